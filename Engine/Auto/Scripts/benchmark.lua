@@ -0,0 +1,121 @@
+--------------------------------------------------------------
+-- @Description : Makefile of CatDogEngine BenchmarkRunner
+--------------------------------------------------------------
+
+project("BenchmarkRunner")
+	kind("ConsoleApp")
+	SetLanguageAndToolset("BenchmarkRunner")
+	dependson { "Engine" }
+
+	files {
+		path.join(BenchmarkSourcePath, "**.*"),
+	}
+
+	vpaths {
+		["Source/*"] = { 
+			path.join(BenchmarkSourcePath, "**.*"),
+		},
+	}
+
+	defines {
+		"BX_CONFIG_DEBUG",
+		"CDENGINE_BUILTIN_SHADER_PATH=\""..BuiltInShaderSourcePath.."\"",
+		"CDPROJECT_RESOURCES_SHARED_PATH=\""..ProjectSharedPath.."\"",
+		"CDPROJECT_RESOURCES_ROOT_PATH=\""..ProjectResourceRootPath.."\"",
+		"CDEDITOR_RESOURCES_ROOT_PATH=\""..EditorResourceRootPath.."\"",
+		"EDITOR_MODE", -- TODO : remove. Component layouts need to match the Engine library.
+		GetPlatformMacroName(),
+	}
+
+	includedirs {
+		path.join(EngineSourcePath, "Runtime/"),
+		path.join(ThirdPartySourcePath, "AssetPipeline/public"),
+		path.join(EnginePath, "BuiltInShaders/shaders"),
+		path.join(EnginePath, "BuiltInShaders/UniformDefines"),
+		path.join(ThirdPartySourcePath, "bgfx/include"),
+		path.join(ThirdPartySourcePath, "bimg/include"),
+		path.join(ThirdPartySourcePath, "bimg/3rdparty"),
+		path.join(ThirdPartySourcePath, "bx/include"),
+		path.join(ThirdPartySourcePath, "bx/include/compat/msvc"),
+		ThirdPartySourcePath,
+	}
+
+	if ENABLE_SPDLOG then
+		defines {
+			"SPDLOG_ENABLE", "SPDLOG_NO_EXCEPTIONS",
+		}
+
+		includedirs {
+			path.join(ThirdPartySourcePath, "spdlog/include"),
+		}
+	end
+
+	if ENABLE_TRACY then
+		defines {
+			"TRACY_ENABLE",
+		}
+
+		includedirs {
+			path.join(ThirdPartySourcePath, "tracy/public"),
+		}
+	end
+
+	AddProfilingDefines()
+
+	if ENABLE_DDGI then
+		includedirs {
+			path.join(DDGI_SDK_PATH, "include"),
+		}
+		libdirs {
+			path.join(DDGI_SDK_PATH, "lib"),
+		}
+		links {
+			"ddgi_sdk", "mright_sdk", "DDGIProbeDecoderBin"
+		}
+		defines {
+			"ENABLE_DDGI",
+			"DDGI_SDK_PATH=\""..DDGI_SDK_PATH.."\"",
+		}
+	end
+
+	-- use /MT /MTd, not /MD /MDd
+	staticruntime "on"
+	filter { "configurations:Debug" }
+		runtime "Debug" -- /MTd
+	filter { "configurations:Release" }
+		runtime "Release" -- /MT
+	filter {}
+
+	libdirs {
+		BinariesPath,
+		path.join(ThirdPartySourcePath, "AssetPipeline/build/bin/%{cfg.buildcfg}"),
+	}
+
+	links {
+		"Engine",
+		"AssetPipelineCore",
+		"CDProducer",
+	}
+
+	-- Disable these options can reduce the size of compiled binaries.
+	justmycode("Off")
+	editAndContinue("Off")
+	-- Reports are parsed by nlohmann json which reports errors by exceptions.
+	exceptionhandling("On")
+	rtti("Off")
+
+	-- Strict.
+	warnings("Default")
+	externalwarnings("Off")
+
+	flags {
+		"MultiProcessorCompile", -- compiler uses multiple thread
+	}
+
+	if not USE_CLANG_TOOLSET then
+		flags {
+			"FatalWarnings", -- treat warnings as errors
+		}
+	end
+
+	CopyDllAutomatically()
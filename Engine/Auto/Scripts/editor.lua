@@ -80,6 +80,8 @@ project("Editor")
 		}
 	end
 
+	AddProfilingDefines()
+
 	if ENABLE_SUBPROCESS then
 		defines {
 			"ENABLE_SUBPROCESS"
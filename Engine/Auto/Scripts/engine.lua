@@ -132,6 +132,8 @@ project("Engine")
 		}
 	end
 
+	AddProfilingDefines()
+
 	if ENABLE_SUBPROCESS then
 		defines {
 			"ENABLE_SUBPROCESS"
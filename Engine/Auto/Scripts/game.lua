@@ -26,6 +26,8 @@ project("Game")
 		"EDITOR_MODE", -- TODO : remove
 	}
 
+	AddProfilingDefines()
+
 	includedirs {
 		path.join(EngineSourcePath, "Runtime/"),
 		path.join(ThirdPartySourcePath, "AssetPipeline/public"),
@@ -83,6 +83,34 @@ ENABLE_FREETYPE = not USE_CLANG_TOOLSET and not IsLinuxPlatform() and not IsAndr
 ENABLE_SPDLOG = not USE_CLANG_TOOLSET and not IsLinuxPlatform() and not IsAndroidPlatform()
 ENABLE_SUBPROCESS = not USE_CLANG_TOOLSET and not IsLinuxPlatform() and not IsAndroidPlatform()
 ENABLE_TRACY = not USE_CLANG_TOOLSET and not IsLinuxPlatform() and not IsAndroidPlatform()
+-- Built-in CPU/GPU zones and Chrome trace export. Unlike Tracy it has no dependency so it works on every platform.
+-- Always on in Debug. Set CD_ENABLE_PROFILING=1 to also enable it in Release for profiling sessions.
+ENABLE_PROFILING = os.getenv("CD_ENABLE_PROFILING") == "1"
+-- Per-subsystem heap accounting. Adds a small header and a few atomic counters to every allocation.
+-- Always on in Debug. Set CD_ENABLE_MEMORY_TRACKING=1 to also enable it in Release.
+ENABLE_MEMORY_TRACKING = os.getenv("CD_ENABLE_MEMORY_TRACKING") == "1"
+
+-- Every project linking Engine calls it so that all of them agree on the instrumentation defines.
+function AddProfilingDefines()
+	filter { "configurations:Debug" }
+		defines {
+			"ENABLE_PROFILING",
+			"ENABLE_MEMORY_TRACKING",
+		}
+	filter { "configurations:Release" }
+		if ENABLE_PROFILING then
+			defines {
+				"ENABLE_PROFILING"
+			}
+		end
+
+		if ENABLE_MEMORY_TRACKING then
+			defines {
+				"ENABLE_MEMORY_TRACKING"
+			}
+		end
+	filter {}
+end
 
 ShouldTreatWaringAsError = not (ENABLE_DDGI or USE_CLANG_TOOLSET)
 
@@ -119,6 +147,8 @@ print("ENABLE_FREETYPE = "..tostring(ENABLE_FREETYPE))
 print("ENABLE_SPDLOG = "..tostring(ENABLE_SPDLOG))
 print("ENABLE_SUBPROCESS = "..tostring(ENABLE_SUBPROCESS))
 print("ENABLE_TRACY = "..tostring(ENABLE_TRACY))
+print("ENABLE_PROFILING (Release) = "..tostring(ENABLE_PROFILING))
+print("ENABLE_MEMORY_TRACKING (Release) = "..tostring(ENABLE_MEMORY_TRACKING))
 print("================================================================")
 
 -- workspace means solution in Visual Studio
@@ -216,6 +246,11 @@ end
 -- game projects
 --dofile("game.lua")
 
+-- headless benchmarks for rendering and simulation regressions
+if not IsAndroidPlatform() then
+	dofile("benchmark.lua")
+end
+
 -- regression tests for engine core modules
 dofile("test.lua")
 
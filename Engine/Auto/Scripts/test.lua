@@ -6,6 +6,18 @@
 TestsPath = path.join(RootPath, "Tests")
 print("Make tests : "..TestsPath)
 
+-- Tests which need to create engine objects such as RenderContext.
+TestsLinkEngine = {
+	"Animation",
+	"Jobs",
+	"Memory",
+	"Particle",
+	"Profiling",
+	"Rendering",
+	"SceneSnapshot",
+	"Time",
+}
+
 function MakeTest(testName)
 	local testSourcePath = path.join(TestsPath, testName)
 
@@ -28,6 +40,35 @@ function MakeTest(testName)
 			path.join(EnginePath, "BuiltInShaders/UniformDefines"),
 		}
 
+		if table.contains(TestsLinkEngine, testName) then
+			dependson { "Engine" }
+
+			includedirs {
+				path.join(ThirdPartySourcePath, "bgfx/include"),
+				path.join(ThirdPartySourcePath, "bimg/include"),
+				path.join(ThirdPartySourcePath, "bx/include"),
+				path.join(ThirdPartySourcePath, "bx/include/compat/msvc"),
+			}
+
+			defines {
+				GetPlatformMacroName(),
+			}
+
+			AddProfilingDefines()
+
+			libdirs {
+				BinariesPath,
+			}
+
+			links {
+				"Engine",
+			}
+
+			filter { "configurations:Debug" }
+				defines { "BX_CONFIG_DEBUG" }
+			filter {}
+		end
+
 		-- convenient to test multiple threads
 		openmp("On")
 
@@ -1,5 +1,6 @@
-#define BS_MORPH_AFFECTED_STAGE 1
-#define BS_ALL_MORPH_VERTEX_ID_STAGE 2
-#define BS_ACTIVE_MORPH_DATA_STAGE 3
-#define BS_FINAL_MORPH_AFFECTED_STAGE 4
-#define BS_CHANGED_MORPH_INDEX_STAGE 5
\ No newline at end of file
+#define BS_AFFECTED_VERTEX_STAGE 1
+#define BS_MORPH_DELTA_STAGE 2
+#define BS_MORPH_WEIGHT_STAGE 3
+#define BS_WORK_GROUP_STAGE 4
+#define BS_FINAL_POSITION_STAGE 5
+#define BS_BATCH_THREAD_COUNT 64
\ No newline at end of file
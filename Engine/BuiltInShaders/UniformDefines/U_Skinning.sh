@@ -0,0 +1,5 @@
+#define BONE_PALETTE_SLOT 7
+#define BONE_PALETTE_WIDTH 1024
+#define SKINNING_VERTEX_STAGE 1
+#define SKINNED_VERTEX_STAGE 2
+#define SKINNING_THREAD_COUNT 64
\ No newline at end of file
@@ -25,21 +25,37 @@ uniform vec4 u_metallicRoughnessRefectanceFactor;
 uniform vec4 u_albedoUVOffsetAndScale;
 uniform vec4 u_alphaCutOff;
 
+#if defined(TEXTUREARRAY)
+// Material textures are packed into 2D texture arrays by slot.
+// xyzw are the layer indexes of albedo, normal, ORM and emissive textures.
+uniform vec4 u_textureLayers;
+
+#define MATERIAL_SAMPLER(_name, _slot) SAMPLER2DARRAY(_name, _slot)
+#define MATERIAL_TEXTURE(_name, _uv, _layer) texture2DArray(_name, vec3(_uv, _layer))
+#else
+#define MATERIAL_SAMPLER(_name, _slot) SAMPLER2D(_name, _slot)
+#define MATERIAL_TEXTURE(_name, _uv, _layer) texture2D(_name, _uv)
+#endif
+
 #if defined(ALBEDOMAP)
-SAMPLER2D(s_texBaseColor, ALBEDO_MAP_SLOT);
+MATERIAL_SAMPLER(s_texBaseColor, ALBEDO_MAP_SLOT);
 
 vec4 SampleAlbedoTexture(vec2 uv) {
 	// We assume that albedo texture is already in linear space.
-	return texture2D(s_texBaseColor, uv);
+	return MATERIAL_TEXTURE(s_texBaseColor, uv, u_textureLayers.x);
 }
 #endif
 
 #if defined(NORMALMAP)
-SAMPLER2D(s_texNormal, NORMAL_MAP_SLOT);
+MATERIAL_SAMPLER(s_texNormal, NORMAL_MAP_SLOT);
 
 vec3 SampleNormalTexture(vec2 uv, mat3 TBN) {
 	// We assume that normal texture is already in linear space.
-	vec3 normalTexture = normalize(texture2D(s_texNormal, uv).xyz * 2.0 - 1.0);
+	// Z is reconstructed from XY so that two channels formats such as BC5 also work.
+	vec3 normalTexture;
+	normalTexture.xy = MATERIAL_TEXTURE(s_texNormal, uv, u_textureLayers.y).xy * 2.0 - 1.0;
+	normalTexture.z = sqrt(max(1.0 - dot(normalTexture.xy, normalTexture.xy), 0.0));
+	normalTexture = normalize(normalTexture);
 	return normalize(mul(TBN, normalTexture));
 }
 #endif
@@ -48,11 +64,11 @@ vec3 SampleNormalTexture(vec2 uv, mat3 TBN) {
 // ORM means that the three attributes of
 // Occlusion, Roughness and Metallic are located in the
 // R, G and B channels of the ORM texture.
-SAMPLER2D(s_texORM, ORM_MAP_SLOT);
+MATERIAL_SAMPLER(s_texORM, ORM_MAP_SLOT);
 
 vec3 SampleORMTexture(vec2 uv) {
 	// We assume that ORM texture is already in linear space.
-	vec3 orm = texture2D(s_texORM, uv).xyz;
+	vec3 orm = MATERIAL_TEXTURE(s_texORM, uv, u_textureLayers.z).xyz;
 	
 	// Clamp rouphness.
 	orm.y = clamp(orm.y, 0.04, 1.0);
@@ -62,11 +78,11 @@ vec3 SampleORMTexture(vec2 uv) {
 #endif
 
 #if defined(EMISSIVEMAP)
-SAMPLER2D(s_texEmissive, EMISSIVE_MAP_SLOT);
+MATERIAL_SAMPLER(s_texEmissive, EMISSIVE_MAP_SLOT);
 
 vec3 SampleEmissiveTexture(vec2 uv) {
 	// We assume that emissive texture is already in linear space.
-	return texture2D(s_texEmissive, uv).xyz;
+	return MATERIAL_TEXTURE(s_texEmissive, uv, u_textureLayers.w).xyz;
 }
 #endif
 
@@ -0,0 +1,103 @@
+//-----------------------------------------------------------------------------------------------//
+// @brief Skins vertices with bone palettes which are packed into one texture for all characters. //
+//                                                                                               //
+// vec3 SkinPosition(vec3 position, float firstTexel, ivec4 indices, vec4 weights)               //
+// void SkinVertex(vec3 position, vec3 normal, float firstTexel, ivec4 indices, vec4 weights,    //
+//                 out vec3 skinnedPosition, out vec3 skinnedNormal)                             //
+//-----------------------------------------------------------------------------------------------//
+
+#include "../UniformDefines/U_Skinning.sh"
+
+SAMPLER2D(s_bonePalette, BONE_PALETTE_SLOT);
+
+// x : first texel of the palette.
+// y : 0 for matrices, 1 for dual quaternions.
+// z : 1 if vertices were already skinned by cs_skinning.
+// w : vertex count in cs_skinning.
+uniform vec4 u_skinningParams;
+
+vec4 FetchPaletteTexel(float texel)
+{
+	float row = floor(texel / BONE_PALETTE_WIDTH);
+	return texelFetch(s_bonePalette, ivec2(int(texel - row * BONE_PALETTE_WIDTH), int(row)), 0);
+}
+
+mat4 BlendBoneMatrices(float firstTexel, ivec4 indices, vec4 weights)
+{
+	vec4 row0 = vec4_splat(0.0);
+	vec4 row1 = vec4_splat(0.0);
+	vec4 row2 = vec4_splat(0.0);
+	for (int influence = 0; influence < 4; ++influence)
+	{
+		float texel = firstTexel + float(indices[influence]) * 3.0;
+		row0 += FetchPaletteTexel(texel) * weights[influence];
+		row1 += FetchPaletteTexel(texel + 1.0) * weights[influence];
+		row2 += FetchPaletteTexel(texel + 2.0) * weights[influence];
+	}
+
+	return mtxFromRows(row0, row1, row2, vec4(0.0, 0.0, 0.0, 1.0));
+}
+
+// Returns the normalized real part, dual is scaled by the same length.
+vec4 BlendDualQuaternions(float firstTexel, ivec4 indices, vec4 weights, out vec4 dual)
+{
+	vec4 firstReal = FetchPaletteTexel(firstTexel + float(indices[0]) * 2.0);
+	vec4 real = vec4_splat(0.0);
+	dual = vec4_splat(0.0);
+	for (int influence = 0; influence < 4; ++influence)
+	{
+		float texel = firstTexel + float(indices[influence]) * 2.0;
+		vec4 boneReal = FetchPaletteTexel(texel);
+		// q and -q are the same rotation, blend on the hemisphere of the first bone.
+		float weight = dot(firstReal, boneReal) < 0.0 ? -weights[influence] : weights[influence];
+		real += boneReal * weight;
+		dual += FetchPaletteTexel(texel + 1.0) * weight;
+	}
+
+	float inverseLength = 1.0 / length(real);
+	dual *= inverseLength;
+	return real * inverseLength;
+}
+
+vec3 RotateByQuaternion(vec4 q, vec3 v)
+{
+	return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+vec3 DualQuaternionTranslation(vec4 real, vec4 dual)
+{
+	return 2.0 * (real.w * dual.xyz - dual.w * real.xyz + cross(real.xyz, dual.xyz));
+}
+
+vec3 SkinPosition(vec3 position, float firstTexel, ivec4 indices, vec4 weights)
+{
+	if (u_skinningParams.y > 0.5)
+	{
+		vec4 dual;
+		vec4 real = BlendDualQuaternions(firstTexel, indices, weights, dual);
+		return RotateByQuaternion(real, position) + DualQuaternionTranslation(real, dual);
+	}
+
+	return mul(BlendBoneMatrices(firstTexel, indices, weights), vec4(position, 1.0)).xyz;
+}
+
+void SkinVertex(vec3 position, vec3 normal, float firstTexel, ivec4 indices, vec4 weights, out vec3 skinnedPosition, out vec3 skinnedNormal)
+{
+	if (u_skinningParams.y > 0.5)
+	{
+		vec4 dual;
+		vec4 real = BlendDualQuaternions(firstTexel, indices, weights, dual);
+		skinnedPosition = RotateByQuaternion(real, position) + DualQuaternionTranslation(real, dual);
+		skinnedNormal = RotateByQuaternion(real, normal);
+	}
+	else
+	{
+		mat4 skinMatrix = BlendBoneMatrices(firstTexel, indices, weights);
+		skinnedPosition = mul(skinMatrix, vec4(position, 1.0)).xyz;
+		skinnedNormal = mul(skinMatrix, vec4(normal, 0.0)).xyz;
+	}
+
+	// Meshes without normals keep a zero normal.
+	float normalLength = length(skinnedNormal);
+	skinnedNormal = normalLength > 0.0 ? skinnedNormal / normalLength : skinnedNormal;
+}
@@ -0,0 +1,43 @@
+#include "../common/bgfx_compute.sh"
+#include "../UniformDefines/U_BlendShape.sh"
+
+// 8 uint per vertex : base position, output vertex, first delta, delta count, first weight, padding.
+BUFFER_RO(s_affectedVertices, uint, BS_AFFECTED_VERTEX_STAGE);
+// 4 uint per delta : morph index, offset from the base position.
+BUFFER_RO(s_morphDeltas, uint, BS_MORPH_DELTA_STAGE);
+BUFFER_RO(s_morphWeights, uint, BS_MORPH_WEIGHT_STAGE);
+// 2 uint per work group : first affected vertex, affected vertex count.
+BUFFER_RO(s_workGroups, uint, BS_WORK_GROUP_STAGE);
+// Position and the weight which is left for the base position.
+BUFFER_RW(s_finalPositions, vec4, BS_FINAL_POSITION_STAGE);
+
+// x : first work group of this dispatch.
+uniform vec4 u_blendShapeBatchParams;
+
+NUM_THREADS(BS_BATCH_THREAD_COUNT, 1, 1)
+void main()
+{
+	uint groupIndex = uint(u_blendShapeBatchParams.x) + gl_WorkGroupID.x;
+	if (gl_LocalInvocationID.x >= s_workGroups[groupIndex * 2u + 1u])
+	{
+		return;
+	}
+
+	uint vertexOffset = (s_workGroups[groupIndex * 2u] + gl_LocalInvocationID.x) * 8u;
+	vec3 position = vec3(asfloat(s_affectedVertices[vertexOffset]), asfloat(s_affectedVertices[vertexOffset + 1u]), asfloat(s_affectedVertices[vertexOffset + 2u]));
+	uint outputVertex = s_affectedVertices[vertexOffset + 3u];
+	uint firstDelta = s_affectedVertices[vertexOffset + 4u];
+	uint lastDelta = firstDelta + s_affectedVertices[vertexOffset + 5u];
+	uint firstWeight = s_affectedVertices[vertexOffset + 6u];
+
+	float weightSum = 0.0;
+	for (uint deltaIndex = firstDelta; deltaIndex < lastDelta; ++deltaIndex)
+	{
+		uint deltaOffset = deltaIndex * 4u;
+		float weight = asfloat(s_morphWeights[firstWeight + s_morphDeltas[deltaOffset]]);
+		position += weight * vec3(asfloat(s_morphDeltas[deltaOffset + 1u]), asfloat(s_morphDeltas[deltaOffset + 2u]), asfloat(s_morphDeltas[deltaOffset + 3u]));
+		weightSum += weight;
+	}
+
+	s_finalPositions[outputVertex] = vec4(position, 1.0 - weightSum);
+}
@@ -0,0 +1,29 @@
+#include "../common/bgfx_compute.sh"
+#include "../common/Skinning.sh"
+
+// 4 vec4 per vertex : position, normal, bone indices, bone weights.
+BUFFER_RO(s_skinningVertices, vec4, SKINNING_VERTEX_STAGE);
+// 2 vec4 per vertex : skinned position and normal.
+BUFFER_WR(s_skinnedVertices, vec4, SKINNED_VERTEX_STAGE);
+
+NUM_THREADS(SKINNING_THREAD_COUNT, 1, 1)
+void main()
+{
+	uint vertexIndex = gl_GlobalInvocationID.x;
+	if (vertexIndex >= uint(u_skinningParams.w))
+	{
+		return;
+	}
+
+	vec3 position = s_skinningVertices[vertexIndex * 4u].xyz;
+	vec3 normal = s_skinningVertices[vertexIndex * 4u + 1u].xyz;
+	ivec4 indices = ivec4(s_skinningVertices[vertexIndex * 4u + 2u]);
+	vec4 weights = s_skinningVertices[vertexIndex * 4u + 3u];
+
+	vec3 skinnedPosition;
+	vec3 skinnedNormal;
+	SkinVertex(position, normal, u_skinningParams.x, indices, weights, skinnedPosition, skinnedNormal);
+
+	s_skinnedVertices[vertexIndex * 2u] = vec4(skinnedPosition, 1.0);
+	s_skinnedVertices[vertexIndex * 2u + 1u] = vec4(skinnedNormal, 0.0);
+}
@@ -0,0 +1,15 @@
+$input a_position, a_indices, a_weight, i_data0, i_data1, i_data2, i_data3, i_data4
+$output v_worldPos
+
+#include "../common/common.sh"
+#include "../common/Skinning.sh"
+
+void main()
+{
+	// i_data0-3 : model matrix, i_data4.x : first texel of the palette of this instance.
+	mat4 model = mtxFromCols(i_data0, i_data1, i_data2, i_data3);
+	vec4 worldPos = mul(model, vec4(SkinPosition(a_position, i_data4.x, a_indices, a_weight), 1.0));
+	gl_Position = mul(u_viewProj, worldPos);
+
+	v_worldPos = worldPos.xyz;
+}
@@ -0,0 +1,138 @@
+#include "AllocationCounter.h"
+
+#ifdef ENABLE_MEMORY_TRACKING
+#include "Core/Memory/MemoryTracker.h"
+#endif
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+std::atomic<uint64_t> s_allocationCount = 0U;
+std::atomic<uint64_t> s_allocatedBytes = 0U;
+
+void* CountedAlloc(std::size_t size)
+{
+	s_allocationCount.fetch_add(1U, std::memory_order_relaxed);
+	s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+#ifdef ENABLE_MEMORY_TRACKING
+	// Per-tag accounting keeps working in benchmark runs.
+	return engine::MemoryTracker::Allocate(size);
+#else
+	return std::malloc(0U == size ? 1U : size);
+#endif
+}
+
+void* CountedAlignedAlloc(std::size_t size, std::size_t alignment)
+{
+	s_allocationCount.fetch_add(1U, std::memory_order_relaxed);
+	s_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+#if defined(ENABLE_MEMORY_TRACKING)
+	return engine::MemoryTracker::Allocate(size, alignment);
+#elif defined(CD_PLATFORM_WINDOWS)
+	return _aligned_malloc(0U == size ? 1U : size, alignment);
+#else
+	// std::aligned_alloc needs the size to be a multiple of alignment which is always a power of two.
+	const std::size_t alignedSize = ((0U == size ? 1U : size) + alignment - 1U) & ~(alignment - 1U);
+	return std::aligned_alloc(alignment, alignedSize);
+#endif
+}
+
+void Free(void* pMemory)
+{
+#ifdef ENABLE_MEMORY_TRACKING
+	engine::MemoryTracker::Free(pMemory);
+#else
+	std::free(pMemory);
+#endif
+}
+
+void AlignedFree(void* pMemory)
+{
+#if defined(ENABLE_MEMORY_TRACKING)
+	engine::MemoryTracker::Free(pMemory);
+#elif defined(CD_PLATFORM_WINDOWS)
+	_aligned_free(pMemory);
+#else
+	std::free(pMemory);
+#endif
+}
+
+}
+
+namespace benchmark
+{
+
+AllocationCounts AllocationCounter::Get()
+{
+	AllocationCounts counts;
+	counts.allocationCount = s_allocationCount.load(std::memory_order_relaxed);
+	counts.allocatedBytes = s_allocatedBytes.load(std::memory_order_relaxed);
+	return counts;
+}
+
+}
+
+void* operator new(std::size_t size)
+{
+	if (void* pMemory = CountedAlloc(size))
+	{
+		return pMemory;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return CountedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return CountedAlloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	if (void* pMemory = CountedAlignedAlloc(size, static_cast<std::size_t>(alignment)))
+	{
+		return pMemory;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return CountedAlignedAlloc(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return CountedAlignedAlloc(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pMemory) noexcept { Free(pMemory); }
+void operator delete[](void* pMemory) noexcept { Free(pMemory); }
+void operator delete(void* pMemory, std::size_t) noexcept { Free(pMemory); }
+void operator delete[](void* pMemory, std::size_t) noexcept { Free(pMemory); }
+void operator delete(void* pMemory, const std::nothrow_t&) noexcept { Free(pMemory); }
+void operator delete[](void* pMemory, const std::nothrow_t&) noexcept { Free(pMemory); }
+void operator delete(void* pMemory, std::align_val_t) noexcept { AlignedFree(pMemory); }
+void operator delete[](void* pMemory, std::align_val_t) noexcept { AlignedFree(pMemory); }
+void operator delete(void* pMemory, std::size_t, std::align_val_t) noexcept { AlignedFree(pMemory); }
+void operator delete[](void* pMemory, std::size_t, std::align_val_t) noexcept { AlignedFree(pMemory); }
+void operator delete(void* pMemory, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(pMemory); }
+void operator delete[](void* pMemory, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(pMemory); }
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+namespace benchmark
+{
+
+struct AllocationCounts
+{
+	uint64_t allocationCount = 0U;
+	uint64_t allocatedBytes = 0U;
+};
+
+// BenchmarkRunner replaces global operator new/delete to count heap allocations of all threads.
+// Memory still comes from malloc so counting doesn't change what is measured.
+// Allocations which bypass operator new such as bgfx's allocator or malloc in C libraries are not counted.
+class AllocationCounter final
+{
+public:
+	AllocationCounter() = delete;
+
+	// Totals since the program started. Subtract two snapshots to count allocations of a scope.
+	static AllocationCounts Get();
+};
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Graphics/GraphicsBackend.h"
+
+#include <cstdint>
+#include <string>
+
+namespace benchmark
+{
+
+struct BenchmarkConfig
+{
+	std::string name = "Default";
+
+	uint32_t warmupFrameCount = 60U;
+	uint32_t frameCount = 300U;
+	// Simulation uses a fixed time step so that every run updates the same frames.
+	float deltaTime = 1.0f / 60.0f;
+
+	uint32_t meshCount = 256U;
+	uint32_t lightCount = 3U;
+	uint32_t shadowLightCount = 1U;
+	uint32_t particleEmitterCount = 8U;
+	uint32_t characterCount = 0U;
+	std::string characterModelPath;
+	bool enableTerrain = true;
+	uint32_t seed = 1U;
+
+	uint16_t width = 1280U;
+	uint16_t height = 720U;
+	// Noop backend can consume shader binaries of any backend so it selects the folder of compiled shaders.
+	engine::GraphicsBackend shaderBackend = engine::GraphicsBackend::Direct3D11;
+	bool enableParallelRecord = true;
+	// 0 means to use all hardware threads.
+	uint32_t threadCount = 0U;
+};
+
+}
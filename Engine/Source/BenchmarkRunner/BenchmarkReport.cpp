@@ -0,0 +1,242 @@
+#include "BenchmarkReport.h"
+
+#include "Base/NameOf.h"
+#include "Base/Template.h"
+#include "Log/Log.h"
+
+#include <json/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+
+namespace benchmark
+{
+
+namespace
+{
+
+using Json = nlohmann::ordered_json;
+
+// Timings below this difference in milliseconds are noise of the timer and the OS scheduler.
+constexpr double TimeNoiseFloorMs = 0.05;
+
+double GetPercentile(const std::vector<double>& sortedSamples, double percentile)
+{
+	// Nearest rank so that the reported value was really measured.
+	const size_t rank = static_cast<size_t>(std::ceil(percentile * static_cast<double>(sortedSamples.size())));
+	return sortedSamples[std::clamp<size_t>(rank, 1U, sortedSamples.size()) - 1U];
+}
+
+Json ToJson(const MetricSummary& summary)
+{
+	Json json;
+	json["mean"] = summary.mean;
+	json["min"] = summary.min;
+	json["p50"] = summary.p50;
+	json["p95"] = summary.p95;
+	json["p99"] = summary.p99;
+	json["max"] = summary.max;
+	return json;
+}
+
+Json ToJson(const BenchmarkConfig& config)
+{
+	Json json;
+	json["name"] = config.name;
+	json["warmupFrameCount"] = config.warmupFrameCount;
+	json["frameCount"] = config.frameCount;
+	json["deltaTime"] = config.deltaTime;
+	json["meshCount"] = config.meshCount;
+	json["lightCount"] = config.lightCount;
+	json["shadowLightCount"] = config.shadowLightCount;
+	json["particleEmitterCount"] = config.particleEmitterCount;
+	json["characterCount"] = config.characterCount;
+	json["characterModelPath"] = config.characterModelPath;
+	json["enableTerrain"] = config.enableTerrain;
+	json["seed"] = config.seed;
+	json["width"] = config.width;
+	json["height"] = config.height;
+	json["shaderBackend"] = std::string(nameof::nameof_enum(config.shaderBackend));
+	json["enableParallelRecord"] = config.enableParallelRecord;
+	return json;
+}
+
+Json ToJson(const BenchmarkSceneStats& stats)
+{
+	Json json;
+	json["entityCount"] = stats.entityCount;
+	json["meshCount"] = stats.meshCount;
+	json["lightCount"] = stats.lightCount;
+	json["shadowLightCount"] = stats.shadowLightCount;
+	json["particleEmitterCount"] = stats.particleEmitterCount;
+	json["terrainCount"] = stats.terrainCount;
+	json["characterCount"] = stats.characterCount;
+	json["vertexCount"] = stats.vertexCount;
+	json["polygonCount"] = stats.polygonCount;
+	return json;
+}
+
+// Returns a negative value when the metric is missing in the baseline.
+double GetBaselineValue(const Json& baseline, const Json::json_pointer& pointer)
+{
+	if (!baseline.contains(pointer) || !baseline[pointer].is_number())
+	{
+		return -1.0;
+	}
+
+	return baseline[pointer].get<double>();
+}
+
+bool IsRegression(double current, double baseline, double threshold, double noiseFloor)
+{
+	return current - baseline > std::max(baseline * threshold, noiseFloor);
+}
+
+}
+
+MetricSummary Summarize(std::vector<double> samples)
+{
+	MetricSummary summary;
+	if (samples.empty())
+	{
+		return summary;
+	}
+
+	std::sort(samples.begin(), samples.end());
+	summary.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+	summary.min = samples.front();
+	summary.p50 = GetPercentile(samples, 0.50);
+	summary.p95 = GetPercentile(samples, 0.95);
+	summary.p99 = GetPercentile(samples, 0.99);
+	summary.max = samples.back();
+	return summary;
+}
+
+std::string ToJson(const BenchmarkReport& report)
+{
+	Json json;
+	json["config"] = ToJson(report.config);
+	json["scene"] = ToJson(report.sceneStats);
+	json["threadCount"] = report.threadCount;
+	json["pendingMaterialCount"] = report.pendingMaterialCount;
+	json["measuredFrameCount"] = report.measuredFrameCount;
+	json["totalSeconds"] = report.totalSeconds;
+	json["frameMs"] = ToJson(report.frameMs);
+
+	Json stages = Json::object();
+	for (const StageSummary& stage : report.stages)
+	{
+		stages[stage.name] = ToJson(stage.ms);
+	}
+	json["stageMs"] = cd::MoveTemp(stages);
+
+	Json perFrame;
+	perFrame["drawCalls"] = ToJson(report.drawCalls);
+	perFrame["dispatches"] = ToJson(report.dispatches);
+	perFrame["uniformUpdates"] = ToJson(report.uniformUpdates);
+	perFrame["allocations"] = ToJson(report.allocations);
+	perFrame["allocatedBytes"] = ToJson(report.allocatedBytes);
+	json["perFrame"] = cd::MoveTemp(perFrame);
+
+	Json resources;
+	resources["programs"] = report.programCount;
+	resources["shaders"] = report.shaderCount;
+	resources["textures"] = report.textureCount;
+	resources["uniforms"] = report.uniformCount;
+	resources["vertexBuffers"] = report.vertexBufferCount;
+	resources["indexBuffers"] = report.indexBufferCount;
+	resources["frameBuffers"] = report.frameBufferCount;
+	json["resources"] = cd::MoveTemp(resources);
+
+	return json.dump(4);
+}
+
+bool WriteReport(const BenchmarkReport& report, const char* pFilePath)
+{
+	const std::string content = ToJson(report);
+	if (!pFilePath)
+	{
+		std::cout << content << std::endl;
+		return true;
+	}
+
+	std::ofstream file(pFilePath, std::ios::out | std::ios::trunc);
+	if (!file.is_open())
+	{
+		CD_ERROR("Failed to open benchmark report file {}.", pFilePath);
+		return false;
+	}
+
+	file << content << std::endl;
+	CD_INFO("Benchmark report is saved to {}.", pFilePath);
+	return true;
+}
+
+uint32_t CompareWithBaseline(const BenchmarkReport& report, const char* pBaselineFilePath, double threshold)
+{
+	std::ifstream file(pBaselineFilePath, std::ios::in);
+	if (!file.is_open())
+	{
+		CD_ERROR("Failed to open benchmark baseline file {}.", pBaselineFilePath);
+		return 0U;
+	}
+
+	const Json baseline = Json::parse(file, nullptr, false);
+	if (baseline.is_discarded())
+	{
+		CD_ERROR("Failed to parse benchmark baseline file {}.", pBaselineFilePath);
+		return 0U;
+	}
+
+	if (baseline.contains("scene") && baseline["scene"] != ToJson(report.sceneStats))
+	{
+		CD_WARN("Scene of the baseline differs from the current run. Results are not comparable.");
+	}
+
+	uint32_t regressionCount = 0U;
+	auto compare = [&](const std::string& pointer, double current, double noiseFloor)
+	{
+		double baselineValue = GetBaselineValue(baseline, Json::json_pointer(pointer));
+		if (baselineValue < 0.0)
+		{
+			return;
+		}
+
+		if (IsRegression(current, baselineValue, threshold, noiseFloor))
+		{
+			++regressionCount;
+			CD_WARN("[Regression] {} : {:.4f} -> {:.4f} ({:+.1f}%)", pointer, baselineValue, current,
+				baselineValue > 0.0 ? (current / baselineValue - 1.0) * 100.0 : 100.0);
+		}
+	};
+
+	compare("/frameMs/p50", report.frameMs.p50, TimeNoiseFloorMs);
+	compare("/frameMs/p95", report.frameMs.p95, TimeNoiseFloorMs);
+	for (const StageSummary& stage : report.stages)
+	{
+		// Stage names contain '/' which needs to be escaped in json pointers.
+		std::string escapedName;
+		for (char c : stage.name)
+		{
+			escapedName += ('/' == c) ? "~1" : std::string(1, c);
+		}
+		compare("/stageMs/" + escapedName + "/p50", stage.ms.p50, TimeNoiseFloorMs);
+	}
+
+	// Counters are deterministic so any growth above the threshold is a real change.
+	compare("/perFrame/drawCalls/mean", report.drawCalls.mean, 0.0);
+	compare("/perFrame/uniformUpdates/mean", report.uniformUpdates.mean, 0.0);
+	compare("/perFrame/allocations/mean", report.allocations.mean, 0.0);
+
+	if (0U == regressionCount)
+	{
+		CD_INFO("No regressions against {}.", pBaselineFilePath);
+	}
+
+	return regressionCount;
+}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "BenchmarkConfig.h"
+#include "BenchmarkScene.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace benchmark
+{
+
+// Distribution of one metric over all measured frames.
+struct MetricSummary
+{
+	double mean = 0.0;
+	double min = 0.0;
+	double p50 = 0.0;
+	double p95 = 0.0;
+	double p99 = 0.0;
+	double max = 0.0;
+};
+
+MetricSummary Summarize(std::vector<double> samples);
+
+struct StageSummary
+{
+	std::string name;
+	MetricSummary ms;
+};
+
+struct BenchmarkReport
+{
+	BenchmarkConfig config;
+	BenchmarkSceneStats sceneStats;
+	uint32_t threadCount = 0U;
+	// Materials which still wait for shaders after warmup. They are not drawn so timings miss their cost.
+	uint32_t pendingMaterialCount = 0U;
+
+	uint32_t measuredFrameCount = 0U;
+	double totalSeconds = 0.0;
+	MetricSummary frameMs;
+	std::vector<StageSummary> stages;
+
+	MetricSummary drawCalls;
+	MetricSummary dispatches;
+	MetricSummary uniformUpdates;
+	MetricSummary allocations;
+	MetricSummary allocatedBytes;
+
+	// bgfx objects which are alive at the end of the run.
+	uint32_t programCount = 0U;
+	uint32_t shaderCount = 0U;
+	uint32_t textureCount = 0U;
+	uint32_t uniformCount = 0U;
+	uint32_t vertexBufferCount = 0U;
+	uint32_t indexBufferCount = 0U;
+	uint32_t frameBufferCount = 0U;
+};
+
+std::string ToJson(const BenchmarkReport& report);
+bool WriteReport(const BenchmarkReport& report, const char* pFilePath);
+
+// Compares medians of frame and stage timings and means of per frame counters with a report of an earlier run.
+// A metric regresses when it grows by more than threshold, e.g. 0.1 for 10%. Returns the number of regressions.
+uint32_t CompareWithBaseline(const BenchmarkReport& report, const char* pBaselineFilePath, double threshold);
+
+}
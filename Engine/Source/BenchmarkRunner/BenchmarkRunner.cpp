@@ -0,0 +1,415 @@
+#include "BenchmarkRunner.h"
+
+#include "AllocationCounter.h"
+#include "BenchmarkScene.h"
+
+#include "Base/NameOf.h"
+#include "Core/Jobs/JobSystem.h"
+#include "ECWorld/SceneWorld.h"
+#include "Log/Log.h"
+#include "Path/Path.h"
+#include "Profiling/Profile.h"
+#include "Rendering/AnimationRenderer.h"
+#include "Rendering/BlitRenderTargetPass.h"
+#include "Rendering/PBRSkyRenderer.h"
+#include "Rendering/ParallelRenderRecorder.h"
+#include "Rendering/ParticleRenderer.h"
+#include "Rendering/PostProcessRenderer.h"
+#include "Rendering/RenderContext.h"
+#include "Rendering/Resources/ResourceContext.h"
+#include "Rendering/Resources/ShaderResource.h"
+#include "Rendering/ShadowMapRenderer.h"
+#include "Rendering/SkeletonRenderer.h"
+#include "Rendering/SkinningRenderer.h"
+#include "Rendering/SkyboxRenderer.h"
+#include "Rendering/TerrainRenderer.h"
+#include "Rendering/WorldRenderer.h"
+
+#include <bgfx/bgfx.h>
+
+#include <cassert>
+#include <chrono>
+
+namespace benchmark
+{
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double GetElapsedMs(Clock::time_point begin, Clock::time_point end)
+{
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+bool IsAtmosphericScatteringEnable()
+{
+	// Same rule as the editor so that the benchmark renders the same sky.
+	engine::GraphicsBackend backend = engine::Path::GetGraphicsBackend();
+
+	return engine::GraphicsBackend::Vulkan != backend
+		&& engine::GraphicsBackend::OpenGL != backend
+		&& engine::GraphicsBackend::OpenGLES != backend;
+}
+
+// SetSceneWorld is not a virtual method of Renderer so scene renderers are created with their type.
+template<typename T>
+std::unique_ptr<engine::Renderer> CreateSceneRenderer(engine::RenderContext* pRenderContext, engine::RenderTarget* pRenderTarget, engine::SceneWorld* pSceneWorld)
+{
+	auto pRenderer = std::make_unique<T>(pRenderContext->CreateView(), pRenderTarget);
+	pRenderer->SetSceneWorld(pSceneWorld);
+	return pRenderer;
+}
+
+}
+
+BenchmarkRunner::BenchmarkRunner(BenchmarkConfig config)
+	: m_config(cd::MoveTemp(config))
+{
+}
+
+BenchmarkRunner::~BenchmarkRunner()
+{
+	Shutdown();
+}
+
+void BenchmarkRunner::Init()
+{
+	engine::JobSystem::Get().Init(m_config.threadCount);
+	CD_PROFILE_THREAD("Main");
+
+	InitRenderContext();
+	InitMaterialTypes();
+
+	m_pScene = std::make_unique<BenchmarkScene>(m_pSceneWorld.get(), m_pRenderContext.get());
+	m_pScene->Build(m_config);
+
+	InitRenderers();
+}
+
+void BenchmarkRunner::InitRenderContext()
+{
+	// Shaders are loaded from the output folder of shaderBackend while bgfx runs on Noop without a window.
+	CD_INFO("Benchmark {} with shaders of {}", m_config.name, nameof::nameof_enum(m_config.shaderBackend));
+
+	engine::Path::SetGraphicsBackend(m_config.shaderBackend);
+	m_pRenderContext = std::make_unique<engine::RenderContext>();
+	m_pRenderContext->Init(engine::GraphicsBackend::Noop);
+	engine::Renderer::SetRenderContext(m_pRenderContext.get());
+
+	m_pResourceContext = std::make_unique<engine::ResourceContext>();
+	m_pRenderContext->SetResourceContext(m_pResourceContext.get());
+
+	m_pRenderRecorder = std::make_unique<engine::ParallelRenderRecorder>();
+}
+
+void BenchmarkRunner::InitMaterialTypes()
+{
+	m_pRenderContext->RegisterShaderProgram("WorldProgram", "vs_PBR", "fs_PBR");
+	m_pRenderContext->RegisterShaderProgram("AnimationProgram", "vs_animation", "fs_animation");
+	m_pRenderContext->RegisterShaderProgram("TerrainProgram", "vs_terrain", "fs_terrain");
+	m_pRenderContext->RegisterShaderProgram("ParticleProgram", "vs_particleSprite", "fs_particleSprite");
+
+	m_pSceneWorld = std::make_unique<engine::SceneWorld>();
+	m_pSceneWorld->CreatePBRMaterialType("WorldProgram", IsAtmosphericScatteringEnable());
+	m_pSceneWorld->CreateAnimationMaterialType("AnimationProgram");
+	m_pSceneWorld->CreateTerrainMaterialType("TerrainProgram");
+	m_pSceneWorld->CreateParticleMaterialType("ParticleProgram");
+}
+
+void BenchmarkRunner::InitRenderers()
+{
+	m_simulationStage = AddStage("Simulation");
+	m_resourceStage = AddStage("ResourceUpdate");
+	m_materialStage = AddStage("Materials");
+
+	constexpr engine::StringCrc sceneRenderTargetName("SceneRenderTarget");
+	std::vector<engine::AttachmentDescriptor> attachmentDesc = {
+		{.textureFormat = engine::TextureFormat::RGBA32F },
+		{.textureFormat = engine::TextureFormat::RGBA32F },
+		{.textureFormat = engine::TextureFormat::D32F },
+	};
+	engine::RenderTarget* pSceneRenderTarget = m_pRenderContext->CreateRenderTarget(sceneRenderTargetName,
+		m_config.width, m_config.height, cd::MoveTemp(attachmentDesc));
+
+	// Same order as engine renderers in the editor without editor only debug renderers.
+	engine::RenderContext* pRenderContext = m_pRenderContext.get();
+	engine::SceneWorld* pSceneWorld = m_pSceneWorld.get();
+	AddRenderer("Skinning", CreateSceneRenderer<engine::SkinningRenderer>(pRenderContext, pSceneRenderTarget, pSceneWorld));
+	AddRenderer("ShadowMap", CreateSceneRenderer<engine::ShadowMapRenderer>(pRenderContext, pSceneRenderTarget, pSceneWorld));
+	AddRenderer("Skybox", CreateSceneRenderer<engine::SkyboxRenderer>(pRenderContext, pSceneRenderTarget, pSceneWorld));
+	if (IsAtmosphericScatteringEnable())
+	{
+		AddRenderer("PBRSky", CreateSceneRenderer<engine::PBRSkyRenderer>(pRenderContext, pSceneRenderTarget, pSceneWorld));
+	}
+	AddRenderer("Skeleton", CreateSceneRenderer<engine::SkeletonRenderer>(pRenderContext, pSceneRenderTarget, pSceneWorld));
+	AddRenderer("Animation", CreateSceneRenderer<engine::AnimationRenderer>(pRenderContext, pSceneRenderTarget, pSceneWorld));
+	AddRenderer("World", CreateSceneRenderer<engine::WorldRenderer>(pRenderContext, pSceneRenderTarget, pSceneWorld));
+	AddRenderer("Terrain", CreateSceneRenderer<engine::TerrainRenderer>(pRenderContext, pSceneRenderTarget, pSceneWorld));
+	AddRenderer("Particle", CreateSceneRenderer<engine::ParticleRenderer>(pRenderContext, pSceneRenderTarget, pSceneWorld));
+	AddRenderer("BlitRenderTarget", std::make_unique<engine::BlitRenderTargetPass>(pRenderContext->CreateView(), pSceneRenderTarget));
+	AddRenderer("PostProcess", CreateSceneRenderer<engine::PostProcessRenderer>(pRenderContext, pSceneRenderTarget, pSceneWorld));
+
+	m_recordStage = AddStage("ParallelRecord");
+	m_submitStage = AddStage("Submit");
+}
+
+void BenchmarkRunner::AddRenderer(const char* pName, std::unique_ptr<engine::Renderer> pRenderer)
+{
+	pRenderer->Init();
+
+	BenchmarkRenderer& renderer = m_renderers.emplace_back();
+	renderer.stageName = std::string("Render/") + pName;
+	renderer.pRenderer = cd::MoveTemp(pRenderer);
+	AddStage(renderer.stageName);
+}
+
+uint32_t BenchmarkRunner::AddStage(std::string name)
+{
+	uint32_t stageIndex = static_cast<uint32_t>(m_stageNames.size());
+	m_stageNames.emplace_back(cd::MoveTemp(name));
+	return stageIndex;
+}
+
+void BenchmarkRunner::UpdateMaterials()
+{
+	// Resolve shader variants like the editor but without recompiling. Shaders need to be compiled before.
+	for (engine::Entity entity : m_pSceneWorld->GetMaterialEntities())
+	{
+		engine::MaterialComponent* pMaterialComponent = m_pSceneWorld->GetMaterialComponent(entity);
+		if (!pMaterialComponent || !pMaterialComponent->IsShaderResourceDirty())
+		{
+			continue;
+		}
+
+		const std::string& programName = pMaterialComponent->GetShaderProgramName();
+		const std::string& featuresCombine = pMaterialComponent->GetFeaturesCombine();
+
+		engine::ShaderResource* pShaderResource = m_pResourceContext->GetShaderResource(engine::StringCrc{ programName + featuresCombine });
+		if (!pShaderResource)
+		{
+			engine::ShaderResource* pOriginShaderResource = m_pResourceContext->GetShaderResource(engine::StringCrc{ programName });
+			assert(pOriginShaderResource);
+
+			engine::ShaderProgramType programtype = pOriginShaderResource->GetType();
+			if (engine::ShaderProgramType::Standard == programtype)
+			{
+				pShaderResource = m_pRenderContext->RegisterShaderProgram(pOriginShaderResource->GetName(),
+					pOriginShaderResource->GetShaderInfo(0).name,
+					pOriginShaderResource->GetShaderInfo(1).name,
+					featuresCombine);
+			}
+			else
+			{
+				pShaderResource = m_pRenderContext->RegisterShaderProgram(pOriginShaderResource->GetName(),
+					pOriginShaderResource->GetShaderInfo(0).name,
+					programtype,
+					featuresCombine);
+			}
+		}
+
+		assert(pShaderResource);
+		pMaterialComponent->SetShaderResource(pShaderResource);
+	}
+}
+
+void BenchmarkRunner::RunFrame(bool isMeasured)
+{
+	const float deltaTime = m_config.deltaTime;
+	const AllocationCounts beginAllocations = AllocationCounter::Get();
+	const Clock::time_point frameBegin = Clock::now();
+	Clock::time_point stageBegin = frameBegin;
+
+	auto endStage = [this, &stageBegin](uint32_t stageIndex)
+	{
+		Clock::time_point stageEnd = Clock::now();
+		m_frameStageMs[stageIndex] = GetElapsedMs(stageBegin, stageEnd);
+		stageBegin = stageEnd;
+	};
+
+	{
+		CD_PROFILE_ZONE("Simulation");
+		m_pScene->Update(deltaTime);
+		// One fixed step per frame keeps benchmark frames deterministic.
+		m_pSceneWorld->FixedUpdate(deltaTime);
+		m_pSceneWorld->SetInterpolationAlpha(1.0f);
+		m_pSceneWorld->Update();
+
+		engine::CameraComponent* pMainCameraComponent = m_pSceneWorld->GetCameraComponent(m_pSceneWorld->GetMainCameraEntity());
+		assert(pMainCameraComponent);
+		pMainCameraComponent->BuildProjectMatrix();
+	}
+	endStage(m_simulationStage);
+
+	m_pResourceContext->Update();
+	m_pRenderContext->BeginFrame();
+	endStage(m_resourceStage);
+
+	UpdateMaterials();
+	endStage(m_materialStage);
+
+	engine::CameraComponent* pMainCameraComponent = m_pSceneWorld->GetCameraComponent(m_pSceneWorld->GetMainCameraEntity());
+	const float* pViewMatrix = pMainCameraComponent->GetViewMatrix().begin();
+	const float* pProjectionMatrix = pMainCameraComponent->GetProjectionMatrix().begin();
+	for (uint32_t rendererIndex = 0U; rendererIndex < m_renderers.size(); ++rendererIndex)
+	{
+		engine::Renderer* pRenderer = m_renderers[rendererIndex].pRenderer.get();
+		if (pRenderer->IsEnable())
+		{
+			CD_PROFILE_ZONE_VIEW("Render", pRenderer->GetViewID());
+			pRenderer->UpdateView(pViewMatrix, pProjectionMatrix);
+
+			// Parallel renderers only prepare here. Their recording is measured in the ParallelRecord stage.
+			if (m_config.enableParallelRecord && pRenderer->IsParallelRecordSupported())
+			{
+				m_pRenderRecorder->Add(pRenderer, deltaTime);
+			}
+			else
+			{
+				pRenderer->Render(deltaTime);
+			}
+		}
+		endStage(m_materialStage + 1U + rendererIndex);
+	}
+
+	m_pRenderRecorder->Record();
+	endStage(m_recordStage);
+
+	m_pRenderContext->EndFrame();
+	endStage(m_submitStage);
+
+	CD_PROFILE_FRAME();
+
+	if (!isMeasured)
+	{
+		return;
+	}
+
+	const AllocationCounts endAllocations = AllocationCounter::Get();
+	const engine::RenderCommandCounts& commandCounts = m_pRenderContext->GetLastFrameCommandCounts();
+
+	m_samples.frameMs.push_back(GetElapsedMs(frameBegin, stageBegin));
+	for (uint32_t stageIndex = 0U; stageIndex < m_frameStageMs.size(); ++stageIndex)
+	{
+		m_samples.stageMs[stageIndex].push_back(m_frameStageMs[stageIndex]);
+	}
+	m_samples.drawCallCounts.push_back(static_cast<double>(commandCounts.drawCallCount));
+	m_samples.dispatchCounts.push_back(static_cast<double>(commandCounts.dispatchCount));
+	m_samples.uniformUpdateCounts.push_back(static_cast<double>(commandCounts.uniformUpdateCount));
+	m_samples.allocationCounts.push_back(static_cast<double>(endAllocations.allocationCount - beginAllocations.allocationCount));
+	m_samples.allocatedBytes.push_back(static_cast<double>(endAllocations.allocatedBytes - beginAllocations.allocatedBytes));
+}
+
+void BenchmarkRunner::Run()
+{
+	m_frameStageMs.assign(m_stageNames.size(), 0.0);
+
+	// Warmup loads shaders and builds resources which happen asynchronously over the first frames.
+	for (uint32_t frameIndex = 0U; frameIndex < m_config.warmupFrameCount; ++frameIndex)
+	{
+		RunFrame(false);
+	}
+
+	// Reserve all sample storage up front so that recording samples doesn't count as frame allocations.
+	const uint32_t frameCount = m_config.frameCount;
+	m_samples.frameMs.reserve(frameCount);
+	m_samples.stageMs.resize(m_stageNames.size());
+	for (std::vector<double>& stageSamples : m_samples.stageMs)
+	{
+		stageSamples.reserve(frameCount);
+	}
+	m_samples.drawCallCounts.reserve(frameCount);
+	m_samples.dispatchCounts.reserve(frameCount);
+	m_samples.uniformUpdateCounts.reserve(frameCount);
+	m_samples.allocationCounts.reserve(frameCount);
+	m_samples.allocatedBytes.reserve(frameCount);
+
+#ifdef ENABLE_PROFILING
+	if (engine::FrameProfiler::IsEnabled())
+	{
+		engine::FrameProfiler::Get().BeginCapture(frameCount);
+	}
+#endif
+
+	const Clock::time_point runBegin = Clock::now();
+	for (uint32_t frameIndex = 0U; frameIndex < frameCount; ++frameIndex)
+	{
+		RunFrame(true);
+	}
+	const Clock::time_point runEnd = Clock::now();
+
+	BuildReport(GetElapsedMs(runBegin, runEnd) / 1000.0);
+}
+
+void BenchmarkRunner::BuildReport(double totalSeconds)
+{
+	m_report.config = m_config;
+	m_report.sceneStats = m_pScene->GetStats();
+	m_report.threadCount = engine::JobSystem::Get().GetThreadCount();
+
+	m_report.pendingMaterialCount = 0U;
+	for (engine::Entity entity : m_pSceneWorld->GetMaterialEntities())
+	{
+		engine::MaterialComponent* pMaterialComponent = m_pSceneWorld->GetMaterialComponent(entity);
+		engine::ShaderResource* pShaderResource = pMaterialComponent ? pMaterialComponent->GetShaderResource() : nullptr;
+		if (pShaderResource && engine::ResourceStatus::Ready != pShaderResource->GetStatus() &&
+			engine::ResourceStatus::Optimized != pShaderResource->GetStatus())
+		{
+			++m_report.pendingMaterialCount;
+		}
+	}
+	if (m_report.pendingMaterialCount > 0U)
+	{
+		CD_WARN("{} materials have no loaded shaders. Compile shaders for {} before benchmarking.",
+			m_report.pendingMaterialCount, nameof::nameof_enum(m_config.shaderBackend));
+	}
+
+	m_report.measuredFrameCount = static_cast<uint32_t>(m_samples.frameMs.size());
+	m_report.totalSeconds = totalSeconds;
+	m_report.frameMs = Summarize(m_samples.frameMs);
+
+	m_report.stages.clear();
+	for (uint32_t stageIndex = 0U; stageIndex < m_stageNames.size(); ++stageIndex)
+	{
+		StageSummary& stage = m_report.stages.emplace_back();
+		stage.name = m_stageNames[stageIndex];
+		stage.ms = Summarize(m_samples.stageMs[stageIndex]);
+	}
+
+	m_report.drawCalls = Summarize(m_samples.drawCallCounts);
+	m_report.dispatches = Summarize(m_samples.dispatchCounts);
+	m_report.uniformUpdates = Summarize(m_samples.uniformUpdateCounts);
+	m_report.allocations = Summarize(m_samples.allocationCounts);
+	m_report.allocatedBytes = Summarize(m_samples.allocatedBytes);
+
+	const bgfx::Stats* pStats = bgfx::getStats();
+	m_report.programCount = pStats->numPrograms;
+	m_report.shaderCount = pStats->numShaders;
+	m_report.textureCount = pStats->numTextures;
+	m_report.uniformCount = pStats->numUniforms;
+	m_report.vertexBufferCount = pStats->numVertexBuffers;
+	m_report.indexBufferCount = pStats->numIndexBuffers;
+	m_report.frameBufferCount = pStats->numFrameBuffers;
+}
+
+void BenchmarkRunner::Shutdown()
+{
+	if (!m_pRenderContext)
+	{
+		return;
+	}
+
+	// Renderers and resources own bgfx handles so they are destroyed before RenderContext shuts down bgfx.
+	m_renderers.clear();
+	m_pScene.reset();
+	m_pSceneWorld.reset();
+	m_pRenderRecorder.reset();
+	m_pRenderContext->Shutdown();
+	m_pResourceContext.reset();
+	m_pRenderContext.reset();
+
+	engine::JobSystem::Get().Shutdown();
+}
+
+}
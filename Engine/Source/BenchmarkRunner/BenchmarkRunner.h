@@ -0,0 +1,96 @@
+#pragma once
+
+#include "BenchmarkConfig.h"
+#include "BenchmarkReport.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace engine
+{
+
+class ParallelRenderRecorder;
+class RenderContext;
+class Renderer;
+class ResourceContext;
+class SceneWorld;
+
+}
+
+namespace benchmark
+{
+
+class BenchmarkScene;
+
+// BenchmarkRunner boots the engine without window and UI on the Noop backend, builds a procedural scene
+// and measures a fixed number of frames. CPU costs of simulation, resource updates and every renderer are
+// the same as with a real backend while GPU work is skipped, so runs are comparable on any machine setup.
+class BenchmarkRunner final
+{
+public:
+	BenchmarkRunner() = delete;
+	explicit BenchmarkRunner(BenchmarkConfig config);
+	BenchmarkRunner(const BenchmarkRunner&) = delete;
+	BenchmarkRunner& operator=(const BenchmarkRunner&) = delete;
+	BenchmarkRunner(BenchmarkRunner&&) = delete;
+	BenchmarkRunner& operator=(BenchmarkRunner&&) = delete;
+	~BenchmarkRunner();
+
+	void Init();
+	void Run();
+	void Shutdown();
+
+	const BenchmarkReport& GetReport() const { return m_report; }
+
+private:
+	struct BenchmarkRenderer
+	{
+		std::string stageName;
+		std::unique_ptr<engine::Renderer> pRenderer;
+	};
+
+	struct FrameSamples
+	{
+		std::vector<double> frameMs;
+		std::vector<std::vector<double>> stageMs;
+		std::vector<double> drawCallCounts;
+		std::vector<double> dispatchCounts;
+		std::vector<double> uniformUpdateCounts;
+		std::vector<double> allocationCounts;
+		std::vector<double> allocatedBytes;
+	};
+
+	void InitRenderContext();
+	void InitMaterialTypes();
+	void InitRenderers();
+	void AddRenderer(const char* pName, std::unique_ptr<engine::Renderer> pRenderer);
+	uint32_t AddStage(std::string name);
+	void UpdateMaterials();
+	void RunFrame(bool isMeasured);
+	void BuildReport(double totalSeconds);
+
+private:
+	BenchmarkConfig m_config;
+
+	std::unique_ptr<engine::RenderContext> m_pRenderContext;
+	std::unique_ptr<engine::ResourceContext> m_pResourceContext;
+	std::unique_ptr<engine::SceneWorld> m_pSceneWorld;
+	std::unique_ptr<BenchmarkScene> m_pScene;
+	std::unique_ptr<engine::ParallelRenderRecorder> m_pRenderRecorder;
+	std::vector<BenchmarkRenderer> m_renderers;
+
+	// Stage samples are stored in the order of stage names.
+	std::vector<std::string> m_stageNames;
+	uint32_t m_simulationStage = 0U;
+	uint32_t m_resourceStage = 0U;
+	uint32_t m_materialStage = 0U;
+	uint32_t m_recordStage = 0U;
+	uint32_t m_submitStage = 0U;
+	FrameSamples m_samples;
+	std::vector<double> m_frameStageMs;
+
+	BenchmarkReport m_report;
+};
+
+}
@@ -0,0 +1,455 @@
+#include "BenchmarkScene.h"
+
+#include "BenchmarkConfig.h"
+#include "ECWorld/SceneWorld.h"
+#include "Framework/Processor.h"
+#include "Log/Log.h"
+#include "Math/MeshGenerator.h"
+#include "Math/Sphere.hpp"
+#include "Producers/CDProducer/CDProducer.h"
+#include "Rendering/LightUniforms.h"
+#include "Rendering/RenderContext.h"
+#include "Rendering/Resources/MeshResource.h"
+#include "Rendering/Resources/ResourceContext.h"
+#include "Rendering/Resources/SkeletonResource.h"
+#include "Rendering/ShadowMapRenderer.h"
+#include "Rendering/SkyType.h"
+#include "Scene/SceneDatabase.h"
+#include "Terrain/TerrainUtils.h"
+
+#include <bgfx/bgfx.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <filesystem>
+
+namespace
+{
+
+// Distance between neighbor grid cells. Generated shapes are 10 units wide.
+constexpr float GridSpacing = 30.0f;
+
+cd::Point GetGridPosition(uint32_t index, uint32_t count, float height)
+{
+	const uint32_t gridWidth = std::max(1U, static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(count)))));
+	const float halfExtent = 0.5f * static_cast<float>(gridWidth - 1U) * GridSpacing;
+	const float x = static_cast<float>(index % gridWidth) * GridSpacing - halfExtent;
+	const float z = static_cast<float>(index / gridWidth) * GridSpacing - halfExtent;
+	return cd::Point(x, height, z);
+}
+
+}
+
+namespace benchmark
+{
+
+BenchmarkScene::BenchmarkScene(engine::SceneWorld* pSceneWorld, engine::RenderContext* pRenderContext)
+	: m_pSceneWorld(pSceneWorld)
+	, m_pRenderContext(pRenderContext)
+	, m_pResourceContext(pRenderContext->GetResourceContext())
+{
+	assert(m_pSceneWorld && m_pResourceContext);
+}
+
+void BenchmarkScene::Build(const BenchmarkConfig& config)
+{
+	m_random.seed(config.seed);
+	m_stats = BenchmarkSceneStats();
+
+	AddCamera(config.width, config.height);
+	AddSky();
+	AddMeshes(config.meshCount);
+	AddLights(config.lightCount, config.shadowLightCount);
+	AddParticleEmitters(config.particleEmitterCount);
+	if (config.enableTerrain)
+	{
+		AddTerrain();
+	}
+
+	// SceneDatabase can reallocate meshes when merging so characters are added after everything else.
+	if (config.characterCount > 0U)
+	{
+		AddCharacters(config.characterModelPath, config.characterCount);
+	}
+}
+
+void BenchmarkScene::Update(float deltaTime)
+{
+	const cd::Vec3f axis(0.0f, 1.0f, 0.0f);
+	for (const SpinningMesh& spinningMesh : m_spinningMeshes)
+	{
+		engine::TransformComponent* pTransformComponent = m_pSceneWorld->GetTransformComponent(spinningMesh.entity);
+		cd::Transform& transform = pTransformComponent->GetTransform();
+		transform.SetRotation(cd::Quaternion::FromAxisAngle(axis, spinningMesh.angularSpeed * deltaTime) * transform.GetRotation());
+		pTransformComponent->Dirty();
+		pTransformComponent->Build();
+	}
+}
+
+engine::Entity BenchmarkScene::AddNamedEntity(const char* pName)
+{
+	engine::World* pWorld = m_pSceneWorld->GetWorld();
+	engine::Entity entity = pWorld->CreateEntity();
+	auto& nameComponent = pWorld->CreateComponent<engine::NameComponent>(entity);
+	nameComponent.SetName(pName + std::to_string(entity));
+	++m_stats.entityCount;
+
+	return entity;
+}
+
+void BenchmarkScene::AddCamera(uint16_t width, uint16_t height)
+{
+	engine::World* pWorld = m_pSceneWorld->GetWorld();
+
+	engine::Entity cameraEntity = pWorld->CreateEntity();
+	m_pSceneWorld->SetMainCameraEntity(cameraEntity);
+	++m_stats.entityCount;
+	auto& nameComponent = pWorld->CreateComponent<engine::NameComponent>(cameraEntity);
+	nameComponent.SetName("MainCamera");
+
+	auto& cameraTransformComponent = pWorld->CreateComponent<engine::TransformComponent>(cameraEntity);
+	cameraTransformComponent.SetTransform(cd::Transform::Identity());
+	cameraTransformComponent.Build();
+
+	// Look down at the grid from one side so that most generated objects are in the frustum.
+	auto& cameraTransform = cameraTransformComponent.GetTransform();
+	cameraTransform.SetTranslation(cd::Point(0.0f, 200.0f, -500.0f));
+	engine::CameraComponent::SetLookAt(cd::Direction(0.0f, -0.4f, 1.0f).Normalize(), cameraTransform);
+	engine::CameraComponent::SetUp(cd::Direction(0.0f, 1.0f, 0.0f), cameraTransform);
+
+	auto& cameraComponent = pWorld->CreateComponent<engine::CameraComponent>(cameraEntity);
+	cameraComponent.SetAspect(static_cast<float>(width) / static_cast<float>(height));
+	cameraComponent.SetFov(45.0f);
+	cameraComponent.SetNearPlane(0.1f);
+	cameraComponent.SetFarPlane(2000.0f);
+	cameraComponent.SetNDCDepth(bgfx::getCaps()->homogeneousDepth ? cd::NDCDepth::MinusOneToOne : cd::NDCDepth::ZeroToOne);
+	cameraComponent.SetExposure(1.0f);
+	cameraComponent.SetGammaCorrection(0.45f);
+	cameraComponent.SetToneMappingMode(cd::ToneMappingMode::ACES);
+	cameraComponent.SetBloomEnable(false);
+	cameraComponent.SetBlurEnable(false);
+	cameraComponent.BuildProjectMatrix();
+	cameraComponent.BuildViewMatrix(cameraTransform);
+}
+
+void BenchmarkScene::AddSky()
+{
+	engine::World* pWorld = m_pSceneWorld->GetWorld();
+
+	engine::Entity skyEntity = pWorld->CreateEntity();
+	m_pSceneWorld->SetSkyEntity(skyEntity);
+	++m_stats.entityCount;
+
+	auto& nameComponent = pWorld->CreateComponent<engine::NameComponent>(skyEntity);
+	nameComponent.SetName("Sky");
+
+	pWorld->CreateComponent<engine::SkyComponent>(skyEntity);
+
+	cd::VertexFormat vertexFormat;
+	vertexFormat.AddVertexAttributeLayout(cd::VertexAttributeType::Position, cd::AttributeValueType::Float, 3);
+	m_pRenderContext->CreateVertexLayout(engine::StringCrc("PosistionOnly"), vertexFormat.GetVertexAttributeLayouts());
+
+	cd::Box skyBox(cd::Point(-1.0f), cd::Point(1.0f));
+	m_optSkyMesh = cd::MeshGenerator::Generate(skyBox, vertexFormat, false);
+	assert(m_optSkyMesh.has_value());
+
+	auto& meshComponent = pWorld->CreateComponent<engine::StaticMeshComponent>(skyEntity);
+	constexpr engine::StringCrc skyboxMeshCrc("SkyboxMesh");
+	engine::MeshResource* pMeshResource = m_pResourceContext->AddMeshResource(skyboxMeshCrc);
+	pMeshResource->SetMeshAsset(&m_optSkyMesh.value());
+	pMeshResource->UpdateVertexFormat(vertexFormat);
+	meshComponent.SetMeshResource(pMeshResource);
+}
+
+void BenchmarkScene::AddMeshes(uint32_t meshCount)
+{
+	if (0U == meshCount)
+	{
+		return;
+	}
+
+	engine::World* pWorld = m_pSceneWorld->GetWorld();
+	engine::MaterialType* pPBRMaterialType = m_pSceneWorld->GetPBRMaterialType();
+	const cd::VertexFormat& vertexFormat = pPBRMaterialType->GetRequiredVertexFormat();
+	const engine::ShaderFeature skyFeature = engine::GetSkyTypeShaderFeature(m_pSceneWorld->GetSkyComponent(m_pSceneWorld->GetSkyEntity())->GetSkyType());
+
+	m_optBoxMesh = cd::MeshGenerator::Generate(cd::Box(cd::Point(-5.0f), cd::Point(5.0f)), vertexFormat);
+	m_optSphereMesh = cd::MeshGenerator::Generate(cd::Sphere(cd::Point(0.0f), 5.0f), 32U, 32U, vertexFormat);
+	assert(m_optBoxMesh.has_value() && m_optSphereMesh.has_value());
+
+	constexpr engine::StringCrc boxMeshCrc("BenchmarkBoxMesh");
+	constexpr engine::StringCrc sphereMeshCrc("BenchmarkSphereMesh");
+	engine::MeshResource* pBoxMeshResource = m_pResourceContext->AddMeshResource(boxMeshCrc);
+	pBoxMeshResource->SetMeshAsset(&m_optBoxMesh.value());
+	pBoxMeshResource->UpdateVertexFormat(vertexFormat);
+	engine::MeshResource* pSphereMeshResource = m_pResourceContext->AddMeshResource(sphereMeshCrc);
+	pSphereMeshResource->SetMeshAsset(&m_optSphereMesh.value());
+	pSphereMeshResource->UpdateVertexFormat(vertexFormat);
+
+	std::uniform_real_distribution<float> angleDistribution(0.0f, cd::Math::TWO_PI);
+	std::uniform_real_distribution<float> speedDistribution(-1.0f, 1.0f);
+	m_spinningMeshes.reserve(meshCount);
+	for (uint32_t meshIndex = 0U; meshIndex < meshCount; ++meshIndex)
+	{
+		// Alternate shapes so that draw calls switch vertex buffers like a real scene.
+		const bool isBox = 0U == (meshIndex & 1U);
+		const cd::Mesh& mesh = isBox ? m_optBoxMesh.value() : m_optSphereMesh.value();
+
+		engine::Entity entity = AddNamedEntity(isBox ? "Box" : "Sphere");
+
+		auto& collisionMeshComponent = pWorld->CreateComponent<engine::CollisionMeshComponent>(entity);
+		collisionMeshComponent.SetType(engine::CollisonMeshType::AABB);
+		collisionMeshComponent.SetAABB(mesh.GetAABB());
+		collisionMeshComponent.Build();
+
+		auto& staticMeshComponent = pWorld->CreateComponent<engine::StaticMeshComponent>(entity);
+		staticMeshComponent.SetMeshResource(isBox ? pBoxMeshResource : pSphereMeshResource);
+
+		auto& materialComponent = pWorld->CreateComponent<engine::MaterialComponent>(entity);
+		materialComponent.Init();
+		materialComponent.SetMaterialType(pPBRMaterialType);
+		materialComponent.ActivateShaderFeature(skyFeature);
+
+		const cd::Quaternion rotation = cd::Quaternion::FromAxisAngle(cd::Vec3f(0.0f, 1.0f, 0.0f), angleDistribution(m_random));
+		auto& transformComponent = pWorld->CreateComponent<engine::TransformComponent>(entity);
+		transformComponent.SetTransform(cd::Transform(GetGridPosition(meshIndex, meshCount, 5.0f), rotation, cd::Vec3f::One()));
+		transformComponent.Build();
+
+		m_spinningMeshes.push_back({ entity, speedDistribution(m_random) });
+
+		++m_stats.meshCount;
+		m_stats.vertexCount += mesh.GetVertexCount();
+		m_stats.polygonCount += mesh.GetPolygonCount();
+	}
+}
+
+void BenchmarkScene::AddLights(uint32_t lightCount, uint32_t shadowLightCount)
+{
+	// Light uniforms and shadow passes have fixed sizes.
+	if (lightCount > engine::MAX_LIGHT_COUNT)
+	{
+		CD_WARN("Light count {} is clamped to {}.", lightCount, engine::MAX_LIGHT_COUNT);
+		lightCount = engine::MAX_LIGHT_COUNT;
+	}
+	shadowLightCount = std::min(std::min(shadowLightCount, lightCount), static_cast<uint32_t>(engine::shadowLightMaxNum));
+
+	engine::World* pWorld = m_pSceneWorld->GetWorld();
+	std::uniform_real_distribution<float> positionDistribution(-200.0f, 200.0f);
+	for (uint32_t lightIndex = 0U; lightIndex < lightCount; ++lightIndex)
+	{
+		const bool isCastShadow = lightIndex < shadowLightCount;
+
+		// The first light is the sun. Others alternate between point and spot lights.
+		cd::LightType lightType = cd::LightType::Directional;
+		if (lightIndex > 0U)
+		{
+			lightType = 0U == (lightIndex & 1U) ? cd::LightType::Spot : cd::LightType::Point;
+		}
+
+		engine::Entity entity = AddNamedEntity(cd::LightType::Directional == lightType ? "DirectionalLight" :
+			(cd::LightType::Point == lightType ? "PointLight" : "SpotLight"));
+
+		auto& lightComponent = pWorld->CreateComponent<engine::LightComponent>(entity);
+		lightComponent.SetType(lightType);
+		lightComponent.SetColor(cd::Vec3f(1.0f, 1.0f, 1.0f));
+		lightComponent.SetShadowMapSize(1024U);
+		lightComponent.SetIsCastShadow(isCastShadow);
+		lightComponent.SetShadowBias(0.0f);
+		lightComponent.SetShadowMapTexture(BGFX_INVALID_HANDLE);
+		if (cd::LightType::Directional == lightType)
+		{
+			lightComponent.SetIntensity(4.0f);
+			lightComponent.SetDirection(cd::Direction(0.3f, -1.0f, 0.5f).Normalize());
+			lightComponent.SetCascadeNum(4);
+			lightComponent.SetFrustumClips(cd::Vec4f(0.0f, 0.0f, 0.0f, 0.0f));
+		}
+		else
+		{
+			lightComponent.SetIntensity(1024.0f);
+			lightComponent.SetPosition(cd::Point(positionDistribution(m_random), 40.0f, positionDistribution(m_random)));
+			lightComponent.SetRange(1024.0f);
+			if (cd::LightType::Spot == lightType)
+			{
+				lightComponent.SetDirection(cd::Direction(0.0f, -1.0f, 0.0f));
+				lightComponent.SetInnerAndOuter(24.0f, 40.0f);
+			}
+		}
+
+		auto& transformComponent = pWorld->CreateComponent<engine::TransformComponent>(entity);
+		transformComponent.SetTransform(cd::Transform::Identity());
+		transformComponent.Build();
+
+		++m_stats.lightCount;
+		if (isCastShadow)
+		{
+			++m_stats.shadowLightCount;
+		}
+	}
+}
+
+void BenchmarkScene::AddParticleEmitters(uint32_t emitterCount)
+{
+	engine::World* pWorld = m_pSceneWorld->GetWorld();
+	engine::MaterialType* pParticleMaterialType = m_pSceneWorld->GetParticleMaterialType();
+	for (uint32_t emitterIndex = 0U; emitterIndex < emitterCount; ++emitterIndex)
+	{
+		engine::Entity entity = AddNamedEntity("ParticleEmitter");
+		auto& particleEmitterComponent = pWorld->CreateComponent<engine::ParticleEmitterComponent>(entity);
+		auto& particleRibbonComponent = pWorld->CreateComponent<engine::ParticleRibbonComponent>(entity);
+		auto& particleMaterialComponent = pWorld->CreateComponent<engine::MaterialComponent>(entity);
+
+		auto& transformComponent = pWorld->CreateComponent<engine::TransformComponent>(entity);
+		transformComponent.SetTransform(cd::Transform::Identity());
+		transformComponent.GetTransform().SetTranslation(GetGridPosition(emitterIndex, emitterCount, 20.0f));
+		transformComponent.Build();
+
+		particleEmitterComponent.SetRequiredVertexFormat(&pParticleMaterialType->GetRequiredVertexFormat());
+		particleMaterialComponent.Init();
+		particleMaterialComponent.SetMaterialType(pParticleMaterialType);
+		particleEmitterComponent.Build();
+		particleRibbonComponent.Build();
+
+		++m_stats.particleEmitterCount;
+	}
+}
+
+void BenchmarkScene::AddTerrain()
+{
+	engine::World* pWorld = m_pSceneWorld->GetWorld();
+	engine::MaterialType* pTerrainMaterialType = m_pSceneWorld->GetTerrainMaterialType();
+
+	engine::Entity entity = AddNamedEntity("Terrain");
+
+	auto& terrainComponent = pWorld->CreateComponent<engine::TerrainComponent>(entity);
+	terrainComponent.InitElevationRawData();
+
+	m_optTerrainMesh = engine::GenerateTerrainMesh(terrainComponent.GetMeshWidth(), terrainComponent.GetMeshDepth(), pTerrainMaterialType->GetRequiredVertexFormat());
+	assert(m_optTerrainMesh.has_value());
+
+	auto& meshComponent = pWorld->CreateComponent<engine::StaticMeshComponent>(entity);
+	constexpr engine::StringCrc nameCrc("TerrainMesh");
+	engine::MeshResource* pMeshResource = m_pResourceContext->AddMeshResource(nameCrc);
+	pMeshResource->SetMeshAsset(&m_optTerrainMesh.value());
+	pMeshResource->UpdateVertexFormat(pTerrainMaterialType->GetRequiredVertexFormat());
+	meshComponent.SetMeshResource(pMeshResource);
+
+	auto& materialComponent = pWorld->CreateComponent<engine::MaterialComponent>(entity);
+	materialComponent.Init();
+	materialComponent.SetMaterialType(pTerrainMaterialType);
+	materialComponent.SetTwoSided(true);
+	materialComponent.ActivateShaderFeature(engine::GetSkyTypeShaderFeature(m_pSceneWorld->GetSkyComponent(m_pSceneWorld->GetSkyEntity())->GetSkyType()));
+
+	auto& transformComponent = pWorld->CreateComponent<engine::TransformComponent>(entity);
+	transformComponent.SetTransform(cd::Transform::Identity());
+	transformComponent.Build();
+
+	++m_stats.terrainCount;
+	m_stats.vertexCount += m_optTerrainMesh->GetVertexCount();
+	m_stats.polygonCount += m_optTerrainMesh->GetPolygonCount();
+}
+
+void BenchmarkScene::AddCharacters(const std::string& modelFilePath, uint32_t characterCount)
+{
+	// AssetPipeline has no API to author skeletons and animations procedurally so characters are instances of a model.
+	if (modelFilePath.empty() || !std::filesystem::exists(modelFilePath))
+	{
+		CD_WARN("Skip {} characters because model file \"{}\" doesn't exist.", characterCount, modelFilePath);
+		return;
+	}
+
+	cd::SceneDatabase* pSceneDatabase = m_pSceneWorld->GetSceneDatabase();
+	const uint32_t oldMeshCount = pSceneDatabase->GetMeshCount();
+	{
+		cd::SceneDatabase newSceneDatabase;
+		cdtools::CDProducer cdProducer(modelFilePath.c_str());
+		cdtools::Processor processor(&cdProducer, nullptr, &newSceneDatabase);
+		processor.Run();
+		pSceneDatabase->Merge(cd::MoveTemp(newSceneDatabase));
+	}
+
+	// Same as ECWorldConsumer, skinned meshes play the first animation and use the first skeleton.
+	const cd::Mesh* pSkinMesh = nullptr;
+	for (uint32_t meshIndex = oldMeshCount; meshIndex < pSceneDatabase->GetMeshCount(); ++meshIndex)
+	{
+		const cd::Mesh& mesh = pSceneDatabase->GetMesh(meshIndex);
+		if (mesh.GetSkinIDCount() > 0U)
+		{
+			pSkinMesh = &mesh;
+			break;
+		}
+	}
+
+	if (!pSkinMesh || 0U == pSceneDatabase->GetAnimationCount() || 0U == pSceneDatabase->GetSkeletonCount())
+	{
+		CD_WARN("Skip characters because \"{}\" doesn't have a skinned mesh with animation.", modelFilePath);
+		return;
+	}
+
+	engine::World* pWorld = m_pSceneWorld->GetWorld();
+	engine::MaterialType* pAnimationMaterialType = m_pSceneWorld->GetAnimationMaterialType();
+
+	engine::MeshResource* pMeshResource = m_pResourceContext->AddMeshResource(engine::StringCrc(std::string(pSkinMesh->GetName())));
+	for (auto skinID : pSkinMesh->GetSkinIDs())
+	{
+		const cd::Skin& skin = pSceneDatabase->GetSkin(skinID.Data());
+		pMeshResource->SetSkinAsset(&skin);
+		const cd::Skeleton& skeleton = pSceneDatabase->GetSkeleton(skin.GetSkeletonID().Data());
+		for (auto boneID : skeleton.GetBoneIDs())
+		{
+			pMeshResource->AddBonesAsset(pSceneDatabase->GetBone(boneID.Data()));
+		}
+	}
+	pMeshResource->SetMeshAsset(pSkinMesh);
+	pMeshResource->UpdateVertexFormat(pAnimationMaterialType->GetRequiredVertexFormat());
+
+	const cd::Skeleton& skeleton = pSceneDatabase->GetSkeleton(0);
+	engine::SkeletonResource* pSkeletonResource = m_pResourceContext->AddSkeletonResource(engine::StringCrc(std::string(skeleton.GetName())));
+	pSkeletonResource->SetSceneDataBase(pSceneDatabase);
+
+	const cd::Animation& animation = pSceneDatabase->GetAnimation(0);
+	const engine::ShaderFeature skyFeature = engine::GetSkyTypeShaderFeature(m_pSceneWorld->GetSkyComponent(m_pSceneWorld->GetSkyEntity())->GetSkyType());
+	bgfx::UniformHandle boneMatricesUniform = m_pRenderContext->CreateUniform("u_boneMatrices", bgfx::UniformType::Mat4, 128);
+
+	std::uniform_real_distribution<float> playTimeDistribution(0.0f, animation.GetDuration());
+	for (uint32_t characterIndex = 0U; characterIndex < characterCount; ++characterIndex)
+	{
+		engine::Entity entity = AddNamedEntity("Character");
+
+		auto& collisionMeshComponent = pWorld->CreateComponent<engine::CollisionMeshComponent>(entity);
+		collisionMeshComponent.SetType(engine::CollisonMeshType::AABB);
+		collisionMeshComponent.SetAABB(pSkinMesh->GetAABB());
+		collisionMeshComponent.Build();
+
+		auto& staticMeshComponent = pWorld->CreateComponent<engine::StaticMeshComponent>(entity);
+		staticMeshComponent.SetMeshResource(pMeshResource);
+
+		auto& animationComponent = pWorld->CreateComponent<engine::AnimationComponent>(entity);
+		animationComponent.SetAnimationData(&animation);
+		animationComponent.SetTrackData(pSceneDatabase->GetTracks().data());
+		animationComponent.SetDuration(animation.GetDuration());
+		animationComponent.SetTicksPerSecond(animation.GetTicksPerSecond());
+		animationComponent.SetBoneMatricesUniform(boneMatricesUniform.idx);
+		// Characters don't move in lockstep.
+		animationComponent.SetAnimationPlayTime(playTimeDistribution(m_random));
+
+		auto& materialComponent = pWorld->CreateComponent<engine::MaterialComponent>(entity);
+		materialComponent.Init();
+		materialComponent.SetMaterialType(pAnimationMaterialType);
+		materialComponent.ActivateShaderFeature(skyFeature);
+
+		auto& skeletonComponent = pWorld->CreateComponent<engine::SkeletonComponent>(entity);
+		skeletonComponent.SetSkeletonAsset(pSkeletonResource);
+
+		auto& transformComponent = pWorld->CreateComponent<engine::TransformComponent>(entity);
+		transformComponent.SetTransform(cd::Transform::Identity());
+		transformComponent.GetTransform().SetTranslation(GetGridPosition(characterIndex, characterCount, 0.0f) + cd::Point(0.5f * GridSpacing, 0.0f, 0.5f * GridSpacing));
+		transformComponent.Build();
+
+		++m_stats.characterCount;
+		m_stats.vertexCount += pSkinMesh->GetVertexCount();
+		m_stats.polygonCount += pSkinMesh->GetPolygonCount();
+	}
+}
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "ECWorld/Entity.h"
+#include "Scene/Mesh.h"
+
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace engine
+{
+
+class RenderContext;
+class ResourceContext;
+class SceneWorld;
+
+}
+
+namespace benchmark
+{
+
+struct BenchmarkConfig;
+
+// Entity counts of the built scene. Requested counts can be clamped by engine limits.
+struct BenchmarkSceneStats
+{
+	uint32_t entityCount = 0U;
+	uint32_t meshCount = 0U;
+	uint32_t lightCount = 0U;
+	uint32_t shadowLightCount = 0U;
+	uint32_t particleEmitterCount = 0U;
+	uint32_t terrainCount = 0U;
+	uint32_t characterCount = 0U;
+	uint64_t vertexCount = 0U;
+	uint64_t polygonCount = 0U;
+};
+
+// BenchmarkScene builds scenes procedurally so that runs are reproducible without project assets.
+// Meshes are generated shapes placed on a grid, skinned characters are instances of one .cdbin model.
+class BenchmarkScene final
+{
+public:
+	BenchmarkScene() = delete;
+	explicit BenchmarkScene(engine::SceneWorld* pSceneWorld, engine::RenderContext* pRenderContext);
+	BenchmarkScene(const BenchmarkScene&) = delete;
+	BenchmarkScene& operator=(const BenchmarkScene&) = delete;
+	BenchmarkScene(BenchmarkScene&&) = delete;
+	BenchmarkScene& operator=(BenchmarkScene&&) = delete;
+	~BenchmarkScene() = default;
+
+	void Build(const BenchmarkConfig& config);
+
+	// Spins generated meshes so that transforms and shadow casters change every frame like a simulated scene.
+	void Update(float deltaTime);
+
+	const BenchmarkSceneStats& GetStats() const { return m_stats; }
+
+private:
+	engine::Entity AddNamedEntity(const char* pName);
+	void AddCamera(uint16_t width, uint16_t height);
+	void AddSky();
+	void AddMeshes(uint32_t meshCount);
+	void AddLights(uint32_t lightCount, uint32_t shadowLightCount);
+	void AddParticleEmitters(uint32_t emitterCount);
+	void AddTerrain();
+	void AddCharacters(const std::string& modelFilePath, uint32_t characterCount);
+
+private:
+	engine::SceneWorld* m_pSceneWorld;
+	engine::RenderContext* m_pRenderContext;
+	engine::ResourceContext* m_pResourceContext;
+
+	std::mt19937 m_random;
+	BenchmarkSceneStats m_stats;
+
+	// MeshResources reference mesh assets until they are built. Instances of one shape share its MeshResource.
+	std::optional<cd::Mesh> m_optSkyMesh;
+	std::optional<cd::Mesh> m_optBoxMesh;
+	std::optional<cd::Mesh> m_optSphereMesh;
+	std::optional<cd::Mesh> m_optTerrainMesh;
+
+	struct SpinningMesh
+	{
+		engine::Entity entity;
+		float angularSpeed;
+	};
+	std::vector<SpinningMesh> m_spinningMeshes;
+};
+
+}
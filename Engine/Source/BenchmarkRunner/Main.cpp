@@ -0,0 +1,182 @@
+#include "BenchmarkReport.h"
+#include "BenchmarkRunner.h"
+
+#include "Base/NameOf.h"
+#include "Base/Template.h"
+#include "Log/Log.h"
+#include "Profiling/FrameProfiler.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+
+namespace
+{
+
+struct CommandLineArgs
+{
+	benchmark::BenchmarkConfig config;
+	const char* pOutputFilePath = nullptr;
+	const char* pBaselineFilePath = nullptr;
+	double threshold = 0.1;
+	const char* pTraceFilePath = nullptr;
+};
+
+void PrintUsage()
+{
+	std::printf(
+		"Usage: BenchmarkRunner [options]\n"
+		"  --name <string>             Name of the run in the report.\n"
+		"  --frames <count>            Measured frames. Default 300.\n"
+		"  --warmup <count>            Frames before measuring. Default 60.\n"
+		"  --meshes <count>            Static meshes. Default 256.\n"
+		"  --lights <count>            Lights, clamped to the engine limit. Default 3.\n"
+		"  --shadow-lights <count>     Lights which cast shadows. Default 1.\n"
+		"  --emitters <count>          Particle emitters. Default 8.\n"
+		"  --characters <count>        Skinned character instances. Needs --character-model.\n"
+		"  --character-model <path>    .cdbin model with skeleton and animation.\n"
+		"  --no-terrain                Don't add terrain.\n"
+		"  --seed <number>             Seed of procedural placement. Default 1.\n"
+		"  --width <pixels> --height <pixels>\n"
+		"  --shader-backend <name>     Folder of compiled shaders, e.g. Direct3D11 or Vulkan.\n"
+		"  --threads <count>           JobSystem threads including main. 0 uses all cores.\n"
+		"  --serial                    Record all renderers on the main thread.\n"
+		"  --output <path>             Write the json report to a file instead of stdout.\n"
+		"  --baseline <path>           Compare with an earlier report. Exits with 1 on any regression.\n"
+		"  --threshold <ratio>         Allowed growth against the baseline. Default 0.1.\n"
+		"  --trace <path>              Save a Chrome trace of measured frames. Needs ENABLE_PROFILING.\n");
+}
+
+std::optional<engine::GraphicsBackend> ParseGraphicsBackend(const char* pName)
+{
+	for (int backendIndex = 0; backendIndex < static_cast<int>(engine::GraphicsBackend::Count); ++backendIndex)
+	{
+		auto backend = static_cast<engine::GraphicsBackend>(backendIndex);
+		if (nameof::nameof_enum(backend) == pName)
+		{
+			return backend;
+		}
+	}
+
+	return std::nullopt;
+}
+
+bool ParseCommandLine(int argc, char** argv, CommandLineArgs& args)
+{
+	benchmark::BenchmarkConfig& config = args.config;
+	for (int argIndex = 1; argIndex < argc; ++argIndex)
+	{
+		const char* pArg = argv[argIndex];
+		const bool hasValue = argIndex + 1 < argc;
+		auto nextValue = [&]() { return argv[++argIndex]; };
+		auto nextUInt = [&]() { return static_cast<uint32_t>(std::strtoul(nextValue(), nullptr, 10)); };
+
+		if (0 == std::strcmp(pArg, "--no-terrain"))
+		{
+			config.enableTerrain = false;
+		}
+		else if (0 == std::strcmp(pArg, "--serial"))
+		{
+			config.enableParallelRecord = false;
+		}
+		else if (0 == std::strcmp(pArg, "--help"))
+		{
+			return false;
+		}
+		else if (!hasValue)
+		{
+			std::fprintf(stderr, "Missing value or unknown option %s.\n", pArg);
+			return false;
+		}
+		else if (0 == std::strcmp(pArg, "--name")) { config.name = nextValue(); }
+		else if (0 == std::strcmp(pArg, "--frames")) { config.frameCount = nextUInt(); }
+		else if (0 == std::strcmp(pArg, "--warmup")) { config.warmupFrameCount = nextUInt(); }
+		else if (0 == std::strcmp(pArg, "--meshes")) { config.meshCount = nextUInt(); }
+		else if (0 == std::strcmp(pArg, "--lights")) { config.lightCount = nextUInt(); }
+		else if (0 == std::strcmp(pArg, "--shadow-lights")) { config.shadowLightCount = nextUInt(); }
+		else if (0 == std::strcmp(pArg, "--emitters")) { config.particleEmitterCount = nextUInt(); }
+		else if (0 == std::strcmp(pArg, "--characters")) { config.characterCount = nextUInt(); }
+		else if (0 == std::strcmp(pArg, "--character-model")) { config.characterModelPath = nextValue(); }
+		else if (0 == std::strcmp(pArg, "--seed")) { config.seed = nextUInt(); }
+		else if (0 == std::strcmp(pArg, "--width")) { config.width = static_cast<uint16_t>(nextUInt()); }
+		else if (0 == std::strcmp(pArg, "--height")) { config.height = static_cast<uint16_t>(nextUInt()); }
+		else if (0 == std::strcmp(pArg, "--threads")) { config.threadCount = nextUInt(); }
+		else if (0 == std::strcmp(pArg, "--output")) { args.pOutputFilePath = nextValue(); }
+		else if (0 == std::strcmp(pArg, "--baseline")) { args.pBaselineFilePath = nextValue(); }
+		else if (0 == std::strcmp(pArg, "--threshold")) { args.threshold = std::strtod(nextValue(), nullptr); }
+		else if (0 == std::strcmp(pArg, "--trace")) { args.pTraceFilePath = nextValue(); }
+		else if (0 == std::strcmp(pArg, "--shader-backend"))
+		{
+			const char* pBackendName = nextValue();
+			std::optional<engine::GraphicsBackend> optBackend = ParseGraphicsBackend(pBackendName);
+			if (!optBackend.has_value() || engine::GraphicsBackend::Noop == optBackend.value())
+			{
+				std::fprintf(stderr, "Unknown shader backend %s.\n", pBackendName);
+				return false;
+			}
+			config.shaderBackend = optBackend.value();
+		}
+		else
+		{
+			std::fprintf(stderr, "Unknown option %s.\n", pArg);
+			return false;
+		}
+	}
+
+	if (0U == config.frameCount || 0U == config.width || 0U == config.height)
+	{
+		std::fprintf(stderr, "Frame count and resolution should not be zero.\n");
+		return false;
+	}
+
+	return true;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	CommandLineArgs args;
+	if (!ParseCommandLine(argc, argv, args))
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	engine::Log::Init();
+
+#ifdef ENABLE_PROFILING
+	// Zones are only recorded when a trace is requested so that profiling doesn't change the measured timings.
+	engine::FrameProfiler::SetEnable(nullptr != args.pTraceFilePath);
+#endif
+
+	benchmark::BenchmarkRunner runner(cd::MoveTemp(args.config));
+	runner.Init();
+	runner.Run();
+
+	const benchmark::BenchmarkReport& report = runner.GetReport();
+	if (!benchmark::WriteReport(report, args.pOutputFilePath))
+	{
+		return EXIT_FAILURE;
+	}
+
+#ifdef ENABLE_PROFILING
+	if (args.pTraceFilePath)
+	{
+		engine::FrameProfiler::Get().WriteChromeTrace(args.pTraceFilePath);
+	}
+#endif
+
+	uint32_t regressionCount = 0U;
+	if (args.pBaselineFilePath)
+	{
+		regressionCount = benchmark::CompareWithBaseline(report, args.pBaselineFilePath, args.threshold);
+	}
+
+	runner.Shutdown();
+
+	// Exit codes are truncated to 8 bits by shells, 256 regressions must not look like success.
+	return regressionCount > 0U ? 1 : 0;
+}
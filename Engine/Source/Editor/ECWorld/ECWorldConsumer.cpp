@@ -15,11 +15,17 @@
 #include "Resources/ResourceBuilder.h"
 #include "Resources/ResourceLoader.h"
 #include "Resources/ShaderBuilder.h"
+#include "Resources/TextureCookProfile.h"
 #include "Rendering/Utility/VertexLayoutUtility.h"
 #include "Scene/SceneDatabase.h"
 
+#include <bgfx/bgfx.h>
+#include <bimg/decode.h>
+
 #include <algorithm>
+#include <cstring>
 #include <filesystem>
+#include <tuple>
 
 namespace editor
 {
@@ -118,6 +124,16 @@ void ECWorldConsumer::Execute(const cd::SceneDatabase* pSceneDatabase)
 		engine::Entity lightEntity = m_pSceneWorld->GetWorld()->CreateEntity();
 		AddLight(lightEntity, light);
 	}
+
+	if (m_enableTextureArrayPacking && !m_materialEntities.empty())
+	{
+		// Packing reads built DDS files so it waits for texture build tasks.
+		ResourceBuilder::Get().AddIdleCallback([pSceneWorld = m_pSceneWorld, pResourceContext = m_pResourceContext, materialEntities = m_materialEntities]()
+		{
+			PackMaterialTextureArrays(pSceneWorld, pResourceContext, materialEntities);
+		});
+	}
+	m_materialEntities.clear();
 }
 
 void ECWorldConsumer::AddCamera(engine::Entity entity, const cd::Camera& camera)
@@ -251,10 +267,15 @@ void ECWorldConsumer::AddMaterial(engine::Entity entity, const cd::Material* pMa
 	{
 		return;
 	}
+	m_materialEntities.push_back(entity);
 
 	std::set<uint8_t> compiledTextureSlot;
 	std::vector<std::tuple<cd::MaterialTextureType, std::string, const cd::Texture*>> outputTypeToData;
 
+	// Occlusion, Roughness and Metallic textures are packed into one ORM texture.
+	constexpr cd::MaterialTextureType ormTextureTypes[3] = { cd::MaterialTextureType::Occlusion, cd::MaterialTextureType::Roughness, cd::MaterialTextureType::Metallic };
+	const cd::Texture* ormTextures[3] = { nullptr, nullptr, nullptr };
+
 	// Expected textures are ready to build. Add more optional texture data.
 	for (cd::MaterialTextureType optionalTextureType : pMaterialType->GetOptionalTextureTypes())
 	{
@@ -273,6 +294,13 @@ void ECWorldConsumer::AddMaterial(engine::Entity entity, const cd::Material* pMa
 
 		uint8_t textureSlot = optTextureSlot.value();
 		const cd::Texture& optionalTexture = pSceneDatabase->GetTexture(textureID.Data());
+		if (TextureCookProfile::IsORMTextureType(optionalTextureType))
+		{
+			auto itORM = std::find(std::begin(ormTextureTypes), std::end(ormTextureTypes), optionalTextureType);
+			ormTextures[std::distance(std::begin(ormTextureTypes), itORM)] = &optionalTexture;
+			continue;
+		}
+
 		std::string outputTexturePath = engine::Path::GetTextureOutputFilePath(optionalTexture.GetPath(), ".dds");
 		if (compiledTextureSlot.find(textureSlot) == compiledTextureSlot.end())
 		{
@@ -283,6 +311,52 @@ void ECWorldConsumer::AddMaterial(engine::Entity entity, const cd::Material* pMa
 		outputTypeToData.emplace_back(optionalTextureType, cd::MoveTemp(outputTexturePath), &optionalTexture);
 	}
 
+	std::string ormOutputName;
+	const char* ormInputFilePaths[3] = { nullptr, nullptr, nullptr };
+	bool isPackedORM = true;
+	for (uint32_t ormIndex = 0U; ormIndex < 3U; ++ormIndex)
+	{
+		if (!ormTextures[ormIndex])
+		{
+			isPackedORM = false;
+			continue;
+		}
+
+		ormInputFilePaths[ormIndex] = ormTextures[ormIndex]->GetPath();
+		std::string stem = engine::Path::GetFileNameWithoutExtension(ormInputFilePaths[ormIndex]);
+		if (ormOutputName.find(stem) == std::string::npos)
+		{
+			ormOutputName += ormOutputName.empty() ? stem : "_" + stem;
+		}
+
+		if (0U != ormIndex && (!ormInputFilePaths[0] || 0 != std::strcmp(ormInputFilePaths[0], ormInputFilePaths[ormIndex])))
+		{
+			isPackedORM = false;
+		}
+	}
+
+	if (!ormOutputName.empty())
+	{
+		std::string ormOutputTexturePath = engine::Path::GetTextureOutputFilePath(ormOutputName.c_str(), ".dds");
+		if (isPackedORM)
+		{
+			// Source texture is already packed.
+			ResourceBuilder::Get().AddTextureBuildTask(cd::MaterialTextureType::Occlusion, ormInputFilePaths[0], ormOutputTexturePath.c_str());
+		}
+		else
+		{
+			ResourceBuilder::Get().AddORMTextureBuildTask(ormInputFilePaths[0], ormInputFilePaths[1], ormInputFilePaths[2], ormOutputTexturePath.c_str());
+		}
+
+		for (uint32_t ormIndex = 0U; ormIndex < 3U; ++ormIndex)
+		{
+			if (ormTextures[ormIndex])
+			{
+				outputTypeToData.emplace_back(ormTextureTypes[ormIndex], ormOutputTexturePath, ormTextures[ormIndex]);
+			}
+		}
+	}
+
 	// TODO : create material component before ResourceBuilder done.
 	// Assign a special color for loading resource status.
 	
@@ -485,4 +559,177 @@ void ECWorldConsumer::AddSkeleton(engine::Entity entity, const cd::SceneDatabase
 	
 }
 
-}
\ No newline at end of file
+void ECWorldConsumer::PackMaterialTextureArrays(engine::SceneWorld* pSceneWorld, engine::ResourceContext* pResourceContext, const std::vector<engine::Entity>& materialEntities)
+{
+	const bgfx::Caps* pCaps = bgfx::getCaps();
+	if (0 == (pCaps->supported & BGFX_CAPS_TEXTURE_2D_ARRAY))
+	{
+		CD_WARN("[ECWorldConsumer] 2D texture array is not supported. Skip packing material textures.");
+		return;
+	}
+
+	// Textures which can share one texture array : slot, format, width, height, mips and address modes are same.
+	// Address modes are in the key as the sampler state is decided by texture flags.
+	using TextureArrayKey = std::tuple<uint8_t, uint32_t, uint32_t, uint32_t, uint8_t, cd::TextureMapMode, cd::TextureMapMode>;
+	struct TextureArrayGroup
+	{
+		std::vector<engine::TextureResource*> layers;
+		std::vector<std::pair<engine::MaterialComponent*, cd::MaterialTextureType>> users;
+	};
+
+	std::map<engine::TextureResource*, TextureArrayKey> textureKeys;
+	std::vector<engine::MaterialComponent*> candidates;
+	for (engine::Entity entity : materialEntities)
+	{
+		engine::MaterialComponent* pMaterialComponent = pSceneWorld->GetMaterialComponent(entity);
+		if (!pMaterialComponent ||
+			!pMaterialComponent->GetMaterialType()->GetShaderSchema().GetConflictFeatureSet(engine::ShaderFeature::TEXTURE_ARRAY).has_value())
+		{
+			continue;
+		}
+
+		bool isPackable = false;
+		for (const auto& [textureType, propertyGroup] : pMaterialComponent->GetPropertyGroups())
+		{
+			engine::TextureResource* pTextureResource = propertyGroup.textureInfo.pTextureResource;
+			if (!propertyGroup.useTexture || !pTextureResource)
+			{
+				continue;
+			}
+
+			if (textureKeys.find(pTextureResource) == textureKeys.end())
+			{
+				// Only the header is needed to decide which array the texture can go into.
+				std::vector<std::byte> fileData = engine::ResourceLoader::LoadFile(pTextureResource->GetDDSBuiltTexturePath().c_str());
+				bimg::ImageContainer imageContainer;
+				if (fileData.empty() || !bimg::imageParse(imageContainer, fileData.data(), static_cast<uint32_t>(fileData.size()), nullptr) ||
+					imageContainer.m_numLayers > 1 || imageContainer.m_depth > 1 || imageContainer.m_cubeMap)
+				{
+					isPackable = false;
+					break;
+				}
+
+				const cd::Texture* pTextureAsset = pTextureResource->GetTextureAsset();
+				textureKeys[pTextureResource] = TextureArrayKey(propertyGroup.textureInfo.slot, static_cast<uint32_t>(imageContainer.m_format),
+					imageContainer.m_width, imageContainer.m_height, imageContainer.m_numMips, pTextureAsset->GetUMapMode(), pTextureAsset->GetVMapMode());
+			}
+			isPackable = true;
+		}
+
+		if (isPackable)
+		{
+			candidates.push_back(pMaterialComponent);
+		}
+	}
+
+	// A material samples all of its textures as arrays after packing. But one layer texture array is same as a 2D texture in bgfx.
+	// So drop materials which have any texture not able to share an array with others until all groups are stable.
+	std::map<TextureArrayKey, TextureArrayGroup> groups;
+	bool isStable = false;
+	while (!isStable && !candidates.empty())
+	{
+		groups.clear();
+		for (engine::MaterialComponent* pMaterialComponent : candidates)
+		{
+			for (const auto& [textureType, propertyGroup] : pMaterialComponent->GetPropertyGroups())
+			{
+				engine::TextureResource* pTextureResource = propertyGroup.textureInfo.pTextureResource;
+				if (!propertyGroup.useTexture || !pTextureResource)
+				{
+					continue;
+				}
+
+				TextureArrayGroup& group = groups[textureKeys[pTextureResource]];
+				if (std::find(group.layers.begin(), group.layers.end(), pTextureResource) == group.layers.end())
+				{
+					group.layers.push_back(pTextureResource);
+				}
+				group.users.emplace_back(pMaterialComponent, textureType);
+			}
+		}
+
+		isStable = true;
+		for (const auto& [key, group] : groups)
+		{
+			if (group.layers.size() >= 2U && group.layers.size() <= pCaps->limits.maxTextureLayers)
+			{
+				continue;
+			}
+
+			for (const auto& [pMaterialComponent, textureType] : group.users)
+			{
+				candidates.erase(std::remove(candidates.begin(), candidates.end(), pMaterialComponent), candidates.end());
+			}
+			isStable = false;
+		}
+	}
+
+	if (candidates.empty())
+	{
+		return;
+	}
+
+	// Build all arrays before assigning them. Otherwise a material may mix texture arrays and 2D textures.
+	std::vector<std::pair<const TextureArrayGroup*, std::string>> builtArrays;
+	for (const auto& [key, group] : groups)
+	{
+		std::vector<std::string> layerFilePaths;
+		std::string layerFilePathsCombine;
+		for (const engine::TextureResource* pTextureResource : group.layers)
+		{
+			layerFilePaths.push_back(pTextureResource->GetDDSBuiltTexturePath());
+			layerFilePathsCombine += pTextureResource->GetDDSBuiltTexturePath();
+		}
+
+		std::string arrayName = "TextureArray_" + std::to_string(engine::StringCrc(layerFilePathsCombine).Value());
+		std::string outputFilePath = engine::Path::GetTextureOutputFilePath(arrayName.c_str(), ".ktx");
+		if (!ResourceBuilder::Get().BuildTextureArray(layerFilePaths, outputFilePath.c_str()))
+		{
+			CD_WARN("[ECWorldConsumer] Failed to pack material textures. Keep using 2D textures.");
+			return;
+		}
+		builtArrays.emplace_back(&group, cd::MoveTemp(outputFilePath));
+	}
+
+	for (const auto& [pGroup, outputFilePath] : builtArrays)
+	{
+		const TextureArrayKey& key = textureKeys[pGroup->layers.front()];
+		engine::TextureResource* pArrayResource = pResourceContext->AddTextureResource(engine::StringCrc(outputFilePath));
+		pArrayResource->SetTextureAsset(pGroup->layers.front()->GetTextureAsset());
+		pArrayResource->SetDDSBuiltTexturePath(outputFilePath);
+		pArrayResource->UpdateTextureType(pGroup->users.front().second);
+		pArrayResource->UpdateUVMapMode(std::get<5>(key), std::get<6>(key));
+
+		for (const auto& [pMaterialComponent, textureType] : pGroup->users)
+		{
+			engine::MaterialComponent::PropertyGroup* pPropertyGroup = pMaterialComponent->GetPropertyGroup(textureType);
+			auto itLayer = std::find(pGroup->layers.begin(), pGroup->layers.end(), pPropertyGroup->textureInfo.pTextureResource);
+			uint16_t layer = static_cast<uint16_t>(std::distance(pGroup->layers.begin(), itLayer));
+			cd::Vec2f uvOffset = pPropertyGroup->textureInfo.GetUVOffset();
+			cd::Vec2f uvScale = pPropertyGroup->textureInfo.GetUVScale();
+			pMaterialComponent->SetTextureResource(textureType, uvOffset, uvScale, pArrayResource);
+			pPropertyGroup->textureInfo.SetLayer(layer);
+			pMaterialComponent->ActivateShaderFeature(engine::ShaderFeature::TEXTURE_ARRAY);
+		}
+	}
+
+	// Remove packed 2D textures unless other materials in the scene still sample them.
+	std::set<engine::TextureResource*> replacedTextures;
+	for (const auto& [pGroup, outputFilePath] : builtArrays)
+	{
+		replacedTextures.insert(pGroup->layers.begin(), pGroup->layers.end());
+	}
+	for (engine::Entity entity : pSceneWorld->GetMaterialEntities())
+	{
+		for (const auto& [textureType, propertyGroup] : pSceneWorld->GetMaterialComponent(entity)->GetPropertyGroups())
+		{
+			replacedTextures.erase(propertyGroup.textureInfo.pTextureResource);
+		}
+	}
+	for (engine::TextureResource* pTextureResource : replacedTextures)
+	{
+		pResourceContext->RemoveTextureResource(pTextureResource->GetName());
+	}
+}
+
+}
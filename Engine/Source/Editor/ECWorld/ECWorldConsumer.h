@@ -59,6 +59,8 @@ public:
 
 	void SetDefaultMaterialType(engine::MaterialType* pMaterialType) { m_pDefaultMaterialType = pMaterialType; }
 	void SetSceneDatabaseIDs(uint32_t nodeID, uint32_t meshID);
+	// Pack material textures which have the same slot, format and size into 2D texture arrays after texture build tasks finish.
+	void SetTextureArrayPackingEnable(bool enable) { m_enableTextureArrayPacking = enable; }
 	virtual void Execute(const cd::SceneDatabase* pSceneDatabase) override;
 
 private:
@@ -72,6 +74,8 @@ private:
 	void AddMaterial(engine::Entity entity, const cd::Material* pMaterial, engine::MaterialType* pMaterialType, const cd::SceneDatabase* pSceneDatabase);
 	void AddBlendShape(engine::Entity entity, const cd::Mesh* pMesh, const cd::BlendShape& blendShape, const cd::SceneDatabase* pSceneDatabase);
 	void AddParticleEmitter(engine::Entity entity, const cd::Mesh& mesh, const cd::VertexFormat& vertexFormat, const cd::ParticleEmitter& emitter);
+	static void PackMaterialTextureArrays(engine::SceneWorld* pSceneWorld, engine::ResourceContext* pResourceContext, const std::vector<engine::Entity>& materialEntities);
+
 private:
 	engine::MaterialType* m_pDefaultMaterialType = nullptr;
 	engine::SceneWorld* m_pSceneWorld = nullptr;
@@ -80,6 +84,9 @@ private:
 
 	uint32_t m_nodeMinID;
 	uint32_t m_meshMinID;
+
+	bool m_enableTextureArrayPacking = false;
+	std::vector<engine::Entity> m_materialEntities;
 };
 
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 ﻿#include "EditorApp.h"
 
 #include "Application/Engine.h"
+#include "Core/Jobs/JobSystem.h"
+#include "Core/Memory/MemoryTracker.h"
 #include "Display/CameraController.h"
 #include "ECWorld/SceneWorld.h"
 #include "ImGui/EditorImGuiViewport.h"
@@ -11,6 +13,7 @@
 #include "Log/Log.h"
 #include "Math/MeshGenerator.h"
 #include "Path/Path.h"
+#include "Profiling/Profile.h"
 #include "Rendering/AABBRenderer.h"
 #include "Rendering/AnimationRenderer.h"
 #include "Rendering/BlendShapeRenderer.h"
@@ -23,6 +26,7 @@
 #include "Rendering/WireframeRenderer.h"
 #include "Rendering/ImGuiRenderer.h"
 #include "Rendering/PBRSkyRenderer.h"
+#include "Rendering/ParallelRenderRecorder.h"
 #include "Rendering/BloomRenderer.h"
 #include "Rendering/PostProcessRenderer.h"
 #include "Rendering/RenderContext.h"
@@ -30,6 +34,7 @@
 #include "Rendering/Resources/ResourceContext.h"
 #include "Rendering/Resources/ShaderResource.h"
 #include "Rendering/SkeletonRenderer.h"
+#include "Rendering/SkinningRenderer.h"
 #include "Rendering/SkyboxRenderer.h"
 #include "Rendering/ShadowMapRenderer.h"
 #include "Rendering/TerrainRenderer.h"
@@ -61,7 +66,6 @@
 #include "ImGui/imfilebrowser.h"
 
 //#include <format>
-#include <thread>
 
 namespace editor
 {
@@ -112,11 +116,10 @@ void EditorApp::Init(engine::EngineInitArgs initArgs)
 	InitShaderPrograms(initArgs.compileAllShaders);
 	m_pEditorImGuiContext->AddStaticLayer(std::make_unique<Splash>("Splash"));
 
-	std::thread resourceThread([]()
+	engine::JobSystem::Get().Run([]()
 	{
 		ResourceBuilder::Get().Update(false, true);
 	});
-	resourceThread.detach();
 
 	InitFileWatcher();
 }
@@ -452,11 +455,14 @@ void EditorApp::InitRenderContext(engine::GraphicsBackend backend, void* hwnd)
 
 	engine::Path::SetGraphicsBackend(backend);
 	m_pRenderContext = std::make_unique<engine::RenderContext>();
+	m_pRenderContext->SetVSync(engine::FramePacingMode::VSync == m_initArgs.framePacingMode);
 	m_pRenderContext->Init(backend, hwnd);
 	engine::Renderer::SetRenderContext(m_pRenderContext.get());
 
 	m_pResourceContext = std::make_unique<engine::ResourceContext>();
 	m_pRenderContext->SetResourceContext(m_pResourceContext.get());
+
+	m_pRenderRecorder = std::make_unique<engine::ParallelRenderRecorder>();
 }
 
 void EditorApp::InitEditorRenderers()
@@ -476,6 +482,15 @@ void EditorApp::InitEngineRenderers()
 	// The init size doesn't make sense. It will resize by SceneView.
 	engine::RenderTarget* pSceneRenderTarget = m_pRenderContext->CreateRenderTarget(sceneViewRenderTargetName, 1, 1, std::move(attachmentDesc));
 
+	// Skinned vertices and blend shape positions are written before any pass draws them.
+	auto pSkinningRenderer = std::make_unique<engine::SkinningRenderer>(m_pRenderContext->CreateView());
+	pSkinningRenderer->SetSceneWorld(m_pSceneWorld.get());
+	AddEngineRenderer(cd::MoveTemp(pSkinningRenderer));
+
+	auto pBlendShapeRenderer = std::make_unique<engine::BlendShapeRenderer>(m_pRenderContext->CreateView());
+	pBlendShapeRenderer->SetSceneWorld(m_pSceneWorld.get());
+	AddEngineRenderer(cd::MoveTemp(pBlendShapeRenderer));
+
 	auto pShadowMapRenderer = std::make_unique<engine::ShadowMapRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	m_pShadowMapRenderer = pShadowMapRenderer.get();
 	pShadowMapRenderer->SetSceneWorld(m_pSceneWorld.get());
@@ -517,10 +532,6 @@ void EditorApp::InitEngineRenderers()
 	pOutLineRenderer->SetSceneWorld(m_pSceneWorld.get());
 	AddEngineRenderer(cd::MoveTemp(pOutLineRenderer));
 
-	auto pBlendShapeRenderer = std::make_unique<engine::BlendShapeRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
-	pBlendShapeRenderer->SetSceneWorld(m_pSceneWorld.get());
-	AddEngineRenderer(cd::MoveTemp(pBlendShapeRenderer));
-
 	auto pTerrainRenderer = std::make_unique<engine::TerrainRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	m_pTerrainRenderer = pTerrainRenderer.get();
 	pTerrainRenderer->SetSceneWorld(m_pSceneWorld.get());
@@ -619,8 +630,17 @@ void EditorApp::AddEngineRenderer(std::unique_ptr<engine::Renderer> pRenderer)
 	m_pEngineRenderers.emplace_back(cd::MoveTemp(pRenderer));
 }
 
+bool EditorApp::FixedUpdate(float fixedDeltaTime)
+{
+	m_pSceneWorld->FixedUpdate(fixedDeltaTime);
+	return true;
+}
+
 bool EditorApp::Update(float deltaTime)
 {
+	// Engine systems called from here override it with their own tags.
+	CD_MEMORY_TAG_SCOPE(Editor);
+
 	// TODO : it is better to remove these logics about splash -> editor switch here.
 	// Better implementation is to have multiple Application or Window classes and they can switch.
 	if (!m_bInitEditor && ResourceBuilder::Get().IsIdle())
@@ -656,6 +676,7 @@ bool EditorApp::Update(float deltaTime)
 	GetMainWindow()->Update();
 	m_crtInputFocus = GetMainWindow()->GetInputFocus();
 	m_pEditorImGuiContext->Update(deltaTime);
+	m_pSceneWorld->SetInterpolationAlpha(GetEngine()->GetFixedTimestep().GetAlpha());
 	m_pSceneWorld->Update();
 
 	engine::CameraComponent* pMainCameraComponent = m_pSceneWorld->GetCameraComponent(m_pSceneWorld->GetMainCameraEntity());
@@ -669,8 +690,10 @@ bool EditorApp::Update(float deltaTime)
 	{
 		if (pRenderer->IsEnable())
 		{
+			CD_MEMORY_TAG_SCOPE(Rendering);
 			const float* pViewMatrix = nullptr;
 			const float* pProjectionMatrix = nullptr;
+			CD_PROFILE_ZONE_VIEW("Render", pRenderer->GetViewID());
 			pRenderer->UpdateView(pViewMatrix, pProjectionMatrix);
 			pRenderer->Render(deltaTime);
 		}
@@ -701,6 +724,7 @@ bool EditorApp::Update(float deltaTime)
 		m_pEngineImGuiContext->SetWindowPosOffset(m_pSceneView->GetWindowPosX(), m_pSceneView->GetWindowPosY());
 		m_pEngineImGuiContext->Update(deltaTime);
 
+		CD_MEMORY_TAG_SCOPE(Rendering);
 		UpdateMaterials();
 		for (std::unique_ptr<engine::Renderer>& pRenderer : m_pEngineRenderers)
 		{
@@ -708,10 +732,21 @@ bool EditorApp::Update(float deltaTime)
 			{
 				const float* pViewMatrix = pMainCameraComponent->GetViewMatrix().begin();
 				const float* pProjectionMatrix = pMainCameraComponent->GetProjectionMatrix().begin();
+				CD_PROFILE_ZONE_VIEW("Render", pRenderer->GetViewID());
 				pRenderer->UpdateView(pViewMatrix, pProjectionMatrix);
-				pRenderer->Render(deltaTime);
+				if (pRenderer->IsParallelRecordSupported())
+				{
+					m_pRenderRecorder->Add(pRenderer.get(), deltaTime);
+				}
+				else
+				{
+					pRenderer->Render(deltaTime);
+				}
 			}
 		}
+
+		// Views are sorted by id in bgfx so recording them after serial renderers doesn't change the frame.
+		m_pRenderRecorder->Record();
 	}
 
 	m_pRenderContext->EndFrame();
@@ -14,6 +14,7 @@ class FlybyCamera;
 class ImGuiBaseLayer;
 class ImGuiContextInstance;
 class Window;
+class ParallelRenderRecorder;
 class RenderContext;
 class Renderer;
 class ResourceContext;
@@ -44,6 +45,7 @@ public:
 
 	virtual void Init(engine::EngineInitArgs initArgs) override;
 	virtual bool Update(float deltaTime) override;
+	virtual bool FixedUpdate(float fixedDeltaTime) override;
 	virtual void Shutdown() override;
 
 	engine::Window* GetWindow(size_t index) const;
@@ -119,6 +121,7 @@ private:
 
 	std::vector<std::unique_ptr<engine::Renderer>> m_pEditorRenderers;
 	std::vector<std::unique_ptr<engine::Renderer>> m_pEngineRenderers;
+	std::unique_ptr<engine::ParallelRenderRecorder> m_pRenderRecorder;
 
 	// Controllers for processing input events.
 	std::unique_ptr<engine::CameraController> m_pViewportCameraController;
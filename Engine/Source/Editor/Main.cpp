@@ -1,5 +1,8 @@
 #include "EditorApp.h"
 #include "Application/Engine.h"
+#include "Core/Memory/MemoryTracker.h"
+
+CD_MEMORY_TRACKING_OVERRIDE_NEW()
 
 int main()
 {
@@ -4,9 +4,28 @@
 #include "Log/Log.h"
 #include "Path/Path.h"
 #include "Process/Process.h"
+#include "Resources/ResourceLoader.h"
+#include "TextureCookProfile.h"
 #include "Time/Clock.h"
 
+#include <bimg/bimg.h>
+#include <bimg/decode.h>
+#include <bx/allocator.h>
+#include <bx/file.h>
+
 #include <cassert>
+#include <cstring>
+
+namespace details
+{
+
+static bx::AllocatorI* GetResourceAllocator()
+{
+	static bx::DefaultAllocator s_allocator;
+	return &s_allocator;
+}
+
+}
 
 namespace editor
 {
@@ -107,7 +126,7 @@ std::string ResourceBuilder::GetModifyCacheFilePath()
 	return "";
 }
 
-ProcessStatus ResourceBuilder::CheckFileStatus(const char* pInputFilePath, const char* pOutputFilePath)
+ProcessStatus ResourceBuilder::CheckFileStatus(const char* pInputFilePath, const char* pOutputFilePath, const char* pCacheKey)
 {
 	// Use output file path as map key to store time cache.
 	// 
@@ -116,8 +135,15 @@ ProcessStatus ResourceBuilder::CheckFileStatus(const char* pInputFilePath, const
 	// 
 	// And for uber shader, a single source file can generate multiple output files,
 	// so the input file path is no longer sufficient to represent the modified state of a particular variant.
+	//
+	// Build options such as texture compression format are appended so that changing them will trigger a rebuild.
 	
-	const char* key = pOutputFilePath;
+	std::string key = pOutputFilePath;
+	if (pCacheKey && std::strlen(pCacheKey) != 0)
+	{
+		key += "|";
+		key += pCacheKey;
+	}
 
 	if (!engine::Path::FileExists(pInputFilePath))
 	{
@@ -313,18 +339,31 @@ TaskHandle ResourceBuilder::AddRadianceCubeMapBuildTask(const char* pInputFilePa
 
 TaskHandle ResourceBuilder::AddTextureBuildTask(cd::MaterialTextureType textureType, const char* pInputFilePath, const char* pOutputFilePath, TaskOutputCallbacks callbacks)
 {
-	if (SkipStatus & static_cast<uint8_t>(CheckFileStatus(pInputFilePath, pOutputFilePath)))
+	return AddTextureBuildTask(TextureCookProfile::Get(textureType, engine::Path::GetGraphicsBackend()), pInputFilePath, pOutputFilePath, cd::MoveTemp(callbacks));
+}
+
+TaskHandle ResourceBuilder::AddTextureBuildTask(const TextureCookProfile& profile, const char* pInputFilePath, const char* pOutputFilePath, TaskOutputCallbacks callbacks)
+{
+	std::string cacheKey = profile.GetCacheKey();
+	if (SkipStatus & static_cast<uint8_t>(CheckFileStatus(pInputFilePath, pOutputFilePath, cacheKey.c_str())))
 	{
 		return INVALID_TASK_HANDLE;
 	}
 
+	CD_INFO("Cook texture {0} as {1} ({2} bpp).", pInputFilePath, profile.GetFormatName(), profile.GetBitsPerPixel());
+
 	// Document : https://bkaradzic.github.io/bgfx/tools.html#texture-compiler-texturec
-	std::vector<std::string> commandArguments{ "-f", pInputFilePath, "-o", pOutputFilePath, "-t", "BC3", "--mips", "-q", "highest", "--max", "1024"};
-	if (cd::MaterialTextureType::Normal == textureType)
+	std::vector<std::string> commandArguments{ "-f", pInputFilePath, "-o", pOutputFilePath, "-t", profile.GetFormatName(), "-q", "highest", "--max", std::to_string(profile.maxSize) };
+	if (profile.generateMips)
+	{
+		commandArguments.push_back("--mips");
+	}
+
+	if (profile.isNormalMap)
 	{
 		commandArguments.push_back("--normalmap");
 	}
-	else if (cd::MaterialTextureType::BaseColor != textureType)
+	else if (profile.isLinear)
 	{
 		commandArguments.push_back("--linear");
 	}
@@ -337,6 +376,218 @@ TaskHandle ResourceBuilder::AddTextureBuildTask(cd::MaterialTextureType textureT
 	return AddTask(cd::MoveTemp(pProcess));
 }
 
+TaskHandle ResourceBuilder::AddORMTextureBuildTask(const char* pOcclusionFilePath, const char* pRoughnessFilePath, const char* pMetallicFilePath, const char* pOutputFilePath, TaskOutputCallbacks callbacks)
+{
+	const char* inputFilePaths[3] = { pOcclusionFilePath, pRoughnessFilePath, pMetallicFilePath };
+	// Default values when a channel has no input texture : no occlusion, full rough, non-metal.
+	constexpr uint8_t defaultChannelValues[3] = { 255, 255, 0 };
+
+	TextureCookProfile profile = TextureCookProfile::GetPackedORM(engine::Path::GetGraphicsBackend());
+	std::string cacheKey = profile.GetCacheKey();
+
+	bool needBuild = false;
+	for (uint32_t channel = 0U; channel < 3U; ++channel)
+	{
+		if (!inputFilePaths[channel])
+		{
+			continue;
+		}
+
+		std::string channelCacheKey = cacheKey + "_orm" + std::to_string(channel);
+		if (!(SkipStatus & static_cast<uint8_t>(CheckFileStatus(inputFilePaths[channel], pOutputFilePath, channelCacheKey.c_str()))))
+		{
+			needBuild = true;
+		}
+	}
+
+	if (!needBuild)
+	{
+		return INVALID_TASK_HANDLE;
+	}
+
+	// Decode all inputs to RGBA8. One file may be used by multiple channels which means that it is already packed.
+	// In that case, read the channel which matches ORM layout. Otherwise, it is a grayscale image so read R channel.
+	bimg::ImageContainer* pImages[3] = { nullptr, nullptr, nullptr };
+	uint32_t channelSources[3] = { 0U, 0U, 0U };
+	uint32_t width = 0U;
+	uint32_t height = 0U;
+	for (uint32_t channel = 0U; channel < 3U; ++channel)
+	{
+		if (!inputFilePaths[channel] || !engine::Path::FileExists(inputFilePaths[channel]))
+		{
+			continue;
+		}
+
+		bool isShared = false;
+		for (uint32_t otherChannel = 0U; otherChannel < 3U; ++otherChannel)
+		{
+			if (otherChannel != channel && inputFilePaths[otherChannel] &&
+				0 == std::strcmp(inputFilePaths[channel], inputFilePaths[otherChannel]))
+			{
+				isShared = true;
+			}
+		}
+		channelSources[channel] = isShared ? channel : 0U;
+
+		std::vector<std::byte> fileData = engine::ResourceLoader::LoadFile(inputFilePaths[channel]);
+		pImages[channel] = bimg::imageParse(details::GetResourceAllocator(), fileData.data(), static_cast<uint32_t>(fileData.size()), bimg::TextureFormat::RGBA8);
+		if (!pImages[channel])
+		{
+			CD_ERROR("Failed to decode ORM input texture {0}!", inputFilePaths[channel]);
+			continue;
+		}
+
+		if (0U == width)
+		{
+			width = pImages[channel]->m_width;
+			height = pImages[channel]->m_height;
+		}
+		else if (width != pImages[channel]->m_width || height != pImages[channel]->m_height)
+		{
+			CD_WARN("ORM input texture {0} has a different size. Skip packing it.", inputFilePaths[channel]);
+			bimg::imageFree(pImages[channel]);
+			pImages[channel] = nullptr;
+		}
+	}
+
+	TaskHandle handle = INVALID_TASK_HANDLE;
+	if (width > 0U && height > 0U)
+	{
+		// TGA stores pixels in BGRA order.
+		constexpr uint32_t tgaChannelOffsets[3] = { 2U, 1U, 0U };
+		std::vector<uint8_t> packedData(width * height * 4U);
+		for (uint32_t pixelIndex = 0U; pixelIndex < width * height; ++pixelIndex)
+		{
+			for (uint32_t channel = 0U; channel < 3U; ++channel)
+			{
+				const bimg::ImageContainer* pImage = pImages[channel];
+				packedData[pixelIndex * 4U + tgaChannelOffsets[channel]] = pImage ?
+					static_cast<const uint8_t*>(pImage->m_data)[pixelIndex * 4U + channelSources[channel]] :
+					defaultChannelValues[channel];
+			}
+			packedData[pixelIndex * 4U + 3U] = 255;
+		}
+
+		// texturec only accepts one input file so write packed data to an intermediate file.
+		std::string packedFilePath = std::filesystem::path(pOutputFilePath).replace_extension(".orm.tga").generic_string();
+		bx::FileWriter writer;
+		if (bx::open(&writer, packedFilePath.c_str()))
+		{
+			bimg::imageWriteTga(&writer, width, height, width * 4U, packedData.data(), false, false);
+			bx::close(&writer);
+
+			handle = AddTextureBuildTask(profile, packedFilePath.c_str(), pOutputFilePath, cd::MoveTemp(callbacks));
+		}
+		else
+		{
+			CD_ERROR("Failed to write packed ORM texture {0}!", packedFilePath);
+		}
+	}
+
+	for (bimg::ImageContainer* pImage : pImages)
+	{
+		if (pImage)
+		{
+			bimg::imageFree(pImage);
+		}
+	}
+
+	return handle;
+}
+
+bool ResourceBuilder::BuildTextureArray(std::span<const std::string> inputFilePaths, const char* pOutputFilePath)
+{
+	if (inputFilePaths.empty())
+	{
+		return false;
+	}
+
+	bool needBuild = !engine::Path::FileExists(pOutputFilePath);
+	for (const std::string& inputFilePath : inputFilePaths)
+	{
+		if (!engine::Path::FileExists(inputFilePath.c_str()))
+		{
+			CD_ERROR("Texture array layer {0} does not exist!", inputFilePath);
+			return false;
+		}
+
+		if (!needBuild && std::filesystem::last_write_time(inputFilePath) > std::filesystem::last_write_time(pOutputFilePath))
+		{
+			needBuild = true;
+		}
+	}
+
+	if (!needBuild)
+	{
+		return true;
+	}
+
+	// bimg stores layers one by one and mips inside each layer.
+	// So layer data of single layer textures can be appended directly.
+	bimg::ImageContainer arrayImage;
+	std::vector<uint8_t> arrayData;
+	for (uint32_t layerIndex = 0U; layerIndex < inputFilePaths.size(); ++layerIndex)
+	{
+		const std::string& inputFilePath = inputFilePaths[layerIndex];
+		std::vector<std::byte> fileData = engine::ResourceLoader::LoadFile(inputFilePath.c_str());
+		bimg::ImageContainer* pImage = bimg::imageParse(details::GetResourceAllocator(), fileData.data(), static_cast<uint32_t>(fileData.size()));
+		if (!pImage)
+		{
+			CD_ERROR("Failed to parse texture array layer {0}!", inputFilePath);
+			return false;
+		}
+
+		if (0U == layerIndex)
+		{
+			arrayImage = *pImage;
+			arrayImage.m_data = nullptr;
+			arrayImage.m_allocator = nullptr;
+			arrayData.reserve(pImage->m_size * inputFilePaths.size());
+		}
+
+		bool isCompatible = pImage->m_format == arrayImage.m_format && pImage->m_width == arrayImage.m_width &&
+			pImage->m_height == arrayImage.m_height && pImage->m_numMips == arrayImage.m_numMips &&
+			1U == pImage->m_numLayers && 1U == pImage->m_depth && !pImage->m_cubeMap;
+		if (!isCompatible)
+		{
+			CD_ERROR("Texture array layer {0} has a different layout!", inputFilePath);
+			bimg::imageFree(pImage);
+			return false;
+		}
+
+		const uint8_t* pLayerData = static_cast<const uint8_t*>(pImage->m_data);
+		arrayData.insert(arrayData.end(), pLayerData, pLayerData + pImage->m_size);
+		bimg::imageFree(pImage);
+	}
+
+	arrayImage.m_numLayers = static_cast<uint16_t>(inputFilePaths.size());
+	arrayImage.m_size = static_cast<uint32_t>(arrayData.size());
+
+	bx::FileWriter writer;
+	if (!bx::open(&writer, pOutputFilePath))
+	{
+		CD_ERROR("Failed to write texture array {0}!", pOutputFilePath);
+		return false;
+	}
+
+	bimg::imageWriteKtx(&writer, arrayImage, arrayData.data(), arrayImage.m_size, nullptr);
+	bx::close(&writer);
+	CD_INFO("Pack {0} textures into texture array {1}.", inputFilePaths.size(), pOutputFilePath);
+
+	return true;
+}
+
+void ResourceBuilder::AddIdleCallback(std::function<void()> callback)
+{
+	if (IsIdle())
+	{
+		callback();
+		return;
+	}
+
+	m_idleCallbacks.push_back(cd::MoveTemp(callback));
+}
+
 void ResourceBuilder::Update(bool doPrintLog, bool doPrintErrorLog)
 {
 	assert(m_numActiveTask == m_taskQueue.size());
@@ -346,28 +597,39 @@ void ResourceBuilder::Update(bool doPrintLog, bool doPrintErrorLog)
 		return;
 	}
 
-	// It may wait until process exited which depends on process's setting.
+	// Processes run in parallel. Wait for all of them so that outputs exist when Update returns.
+	std::vector<std::unique_ptr<Process>> runningProcesses;
 	while (!m_taskQueue.empty())
 	{
 		TaskHandle handle = m_taskQueue.front();
 		Process* pProcess = m_tasks[handle].get();
 		assert(pProcess);
 
-		pProcess->SetWaitUntilFinished(1 == m_taskQueue.size());
 		pProcess->SetPrintChildProcessLog(doPrintLog);
 		pProcess->SetPrintChildProcessErrorLog(doPrintErrorLog);
 		pProcess->Run();
 
-		m_tasks[handle].reset();
+		runningProcesses.push_back(cd::MoveTemp(m_tasks[handle]));
 		m_taskQueue.pop();
 
 		m_handleList[--m_numActiveTask] = handle;
 	}
 	assert(m_numActiveTask == m_taskQueue.size());
 
-	if (m_taskQueue.empty())
+	for (std::unique_ptr<Process>& pProcess : runningProcesses)
+	{
+		pProcess->Wait();
+	}
+	runningProcesses.clear();
+
+	WriteModifyCacheFile();
+
+	// Callbacks may add new tasks so they are moved out before running.
+	std::vector<std::function<void()>> idleCallbacks = cd::MoveTemp(m_idleCallbacks);
+	m_idleCallbacks.clear();
+	for (std::function<void()>& callback : idleCallbacks)
 	{
-		WriteModifyCacheFile();
+		callback();
 	}
 }
 
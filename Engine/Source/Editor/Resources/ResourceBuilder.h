@@ -8,10 +8,12 @@
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <queue>
 #include <span>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace editor
 {
@@ -27,6 +29,7 @@ enum class ProcessStatus : uint8_t
 };
 
 class Process;
+struct TextureCookProfile;
 
 struct TaskOutputCallbacks
 {
@@ -69,6 +72,16 @@ public:
 	TaskHandle AddIrradianceCubeMapBuildTask(const char* pInputFilePath, const char* pOutputFilePath, TaskOutputCallbacks callbacks = {});
 	TaskHandle AddRadianceCubeMapBuildTask(const char* pInputFilePath, const char* pOutputFilePath, TaskOutputCallbacks callbacks = {});
 	TaskHandle AddTextureBuildTask(cd::MaterialTextureType textureType, const char* pInputFilePath, const char* pOutputFilePath, TaskOutputCallbacks callbacks = {});
+	TaskHandle AddTextureBuildTask(const TextureCookProfile& profile, const char* pInputFilePath, const char* pOutputFilePath, TaskOutputCallbacks callbacks = {});
+	// Input file paths can be nullptr or duplicated. Missing channels will be filled by default values.
+	TaskHandle AddORMTextureBuildTask(const char* pOcclusionFilePath, const char* pRoughnessFilePath, const char* pMetallicFilePath, const char* pOutputFilePath, TaskOutputCallbacks callbacks = {});
+	// Packs already built textures into one 2D texture array. Inputs must share the same format, size and mip count.
+	// It runs immediately as it only copies compressed blocks.
+	bool BuildTextureArray(std::span<const std::string> inputFilePaths, const char* pOutputFilePath);
+
+	// Runs callback after all queued tasks finished, or immediately when there is no task.
+	// Callbacks run in the order they were added on the thread which calls Update.
+	void AddIdleCallback(std::function<void()> callback);
 
 	void Update(bool doPrintLog = false, bool doPrintErrorLog = true);
 	uint32_t GetCurrentTaskCount() const;
@@ -88,13 +101,15 @@ private:
 
 	std::string GetModifyCacheFilePath();
 
-	ProcessStatus CheckFileStatus(const char* pInputFilePath, const char* pOutputFilePath);
+	// pCacheKey is appended to output file path as the cache key so that different build options will not share the same record.
+	ProcessStatus CheckFileStatus(const char* pInputFilePath, const char* pOutputFilePath, const char* pCacheKey = nullptr);
 
 private:
 	uint32_t m_numActiveTask;
 	std::array<TaskHandle, MaxTaskCount> m_handleList;
 	std::array<std::unique_ptr<Process>, MaxTaskCount> m_tasks;
 	std::queue<TaskHandle> m_taskQueue;
+	std::vector<std::function<void()>> m_idleCallbacks;
 
 	std::unordered_map<std::string, uint64_t> m_modifyTimeCache;
 	// We always access to fragment shader multiple times by using ubre options.
@@ -0,0 +1,163 @@
+#include "TextureCookProfile.h"
+
+#include <cassert>
+
+namespace editor
+{
+
+const char* TextureCookProfile::GetFormatName() const
+{
+	switch (compression)
+	{
+	case TextureCompression::BC1:
+		return "BC1";
+	case TextureCompression::BC3:
+		return "BC3";
+	case TextureCompression::BC4:
+		return "BC4";
+	case TextureCompression::BC5:
+		return "BC5";
+	case TextureCompression::BC7:
+		return "BC7";
+	case TextureCompression::ETC2:
+		return "ETC2";
+	case TextureCompression::ETC2A:
+		return "ETC2A";
+	case TextureCompression::ASTC4x4:
+		return "ASTC4x4";
+	case TextureCompression::ASTC6x6:
+		return "ASTC6x6";
+	default:
+		assert(false && "Unknown texture compression format.");
+		return "BC3";
+	}
+}
+
+float TextureCookProfile::GetBitsPerPixel() const
+{
+	switch (compression)
+	{
+	case TextureCompression::BC1:
+	case TextureCompression::BC4:
+	case TextureCompression::ETC2:
+		return 4.0f;
+	case TextureCompression::BC3:
+	case TextureCompression::BC5:
+	case TextureCompression::BC7:
+	case TextureCompression::ETC2A:
+	case TextureCompression::ASTC4x4:
+		return 8.0f;
+	case TextureCompression::ASTC6x6:
+		return 128.0f / 36.0f;
+	default:
+		return 32.0f;
+	}
+}
+
+std::string TextureCookProfile::GetCacheKey() const
+{
+	std::string key = GetFormatName();
+	key += isNormalMap ? "_n" : "";
+	key += isLinear ? "_l" : "";
+	key += generateMips ? "_m" : "";
+	key += "_" + std::to_string(maxSize);
+	return key;
+}
+
+TextureCompressionFamily TextureCookProfile::GetCompressionFamily(engine::GraphicsBackend backend)
+{
+	switch (backend)
+	{
+	case engine::GraphicsBackend::OpenGLES:
+		return TextureCompressionFamily::ETC2;
+	case engine::GraphicsBackend::Vulkan:
+#if CD_PLATFORM_ANDROID
+		return TextureCompressionFamily::ASTC;
+#else
+		return TextureCompressionFamily::BC;
+#endif
+	case engine::GraphicsBackend::Metal:
+#if CD_PLATFORM_IOS
+		return TextureCompressionFamily::ASTC;
+#else
+		return TextureCompressionFamily::BC;
+#endif
+	case engine::GraphicsBackend::Noop:
+	case engine::GraphicsBackend::OpenGL:
+	case engine::GraphicsBackend::Direct3D11:
+	case engine::GraphicsBackend::Direct3D12:
+	default:
+		return TextureCompressionFamily::BC;
+	}
+}
+
+bool TextureCookProfile::IsORMTextureType(cd::MaterialTextureType textureType)
+{
+	return cd::MaterialTextureType::Occlusion == textureType ||
+		cd::MaterialTextureType::Roughness == textureType ||
+		cd::MaterialTextureType::Metallic == textureType;
+}
+
+TextureCookProfile TextureCookProfile::GetPackedORM(engine::GraphicsBackend backend)
+{
+	TextureCookProfile profile;
+	profile.isLinear = true;
+
+	switch (GetCompressionFamily(backend))
+	{
+	case TextureCompressionFamily::ASTC:
+		profile.compression = TextureCompression::ASTC6x6;
+		break;
+	case TextureCompressionFamily::ETC2:
+		profile.compression = TextureCompression::ETC2;
+		break;
+	case TextureCompressionFamily::BC:
+	default:
+		profile.compression = TextureCompression::BC1;
+		break;
+	}
+
+	return profile;
+}
+
+TextureCookProfile TextureCookProfile::Get(cd::MaterialTextureType textureType, engine::GraphicsBackend backend)
+{
+	// ORM textures are sampled as RGB in shader so they always go through the packed profile.
+	if (IsORMTextureType(textureType))
+	{
+		return GetPackedORM(backend);
+	}
+
+	TextureCompressionFamily family = GetCompressionFamily(backend);
+
+	TextureCookProfile profile;
+	if (cd::MaterialTextureType::BaseColor == textureType)
+	{
+		// Alpha channel is used by opacity and alpha test.
+		profile.isLinear = false;
+		profile.compression = TextureCompressionFamily::ASTC == family ? TextureCompression::ASTC4x4 :
+			TextureCompressionFamily::ETC2 == family ? TextureCompression::ETC2A : TextureCompression::BC7;
+	}
+	else if (cd::MaterialTextureType::Normal == textureType)
+	{
+		// Only XY are stored for BC5. Shader reconstructs Z.
+		profile.isNormalMap = true;
+		profile.compression = TextureCompressionFamily::ASTC == family ? TextureCompression::ASTC4x4 :
+			TextureCompressionFamily::ETC2 == family ? TextureCompression::ETC2 : TextureCompression::BC5;
+	}
+	else if (cd::MaterialTextureType::Emissive == textureType)
+	{
+		profile.compression = TextureCompressionFamily::ASTC == family ? TextureCompression::ASTC6x6 :
+			TextureCompressionFamily::ETC2 == family ? TextureCompression::ETC2 : TextureCompression::BC1;
+	}
+	else
+	{
+		// Unknown usages are treated as single channel data such as masks.
+		profile.compression = TextureCompressionFamily::ASTC == family ? TextureCompression::ASTC6x6 :
+			TextureCompressionFamily::ETC2 == family ? TextureCompression::ETC2 : TextureCompression::BC4;
+	}
+
+	return profile;
+}
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Graphics/GraphicsBackend.h"
+#include "Scene/MaterialTextureType.h"
+
+#include <cstdint>
+#include <string>
+
+namespace editor
+{
+
+// GPU block compression formats which texturec can output.
+enum class TextureCompression : uint8_t
+{
+	BC1,     // RGB,  4 bpp
+	BC3,     // RGBA, 8 bpp
+	BC4,     // R,    4 bpp
+	BC5,     // RG,   8 bpp
+	BC7,     // RGBA, 8 bpp
+	ETC2,    // RGB,  4 bpp
+	ETC2A,   // RGBA, 8 bpp
+	ASTC4x4, // RGBA, 8 bpp
+	ASTC6x6, // RGBA, 3.56 bpp
+	Count,
+};
+
+// Which family of block compression formats a graphics backend can sample on the target platform.
+enum class TextureCompressionFamily : uint8_t
+{
+	BC,   // Desktop
+	ASTC, // Android Vulkan, iOS Metal
+	ETC2, // OpenGLES
+};
+
+// TextureCookProfile describes how texturec should compress a texture.
+// Different MaterialTextureTypes have different channel usages so one fixed format wastes memory or quality.
+struct TextureCookProfile
+{
+	TextureCompression compression = TextureCompression::BC3;
+	bool isNormalMap = false;
+	bool isLinear = true;
+	bool generateMips = true;
+	uint16_t maxSize = 1024;
+
+	const char* GetFormatName() const;
+	float GetBitsPerPixel() const;
+
+	// The key is recorded in build cache so that switching profile will trigger a rebuild.
+	std::string GetCacheKey() const;
+
+	static TextureCompressionFamily GetCompressionFamily(engine::GraphicsBackend backend);
+	static TextureCookProfile Get(cd::MaterialTextureType textureType, engine::GraphicsBackend backend);
+	// Occlusion, Roughness and Metallic are packed into R, G and B channels of one texture.
+	static TextureCookProfile GetPackedORM(engine::GraphicsBackend backend);
+	static bool IsORMTextureType(cd::MaterialTextureType textureType);
+};
+
+}
@@ -1,4 +1,5 @@
 #include "AssetBrowser.h"
+#include "Core/Memory/MemoryTracker.h"
 
 #include "Consumers/CDConsumer/CDConsumer.h"
 #ifdef ENABLE_FBX_CONSUMER
@@ -6,6 +7,7 @@
 #endif
 #include "ECWorld/ECWorldConsumer.h"
 #include "ECWorld/MaterialComponent.h"
+#include "ECWorld/SceneSnapshot.h"
 #include "ECWorld/SceneWorld.h"
 #include "ECWorld/StaticMeshComponent.h"
 #include "ECWorld/World.h"
@@ -15,6 +17,7 @@
 #include "ImGui/ImGuiUtils.hpp"
 #include "Log/Log.h"
 #include "Material/MaterialType.h"
+#include "Path/Path.h"
 #include "Producers/CDProducer/CDProducer.h"
 #include "Producers/EffekseerProducer/EffekseerProducer.h"
 #ifdef ENABLE_FBX_PRODUCER
@@ -30,6 +33,9 @@
 
 #include <json/json.hpp>
 
+#include <algorithm>
+#include <filesystem>
+
 #include <imgui/imgui.h>
 #define IMGUI_DEFINE_MATH_OPERATORS
 #include <imgui/imgui_internal.h>
@@ -246,7 +252,7 @@ bool AssetBrowser::RenderFile(int dirIndex, bool folder, int shownIndex, bool gr
 				 bgfx::TextureHandle TextureHandle = pRenderContext->GetTexture(textureCrc);
 				 if (!bgfx::isValid(TextureHandle))
 				 {
-					 ResourceBuilder::Get().AddTextureBuildTask(cd::MaterialTextureType::Normal, texturesPath.string().c_str(), texviewPath.string().c_str());
+					 ResourceBuilder::Get().AddTextureBuildTask(cd::MaterialTextureType::BaseColor, texturesPath.string().c_str(), texviewPath.string().c_str());
 					 ResourceBuilder::Get().Update();
 					 std::string texview = "Textures/textures/";
 					 texview += (nameNoEx + ".dds");
@@ -703,7 +709,8 @@ void AssetBrowser::UpdateAssetFileView()
 	ImGui::SliderFloat(" ", &m_gridSize, 40.0f, 160.0f, " ", ImGuiSliderFlags_AlwaysClamp | ImGuiSliderFlags_Logarithmic);
 }
 
-bool AssetBrowser::UpdateOptionDialog(const char* pTitle, bool& active, bool& importMesh, bool& importMaterial, bool& importTexture, bool& importAnimation, bool& importCamera, bool& importLight)
+bool AssetBrowser::UpdateOptionDialog(const char* pTitle, bool& active, bool& importMesh, bool& importMaterial, bool& importTexture, bool& importAnimation, bool& importCamera, bool& importLight,
+	bool* pPackTextureArray)
 {
 	if (!active)
 	{
@@ -736,6 +743,10 @@ bool AssetBrowser::UpdateOptionDialog(const char* pTitle, bool& active, bool& im
 		{
 			ImGuiUtils::ImGuiBoolProperty("Material", importMaterial);
 			ImGuiUtils::ImGuiBoolProperty("Texture", importTexture);
+			if (pPackTextureArray)
+			{
+				ImGuiUtils::ImGuiBoolProperty("Pack Texture Array", *pPackTextureArray);
+			}
 		}
 		ImGui::Separator();
 		ImGui::PopStyleVar();
@@ -937,15 +948,40 @@ void AssetBrowser::ProcessSceneDatabase(cd::SceneDatabase* pSceneDatabase, bool
 // Translate different 3D model file formats to memory data.
 void AssetBrowser::ImportModelFile(const char* pFilePath)
 {
+	// Components and resources created by the consumer are accounted by their own tags.
+	CD_MEMORY_TAG_SCOPE(Scene);
+
 	engine::RenderContext* pCurrentRenderContext = GetRenderContext();
 	engine::SceneWorld* pSceneWorld = GetImGuiContextInstance()->GetSceneWorld();
 
+	// Step 0 : Load the scene snapshot which was saved by an import with the same options.
+	// It contains entities, components and built resources so that producers and consumers are skipped.
+	std::filesystem::path inputFilePath(pFilePath);
+	uint32_t importOptionsMask = 0U;
+	for (bool importOption : { m_importOptions.ImportMesh, m_importOptions.ImportMaterial, m_importOptions.ImportTexture,
+		m_importOptions.ImportCamera, m_importOptions.ImportLight, m_importOptions.ImportAnimation, m_importOptions.PackTextureArray })
+	{
+		importOptionsMask = (importOptionsMask << 1U) | (importOption ? 1U : 0U);
+	}
+	std::string snapshotOptions = std::to_string(static_cast<uint32_t>(m_importOptions.AssetType)) + "_" + std::to_string(importOptionsMask);
+	std::string snapshotFilePath = engine::Path::GetSceneSnapshotOutputFilePath(pFilePath, snapshotOptions);
+	std::error_code errorCode;
+	if (std::filesystem::exists(snapshotFilePath, errorCode) &&
+		std::filesystem::last_write_time(snapshotFilePath, errorCode) >= std::filesystem::last_write_time(inputFilePath, errorCode))
+	{
+		engine::SceneSnapshotInfo snapshotInfo;
+		if (engine::SceneSnapshot::Load(*pSceneWorld, pCurrentRenderContext->GetResourceContext(), snapshotFilePath.c_str(), &snapshotInfo))
+		{
+			CD_INFO("Load {0} from scene snapshot {1} : {2} entities", pFilePath, snapshotFilePath, snapshotInfo.entityCount);
+			return;
+		}
+	}
+
 	cd::SceneDatabase* pSceneDatabase = pSceneWorld->GetSceneDatabase();
 	uint32_t oldNodeCount = pSceneDatabase->GetNodeCount();
 	uint32_t oldMeshCount = pSceneDatabase->GetMeshCount();
 
 	// Step 1 : Convert model file to cd::SceneDatabase
-	std::filesystem::path inputFilePath(pFilePath);
 	std::filesystem::path inputFileExtension = inputFilePath.extension();
 	bool importedModel = false;
 	auto newSceneDatabase = std::make_unique<cd::SceneDatabase>();
@@ -995,10 +1031,12 @@ void AssetBrowser::ImportModelFile(const char* pFilePath)
 	ProcessSceneDatabase(pSceneDatabase, m_importOptions.ImportMesh, m_importOptions.ImportMaterial, m_importOptions.ImportTexture,
 		m_importOptions.ImportCamera, m_importOptions.ImportLight);
 	// Step 3 : Convert cd::SceneDatabase to entities and components
+	const engine::Entity firstImportedEntity = engine::World::GetNextEntity();
 	{
 		ECWorldConsumer ecConsumer(pSceneWorld, pCurrentRenderContext);
 		ecConsumer.SetDefaultMaterialType(pSceneWorld->GetPBRMaterialType());
 		ecConsumer.SetSceneDatabaseIDs(oldNodeCount, oldMeshCount);
+		ecConsumer.SetTextureArrayPackingEnable(m_importOptions.PackTextureArray);
 #ifdef ENABLE_DDGI
 		if (m_importOptions.AssetType == IOAssetType::DDGIModel)
 		{
@@ -1010,6 +1048,22 @@ void AssetBrowser::ImportModelFile(const char* pFilePath)
 		processor.Run();
 	}
 
+	// Save the imported entities for the next import after texture arrays are packed.
+	// Blend shapes and particles reference the SceneDatabase so they are not stored.
+	ResourceBuilder::Get().AddIdleCallback([pSceneWorld, snapshotFilePath, firstImportedEntity]()
+	{
+		auto isImported = [firstImportedEntity](engine::Entity entity) { return entity >= firstImportedEntity; };
+		const std::vector<engine::Entity>& blendShapeEntities = pSceneWorld->GetBlendShapeEntities();
+		const std::vector<engine::Entity>& particleEmitterEntities = pSceneWorld->GetParticleEmitterEntities();
+		if (std::none_of(blendShapeEntities.begin(), blendShapeEntities.end(), isImported) &&
+			std::none_of(particleEmitterEntities.begin(), particleEmitterEntities.end(), isImported))
+		{
+			std::error_code errorCode;
+			std::filesystem::create_directories(std::filesystem::path(snapshotFilePath).parent_path(), errorCode);
+			engine::SceneSnapshot::Save(*pSceneWorld->GetWorld(), snapshotFilePath.c_str(), firstImportedEntity);
+		}
+	});
+
 	// Step 4 : Convert cd::SceneDatabase to cd asset files and save in disk
 	{
 		cdtools::CDConsumer cdConsumer(m_currentDirectory->FilePath.string().c_str());
@@ -1233,7 +1287,7 @@ void AssetBrowser::Update()
 		m_importOptions.Active = true;
 	}
 	if (UpdateOptionDialog("Import Options", m_importOptions.Active, m_importOptions.ImportMesh, m_importOptions.ImportMaterial, m_importOptions.ImportTexture,
-		m_importOptions.ImportAnimation, m_importOptions.ImportCamera, m_importOptions.ImportLight))
+		m_importOptions.ImportAnimation, m_importOptions.ImportCamera, m_importOptions.ImportLight, &m_importOptions.PackTextureArray))
 	{
 		ImportAssetFile(m_pImportFileBrowser->GetSelected().string().c_str());
 		m_pImportFileBrowser->ClearSelected();
@@ -52,6 +52,7 @@ struct AssetImportOptions
 	bool ImportMesh = true;
 	bool ImportTexture = true;
 	bool ImportAnimation = true;
+	bool PackTextureArray = false;
 };
 
 struct AssetExportOptions
@@ -110,7 +111,9 @@ private:
 
 	void UpdateAssetFolderTree();
 	void UpdateAssetFileView();
-	bool UpdateOptionDialog(const char* pTitle, bool& active, bool& importMesh, bool& importMaterial, bool& importTexture, bool& importAnimation, bool& importCamera, bool& importLight);
+	// pPackTextureArray is only shown when it is not nullptr.
+	bool UpdateOptionDialog(const char* pTitle, bool& active, bool& importMesh, bool& importMaterial, bool& importTexture, bool& importAnimation, bool& importCamera, bool& importLight,
+		bool* pPackTextureArray = nullptr);
 
 private:
 	AssetImportOptions m_importOptions;
@@ -130,14 +130,13 @@ void UpdateComponentWidget<engine::BlendShapeComponent>(engine::SceneWorld* pSce
 	{
 		// Parameters
 		uint32_t morphCount = pBlendShapeComponent->GetMorphCount();
-		std::vector<float>& weights = pBlendShapeComponent->GetWeights();
 		for (uint32_t morphIndex = 0; morphIndex < morphCount; ++morphIndex)
 		{
 			const auto* pMorph = pBlendShapeComponent->GetMorphData(morphIndex);
-			float weightI = weights[morphIndex];
-			if (ImGuiUtils::ImGuiFloatProperty(pMorph->GetName(), weights[morphIndex], cd::Unit::None, 0.0f, 1.0f))//, false, 0.1f
+			float weight = pBlendShapeComponent->GetWeight(morphIndex);
+			if (ImGuiUtils::ImGuiFloatProperty(pMorph->GetName(), weight, cd::Unit::None, 0.0f, 1.0f))//, false, 0.1f
 			{
-				pBlendShapeComponent->AddNeedUpdate(morphIndex, weightI);
+				pBlendShapeComponent->SetWeight(morphIndex, weight);
 			}
 		}
 	}
@@ -164,6 +163,9 @@ void UpdateComponentWidget<engine::MaterialComponent>(engine::SceneWorld* pScene
 		ImGui::Separator();
 		ImGuiUtils::ImGuiStringProperty("Name", pMaterialComponent->GetName());
 
+		// Widgets below modify material values by references. Resolve pipeline state again only when one of them changed.
+		bool isPipelineStateChanged = false;
+
 		// Parameters
 		ImGui::Separator();
 		
@@ -175,8 +177,8 @@ void UpdateComponentWidget<engine::MaterialComponent>(engine::SceneWorld* pScene
 			if (isOpen)
 			{
 				// TODO : generic cull mode.
-				ImGuiUtils::ImGuiBoolProperty("TwoSided", pMaterialComponent->GetTwoSided());
-				ImGuiUtils::ImGuiEnumProperty("BlendMode", pMaterialComponent->GetBlendMode());
+				isPipelineStateChanged |= ImGuiUtils::ImGuiBoolProperty("TwoSided", pMaterialComponent->GetTwoSided());
+				isPipelineStateChanged |= ImGuiUtils::ImGuiEnumProperty("BlendMode", pMaterialComponent->GetBlendMode());
 			}
 
 			ImGui::Separator();
@@ -185,7 +187,7 @@ void UpdateComponentWidget<engine::MaterialComponent>(engine::SceneWorld* pScene
 
 		if (cd::BlendMode::Mask == pMaterialComponent->GetBlendMode())
 		{
-			ImGuiUtils::ImGuiFloatProperty("AlphaCutOff", pMaterialComponent->GetAlphaCutOff(), cd::Unit::None, 0.0f, 1.0f);
+			isPipelineStateChanged |= ImGuiUtils::ImGuiFloatProperty("AlphaCutOff", pMaterialComponent->GetAlphaCutOff(), cd::Unit::None, 0.0f, 1.0f);
 		}
 
 		// Textures
@@ -236,8 +238,8 @@ void UpdateComponentWidget<engine::MaterialComponent>(engine::SceneWorld* pScene
 					s_pInspector->SetIsOpenFileBrowser(true);
 				}
 
-				ImGuiUtils::ImGuiVectorProperty("UV Offset", textureInfo.GetUVOffset(), cd::Unit::None, cd::Vec2f::Zero(), cd::Vec2f::One(), false, 0.01f);
-				ImGuiUtils::ImGuiVectorProperty("UV Scale", textureInfo.GetUVScale());
+				isPipelineStateChanged |= ImGuiUtils::ImGuiVectorProperty("UV Offset", textureInfo.GetUVOffset(), cd::Unit::None, cd::Vec2f::Zero(), cd::Vec2f::One(), false, 0.01f);
+				isPipelineStateChanged |= ImGuiUtils::ImGuiVectorProperty("UV Scale", textureInfo.GetUVScale());
 
 				if (isPropertyGroupChanded)
 				{
@@ -253,21 +255,21 @@ void UpdateComponentWidget<engine::MaterialComponent>(engine::SceneWorld* pScene
 				
 				if (cd::MaterialTextureType::BaseColor == textureType)
 				{
-					ImGuiUtils::ColorPickerProperty("Factor", *(pMaterialComponent->GetFactor<cd::Vec3f>(textureType)));
+					isPipelineStateChanged |= ImGuiUtils::ColorPickerProperty("Factor", *(pMaterialComponent->GetFactor<cd::Vec3f>(textureType)));
 				}
 				else if (cd::MaterialTextureType::Occlusion == textureType ||
 					cd::MaterialTextureType::Metallic == textureType ||
 					cd::MaterialTextureType::Roughness == textureType)
 				{
-					ImGuiUtils::ImGuiFloatProperty("Factor", *(pMaterialComponent->GetFactor<float>(textureType)), cd::Unit::None, 0.0f, 1.0f, false, 0.01f);
+					isPipelineStateChanged |= ImGuiUtils::ImGuiFloatProperty("Factor", *(pMaterialComponent->GetFactor<float>(textureType)), cd::Unit::None, 0.0f, 1.0f, false, 0.01f);
 				}
 				else if (cd::MaterialTextureType::Emissive == textureType)
 				{
 					cd::Vec4f& emissiveColorAndFactor = *(pMaterialComponent->GetFactor<cd::Vec4f>(textureType));
 					cd::Vec3f emissiveColor{ emissiveColorAndFactor.x(), emissiveColorAndFactor.y(), emissiveColorAndFactor.z() };
 					float emissiveFactor = emissiveColorAndFactor.w();
-					ImGuiUtils::ImGuiVectorProperty("Color", emissiveColor, cd::Unit::None, cd::Vec3f::Zero(), cd::Vec3f::One(), false, 0.01f);
-					ImGuiUtils::ImGuiFloatProperty("Factor", emissiveFactor, cd::Unit::None, 0.0f, 10000.0f, false, 0.1f);
+					isPipelineStateChanged |= ImGuiUtils::ImGuiVectorProperty("Color", emissiveColor, cd::Unit::None, cd::Vec3f::Zero(), cd::Vec3f::One(), false, 0.01f);
+					isPipelineStateChanged |= ImGuiUtils::ImGuiFloatProperty("Factor", emissiveFactor, cd::Unit::None, 0.0f, 10000.0f, false, 0.1f);
 					emissiveColorAndFactor = cd::Vec4f{ emissiveColor.x(), emissiveColor.y(), emissiveColor.z(), emissiveFactor };
 				}
 
@@ -285,14 +287,19 @@ void UpdateComponentWidget<engine::MaterialComponent>(engine::SceneWorld* pScene
 			ImGui::Separator();
 			if (isOpen)
 			{
-				ImGuiUtils::ImGuiFloatProperty("iblStrength", pMaterialComponent->GetIblStrengeth(), cd::Unit::None, 0.01f, 10.0f, false, 0.02f);
-				ImGuiUtils::ImGuiFloatProperty("Reflectance", pMaterialComponent->GetReflectance(), cd::Unit::None, 0.0f, 1.0f);
+				isPipelineStateChanged |= ImGuiUtils::ImGuiFloatProperty("iblStrength", pMaterialComponent->GetIblStrengeth(), cd::Unit::None, 0.01f, 10.0f, false, 0.02f);
+				isPipelineStateChanged |= ImGuiUtils::ImGuiFloatProperty("Reflectance", pMaterialComponent->GetReflectance(), cd::Unit::None, 0.0f, 1.0f);
 			}
 
 			ImGui::Separator();
 			ImGui::PopStyleVar();
 		}
 
+		if (isPipelineStateChanged)
+		{
+			pMaterialComponent->SetPipelineStateDirty(true);
+		}
+
 		// Cartoon
 		{
 			bool isOpen = ImGui::CollapsingHeader("Cartoon Material", ImGuiTreeNodeFlags_AllowItemOverlap | ImGuiTreeNodeFlags_Selected);
@@ -671,6 +678,7 @@ void UpdateComponentWidget<engine::ParticleEmitterComponent>(engine::SceneWorld*
 		ImGuiUtils::ImGuiVectorProperty("Emitter Range", pParticleEmitterComponent->GetEmitterShapeRange());
 		ImGuiUtils::ImGuiBoolProperty("Random Emit Pos", pParticleEmitterComponent->GetRandomPosState());
 		ImGuiUtils::ImGuiIntProperty("Max Count", pParticleEmitterComponent->GetSpawnCount(), cd::Unit::None, 1, 300);
+		ImGuiUtils::ImGuiFloatProperty("Spawn Rate", pParticleEmitterComponent->GetParticleSpawner().GetSpawnRate(), cd::Unit::None, 0, 300);
 		ImGuiUtils::ImGuiVectorProperty("Velocity", pParticleEmitterComponent->GetEmitterVelocity());
 		ImGuiUtils::ImGuiVectorProperty("Random Velocity", pParticleEmitterComponent->GetRandomVelocity());
 		ImGuiUtils::ImGuiBoolProperty("RandomVelocity State", pParticleEmitterComponent->GetRandomVelocityState());
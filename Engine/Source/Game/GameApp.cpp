@@ -9,6 +9,7 @@
 #include "Log/Log.h"
 #include "Math/MeshGenerator.h"
 #include "Path/Path.h"
+#include "Profiling/Profile.h"
 #include "Rendering/AnimationRenderer.h"
 #ifdef ENABLE_DDGI
 #include "Rendering/DDGIRenderer.h"
@@ -18,6 +19,7 @@
 #include "Rendering/PBRSkyRenderer.h"
 #include "Rendering/PostProcessRenderer.h"
 #include "Rendering/RenderContext.h"
+#include "Rendering/SkinningRenderer.h"
 #include "Rendering/SkyboxRenderer.h"
 #include "Rendering/WorldRenderer.h"
 #include "Resources/ShaderLoader.h"
@@ -212,6 +214,7 @@ void GameApp::InitRenderContext(engine::GraphicsBackend backend, void* hwnd)
 
 	engine::Path::SetGraphicsBackend(backend);
 	m_pRenderContext = std::make_unique<engine::RenderContext>();
+	m_pRenderContext->SetVSync(engine::FramePacingMode::VSync == m_initArgs.framePacingMode);
 	m_pRenderContext->Init(backend, hwnd);
 	engine::Renderer::SetRenderContext(m_pRenderContext.get());
 }
@@ -229,6 +232,11 @@ void GameApp::InitEngineRenderers()
 	engine::RenderTarget* pSceneRenderTarget = nullptr;
 	pSceneRenderTarget = m_pRenderContext->CreateRenderTarget(sceneViewRenderTargetName, GetMainWindow()->GetWidth(), GetMainWindow()->GetHeight(), std::move(attachmentDesc));
 
+	// Skinned vertices are written before any pass draws them.
+	auto pSkinningRenderer = std::make_unique<engine::SkinningRenderer>(m_pRenderContext->CreateView());
+	pSkinningRenderer->SetSceneWorld(m_pSceneWorld.get());
+	AddEngineRenderer(cd::MoveTemp(pSkinningRenderer));
+
 	auto pSkyboxRenderer = std::make_unique<engine::SkyboxRenderer>(m_pRenderContext->CreateView(), pSceneRenderTarget);
 	m_pIBLSkyRenderer = pSkyboxRenderer.get();
 	pSkyboxRenderer->SetSceneWorld(m_pSceneWorld.get());
@@ -292,6 +300,12 @@ void GameApp::AddEngineRenderer(std::unique_ptr<engine::Renderer> pRenderer)
 	m_pEngineRenderers.emplace_back(cd::MoveTemp(pRenderer));
 }
 
+bool GameApp::FixedUpdate(float fixedDeltaTime)
+{
+	m_pSceneWorld->FixedUpdate(fixedDeltaTime);
+	return true;
+}
+
 bool GameApp::Update(float deltaTime)
 {
 	// TODO : it is better to remove these logics about splash -> editor switch here.
@@ -338,6 +352,7 @@ bool GameApp::Update(float deltaTime)
 	}
 
 	GetMainWindow()->Update();
+	m_pSceneWorld->SetInterpolationAlpha(GetEngine()->GetFixedTimestep().GetAlpha());
 	m_pSceneWorld->Update();
 
 	engine::CameraComponent* pMainCameraComponent = m_pSceneWorld->GetCameraComponent(m_pSceneWorld->GetMainCameraEntity());
@@ -354,6 +369,7 @@ bool GameApp::Update(float deltaTime)
 			{
 				const float* pViewMatrix = pMainCameraComponent->GetViewMatrix().Begin();
 				const float* pProjectionMatrix = pMainCameraComponent->GetProjectionMatrix().Begin();
+				CD_PROFILE_ZONE_VIEW("Render", pRenderer->GetViewID());
 				pRenderer->UpdateView(pViewMatrix, pProjectionMatrix);
 				pRenderer->Render(deltaTime);
 			}
@@ -40,6 +40,7 @@ public:
 
 	virtual void Init(engine::EngineInitArgs initArgs) override;
 	virtual bool Update(float deltaTime) override;
+	virtual bool FixedUpdate(float fixedDeltaTime) override;
 	virtual void Shutdown() override;
 
 	engine::Window* GetWindow(size_t index) const;
@@ -1,5 +1,8 @@
 #include "GameApp.h"
 #include "Application/Engine.h"
+#include "Core/Memory/MemoryTracker.h"
+
+CD_MEMORY_TRACKING_OVERRIDE_NEW()
 
 int main()
 {
@@ -8,7 +11,8 @@ int main()
 
 	pEngine->Init({ .pTitle = "Game",
 		.width = 1280, .height = 720, .useFullScreen = false,
-		.language = Language::ChineseSimplied, .backend = GraphicsBackend::Direct3D11 });
+		.language = Language::ChineseSimplied, .backend = GraphicsBackend::Direct3D11,
+		.pFrameStatsFilePath = "CatDogFrameStats.json" });
 
 	pEngine->Run();
 
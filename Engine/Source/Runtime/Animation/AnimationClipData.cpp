@@ -0,0 +1,277 @@
+#include "AnimationClipData.h"
+
+#include "Animation/SoaPose.h"
+#include "Log/Log.h"
+#include "Scene/SceneDatabase.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace engine
+{
+
+bool AnimationClipData::Compile(const cd::SceneDatabase* pSceneDatabase, const cd::Animation& animation, float sampleRate)
+{
+	const uint32_t boneCount = pSceneDatabase->GetBoneCount();
+	if (0U == boneCount)
+	{
+		CD_ENGINE_ERROR("Failed to compile animation clip {0} without bones.", animation.GetName());
+		return false;
+	}
+
+	// Duration and key times are in ticks. Frames are in seconds like the running time of AnimationComponent.
+	const float ticksPerSecond = animation.GetTicksPerSecond();
+	const float secondsPerTick = ticksPerSecond > 0.0f ? 1.0f / ticksPerSecond : 1.0f;
+	Init(boneCount, animation.GetDuration() * secondsPerTick, sampleRate);
+	m_name = animation.GetName();
+
+	// Bone 0 is the root. Walk the hierarchy in the same order as the renderers so parents come first.
+	m_boneOrder.clear();
+	m_boneOrder.push_back(0U);
+	for (size_t orderIndex = 0U; orderIndex < m_boneOrder.size(); ++orderIndex)
+	{
+		const uint32_t boneIndex = m_boneOrder[orderIndex];
+		for (cd::BoneID childID : pSceneDatabase->GetBone(boneIndex).GetChildIDs())
+		{
+			m_parentIndices[childID.Data()] = boneIndex;
+			m_boneOrder.push_back(childID.Data());
+		}
+	}
+	assert(m_boneOrder.size() == boneCount && "Bones should be reachable from the root bone.");
+	MoveLeafBonesLast();
+
+	// Tracks are named by clip name and bone name. Names are only looked up here.
+	std::string trackName;
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		trackName = m_name;
+		trackName += pSceneDatabase->GetBone(boneIndex).GetName();
+		const cd::Track* pTrack = pSceneDatabase->GetTrackByName(trackName.c_str());
+		if (!pTrack)
+		{
+			continue;
+		}
+
+		ResampleTranslationKeys(boneIndex, pTrack->GetTranslationKeys().data(), pTrack->GetTranslationKeyCount(), secondsPerTick);
+		ResampleRotationKeys(boneIndex, pTrack->GetRotationKeys().data(), pTrack->GetRotationKeyCount(), secondsPerTick);
+		ResampleScaleKeys(boneIndex, pTrack->GetScaleKeys().data(), pTrack->GetScaleKeyCount(), secondsPerTick);
+	}
+
+	return true;
+}
+
+void AnimationClipData::Init(uint32_t boneCount, float duration, float sampleRate)
+{
+	assert(boneCount > 0U && sampleRate > 0.0f);
+
+	m_duration = std::max(duration, 0.0f);
+	m_sampleRate = sampleRate;
+	m_boneCount = boneCount;
+
+	// Frames are spread evenly from 0 to duration so the last frame is exactly at the end of the clip.
+	m_frameCount = std::max(static_cast<uint32_t>(std::ceil(m_duration * sampleRate)), 1U) + 1U;
+	m_frameInterval = m_duration / static_cast<float>(m_frameCount - 1U);
+
+	m_frames.assign(static_cast<size_t>(m_frameCount) * boneCount, cd::Transform::Identity());
+	m_compressedClip.Clear();
+	m_hasTracks.assign(boneCount, false);
+	m_parentIndices.assign(boneCount, InvalidBoneIndex);
+	m_boneOrder.resize(boneCount);
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		m_boneOrder[boneIndex] = boneIndex;
+	}
+	m_lodBoneCount = boneCount;
+}
+
+bool AnimationClipData::Restore(std::string name, float duration, float sampleRate, std::vector<cd::Transform> frames,
+	std::vector<uint32_t> parentIndices, std::vector<uint32_t> boneOrder, std::vector<bool> hasTracks)
+{
+	const uint32_t boneCount = static_cast<uint32_t>(parentIndices.size());
+	if (0U == boneCount || sampleRate <= 0.0f || boneOrder.size() != boneCount || hasTracks.size() != boneCount)
+	{
+		return false;
+	}
+
+	std::vector<bool> isOrdered(boneCount, false);
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		const uint32_t orderedBoneIndex = boneOrder[boneIndex];
+		if (orderedBoneIndex >= boneCount || isOrdered[orderedBoneIndex] ||
+			(InvalidBoneIndex != parentIndices[boneIndex] && parentIndices[boneIndex] >= boneCount))
+		{
+			return false;
+		}
+		isOrdered[orderedBoneIndex] = true;
+	}
+
+	Init(boneCount, duration, sampleRate);
+	if (frames.size() != m_frames.size())
+	{
+		return false;
+	}
+
+	m_name = std::move(name);
+	m_frames = std::move(frames);
+	m_parentIndices = std::move(parentIndices);
+	m_boneOrder = std::move(boneOrder);
+	m_hasTracks = std::move(hasTracks);
+	// The saved order already has leaf bones last, this only counts them again.
+	MoveLeafBonesLast();
+
+	return true;
+}
+
+void AnimationClipData::GetFrames(std::vector<cd::Transform>& frames) const
+{
+	if (!IsCompressed())
+	{
+		frames = m_frames;
+		return;
+	}
+
+	frames.resize(static_cast<size_t>(m_frameCount) * m_boneCount);
+	for (uint32_t frameIndex = 0U; frameIndex < m_frameCount; ++frameIndex)
+	{
+		m_compressedClip.SamplePose(static_cast<float>(frameIndex), &frames[static_cast<size_t>(frameIndex) * m_boneCount]);
+	}
+}
+
+void AnimationClipData::SetParentIndex(uint32_t boneIndex, uint32_t parentIndex)
+{
+	assert(parentIndex < boneIndex && boneIndex < m_boneCount);
+	m_parentIndices[boneIndex] = parentIndex;
+
+	// Bone index order keeps parents first, leaf bones are moved again for the new hierarchy.
+	for (uint32_t orderIndex = 0U; orderIndex < m_boneCount; ++orderIndex)
+	{
+		m_boneOrder[orderIndex] = orderIndex;
+	}
+	MoveLeafBonesLast();
+}
+
+void AnimationClipData::MoveLeafBonesLast()
+{
+	std::vector<bool> hasChildren(m_boneCount, false);
+	for (uint32_t boneIndex = 0U; boneIndex < m_boneCount; ++boneIndex)
+	{
+		if (InvalidBoneIndex != m_parentIndices[boneIndex])
+		{
+			hasChildren[m_parentIndices[boneIndex]] = true;
+		}
+	}
+
+	// Leaf bones have no children so moving them after all other bones keeps parents first.
+	auto itFirstLeaf = std::stable_partition(m_boneOrder.begin(), m_boneOrder.end(), [this, &hasChildren](uint32_t boneIndex)
+	{
+		return hasChildren[boneIndex] || InvalidBoneIndex == m_parentIndices[boneIndex];
+	});
+	m_lodBoneCount = static_cast<uint32_t>(itFirstLeaf - m_boneOrder.begin());
+}
+
+bool AnimationClipData::Compress(const AnimationCompressionSettings& settings)
+{
+	if (IsCompressed())
+	{
+		return true;
+	}
+
+	if (!m_compressedClip.Compress(*this, settings))
+	{
+		return false;
+	}
+
+	m_frames.clear();
+	m_frames.shrink_to_fit();
+	return true;
+}
+
+void AnimationClipData::SamplePose(float time, cd::Transform* pPose) const
+{
+	const FrameCursor cursor = GetFrameCursor(time);
+	if (IsCompressed())
+	{
+		m_compressedClip.SamplePose(static_cast<float>(cursor.frameIndex) + cursor.alpha, pPose);
+		return;
+	}
+
+	const cd::Transform* pCurrentFrame = &m_frames[cursor.frameIndex * m_boneCount];
+	const cd::Transform* pNextFrame = pCurrentFrame + m_boneCount;
+	for (uint32_t boneIndex = 0U; boneIndex < m_boneCount; ++boneIndex)
+	{
+		const cd::Transform& current = pCurrentFrame[boneIndex];
+		const cd::Transform& next = pNextFrame[boneIndex];
+		pPose[boneIndex] = cd::Transform(cd::Vec3f::Lerp(current.GetTranslation(), next.GetTranslation(), cursor.alpha),
+			cd::Quaternion::SLerp(current.GetRotation(), next.GetRotation(), cursor.alpha).Normalize(),
+			cd::Vec3f::Lerp(current.GetScale(), next.GetScale(), cursor.alpha));
+	}
+}
+
+void AnimationClipData::SamplePose(float time, SoaPose& pose, uint32_t boneOrderCount, AnimationSampleCursor* pCursor) const
+{
+	assert(pose.GetBoneCount() == m_boneCount);
+	const FrameCursor cursor = GetFrameCursor(time);
+	const float framePosition = static_cast<float>(cursor.frameIndex) + cursor.alpha;
+	if (boneOrderCount < m_boneCount)
+	{
+		for (uint32_t orderIndex = 0U; orderIndex < boneOrderCount; ++orderIndex)
+		{
+			const uint32_t boneIndex = m_boneOrder[orderIndex];
+			pose.SetTransform(boneIndex, IsCompressed() ? m_compressedClip.SampleBone(boneIndex, framePosition, pCursor) : InterpolateFrames(cursor, boneIndex));
+		}
+		return;
+	}
+
+	if (IsCompressed())
+	{
+		m_compressedClip.SamplePose(framePosition, pose, pCursor);
+		return;
+	}
+
+	for (uint32_t boneIndex = 0U; boneIndex < m_boneCount; ++boneIndex)
+	{
+		pose.SetTransform(boneIndex, InterpolateFrames(cursor, boneIndex));
+	}
+}
+
+cd::Transform AnimationClipData::SampleBone(uint32_t boneIndex, float time, AnimationSampleCursor* pCursor) const
+{
+	assert(boneIndex < m_boneCount);
+	const FrameCursor cursor = GetFrameCursor(time);
+	if (IsCompressed())
+	{
+		return m_compressedClip.SampleBone(boneIndex, static_cast<float>(cursor.frameIndex) + cursor.alpha, pCursor);
+	}
+
+	return InterpolateFrames(cursor, boneIndex);
+}
+
+AnimationClipData::FrameCursor AnimationClipData::GetFrameCursor(float time) const
+{
+	if (m_frameInterval <= 0.0f)
+	{
+		return FrameCursor{ 0U, 0.0f };
+	}
+
+	// Always returns a frame which has a next frame so that callers don't need to check the last frame.
+	const float framePosition = std::clamp(time, 0.0f, m_duration) / m_frameInterval;
+	const uint32_t frameIndex = std::min(static_cast<uint32_t>(framePosition), m_frameCount - 2U);
+	return FrameCursor{ frameIndex, std::min(framePosition - static_cast<float>(frameIndex), 1.0f) };
+}
+
+cd::Transform AnimationClipData::InterpolateFrames(const FrameCursor& cursor, uint32_t boneIndex) const
+{
+	const cd::Transform& current = GetFrameTransform(cursor.frameIndex, boneIndex);
+	const cd::Transform& next = GetFrameTransform(cursor.frameIndex + 1U, boneIndex);
+	return cd::Transform(cd::Vec3f::Lerp(current.GetTranslation(), next.GetTranslation(), cursor.alpha),
+		cd::Quaternion::SLerp(current.GetRotation(), next.GetRotation(), cursor.alpha).Normalize(),
+		cd::Vec3f::Lerp(current.GetScale(), next.GetScale(), cursor.alpha));
+}
+
+float AnimationClipData::GetFrameTime(uint32_t frameIndex) const
+{
+	return frameIndex + 1U == m_frameCount ? m_duration : static_cast<float>(frameIndex) * m_frameInterval;
+}
+
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include "Animation/CompressedAnimationClip.h"
+#include "Math/Transform.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cd
+{
+
+class Animation;
+class SceneDatabase;
+
+}
+
+namespace engine
+{
+
+class SoaPose;
+
+// AnimationClipData is the runtime form of a cd::Animation. Every track is resampled at a fixed rate
+// into one pose per frame so that sampling only computes a frame index instead of searching keys.
+// Tracks are resolved to bone indices once when compiling, sampling doesn't touch names or the SceneDatabase.
+class AnimationClipData final
+{
+public:
+	static constexpr float DefaultSampleRate = 30.0f;
+	static constexpr uint32_t InvalidBoneIndex = UINT32_MAX;
+
+public:
+	AnimationClipData() = default;
+	AnimationClipData(const AnimationClipData&) = delete;
+	AnimationClipData& operator=(const AnimationClipData&) = delete;
+	AnimationClipData(AnimationClipData&&) = default;
+	AnimationClipData& operator=(AnimationClipData&&) = default;
+	~AnimationClipData() = default;
+
+	// Resamples tracks of animation which are named by clip name and bone name for all bones in the SceneDatabase.
+	bool Compile(const cd::SceneDatabase* pSceneDatabase, const cd::Animation& animation, float sampleRate = DefaultSampleRate);
+
+	// Allocates frames for boneCount bones. Bones without a track keep the identity transform.
+	void Init(uint32_t boneCount, float duration, float sampleRate = DefaultSampleRate);
+
+	// Restores a clip which was compiled before from its frames and hierarchy, e.g. from a scene snapshot.
+	// frames are frame major like GetFrames. Returns false if sizes don't match or boneOrder is not a bone permutation.
+	bool Restore(std::string name, float duration, float sampleRate, std::vector<cd::Transform> frames,
+		std::vector<uint32_t> parentIndices, std::vector<uint32_t> boneOrder, std::vector<bool> hasTracks);
+
+	// Bones from Init have no parent. Parent index should be less than bone index to keep the bone order.
+	void SetParentIndex(uint32_t boneIndex, uint32_t parentIndex);
+
+	// Keys need GetTime and GetValue and should be sorted by time. Times before the first key and
+	// after the last key clamp to the first and the last key. Key times are multiplied by secondsPerTick.
+	template<typename Key>
+	void ResampleTranslationKeys(uint32_t boneIndex, const Key* pKeys, uint32_t keyCount, float secondsPerTick = 1.0f);
+	template<typename Key>
+	void ResampleRotationKeys(uint32_t boneIndex, const Key* pKeys, uint32_t keyCount, float secondsPerTick = 1.0f);
+	template<typename Key>
+	void ResampleScaleKeys(uint32_t boneIndex, const Key* pKeys, uint32_t keyCount, float secondsPerTick = 1.0f);
+
+	// Replaces frames by a CompressedAnimationClip. Keys are decompressed when sampling.
+	bool Compress(const AnimationCompressionSettings& settings = AnimationCompressionSettings());
+	bool IsCompressed() const { return !m_compressedClip.IsEmpty(); }
+	const CompressedAnimationClip& GetCompressedClip() const { return m_compressedClip; }
+	// Bytes of frames or compressed keys.
+	size_t GetMemorySize() const { return m_frames.size() * sizeof(cd::Transform) + m_compressedClip.GetMemorySize(); }
+
+	// Local transforms of all bones at time. pPose needs GetBoneCount elements.
+	void SamplePose(float time, cd::Transform* pPose) const;
+	// Only the first boneOrderCount bones of GetBoneOrder are sampled, the others keep their values.
+	// pCursor speeds up key lookups of compressed clips which are played forward.
+	void SamplePose(float time, SoaPose& pose, uint32_t boneOrderCount = UINT32_MAX, AnimationSampleCursor* pCursor = nullptr) const;
+	cd::Transform SampleBone(uint32_t boneIndex, float time, AnimationSampleCursor* pCursor = nullptr) const;
+
+	const std::string& GetName() const { return m_name; }
+	float GetDuration() const { return m_duration; }
+	float GetSampleRate() const { return m_sampleRate; }
+	uint32_t GetFrameCount() const { return m_frameCount; }
+	uint32_t GetBoneCount() const { return m_boneCount; }
+
+	bool HasTrack(uint32_t boneIndex) const { return m_hasTracks[boneIndex]; }
+
+	// Parents are placed before their children so that global transforms can be built in one pass.
+	// Leaf bones are placed after all other bones so that LODs can skip them by evaluating a prefix of the order.
+	const std::vector<uint32_t>& GetBoneOrder() const { return m_boneOrder; }
+	// Number of bones before the leaf bones in the bone order. Roots are never counted as leaf bones.
+	uint32_t GetLodBoneCount() const { return m_lodBoneCount; }
+	uint32_t GetParentIndex(uint32_t boneIndex) const { return m_parentIndices[boneIndex]; }
+
+	// Frames of all bones, frame major. Compressed clips are decompressed so the frames carry the compression error.
+	void GetFrames(std::vector<cd::Transform>& frames) const;
+
+	// Resampled frames which are only available before compressing.
+	const cd::Transform& GetFrameTransform(uint32_t frameIndex, uint32_t boneIndex) const { assert(!IsCompressed()); return m_frames[frameIndex * m_boneCount + boneIndex]; }
+
+private:
+	struct FrameCursor
+	{
+		uint32_t frameIndex;
+		float alpha;
+	};
+
+	FrameCursor GetFrameCursor(float time) const;
+	cd::Transform InterpolateFrames(const FrameCursor& cursor, uint32_t boneIndex) const;
+	void MoveLeafBonesLast();
+	float GetFrameTime(uint32_t frameIndex) const;
+	cd::Transform& GetFrameTransform(uint32_t frameIndex, uint32_t boneIndex) { return m_frames[frameIndex * m_boneCount + boneIndex]; }
+
+	template<typename Key, typename Interpolate, typename Apply>
+	void ResampleKeys(const Key* pKeys, uint32_t keyCount, float secondsPerTick, Interpolate interpolate, Apply apply);
+
+private:
+	std::string m_name;
+	float m_duration = 0.0f;
+	float m_sampleRate = DefaultSampleRate;
+	float m_frameInterval = 0.0f;
+	uint32_t m_frameCount = 0U;
+	uint32_t m_boneCount = 0U;
+	uint32_t m_lodBoneCount = 0U;
+
+	// Frame major so that sampling a whole pose reads two contiguous ranges.
+	std::vector<cd::Transform> m_frames;
+	CompressedAnimationClip m_compressedClip;
+	std::vector<bool> m_hasTracks;
+	std::vector<uint32_t> m_boneOrder;
+	std::vector<uint32_t> m_parentIndices;
+};
+
+template<typename Key, typename Interpolate, typename Apply>
+void AnimationClipData::ResampleKeys(const Key* pKeys, uint32_t keyCount, float secondsPerTick, Interpolate interpolate, Apply apply)
+{
+	if (0U == keyCount)
+	{
+		return;
+	}
+
+	// Frame times only grow so the key cursor never moves back. It is linear in keys and frames.
+	uint32_t keyIndex = 0U;
+	for (uint32_t frameIndex = 0U; frameIndex < m_frameCount; ++frameIndex)
+	{
+		const float frameTime = GetFrameTime(frameIndex);
+		while (keyIndex + 1U < keyCount && pKeys[keyIndex + 1U].GetTime() * secondsPerTick <= frameTime)
+		{
+			++keyIndex;
+		}
+
+		const Key& currentKey = pKeys[keyIndex];
+		const float currentKeyTime = currentKey.GetTime() * secondsPerTick;
+		if (keyIndex + 1U == keyCount || frameTime <= currentKeyTime)
+		{
+			apply(frameIndex, currentKey.GetValue());
+			continue;
+		}
+
+		const Key& nextKey = pKeys[keyIndex + 1U];
+		float keyFrameRate = (frameTime - currentKeyTime) / (nextKey.GetTime() * secondsPerTick - currentKeyTime);
+		apply(frameIndex, interpolate(currentKey.GetValue(), nextKey.GetValue(), keyFrameRate));
+	}
+}
+
+template<typename Key>
+void AnimationClipData::ResampleTranslationKeys(uint32_t boneIndex, const Key* pKeys, uint32_t keyCount, float secondsPerTick)
+{
+	assert(boneIndex < m_boneCount && !IsCompressed());
+	m_hasTracks[boneIndex] = m_hasTracks[boneIndex] || keyCount > 0U;
+	ResampleKeys(pKeys, keyCount, secondsPerTick,
+		[](const cd::Vec3f& a, const cd::Vec3f& b, float t) { return cd::Vec3f::Lerp(a, b, t); },
+		[this, boneIndex](uint32_t frameIndex, const cd::Vec3f& value) { GetFrameTransform(frameIndex, boneIndex).SetTranslation(value); });
+}
+
+template<typename Key>
+void AnimationClipData::ResampleRotationKeys(uint32_t boneIndex, const Key* pKeys, uint32_t keyCount, float secondsPerTick)
+{
+	assert(boneIndex < m_boneCount && !IsCompressed());
+	m_hasTracks[boneIndex] = m_hasTracks[boneIndex] || keyCount > 0U;
+	ResampleKeys(pKeys, keyCount, secondsPerTick,
+		[](const cd::Quaternion& a, const cd::Quaternion& b, float t) { return cd::Quaternion::SLerp(a, b, t).Normalize(); },
+		[this, boneIndex](uint32_t frameIndex, const cd::Quaternion& value) { GetFrameTransform(frameIndex, boneIndex).SetRotation(value); });
+}
+
+template<typename Key>
+void AnimationClipData::ResampleScaleKeys(uint32_t boneIndex, const Key* pKeys, uint32_t keyCount, float secondsPerTick)
+{
+	assert(boneIndex < m_boneCount && !IsCompressed());
+	m_hasTracks[boneIndex] = m_hasTracks[boneIndex] || keyCount > 0U;
+	ResampleKeys(pKeys, keyCount, secondsPerTick,
+		[](const cd::Vec3f& a, const cd::Vec3f& b, float t) { return cd::Vec3f::Lerp(a, b, t); },
+		[this, boneIndex](uint32_t frameIndex, const cd::Vec3f& value) { GetFrameTransform(frameIndex, boneIndex).SetScale(value); });
+}
+
+}
@@ -0,0 +1,87 @@
+#include "AnimationLod.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace engine
+{
+
+float AnimationLod::GetScreenSize(const cd::Matrix4x4& viewMatrix, const cd::Matrix4x4& projectionMatrix, const cd::Vec3f& center, float radius)
+{
+	// Matrices are column major.
+	const float* pView = viewMatrix.begin();
+	const float* pProjection = projectionMatrix.begin();
+	float viewCenter[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	for (uint32_t row = 0U; row < 3U; ++row)
+	{
+		viewCenter[row] = pView[row] * center[0] + pView[4U + row] * center[1] + pView[8U + row] * center[2] + pView[12U + row];
+	}
+
+	float rows[4][4];
+	for (uint32_t row = 0U; row < 4U; ++row)
+	{
+		for (uint32_t column = 0U; column < 4U; ++column)
+		{
+			rows[row][column] = pProjection[column * 4U + row];
+		}
+	}
+
+	// Side and far planes are the w row plus or minus the x, y and z rows. Side planes meet at the eye so
+	// they also reject spheres behind the camera. The near plane is skipped because it depends on the NDC depth.
+	constexpr int planeRows[5][2] = { { 0, 1 }, { 0, -1 }, { 1, 1 }, { 1, -1 }, { 2, -1 } };
+	for (const auto& [row, sign] : planeRows)
+	{
+		float plane[4];
+		for (uint32_t column = 0U; column < 4U; ++column)
+		{
+			plane[column] = rows[3][column] + static_cast<float>(sign) * rows[row][column];
+		}
+
+		const float normalLength = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+		const float distance = plane[0] * viewCenter[0] + plane[1] * viewCenter[1] + plane[2] * viewCenter[2] + plane[3];
+		if (normalLength > 0.0f && distance < -radius * normalLength)
+		{
+			return 0.0f;
+		}
+	}
+
+	// w is the view depth for perspective projections and 1 for orthographic ones.
+	const float w = rows[3][0] * viewCenter[0] + rows[3][1] * viewCenter[1] + rows[3][2] * viewCenter[2] + rows[3][3];
+	return radius * std::abs(pProjection[5]) / std::max(w, radius);
+}
+
+AnimationLodLevel AnimationLod::SelectLevel(float screenSize, const AnimationLodSettings& settings, bool isShadowCaster)
+{
+	for (uint32_t levelIndex = 0U; levelIndex < static_cast<uint32_t>(AnimationLodLevel::Culled); ++levelIndex)
+	{
+		if (screenSize >= settings.screenSizes[levelIndex])
+		{
+			return static_cast<AnimationLodLevel>(levelIndex);
+		}
+	}
+
+	return isShadowCaster ? static_cast<AnimationLodLevel>(static_cast<uint32_t>(AnimationLodLevel::Culled) - 1U) : AnimationLodLevel::Culled;
+}
+
+uint32_t AnimationLod::GetUpdateInterval(AnimationLodLevel level, const AnimationLodSettings& settings)
+{
+	return AnimationLodLevel::Culled == level ? 0U : std::max(settings.updateIntervals[static_cast<uint32_t>(level)], 1U);
+}
+
+bool AnimationLod::IsUpdateFrame(uint64_t frameIndex, uint32_t stagger, uint32_t updateInterval)
+{
+	return updateInterval <= 1U || 0U == (frameIndex + stagger) % updateInterval;
+}
+
+void AnimationLod::InterpolateMatrices(const cd::Matrix4x4* pSource, const cd::Matrix4x4* pTarget, float alpha, uint32_t count, cd::Matrix4x4* pResult)
+{
+	const float* pSourceElements = reinterpret_cast<const float*>(pSource);
+	const float* pTargetElements = reinterpret_cast<const float*>(pTarget);
+	float* pResultElements = reinterpret_cast<float*>(pResult);
+	for (uint32_t elementIndex = 0U; elementIndex < count * 16U; ++elementIndex)
+	{
+		pResultElements[elementIndex] = pSourceElements[elementIndex] + (pTargetElements[elementIndex] - pSourceElements[elementIndex]) * alpha;
+	}
+}
+
+}
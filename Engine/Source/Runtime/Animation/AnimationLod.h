@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Math/Matrix.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+
+// From the most detailed level. Characters which are smaller on screen use later levels.
+enum class AnimationLodLevel : uint8_t
+{
+	Full,
+	Half,
+	Quarter,
+	Culled,
+	Count
+};
+
+struct AnimationLodSettings
+{
+	// Smallest height on screen as a fraction of the viewport height for Full, Half and Quarter.
+	// Smaller characters and characters outside of the view frustum are Culled unless they cast shadows.
+	float screenSizes[3] = { 0.2f, 0.08f, 0.005f };
+	// Frames between two evaluations for Full, Half and Quarter. Skinning matrices are interpolated in between.
+	uint32_t updateIntervals[3] = { 1U, 2U, 4U };
+	// Levels from this one don't evaluate leaf bones such as fingers and face bones.
+	AnimationLodLevel leafBoneLevel = AnimationLodLevel::Quarter;
+	// Animated bones can leave the bind pose bounds.
+	float boundsScale = 1.5f;
+};
+
+// Camera which drives LOD selection of one frame.
+struct AnimationLodView
+{
+	cd::Matrix4x4 viewMatrix;
+	cd::Matrix4x4 projectionMatrix;
+	uint64_t frameIndex;
+	float deltaTime;
+	// Characters outside of the view frustum can still cast shadows into it so they are never Culled.
+	bool hasShadowCasters = false;
+};
+
+// Per entity state of interpolated updates. Poses are evaluated ahead at targetTime so that frames
+// between two evaluations interpolate towards the future pose instead of lagging behind.
+struct AnimationLodState
+{
+	AnimationLodLevel level = AnimationLodLevel::Full;
+	bool hasTarget = false;
+	float sourceTime = 0.0f;
+	float targetTime = 0.0f;
+	std::vector<cd::Matrix4x4> sourceSkinningMatrices;
+	std::vector<cd::Matrix4x4> targetSkinningMatrices;
+};
+
+// Counts of one EvaluateAll call.
+struct AnimationLodStats
+{
+	uint32_t evaluatedBoneCount = 0U;
+	uint32_t evaluatedEntityCount = 0U;
+	uint32_t interpolatedEntityCount = 0U;
+	uint32_t culledEntityCount = 0U;
+};
+
+class AnimationLod final
+{
+public:
+	AnimationLod() = delete;
+
+	// Height of a bounding sphere on screen as a fraction of the viewport height. 0 if it is outside of the view frustum.
+	static float GetScreenSize(const cd::Matrix4x4& viewMatrix, const cd::Matrix4x4& projectionMatrix, const cd::Vec3f& center, float radius);
+	// Shadow casters stay on the last level before Culled, their skinning matrices would be stale otherwise.
+	static AnimationLodLevel SelectLevel(float screenSize, const AnimationLodSettings& settings, bool isShadowCaster = false);
+
+	// 0 for Culled.
+	static uint32_t GetUpdateInterval(AnimationLodLevel level, const AnimationLodSettings& settings);
+	static bool IsLeafBoneSkipped(AnimationLodLevel level, const AnimationLodSettings& settings) { return level >= settings.leafBoneLevel; }
+
+	// Entities with different staggers update on different frames so that their cost is spread.
+	static bool IsUpdateFrame(uint64_t frameIndex, uint32_t stagger, uint32_t updateInterval);
+
+	// Lerps every element. Close enough to the real pose for the small changes between two updates.
+	static void InterpolateMatrices(const cd::Matrix4x4* pSource, const cd::Matrix4x4* pTarget, float alpha, uint32_t count, cd::Matrix4x4* pResult);
+};
+
+}
@@ -0,0 +1,215 @@
+#include "BlendShapeBatch.h"
+
+#include <cassert>
+
+namespace engine
+{
+
+uint32_t BlendShapeBatch::AddMesh(const cd::Vec3f* pBasePositions, uint32_t vertexCount, const BlendShapeMorphTarget* pMorphTargets, uint32_t morphCount)
+{
+	Mesh mesh;
+	mesh.firstVertex = GetTotalVertexCount();
+	mesh.vertexCount = vertexCount;
+	mesh.firstAffectedVertex = static_cast<uint32_t>(m_affectedVertices.size());
+	mesh.affectedVertexCount = 0U;
+	mesh.firstWeight = static_cast<uint32_t>(m_weights.size());
+	mesh.morphCount = morphCount;
+	mesh.isChanged = true;
+
+	m_basePositions.reserve(m_basePositions.size() + vertexCount * 4U);
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const cd::Vec3f& position = pBasePositions[vertexIndex];
+		m_basePositions.insert(m_basePositions.end(), { position[0], position[1], position[2], 1.0f });
+	}
+	m_weights.resize(m_weights.size() + morphCount, 0.0f);
+
+	// Deltas per vertex first so that they can be stored grouped by vertex. Targets at the base position are dropped.
+	auto isMoved = [pBasePositions](const cd::Vec3f& position, uint32_t vertexID)
+	{
+		const cd::Vec3f& basePosition = pBasePositions[vertexID];
+		return position[0] != basePosition[0] || position[1] != basePosition[1] || position[2] != basePosition[2];
+	};
+
+	std::vector<uint32_t> vertexDeltaCounts(vertexCount, 0U);
+	for (uint32_t morphIndex = 0U; morphIndex < morphCount; ++morphIndex)
+	{
+		const BlendShapeMorphTarget& morphTarget = pMorphTargets[morphIndex];
+		for (uint32_t targetIndex = 0U; targetIndex < morphTarget.vertexCount; ++targetIndex)
+		{
+			const uint32_t vertexID = morphTarget.pVertexIDs[targetIndex];
+			assert(vertexID < vertexCount);
+			if (vertexID < vertexCount && isMoved(morphTarget.pPositions[targetIndex], vertexID))
+			{
+				++vertexDeltaCounts[vertexID];
+			}
+		}
+	}
+
+	// Delta cursor of every affected vertex.
+	std::vector<uint32_t> vertexDeltaCursors(vertexCount, UINT32_MAX);
+	uint32_t deltaCount = static_cast<uint32_t>(m_morphDeltas.size());
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		if (0U == vertexDeltaCounts[vertexIndex])
+		{
+			continue;
+		}
+
+		const cd::Vec3f& basePosition = pBasePositions[vertexIndex];
+		AffectedVertex affectedVertex;
+		affectedVertex.basePosition[0] = basePosition[0];
+		affectedVertex.basePosition[1] = basePosition[1];
+		affectedVertex.basePosition[2] = basePosition[2];
+		affectedVertex.outputVertex = mesh.firstVertex + vertexIndex;
+		affectedVertex.firstDelta = deltaCount;
+		affectedVertex.deltaCount = vertexDeltaCounts[vertexIndex];
+		affectedVertex.firstWeight = mesh.firstWeight;
+		affectedVertex.padding = 0U;
+		m_affectedVertices.push_back(affectedVertex);
+
+		vertexDeltaCursors[vertexIndex] = deltaCount;
+		deltaCount += vertexDeltaCounts[vertexIndex];
+	}
+	mesh.affectedVertexCount = static_cast<uint32_t>(m_affectedVertices.size()) - mesh.firstAffectedVertex;
+
+	m_morphDeltas.resize(deltaCount);
+	for (uint32_t morphIndex = 0U; morphIndex < morphCount; ++morphIndex)
+	{
+		const BlendShapeMorphTarget& morphTarget = pMorphTargets[morphIndex];
+		for (uint32_t targetIndex = 0U; targetIndex < morphTarget.vertexCount; ++targetIndex)
+		{
+			const uint32_t vertexID = morphTarget.pVertexIDs[targetIndex];
+			const cd::Vec3f& position = morphTarget.pPositions[targetIndex];
+			if (vertexID >= vertexCount || !isMoved(position, vertexID))
+			{
+				continue;
+			}
+
+			const cd::Vec3f& basePosition = pBasePositions[vertexID];
+			MorphDelta& morphDelta = m_morphDeltas[vertexDeltaCursors[vertexID]++];
+			morphDelta.morphIndex = morphIndex;
+			morphDelta.delta[0] = position[0] - basePosition[0];
+			morphDelta.delta[1] = position[1] - basePosition[1];
+			morphDelta.delta[2] = position[2] - basePosition[2];
+		}
+	}
+
+	m_maxWorkGroupCount += (mesh.affectedVertexCount + GroupVertexCount - 1U) / GroupVertexCount;
+	m_meshes.push_back(mesh);
+
+	return static_cast<uint32_t>(m_meshes.size()) - 1U;
+}
+
+void BlendShapeBatch::Clear()
+{
+	m_meshes.clear();
+	m_basePositions.clear();
+	m_affectedVertices.clear();
+	m_morphDeltas.clear();
+	m_weights.clear();
+	m_maxWorkGroupCount = 0U;
+	m_workGroups.clear();
+	m_changedMeshes.clear();
+}
+
+bool BlendShapeBatch::SetWeights(uint32_t meshIndex, const float* pWeights)
+{
+	bool isChanged = false;
+	for (uint32_t morphIndex = 0U; morphIndex < m_meshes[meshIndex].morphCount; ++morphIndex)
+	{
+		isChanged |= SetWeight(meshIndex, morphIndex, pWeights[morphIndex]);
+	}
+
+	return isChanged;
+}
+
+bool BlendShapeBatch::SetWeight(uint32_t meshIndex, uint32_t morphIndex, float weight)
+{
+	Mesh& mesh = m_meshes[meshIndex];
+	assert(morphIndex < mesh.morphCount);
+	float& currentWeight = m_weights[mesh.firstWeight + morphIndex];
+	if (currentWeight == weight)
+	{
+		return false;
+	}
+
+	currentWeight = weight;
+	mesh.isChanged = true;
+	return true;
+}
+
+void BlendShapeBatch::MarkAllChanged()
+{
+	for (Mesh& mesh : m_meshes)
+	{
+		mesh.isChanged = true;
+	}
+}
+
+uint32_t BlendShapeBatch::BuildWorkGroups()
+{
+	m_workGroups.clear();
+	m_changedMeshes.clear();
+	for (uint32_t meshIndex = 0U; meshIndex < GetMeshCount(); ++meshIndex)
+	{
+		Mesh& mesh = m_meshes[meshIndex];
+		if (!mesh.isChanged)
+		{
+			continue;
+		}
+
+		mesh.isChanged = false;
+		m_changedMeshes.push_back(meshIndex);
+		for (uint32_t affectedIndex = 0U; affectedIndex < mesh.affectedVertexCount; affectedIndex += GroupVertexCount)
+		{
+			const uint32_t affectedVertexCount = mesh.affectedVertexCount - affectedIndex < GroupVertexCount ? mesh.affectedVertexCount - affectedIndex : GroupVertexCount;
+			m_workGroups.push_back({ mesh.firstAffectedVertex + affectedIndex, affectedVertexCount });
+		}
+	}
+
+	return static_cast<uint32_t>(m_workGroups.size());
+}
+
+void BlendShapeBatch::Evaluate(float* pOutputPositions) const
+{
+	EvaluateWorkGroups(m_workGroups.data(), static_cast<uint32_t>(m_workGroups.size()), pOutputPositions);
+}
+
+void BlendShapeBatch::EvaluateWorkGroups(const WorkGroup* pWorkGroups, uint32_t groupCount, float* pOutputPositions) const
+{
+	// Same math as cs_blendshape_batch. Every affected vertex is rebuilt from its base position so errors don't accumulate.
+	for (uint32_t groupIndex = 0U; groupIndex < groupCount; ++groupIndex)
+	{
+		const WorkGroup& workGroup = pWorkGroups[groupIndex];
+		for (uint32_t affectedIndex = workGroup.firstAffectedVertex; affectedIndex < workGroup.firstAffectedVertex + workGroup.affectedVertexCount; ++affectedIndex)
+		{
+			const AffectedVertex& affectedVertex = m_affectedVertices[affectedIndex];
+			float position[3] = { affectedVertex.basePosition[0], affectedVertex.basePosition[1], affectedVertex.basePosition[2] };
+			float weightSum = 0.0f;
+			for (uint32_t deltaIndex = affectedVertex.firstDelta; deltaIndex < affectedVertex.firstDelta + affectedVertex.deltaCount; ++deltaIndex)
+			{
+				const MorphDelta& morphDelta = m_morphDeltas[deltaIndex];
+				const float weight = m_weights[affectedVertex.firstWeight + morphDelta.morphIndex];
+				position[0] += weight * morphDelta.delta[0];
+				position[1] += weight * morphDelta.delta[1];
+				position[2] += weight * morphDelta.delta[2];
+				weightSum += weight;
+			}
+
+			float* pOutput = pOutputPositions + affectedVertex.outputVertex * 4U;
+			pOutput[0] = position[0];
+			pOutput[1] = position[1];
+			pOutput[2] = position[2];
+			pOutput[3] = 1.0f - weightSum;
+		}
+	}
+}
+
+size_t BlendShapeBatch::GetMemorySize() const
+{
+	return m_meshes.size() * sizeof(Mesh) + m_basePositions.size() * sizeof(float) + m_affectedVertices.size() * sizeof(AffectedVertex) +
+		m_morphDeltas.size() * sizeof(MorphDelta) + m_weights.size() * sizeof(float);
+}
+
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Math/Vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+
+// Target positions of one morph. Vertices which the morph doesn't move can be left out.
+struct BlendShapeMorphTarget
+{
+	const uint32_t* pVertexIDs;
+	const cd::Vec3f* pPositions;
+	uint32_t vertexCount;
+};
+
+// BlendShapeBatch keeps morph deltas of all blend shape meshes in one sparse buffer so that one compute
+// dispatch per frame updates every mesh whose weights changed:
+// - Only vertices which at least one morph moves are stored. Other vertices keep their base position.
+// - Deltas are grouped by vertex so one thread sums all morphs of its vertex without atomics.
+// - Meshes whose weights didn't change since the last dispatch are not in the work list.
+// Buffers are arrays of 32 bit values which cs_blendshape_batch reads as uint.
+class BlendShapeBatch final
+{
+public:
+	static constexpr uint32_t InvalidMeshIndex = UINT32_MAX;
+	// Vertices per work group. Same as BS_BATCH_THREAD_COUNT in U_BlendShape.sh.
+	static constexpr uint32_t GroupVertexCount = 64U;
+
+	struct AffectedVertex
+	{
+		float basePosition[3];
+		uint32_t outputVertex;
+		uint32_t firstDelta;
+		uint32_t deltaCount;
+		uint32_t firstWeight;
+		uint32_t padding;
+	};
+
+	// Offset from the base position to the morph target.
+	struct MorphDelta
+	{
+		uint32_t morphIndex;
+		float delta[3];
+	};
+
+	struct WorkGroup
+	{
+		uint32_t firstAffectedVertex;
+		uint32_t affectedVertexCount;
+	};
+
+	static_assert(sizeof(AffectedVertex) == 32U && sizeof(MorphDelta) == 16U && sizeof(WorkGroup) == 8U,
+		"Blend shape buffers are read as uint arrays by cs_blendshape_batch.");
+
+public:
+	BlendShapeBatch() = default;
+	BlendShapeBatch(const BlendShapeBatch&) = delete;
+	BlendShapeBatch& operator=(const BlendShapeBatch&) = delete;
+	BlendShapeBatch(BlendShapeBatch&&) = default;
+	BlendShapeBatch& operator=(BlendShapeBatch&&) = default;
+	~BlendShapeBatch() = default;
+
+	// Returns the index of the mesh. Its vertices start at GetFirstVertex in the output positions and weights start at 0.
+	uint32_t AddMesh(const cd::Vec3f* pBasePositions, uint32_t vertexCount, const BlendShapeMorphTarget* pMorphTargets, uint32_t morphCount);
+	void Clear();
+
+	// Returns true if a weight changed. Only changed meshes are evaluated by the next work list.
+	bool SetWeights(uint32_t meshIndex, const float* pWeights);
+	bool SetWeight(uint32_t meshIndex, uint32_t morphIndex, float weight);
+	// All meshes are evaluated by the next work list, e.g. after the output buffer was recreated.
+	void MarkAllChanged();
+
+	// Work groups of meshes changed since the last call. Returns the group count.
+	uint32_t BuildWorkGroups();
+	const std::vector<WorkGroup>& GetWorkGroups() const { return m_workGroups; }
+	const std::vector<uint32_t>& GetChangedMeshes() const { return m_changedMeshes; }
+	// Upper bound of BuildWorkGroups so that its buffer can be allocated once.
+	uint32_t GetMaxWorkGroupCount() const { return m_maxWorkGroupCount; }
+
+	// CPU version of cs_blendshape_batch which runs the current work groups.
+	// pOutputPositions has 4 floats per vertex, position and the weight which is left for the base position.
+	void Evaluate(float* pOutputPositions) const;
+	void EvaluateWorkGroups(const WorkGroup* pWorkGroups, uint32_t groupCount, float* pOutputPositions) const;
+
+	uint32_t GetMeshCount() const { return static_cast<uint32_t>(m_meshes.size()); }
+	uint32_t GetFirstVertex(uint32_t meshIndex) const { return m_meshes[meshIndex].firstVertex; }
+	uint32_t GetVertexCount(uint32_t meshIndex) const { return m_meshes[meshIndex].vertexCount; }
+	uint32_t GetAffectedVertexCount(uint32_t meshIndex) const { return m_meshes[meshIndex].affectedVertexCount; }
+	uint32_t GetTotalVertexCount() const { return static_cast<uint32_t>(m_basePositions.size() / 4U); }
+
+	// Initial content of the output buffer, 4 floats per vertex like the evaluated positions.
+	const std::vector<float>& GetBasePositions() const { return m_basePositions; }
+	const std::vector<AffectedVertex>& GetAffectedVertices() const { return m_affectedVertices; }
+	const std::vector<MorphDelta>& GetMorphDeltas() const { return m_morphDeltas; }
+	const std::vector<float>& GetWeights() const { return m_weights; }
+	size_t GetMemorySize() const;
+
+private:
+	struct Mesh
+	{
+		uint32_t firstVertex;
+		uint32_t vertexCount;
+		uint32_t firstAffectedVertex;
+		uint32_t affectedVertexCount;
+		uint32_t firstWeight;
+		uint32_t morphCount;
+		bool isChanged;
+	};
+
+	std::vector<Mesh> m_meshes;
+	std::vector<float> m_basePositions;
+	std::vector<AffectedVertex> m_affectedVertices;
+	std::vector<MorphDelta> m_morphDeltas;
+	std::vector<float> m_weights;
+
+	uint32_t m_maxWorkGroupCount = 0U;
+	std::vector<WorkGroup> m_workGroups;
+	std::vector<uint32_t> m_changedMeshes;
+};
+
+}
@@ -0,0 +1,445 @@
+#include "CompressedAnimationClip.h"
+
+#include "Animation/AnimationClipData.h"
+#include "Animation/SoaPose.h"
+#include "Log/Log.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace engine
+{
+
+namespace
+{
+
+constexpr float QuantizedVectorScale = 65535.0f;
+constexpr float QuantizedComponentScale = 32767.0f;
+constexpr uint16_t QuantizedComponentMask = 0x7FFF;
+// Components other than the largest one are in [-1 / sqrt(2), 1 / sqrt(2)].
+constexpr float SmallestComponentRange = 0.70710678f;
+
+cd::Quaternion MakeQuaternion(float x, float y, float z, float w)
+{
+	cd::Quaternion rotation = cd::Quaternion::Identity();
+	rotation.x() = x;
+	rotation.y() = y;
+	rotation.z() = z;
+	rotation.w() = w;
+	return rotation;
+}
+
+float Dot(const cd::Quaternion& a, const cd::Quaternion& b)
+{
+	return a.x() * b.x() + a.y() * b.y() + a.z() * b.z() + a.w() * b.w();
+}
+
+// Keys are close to each other so normalized lerp is near slerp and cheaper to decompress.
+cd::Quaternion NLerp(const cd::Quaternion& a, const cd::Quaternion& b, float t)
+{
+	// q and -q are the same rotation, interpolate on the hemisphere of a.
+	const float sign = Dot(a, b) < 0.0f ? -1.0f : 1.0f;
+	cd::Quaternion rotation = MakeQuaternion(a.x() + (b.x() * sign - a.x()) * t,
+		a.y() + (b.y() * sign - a.y()) * t,
+		a.z() + (b.z() * sign - a.z()) * t,
+		a.w() + (b.w() * sign - a.w()) * t);
+	return rotation.Normalize();
+}
+
+float VectorError(const cd::Vec3f& a, const cd::Vec3f& b)
+{
+	return std::max({ std::abs(a[0] - b[0]), std::abs(a[1] - b[1]), std::abs(a[2] - b[2]) });
+}
+
+// Angle between two rotations. The chord between them keeps precision for small angles where acos of the dot doesn't.
+float RotationError(const cd::Quaternion& a, const cd::Quaternion& b)
+{
+	const float sign = Dot(a, b) < 0.0f ? -1.0f : 1.0f;
+	const float x = a.x() - b.x() * sign;
+	const float y = a.y() - b.y() * sign;
+	const float z = a.z() - b.z() * sign;
+	const float w = a.w() - b.w() * sign;
+	return 4.0f * std::asin(std::min(0.5f * std::sqrt(x * x + y * y + z * z + w * w), 1.0f));
+}
+
+// Segments grow while interpolating their end keys reproduces all frames inside within tolerance.
+// End keys are decoded values so that the quantization error is included.
+// Segments are at most MaxSegmentFrameCount frames so every frame is checked against a bounded number of segment ends.
+template<typename Value, typename Interpolate, typename Error>
+void ReduceKeys(const std::vector<Value>& frames, const std::vector<Value>& decodedFrames, float tolerance,
+	Interpolate interpolate, Error error, std::vector<uint16_t>& keyFrames)
+{
+	const uint32_t frameCount = static_cast<uint32_t>(frames.size());
+	keyFrames.clear();
+	keyFrames.push_back(0U);
+
+	// Constant tracks such as unit scales keep one key.
+	bool isConstant = true;
+	for (uint32_t frameIndex = 1U; frameIndex < frameCount && isConstant; ++frameIndex)
+	{
+		isConstant = error(decodedFrames[0], frames[frameIndex]) <= tolerance;
+	}
+
+	if (isConstant)
+	{
+		return;
+	}
+
+	uint32_t segmentBegin = 0U;
+	for (uint32_t segmentEnd = 2U; segmentEnd < frameCount; ++segmentEnd)
+	{
+		bool isSegmentEnded = segmentEnd - segmentBegin > CompressedAnimationClip::MaxSegmentFrameCount;
+		for (uint32_t frameIndex = segmentBegin + 1U; frameIndex < segmentEnd && !isSegmentEnded; ++frameIndex)
+		{
+			const float alpha = static_cast<float>(frameIndex - segmentBegin) / static_cast<float>(segmentEnd - segmentBegin);
+			isSegmentEnded = error(interpolate(decodedFrames[segmentBegin], decodedFrames[segmentEnd], alpha), frames[frameIndex]) > tolerance;
+		}
+
+		if (isSegmentEnded)
+		{
+			// The previous frame ends this segment and begins the next one.
+			segmentBegin = segmentEnd - 1U;
+			keyFrames.push_back(static_cast<uint16_t>(segmentBegin));
+		}
+	}
+
+	keyFrames.push_back(static_cast<uint16_t>(frameCount - 1U));
+}
+
+}
+
+bool CompressedAnimationClip::Compress(const AnimationClipData& clip, const AnimationCompressionSettings& settings)
+{
+	assert(!clip.IsCompressed());
+	Clear();
+
+	const uint32_t frameCount = clip.GetFrameCount();
+	if (frameCount > UINT16_MAX + 1U)
+	{
+		CD_ENGINE_ERROR("Failed to compress animation clip {0} with {1} frames.", clip.GetName(), frameCount);
+		return false;
+	}
+
+	const uint32_t boneCount = clip.GetBoneCount();
+	m_tracks.resize(static_cast<size_t>(boneCount) * TrackTypeCount);
+	m_ranges.resize(static_cast<size_t>(boneCount) * 2U);
+
+	std::vector<cd::Vec3f> vectorFrames(frameCount);
+	std::vector<cd::Vec3f> decodedVectorFrames(frameCount);
+	std::vector<PackedVector> packedVectorFrames(frameCount);
+	std::vector<cd::Quaternion> rotationFrames(frameCount);
+	std::vector<cd::Quaternion> decodedRotationFrames(frameCount);
+	std::vector<PackedQuaternion> packedRotationFrames(frameCount);
+	std::vector<uint16_t> trackKeyFrames;
+	// Key values are not checked by key reduction, only the frames between them.
+	bool isToleranceExceeded = false;
+	float maxKeyTranslationError = 0.0f;
+	float maxKeyRotationError = 0.0f;
+	float maxKeyScaleError = 0.0f;
+
+	auto lerp = [](const cd::Vec3f& a, const cd::Vec3f& b, float t) { return cd::Vec3f::Lerp(a, b, t); };
+	auto addTrack = [this, &trackKeyFrames](uint32_t boneIndex, TrackType type, uint32_t firstValue)
+	{
+		m_tracks[boneIndex * TrackTypeCount + static_cast<uint32_t>(type)] = Track{ static_cast<uint32_t>(m_keyFrames.size()),
+			firstValue, static_cast<uint32_t>(trackKeyFrames.size()) };
+		m_keyFrames.insert(m_keyFrames.end(), trackKeyFrames.begin(), trackKeyFrames.end());
+	};
+
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		if (!clip.HasTrack(boneIndex))
+		{
+			// Identity transform, one key per track without reading the frames.
+			trackKeyFrames.assign(1U, 0U);
+			const cd::Transform identity = cd::Transform::Identity();
+			for (TrackType type : { TrackType::Translation, TrackType::Scale })
+			{
+				const cd::Vec3f value = TrackType::Scale == type ? identity.GetScale() : identity.GetTranslation();
+				TrackRange& range = m_ranges[boneIndex * 2U + (TrackType::Scale == type ? 1U : 0U)];
+				for (uint32_t axis = 0U; axis < 3U; ++axis)
+				{
+					range.minimum[axis] = value[axis];
+					range.extent[axis] = 0.0f;
+				}
+				addTrack(boneIndex, type, static_cast<uint32_t>(m_vectorKeys.size()));
+				m_vectorKeys.push_back(PackVector(value, range));
+			}
+			addTrack(boneIndex, TrackType::Rotation, static_cast<uint32_t>(m_rotationKeys.size()));
+			m_rotationKeys.push_back(PackQuaternion(identity.GetRotation()));
+			continue;
+		}
+
+		for (TrackType type : { TrackType::Translation, TrackType::Rotation, TrackType::Scale })
+		{
+			if (TrackType::Rotation == type)
+			{
+				for (uint32_t frameIndex = 0U; frameIndex < frameCount; ++frameIndex)
+				{
+					rotationFrames[frameIndex] = clip.GetFrameTransform(frameIndex, boneIndex).GetRotation();
+					packedRotationFrames[frameIndex] = PackQuaternion(rotationFrames[frameIndex]);
+					decodedRotationFrames[frameIndex] = UnpackQuaternion(packedRotationFrames[frameIndex]);
+				}
+
+				ReduceKeys(rotationFrames, decodedRotationFrames, settings.rotationTolerance, NLerp, RotationError, trackKeyFrames);
+				addTrack(boneIndex, type, static_cast<uint32_t>(m_rotationKeys.size()));
+				for (uint16_t keyFrame : trackKeyFrames)
+				{
+					m_rotationKeys.push_back(packedRotationFrames[keyFrame]);
+					const float keyError = RotationError(decodedRotationFrames[keyFrame], rotationFrames[keyFrame]);
+					maxKeyRotationError = std::max(maxKeyRotationError, keyError);
+					isToleranceExceeded = isToleranceExceeded || keyError > settings.rotationTolerance;
+				}
+				continue;
+			}
+
+			TrackRange& range = m_ranges[boneIndex * 2U + (TrackType::Scale == type ? 1U : 0U)];
+			cd::Vec3f maximum;
+			for (uint32_t frameIndex = 0U; frameIndex < frameCount; ++frameIndex)
+			{
+				const cd::Transform& transform = clip.GetFrameTransform(frameIndex, boneIndex);
+				const cd::Vec3f& value = TrackType::Scale == type ? transform.GetScale() : transform.GetTranslation();
+				vectorFrames[frameIndex] = value;
+				for (uint32_t axis = 0U; axis < 3U; ++axis)
+				{
+					range.minimum[axis] = 0U == frameIndex ? value[axis] : std::min(range.minimum[axis], value[axis]);
+					maximum[axis] = 0U == frameIndex ? value[axis] : std::max(maximum[axis], value[axis]);
+				}
+			}
+
+			for (uint32_t axis = 0U; axis < 3U; ++axis)
+			{
+				range.extent[axis] = maximum[axis] - range.minimum[axis];
+			}
+
+			for (uint32_t frameIndex = 0U; frameIndex < frameCount; ++frameIndex)
+			{
+				packedVectorFrames[frameIndex] = PackVector(vectorFrames[frameIndex], range);
+				decodedVectorFrames[frameIndex] = UnpackVector(packedVectorFrames[frameIndex], range);
+			}
+
+			const float tolerance = TrackType::Scale == type ? settings.scaleTolerance : settings.translationTolerance;
+			ReduceKeys(vectorFrames, decodedVectorFrames, tolerance, lerp, VectorError, trackKeyFrames);
+			addTrack(boneIndex, type, static_cast<uint32_t>(m_vectorKeys.size()));
+			float& maxKeyError = TrackType::Scale == type ? maxKeyScaleError : maxKeyTranslationError;
+			for (uint16_t keyFrame : trackKeyFrames)
+			{
+				m_vectorKeys.push_back(packedVectorFrames[keyFrame]);
+				const float keyError = VectorError(decodedVectorFrames[keyFrame], vectorFrames[keyFrame]);
+				maxKeyError = std::max(maxKeyError, keyError);
+				isToleranceExceeded = isToleranceExceeded || keyError > tolerance;
+			}
+		}
+	}
+
+	if (isToleranceExceeded)
+	{
+		CD_ENGINE_WARN("Quantized keys of animation clip {0} exceed the tolerances : translation {1}, rotation {2}, scale {3}.",
+			clip.GetName(), maxKeyTranslationError, maxKeyRotationError, maxKeyScaleError);
+	}
+
+	m_keyFrames.shrink_to_fit();
+	m_vectorKeys.shrink_to_fit();
+	m_rotationKeys.shrink_to_fit();
+
+	// Not empty until all tracks are built because the clip stops exposing its frames then.
+	m_boneCount = boneCount;
+	m_frameCount = frameCount;
+	return true;
+}
+
+void CompressedAnimationClip::Clear()
+{
+	m_boneCount = 0U;
+	m_frameCount = 0U;
+	m_tracks.clear();
+	m_ranges.clear();
+	m_keyFrames.clear();
+	m_vectorKeys.clear();
+	m_rotationKeys.clear();
+}
+
+void CompressedAnimationClip::SamplePose(float framePosition, cd::Transform* pPose, AnimationSampleCursor* pCursor) const
+{
+	for (uint32_t boneIndex = 0U; boneIndex < m_boneCount; ++boneIndex)
+	{
+		pPose[boneIndex] = SampleBone(boneIndex, framePosition, pCursor);
+	}
+}
+
+void CompressedAnimationClip::SamplePose(float framePosition, SoaPose& pose, AnimationSampleCursor* pCursor) const
+{
+	assert(pose.GetBoneCount() == m_boneCount);
+	for (uint32_t boneIndex = 0U; boneIndex < m_boneCount; ++boneIndex)
+	{
+		pose.SetTransform(boneIndex, SampleBone(boneIndex, framePosition, pCursor));
+	}
+}
+
+cd::Transform CompressedAnimationClip::SampleBone(uint32_t boneIndex, float framePosition, AnimationSampleCursor* pCursor) const
+{
+	assert(boneIndex < m_boneCount);
+	return cd::Transform(SampleVector(boneIndex, TrackType::Translation, framePosition, pCursor),
+		SampleRotation(boneIndex, framePosition, pCursor),
+		SampleVector(boneIndex, TrackType::Scale, framePosition, pCursor));
+}
+
+size_t CompressedAnimationClip::GetMemorySize() const
+{
+	return m_tracks.size() * sizeof(Track) + m_ranges.size() * sizeof(TrackRange) + m_keyFrames.size() * sizeof(uint16_t) +
+		m_vectorKeys.size() * sizeof(PackedVector) + m_rotationKeys.size() * sizeof(PackedQuaternion);
+}
+
+uint32_t CompressedAnimationClip::FindKey(const Track& track, float framePosition, float& alpha, uint32_t* pCachedKey) const
+{
+	alpha = 0.0f;
+	if (track.keyCount < 2U)
+	{
+		return 0U;
+	}
+
+	// Last key at or before framePosition. The last key is excluded so that the result always has a next key.
+	const uint16_t* pKeyFrames = m_keyFrames.data() + track.firstKey;
+	const uint32_t lastKeyIndex = track.keyCount - 2U;
+	uint32_t keyIndex;
+	if (pCachedKey && *pCachedKey <= lastKeyIndex && static_cast<float>(pKeyFrames[*pCachedKey]) <= framePosition)
+	{
+		// Forward playback only passes a few keys since the last sample.
+		keyIndex = *pCachedKey;
+		while (keyIndex < lastKeyIndex && static_cast<float>(pKeyFrames[keyIndex + 1U]) <= framePosition)
+		{
+			++keyIndex;
+		}
+	}
+	else
+	{
+		const uint16_t* pKeyFrame = std::upper_bound(pKeyFrames + 1U, pKeyFrames + track.keyCount - 1U, framePosition,
+			[](float position, uint16_t keyFrame) { return position < static_cast<float>(keyFrame); }) - 1;
+		keyIndex = static_cast<uint32_t>(pKeyFrame - pKeyFrames);
+	}
+
+	if (pCachedKey)
+	{
+		*pCachedKey = keyIndex;
+	}
+
+	const float currentFrame = static_cast<float>(pKeyFrames[keyIndex]);
+	const float nextFrame = static_cast<float>(pKeyFrames[keyIndex + 1U]);
+	alpha = std::clamp((framePosition - currentFrame) / (nextFrame - currentFrame), 0.0f, 1.0f);
+	return keyIndex;
+}
+
+uint32_t* CompressedAnimationClip::GetCachedKey(AnimationSampleCursor* pCursor, uint32_t boneIndex, TrackType type) const
+{
+	if (!pCursor)
+	{
+		return nullptr;
+	}
+
+	// Sized on first use with this clip. Keys of another clip with the same track count are validated in FindKey.
+	if (pCursor->m_keyIndices.size() != m_tracks.size())
+	{
+		pCursor->m_keyIndices.assign(m_tracks.size(), 0U);
+	}
+	return &pCursor->m_keyIndices[boneIndex * TrackTypeCount + static_cast<uint32_t>(type)];
+}
+
+cd::Vec3f CompressedAnimationClip::SampleVector(uint32_t boneIndex, TrackType type, float framePosition, AnimationSampleCursor* pCursor) const
+{
+	const Track& track = GetTrack(boneIndex, type);
+	const TrackRange& range = GetRange(boneIndex, type);
+	float alpha;
+	const uint32_t valueIndex = track.firstValue + FindKey(track, framePosition, alpha, GetCachedKey(pCursor, boneIndex, type));
+	const cd::Vec3f current = UnpackVector(m_vectorKeys[valueIndex], range);
+	if (track.keyCount < 2U)
+	{
+		return current;
+	}
+
+	return cd::Vec3f::Lerp(current, UnpackVector(m_vectorKeys[valueIndex + 1U], range), alpha);
+}
+
+cd::Quaternion CompressedAnimationClip::SampleRotation(uint32_t boneIndex, float framePosition, AnimationSampleCursor* pCursor) const
+{
+	const Track& track = GetTrack(boneIndex, TrackType::Rotation);
+	float alpha;
+	const uint32_t valueIndex = track.firstValue + FindKey(track, framePosition, alpha, GetCachedKey(pCursor, boneIndex, TrackType::Rotation));
+	const cd::Quaternion current = UnpackQuaternion(m_rotationKeys[valueIndex]);
+	if (track.keyCount < 2U)
+	{
+		return current;
+	}
+
+	return NLerp(current, UnpackQuaternion(m_rotationKeys[valueIndex + 1U]), alpha);
+}
+
+CompressedAnimationClip::PackedQuaternion CompressedAnimationClip::PackQuaternion(const cd::Quaternion& rotation)
+{
+	const float components[4] = { rotation.x(), rotation.y(), rotation.z(), rotation.w() };
+	uint32_t largestIndex = 0U;
+	for (uint32_t componentIndex = 1U; componentIndex < 4U; ++componentIndex)
+	{
+		if (std::abs(components[componentIndex]) > std::abs(components[largestIndex]))
+		{
+			largestIndex = componentIndex;
+		}
+	}
+
+	// Flip to the hemisphere where the largest component is positive so that it can be rebuilt from the others.
+	const float sign = components[largestIndex] < 0.0f ? -1.0f : 1.0f;
+	PackedQuaternion packedRotation;
+	uint32_t packedIndex = 0U;
+	for (uint32_t componentIndex = 0U; componentIndex < 4U; ++componentIndex)
+	{
+		if (componentIndex != largestIndex)
+		{
+			const float normalized = std::clamp(components[componentIndex] * sign / SmallestComponentRange * 0.5f + 0.5f, 0.0f, 1.0f);
+			packedRotation.data[packedIndex++] = static_cast<uint16_t>(std::lround(normalized * QuantizedComponentScale));
+		}
+	}
+
+	packedRotation.data[0] |= static_cast<uint16_t>((largestIndex & 1U) << 15U);
+	packedRotation.data[1] |= static_cast<uint16_t>((largestIndex >> 1U) << 15U);
+	return packedRotation;
+}
+
+cd::Quaternion CompressedAnimationClip::UnpackQuaternion(const PackedQuaternion& packedRotation)
+{
+	const uint32_t largestIndex = (packedRotation.data[0] >> 15U) | ((packedRotation.data[1] >> 15U) << 1U);
+	float components[4];
+	float sumOfSquares = 0.0f;
+	uint32_t packedIndex = 0U;
+	for (uint32_t componentIndex = 0U; componentIndex < 4U; ++componentIndex)
+	{
+		if (componentIndex != largestIndex)
+		{
+			const float normalized = static_cast<float>(packedRotation.data[packedIndex++] & QuantizedComponentMask) / QuantizedComponentScale;
+			components[componentIndex] = (normalized * 2.0f - 1.0f) * SmallestComponentRange;
+			sumOfSquares += components[componentIndex] * components[componentIndex];
+		}
+	}
+
+	components[largestIndex] = std::sqrt(std::max(1.0f - sumOfSquares, 0.0f));
+	return MakeQuaternion(components[0], components[1], components[2], components[3]);
+}
+
+CompressedAnimationClip::PackedVector CompressedAnimationClip::PackVector(const cd::Vec3f& value, const TrackRange& range)
+{
+	PackedVector packedValue;
+	for (uint32_t axis = 0U; axis < 3U; ++axis)
+	{
+		const float normalized = range.extent[axis] > 0.0f ? std::clamp((value[axis] - range.minimum[axis]) / range.extent[axis], 0.0f, 1.0f) : 0.0f;
+		packedValue.data[axis] = static_cast<uint16_t>(std::lround(normalized * QuantizedVectorScale));
+	}
+
+	return packedValue;
+}
+
+cd::Vec3f CompressedAnimationClip::UnpackVector(const PackedVector& packedValue, const TrackRange& range)
+{
+	return cd::Vec3f(range.minimum[0] + static_cast<float>(packedValue.data[0]) / QuantizedVectorScale * range.extent[0],
+		range.minimum[1] + static_cast<float>(packedValue.data[1]) / QuantizedVectorScale * range.extent[1],
+		range.minimum[2] + static_cast<float>(packedValue.data[2]) / QuantizedVectorScale * range.extent[2]);
+}
+
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "Math/Transform.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+
+class AnimationClipData;
+class CompressedAnimationClip;
+class SoaPose;
+
+// Max errors of resampled frames between two keys after key reduction. Key values themselves carry the quantization
+// error which is up to extent / 131070 per translation or scale component of a track and below 0.0001 radians per rotation.
+// Tracks with a range above about 65 units can exceed a translation tolerance of 0.0005 on their keys, Compress warns then.
+struct AnimationCompressionSettings
+{
+	float translationTolerance = 0.0005f;
+	// In radians.
+	float rotationTolerance = 0.0005f;
+	float scaleTolerance = 0.0005f;
+};
+
+// Keys which the last samples of one player used, one per track of a CompressedAnimationClip.
+// Forward playback moves by a key or two per sample instead of searching all keys of every track.
+// Keys are validated before use so a cursor which was used with another clip or a later time is still correct, only slower.
+class AnimationSampleCursor final
+{
+public:
+	AnimationSampleCursor() = default;
+	AnimationSampleCursor(const AnimationSampleCursor&) = default;
+	AnimationSampleCursor& operator=(const AnimationSampleCursor&) = default;
+	AnimationSampleCursor(AnimationSampleCursor&&) = default;
+	AnimationSampleCursor& operator=(AnimationSampleCursor&&) = default;
+	~AnimationSampleCursor() = default;
+
+	void Reset() { m_keyIndices.clear(); }
+
+private:
+	friend class CompressedAnimationClip;
+
+	std::vector<uint32_t> m_keyIndices;
+};
+
+// CompressedAnimationClip stores the frames of an AnimationClipData in a compact form:
+// - Frames which linear interpolation of their neighbour keys reproduces within the tolerance are removed.
+// - Rotations keep the three smallest components in 15 bits each, 48 bits per key.
+// - Translations and scales are 16 bits per component inside the range of their track.
+// Keys of a track are contiguous and tracks are in bone order so sampling a pose streams through memory once.
+// Segments between two keys are at most MaxSegmentFrameCount frames long so that compression is linear in frames.
+class CompressedAnimationClip final
+{
+public:
+	static constexpr uint32_t MaxSegmentFrameCount = 128U;
+
+public:
+	CompressedAnimationClip() = default;
+	CompressedAnimationClip(const CompressedAnimationClip&) = delete;
+	CompressedAnimationClip& operator=(const CompressedAnimationClip&) = delete;
+	CompressedAnimationClip(CompressedAnimationClip&&) = default;
+	CompressedAnimationClip& operator=(CompressedAnimationClip&&) = default;
+	~CompressedAnimationClip() = default;
+
+	// Compresses frames of an uncompressed clip. Returns false if the clip has too many frames for 16 bit frame indices.
+	bool Compress(const AnimationClipData& clip, const AnimationCompressionSettings& settings = AnimationCompressionSettings());
+	void Clear();
+
+	// framePosition is in frames of the source clip, from 0 to GetFrameCount() - 1.
+	// A cursor which is used for consecutive samples of one player turns the key search into a step to the next keys.
+	void SamplePose(float framePosition, cd::Transform* pPose, AnimationSampleCursor* pCursor = nullptr) const;
+	void SamplePose(float framePosition, SoaPose& pose, AnimationSampleCursor* pCursor = nullptr) const;
+	cd::Transform SampleBone(uint32_t boneIndex, float framePosition, AnimationSampleCursor* pCursor = nullptr) const;
+
+	bool IsEmpty() const { return 0U == m_boneCount; }
+	uint32_t GetBoneCount() const { return m_boneCount; }
+	uint32_t GetFrameCount() const { return m_frameCount; }
+	uint32_t GetKeyCount() const { return static_cast<uint32_t>(m_keyFrames.size()); }
+	size_t GetMemorySize() const;
+
+private:
+	enum class TrackType : uint8_t
+	{
+		Translation,
+		Rotation,
+		Scale,
+		Count
+	};
+
+	// firstKey indexes m_keyFrames, firstValue indexes m_vectorKeys or m_rotationKeys.
+	struct Track
+	{
+		uint32_t firstKey;
+		uint32_t firstValue;
+		uint32_t keyCount;
+	};
+
+	// Dequantized value is minimum + quantized / 65535 * extent.
+	struct TrackRange
+	{
+		float minimum[3];
+		float extent[3];
+	};
+
+	struct PackedVector
+	{
+		uint16_t data[3];
+	};
+
+	// Bit 15 of data[0] and data[1] is the index of the largest component which is dropped.
+	struct PackedQuaternion
+	{
+		uint16_t data[3];
+	};
+
+	static constexpr uint32_t TrackTypeCount = static_cast<uint32_t>(TrackType::Count);
+
+	const Track& GetTrack(uint32_t boneIndex, TrackType type) const { return m_tracks[boneIndex * TrackTypeCount + static_cast<uint32_t>(type)]; }
+	const TrackRange& GetRange(uint32_t boneIndex, TrackType type) const { return m_ranges[boneIndex * 2U + (TrackType::Scale == type ? 1U : 0U)]; }
+
+	// Returns the first key of the segment which contains framePosition and the interpolation alpha inside it.
+	// pCachedKey is the result of the last search on this track. It is only a hint and updated to the new result.
+	uint32_t FindKey(const Track& track, float framePosition, float& alpha, uint32_t* pCachedKey) const;
+	cd::Vec3f SampleVector(uint32_t boneIndex, TrackType type, float framePosition, AnimationSampleCursor* pCursor) const;
+	cd::Quaternion SampleRotation(uint32_t boneIndex, float framePosition, AnimationSampleCursor* pCursor) const;
+	uint32_t* GetCachedKey(AnimationSampleCursor* pCursor, uint32_t boneIndex, TrackType type) const;
+
+	static PackedQuaternion PackQuaternion(const cd::Quaternion& rotation);
+	static cd::Quaternion UnpackQuaternion(const PackedQuaternion& packedRotation);
+	static PackedVector PackVector(const cd::Vec3f& value, const TrackRange& range);
+	static cd::Vec3f UnpackVector(const PackedVector& packedValue, const TrackRange& range);
+
+private:
+	uint32_t m_boneCount = 0U;
+	uint32_t m_frameCount = 0U;
+
+	// TrackTypeCount tracks per bone.
+	std::vector<Track> m_tracks;
+	// Translation and scale ranges per bone.
+	std::vector<TrackRange> m_ranges;
+	// Source frame of every key of all tracks.
+	std::vector<uint16_t> m_keyFrames;
+	std::vector<PackedVector> m_vectorKeys;
+	std::vector<PackedQuaternion> m_rotationKeys;
+};
+
+}
@@ -0,0 +1,295 @@
+#include "PoseEvaluator.h"
+
+#include "Animation/AnimationClipData.h"
+#include "Animation/PoseKernels.h"
+#include "Animation/SoaPose.h"
+#include "Core/Jobs/JobSystem.h"
+#include "ECWorld/AnimationComponent.h"
+#include "ECWorld/CollisionMeshComponent.h"
+#include "ECWorld/SceneWorld.h"
+#include "ECWorld/SkeletonComponent.h"
+#include "ECWorld/TransformComponent.h"
+#include "Profiling/Profile.h"
+#include "Rendering/Resources/SkeletonResource.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+
+namespace engine
+{
+
+namespace
+{
+
+float CustomFMod(float dividend, float divisor)
+{
+	if (divisor == 0.0f)
+	{
+		return 0.0f;
+	}
+
+	int quotient = static_cast<int>(dividend / divisor);
+	float result = dividend - static_cast<float>(quotient) * divisor;
+
+	if (result == 0.0f && dividend != 0.0f)
+	{
+		result = 0.0f;
+	}
+	if ((dividend < 0 && divisor > 0) || (dividend > 0 && divisor < 0))
+	{
+		result = -result;
+	}
+	return result;
+}
+
+bool IsResourceReady(const SkeletonResource* pSkeletonResource)
+{
+	return pSkeletonResource && (ResourceStatus::Ready == pSkeletonResource->GetStatus() ||
+		ResourceStatus::Optimized == pSkeletonResource->GetStatus());
+}
+
+// Bounds come from the collision mesh in bind pose. Entities without it always use the full LOD.
+AnimationLodLevel SelectLodLevel(const SceneWorld* pSceneWorld, Entity entity, const AnimationLodView& lodView, const AnimationLodSettings& lodSettings)
+{
+	const TransformComponent* pTransformComponent = pSceneWorld->GetTransformComponent(entity);
+	const CollisionMeshComponent* pCollisionMeshComponent = pSceneWorld->GetCollisionMeshComponent(entity);
+	if (!pTransformComponent || !pCollisionMeshComponent)
+	{
+		return AnimationLodLevel::Full;
+	}
+
+	cd::AABB aabb = pCollisionMeshComponent->GetAABB();
+	aabb = aabb.Transform(pTransformComponent->GetWorldMatrix());
+	const float radius = (aabb.Max() - aabb.Center()).Length() * lodSettings.boundsScale;
+	if (!std::isfinite(radius) || radius <= 0.0f)
+	{
+		return AnimationLodLevel::Full;
+	}
+
+	const float screenSize = AnimationLod::GetScreenSize(lodView.viewMatrix, lodView.projectionMatrix, aabb.Center(), radius);
+	return AnimationLod::SelectLevel(screenSize, lodSettings, lodView.hasShadowCasters);
+}
+
+}
+
+AnimationLodStats PoseEvaluator::EvaluateAll(SceneWorld* pSceneWorld, const AnimationLodView* pLodView, const AnimationLodSettings& lodSettings)
+{
+	CD_PROFILE_ZONE("EvaluatePoses");
+
+	const std::vector<Entity>& animationEntities = pSceneWorld->GetAnimationEntities();
+	const float interpolationAlpha = pSceneWorld->GetInterpolationAlpha();
+	std::atomic<uint32_t> evaluatedBoneCount = 0U;
+	std::atomic<uint32_t> evaluatedEntityCount = 0U;
+	std::atomic<uint32_t> interpolatedEntityCount = 0U;
+	std::atomic<uint32_t> culledEntityCount = 0U;
+	JobSystem::Get().ParallelFor(static_cast<uint32_t>(animationEntities.size()), 0U,
+		[&](uint32_t begin, uint32_t end)
+	{
+		AnimationLodStats rangeStats;
+		for (uint32_t entityIndex = begin; entityIndex < end; ++entityIndex)
+		{
+			Entity entity = animationEntities[entityIndex];
+			AnimationComponent* pAnimationComponent = pSceneWorld->GetAnimationComponent(entity);
+			SkeletonComponent* pSkeletonComponent = pSceneWorld->GetSkeletonComponent(entity);
+			if (!pAnimationComponent || !pSkeletonComponent)
+			{
+				continue;
+			}
+
+			// Advanced by SceneWorld::FixedUpdate.
+			const float runningTime = pAnimationComponent->GetInterpolatedRunningTime(interpolationAlpha);
+			AnimationLodState& lodState = pSkeletonComponent->GetAnimationLodState();
+			lodState.level = pLodView ? SelectLodLevel(pSceneWorld, entity, *pLodView, lodSettings) : AnimationLodLevel::Full;
+			if (AnimationLodLevel::Culled == lodState.level)
+			{
+				// Resumes from the current time when it becomes visible again.
+				lodState.hasTarget = false;
+				++rangeStats.culledEntityCount;
+				continue;
+			}
+
+			const bool skipLeafBones = AnimationLod::IsLeafBoneSkipped(lodState.level, lodSettings);
+			const uint32_t updateInterval = AnimationLod::GetUpdateInterval(lodState.level, lodSettings);
+			if (updateInterval <= 1U || !pLodView)
+			{
+				lodState.hasTarget = false;
+				const uint32_t boneCount = Evaluate(pAnimationComponent, pSkeletonComponent, runningTime, skipLeafBones);
+				rangeStats.evaluatedBoneCount += boneCount;
+				rangeStats.evaluatedEntityCount += boneCount > 0U ? 1U : 0U;
+				continue;
+			}
+
+			std::vector<cd::Matrix4x4>& skinningMatrices = pSkeletonComponent->GetSkinningMatrices();
+			const bool isTimeInRange = lodState.hasTarget && runningTime >= lodState.sourceTime && runningTime <= lodState.targetTime;
+			if (!isTimeInRange || AnimationLod::IsUpdateFrame(pLodView->frameIndex, entity, updateInterval))
+			{
+				lodState.sourceSkinningMatrices.resize(skinningMatrices.size());
+				lodState.targetSkinningMatrices.resize(skinningMatrices.size());
+				if (isTimeInRange)
+				{
+					// The last target is the pose of about now.
+					std::swap(lodState.sourceSkinningMatrices, lodState.targetSkinningMatrices);
+					lodState.sourceTime = lodState.targetTime;
+				}
+				else
+				{
+					// First update or a time jump, the current pose is evaluated too.
+					const uint32_t boneCount = Evaluate(pAnimationComponent, pSkeletonComponent, runningTime, skipLeafBones);
+					if (0U == boneCount)
+					{
+						continue;
+					}
+					rangeStats.evaluatedBoneCount += boneCount;
+					std::swap(skinningMatrices, lodState.sourceSkinningMatrices);
+					lodState.sourceTime = runningTime;
+				}
+
+				// Evaluated ahead so that frames until the next update interpolate towards it.
+				// Running time advances by the playback speed, see SceneWorld::FixedUpdate.
+				const float playBackSpeed = pAnimationComponent->IsPlaying() ? pAnimationComponent->GetPlayBackSpeed() : 0.0f;
+				const float lookAheadTime = static_cast<float>(updateInterval) * pLodView->deltaTime * std::max(playBackSpeed, 0.0f);
+				lodState.targetTime = std::max(runningTime + lookAheadTime, lodState.sourceTime);
+				const uint32_t boneCount = Evaluate(pAnimationComponent, pSkeletonComponent, lodState.targetTime, skipLeafBones);
+				if (0U == boneCount)
+				{
+					lodState.hasTarget = false;
+					continue;
+				}
+				rangeStats.evaluatedBoneCount += boneCount;
+				++rangeStats.evaluatedEntityCount;
+				std::swap(skinningMatrices, lodState.targetSkinningMatrices);
+				lodState.hasTarget = true;
+			}
+			else
+			{
+				++rangeStats.interpolatedEntityCount;
+			}
+
+			const float timeRange = lodState.targetTime - lodState.sourceTime;
+			const float alpha = timeRange > 0.0f ? std::clamp((runningTime - lodState.sourceTime) / timeRange, 0.0f, 1.0f) : 1.0f;
+			AnimationLod::InterpolateMatrices(lodState.sourceSkinningMatrices.data(), lodState.targetSkinningMatrices.data(), alpha,
+				static_cast<uint32_t>(skinningMatrices.size()), skinningMatrices.data());
+		}
+
+		evaluatedBoneCount.fetch_add(rangeStats.evaluatedBoneCount, std::memory_order_relaxed);
+		evaluatedEntityCount.fetch_add(rangeStats.evaluatedEntityCount, std::memory_order_relaxed);
+		interpolatedEntityCount.fetch_add(rangeStats.interpolatedEntityCount, std::memory_order_relaxed);
+		culledEntityCount.fetch_add(rangeStats.culledEntityCount, std::memory_order_relaxed);
+	});
+
+	AnimationLodStats stats;
+	stats.evaluatedBoneCount = evaluatedBoneCount.load(std::memory_order_relaxed);
+	stats.evaluatedEntityCount = evaluatedEntityCount.load(std::memory_order_relaxed);
+	stats.interpolatedEntityCount = interpolatedEntityCount.load(std::memory_order_relaxed);
+	stats.culledEntityCount = culledEntityCount.load(std::memory_order_relaxed);
+	CD_PROFILE_COUNTER("Animation/EvaluatedBones", stats.evaluatedBoneCount);
+	CD_PROFILE_COUNTER("Animation/EvaluatedCharacters", stats.evaluatedEntityCount);
+	CD_PROFILE_COUNTER("Animation/InterpolatedCharacters", stats.interpolatedEntityCount);
+	CD_PROFILE_COUNTER("Animation/CulledCharacters", stats.culledEntityCount);
+
+	return stats;
+}
+
+uint32_t PoseEvaluator::Evaluate(AnimationComponent* pAnimationComponent, SkeletonComponent* pSkeletonComponent, float runningTime, bool skipLeafBones)
+{
+	const SkeletonResource* pSkeletonResource = pSkeletonComponent->GetSkeletonResource();
+	if (!IsResourceReady(pSkeletonResource))
+	{
+		return 0U;
+	}
+
+	// Clips of one skeleton share the bone order.
+	auto getBoneOrderCount = [skipLeafBones](const AnimationClipData* pClip)
+	{
+		return skipLeafBones ? pClip->GetLodBoneCount() : pClip->GetBoneCount();
+	};
+
+	SoaPose& localPose = pSkeletonComponent->GetLocalPose();
+	const AnimationClipData* pClip = nullptr;
+	uint32_t boneOrderCount = 0U;
+	const AnimationClip animationClip = pAnimationComponent->GetAnimationClip();
+	if (AnimationClip::Idle == animationClip || AnimationClip::Walking == animationClip)
+	{
+		pClip = pSkeletonResource->GetAnimationClip(AnimationClip::Idle == animationClip ? 0U : 1U);
+		if (!pClip)
+		{
+			return 0U;
+		}
+
+		float animationTime = CustomFMod(runningTime, pClip->GetDuration());
+		pAnimationComponent->SetAnimationPlayTime(animationTime);
+		boneOrderCount = getBoneOrderCount(pClip);
+		pClip->SamplePose(animationTime, localPose, boneOrderCount, &pSkeletonComponent->GetLocalSampleCursor());
+	}
+	else if (AnimationClip::Blend == animationClip)
+	{
+		const AnimationClipData* pClipA = pSkeletonResource->GetAnimationClip(0U);
+		const AnimationClipData* pClipB = pSkeletonResource->GetAnimationClip(1U);
+		if (!pClipA || !pClipB)
+		{
+			return 0U;
+		}
+
+		float factor = pAnimationComponent->GetBlendFactor();
+		float clipATime = pClipA->GetDuration();
+		float clipBTime = pClipB->GetDuration();
+		const float blendSpeed = clipATime + (clipBTime - clipATime) * factor;
+		pAnimationComponent->SetPlayBackSpeed(clipATime / blendSpeed);
+
+		// Both clips play at the same progress so that their cycles stay in sync.
+		float clipAProgress = CustomFMod(runningTime, clipATime) / clipATime;
+		SoaPose& blendPose = pSkeletonComponent->GetBlendPose();
+		boneOrderCount = getBoneOrderCount(pClipA);
+		pClipA->SamplePose(clipATime * clipAProgress, localPose, boneOrderCount, &pSkeletonComponent->GetLocalSampleCursor());
+		pClipB->SamplePose(clipBTime * clipAProgress, blendPose, boneOrderCount, &pSkeletonComponent->GetBlendSampleCursor());
+		const SoaPose* poses[] = { &localPose, &blendPose };
+		const float weights[] = { 1.0f - factor, factor };
+		PoseKernels::BlendPoses(poses, weights, 2U, localPose);
+		pClip = pClipA;
+	}
+	else
+	{
+		return 0U;
+	}
+
+	assert(pClip->GetBoneCount() == localPose.GetBoneCount());
+	std::vector<cd::Matrix4x4>& globalMatrices = pSkeletonComponent->GetBoneGlobalMatrices();
+	std::vector<cd::Matrix4x4>& skinningMatrices = pSkeletonComponent->GetSkinningMatrices();
+	PoseKernels::LocalToModel(localPose, *pClip, globalMatrices.data(), boneOrderCount);
+	if (boneOrderCount < pClip->GetBoneCount())
+	{
+		const std::vector<uint32_t>& boneOrder = pClip->GetBoneOrder();
+		const std::vector<cd::Matrix4x4>& boneOffsets = pSkeletonResource->GetBoneOffsets();
+		for (uint32_t orderIndex = 0U; orderIndex < boneOrderCount; ++orderIndex)
+		{
+			const uint32_t boneIndex = boneOrder[orderIndex];
+			skinningMatrices[boneIndex] = globalMatrices[boneIndex] * boneOffsets[boneIndex];
+		}
+
+		// A leaf in bind pose relative to its parent moves its vertices like the parent does.
+		for (uint32_t orderIndex = boneOrderCount; orderIndex < pClip->GetBoneCount(); ++orderIndex)
+		{
+			const uint32_t boneIndex = boneOrder[orderIndex];
+			skinningMatrices[boneIndex] = skinningMatrices[pClip->GetParentIndex(boneIndex)];
+		}
+	}
+	else
+	{
+		BuildSkinningMatrices(globalMatrices.data(), pSkeletonResource->GetBoneOffsets().data(), pClip->GetBoneCount(), skinningMatrices.data());
+	}
+	pSkeletonComponent->SetRootMatrix(globalMatrices[0]);
+
+	return boneOrderCount;
+}
+
+void PoseEvaluator::BuildSkinningMatrices(const cd::Matrix4x4* pGlobalMatrices, const cd::Matrix4x4* pBoneOffsets, uint32_t boneCount, cd::Matrix4x4* pSkinningMatrices)
+{
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		pSkinningMatrices[boneIndex] = pGlobalMatrices[boneIndex] * pBoneOffsets[boneIndex];
+	}
+}
+
+}
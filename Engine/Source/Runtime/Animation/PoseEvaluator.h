@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Animation/AnimationLod.h"
+#include "Math/Transform.hpp"
+
+#include <cstdint>
+
+namespace engine
+{
+
+class AnimationComponent;
+class SceneWorld;
+class SkeletonComponent;
+
+// PoseEvaluator computes bone matrices of animated entities from compiled clips.
+// Every entity only writes to its own AnimationComponent and SkeletonComponent so entities are evaluated in parallel.
+class PoseEvaluator final
+{
+public:
+	PoseEvaluator() = delete;
+
+	// Evaluates all animation entities on JobSystem threads. Blocks until finished.
+	// With a view, entities pick a LOD from their size on screen: they update every few frames and
+	// interpolate in between, skip leaf bones, or are not evaluated at all outside of the view unless they cast shadows.
+	static AnimationLodStats EvaluateAll(SceneWorld* pSceneWorld, const AnimationLodView* pLodView = nullptr,
+		const AnimationLodSettings& lodSettings = AnimationLodSettings());
+
+	// Returns the number of evaluated bones, 0 if the skeleton or its clips are not ready.
+	// Skipped leaf bones keep their bind pose relative to their parents.
+	static uint32_t Evaluate(AnimationComponent* pAnimationComponent, SkeletonComponent* pSkeletonComponent, float runningTime, bool skipLeafBones = false);
+
+	// Global matrices multiplied by bone offsets which are uploaded for skinning.
+	static void BuildSkinningMatrices(const cd::Matrix4x4* pGlobalMatrices, const cd::Matrix4x4* pBoneOffsets, uint32_t boneCount, cd::Matrix4x4* pSkinningMatrices);
+};
+
+}
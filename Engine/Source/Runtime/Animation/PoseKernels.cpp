@@ -0,0 +1,461 @@
+#include "PoseKernels.h"
+
+#include "Animation/AnimationClipData.h"
+#include "Animation/SoaPose.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined(__AVX__)
+#define CD_POSE_KERNELS_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CD_POSE_KERNELS_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define CD_POSE_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace engine
+{
+
+namespace
+{
+
+static_assert(sizeof(cd::Matrix4x4) == 16U * sizeof(float), "Matrices are written as 16 floats.");
+
+constexpr float NormalizeEpsilon = 1e-12f;
+
+struct ScalarOps
+{
+	using Type = float;
+	static constexpr uint32_t Width = 1U;
+
+	static Type Load(const float* pValue) { return *pValue; }
+	static void Store(float* pValue, Type value) { *pValue = value; }
+	static Type Set(float value) { return value; }
+	static Type Add(Type a, Type b) { return a + b; }
+	static Type Sub(Type a, Type b) { return a - b; }
+	static Type Mul(Type a, Type b) { return a * b; }
+	static Type Div(Type a, Type b) { return a / b; }
+	static Type Max(Type a, Type b) { return a > b ? a : b; }
+	static Type Sqrt(Type value) { return std::sqrt(value); }
+	// Negates value if sign is negative.
+	static Type XorSign(Type value, Type sign) { return std::signbit(sign) ? -value : value; }
+};
+
+#if defined(CD_POSE_KERNELS_AVX)
+struct SimdOps
+{
+	using Type = __m256;
+	static constexpr uint32_t Width = 8U;
+
+	static Type Load(const float* pValue) { return _mm256_load_ps(pValue); }
+	static void Store(float* pValue, Type value) { _mm256_store_ps(pValue, value); }
+	static Type Set(float value) { return _mm256_set1_ps(value); }
+	static Type Add(Type a, Type b) { return _mm256_add_ps(a, b); }
+	static Type Sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+	static Type Mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+	static Type Div(Type a, Type b) { return _mm256_div_ps(a, b); }
+	static Type Max(Type a, Type b) { return _mm256_max_ps(a, b); }
+	static Type Sqrt(Type value) { return _mm256_sqrt_ps(value); }
+	static Type XorSign(Type value, Type sign) { return _mm256_xor_ps(value, _mm256_and_ps(sign, _mm256_set1_ps(-0.0f))); }
+};
+#elif defined(CD_POSE_KERNELS_SSE)
+struct SimdOps
+{
+	using Type = __m128;
+	static constexpr uint32_t Width = 4U;
+
+	static Type Load(const float* pValue) { return _mm_load_ps(pValue); }
+	static void Store(float* pValue, Type value) { _mm_store_ps(pValue, value); }
+	static Type Set(float value) { return _mm_set1_ps(value); }
+	static Type Add(Type a, Type b) { return _mm_add_ps(a, b); }
+	static Type Sub(Type a, Type b) { return _mm_sub_ps(a, b); }
+	static Type Mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+	static Type Div(Type a, Type b) { return _mm_div_ps(a, b); }
+	static Type Max(Type a, Type b) { return _mm_max_ps(a, b); }
+	static Type Sqrt(Type value) { return _mm_sqrt_ps(value); }
+	static Type XorSign(Type value, Type sign) { return _mm_xor_ps(value, _mm_and_ps(sign, _mm_set1_ps(-0.0f))); }
+};
+#elif defined(CD_POSE_KERNELS_NEON)
+struct SimdOps
+{
+	using Type = float32x4_t;
+	static constexpr uint32_t Width = 4U;
+
+	static Type Load(const float* pValue) { return vld1q_f32(pValue); }
+	static void Store(float* pValue, Type value) { vst1q_f32(pValue, value); }
+	static Type Set(float value) { return vdupq_n_f32(value); }
+	static Type Add(Type a, Type b) { return vaddq_f32(a, b); }
+	static Type Sub(Type a, Type b) { return vsubq_f32(a, b); }
+	static Type Mul(Type a, Type b) { return vmulq_f32(a, b); }
+	static Type Div(Type a, Type b) { return vdivq_f32(a, b); }
+	static Type Max(Type a, Type b) { return vmaxq_f32(a, b); }
+	static Type Sqrt(Type value) { return vsqrtq_f32(value); }
+	static Type XorSign(Type value, Type sign)
+	{
+		const uint32x4_t signBits = vandq_u32(vreinterpretq_u32_f32(sign), vdupq_n_u32(0x80000000U));
+		return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(value), signBits));
+	}
+};
+#else
+using SimdOps = ScalarOps;
+#endif
+
+static_assert(SoaPose::LaneCount % SimdOps::Width == 0U, "Pose padding should cover a whole SIMD register.");
+
+template<typename Ops>
+struct QuaternionLanes
+{
+	typename Ops::Type x;
+	typename Ops::Type y;
+	typename Ops::Type z;
+	typename Ops::Type w;
+};
+
+template<typename Ops>
+QuaternionLanes<Ops> LoadRotations(const SoaPose& pose, uint32_t boneIndex)
+{
+	return QuaternionLanes<Ops>{ Ops::Load(pose.GetStream(PoseStream::RotationX) + boneIndex),
+		Ops::Load(pose.GetStream(PoseStream::RotationY) + boneIndex),
+		Ops::Load(pose.GetStream(PoseStream::RotationZ) + boneIndex),
+		Ops::Load(pose.GetStream(PoseStream::RotationW) + boneIndex) };
+}
+
+template<typename Ops>
+void StoreRotations(SoaPose& pose, uint32_t boneIndex, const QuaternionLanes<Ops>& rotation)
+{
+	Ops::Store(pose.GetStream(PoseStream::RotationX) + boneIndex, rotation.x);
+	Ops::Store(pose.GetStream(PoseStream::RotationY) + boneIndex, rotation.y);
+	Ops::Store(pose.GetStream(PoseStream::RotationZ) + boneIndex, rotation.z);
+	Ops::Store(pose.GetStream(PoseStream::RotationW) + boneIndex, rotation.w);
+}
+
+template<typename Ops>
+typename Ops::Type Dot(const QuaternionLanes<Ops>& a, const QuaternionLanes<Ops>& b)
+{
+	return Ops::Add(Ops::Add(Ops::Mul(a.x, b.x), Ops::Mul(a.y, b.y)), Ops::Add(Ops::Mul(a.z, b.z), Ops::Mul(a.w, b.w)));
+}
+
+template<typename Ops>
+QuaternionLanes<Ops> Normalize(const QuaternionLanes<Ops>& rotation)
+{
+	const typename Ops::Type length = Ops::Sqrt(Ops::Max(Dot(rotation, rotation), Ops::Set(NormalizeEpsilon)));
+	return QuaternionLanes<Ops>{ Ops::Div(rotation.x, length), Ops::Div(rotation.y, length),
+		Ops::Div(rotation.z, length), Ops::Div(rotation.w, length) };
+}
+
+template<typename Ops>
+QuaternionLanes<Ops> Multiply(const QuaternionLanes<Ops>& a, const QuaternionLanes<Ops>& b)
+{
+	using Type = typename Ops::Type;
+	const Type x = Ops::Add(Ops::Add(Ops::Mul(a.w, b.x), Ops::Mul(a.x, b.w)), Ops::Sub(Ops::Mul(a.y, b.z), Ops::Mul(a.z, b.y)));
+	const Type y = Ops::Add(Ops::Sub(Ops::Mul(a.w, b.y), Ops::Mul(a.x, b.z)), Ops::Add(Ops::Mul(a.y, b.w), Ops::Mul(a.z, b.x)));
+	const Type z = Ops::Add(Ops::Add(Ops::Mul(a.w, b.z), Ops::Mul(a.x, b.y)), Ops::Sub(Ops::Mul(a.z, b.w), Ops::Mul(a.y, b.x)));
+	const Type w = Ops::Sub(Ops::Sub(Ops::Mul(a.w, b.w), Ops::Mul(a.x, b.x)), Ops::Add(Ops::Mul(a.y, b.y), Ops::Mul(a.z, b.z)));
+	return QuaternionLanes<Ops>{ x, y, z, w };
+}
+
+constexpr PoseStream VectorStreams[] = {
+	PoseStream::TranslationX, PoseStream::TranslationY, PoseStream::TranslationZ,
+	PoseStream::ScaleX, PoseStream::ScaleY, PoseStream::ScaleZ,
+};
+
+template<typename Ops>
+void BlendPosesImpl(const SoaPose* const* ppPoses, const float* pWeights, uint32_t poseCount, SoaPose& outPose)
+{
+	assert(poseCount > 0U);
+	const SoaPose& firstPose = *ppPoses[0];
+	for (uint32_t poseIndex = 0U; poseIndex < poseCount; ++poseIndex)
+	{
+		assert(ppPoses[poseIndex]->GetBoneCount() == outPose.GetBoneCount());
+	}
+
+	// All inputs of a register are loaded before the output is stored so outPose can alias an input.
+	const uint32_t paddedBoneCount = outPose.GetPaddedBoneCount();
+	for (uint32_t boneIndex = 0U; boneIndex < paddedBoneCount; boneIndex += Ops::Width)
+	{
+		for (PoseStream stream : VectorStreams)
+		{
+			typename Ops::Type sum = Ops::Mul(Ops::Load(firstPose.GetStream(stream) + boneIndex), Ops::Set(pWeights[0]));
+			for (uint32_t poseIndex = 1U; poseIndex < poseCount; ++poseIndex)
+			{
+				const typename Ops::Type value = Ops::Load(ppPoses[poseIndex]->GetStream(stream) + boneIndex);
+				sum = Ops::Add(sum, Ops::Mul(value, Ops::Set(pWeights[poseIndex])));
+			}
+			Ops::Store(outPose.GetStream(stream) + boneIndex, sum);
+		}
+
+		const QuaternionLanes<Ops> firstRotation = LoadRotations<Ops>(firstPose, boneIndex);
+		const typename Ops::Type firstWeight = Ops::Set(pWeights[0]);
+		QuaternionLanes<Ops> sum{ Ops::Mul(firstRotation.x, firstWeight), Ops::Mul(firstRotation.y, firstWeight),
+			Ops::Mul(firstRotation.z, firstWeight), Ops::Mul(firstRotation.w, firstWeight) };
+		for (uint32_t poseIndex = 1U; poseIndex < poseCount; ++poseIndex)
+		{
+			// q and -q are the same rotation. Take the one closer to the first pose so the sum doesn't cancel out.
+			const QuaternionLanes<Ops> rotation = LoadRotations<Ops>(*ppPoses[poseIndex], boneIndex);
+			const typename Ops::Type sign = Dot(firstRotation, rotation);
+			const typename Ops::Type weight = Ops::XorSign(Ops::Set(pWeights[poseIndex]), sign);
+			sum.x = Ops::Add(sum.x, Ops::Mul(rotation.x, weight));
+			sum.y = Ops::Add(sum.y, Ops::Mul(rotation.y, weight));
+			sum.z = Ops::Add(sum.z, Ops::Mul(rotation.z, weight));
+			sum.w = Ops::Add(sum.w, Ops::Mul(rotation.w, weight));
+		}
+		StoreRotations(outPose, boneIndex, Normalize(sum));
+	}
+}
+
+template<typename Ops>
+void AddLayerImpl(SoaPose& pose, const SoaPose& additivePose, float weight)
+{
+	assert(pose.GetBoneCount() == additivePose.GetBoneCount());
+
+	using Type = typename Ops::Type;
+	const Type layerWeight = Ops::Set(weight);
+	const Type baseWeight = Ops::Set(1.0f - weight);
+	const uint32_t paddedBoneCount = pose.GetPaddedBoneCount();
+	for (uint32_t boneIndex = 0U; boneIndex < paddedBoneCount; boneIndex += Ops::Width)
+	{
+		for (PoseStream stream : { PoseStream::TranslationX, PoseStream::TranslationY, PoseStream::TranslationZ })
+		{
+			float* pValues = pose.GetStream(stream) + boneIndex;
+			const Type delta = Ops::Load(additivePose.GetStream(stream) + boneIndex);
+			Ops::Store(pValues, Ops::Add(Ops::Load(pValues), Ops::Mul(delta, layerWeight)));
+		}
+
+		for (PoseStream stream : { PoseStream::ScaleX, PoseStream::ScaleY, PoseStream::ScaleZ })
+		{
+			float* pValues = pose.GetStream(stream) + boneIndex;
+			const Type delta = Ops::Load(additivePose.GetStream(stream) + boneIndex);
+			Ops::Store(pValues, Ops::Mul(Ops::Load(pValues), Ops::Add(baseWeight, Ops::Mul(delta, layerWeight))));
+		}
+
+		// Lerp from identity on the hemisphere of identity, then normalize.
+		const QuaternionLanes<Ops> delta = LoadRotations<Ops>(additivePose, boneIndex);
+		const Type weightedDelta = Ops::XorSign(layerWeight, delta.w);
+		const QuaternionLanes<Ops> weightedRotation = Normalize(QuaternionLanes<Ops>{ Ops::Mul(delta.x, weightedDelta),
+			Ops::Mul(delta.y, weightedDelta), Ops::Mul(delta.z, weightedDelta), Ops::Add(baseWeight, Ops::Mul(delta.w, weightedDelta)) });
+		StoreRotations(pose, boneIndex, Multiply(LoadRotations<Ops>(pose, boneIndex), weightedRotation));
+	}
+}
+
+#if defined(CD_POSE_KERNELS_AVX) || defined(CD_POSE_KERNELS_SSE)
+// Column major 4x4 product, pOut can be pB.
+void MultiplyMatrix(const float* pA, const float* pB, float* pOut)
+{
+	const __m128 column0 = _mm_loadu_ps(pA);
+	const __m128 column1 = _mm_loadu_ps(pA + 4);
+	const __m128 column2 = _mm_loadu_ps(pA + 8);
+	const __m128 column3 = _mm_loadu_ps(pA + 12);
+	for (uint32_t columnIndex = 0U; columnIndex < 4U; ++columnIndex)
+	{
+		const float* pColumn = pB + columnIndex * 4U;
+		__m128 result = _mm_mul_ps(column0, _mm_set1_ps(pColumn[0]));
+		result = _mm_add_ps(result, _mm_mul_ps(column1, _mm_set1_ps(pColumn[1])));
+		result = _mm_add_ps(result, _mm_mul_ps(column2, _mm_set1_ps(pColumn[2])));
+		result = _mm_add_ps(result, _mm_mul_ps(column3, _mm_set1_ps(pColumn[3])));
+		_mm_storeu_ps(pOut + columnIndex * 4U, result);
+	}
+}
+#elif defined(CD_POSE_KERNELS_NEON)
+void MultiplyMatrix(const float* pA, const float* pB, float* pOut)
+{
+	const float32x4_t column0 = vld1q_f32(pA);
+	const float32x4_t column1 = vld1q_f32(pA + 4);
+	const float32x4_t column2 = vld1q_f32(pA + 8);
+	const float32x4_t column3 = vld1q_f32(pA + 12);
+	for (uint32_t columnIndex = 0U; columnIndex < 4U; ++columnIndex)
+	{
+		const float32x4_t column = vld1q_f32(pB + columnIndex * 4U);
+		float32x4_t result = vmulq_laneq_f32(column0, column, 0);
+		result = vfmaq_laneq_f32(result, column1, column, 1);
+		result = vfmaq_laneq_f32(result, column2, column, 2);
+		result = vfmaq_laneq_f32(result, column3, column, 3);
+		vst1q_f32(pOut + columnIndex * 4U, result);
+	}
+}
+#else
+void MultiplyMatrix(const float* pA, const float* pB, float* pOut)
+{
+	float result[16];
+	for (uint32_t columnIndex = 0U; columnIndex < 4U; ++columnIndex)
+	{
+		for (uint32_t rowIndex = 0U; rowIndex < 4U; ++rowIndex)
+		{
+			result[columnIndex * 4U + rowIndex] = pA[rowIndex] * pB[columnIndex * 4U] + pA[4U + rowIndex] * pB[columnIndex * 4U + 1U] +
+				pA[8U + rowIndex] * pB[columnIndex * 4U + 2U] + pA[12U + rowIndex] * pB[columnIndex * 4U + 3U];
+		}
+	}
+
+	for (uint32_t index = 0U; index < 16U; ++index)
+	{
+		pOut[index] = result[index];
+	}
+}
+#endif
+
+// Writes T * R * S of every bone in the same column major layout as cd::Transform::GetMatrix.
+template<typename Ops>
+void BuildLocalMatrices(const SoaPose& localPose, float* pMatrices)
+{
+	using Type = typename Ops::Type;
+	constexpr uint32_t ElementCount = 12U;
+	alignas(SoaPose::Alignment) float elements[ElementCount][Ops::Width];
+
+	const Type one = Ops::Set(1.0f);
+	const Type two = Ops::Set(2.0f);
+	const uint32_t boneCount = localPose.GetBoneCount();
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; boneIndex += Ops::Width)
+	{
+		const QuaternionLanes<Ops> rotation = LoadRotations<Ops>(localPose, boneIndex);
+		const Type scaleX = Ops::Load(localPose.GetStream(PoseStream::ScaleX) + boneIndex);
+		const Type scaleY = Ops::Load(localPose.GetStream(PoseStream::ScaleY) + boneIndex);
+		const Type scaleZ = Ops::Load(localPose.GetStream(PoseStream::ScaleZ) + boneIndex);
+
+		const Type xx = Ops::Mul(rotation.x, rotation.x);
+		const Type yy = Ops::Mul(rotation.y, rotation.y);
+		const Type zz = Ops::Mul(rotation.z, rotation.z);
+		const Type xy = Ops::Mul(rotation.x, rotation.y);
+		const Type xz = Ops::Mul(rotation.x, rotation.z);
+		const Type yz = Ops::Mul(rotation.y, rotation.z);
+		const Type wx = Ops::Mul(rotation.w, rotation.x);
+		const Type wy = Ops::Mul(rotation.w, rotation.y);
+		const Type wz = Ops::Mul(rotation.w, rotation.z);
+
+		Ops::Store(elements[0], Ops::Mul(Ops::Sub(one, Ops::Mul(two, Ops::Add(yy, zz))), scaleX));
+		Ops::Store(elements[1], Ops::Mul(Ops::Mul(two, Ops::Add(xy, wz)), scaleX));
+		Ops::Store(elements[2], Ops::Mul(Ops::Mul(two, Ops::Sub(xz, wy)), scaleX));
+		Ops::Store(elements[3], Ops::Mul(Ops::Mul(two, Ops::Sub(xy, wz)), scaleY));
+		Ops::Store(elements[4], Ops::Mul(Ops::Sub(one, Ops::Mul(two, Ops::Add(xx, zz))), scaleY));
+		Ops::Store(elements[5], Ops::Mul(Ops::Mul(two, Ops::Add(yz, wx)), scaleY));
+		Ops::Store(elements[6], Ops::Mul(Ops::Mul(two, Ops::Add(xz, wy)), scaleZ));
+		Ops::Store(elements[7], Ops::Mul(Ops::Mul(two, Ops::Sub(yz, wx)), scaleZ));
+		Ops::Store(elements[8], Ops::Mul(Ops::Sub(one, Ops::Mul(two, Ops::Add(xx, yy))), scaleZ));
+		Ops::Store(elements[9], Ops::Load(localPose.GetStream(PoseStream::TranslationX) + boneIndex));
+		Ops::Store(elements[10], Ops::Load(localPose.GetStream(PoseStream::TranslationY) + boneIndex));
+		Ops::Store(elements[11], Ops::Load(localPose.GetStream(PoseStream::TranslationZ) + boneIndex));
+
+		const uint32_t laneCount = boneCount - boneIndex < Ops::Width ? boneCount - boneIndex : Ops::Width;
+		for (uint32_t laneIndex = 0U; laneIndex < laneCount; ++laneIndex)
+		{
+			float* pMatrix = pMatrices + (boneIndex + laneIndex) * 16U;
+			pMatrix[0] = elements[0][laneIndex];
+			pMatrix[1] = elements[1][laneIndex];
+			pMatrix[2] = elements[2][laneIndex];
+			pMatrix[3] = 0.0f;
+			pMatrix[4] = elements[3][laneIndex];
+			pMatrix[5] = elements[4][laneIndex];
+			pMatrix[6] = elements[5][laneIndex];
+			pMatrix[7] = 0.0f;
+			pMatrix[8] = elements[6][laneIndex];
+			pMatrix[9] = elements[7][laneIndex];
+			pMatrix[10] = elements[8][laneIndex];
+			pMatrix[11] = 0.0f;
+			pMatrix[12] = elements[9][laneIndex];
+			pMatrix[13] = elements[10][laneIndex];
+			pMatrix[14] = elements[11][laneIndex];
+			pMatrix[15] = 1.0f;
+		}
+	}
+}
+
+}
+
+const char* PoseKernels::GetInstructionSetName()
+{
+#if defined(CD_POSE_KERNELS_AVX)
+	return "AVX";
+#elif defined(CD_POSE_KERNELS_SSE)
+	return "SSE2";
+#elif defined(CD_POSE_KERNELS_NEON)
+	return "NEON";
+#else
+	return "Scalar";
+#endif
+}
+
+void PoseKernels::BlendPoses(const SoaPose* const* ppPoses, const float* pWeights, uint32_t poseCount, SoaPose& outPose)
+{
+	BlendPosesImpl<SimdOps>(ppPoses, pWeights, poseCount, outPose);
+}
+
+void PoseKernels::BlendPosesScalar(const SoaPose* const* ppPoses, const float* pWeights, uint32_t poseCount, SoaPose& outPose)
+{
+	BlendPosesImpl<ScalarOps>(ppPoses, pWeights, poseCount, outPose);
+}
+
+void PoseKernels::AddLayer(SoaPose& pose, const SoaPose& additivePose, float weight)
+{
+	AddLayerImpl<SimdOps>(pose, additivePose, weight);
+}
+
+void PoseKernels::AddLayerScalar(SoaPose& pose, const SoaPose& additivePose, float weight)
+{
+	AddLayerImpl<ScalarOps>(pose, additivePose, weight);
+}
+
+void PoseKernels::LocalToModel(const SoaPose& localPose, const AnimationClipData& clip, cd::Matrix4x4* pModelMatrices, uint32_t boneOrderCount)
+{
+	assert(localPose.GetBoneCount() == clip.GetBoneCount());
+
+	const std::vector<uint32_t>& boneOrder = clip.GetBoneOrder();
+	const uint32_t orderCount = std::min(boneOrderCount, static_cast<uint32_t>(boneOrder.size()));
+	float* pMatrices = reinterpret_cast<float*>(pModelMatrices);
+	if (orderCount == boneOrder.size())
+	{
+		// Local matrices are built in place, then every bone is multiplied by its parent which is already in model space.
+		BuildLocalMatrices<SimdOps>(localPose, pMatrices);
+		for (uint32_t orderIndex = 0U; orderIndex < orderCount; ++orderIndex)
+		{
+			const uint32_t boneIndex = boneOrder[orderIndex];
+			const uint32_t parentIndex = clip.GetParentIndex(boneIndex);
+			if (AnimationClipData::InvalidBoneIndex != parentIndex)
+			{
+				float* pMatrix = pMatrices + boneIndex * 16U;
+				MultiplyMatrix(pMatrices + parentIndex * 16U, pMatrix, pMatrix);
+			}
+		}
+		return;
+	}
+
+	// Local matrices of all bones are built at once, so they go to a scratch buffer to keep skipped bones unchanged.
+	// It only grows when a thread sees a larger skeleton.
+	thread_local std::vector<cd::Matrix4x4> t_localMatrices;
+	t_localMatrices.resize(std::max(t_localMatrices.size(), static_cast<size_t>(localPose.GetBoneCount())));
+	const float* pLocalMatrices = reinterpret_cast<const float*>(t_localMatrices.data());
+	BuildLocalMatrices<SimdOps>(localPose, reinterpret_cast<float*>(t_localMatrices.data()));
+	for (uint32_t orderIndex = 0U; orderIndex < orderCount; ++orderIndex)
+	{
+		const uint32_t boneIndex = boneOrder[orderIndex];
+		const uint32_t parentIndex = clip.GetParentIndex(boneIndex);
+		if (AnimationClipData::InvalidBoneIndex != parentIndex)
+		{
+			MultiplyMatrix(pMatrices + parentIndex * 16U, pLocalMatrices + boneIndex * 16U, pMatrices + boneIndex * 16U);
+		}
+		else
+		{
+			pModelMatrices[boneIndex] = t_localMatrices[boneIndex];
+		}
+	}
+}
+
+void PoseKernels::LocalToModelScalar(const SoaPose& localPose, const AnimationClipData& clip, cd::Matrix4x4* pModelMatrices, uint32_t boneOrderCount)
+{
+	assert(localPose.GetBoneCount() == clip.GetBoneCount());
+
+	const std::vector<uint32_t>& boneOrder = clip.GetBoneOrder();
+	const uint32_t orderCount = std::min(boneOrderCount, static_cast<uint32_t>(boneOrder.size()));
+	for (uint32_t orderIndex = 0U; orderIndex < orderCount; ++orderIndex)
+	{
+		const uint32_t boneIndex = boneOrder[orderIndex];
+		const uint32_t parentIndex = clip.GetParentIndex(boneIndex);
+		const cd::Matrix4x4 localMatrix = localPose.GetTransform(boneIndex).GetMatrix();
+		pModelMatrices[boneIndex] = AnimationClipData::InvalidBoneIndex == parentIndex ?
+			localMatrix : pModelMatrices[parentIndex] * localMatrix;
+	}
+}
+
+}
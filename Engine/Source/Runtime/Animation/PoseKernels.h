@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Math/Transform.hpp"
+
+#include <cstdint>
+
+namespace engine
+{
+
+class AnimationClipData;
+class SoaPose;
+
+// PoseKernels are the per bone math of pose evaluation on SoaPose streams. The instruction set is chosen
+// when compiling: AVX, SSE2, NEON or plain floats. Scalar variants run the same math one bone at a time
+// and are kept as the reference to validate the SIMD paths.
+class PoseKernels final
+{
+public:
+	PoseKernels() = delete;
+
+	static const char* GetInstructionSetName();
+
+	// Weighted sum of poseCount poses of the same skeleton. Weights should sum to one.
+	// Rotations are flipped to the hemisphere of the first pose before summing and normalized after.
+	// outPose can be one of the inputs.
+	static void BlendPoses(const SoaPose* const* ppPoses, const float* pWeights, uint32_t poseCount, SoaPose& outPose);
+	static void BlendPosesScalar(const SoaPose* const* ppPoses, const float* pWeights, uint32_t poseCount, SoaPose& outPose);
+
+	// Applies a delta pose on top of pose. Weight 0 keeps pose and weight 1 applies the full delta.
+	// Rotation becomes rotation * delta, so the delta is in the local space of the bone.
+	static void AddLayer(SoaPose& pose, const SoaPose& additivePose, float weight);
+	static void AddLayerScalar(SoaPose& pose, const SoaPose& additivePose, float weight);
+
+	// Model space matrices from local transforms. Walks bones in clip bone order so parents are ready before children.
+	// Only the first boneOrderCount bones of the order get model space matrices, the others keep their values.
+	static void LocalToModel(const SoaPose& localPose, const AnimationClipData& clip, cd::Matrix4x4* pModelMatrices, uint32_t boneOrderCount = UINT32_MAX);
+	static void LocalToModelScalar(const SoaPose& localPose, const AnimationClipData& clip, cd::Matrix4x4* pModelMatrices, uint32_t boneOrderCount = UINT32_MAX);
+};
+
+}
@@ -0,0 +1,134 @@
+#include "SkinningPalette.h"
+
+#include <cmath>
+
+namespace engine
+{
+
+namespace
+{
+
+static_assert(sizeof(cd::Matrix4x4) == 16U * sizeof(float), "Matrices are read as 16 floats.");
+
+// Column major as bgfx expects, element of row and column.
+float GetElement(const float* pMatrix, uint32_t row, uint32_t column)
+{
+	return pMatrix[column * 4U + row];
+}
+
+}
+
+void SkinningPalette::PackMatrix(const cd::Matrix4x4& matrix, float* pTexels)
+{
+	// The last row is always (0, 0, 0, 1) so it is not stored.
+	const float* pMatrix = matrix.begin();
+	for (uint32_t row = 0U; row < 3U; ++row)
+	{
+		for (uint32_t column = 0U; column < 4U; ++column)
+		{
+			pTexels[row * 4U + column] = GetElement(pMatrix, row, column);
+		}
+	}
+}
+
+void SkinningPalette::PackDualQuaternion(const cd::Matrix4x4& matrix, float* pTexels)
+{
+	const float* pMatrix = matrix.begin();
+
+	// Rotation part without scale.
+	float rotation[3][3];
+	for (uint32_t column = 0U; column < 3U; ++column)
+	{
+		const float x = GetElement(pMatrix, 0U, column);
+		const float y = GetElement(pMatrix, 1U, column);
+		const float z = GetElement(pMatrix, 2U, column);
+		const float length = std::sqrt(x * x + y * y + z * z);
+		const float inverseLength = length > 0.0f ? 1.0f / length : 0.0f;
+		rotation[0][column] = x * inverseLength;
+		rotation[1][column] = y * inverseLength;
+		rotation[2][column] = z * inverseLength;
+	}
+
+	// Real part from the largest diagonal term to stay away from small divisors.
+	float qx;
+	float qy;
+	float qz;
+	float qw;
+	const float trace = rotation[0][0] + rotation[1][1] + rotation[2][2];
+	if (trace > 0.0f)
+	{
+		const float s = std::sqrt(trace + 1.0f) * 2.0f;
+		qw = 0.25f * s;
+		qx = (rotation[2][1] - rotation[1][2]) / s;
+		qy = (rotation[0][2] - rotation[2][0]) / s;
+		qz = (rotation[1][0] - rotation[0][1]) / s;
+	}
+	else if (rotation[0][0] > rotation[1][1] && rotation[0][0] > rotation[2][2])
+	{
+		const float s = std::sqrt(1.0f + rotation[0][0] - rotation[1][1] - rotation[2][2]) * 2.0f;
+		qw = (rotation[2][1] - rotation[1][2]) / s;
+		qx = 0.25f * s;
+		qy = (rotation[0][1] + rotation[1][0]) / s;
+		qz = (rotation[0][2] + rotation[2][0]) / s;
+	}
+	else if (rotation[1][1] > rotation[2][2])
+	{
+		const float s = std::sqrt(1.0f + rotation[1][1] - rotation[0][0] - rotation[2][2]) * 2.0f;
+		qw = (rotation[0][2] - rotation[2][0]) / s;
+		qx = (rotation[0][1] + rotation[1][0]) / s;
+		qy = 0.25f * s;
+		qz = (rotation[1][2] + rotation[2][1]) / s;
+	}
+	else
+	{
+		const float s = std::sqrt(1.0f + rotation[2][2] - rotation[0][0] - rotation[1][1]) * 2.0f;
+		qw = (rotation[1][0] - rotation[0][1]) / s;
+		qx = (rotation[0][2] + rotation[2][0]) / s;
+		qy = (rotation[1][2] + rotation[2][1]) / s;
+		qz = 0.25f * s;
+	}
+
+	// Dual part is 0.5 * translation * real.
+	const float tx = GetElement(pMatrix, 0U, 3U);
+	const float ty = GetElement(pMatrix, 1U, 3U);
+	const float tz = GetElement(pMatrix, 2U, 3U);
+	pTexels[0] = qx;
+	pTexels[1] = qy;
+	pTexels[2] = qz;
+	pTexels[3] = qw;
+	pTexels[4] = 0.5f * (tx * qw + ty * qz - tz * qy);
+	pTexels[5] = 0.5f * (-tx * qz + ty * qw + tz * qx);
+	pTexels[6] = 0.5f * (tx * qy - ty * qx + tz * qw);
+	pTexels[7] = -0.5f * (tx * qx + ty * qy + tz * qz);
+}
+
+uint32_t SkinningPalette::Append(const cd::Matrix4x4* pSkinningMatrices, uint32_t boneCount, SkinningMode mode)
+{
+	const uint32_t firstTexel = m_texelCount;
+	const uint32_t texelsPerBone = GetTexelsPerBone(mode);
+	m_texelCount += boneCount * texelsPerBone;
+
+	const size_t floatCount = static_cast<size_t>(GetRowCount()) * TextureWidth * 4U;
+	if (m_texels.size() < floatCount)
+	{
+		m_texels.resize(floatCount);
+	}
+
+	float* pTexels = &m_texels[static_cast<size_t>(firstTexel) * 4U];
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		if (SkinningMode::LinearBlend == mode)
+		{
+			PackMatrix(pSkinningMatrices[boneIndex], pTexels);
+		}
+		else
+		{
+			PackDualQuaternion(pSkinningMatrices[boneIndex], pTexels);
+		}
+		pTexels += texelsPerBone * 4U;
+	}
+
+	return firstTexel;
+}
+
+}
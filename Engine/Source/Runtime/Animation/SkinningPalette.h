@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Math/Matrix.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+
+enum class SkinningMode : uint8_t
+{
+	// 3 texels per bone, rows of the affine skinning matrix.
+	LinearBlend,
+	// 2 texels per bone, real and dual part. Keeps volume on twisted joints but ignores bone scale.
+	DualQuaternion,
+};
+
+// SkinningPalette packs skinning matrices of all characters into one float4 array which is uploaded
+// as a single texture per frame. Shaders address bones by the first texel of their character's palette,
+// so the bone count is only limited by texture size and characters sharing a mesh can be instanced.
+// Every palette is packed in the skinning mode of its character.
+class SkinningPalette final
+{
+public:
+	// Texels per texture row. Same as BONE_PALETTE_WIDTH in U_Skinning.sh.
+	static constexpr uint32_t TextureWidth = 1024U;
+
+	static constexpr uint32_t GetTexelsPerBone(SkinningMode mode) { return SkinningMode::LinearBlend == mode ? 3U : 2U; }
+
+	// Writes 3 texels.
+	static void PackMatrix(const cd::Matrix4x4& matrix, float* pTexels);
+	// Writes 2 texels. The matrix should be a rotation and a translation, scale is removed.
+	static void PackDualQuaternion(const cd::Matrix4x4& matrix, float* pTexels);
+
+public:
+	SkinningPalette() = default;
+	SkinningPalette(const SkinningPalette&) = delete;
+	SkinningPalette& operator=(const SkinningPalette&) = delete;
+	SkinningPalette(SkinningPalette&&) = default;
+	SkinningPalette& operator=(SkinningPalette&&) = default;
+	~SkinningPalette() = default;
+
+	// Keeps the capacity so that palettes of the same size don't allocate again.
+	void Reset() { m_texelCount = 0U; }
+
+	// Returns the first texel of this palette.
+	uint32_t Append(const cd::Matrix4x4* pSkinningMatrices, uint32_t boneCount, SkinningMode mode);
+
+	uint32_t GetTexelCount() const { return m_texelCount; }
+	// Rows are filled up so the texture can be updated from GetData in one call.
+	uint32_t GetRowCount() const { return (m_texelCount + TextureWidth - 1U) / TextureWidth; }
+	const float* GetData() const { return m_texels.data(); }
+	uint32_t GetDataSize() const { return GetRowCount() * TextureWidth * 4U * sizeof(float); }
+
+private:
+	uint32_t m_texelCount = 0U;
+	std::vector<float> m_texels;
+};
+
+}
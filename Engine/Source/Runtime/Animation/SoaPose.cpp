@@ -0,0 +1,144 @@
+#include "SoaPose.h"
+
+#include <cassert>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace engine
+{
+
+namespace
+{
+
+constexpr size_t StreamCount = static_cast<size_t>(PoseStream::Count);
+
+}
+
+SoaPose::SoaPose(uint32_t boneCount)
+{
+	Resize(boneCount);
+}
+
+SoaPose::SoaPose(const SoaPose& other)
+{
+	*this = other;
+}
+
+SoaPose& SoaPose::operator=(const SoaPose& other)
+{
+	if (this != &other)
+	{
+		Resize(other.m_boneCount);
+		if (m_pData)
+		{
+			std::memcpy(m_pData, other.m_pData, StreamCount * m_paddedBoneCount * sizeof(float));
+		}
+	}
+
+	return *this;
+}
+
+SoaPose::SoaPose(SoaPose&& other) noexcept
+	: m_pData(std::exchange(other.m_pData, nullptr))
+	, m_boneCount(std::exchange(other.m_boneCount, 0U))
+	, m_paddedBoneCount(std::exchange(other.m_paddedBoneCount, 0U))
+{
+}
+
+SoaPose& SoaPose::operator=(SoaPose&& other) noexcept
+{
+	if (this != &other)
+	{
+		Free();
+		m_pData = std::exchange(other.m_pData, nullptr);
+		m_boneCount = std::exchange(other.m_boneCount, 0U);
+		m_paddedBoneCount = std::exchange(other.m_paddedBoneCount, 0U);
+	}
+
+	return *this;
+}
+
+SoaPose::~SoaPose()
+{
+	Free();
+}
+
+void SoaPose::Resize(uint32_t boneCount)
+{
+	const uint32_t paddedBoneCount = (boneCount + LaneCount - 1U) / LaneCount * LaneCount;
+	if (paddedBoneCount != m_paddedBoneCount)
+	{
+		Free();
+		if (paddedBoneCount > 0U)
+		{
+			m_pData = static_cast<float*>(::operator new(StreamCount * paddedBoneCount * sizeof(float), std::align_val_t{ Alignment }));
+		}
+		m_paddedBoneCount = paddedBoneCount;
+	}
+
+	m_boneCount = boneCount;
+	SetIdentity();
+}
+
+void SoaPose::SetIdentity()
+{
+	for (size_t streamIndex = 0U; streamIndex < StreamCount; ++streamIndex)
+	{
+		const PoseStream stream = static_cast<PoseStream>(streamIndex);
+		const float value = PoseStream::RotationW == stream || stream >= PoseStream::ScaleX ? 1.0f : 0.0f;
+		float* pStream = GetStream(stream);
+		for (uint32_t boneIndex = 0U; boneIndex < m_paddedBoneCount; ++boneIndex)
+		{
+			pStream[boneIndex] = value;
+		}
+	}
+}
+
+void SoaPose::SetTransform(uint32_t boneIndex, const cd::Transform& transform)
+{
+	assert(boneIndex < m_boneCount);
+	const cd::Vec3f& translation = transform.GetTranslation();
+	const cd::Quaternion& rotation = transform.GetRotation();
+	const cd::Vec3f& scale = transform.GetScale();
+	GetStream(PoseStream::TranslationX)[boneIndex] = translation[0];
+	GetStream(PoseStream::TranslationY)[boneIndex] = translation[1];
+	GetStream(PoseStream::TranslationZ)[boneIndex] = translation[2];
+	GetStream(PoseStream::RotationX)[boneIndex] = rotation.x();
+	GetStream(PoseStream::RotationY)[boneIndex] = rotation.y();
+	GetStream(PoseStream::RotationZ)[boneIndex] = rotation.z();
+	GetStream(PoseStream::RotationW)[boneIndex] = rotation.w();
+	GetStream(PoseStream::ScaleX)[boneIndex] = scale[0];
+	GetStream(PoseStream::ScaleY)[boneIndex] = scale[1];
+	GetStream(PoseStream::ScaleZ)[boneIndex] = scale[2];
+}
+
+cd::Transform SoaPose::GetTransform(uint32_t boneIndex) const
+{
+	assert(boneIndex < m_boneCount);
+	cd::Quaternion rotation = cd::Quaternion::Identity();
+	rotation.x() = GetStream(PoseStream::RotationX)[boneIndex];
+	rotation.y() = GetStream(PoseStream::RotationY)[boneIndex];
+	rotation.z() = GetStream(PoseStream::RotationZ)[boneIndex];
+	rotation.w() = GetStream(PoseStream::RotationW)[boneIndex];
+
+	cd::Transform transform(cd::Vec3f(GetStream(PoseStream::TranslationX)[boneIndex],
+		GetStream(PoseStream::TranslationY)[boneIndex],
+		GetStream(PoseStream::TranslationZ)[boneIndex]),
+		rotation,
+		cd::Vec3f(GetStream(PoseStream::ScaleX)[boneIndex],
+		GetStream(PoseStream::ScaleY)[boneIndex],
+		GetStream(PoseStream::ScaleZ)[boneIndex]));
+	return transform;
+}
+
+void SoaPose::Free()
+{
+	if (m_pData)
+	{
+		::operator delete(m_pData, std::align_val_t{ Alignment });
+		m_pData = nullptr;
+	}
+}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Math/Transform.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace engine
+{
+
+// Components of a pose stream. Every stream stores one float per bone.
+enum class PoseStream : uint8_t
+{
+	TranslationX,
+	TranslationY,
+	TranslationZ,
+	RotationX,
+	RotationY,
+	RotationZ,
+	RotationW,
+	ScaleX,
+	ScaleY,
+	ScaleZ,
+	Count
+};
+
+// SoaPose stores local bone transforms as separate float streams so that SIMD kernels process
+// several bones per instruction. Streams are aligned and padded to LaneCount bones,
+// padding bones are identity so kernels never need a scalar tail.
+class SoaPose final
+{
+public:
+	// Enough for AVX. SSE and NEON process half of it per instruction.
+	static constexpr uint32_t LaneCount = 8U;
+	static constexpr size_t Alignment = LaneCount * sizeof(float);
+
+public:
+	SoaPose() = default;
+	explicit SoaPose(uint32_t boneCount);
+	SoaPose(const SoaPose& other);
+	SoaPose& operator=(const SoaPose& other);
+	SoaPose(SoaPose&& other) noexcept;
+	SoaPose& operator=(SoaPose&& other) noexcept;
+	~SoaPose();
+
+	// Resets all bones to identity.
+	void Resize(uint32_t boneCount);
+	void SetIdentity();
+
+	uint32_t GetBoneCount() const { return m_boneCount; }
+	uint32_t GetPaddedBoneCount() const { return m_paddedBoneCount; }
+
+	float* GetStream(PoseStream stream) { return m_pData + static_cast<size_t>(stream) * m_paddedBoneCount; }
+	const float* GetStream(PoseStream stream) const { return m_pData + static_cast<size_t>(stream) * m_paddedBoneCount; }
+
+	void SetTransform(uint32_t boneIndex, const cd::Transform& transform);
+	cd::Transform GetTransform(uint32_t boneIndex) const;
+
+private:
+	void Free();
+
+private:
+	float* m_pData = nullptr;
+	uint32_t m_boneCount = 0U;
+	uint32_t m_paddedBoneCount = 0U;
+};
+
+}
@@ -0,0 +1,128 @@
+#include "VertexSkinning.h"
+
+#include <cmath>
+
+namespace engine
+{
+
+namespace
+{
+
+constexpr uint32_t InfluenceCount = 4U;
+
+void Cross(const float* a, const float* b, float* pResult)
+{
+	pResult[0] = a[1] * b[2] - a[2] * b[1];
+	pResult[1] = a[2] * b[0] - a[0] * b[2];
+	pResult[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+// v + 2 * cross(q.xyz, cross(q.xyz, v) + q.w * v)
+void RotateByQuaternion(const float* pQuaternion, const float* pVector, float* pResult)
+{
+	float inner[3];
+	Cross(pQuaternion, pVector, inner);
+	for (uint32_t axis = 0U; axis < 3U; ++axis)
+	{
+		inner[axis] += pQuaternion[3] * pVector[axis];
+	}
+
+	float outer[3];
+	Cross(pQuaternion, inner, outer);
+	for (uint32_t axis = 0U; axis < 3U; ++axis)
+	{
+		pResult[axis] = pVector[axis] + 2.0f * outer[axis];
+	}
+}
+
+void Normalize(float* pVector)
+{
+	const float lengthSquared = pVector[0] * pVector[0] + pVector[1] * pVector[1] + pVector[2] * pVector[2];
+	if (lengthSquared > 0.0f)
+	{
+		const float inverseLength = 1.0f / std::sqrt(lengthSquared);
+		pVector[0] *= inverseLength;
+		pVector[1] *= inverseLength;
+		pVector[2] *= inverseLength;
+	}
+}
+
+void SkinVertexLinearBlend(const float* pPaletteTexels, const SkinningVertex& vertex, SkinnedVertex& skinnedVertex)
+{
+	float rows[12] = {};
+	for (uint32_t influence = 0U; influence < InfluenceCount; ++influence)
+	{
+		const float weight = vertex.boneWeights[influence];
+		const float* pBone = pPaletteTexels + static_cast<uint32_t>(vertex.boneIndices[influence]) * 12U;
+		for (uint32_t element = 0U; element < 12U; ++element)
+		{
+			rows[element] += pBone[element] * weight;
+		}
+	}
+
+	for (uint32_t row = 0U; row < 3U; ++row)
+	{
+		const float* pRow = rows + row * 4U;
+		skinnedVertex.position[row] = pRow[0] * vertex.position[0] + pRow[1] * vertex.position[1] + pRow[2] * vertex.position[2] + pRow[3];
+		skinnedVertex.normal[row] = pRow[0] * vertex.normal[0] + pRow[1] * vertex.normal[1] + pRow[2] * vertex.normal[2];
+	}
+}
+
+void SkinVertexDualQuaternion(const float* pPaletteTexels, const SkinningVertex& vertex, SkinnedVertex& skinnedVertex)
+{
+	const float* pFirstReal = pPaletteTexels + static_cast<uint32_t>(vertex.boneIndices[0]) * 8U;
+	float real[4] = {};
+	float dual[4] = {};
+	for (uint32_t influence = 0U; influence < InfluenceCount; ++influence)
+	{
+		const float* pBone = pPaletteTexels + static_cast<uint32_t>(vertex.boneIndices[influence]) * 8U;
+		const float dot = pFirstReal[0] * pBone[0] + pFirstReal[1] * pBone[1] + pFirstReal[2] * pBone[2] + pFirstReal[3] * pBone[3];
+		const float weight = dot < 0.0f ? -vertex.boneWeights[influence] : vertex.boneWeights[influence];
+		for (uint32_t element = 0U; element < 4U; ++element)
+		{
+			real[element] += pBone[element] * weight;
+			dual[element] += pBone[4U + element] * weight;
+		}
+	}
+
+	const float inverseLength = 1.0f / std::sqrt(real[0] * real[0] + real[1] * real[1] + real[2] * real[2] + real[3] * real[3]);
+	for (uint32_t element = 0U; element < 4U; ++element)
+	{
+		real[element] *= inverseLength;
+		dual[element] *= inverseLength;
+	}
+
+	float dualCross[3];
+	Cross(real, dual, dualCross);
+	RotateByQuaternion(real, vertex.position, skinnedVertex.position);
+	RotateByQuaternion(real, vertex.normal, skinnedVertex.normal);
+	for (uint32_t axis = 0U; axis < 3U; ++axis)
+	{
+		skinnedVertex.position[axis] += 2.0f * (real[3] * dual[axis] - dual[3] * real[axis] + dualCross[axis]);
+	}
+}
+
+}
+
+void VertexSkinning::SkinVertices(const float* pPaletteTexels, SkinningMode mode, const SkinningVertex* pVertices, uint32_t vertexCount, SkinnedVertex* pSkinnedVertices)
+{
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const SkinningVertex& vertex = pVertices[vertexIndex];
+		SkinnedVertex& skinnedVertex = pSkinnedVertices[vertexIndex];
+		if (SkinningMode::LinearBlend == mode)
+		{
+			SkinVertexLinearBlend(pPaletteTexels, vertex, skinnedVertex);
+		}
+		else
+		{
+			SkinVertexDualQuaternion(pPaletteTexels, vertex, skinnedVertex);
+		}
+
+		Normalize(skinnedVertex.normal);
+		skinnedVertex.position[3] = 1.0f;
+		skinnedVertex.normal[3] = 0.0f;
+	}
+}
+
+}
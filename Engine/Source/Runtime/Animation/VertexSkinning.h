@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Animation/SkinningPalette.h"
+
+#include <cstdint>
+
+namespace engine
+{
+
+// Input of pre-skinning, 4 float4 so that compute shaders read it as a vec4 buffer.
+struct SkinningVertex
+{
+	float position[4];
+	float normal[4];
+	// Bone indices are stored as floats which are exact up to 2^24 bones.
+	float boneIndices[4];
+	float boneWeights[4];
+};
+
+// Output of pre-skinning which later passes bind in front of the mesh vertex buffer.
+struct SkinnedVertex
+{
+	float position[4];
+	float normal[4];
+};
+
+static_assert(sizeof(SkinningVertex) == 64U && sizeof(SkinnedVertex) == 32U, "Skinning vertices are read as float4 arrays by cs_skinning.");
+
+// VertexSkinning is the CPU version of cs_skinning. It is the fallback for backends without compute shaders
+// and runs the same math as Skinning.sh on the texels of a SkinningPalette.
+class VertexSkinning final
+{
+public:
+	VertexSkinning() = delete;
+
+	// pPaletteTexels points to the first texel of the palette of this mesh.
+	static void SkinVertices(const float* pPaletteTexels, SkinningMode mode, const SkinningVertex* pVertices, uint32_t vertexCount, SkinnedVertex* pSkinnedVertices);
+};
+
+}
@@ -1,5 +1,7 @@
 ﻿#include "Engine.h"
+#include "Core/Jobs/JobSystem.h"
 #include "Log/Log.h"
+#include "Profiling/Profile.h"
 #include "Time/Clock.h"
 #include "Window/Window.h"
 
@@ -28,6 +30,12 @@ void Engine::Init(EngineInitArgs args)
 {
 	CD_ENGINE_INFO("Init engine");
 	Window::Init();
+	CD_PROFILE_THREAD("Main");
+	JobSystem::Get().Init();
+
+	m_fixedTimestep = FixedTimestep(args.fixedDeltaTime, args.maxFixedStepsPerFrame);
+	m_framePacer = FramePacer(args.framePacingMode, args.targetFrameRate);
+	m_pFrameStatsFilePath = args.pFrameStatsFilePath;
 
 	m_pApplication->Init(args);
 }
@@ -35,25 +43,81 @@ void Engine::Init(EngineInitArgs args)
 void Engine::Run()
 {
 	Clock clock;
+	bool isFirstFrame = true;
 
 	while (true)
 	{
 		ZoneScoped;
+		CD_PROFILE_ZONE("Frame");
 
 		clock.Update();
+		const float deltaTime = clock.GetDeltaTime();
+		if (!isFirstFrame)
+		{
+			m_frameTimeStats.AddSample(deltaTime * 1000.0f);
+		}
+		isFirstFrame = false;
+
+		// Results from worker threads which need to touch bgfx or windows.
+		JobSystem::Get().ProcessMainThreadJobs();
 
-		if (!m_pApplication->Update(clock.GetDeltaTime()))
+		if (!RunFixedSteps(deltaTime) || !m_pApplication->Update(deltaTime))
 		{
 			// quit
 			break;
 		}
 
+		m_framePacer.WaitForNextFrame();
+
 		FrameMark;
+		CD_PROFILE_FRAME();
+	}
+
+	ReportFrameTimeStats();
+}
+
+bool Engine::RunFixedSteps(float deltaTime)
+{
+	const uint32_t stepCount = m_fixedTimestep.Advance(deltaTime);
+	for (uint32_t stepIndex = 0U; stepIndex < stepCount; ++stepIndex)
+	{
+		CD_PROFILE_ZONE("FixedUpdate");
+		if (!m_pApplication->FixedUpdate(m_fixedTimestep.GetStepTime()))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Engine::ReportFrameTimeStats() const
+{
+	const FrameTimeSummary summary = m_frameTimeStats.GetSummary();
+	if (0U == summary.frameCount)
+	{
+		return;
+	}
+
+	CD_ENGINE_INFO("Frame time of {0} frames : avg {1:.3f} ms, p50 {2:.3f} ms, p95 {3:.3f} ms, p99 {4:.3f} ms, max {5:.3f} ms",
+		summary.frameCount, summary.averageMs, summary.p50Ms, summary.p95Ms, summary.p99Ms, summary.maxMs);
+
+	if (m_pFrameStatsFilePath)
+	{
+		if (m_frameTimeStats.WriteToFile(m_pFrameStatsFilePath))
+		{
+			CD_ENGINE_INFO("Saved frame time stats to {0}", m_pFrameStatsFilePath);
+		}
+		else
+		{
+			CD_ENGINE_ERROR("Failed to save frame time stats to {0}", m_pFrameStatsFilePath);
+		}
 	}
 }
 
 void Engine::Shutdown()
 {
+	JobSystem::Get().Shutdown();
 	Window::Shutdown();
 }
 
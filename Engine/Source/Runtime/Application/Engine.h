@@ -2,6 +2,9 @@
 
 #include "EngineDefines.h"
 #include "IApplication.h"
+#include "Time/FixedTimestep.h"
+#include "Time/FramePacer.h"
+#include "Time/FrameTimeStats.h"
 
 #include <vector>
 #include <memory>
@@ -42,8 +45,22 @@ public:
 	//
 	ENGINE_API void Shutdown();
 
+	// Read it on the thread which calls FixedUpdate, e.g. to interpolate between the last two steps.
+	const FixedTimestep& GetFixedTimestep() const { return m_fixedTimestep; }
+	const FramePacer& GetFramePacer() const { return m_framePacer; }
+	const FrameTimeStats& GetFrameTimeStats() const { return m_frameTimeStats; }
+
+private:
+	bool RunFixedSteps(float deltaTime);
+	void ReportFrameTimeStats() const;
+
 private:
 	std::unique_ptr<IApplication> m_pApplication;
+
+	FixedTimestep m_fixedTimestep;
+	FramePacer m_framePacer;
+	FrameTimeStats m_frameTimeStats;
+	const char* m_pFrameStatsFilePath = nullptr;
 };
 
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "Graphics/GraphicsBackend.h"
 #include "ImGui/Language.h"
+#include "Time/FramePacer.h"
 
 #include <cstdint>
 
@@ -20,6 +21,14 @@ struct EngineInitArgs
 	Language language = Language::English;
 	GraphicsBackend backend = GraphicsBackend::Direct3D11;
 	bool compileAllShaders = false;
+
+	// Main loop. Simulation runs in fixed steps of fixedDeltaTime, rendering runs once per frame.
+	FramePacingMode framePacingMode = FramePacingMode::VSync;
+	float targetFrameRate = 60.0f;
+	float fixedDeltaTime = 1.0f / 60.0f;
+	uint32_t maxFixedStepsPerFrame = 5U;
+	// Frame time percentiles are written here on exit when it is set.
+	const char* pFrameStatsFilePath = nullptr;
 };
 
 class IApplication
@@ -34,6 +43,8 @@ public:
 
 	virtual void Init(EngineInitArgs initArgs) = 0;
 	virtual bool Update(float deltaTime) = 0;
+	// Called zero or more times per frame before Update with a constant step time.
+	virtual bool FixedUpdate(float fixedDeltaTime) { return true; }
 	virtual void Shutdown() = 0;
 
 	void SetEngine(Engine* pEngine) { m_pEngine = pEngine; }
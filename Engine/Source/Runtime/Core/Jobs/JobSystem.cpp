@@ -0,0 +1,311 @@
+#include "JobSystem.h"
+
+#include "Log/Log.h"
+#include "Profiling/Profile.h"
+
+#include <cassert>
+#include <string>
+
+namespace engine
+{
+
+namespace
+{
+
+thread_local uint32_t t_threadIndex = JobSystem::InvalidThreadIndex;
+
+uint32_t NextRandom(uint32_t& seed)
+{
+	// xorshift32
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+}
+
+JobSystem::~JobSystem()
+{
+	Shutdown();
+}
+
+void JobSystem::Init(uint32_t threadCount)
+{
+	if (IsInitialized())
+	{
+		assert(IsMainThread() && "JobSystem should be initialized on the main thread.");
+		return;
+	}
+	t_threadIndex = MainThreadIndex;
+
+	if (0U == threadCount)
+	{
+		// Keep at least one worker so that long background jobs don't wait for the main thread.
+		threadCount = std::max(2U, std::thread::hardware_concurrency());
+	}
+	m_threadCount = std::min(threadCount, MaxThreadCount);
+
+	m_threadContexts = std::make_unique<ThreadContext[]>(m_threadCount);
+	for (uint32_t threadIndex = 0U; threadIndex < m_threadCount; ++threadIndex)
+	{
+		ThreadContext& context = m_threadContexts[threadIndex];
+		context.jobPool = std::make_unique<Job[]>(MaxJobCountPerThread);
+		context.nextJobIndex = 0U;
+		context.randomSeed = threadIndex * 2654435761U + 1U;
+	}
+
+	m_pendingJobCount.store(0U);
+	m_sleepingWorkerCount.store(0U);
+	m_isRunning.store(true, std::memory_order_release);
+
+	m_workerThreads.reserve(m_threadCount - 1U);
+	for (uint32_t threadIndex = 1U; threadIndex < m_threadCount; ++threadIndex)
+	{
+		m_workerThreads.emplace_back(&JobSystem::WorkerMain, this, threadIndex);
+	}
+
+	CD_ENGINE_INFO("Init job system with {0} threads", m_threadCount);
+}
+
+void JobSystem::Shutdown()
+{
+	if (!IsInitialized())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_isRunning.store(false, std::memory_order_release);
+	}
+	m_wakeCondition.notify_all();
+
+	for (std::thread& workerThread : m_workerThreads)
+	{
+		workerThread.join();
+	}
+	m_workerThreads.clear();
+	m_threadContexts.reset();
+	m_threadCount = 1U;
+
+	std::lock_guard<std::mutex> lock(m_mainThreadJobMutex);
+	m_mainThreadJobs.clear();
+}
+
+uint32_t JobSystem::GetThreadIndex()
+{
+	return t_threadIndex;
+}
+
+bool JobSystem::IsMainThread()
+{
+	const uint32_t threadIndex = GetThreadIndex();
+	return MainThreadIndex == threadIndex || (InvalidThreadIndex == threadIndex && !Get().IsInitialized());
+}
+
+void JobSystem::Run(JobFunction function, JobCounter* pCounter)
+{
+	if (!IsInitialized())
+	{
+		function();
+		return;
+	}
+
+	if (pCounter)
+	{
+		pCounter->Add(1U);
+	}
+
+	const uint32_t threadIndex = GetThreadIndex();
+	assert(threadIndex < m_threadCount && "Jobs should be run from the main thread or a worker thread.");
+	Job* pJob = threadIndex < m_threadCount ? AllocateJob(m_threadContexts[threadIndex]) : nullptr;
+	if (!pJob)
+	{
+		// Unknown thread or all job slots are in flight. Execute in place.
+		function();
+		if (pCounter)
+		{
+			pCounter->Decrement();
+		}
+		return;
+	}
+
+	ThreadContext& context = m_threadContexts[threadIndex];
+	pJob->function = std::move(function);
+	pJob->pCounter = pCounter;
+
+	// Count before publishing so that a thief never decrements it below zero.
+	m_pendingJobCount.fetch_add(1U);
+	if (!context.jobQueue.Push(pJob))
+	{
+		// Queue is full. Execute in place.
+		m_pendingJobCount.fetch_sub(1U);
+		Execute(pJob);
+		return;
+	}
+
+	if (m_sleepingWorkerCount.load() > 0U)
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_wakeCondition.notify_one();
+	}
+}
+
+void JobSystem::Wait(const JobCounter& counter)
+{
+	const uint32_t threadIndex = GetThreadIndex();
+	while (!counter.IsDone())
+	{
+		if (MainThreadIndex == threadIndex)
+		{
+			ProcessMainThreadJobs();
+		}
+
+		if (!IsInitialized())
+		{
+			// Jobs which were queued before shutdown will never finish.
+			break;
+		}
+
+		if (threadIndex >= m_threadCount)
+		{
+			// Threads outside of the job system don't own a queue to help with.
+			std::this_thread::yield();
+			continue;
+		}
+
+		if (Job* pJob = FindJob(threadIndex))
+		{
+			Execute(pJob);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::RunOnMainThread(JobFunction function, JobCounter* pCounter)
+{
+	if (!IsInitialized() && IsMainThread())
+	{
+		function();
+		return;
+	}
+
+	if (pCounter)
+	{
+		pCounter->Add(1U);
+	}
+
+	std::lock_guard<std::mutex> lock(m_mainThreadJobMutex);
+	m_mainThreadJobs.emplace_back(std::move(function), pCounter);
+}
+
+void JobSystem::ProcessMainThreadJobs()
+{
+	assert(IsMainThread());
+
+	std::vector<std::pair<JobFunction, JobCounter*>> jobs;
+	{
+		std::lock_guard<std::mutex> lock(m_mainThreadJobMutex);
+		if (m_mainThreadJobs.empty())
+		{
+			return;
+		}
+		jobs.swap(m_mainThreadJobs);
+	}
+
+	for (auto& [function, pCounter] : jobs)
+	{
+		function();
+		if (pCounter)
+		{
+			pCounter->Decrement();
+		}
+	}
+}
+
+void JobSystem::WorkerMain(uint32_t threadIndex)
+{
+	t_threadIndex = threadIndex;
+	CD_PROFILE_THREAD(("Worker " + std::to_string(threadIndex)).c_str());
+
+	while (m_isRunning.load(std::memory_order_acquire))
+	{
+		if (Job* pJob = FindJob(threadIndex))
+		{
+			Execute(pJob);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_sleepingWorkerCount.fetch_add(1U);
+		m_wakeCondition.wait(lock, [this]()
+		{
+			return m_pendingJobCount.load() > 0U || !m_isRunning.load(std::memory_order_acquire);
+		});
+		m_sleepingWorkerCount.fetch_sub(1U);
+	}
+}
+
+Job* JobSystem::AllocateJob(ThreadContext& context)
+{
+	// Ring buffer. Only the owner thread allocates from its pool so no lock is needed.
+	// Slots of jobs which are still queued or running are skipped, never overwritten.
+	for (uint32_t slotIndex = 0U; slotIndex < MaxJobCountPerThread; ++slotIndex)
+	{
+		Job* pJob = &context.jobPool[context.nextJobIndex & (MaxJobCountPerThread - 1U)];
+		++context.nextJobIndex;
+		if (!pJob->isPending.load(std::memory_order_acquire))
+		{
+			pJob->isPending.store(true, std::memory_order_relaxed);
+			return pJob;
+		}
+	}
+
+	return nullptr;
+}
+
+Job* JobSystem::FindJob(uint32_t threadIndex)
+{
+	ThreadContext& context = m_threadContexts[threadIndex];
+	Job* pJob = context.jobQueue.Pop();
+	if (!pJob && m_threadCount > 1U)
+	{
+		// Start from a random victim so that thieves don't all hit the same queue.
+		uint32_t victimOffset = NextRandom(context.randomSeed) % m_threadCount;
+		for (uint32_t victimIndex = 0U; victimIndex < m_threadCount && !pJob; ++victimIndex)
+		{
+			uint32_t victimThreadIndex = (victimOffset + victimIndex) % m_threadCount;
+			if (victimThreadIndex != threadIndex)
+			{
+				pJob = m_threadContexts[victimThreadIndex].jobQueue.Steal();
+			}
+		}
+	}
+
+	if (pJob)
+	{
+		m_pendingJobCount.fetch_sub(1U);
+	}
+
+	return pJob;
+}
+
+void JobSystem::Execute(Job* pJob)
+{
+	pJob->function();
+	pJob->function = nullptr;
+
+	// The job slot can be reused as soon as it is not pending so read the counter first.
+	JobCounter* pCounter = pJob->pCounter;
+	pJob->isPending.store(false, std::memory_order_release);
+	if (pCounter)
+	{
+		pCounter->Decrement();
+	}
+}
+
+}
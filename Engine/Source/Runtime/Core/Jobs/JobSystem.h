@@ -0,0 +1,157 @@
+#pragma once
+
+#include "Core/Jobs/WorkStealingQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace engine
+{
+
+using JobFunction = std::function<void()>;
+
+// JobCounter tracks how many jobs are still in flight.
+// Pass the same counter to a group of jobs and wait on it to express a dependency.
+class JobCounter final
+{
+public:
+	JobCounter() = default;
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+	JobCounter(JobCounter&&) = delete;
+	JobCounter& operator=(JobCounter&&) = delete;
+	~JobCounter() = default;
+
+	void Add(uint32_t count) { m_value.fetch_add(count, std::memory_order_relaxed); }
+	void Decrement() { m_value.fetch_sub(1U, std::memory_order_release); }
+	uint32_t GetValue() const { return m_value.load(std::memory_order_acquire); }
+	bool IsDone() const { return 0U == GetValue(); }
+
+private:
+	std::atomic<uint32_t> m_value = 0U;
+};
+
+struct Job
+{
+	JobFunction function;
+	JobCounter* pCounter = nullptr;
+	std::atomic<bool> isPending = false;
+};
+
+// JobSystem is a work-stealing scheduler.
+// Every thread has its own job deque. Idle threads steal from others. Waiting threads help to execute jobs
+// instead of blocking so that nested jobs never deadlock and no fiber is needed.
+// Thread index 0 is the main thread which owns bgfx and window calls. Use RunOnMainThread for those.
+class JobSystem final
+{
+public:
+	static constexpr uint32_t MaxThreadCount = 64U;
+	static constexpr uint32_t MaxJobCountPerThread = 4096U;
+	static constexpr uint32_t MainThreadIndex = 0U;
+	// Threads which are not created by the job system and did not call Init.
+	static constexpr uint32_t InvalidThreadIndex = UINT32_MAX;
+	// More batches than this don't balance better and only fill the job pool.
+	static constexpr uint32_t MaxParallelForBatchCount = MaxJobCountPerThread / 4U;
+
+public:
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+	JobSystem(JobSystem&&) = delete;
+	JobSystem& operator=(JobSystem&&) = delete;
+
+	static JobSystem& Get()
+	{
+		static JobSystem s_instance;
+		return s_instance;
+	}
+
+	// The calling thread becomes the main thread. threadCount includes the main thread. 0 means hardware_concurrency but at least one worker.
+	void Init(uint32_t threadCount = 0U);
+	void Shutdown();
+	bool IsInitialized() const { return m_isRunning.load(std::memory_order_acquire); }
+
+	// Main thread and worker threads.
+	uint32_t GetThreadCount() const { return m_threadCount; }
+	uint32_t GetWorkerCount() const { return m_threadCount - 1U; }
+	static uint32_t GetThreadIndex();
+	// Before Init every thread counts as the main thread.
+	static bool IsMainThread();
+
+	// Can be called from the main thread or a worker thread. Other threads execute the job in place.
+	void Run(JobFunction function, JobCounter* pCounter = nullptr);
+
+	// Execute other jobs until counter reaches zero.
+	void Wait(const JobCounter& counter);
+
+	// Split [0, count) into batches and run them on all threads. Blocks until finished.
+	// batchSize 0 picks a batch size which produces a few batches per thread.
+	// batchSize grows when the batch count would exceed MaxParallelForBatchCount.
+	template<typename Func>
+	void ParallelFor(uint32_t count, uint32_t batchSize, const Func& func)
+	{
+		if (0U == count)
+		{
+			return;
+		}
+
+		if (0U == batchSize)
+		{
+			batchSize = std::max(1U, count / (m_threadCount * 4U));
+		}
+		batchSize = std::max(batchSize, (count - 1U) / MaxParallelForBatchCount + 1U);
+
+		JobCounter counter;
+		for (uint32_t begin = 0U; begin < count; begin += batchSize)
+		{
+			uint32_t end = std::min(begin + batchSize, count);
+			Run([&func, begin, end]() { func(begin, end); }, &counter);
+		}
+		Wait(counter);
+	}
+
+	// Jobs which must run on the main thread such as bgfx resource creation.
+	// They are executed in ProcessMainThreadJobs and inside Wait on the main thread.
+	void RunOnMainThread(JobFunction function, JobCounter* pCounter = nullptr);
+	void ProcessMainThreadJobs();
+
+private:
+	struct ThreadContext
+	{
+		WorkStealingQueue<Job*, MaxJobCountPerThread> jobQueue;
+		std::unique_ptr<Job[]> jobPool;
+		uint32_t nextJobIndex = 0U;
+		uint32_t randomSeed = 0U;
+	};
+
+	JobSystem() = default;
+	~JobSystem();
+
+	void WorkerMain(uint32_t threadIndex);
+	Job* AllocateJob(ThreadContext& context);
+	Job* FindJob(uint32_t threadIndex);
+	void Execute(Job* pJob);
+
+private:
+	std::atomic<bool> m_isRunning = false;
+	uint32_t m_threadCount = 1U;
+	std::unique_ptr<ThreadContext[]> m_threadContexts;
+	std::vector<std::thread> m_workerThreads;
+
+	// Sleep workers when there is nothing to do.
+	std::atomic<uint32_t> m_pendingJobCount = 0U;
+	std::atomic<uint32_t> m_sleepingWorkerCount = 0U;
+	std::mutex m_sleepMutex;
+	std::condition_variable m_wakeCondition;
+
+	std::mutex m_mainThreadJobMutex;
+	std::vector<std::pair<JobFunction, JobCounter*>> m_mainThreadJobs;
+};
+
+}
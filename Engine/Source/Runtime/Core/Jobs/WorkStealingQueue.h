@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace engine
+{
+
+// Bounded Chase-Lev deque.
+// The owner thread pushes and pops at the bottom in LIFO order to keep caches warm.
+// Other threads steal from the top in FIFO order so that the oldest and usually biggest tasks move away first.
+template<typename T, uint32_t Capacity>
+class WorkStealingQueue final
+{
+public:
+	static_assert(Capacity > 0U && 0U == (Capacity & (Capacity - 1U)), "Capacity should be power of two.");
+	static constexpr int64_t Mask = static_cast<int64_t>(Capacity) - 1;
+
+public:
+	WorkStealingQueue() = default;
+	WorkStealingQueue(const WorkStealingQueue&) = delete;
+	WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+	WorkStealingQueue(WorkStealingQueue&&) = delete;
+	WorkStealingQueue& operator=(WorkStealingQueue&&) = delete;
+	~WorkStealingQueue() = default;
+
+	// Owner thread only. Returns false when the queue is full.
+	bool Push(T item)
+	{
+		int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+		int64_t top = m_top.load(std::memory_order_acquire);
+		if (bottom - top >= static_cast<int64_t>(Capacity))
+		{
+			return false;
+		}
+
+		m_items[bottom & Mask].store(item, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Owner thread only. Returns nullptr when the queue is empty or the last item was stolen.
+	T Pop()
+	{
+		int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+		m_bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t top = m_top.load(std::memory_order_relaxed);
+
+		if (top > bottom)
+		{
+			// Empty.
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		T item = m_items[bottom & Mask].load(std::memory_order_relaxed);
+		if (top == bottom)
+		{
+			// Last item. Race with stealers.
+			if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				item = nullptr;
+			}
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+
+		return item;
+	}
+
+	// Any thread. Returns nullptr when the queue is empty or another thread wins the race.
+	T Steal()
+	{
+		int64_t top = m_top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t bottom = m_bottom.load(std::memory_order_acquire);
+		if (top >= bottom)
+		{
+			return nullptr;
+		}
+
+		T item = m_items[top & Mask].load(std::memory_order_relaxed);
+		if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			return nullptr;
+		}
+
+		return item;
+	}
+
+	bool IsEmpty() const
+	{
+		return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+	}
+
+private:
+	alignas(64) std::atomic<int64_t> m_top = 0;
+	alignas(64) std::atomic<int64_t> m_bottom = 0;
+	std::atomic<T> m_items[Capacity];
+};
+
+}
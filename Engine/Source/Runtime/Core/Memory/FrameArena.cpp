@@ -0,0 +1,135 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+namespace engine
+{
+
+namespace
+{
+
+constexpr size_t BlockAlignment = alignof(std::max_align_t);
+
+size_t AlignUp(size_t value, size_t alignment)
+{
+	return (value + alignment - 1U) & ~(alignment - 1U);
+}
+
+struct ThreadArena
+{
+	LinearArena arena;
+	uint64_t frameIndex = 0U;
+};
+
+ThreadArena& GetThreadArenaContext()
+{
+	thread_local ThreadArena t_threadArena;
+	return t_threadArena;
+}
+
+}
+
+std::atomic<uint64_t> LinearArena::s_heapAllocationCount = 0U;
+std::atomic<uint64_t> FrameArena::s_frameIndex = 0U;
+
+LinearArena::LinearArena(size_t blockSize)
+	: m_blockSize(blockSize)
+{
+	assert(blockSize > 0U);
+}
+
+LinearArena::~LinearArena()
+{
+	FreeBlocks();
+}
+
+void* LinearArena::Allocate(size_t size, size_t alignment)
+{
+	assert(0U == (alignment & (alignment - 1U)) && "Alignment should be power of two.");
+	size = std::max<size_t>(size, 1U);
+
+	while (m_blockIndex < m_blocks.size())
+	{
+		const Block& block = m_blocks[m_blockIndex];
+		const uintptr_t address = reinterpret_cast<uintptr_t>(block.pData) + m_blockOffset;
+		const size_t padding = AlignUp(address, alignment) - address;
+		if (m_blockOffset + padding + size <= block.size)
+		{
+			std::byte* pMemory = block.pData + m_blockOffset + padding;
+			m_blockOffset += padding + size;
+			m_usedSize += padding + size;
+			return pMemory;
+		}
+
+		++m_blockIndex;
+		m_blockOffset = 0U;
+	}
+
+	AddBlock(size + alignment);
+	return Allocate(size, alignment);
+}
+
+void LinearArena::Reset()
+{
+	if (m_blocks.size() > 1U)
+	{
+		// Merge blocks so that next frame with the same allocations doesn't need to grow again.
+		size_t capacity = GetCapacity();
+		FreeBlocks();
+		AddBlock(capacity);
+	}
+
+	m_blockIndex = 0U;
+	m_blockOffset = 0U;
+	m_usedSize = 0U;
+}
+
+size_t LinearArena::GetCapacity() const
+{
+	size_t capacity = 0U;
+	for (const Block& block : m_blocks)
+	{
+		capacity += block.size;
+	}
+
+	return capacity;
+}
+
+void LinearArena::AddBlock(size_t minSize)
+{
+	size_t blockSize = AlignUp(std::max(minSize, m_blockSize), BlockAlignment);
+	auto* pData = static_cast<std::byte*>(::operator new(blockSize, std::align_val_t{ BlockAlignment }));
+	m_blocks.push_back({ pData, blockSize });
+	s_heapAllocationCount.fetch_add(1U, std::memory_order_relaxed);
+}
+
+void LinearArena::FreeBlocks()
+{
+	for (const Block& block : m_blocks)
+	{
+		::operator delete(block.pData, std::align_val_t{ BlockAlignment });
+	}
+	m_blocks.clear();
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	return GetThreadArena().Allocate(size, alignment);
+}
+
+LinearArena& FrameArena::GetThreadArena()
+{
+	ThreadArena& threadArena = GetThreadArenaContext();
+	const uint64_t frameIndex = GetFrameIndex();
+	if (threadArena.frameIndex != frameIndex)
+	{
+		threadArena.arena.Reset();
+		threadArena.frameIndex = frameIndex;
+	}
+
+	return threadArena.arena;
+}
+
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace engine
+{
+
+// LinearArena hands out memory by bumping an offset inside large blocks. Single allocations are never freed,
+// Reset releases everything at once and keeps the blocks for reuse.
+class LinearArena final
+{
+public:
+	static constexpr size_t DefaultBlockSize = 256U * 1024U;
+
+public:
+	explicit LinearArena(size_t blockSize = DefaultBlockSize);
+	LinearArena(const LinearArena&) = delete;
+	LinearArena& operator=(const LinearArena&) = delete;
+	LinearArena(LinearArena&&) = delete;
+	LinearArena& operator=(LinearArena&&) = delete;
+	~LinearArena();
+
+	// alignment should be a power of two.
+	void* Allocate(size_t size, size_t alignment);
+
+	// Blocks which were used since the last reset are merged into one so that the same amount of
+	// allocations fits into one block next time without touching the heap.
+	void Reset();
+
+	size_t GetUsedSize() const { return m_usedSize; }
+	size_t GetCapacity() const;
+
+	// Number of blocks which all LinearArenas requested from the heap.
+	static uint64_t GetHeapAllocationCount() { return s_heapAllocationCount.load(std::memory_order_relaxed); }
+
+private:
+	struct Block
+	{
+		std::byte* pData;
+		size_t size;
+	};
+
+	void AddBlock(size_t minSize);
+	void FreeBlocks();
+
+private:
+	static std::atomic<uint64_t> s_heapAllocationCount;
+
+	size_t m_blockSize;
+	std::vector<Block> m_blocks;
+	size_t m_blockIndex = 0U;
+	size_t m_blockOffset = 0U;
+	size_t m_usedSize = 0U;
+};
+
+// FrameArena owns one LinearArena per thread for data which only lives in the current frame,
+// e.g. temporary arrays and strings built while recording draw calls.
+// RenderContext::BeginFrame starts a new frame. Every thread resets its own arena on the first allocation
+// in the new frame so no thread touches another one. Frame memory must not be kept across BeginFrame.
+class FrameArena final
+{
+public:
+	FrameArena() = delete;
+
+	// Main thread. Memory allocated in previous frames is invalid afterwards.
+	static void BeginFrame() { s_frameIndex.fetch_add(1U, std::memory_order_release); }
+	static uint64_t GetFrameIndex() { return s_frameIndex.load(std::memory_order_acquire); }
+
+	// Any thread. Allocates from the arena of the calling thread.
+	static void* Allocate(size_t size, size_t alignment);
+
+	// Arena of the calling thread. It is reset on the first allocation of a new frame.
+	static LinearArena& GetThreadArena();
+
+private:
+	static std::atomic<uint64_t> s_frameIndex;
+};
+
+// STL allocator on top of FrameArena. deallocate does nothing so prefer reserve for growing containers.
+template<typename T>
+class FrameAllocator
+{
+public:
+	using value_type = T;
+
+	FrameAllocator() noexcept = default;
+	template<typename U>
+	FrameAllocator(const FrameAllocator<U>&) noexcept {}
+
+	T* allocate(size_t count) { return static_cast<T*>(FrameArena::Allocate(count * sizeof(T), alignof(T))); }
+	void deallocate(T*, size_t) noexcept {}
+
+	template<typename U>
+	bool operator==(const FrameAllocator<U>&) const noexcept { return true; }
+	template<typename U>
+	bool operator!=(const FrameAllocator<U>&) const noexcept { return false; }
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+using FrameString = std::basic_string<char, std::char_traits<char>, FrameAllocator<char>>;
+
+}
@@ -0,0 +1,190 @@
+#include "MemoryTracker.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+
+namespace engine
+{
+
+namespace
+{
+
+struct AllocationHeader
+{
+	uint64_t size;
+	// Distance from the start of the malloc block to the user memory.
+	uint32_t offset;
+	MemoryTag tag;
+};
+static_assert(sizeof(AllocationHeader) <= MemoryTracker::HeaderSize);
+
+// Counters of different tags are on different cache lines so that threads working for different subsystems don't contend.
+struct alignas(64) TagCounters
+{
+	std::atomic<int64_t> liveBytes = 0;
+	std::atomic<int64_t> peakBytes = 0;
+	std::atomic<uint64_t> allocationCount = 0U;
+	std::atomic<uint64_t> freeCount = 0U;
+};
+
+constexpr size_t TagCount = static_cast<size_t>(MemoryTag::Count);
+TagCounters g_tagCounters[TagCount];
+
+thread_local MemoryTag t_threadTag = MemoryTag::Untagged;
+
+constexpr const char* TagNames[] =
+{
+	"Untagged",
+	"Scene",
+	"Resources",
+	"ECS",
+	"Rendering",
+	"Editor",
+	"ImGui",
+};
+static_assert(sizeof(TagNames) / sizeof(TagNames[0]) == TagCount);
+
+void UpdatePeak(std::atomic<int64_t>& peakBytes, int64_t liveBytes)
+{
+	int64_t peak = peakBytes.load(std::memory_order_relaxed);
+	while (liveBytes > peak && !peakBytes.compare_exchange_weak(peak, liveBytes, std::memory_order_relaxed))
+	{
+	}
+}
+
+MemoryTagStats LoadStats(const TagCounters& counters)
+{
+	MemoryTagStats stats;
+	stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+	stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+	stats.allocationCount = counters.allocationCount.load(std::memory_order_relaxed);
+	stats.freeCount = counters.freeCount.load(std::memory_order_relaxed);
+	return stats;
+}
+
+}
+
+void* MemoryTracker::Allocate(size_t size, size_t alignment)
+{
+	assert(0U == (alignment & (alignment - 1U)) && "Alignment should be power of two.");
+
+	// The header sits right before the user memory inside the alignment padding.
+	alignment = std::max(alignment, HeaderSize);
+	std::byte* pBlock = static_cast<std::byte*>(std::malloc(size + HeaderSize + alignment - alignof(std::max_align_t)));
+	if (!pBlock)
+	{
+		return nullptr;
+	}
+
+	const uintptr_t blockAddress = reinterpret_cast<uintptr_t>(pBlock);
+	const uintptr_t userAddress = (blockAddress + HeaderSize + alignment - 1U) & ~static_cast<uintptr_t>(alignment - 1U);
+	std::byte* pMemory = pBlock + (userAddress - blockAddress);
+
+	const MemoryTag tag = t_threadTag;
+	auto* pHeader = reinterpret_cast<AllocationHeader*>(pMemory - HeaderSize);
+	pHeader->size = size;
+	pHeader->offset = static_cast<uint32_t>(userAddress - blockAddress);
+	pHeader->tag = tag;
+
+	TagCounters& counters = g_tagCounters[static_cast<size_t>(tag)];
+	const int64_t liveBytes = counters.liveBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) + static_cast<int64_t>(size);
+	counters.allocationCount.fetch_add(1U, std::memory_order_relaxed);
+	UpdatePeak(counters.peakBytes, liveBytes);
+
+	return pMemory;
+}
+
+void MemoryTracker::Free(void* pMemory)
+{
+	if (!pMemory)
+	{
+		return;
+	}
+
+	std::byte* pUserMemory = static_cast<std::byte*>(pMemory);
+	const auto* pHeader = reinterpret_cast<const AllocationHeader*>(pUserMemory - HeaderSize);
+
+	// Freed memory is accounted to the tag it was allocated with even on another thread.
+	TagCounters& counters = g_tagCounters[static_cast<size_t>(pHeader->tag)];
+	counters.liveBytes.fetch_sub(static_cast<int64_t>(pHeader->size), std::memory_order_relaxed);
+	counters.freeCount.fetch_add(1U, std::memory_order_relaxed);
+
+	std::free(pUserMemory - pHeader->offset);
+}
+
+MemoryTag MemoryTracker::GetThreadTag()
+{
+	return t_threadTag;
+}
+
+void MemoryTracker::SetThreadTag(MemoryTag tag)
+{
+	t_threadTag = tag;
+}
+
+const char* MemoryTracker::GetTagName(MemoryTag tag)
+{
+	return TagNames[static_cast<size_t>(tag)];
+}
+
+MemoryTagStats MemoryTracker::GetStats(MemoryTag tag)
+{
+	return LoadStats(g_tagCounters[static_cast<size_t>(tag)]);
+}
+
+MemoryTagStats MemoryTracker::GetTotalStats()
+{
+	// Sum of peaks of all tags. Tags don't peak at the same time so it is an upper bound of the real peak.
+	MemoryTagStats totalStats;
+	for (const TagCounters& counters : g_tagCounters)
+	{
+		MemoryTagStats stats = LoadStats(counters);
+		totalStats.liveBytes += stats.liveBytes;
+		totalStats.peakBytes += stats.peakBytes;
+		totalStats.allocationCount += stats.allocationCount;
+		totalStats.freeCount += stats.freeCount;
+	}
+
+	return totalStats;
+}
+
+void MemoryTracker::ResetPeaks()
+{
+	for (TagCounters& counters : g_tagCounters)
+	{
+		counters.peakBytes.store(counters.liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+}
+
+bool MemoryTracker::DumpToFile(const char* pFilePath)
+{
+	// C stdio so that dumping doesn't allocate through the tracker while reading it.
+	FILE* pFile = std::fopen(pFilePath, "w");
+	if (!pFile)
+	{
+		return false;
+	}
+
+	std::fprintf(pFile, "%-12s %16s %16s %16s %16s %16s\n", "Tag", "LiveBytes", "PeakBytes", "LiveAllocations", "Allocations", "Frees");
+	auto writeRow = [pFile](const char* pName, const MemoryTagStats& stats)
+	{
+		std::fprintf(pFile, "%-12s %16" PRId64 " %16" PRId64 " %16" PRId64 " %16" PRIu64 " %16" PRIu64 "\n",
+			pName, stats.liveBytes, stats.peakBytes,
+			static_cast<int64_t>(stats.allocationCount - stats.freeCount), stats.allocationCount, stats.freeCount);
+	};
+
+	for (size_t tagIndex = 0U; tagIndex < TagCount; ++tagIndex)
+	{
+		MemoryTag tag = static_cast<MemoryTag>(tagIndex);
+		writeRow(GetTagName(tag), GetStats(tag));
+	}
+	writeRow("Total", GetTotalStats());
+
+	std::fclose(pFile);
+	return true;
+}
+
+}
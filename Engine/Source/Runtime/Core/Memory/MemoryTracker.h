@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace engine
+{
+
+// Subsystems which memory is accounted to. Allocations outside of any tag scope are Untagged.
+enum class MemoryTag : uint8_t
+{
+	Untagged,
+	Scene,		// cd::SceneDatabase contents.
+	Resources,	// Mesh, texture, shader and skeleton resources including CPU copies of render data.
+	ECS,		// Entities and components.
+	Rendering,	// Renderers and their per frame data such as particle pools.
+	Editor,
+	ImGui,
+	Count
+};
+
+struct MemoryTagStats
+{
+	int64_t liveBytes = 0;
+	int64_t peakBytes = 0;
+	uint64_t allocationCount = 0U;
+	uint64_t freeCount = 0U;
+};
+
+// MemoryTracker accounts heap memory to the MemoryTag of the calling thread.
+// Allocate stores the size and the tag in a small header in front of the memory so that Free can account it
+// to the right tag from any thread. Global operator new is routed here by CD_MEMORY_TRACKING_OVERRIDE_NEW
+// in the executable, ImGui is routed by ImGuiContextInstance.
+class MemoryTracker final
+{
+public:
+	// Bytes in front of every tracked allocation.
+	static constexpr size_t HeaderSize = 16U;
+
+public:
+	MemoryTracker() = delete;
+
+	static void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+	static void Free(void* pMemory);
+
+	static MemoryTag GetThreadTag();
+	static void SetThreadTag(MemoryTag tag);
+
+	static const char* GetTagName(MemoryTag tag);
+	static MemoryTagStats GetStats(MemoryTag tag);
+	static MemoryTagStats GetTotalStats();
+
+	// Peak bytes restart from live bytes.
+	static void ResetPeaks();
+
+	// Text table of all tags.
+	static bool DumpToFile(const char* pFilePath);
+};
+
+// Accounts allocations of the calling thread to a tag until the end of the scope. Scopes can be nested.
+class MemoryTagScope final
+{
+public:
+	explicit MemoryTagScope(MemoryTag tag)
+		: m_previousTag(MemoryTracker::GetThreadTag())
+	{
+		MemoryTracker::SetThreadTag(tag);
+	}
+
+	MemoryTagScope(const MemoryTagScope&) = delete;
+	MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+	MemoryTagScope(MemoryTagScope&&) = delete;
+	MemoryTagScope& operator=(MemoryTagScope&&) = delete;
+
+	~MemoryTagScope()
+	{
+		MemoryTracker::SetThreadTag(m_previousTag);
+	}
+
+private:
+	MemoryTag m_previousTag;
+};
+
+}
+
+// Compiled out when ENABLE_MEMORY_TRACKING is not defined. Then there is no header and no counter per allocation.
+#ifdef ENABLE_MEMORY_TRACKING
+#define CD_MEMORY_CONCAT_IMPL(a, b) a##b
+#define CD_MEMORY_CONCAT(a, b) CD_MEMORY_CONCAT_IMPL(a, b)
+#define CD_MEMORY_TAG_SCOPE(tag) engine::MemoryTagScope CD_MEMORY_CONCAT(memoryTagScope, __LINE__)(engine::MemoryTag::tag)
+
+#define CD_MEMORY_ALLOCATE_OR_THROW(...) \
+	if (void* pMemory = engine::MemoryTracker::Allocate(__VA_ARGS__)) { return pMemory; } \
+	throw std::bad_alloc();
+
+// Use once in a source file of the executable which is built with exceptions. Replaces all global new and delete operators.
+#define CD_MEMORY_TRACKING_OVERRIDE_NEW() \
+	void* operator new(size_t size) { CD_MEMORY_ALLOCATE_OR_THROW(size) } \
+	void* operator new[](size_t size) { CD_MEMORY_ALLOCATE_OR_THROW(size) } \
+	void* operator new(size_t size, const std::nothrow_t&) noexcept { return engine::MemoryTracker::Allocate(size); } \
+	void* operator new[](size_t size, const std::nothrow_t&) noexcept { return engine::MemoryTracker::Allocate(size); } \
+	void* operator new(size_t size, std::align_val_t alignment) { CD_MEMORY_ALLOCATE_OR_THROW(size, static_cast<size_t>(alignment)) } \
+	void* operator new[](size_t size, std::align_val_t alignment) { CD_MEMORY_ALLOCATE_OR_THROW(size, static_cast<size_t>(alignment)) } \
+	void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return engine::MemoryTracker::Allocate(size, static_cast<size_t>(alignment)); } \
+	void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return engine::MemoryTracker::Allocate(size, static_cast<size_t>(alignment)); } \
+	void operator delete(void* pMemory) noexcept { engine::MemoryTracker::Free(pMemory); } \
+	void operator delete[](void* pMemory) noexcept { engine::MemoryTracker::Free(pMemory); } \
+	void operator delete(void* pMemory, size_t) noexcept { engine::MemoryTracker::Free(pMemory); } \
+	void operator delete[](void* pMemory, size_t) noexcept { engine::MemoryTracker::Free(pMemory); } \
+	void operator delete(void* pMemory, const std::nothrow_t&) noexcept { engine::MemoryTracker::Free(pMemory); } \
+	void operator delete[](void* pMemory, const std::nothrow_t&) noexcept { engine::MemoryTracker::Free(pMemory); } \
+	void operator delete(void* pMemory, std::align_val_t) noexcept { engine::MemoryTracker::Free(pMemory); } \
+	void operator delete[](void* pMemory, std::align_val_t) noexcept { engine::MemoryTracker::Free(pMemory); } \
+	void operator delete(void* pMemory, size_t, std::align_val_t) noexcept { engine::MemoryTracker::Free(pMemory); } \
+	void operator delete[](void* pMemory, size_t, std::align_val_t) noexcept { engine::MemoryTracker::Free(pMemory); } \
+	void operator delete(void* pMemory, std::align_val_t, const std::nothrow_t&) noexcept { engine::MemoryTracker::Free(pMemory); } \
+	void operator delete[](void* pMemory, std::align_val_t, const std::nothrow_t&) noexcept { engine::MemoryTracker::Free(pMemory); }
+#else
+#define CD_MEMORY_TAG_SCOPE(tag)
+#define CD_MEMORY_TRACKING_OVERRIDE_NEW()
+#endif
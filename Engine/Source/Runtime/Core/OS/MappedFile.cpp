@@ -0,0 +1,150 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#if CD_PLATFORM_WINDOWS
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace engine
+{
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		Close();
+		m_pData = std::exchange(other.m_pData, nullptr);
+		m_size = std::exchange(other.m_size, 0U);
+#if CD_PLATFORM_WINDOWS
+		m_fileHandle = std::exchange(other.m_fileHandle, nullptr);
+		m_mappingHandle = std::exchange(other.m_mappingHandle, nullptr);
+#endif
+	}
+
+	return *this;
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#if CD_PLATFORM_WINDOWS
+
+bool MappedFile::Open(const char* pFilePath)
+{
+	Close();
+
+	HANDLE fileHandle = ::CreateFileA(pFilePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (INVALID_HANDLE_VALUE == fileHandle)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!::GetFileSizeEx(fileHandle, &fileSize) || 0 == fileSize.QuadPart)
+	{
+		::CloseHandle(fileHandle);
+		return false;
+	}
+
+	HANDLE mappingHandle = ::CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mappingHandle)
+	{
+		::CloseHandle(fileHandle);
+		return false;
+	}
+
+	void* pView = ::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (!pView)
+	{
+		::CloseHandle(mappingHandle);
+		::CloseHandle(fileHandle);
+		return false;
+	}
+
+	m_pData = static_cast<const std::byte*>(pView);
+	m_size = static_cast<size_t>(fileSize.QuadPart);
+	m_fileHandle = fileHandle;
+	m_mappingHandle = mappingHandle;
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_pData)
+	{
+		::UnmapViewOfFile(m_pData);
+		::CloseHandle(m_mappingHandle);
+		::CloseHandle(m_fileHandle);
+	}
+
+	m_pData = nullptr;
+	m_size = 0U;
+	m_fileHandle = nullptr;
+	m_mappingHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const char* pFilePath)
+{
+	Close();
+
+	int fileDescriptor = ::open(pFilePath, O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStat;
+	if (::fstat(fileDescriptor, &fileStat) != 0 || 0 == fileStat.st_size)
+	{
+		::close(fileDescriptor);
+		return false;
+	}
+
+	void* pView = ::mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	// The mapping keeps its own reference to the file.
+	::close(fileDescriptor);
+	if (MAP_FAILED == pView)
+	{
+		return false;
+	}
+
+	m_pData = static_cast<const std::byte*>(pView);
+	m_size = static_cast<size_t>(fileStat.st_size);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_pData)
+	{
+		::munmap(const_cast<std::byte*>(m_pData), m_size);
+	}
+
+	m_pData = nullptr;
+	m_size = 0U;
+}
+
+#endif
+
+}
@@ -81,6 +81,15 @@ public:
 
 	bool& IsPlaying() { return m_playAnimation; }
 
+	// Running time advances in fixed simulation steps. Rendering blends the last two steps.
+	void AdvanceRunningTime(float deltaTime)
+	{
+		m_previousRunningTime = m_runningTime;
+		m_runningTime += deltaTime;
+	}
+	float GetRunningTime() const { return m_runningTime; }
+	float GetInterpolatedRunningTime(float alpha) const { return m_previousRunningTime + (m_runningTime - m_previousRunningTime) * alpha; }
+
 private:
 	AnimationClip m_clip = AnimationClip::Idle;
 	const cd::Animation* m_pAnimation = nullptr;
@@ -91,6 +100,8 @@ private:
 	bool m_playAnimation;
 
 	float m_animationPlayTime;
+	float m_runningTime = 0.0f;
+	float m_previousRunningTime = 0.0f;
 	float m_duration;
 	float m_ticksPerSecond;
 	uint16_t m_boneMatricesUniform;
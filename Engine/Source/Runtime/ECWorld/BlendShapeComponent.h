@@ -6,7 +6,6 @@
 
 #include <cstdint>
 #include <vector>
-#include <map>
 
 namespace cd
 {
@@ -39,61 +38,42 @@ public:
 	~BlendShapeComponent() = default;
 
 	void SetMesh(const cd::Mesh* mesh) { m_pMesh = mesh; m_meshVertexCount = m_pMesh->GetVertexCount();}
-	const uint32_t GetMeshVertexCount() { return m_meshVertexCount; }
+	const cd::Mesh* GetMesh() const { return m_pMesh; }
+	uint32_t GetMeshVertexCount() const { return m_meshVertexCount; }
 
 	void AddMorph(const cd::Morph* pMorph) { m_pMorphsData.push_back(pMorph); }
-	const cd::Morph* GetMorphData(uint32_t index) { return m_pMorphsData[index]; }
+	const cd::Morph* GetMorphData(uint32_t index) const { return m_pMorphsData[index]; }
 	uint32_t GetMorphCount() const { return static_cast<uint32_t>(m_pMorphsData.size()); }
-	uint32_t GetActiveMorphCount() const { return m_activeMorphCount; }
-	
-	std::vector<float>& GetWeights() { return m_weights; };
 
-	bool IsDirty() { return m_isDirty; }
+	// BlendShapeRenderer only evaluates meshes whose weights changed since its last frame.
+	const std::vector<float>& GetWeights() const { return m_weights; }
+	float GetWeight(uint32_t morphIndex) const { return m_weights[morphIndex]; }
+	void SetWeight(uint32_t morphIndex, float weight) { m_weights[morphIndex] = weight; m_isDirty = true; }
+
+	bool IsDirty() const { return m_isDirty; }
 	void SetDirty(bool isDirty) { m_isDirty = isDirty; }
-	
-	bool NeedUpdate() { return 0U != m_needUpdates.size(); }
-	void AddNeedUpdate(uint32_t index, float weight) { m_needUpdates[index] = weight; }
-	void ClearNeedUpdate() { m_needUpdates.clear(); }
 
+	// Morphed positions are a range of the vertex buffer which BlendShapeRenderer shares between all meshes.
 	uint16_t GetFinalMorphAffectedVB() const { return m_finalMorphAffectedVBHandle; }
-	uint16_t GetMorphAffectedVB() const { return m_morphAffectedVBHandle; }
+	uint32_t GetFinalMorphAffectedFirstVertex() const { return m_finalMorphAffectedFirstVertex; }
+	void SetFinalMorphAffectedVB(uint16_t handle, uint32_t firstVertex) { m_finalMorphAffectedVBHandle = handle; m_finalMorphAffectedFirstVertex = firstVertex; }
 	uint16_t GetNonMorphAffectedVB() const { return m_nonMorphAffectedVBHandle; }
-	uint16_t GetAllMorphVertexIDIB() const { return m_allMorphVertexIDPosIBHandle; }
-	uint16_t GetActiveMorphOffestLengthWeightIB() const { return m_activeMorphOffestLengthWeightIBHandle; }
-	uint16_t GetChangedMorphIndexIB() const { return m_changedMorphIndexIBHandle; }
 
-	void Reset();
 	void Build();
-	void Update();
-	void UpdateChanged();
 
 private:
 	//input
-	const cd::Mesh* m_pMesh;
+	const cd::Mesh* m_pMesh = nullptr;
 	std::vector<const cd::Morph*> m_pMorphsData;
 	std::vector<float> m_weights;
 	
 	uint32_t m_meshVertexCount = 0U;
-	uint32_t m_activeMorphCount = 0U;
-	uint32_t m_morphVertexCountSum = 0U;
+	bool m_isDirty = false;
 
-	bool m_isDirty;
-	std::map<uint32_t, float> m_needUpdates;
-	//uint32_t m_needUpdate;
-	
-	//float m_updatedWeight = 0.0f;
-	
-	std::vector<std::byte>	m_morphAffectedVB;								
-	uint16_t						m_morphAffectedVBHandle = UINT16_MAX;							// Vertex Buffer | Compute Input
 	std::vector<std::byte>	m_nonMorphAffectedVB;
 	uint16_t						m_nonMorphAffectedVBHandle = UINT16_MAX;					// Vertex Buffer | Vertex Input
-	uint16_t						m_finalMorphAffectedVBHandle = UINT16_MAX;					// Dynamic Vertex Buffer | Compute Output | Vertex Input
-	std::vector<std::byte>	m_allMorphVertexIDPosIB;												
-	uint16_t						m_allMorphVertexIDPosIBHandle = UINT16_MAX;					// Index Buffer | Compute Input
-	std::vector<std::byte>	m_activeMorphOffestLengthWeightIB;							
-	uint16_t						m_activeMorphOffestLengthWeightIBHandle = UINT16_MAX;	//	Dynamic Index Buffer	| Compute Input
-	std::vector<std::byte>	m_changedMorphIndexIB;
-	uint16_t						m_changedMorphIndexIBHandle = UINT16_MAX;					//	Dynamic Index Buffer	| Compute Input
+	uint16_t						m_finalMorphAffectedVBHandle = UINT16_MAX;					// Shared Dynamic Vertex Buffer | Compute Output | Vertex Input
+	uint32_t						m_finalMorphAffectedFirstVertex = 0U;
 };
 
 }
\ No newline at end of file
@@ -62,6 +62,22 @@ public:
 		return m_components.back();
 	}
 
+	// Create default components for a batch of entities at once. Returns the first one, others follow contiguously.
+	Component* CreateComponents(const Entity* pEntities, size_t count)
+	{
+		const size_t firstIndex = m_components.size();
+		m_entities.insert(m_entities.end(), pEntities, pEntities + count);
+		m_components.resize(firstIndex + count);
+		m_entityToIndex.reserve(m_entityToIndex.size() + count);
+		for (size_t index = 0; index < count; ++index)
+		{
+			assert(pEntities[index] != INVALID_ENTITY && !Contains(pEntities[index]));
+			m_entityToIndex[pEntities[index]] = firstIndex + index;
+		}
+
+		return m_components.data() + firstIndex;
+	}
+
 	// Remove actvie component from storage.
 	void RemoveComponent(Entity entity)
 	{
@@ -52,6 +52,8 @@ void MaterialComponent::Reset()
 	m_isShaderFeaturesDirty = true;
 	m_isShaderResourceDirty = true;
 	m_pShaderResource = nullptr;
+	m_isPipelineStateDirty = true;
+	m_pipelineState.Reset();
 	m_shaderFeatures.clear();
 	m_featureCombine.clear();
 	m_propertyGroups.clear();
@@ -111,6 +113,7 @@ void MaterialComponent::ActivateShaderFeature(ShaderFeature feature)
 	m_shaderFeatures.insert(cd::MoveTemp(feature));
 	m_isShaderFeaturesDirty = true;
 	m_isShaderResourceDirty = true;
+	m_isPipelineStateDirty = true;
 }
 
 void MaterialComponent::DeactivateShaderFeature(ShaderFeature feature)
@@ -118,6 +121,7 @@ void MaterialComponent::DeactivateShaderFeature(ShaderFeature feature)
 	m_shaderFeatures.erase(feature);
 	m_isShaderFeaturesDirty = true;
 	m_isShaderResourceDirty = true;
+	m_isPipelineStateDirty = true;
 }
 
 const std::string& MaterialComponent::GetFeaturesCombine()
@@ -150,6 +154,7 @@ void MaterialComponent::SetShaderResource(ShaderResource* pShaderResource)
 	m_pShaderResource->SetActive(true);
 
 	m_isShaderResourceDirty = false;
+	m_isPipelineStateDirty = true;
 }
 
 ShaderResource* MaterialComponent::GetShaderResource() const
@@ -177,8 +182,10 @@ void MaterialComponent::SetTextureResource(cd::MaterialTextureType textureType,
 	TextureInfo& textureInfo = propertyGroup.textureInfo;
 	textureInfo.slot = optTextureSlot.value();
 	textureInfo.pTextureResource = pTextureResource;
+	textureInfo.layer = 0;
 	textureInfo.uvScale = uvScale;
 	textureInfo.uvOffset = uvOffset;
+	m_isPipelineStateDirty = true;
 }
 
 }
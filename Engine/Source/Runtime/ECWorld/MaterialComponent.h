@@ -3,6 +3,7 @@
 #include "Core/StringCrc.h"
 #include "ECWorld/SkyComponent.h"
 #include "Material/ShaderSchema.h"
+#include "Rendering/PipelineState.h"
 #include "Scene/MaterialTextureType.h"
 #include "Scene/Texture.h"
 
@@ -50,6 +51,8 @@ public:
 		cd::Vec2f uvOffset = cd::Vec2f::Zero();
 		cd::Vec2f uvScale = cd::Vec2f::One();
 		uint8_t slot;
+		// Layer index when pTextureResource is a packed 2D texture array.
+		uint16_t layer = 0;
 		TextureResource* pTextureResource = nullptr;
 
 		// TODO : Improve TextureInfo 
@@ -59,6 +62,8 @@ public:
 		const cd::Vec2f& GetUVScale() const  { return uvScale; }
 		void SetUVOffset(const cd::Vec2f& offset) { uvOffset = offset; }
 		void SetUVScale(const cd::Vec2f& scale) { uvScale = scale; }
+		uint16_t GetLayer() const { return layer; }
+		void SetLayer(uint16_t index) { layer = index; }
 	};
 
 	struct PropertyGroup
@@ -139,6 +144,7 @@ public:
 		if (auto pValue = std::get_if<T>(&(it->second.factor)); pValue)
 		{
 			*pValue = cd::MoveTemp(factor);
+			m_isPipelineStateDirty = true;
 		}
 	}
 
@@ -167,27 +173,33 @@ public:
 	}
 
 	// Cull parameters. 
-	void SetTwoSided(bool value) { m_twoSided = value; }
+	void SetTwoSided(bool value) { m_twoSided = value; m_isPipelineStateDirty = true; }
 	bool& GetTwoSided() { return m_twoSided; }
 	bool GetTwoSided() const { return m_twoSided; }
 
 	// Blend parameters.
-	void SetBlendMode(cd::BlendMode blendMode) { m_blendMode = blendMode; }
+	void SetBlendMode(cd::BlendMode blendMode) { m_blendMode = blendMode; m_isPipelineStateDirty = true; }
 	cd::BlendMode& GetBlendMode() { return m_blendMode; }
 	cd::BlendMode GetBlendMode() const { return m_blendMode; }
 
-	void SetAlphaCutOff(float value) { m_alphaCutOff = value; }
+	void SetAlphaCutOff(float value) { m_alphaCutOff = value; m_isPipelineStateDirty = true; }
 	float& GetAlphaCutOff() { return m_alphaCutOff; }
 	float GetAlphaCutOff() const { return m_alphaCutOff; }
 
-	void SetIblStrengeth(float strength) { m_iblStrength = strength; }
+	void SetIblStrengeth(float strength) { m_iblStrength = strength; m_isPipelineStateDirty = true; }
 	float& GetIblStrengeth() { return m_iblStrength; }
 	float GetIblStrengeth() const { return m_iblStrength; }
 
-	void SetReflectance(float reflectance) { m_reflectance = reflectance; }
+	void SetReflectance(float reflectance) { m_reflectance = reflectance; m_isPipelineStateDirty = true; }
 	float& GetReflectance() { return m_reflectance; }
 	float GetReflectance() const { return m_reflectance; }
 
+	// Values returned by non-const getters can be modified directly. Mark dirty manually after that.
+	bool IsPipelineStateDirty() const { return m_isPipelineStateDirty; }
+	void SetPipelineStateDirty(bool dirty) { m_isPipelineStateDirty = dirty; }
+	PipelineState& GetPipelineState() { return m_pipelineState; }
+	const PipelineState& GetPipelineState() const { return m_pipelineState; }
+
 	void SetToonParameters(ToonParameters toonParameters) { m_toonParameters = toonParameters; }
 	ToonParameters& GetToonParameters() { return m_toonParameters; }
 	ToonParameters GetToonParameters() const { return m_toonParameters; }
@@ -203,6 +215,8 @@ private:
 	std::string m_featureCombine;
 	std::set<ShaderFeature> m_shaderFeatures;
 	ShaderResource* m_pShaderResource = nullptr;
+	bool m_isPipelineStateDirty = true;
+	PipelineState m_pipelineState;
 
 	// Output
 	bool m_twoSided;
@@ -10,6 +10,8 @@ namespace engine
 
 void ParticleEmitterComponent::Build()
 {
+	m_particlePool.SetParticleMaxCount(m_spawnCount);
+
 	//Sprite
 	BuildParticleShape();
 	bgfx::VertexLayout vertexLayout;
@@ -38,6 +40,23 @@ void ParticleEmitterComponent::Build()
 	}
 }
 
+void ParticleEmitterComponent::Simulate(float deltaTime, const cd::Vec3f& emitterPosition)
+{
+	m_particlePool.SetParticleMaxCount(m_spawnCount);
+
+	ParticleSpawnParams params;
+	params.position = emitterPosition;
+	params.positionRange = m_emitterShapeRange;
+	params.randomPosition = m_randomPosState;
+	params.velocity = m_emitterVelocity;
+	params.velocityRange = m_randomVelocity;
+	params.randomVelocity = m_randomVelocityState;
+	params.acceleration = m_emitterAcceleration;
+	params.color = m_emitterColor;
+	params.lifeTime = m_emitterLifeTime;
+	m_particleSpawner.Simulate(m_particlePool, deltaTime, params);
+}
+
 void ParticleEmitterComponent::PaddingSpriteVertexBuffer()
 {
 	//m_particleVertexBuffer.clear();
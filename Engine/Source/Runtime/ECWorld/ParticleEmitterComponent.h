@@ -7,6 +7,7 @@
 #include "Material/ShaderSchema.h"
 #include "Material/MaterialType.h"
 #include "ParticleSystem/ParticlePool.h"
+#include "ParticleSystem/ParticleSpawner.h"
 #include "Scene/Mesh.h"
 #include "Scene/Types.h"
 #include "Scene/VertexFormat.h"
@@ -43,6 +44,11 @@ public:
 	~ParticleEmitterComponent() = default;
 
 	ParticlePool& GetParticlePool() { return m_particlePool; }
+	const ParticlePool& GetParticlePool() const { return m_particlePool; }
+
+	// Spawn rate, bursts and random seed of the emitter.
+	ParticleSpawner& GetParticleSpawner() { return m_particleSpawner; }
+	const ParticleSpawner& GetParticleSpawner() const { return m_particleSpawner; }
 
 	int& GetSpawnCount() { return m_spawnCount; }
 	void SetSpawnCount(int count) { m_spawnCount = count; }
@@ -101,6 +107,10 @@ public:
 
 	void Build();
 
+	// Updates particles and spawns the ones of this step at the emitter position.
+	// The pool only reallocates when the max count changes.
+	void Simulate(float deltaTime, const cd::Vec3f& emitterPosition);
+
 	void SetRequiredVertexFormat(const cd::VertexFormat* pVertexFormat) { m_pRequiredVertexFormat = pVertexFormat; }
 
 	//void UpdateBuffer();
@@ -113,6 +123,7 @@ public:
 private:
 	//ParticleSystem m_particleSystem;
 	ParticlePool m_particlePool;
+	ParticleSpawner m_particleSpawner;
 
 	engine::ParticleType m_emitterParticleType = engine::ParticleType::Sprite;
 
@@ -124,9 +135,9 @@ private:
 	float m_emitterLifeTime = 6.0f;
 
 	// random emitter data
-	bool m_randomPosState;
+	bool m_randomPosState = false;
 	cd::Vec3f m_randomPos;
-	bool m_randomVelocityState;
+	bool m_randomVelocityState = false;
 	cd::Vec3f m_randomVelocity;
 
 	//instancing
@@ -0,0 +1,1419 @@
+#include "SceneSnapshot.h"
+
+#include "Core/Memory/MemoryTracker.h"
+#include "Core/OS/MappedFile.h"
+#include "ECWorld/AnimationComponent.h"
+#include "ECWorld/CameraComponent.h"
+#include "ECWorld/CollisionMeshComponent.h"
+#include "ECWorld/HierarchyComponent.h"
+#include "ECWorld/LightComponent.h"
+#include "ECWorld/MaterialComponent.h"
+#include "ECWorld/NameComponent.h"
+#include "ECWorld/SceneWorld.h"
+#include "ECWorld/SkeletonComponent.h"
+#include "ECWorld/StaticMeshComponent.h"
+#include "ECWorld/TransformComponent.h"
+#include "ECWorld/World.h"
+#include "Log/Log.h"
+#include "Material/MaterialType.h"
+#include "Rendering/Resources/MeshResource.h"
+#include "Rendering/Resources/ResourceContext.h"
+#include "Rendering/Resources/SkeletonResource.h"
+#include "Rendering/Resources/TextureResource.h"
+
+#include <bgfx/bgfx.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <set>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace engine
+{
+
+namespace
+{
+
+constexpr uint32_t InvalidIndex = UINT32_MAX;
+constexpr size_t SectionAlignment = 16U;
+constexpr uint32_t MaxMaterialPropertyGroups = 16U;
+
+// Records are copied as they are so both sides need the same math library layout.
+static_assert(std::is_trivially_copyable_v<cd::Transform>);
+static_assert(std::is_trivially_copyable_v<cd::Matrix4x4>);
+static_assert(std::is_trivially_copyable_v<cd::AABB>);
+static_assert(std::is_trivially_copyable_v<U_Light>);
+static_assert(std::is_trivially_copyable_v<MaterialComponent::ToonParameters>);
+static_assert(static_cast<uint32_t>(ShaderFeature::COUNT) <= 32U, "Shader features don't fit in the feature mask of material records.");
+
+struct SnapshotHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entityCount;
+	uint32_t sectionCount;
+	uint32_t transformSize;
+	uint32_t resourceCount;
+	uint64_t resourceTableOffset;
+	uint64_t stringTableOffset;
+	uint64_t stringTableSize;
+	uint64_t sectionTableOffset;
+};
+
+struct SnapshotSection
+{
+	uint32_t componentCrc;
+	uint32_t count;
+	// uint32_t entity indices.
+	uint64_t entityIndicesOffset;
+	// count records of the component type.
+	uint64_t recordsOffset;
+	uint64_t recordSize;
+};
+
+struct SnapshotResource
+{
+	uint32_t type;
+	uint32_t nameCrc;
+	// Built data to create the resource when it is not in the ResourceContext. Size is 0 for references only.
+	uint64_t payloadOffset;
+	uint64_t payloadSize;
+};
+
+struct NameRecord
+{
+	uint32_t offset;
+	uint32_t length;
+};
+
+struct TransformRecord
+{
+	cd::Transform transform;
+	cd::Matrix4x4 worldMatrix;
+};
+
+struct HierarchyRecord
+{
+	uint32_t parentIndex;
+};
+
+// StaticMesh and Skeleton components.
+struct ResourceRecord
+{
+	uint32_t resourceIndex;
+};
+
+struct CollisionMeshRecord
+{
+	uint32_t type;
+	cd::AABB aabb;
+};
+
+struct MaterialPropertyRecord
+{
+	uint32_t group;
+	uint32_t useTexture;
+	// Alternative index of MaterialComponent::PropertyGroup::factor.
+	uint32_t factorIndex;
+	float factor[4];
+	uint32_t textureResourceIndex;
+	float uvOffset[2];
+	float uvScale[2];
+	uint32_t layer;
+};
+
+struct MaterialRecord
+{
+	NameRecord name;
+	NameRecord materialTypeName;
+	uint32_t shaderFeatureMask;
+	uint32_t twoSided;
+	uint32_t blendMode;
+	float alphaCutOff;
+	float iblStrength;
+	float reflectance;
+	MaterialComponent::ToonParameters toonParameters;
+	uint32_t propertyCount;
+	MaterialPropertyRecord properties[MaxMaterialPropertyGroups];
+};
+
+struct AnimationRecord
+{
+	uint32_t clip;
+	float duration;
+	float ticksPerSecond;
+	float playBackSpeed;
+	float blendFactor;
+	uint32_t isPlaying;
+};
+
+struct LightRecord
+{
+	U_Light uniformData;
+	uint32_t isCastShadow;
+	uint32_t isCastVolume;
+	uint32_t shadowMapSize;
+	uint32_t cascadePartitionMode;
+	float manualCascadeSplit[4];
+};
+
+struct CameraRecord
+{
+	float aspect;
+	float fov;
+	float nearPlane;
+	float farPlane;
+	uint32_t ndcDepth;
+};
+
+// Resource payloads are packed without alignment and read by copies.
+struct MeshPayloadHeader
+{
+	uint64_t vertexBufferSize;
+	uint32_t vertexCount;
+	uint32_t polygonCount;
+	uint32_t layoutCount;
+	uint32_t indexBufferCount;
+	uint32_t isSkinned;
+};
+
+struct VertexLayoutPayload
+{
+	uint32_t vertexAttributeType;
+	uint32_t attributeValueType;
+	uint32_t attributeCount;
+};
+
+struct TexturePayloadHeader
+{
+	uint32_t isSRGB;
+	uint32_t uMapMode;
+	uint32_t vMapMode;
+	uint32_t pathLength;
+};
+
+struct SkeletonPayloadHeader
+{
+	uint32_t boneCount;
+	uint32_t clipCount;
+	uint32_t isCompressionEnabled;
+	AnimationCompressionSettings compressionSettings;
+};
+
+struct ClipPayloadHeader
+{
+	uint32_t nameLength;
+	uint32_t frameCount;
+	uint32_t isCompressed;
+	float duration;
+	float sampleRate;
+};
+
+struct TextureData
+{
+	bool isSRGB;
+	cd::TextureMapMode uMapMode;
+	cd::TextureMapMode vMapMode;
+	std::string ddsFilePath;
+};
+
+struct SkeletonData
+{
+	bool isCompressionEnabled;
+	AnimationCompressionSettings compressionSettings;
+	std::vector<cd::Matrix4x4> boneOffsets;
+	std::vector<uint32_t> boneParentIndices;
+	std::vector<AnimationClipData> clips;
+};
+
+using ResourcePayload = std::variant<std::monostate, MeshResource::BuiltData, TextureData, SkeletonData>;
+
+class SnapshotWriter
+{
+public:
+	uint64_t Append(const void* pData, size_t size)
+	{
+		const size_t offset = (m_buffer.size() + SectionAlignment - 1U) / SectionAlignment * SectionAlignment;
+		m_buffer.resize(offset + size);
+		if (size > 0U)
+		{
+			std::memcpy(m_buffer.data() + offset, pData, size);
+		}
+		return offset;
+	}
+
+	template<typename T>
+	uint64_t Append(const std::vector<T>& values)
+	{
+		return Append(values.data(), values.size() * sizeof(T));
+	}
+
+	std::byte* GetData() { return m_buffer.data(); }
+	size_t GetSize() const { return m_buffer.size(); }
+
+private:
+	std::vector<std::byte> m_buffer;
+};
+
+class PayloadWriter
+{
+public:
+	template<typename T>
+	void Write(const T& value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		WriteBytes(&value, sizeof(T));
+	}
+
+	template<typename T>
+	void Write(const std::vector<T>& values)
+	{
+		WriteBytes(values.data(), values.size() * sizeof(T));
+	}
+
+	void WriteBytes(const void* pData, size_t size)
+	{
+		const auto* pBytes = static_cast<const std::byte*>(pData);
+		m_buffer.insert(m_buffer.end(), pBytes, pBytes + size);
+	}
+
+	const std::vector<std::byte>& GetBuffer() const { return m_buffer; }
+
+private:
+	std::vector<std::byte> m_buffer;
+};
+
+// Every read checks the remaining size so a corrupted payload fails instead of reading out of range.
+class PayloadReader
+{
+public:
+	PayloadReader(const std::byte* pData, uint64_t size)
+		: m_pData(pData)
+		, m_size(size)
+	{
+	}
+
+	template<typename T>
+	bool Read(T& value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		return ReadBytes(&value, sizeof(T));
+	}
+
+	template<typename T>
+	bool Read(std::vector<T>& values, uint64_t count)
+	{
+		if (count > (m_size - m_offset) / sizeof(T))
+		{
+			return false;
+		}
+
+		values.resize(static_cast<size_t>(count));
+		return ReadBytes(values.data(), count * sizeof(T));
+	}
+
+	bool ReadBytes(void* pData, uint64_t size)
+	{
+		if (size > m_size - m_offset)
+		{
+			return false;
+		}
+
+		if (size > 0U)
+		{
+			std::memcpy(pData, m_pData + m_offset, static_cast<size_t>(size));
+		}
+		m_offset += size;
+		return true;
+	}
+
+	bool IsEnd() const { return m_offset == m_size; }
+
+private:
+	const std::byte* m_pData;
+	uint64_t m_size;
+	uint64_t m_offset = 0U;
+};
+
+bool WritePayload(const MeshResource& meshResource, PayloadWriter& writer)
+{
+	MeshResource::BuiltData builtData;
+	if (!meshResource.GetBuiltData(builtData))
+	{
+		return false;
+	}
+
+	const auto& layouts = builtData.vertexFormat.GetVertexAttributeLayouts();
+	MeshPayloadHeader header{};
+	header.vertexBufferSize = builtData.vertexBuffer.size();
+	header.vertexCount = builtData.vertexCount;
+	header.polygonCount = builtData.polygonCount;
+	header.layoutCount = static_cast<uint32_t>(layouts.size());
+	header.indexBufferCount = static_cast<uint32_t>(builtData.indexBuffers.size());
+	header.isSkinned = builtData.isSkinned ? 1U : 0U;
+	writer.Write(header);
+
+	for (const cd::VertexAttributeLayout& layout : layouts)
+	{
+		writer.Write(VertexLayoutPayload{ static_cast<uint32_t>(layout.vertexAttributeType),
+			static_cast<uint32_t>(layout.attributeValueType), static_cast<uint32_t>(layout.attributeCount) });
+	}
+	for (const MeshResource::IndexBuffer& indexBuffer : builtData.indexBuffers)
+	{
+		writer.Write(static_cast<uint64_t>(indexBuffer.size()));
+	}
+
+	writer.Write(builtData.vertexBuffer);
+	for (const MeshResource::IndexBuffer& indexBuffer : builtData.indexBuffers)
+	{
+		writer.Write(indexBuffer);
+	}
+
+	return true;
+}
+
+bool WritePayload(const TextureResource& textureResource, PayloadWriter& writer)
+{
+	const std::string& ddsFilePath = textureResource.GetDDSBuiltTexturePath();
+	if (ddsFilePath.empty())
+	{
+		return false;
+	}
+
+	TexturePayloadHeader header{};
+	header.isSRGB = textureResource.IsSRGBEnabled() ? 1U : 0U;
+	header.uMapMode = static_cast<uint32_t>(textureResource.GetUMapMode());
+	header.vMapMode = static_cast<uint32_t>(textureResource.GetVMapMode());
+	header.pathLength = static_cast<uint32_t>(ddsFilePath.size());
+	writer.Write(header);
+	writer.WriteBytes(ddsFilePath.data(), ddsFilePath.size());
+
+	return true;
+}
+
+bool WritePayload(const SkeletonResource& skeletonResource, PayloadWriter& writer)
+{
+	// Skeletons which are not built yet are compiled here from their SceneDatabase.
+	std::vector<cd::Matrix4x4> boneOffsets;
+	std::vector<uint32_t> boneParentIndices;
+	std::vector<AnimationClipData> compiledClips;
+	std::vector<const AnimationClipData*> clips;
+	if (!skeletonResource.GetBoneParentIndices().empty())
+	{
+		boneOffsets = skeletonResource.GetBoneOffsets();
+		boneParentIndices = skeletonResource.GetBoneParentIndices();
+		for (uint32_t clipIndex = 0U; clipIndex < skeletonResource.GetAnimationClipCount(); ++clipIndex)
+		{
+			clips.push_back(skeletonResource.GetAnimationClip(clipIndex));
+		}
+	}
+	else if (skeletonResource.CompileAnimationData(boneOffsets, boneParentIndices, compiledClips))
+	{
+		for (const AnimationClipData& clip : compiledClips)
+		{
+			clips.push_back(&clip);
+		}
+	}
+
+	const uint32_t boneCount = static_cast<uint32_t>(boneParentIndices.size());
+	if (0U == boneCount || boneOffsets.size() != boneCount ||
+		std::any_of(clips.begin(), clips.end(), [boneCount](const AnimationClipData* pClip) { return pClip->GetBoneCount() != boneCount; }))
+	{
+		return false;
+	}
+
+	SkeletonPayloadHeader header{};
+	header.boneCount = boneCount;
+	header.clipCount = static_cast<uint32_t>(clips.size());
+	header.isCompressionEnabled = skeletonResource.IsAnimationCompressionEnabled() ? 1U : 0U;
+	header.compressionSettings = skeletonResource.GetAnimationCompressionSettings();
+	writer.Write(header);
+	writer.Write(boneOffsets);
+	writer.Write(boneParentIndices);
+
+	std::vector<cd::Transform> frames;
+	std::vector<uint32_t> clipParentIndices(boneCount);
+	std::vector<uint8_t> hasTracks(boneCount);
+	for (const AnimationClipData* pClip : clips)
+	{
+		ClipPayloadHeader clipHeader{};
+		clipHeader.nameLength = static_cast<uint32_t>(pClip->GetName().size());
+		clipHeader.frameCount = pClip->GetFrameCount();
+		clipHeader.isCompressed = pClip->IsCompressed() ? 1U : 0U;
+		clipHeader.duration = pClip->GetDuration();
+		clipHeader.sampleRate = pClip->GetSampleRate();
+		writer.Write(clipHeader);
+		writer.WriteBytes(pClip->GetName().data(), pClip->GetName().size());
+
+		for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+		{
+			clipParentIndices[boneIndex] = pClip->GetParentIndex(boneIndex);
+			hasTracks[boneIndex] = pClip->HasTrack(boneIndex) ? 1U : 0U;
+		}
+		writer.Write(clipParentIndices);
+		writer.Write(pClip->GetBoneOrder());
+		writer.Write(hasTracks);
+
+		// Compressed clips are stored as decompressed frames and compressed again when loading.
+		pClip->GetFrames(frames);
+		writer.Write(frames);
+	}
+
+	return true;
+}
+
+bool ReadMeshPayload(PayloadReader& reader, MeshResource::BuiltData& builtData)
+{
+	MeshPayloadHeader header;
+	if (!reader.Read(header))
+	{
+		return false;
+	}
+
+	using AttributeCount = decltype(cd::VertexAttributeLayout::attributeCount);
+	for (uint32_t layoutIndex = 0U; layoutIndex < header.layoutCount; ++layoutIndex)
+	{
+		VertexLayoutPayload layout;
+		if (!reader.Read(layout))
+		{
+			return false;
+		}
+		builtData.vertexFormat.AddVertexAttributeLayout(static_cast<cd::VertexAttributeType>(layout.vertexAttributeType),
+			static_cast<cd::AttributeValueType>(layout.attributeValueType), static_cast<AttributeCount>(layout.attributeCount));
+	}
+
+	std::vector<uint64_t> indexBufferSizes;
+	if (!reader.Read(indexBufferSizes, header.indexBufferCount) || !reader.Read(builtData.vertexBuffer, header.vertexBufferSize))
+	{
+		return false;
+	}
+
+	builtData.indexBuffers.resize(header.indexBufferCount);
+	for (uint32_t indexBufferIndex = 0U; indexBufferIndex < header.indexBufferCount; ++indexBufferIndex)
+	{
+		if (!reader.Read(builtData.indexBuffers[indexBufferIndex], indexBufferSizes[indexBufferIndex]))
+		{
+			return false;
+		}
+	}
+
+	builtData.vertexCount = header.vertexCount;
+	builtData.polygonCount = header.polygonCount;
+	builtData.isSkinned = 0U != header.isSkinned;
+	return builtData.vertexBuffer.size() == static_cast<uint64_t>(header.vertexCount) * builtData.vertexFormat.GetStride();
+}
+
+bool ReadTexturePayload(PayloadReader& reader, TextureData& textureData)
+{
+	TexturePayloadHeader header;
+	if (!reader.Read(header))
+	{
+		return false;
+	}
+
+	textureData.isSRGB = 0U != header.isSRGB;
+	textureData.uMapMode = static_cast<cd::TextureMapMode>(header.uMapMode);
+	textureData.vMapMode = static_cast<cd::TextureMapMode>(header.vMapMode);
+	textureData.ddsFilePath.resize(header.pathLength);
+	return header.pathLength > 0U && reader.ReadBytes(textureData.ddsFilePath.data(), header.pathLength);
+}
+
+bool ReadSkeletonPayload(PayloadReader& reader, SkeletonData& skeletonData)
+{
+	SkeletonPayloadHeader header;
+	if (!reader.Read(header) || 0U == header.boneCount ||
+		!reader.Read(skeletonData.boneOffsets, header.boneCount) || !reader.Read(skeletonData.boneParentIndices, header.boneCount))
+	{
+		return false;
+	}
+
+	skeletonData.isCompressionEnabled = 0U != header.isCompressionEnabled;
+	skeletonData.compressionSettings = header.compressionSettings;
+
+	std::vector<uint8_t> hasTracks;
+	for (uint32_t clipIndex = 0U; clipIndex < header.clipCount; ++clipIndex)
+	{
+		ClipPayloadHeader clipHeader;
+		std::string name;
+		std::vector<uint32_t> parentIndices;
+		std::vector<uint32_t> boneOrder;
+		std::vector<cd::Transform> frames;
+		if (!reader.Read(clipHeader))
+		{
+			return false;
+		}
+
+		name.resize(clipHeader.nameLength);
+		if (!reader.ReadBytes(name.data(), clipHeader.nameLength) ||
+			!reader.Read(parentIndices, header.boneCount) ||
+			!reader.Read(boneOrder, header.boneCount) ||
+			!reader.Read(hasTracks, header.boneCount) ||
+			!reader.Read(frames, static_cast<uint64_t>(clipHeader.frameCount) * header.boneCount))
+		{
+			return false;
+		}
+
+		AnimationClipData& clip = skeletonData.clips.emplace_back();
+		if (!clip.Restore(cd::MoveTemp(name), clipHeader.duration, clipHeader.sampleRate, cd::MoveTemp(frames), cd::MoveTemp(parentIndices),
+			cd::MoveTemp(boneOrder), std::vector<bool>(hasTracks.begin(), hasTracks.end())))
+		{
+			return false;
+		}
+
+		if (0U != clipHeader.isCompressed)
+		{
+			clip.Compress(skeletonData.compressionSettings);
+		}
+	}
+
+	return true;
+}
+
+bool ReadPayload(const std::byte* pData, const SnapshotResource& resource, ResourcePayload& payload)
+{
+	PayloadReader reader(pData + resource.payloadOffset, resource.payloadSize);
+	bool isRead = false;
+	switch (static_cast<ResourceType>(resource.type))
+	{
+	case ResourceType::Mesh:
+		isRead = ReadMeshPayload(reader, payload.emplace<MeshResource::BuiltData>());
+		break;
+	case ResourceType::Texture:
+		isRead = ReadTexturePayload(reader, payload.emplace<TextureData>());
+		break;
+	case ResourceType::Skeleton:
+		isRead = ReadSkeletonPayload(reader, payload.emplace<SkeletonData>());
+		break;
+	default:
+		break;
+	}
+
+	return isRead && reader.IsEnd();
+}
+
+// Reuses a resource which is in the ResourceContext already, e.g. shared with a scene loaded before.
+// Otherwise creates it from the payload.
+IResource* ResolveResource(ResourceContext* pResourceContext, const SnapshotResource& resource, ResourcePayload& payload)
+{
+	if (!pResourceContext)
+	{
+		return nullptr;
+	}
+
+	StringCrc nameCrc;
+	nameCrc.Set(resource.nameCrc);
+	switch (static_cast<ResourceType>(resource.type))
+	{
+	case ResourceType::Mesh:
+	{
+		MeshResource* pMeshResource = pResourceContext->GetMeshResource(nameCrc);
+		if (!pMeshResource && std::holds_alternative<MeshResource::BuiltData>(payload))
+		{
+			pMeshResource = pResourceContext->AddMeshResource(nameCrc);
+			pMeshResource->SetBuiltData(cd::MoveTemp(std::get<MeshResource::BuiltData>(payload)));
+		}
+		return pMeshResource;
+	}
+	case ResourceType::Texture:
+	{
+		TextureResource* pTextureResource = pResourceContext->GetTextureResource(nameCrc);
+		if (!pTextureResource && std::holds_alternative<TextureData>(payload))
+		{
+			TextureData& textureData = std::get<TextureData>(payload);
+			pTextureResource = pResourceContext->AddTextureResource(nameCrc);
+			pTextureResource->SetDDSBuiltTexturePath(cd::MoveTemp(textureData.ddsFilePath));
+			pTextureResource->UpdateUVMapMode(textureData.uMapMode, textureData.vMapMode);
+			pTextureResource->SetSRGBEnabled(textureData.isSRGB);
+		}
+		return pTextureResource;
+	}
+	case ResourceType::Skeleton:
+	{
+		SkeletonResource* pSkeletonResource = pResourceContext->GetSkeletonResource(nameCrc);
+		if (!pSkeletonResource && std::holds_alternative<SkeletonData>(payload))
+		{
+			SkeletonData& skeletonData = std::get<SkeletonData>(payload);
+			pSkeletonResource = pResourceContext->AddSkeletonResource(nameCrc);
+			pSkeletonResource->SetAnimationCompressionEnabled(skeletonData.isCompressionEnabled);
+			pSkeletonResource->SetAnimationCompressionSettings(skeletonData.compressionSettings);
+			pSkeletonResource->SetSkeletonData(cd::MoveTemp(skeletonData.boneOffsets), cd::MoveTemp(skeletonData.boneParentIndices),
+				cd::MoveTemp(skeletonData.clips));
+		}
+		return pSkeletonResource;
+	}
+	default:
+		return nullptr;
+	}
+}
+
+// Resources are stored once with their built data when the first component references them.
+class ResourceTableWriter
+{
+public:
+	explicit ResourceTableWriter(SnapshotWriter& writer)
+		: m_writer(writer)
+	{
+	}
+
+	template<typename Resource>
+	uint32_t Add(ResourceType type, const Resource* pResource)
+	{
+		if (!pResource)
+		{
+			return InvalidIndex;
+		}
+
+		const uint32_t nameCrc = pResource->GetName().Value();
+		const uint64_t key = (static_cast<uint64_t>(type) << 32U) | nameCrc;
+		auto [itResource, isNew] = m_resourceToIndex.try_emplace(key, static_cast<uint32_t>(m_resources.size()));
+		if (isNew)
+		{
+			SnapshotResource& resource = m_resources.emplace_back();
+			resource.type = static_cast<uint32_t>(type);
+			resource.nameCrc = nameCrc;
+			resource.payloadOffset = 0U;
+			resource.payloadSize = 0U;
+
+			PayloadWriter payloadWriter;
+			if (WritePayload(*pResource, payloadWriter))
+			{
+				resource.payloadOffset = m_writer.Append(payloadWriter.GetBuffer());
+				resource.payloadSize = payloadWriter.GetBuffer().size();
+			}
+		}
+
+		return itResource->second;
+	}
+
+	const std::vector<SnapshotResource>& GetResources() const { return m_resources; }
+
+private:
+	SnapshotWriter& m_writer;
+	std::vector<SnapshotResource> m_resources;
+	std::unordered_map<uint64_t, uint32_t> m_resourceToIndex;
+};
+
+NameRecord AddString(std::vector<char>& stringTable, const char* pString)
+{
+	const size_t length = std::strlen(pString);
+	NameRecord record;
+	record.offset = static_cast<uint32_t>(stringTable.size());
+	record.length = static_cast<uint32_t>(length);
+	stringTable.insert(stringTable.end(), pString, pString + length + 1U);
+	return record;
+}
+
+template<typename Component, typename Record, typename Convert>
+void WriteSection(SnapshotWriter& writer, std::vector<SnapshotSection>& sections, World& world,
+	const std::unordered_map<Entity, uint32_t>& entityToIndex, Convert convert)
+{
+	ComponentsStorage<Component>* pStorage = world.GetComponents<Component>();
+	const std::vector<Entity>& entities = pStorage->GetEntities();
+
+	// Records are converted in place into the arrays which are written.
+	std::vector<uint32_t> entityIndices(entities.size());
+	std::vector<Record> records(entities.size());
+	size_t count = 0U;
+	for (Entity entity : entities)
+	{
+		auto itEntity = entityToIndex.find(entity);
+		if (itEntity == entityToIndex.end())
+		{
+			continue;
+		}
+
+		records[count] = Record{};
+		if (convert(*pStorage->GetComponent(entity), records[count]))
+		{
+			entityIndices[count] = itEntity->second;
+			++count;
+		}
+	}
+	entityIndices.resize(count);
+	records.resize(count);
+
+	SnapshotSection section;
+	section.componentCrc = Component::GetClassName().Value();
+	section.count = static_cast<uint32_t>(count);
+	section.entityIndicesOffset = writer.Append(entityIndices);
+	section.recordsOffset = writer.Append(records);
+	section.recordSize = sizeof(Record);
+	sections.push_back(section);
+}
+
+bool IsInRange(size_t fileSize, uint64_t offset, uint64_t size)
+{
+	return offset <= fileSize && size <= fileSize - offset;
+}
+
+class SnapshotReader
+{
+public:
+	SnapshotReader(World& world, const std::byte* pData, const SnapshotHeader& header, Entity firstEntity,
+		const std::vector<SnapshotResource>& resources, const std::vector<IResource*>& resolvedResources)
+		: m_world(world)
+		, m_pData(pData)
+		, m_header(header)
+		, m_firstEntity(firstEntity)
+		, m_resources(resources)
+		, m_resolvedResources(resolvedResources)
+	{
+	}
+
+	// Creates components of the accepted records in one batch and fills them.
+	template<typename Component, typename Record, typename Accept, typename Fill>
+	void ReadSection(const SnapshotSection& section, Accept accept, Fill fill)
+	{
+		const auto* pEntityIndices = reinterpret_cast<const uint32_t*>(m_pData + section.entityIndicesOffset);
+		const auto* pRecords = reinterpret_cast<const Record*>(m_pData + section.recordsOffset);
+
+		m_entities.clear();
+		m_recordIndices.clear();
+		for (uint32_t recordIndex = 0U; recordIndex < section.count; ++recordIndex)
+		{
+			if (accept(pRecords[recordIndex]))
+			{
+				m_entities.push_back(ToEntity(pEntityIndices[recordIndex]));
+				m_recordIndices.push_back(recordIndex);
+			}
+		}
+
+		ComponentsStorage<Component>* pStorage = m_world.GetComponents<Component>();
+		Component* pComponents = pStorage->CreateComponents(m_entities.data(), m_entities.size());
+		for (size_t componentIndex = 0U; componentIndex < m_entities.size(); ++componentIndex)
+		{
+			fill(m_entities[componentIndex], pComponents[componentIndex], pRecords[m_recordIndices[componentIndex]]);
+		}
+
+		m_componentCount += static_cast<uint32_t>(m_entities.size());
+		m_skippedComponentCount += section.count - static_cast<uint32_t>(m_entities.size());
+	}
+
+	template<typename Component, typename Record, typename Fill>
+	void ReadSection(const SnapshotSection& section, Fill fill)
+	{
+		ReadSection<Component, Record>(section, [](const Record&) { return true; }, fill);
+	}
+
+	Entity ToEntity(uint32_t index) const
+	{
+		return index < m_header.entityCount ? m_firstEntity + index : INVALID_ENTITY;
+	}
+
+	std::string GetString(const NameRecord& record) const
+	{
+		if (record.offset >= m_header.stringTableSize || record.length >= m_header.stringTableSize - record.offset)
+		{
+			return std::string();
+		}
+		return std::string(reinterpret_cast<const char*>(m_pData + m_header.stringTableOffset + record.offset), record.length);
+	}
+
+	template<typename Resource>
+	Resource* GetResource(uint32_t resourceIndex, ResourceType type) const
+	{
+		if (resourceIndex >= m_resources.size() || static_cast<uint32_t>(type) != m_resources[resourceIndex].type)
+		{
+			return nullptr;
+		}
+		return static_cast<Resource*>(m_resolvedResources[resourceIndex]);
+	}
+
+	uint32_t GetComponentCount() const { return m_componentCount; }
+	uint32_t GetSkippedComponentCount() const { return m_skippedComponentCount; }
+
+private:
+	World& m_world;
+	const std::byte* m_pData;
+	const SnapshotHeader& m_header;
+	Entity m_firstEntity;
+	const std::vector<SnapshotResource>& m_resources;
+	const std::vector<IResource*>& m_resolvedResources;
+	std::vector<Entity> m_entities;
+	std::vector<uint32_t> m_recordIndices;
+	uint32_t m_componentCount = 0U;
+	uint32_t m_skippedComponentCount = 0U;
+};
+
+template<typename Component>
+bool IsSection(const SnapshotSection& section, size_t recordSize)
+{
+	return Component::GetClassName().Value() == section.componentCrc && recordSize == section.recordSize;
+}
+
+}
+
+bool SceneSnapshot::Save(World& world, const char* pFilePath, Entity firstEntity)
+{
+	// Entities are stored as dense indices so that loading only needs to add the first new entity id.
+	// They are sorted by id so loaded entities keep the creation order.
+	std::vector<Entity> entities;
+	auto addEntities = [&entities, firstEntity](const std::vector<Entity>& storageEntities)
+	{
+		std::copy_if(storageEntities.begin(), storageEntities.end(), std::back_inserter(entities),
+			[firstEntity](Entity entity) { return entity >= firstEntity && entity != INVALID_ENTITY; });
+	};
+	addEntities(world.GetComponents<NameComponent>()->GetEntities());
+	addEntities(world.GetComponents<TransformComponent>()->GetEntities());
+	addEntities(world.GetComponents<HierarchyComponent>()->GetEntities());
+	addEntities(world.GetComponents<CollisionMeshComponent>()->GetEntities());
+	addEntities(world.GetComponents<StaticMeshComponent>()->GetEntities());
+	addEntities(world.GetComponents<MaterialComponent>()->GetEntities());
+	addEntities(world.GetComponents<SkeletonComponent>()->GetEntities());
+	addEntities(world.GetComponents<AnimationComponent>()->GetEntities());
+	addEntities(world.GetComponents<LightComponent>()->GetEntities());
+	addEntities(world.GetComponents<CameraComponent>()->GetEntities());
+	std::sort(entities.begin(), entities.end());
+	entities.erase(std::unique(entities.begin(), entities.end()), entities.end());
+
+	std::unordered_map<Entity, uint32_t> entityToIndex;
+	entityToIndex.reserve(entities.size());
+	for (Entity entity : entities)
+	{
+		entityToIndex.emplace(entity, static_cast<uint32_t>(entityToIndex.size()));
+	}
+
+	SnapshotWriter writer;
+	SnapshotHeader header{};
+	writer.Append(&header, sizeof(header));
+
+	std::vector<SnapshotSection> sections;
+	std::vector<char> stringTable;
+	ResourceTableWriter resourceTable(writer);
+
+	// Transforms are written before cameras which build their view matrices from them.
+	WriteSection<NameComponent, NameRecord>(writer, sections, world, entityToIndex,
+		[&stringTable](NameComponent& component, NameRecord& record)
+		{
+			record = AddString(stringTable, component.GetName());
+			return true;
+		});
+
+	WriteSection<TransformComponent, TransformRecord>(writer, sections, world, entityToIndex,
+		[](TransformComponent& component, TransformRecord& record)
+		{
+			record.transform = component.GetTransform();
+			record.worldMatrix = component.GetTransform().GetMatrix();
+			return true;
+		});
+
+	WriteSection<HierarchyComponent, HierarchyRecord>(writer, sections, world, entityToIndex,
+		[&entityToIndex](HierarchyComponent& component, HierarchyRecord& record)
+		{
+			auto itParent = entityToIndex.find(component.GetParentEntity());
+			record.parentIndex = itParent != entityToIndex.end() ? itParent->second : InvalidIndex;
+			return true;
+		});
+
+	WriteSection<CollisionMeshComponent, CollisionMeshRecord>(writer, sections, world, entityToIndex,
+		[](CollisionMeshComponent& component, CollisionMeshRecord& record)
+		{
+			record.type = static_cast<uint32_t>(component.GetType());
+			record.aabb = component.GetAABB();
+			return true;
+		});
+
+	WriteSection<StaticMeshComponent, ResourceRecord>(writer, sections, world, entityToIndex,
+		[&resourceTable](StaticMeshComponent& component, ResourceRecord& record)
+		{
+			record.resourceIndex = resourceTable.Add(ResourceType::Mesh, component.GetMeshResource());
+			return InvalidIndex != record.resourceIndex;
+		});
+
+	WriteSection<MaterialComponent, MaterialRecord>(writer, sections, world, entityToIndex,
+		[&stringTable, &resourceTable](MaterialComponent& component, MaterialRecord& record)
+		{
+			if (!component.GetMaterialType())
+			{
+				return false;
+			}
+
+			record.name = AddString(stringTable, component.GetName().c_str());
+			record.materialTypeName = AddString(stringTable, component.GetMaterialType()->GetMaterialName());
+			for (ShaderFeature feature : component.GetShaderFeatures())
+			{
+				record.shaderFeatureMask |= 1U << static_cast<uint32_t>(feature);
+			}
+			record.twoSided = component.GetTwoSided() ? 1U : 0U;
+			record.blendMode = static_cast<uint32_t>(component.GetBlendMode());
+			record.alphaCutOff = component.GetAlphaCutOff();
+			record.iblStrength = component.GetIblStrengeth();
+			record.reflectance = component.GetReflectance();
+			record.toonParameters = component.GetToonParameters();
+
+			for (const auto& [group, propertyGroup] : component.GetPropertyGroups())
+			{
+				if (MaxMaterialPropertyGroups == record.propertyCount)
+				{
+					CD_ENGINE_WARN("Scene snapshot drops property groups of material {0}", component.GetName());
+					break;
+				}
+
+				MaterialPropertyRecord& property = record.properties[record.propertyCount++];
+				property.group = static_cast<uint32_t>(group);
+				property.useTexture = propertyGroup.useTexture ? 1U : 0U;
+				property.factorIndex = static_cast<uint32_t>(propertyGroup.factor.index());
+				if (const float* pFactor = std::get_if<float>(&propertyGroup.factor))
+				{
+					property.factor[0] = *pFactor;
+				}
+				else if (const cd::Vec3f* pVec3Factor = std::get_if<cd::Vec3f>(&propertyGroup.factor))
+				{
+					std::memcpy(property.factor, pVec3Factor->begin(), 3U * sizeof(float));
+				}
+				else if (const cd::Vec4f* pVec4Factor = std::get_if<cd::Vec4f>(&propertyGroup.factor))
+				{
+					std::memcpy(property.factor, pVec4Factor->begin(), 4U * sizeof(float));
+				}
+
+				const MaterialComponent::TextureInfo& textureInfo = propertyGroup.textureInfo;
+				property.textureResourceIndex = resourceTable.Add(ResourceType::Texture, textureInfo.pTextureResource);
+				std::memcpy(property.uvOffset, textureInfo.GetUVOffset().begin(), sizeof(property.uvOffset));
+				std::memcpy(property.uvScale, textureInfo.GetUVScale().begin(), sizeof(property.uvScale));
+				property.layer = textureInfo.GetLayer();
+			}
+			return true;
+		});
+
+	WriteSection<SkeletonComponent, ResourceRecord>(writer, sections, world, entityToIndex,
+		[&resourceTable](SkeletonComponent& component, ResourceRecord& record)
+		{
+			record.resourceIndex = resourceTable.Add(ResourceType::Skeleton, component.GetSkeletonResource());
+			return InvalidIndex != record.resourceIndex;
+		});
+
+	WriteSection<AnimationComponent, AnimationRecord>(writer, sections, world, entityToIndex,
+		[](AnimationComponent& component, AnimationRecord& record)
+		{
+			record.clip = static_cast<uint32_t>(component.GetAnimationClip());
+			record.duration = component.GetDuration();
+			record.ticksPerSecond = component.GetTicksPerSecond();
+			record.playBackSpeed = component.GetPlayBackSpeed();
+			record.blendFactor = component.GetBlendFactor();
+			record.isPlaying = component.IsPlaying() ? 1U : 0U;
+			return true;
+		});
+
+	WriteSection<LightComponent, LightRecord>(writer, sections, world, entityToIndex,
+		[](LightComponent& component, LightRecord& record)
+		{
+			record.uniformData = *component.GetLightUniformData();
+			record.isCastShadow = component.IsCastShadow() ? 1U : 0U;
+			record.isCastVolume = component.GetIsCastVolume() ? 1U : 0U;
+			record.shadowMapSize = component.GetShadowMapSize();
+			record.cascadePartitionMode = static_cast<uint32_t>(component.GetCascadePartitionMode());
+			std::memcpy(record.manualCascadeSplit, component.GetManualCascadeSplit(), sizeof(record.manualCascadeSplit));
+			return true;
+		});
+
+	WriteSection<CameraComponent, CameraRecord>(writer, sections, world, entityToIndex,
+		[](CameraComponent& component, CameraRecord& record)
+		{
+			record.aspect = component.GetAspect();
+			record.fov = component.GetFov();
+			record.nearPlane = component.GetNearPlane();
+			record.farPlane = component.GetFarPlane();
+			record.ndcDepth = static_cast<uint32_t>(component.GetNDCDepth());
+			return true;
+		});
+
+	header.magic = Magic;
+	header.version = Version;
+	header.entityCount = static_cast<uint32_t>(entityToIndex.size());
+	header.sectionCount = static_cast<uint32_t>(sections.size());
+	header.transformSize = static_cast<uint32_t>(sizeof(cd::Transform));
+	header.resourceCount = static_cast<uint32_t>(resourceTable.GetResources().size());
+	header.resourceTableOffset = writer.Append(resourceTable.GetResources());
+	header.stringTableSize = stringTable.size();
+	header.stringTableOffset = writer.Append(stringTable);
+	header.sectionTableOffset = writer.Append(sections);
+	std::memcpy(writer.GetData(), &header, sizeof(header));
+
+	FILE* pFile = std::fopen(pFilePath, "wb");
+	if (!pFile)
+	{
+		CD_ENGINE_ERROR("Failed to open scene snapshot {0} for writing", pFilePath);
+		return false;
+	}
+
+	bool isWritten = std::fwrite(writer.GetData(), 1U, writer.GetSize(), pFile) == writer.GetSize();
+	std::fclose(pFile);
+
+	if (!isWritten)
+	{
+		CD_ENGINE_ERROR("Failed to write scene snapshot {0}", pFilePath);
+	}
+
+	return isWritten;
+}
+
+bool SceneSnapshot::Load(World& world, ResourceContext* pResourceContext, const char* pFilePath, SceneSnapshotInfo* pInfo,
+	std::span<const MaterialType* const> materialTypes)
+{
+	MappedFile file;
+	if (!file.Open(pFilePath))
+	{
+		CD_ENGINE_ERROR("Failed to map scene snapshot {0}", pFilePath);
+		return false;
+	}
+
+	return Load(world, pResourceContext, file.GetData(), file.GetSize(), pInfo, materialTypes);
+}
+
+bool SceneSnapshot::Load(SceneWorld& sceneWorld, ResourceContext* pResourceContext, const char* pFilePath, SceneSnapshotInfo* pInfo)
+{
+	std::vector<const MaterialType*> materialTypes =
+	{
+		sceneWorld.GetPBRMaterialType(),
+		sceneWorld.GetAnimationMaterialType(),
+		sceneWorld.GetTerrainMaterialType(),
+		sceneWorld.GetParticleMaterialType(),
+		sceneWorld.GetCelluloidMaterialType(),
+#ifdef ENABLE_DDGI
+		sceneWorld.GetDDGIMaterialType(),
+#endif
+	};
+	materialTypes.erase(std::remove(materialTypes.begin(), materialTypes.end(), nullptr), materialTypes.end());
+
+	return Load(*sceneWorld.GetWorld(), pResourceContext, pFilePath, pInfo, materialTypes);
+}
+
+bool SceneSnapshot::Load(World& world, ResourceContext* pResourceContext, const std::byte* pData, size_t size, SceneSnapshotInfo* pInfo,
+	std::span<const MaterialType* const> materialTypes)
+{
+	CD_MEMORY_TAG_SCOPE(ECS);
+
+	// Validate all offsets, entity indices and payloads first so that nothing is created for a corrupted snapshot.
+	if (size < sizeof(SnapshotHeader))
+	{
+		CD_ENGINE_ERROR("Scene snapshot is truncated");
+		return false;
+	}
+
+	SnapshotHeader header;
+	std::memcpy(&header, pData, sizeof(header));
+	if (header.magic != Magic || header.version != Version)
+	{
+		CD_ENGINE_ERROR("Scene snapshot has unknown format or version");
+		return false;
+	}
+
+	if (header.transformSize != sizeof(cd::Transform))
+	{
+		CD_ENGINE_ERROR("Scene snapshot was saved with a different cd::Transform layout");
+		return false;
+	}
+
+	const uint64_t sectionTableOffset = header.sectionTableOffset;
+	if (!IsInRange(size, sectionTableOffset, static_cast<uint64_t>(header.sectionCount) * sizeof(SnapshotSection)) ||
+		!IsInRange(size, header.resourceTableOffset, static_cast<uint64_t>(header.resourceCount) * sizeof(SnapshotResource)) ||
+		!IsInRange(size, header.stringTableOffset, header.stringTableSize) ||
+		0U != sectionTableOffset % alignof(SnapshotSection) || 0U != header.resourceTableOffset % alignof(SnapshotResource))
+	{
+		CD_ENGINE_ERROR("Scene snapshot has invalid tables");
+		return false;
+	}
+
+	// A component storage holds one component per entity, so an entity index is only valid once per component type.
+	std::unordered_map<uint32_t, std::vector<bool>> usedEntityIndices;
+	const auto* pSections = reinterpret_cast<const SnapshotSection*>(pData + sectionTableOffset);
+	for (uint32_t sectionIndex = 0U; sectionIndex < header.sectionCount; ++sectionIndex)
+	{
+		const SnapshotSection& section = pSections[sectionIndex];
+		if (!IsInRange(size, section.entityIndicesOffset, static_cast<uint64_t>(section.count) * sizeof(uint32_t)) ||
+			!IsInRange(size, section.recordsOffset, static_cast<uint64_t>(section.count) * section.recordSize) ||
+			0U != section.entityIndicesOffset % SectionAlignment || 0U != section.recordsOffset % SectionAlignment)
+		{
+			CD_ENGINE_ERROR("Scene snapshot has an invalid section");
+			return false;
+		}
+
+		std::vector<bool>& usedIndices = usedEntityIndices[section.componentCrc];
+		usedIndices.resize(header.entityCount, false);
+		const auto* pEntityIndices = reinterpret_cast<const uint32_t*>(pData + section.entityIndicesOffset);
+		for (uint32_t recordIndex = 0U; recordIndex < section.count; ++recordIndex)
+		{
+			const uint32_t entityIndex = pEntityIndices[recordIndex];
+			if (entityIndex >= header.entityCount)
+			{
+				CD_ENGINE_ERROR("Scene snapshot has an invalid entity index");
+				return false;
+			}
+
+			if (usedIndices[entityIndex])
+			{
+				CD_ENGINE_ERROR("Scene snapshot has two components of one type for the same entity");
+				return false;
+			}
+			usedIndices[entityIndex] = true;
+		}
+	}
+
+	const auto* pResources = reinterpret_cast<const SnapshotResource*>(pData + header.resourceTableOffset);
+	std::vector<SnapshotResource> resources(pResources, pResources + header.resourceCount);
+	std::vector<ResourcePayload> payloads(header.resourceCount);
+	for (uint32_t resourceIndex = 0U; resourceIndex < header.resourceCount; ++resourceIndex)
+	{
+		const SnapshotResource& resource = resources[resourceIndex];
+		if (0U == resource.payloadSize)
+		{
+			continue;
+		}
+
+		if (!IsInRange(size, resource.payloadOffset, resource.payloadSize) || !ReadPayload(pData, resource, payloads[resourceIndex]))
+		{
+			CD_ENGINE_ERROR("Scene snapshot has an invalid resource payload");
+			return false;
+		}
+	}
+
+	// Resolve every referenced resource once instead of once per component.
+	std::vector<IResource*> resolvedResources(header.resourceCount, nullptr);
+	uint32_t unresolvedResourceCount = 0U;
+	for (uint32_t resourceIndex = 0U; resourceIndex < header.resourceCount; ++resourceIndex)
+	{
+		resolvedResources[resourceIndex] = ResolveResource(pResourceContext, resources[resourceIndex], payloads[resourceIndex]);
+		if (!resolvedResources[resourceIndex])
+		{
+			++unresolvedResourceCount;
+		}
+	}
+	payloads.clear();
+
+	std::unordered_map<std::string_view, const MaterialType*> nameToMaterialType;
+	for (const MaterialType* pMaterialType : materialTypes)
+	{
+		nameToMaterialType[pMaterialType->GetMaterialName()] = pMaterialType;
+	}
+
+	const Entity firstEntity = world.CreateEntities(header.entityCount);
+	SnapshotReader reader(world, pData, header, firstEntity, resources, resolvedResources);
+	for (uint32_t sectionIndex = 0U; sectionIndex < header.sectionCount; ++sectionIndex)
+	{
+		const SnapshotSection& section = pSections[sectionIndex];
+		if (IsSection<NameComponent>(section, sizeof(NameRecord)))
+		{
+			reader.ReadSection<NameComponent, NameRecord>(section,
+				[&reader](Entity, NameComponent& component, const NameRecord& record)
+				{
+					component.SetName(reader.GetString(record));
+				});
+		}
+		else if (IsSection<TransformComponent>(section, sizeof(TransformRecord)))
+		{
+			reader.ReadSection<TransformComponent, TransformRecord>(section,
+				[](Entity, TransformComponent& component, const TransformRecord& record)
+				{
+					component.SetTransform(record.transform, record.worldMatrix);
+				});
+		}
+		else if (IsSection<HierarchyComponent>(section, sizeof(HierarchyRecord)))
+		{
+			reader.ReadSection<HierarchyComponent, HierarchyRecord>(section,
+				[&reader](Entity, HierarchyComponent& component, const HierarchyRecord& record)
+				{
+					component.SetParentEntity(reader.ToEntity(record.parentIndex));
+				});
+		}
+		else if (IsSection<CollisionMeshComponent>(section, sizeof(CollisionMeshRecord)))
+		{
+			reader.ReadSection<CollisionMeshComponent, CollisionMeshRecord>(section,
+				[](Entity, CollisionMeshComponent& component, const CollisionMeshRecord& record)
+				{
+					component.SetType(static_cast<CollisonMeshType>(record.type));
+					component.SetAABB(record.aabb);
+					component.Build();
+				});
+		}
+		else if (IsSection<StaticMeshComponent>(section, sizeof(ResourceRecord)))
+		{
+			reader.ReadSection<StaticMeshComponent, ResourceRecord>(section,
+				[&reader](const ResourceRecord& record)
+				{
+					return nullptr != reader.GetResource<MeshResource>(record.resourceIndex, ResourceType::Mesh);
+				},
+				[&reader](Entity, StaticMeshComponent& component, const ResourceRecord& record)
+				{
+					component.SetMeshResource(reader.GetResource<MeshResource>(record.resourceIndex, ResourceType::Mesh));
+				});
+		}
+		else if (IsSection<MaterialComponent>(section, sizeof(MaterialRecord)))
+		{
+			auto findMaterialType = [&reader, &nameToMaterialType](const MaterialRecord& record) -> const MaterialType*
+			{
+				auto itMaterialType = nameToMaterialType.find(reader.GetString(record.materialTypeName));
+				return itMaterialType != nameToMaterialType.end() ? itMaterialType->second : nullptr;
+			};
+
+			reader.ReadSection<MaterialComponent, MaterialRecord>(section,
+				[&findMaterialType](const MaterialRecord& record)
+				{
+					return nullptr != findMaterialType(record);
+				},
+				[&reader, &findMaterialType](Entity, MaterialComponent& component, const MaterialRecord& record)
+				{
+					component.Init();
+					component.SetMaterialType(findMaterialType(record));
+					component.SetName(reader.GetString(record.name));
+					component.SetTwoSided(0U != record.twoSided);
+					component.SetBlendMode(static_cast<cd::BlendMode>(record.blendMode));
+					component.SetAlphaCutOff(record.alphaCutOff);
+					component.SetIblStrengeth(record.iblStrength);
+					component.SetReflectance(record.reflectance);
+					component.SetToonParameters(record.toonParameters);
+
+					std::set<ShaderFeature> shaderFeatures;
+					for (uint32_t featureIndex = 0U; featureIndex < static_cast<uint32_t>(ShaderFeature::COUNT); ++featureIndex)
+					{
+						if (record.shaderFeatureMask & (1U << featureIndex))
+						{
+							shaderFeatures.insert(static_cast<ShaderFeature>(featureIndex));
+						}
+					}
+
+					const uint32_t propertyCount = std::min(record.propertyCount, MaxMaterialPropertyGroups);
+					for (uint32_t propertyIndex = 0U; propertyIndex < propertyCount; ++propertyIndex)
+					{
+						const MaterialPropertyRecord& property = record.properties[propertyIndex];
+						const auto group = static_cast<cd::MaterialPropertyGroup>(property.group);
+						if (TextureResource* pTextureResource = reader.GetResource<TextureResource>(property.textureResourceIndex, ResourceType::Texture))
+						{
+							component.SetTextureResource(group, cd::Vec2f(property.uvOffset[0], property.uvOffset[1]),
+								cd::Vec2f(property.uvScale[0], property.uvScale[1]), pTextureResource);
+						}
+						else if (InvalidIndex != property.textureResourceIndex)
+						{
+							// Texture is unresolved so the material uses its factor instead of sampling it.
+							if (auto itFeature = MaterialTextureTypeToShaderFeature.find(group); itFeature != MaterialTextureTypeToShaderFeature.end())
+							{
+								shaderFeatures.erase(itFeature->second);
+							}
+						}
+
+						MaterialComponent::PropertyGroup* pPropertyGroup = component.GetPropertyGroup(group);
+						if (!pPropertyGroup)
+						{
+							continue;
+						}
+
+						pPropertyGroup->useTexture = 0U != property.useTexture && pPropertyGroup->textureInfo.pTextureResource;
+						pPropertyGroup->textureInfo.SetLayer(static_cast<uint16_t>(property.layer));
+						switch (property.factorIndex)
+						{
+						case 0U:
+							pPropertyGroup->factor = property.factor[0];
+							break;
+						case 1U:
+							pPropertyGroup->factor = cd::Vec3f(property.factor[0], property.factor[1], property.factor[2]);
+							break;
+						case 2U:
+							pPropertyGroup->factor = cd::Vec4f(property.factor[0], property.factor[1], property.factor[2], property.factor[3]);
+							break;
+						default:
+							break;
+						}
+					}
+
+					component.SetShaderFeatures(cd::MoveTemp(shaderFeatures));
+					component.SetPipelineStateDirty(true);
+				});
+		}
+		else if (IsSection<SkeletonComponent>(section, sizeof(ResourceRecord)))
+		{
+			reader.ReadSection<SkeletonComponent, ResourceRecord>(section,
+				[&reader](const ResourceRecord& record)
+				{
+					return nullptr != reader.GetResource<SkeletonResource>(record.resourceIndex, ResourceType::Skeleton);
+				},
+				[&reader](Entity, SkeletonComponent& component, const ResourceRecord& record)
+				{
+					component.SetSkeletonAsset(reader.GetResource<SkeletonResource>(record.resourceIndex, ResourceType::Skeleton));
+				});
+		}
+		else if (IsSection<AnimationComponent>(section, sizeof(AnimationRecord)))
+		{
+			reader.ReadSection<AnimationComponent, AnimationRecord>(section,
+				[](Entity, AnimationComponent& component, const AnimationRecord& record)
+				{
+					component.SetAnimationClip(static_cast<AnimationClip>(std::min(record.clip, static_cast<uint32_t>(AnimationClip::Count) - 1U)));
+					component.SetDuration(record.duration);
+					component.SetTicksPerSecond(record.ticksPerSecond);
+					component.SetPlayBackSpeed(record.playBackSpeed);
+					component.SetBlendFactor(record.blendFactor);
+					component.IsPlaying() = 0U != record.isPlaying;
+
+					bgfx::UniformHandle boneMatricesUniform = bgfx::createUniform("u_boneMatrices", bgfx::UniformType::Mat4, 128);
+					component.SetBoneMatricesUniform(boneMatricesUniform.idx);
+				});
+		}
+		else if (IsSection<LightComponent>(section, sizeof(LightRecord)))
+		{
+			reader.ReadSection<LightComponent, LightRecord>(section,
+				[](Entity, LightComponent& component, const LightRecord& record)
+				{
+					*component.GetLightUniformData() = record.uniformData;
+					component.SetIsCastShadow(0U != record.isCastShadow);
+					component.GetIsCastVolume() = 0U != record.isCastVolume;
+					component.SetShadowMapSize(static_cast<uint16_t>(record.shadowMapSize));
+					component.SetCascadePartitionMode(static_cast<CascadePartitionMode>(
+						std::min(record.cascadePartitionMode, static_cast<uint32_t>(CascadePartitionMode::Count) - 1U)));
+					for (uint16_t splitIndex = 0U; splitIndex < 4U; ++splitIndex)
+					{
+						component.GetManualCascadeSplitAt(splitIndex) = record.manualCascadeSplit[splitIndex];
+					}
+				});
+		}
+		else if (IsSection<CameraComponent>(section, sizeof(CameraRecord)))
+		{
+			ComponentsStorage<TransformComponent>* pTransformStorage = world.GetComponents<TransformComponent>();
+			reader.ReadSection<CameraComponent, CameraRecord>(section,
+				[pTransformStorage](Entity entity, CameraComponent& component, const CameraRecord& record)
+				{
+					component.SetAspect(record.aspect);
+					component.SetFov(record.fov);
+					component.SetNearPlane(record.nearPlane);
+					component.SetFarPlane(record.farPlane);
+					component.SetNDCDepth(static_cast<cd::NDCDepth>(record.ndcDepth));
+					component.BuildProjectMatrix();
+					if (const TransformComponent* pTransformComponent = pTransformStorage->GetComponent(entity))
+					{
+						component.BuildViewMatrix(pTransformComponent->GetTransform());
+					}
+					else
+					{
+						component.ViewDirty();
+					}
+				});
+		}
+		else
+		{
+			CD_ENGINE_WARN("Skip unknown section {0} in scene snapshot", section.componentCrc);
+		}
+	}
+
+	if (unresolvedResourceCount > 0U)
+	{
+		CD_ENGINE_WARN("Scene snapshot references {0} resources which are neither in ResourceContext nor stored", unresolvedResourceCount);
+	}
+
+	if (pInfo)
+	{
+		pInfo->firstEntity = firstEntity;
+		pInfo->entityCount = header.entityCount;
+		pInfo->componentCount = reader.GetComponentCount();
+		pInfo->unresolvedResourceCount = unresolvedResourceCount;
+		pInfo->skippedComponentCount = reader.GetSkippedComponentCount();
+	}
+
+	return true;
+}
+
+}
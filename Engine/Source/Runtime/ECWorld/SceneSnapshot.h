@@ -0,0 +1,55 @@
+#pragma once
+
+#include "ECWorld/Entity.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace engine
+{
+
+class MaterialType;
+class ResourceContext;
+class SceneWorld;
+class World;
+
+struct SceneSnapshotInfo
+{
+	Entity firstEntity = INVALID_ENTITY;
+	uint32_t entityCount = 0U;
+	uint32_t componentCount = 0U;
+	// Referenced resources which were neither in the ResourceContext nor stored in the snapshot. Their components are skipped.
+	uint32_t unresolvedResourceCount = 0U;
+	// Components which were skipped because of unresolved resources or unknown material types.
+	uint32_t skippedComponentCount = 0U;
+};
+
+// SceneSnapshot is a native binary format of a World for fast loading.
+// Every component storage is one section with a flat array of entity indices and a flat array of records.
+// Strings are in a shared string table. Resources are referenced by their name crc and store their built data,
+// so loading creates missing resources without a SceneDatabase, producers or ECWorldConsumer.
+// Supported components : Name, Transform, Hierarchy, CollisionMesh, StaticMesh, Material, Skeleton, Animation, Light and Camera.
+// BlendShape and particle components reference SceneDatabase meshes so they are not stored.
+class SceneSnapshot final
+{
+public:
+	static constexpr uint32_t Magic = 0x57534443U; // "CDSW"
+	static constexpr uint32_t Version = 2U;
+
+public:
+	SceneSnapshot() = delete;
+
+	// Stores entities from firstEntity. All supported component storages need to be registered in world.
+	static bool Save(World& world, const char* pFilePath, Entity firstEntity = INVALID_ENTITY + 1);
+
+	// Appends snapshot entities to world with new consecutive entity ids.
+	// Materials are matched to materialTypes by name. Without a ResourceContext, components with resources are skipped.
+	static bool Load(World& world, ResourceContext* pResourceContext, const char* pFilePath, SceneSnapshotInfo* pInfo = nullptr,
+		std::span<const MaterialType* const> materialTypes = {});
+	static bool Load(World& world, ResourceContext* pResourceContext, const std::byte* pData, size_t size, SceneSnapshotInfo* pInfo = nullptr,
+		std::span<const MaterialType* const> materialTypes = {});
+	static bool Load(SceneWorld& sceneWorld, ResourceContext* pResourceContext, const char* pFilePath, SceneSnapshotInfo* pInfo = nullptr);
+};
+
+}
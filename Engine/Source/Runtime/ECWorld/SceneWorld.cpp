@@ -59,6 +59,7 @@ void SceneWorld::CreatePBRMaterialType(std::string shaderProgramName, bool isAtm
 	shaderSchema.AddFeatureSet({ ShaderFeature::NORMAL_MAP });
 	shaderSchema.AddFeatureSet({ ShaderFeature::ORM_MAP });
 	shaderSchema.AddFeatureSet({ ShaderFeature::EMISSIVE_MAP });
+	shaderSchema.AddFeatureSet({ ShaderFeature::TEXTURE_ARRAY });
 	// TODO : Compile atm shader in GL/VK mode correctly.
 	isAtmosphericScatteringEnable ? shaderSchema.AddFeatureSet({ ShaderFeature::IBL, ShaderFeature::ATM }) : shaderSchema.AddFeatureSet({ ShaderFeature::IBL });
 	shaderSchema.Build();
@@ -316,6 +317,8 @@ void SceneWorld::InitDDGISDK()
 
 void SceneWorld::Update()
 {
+	CD_MEMORY_TAG_SCOPE(ECS);
+
 #ifdef ENABLE_DDGI
 	// Send request 30 times per second.
 	static auto startTime = std::chrono::steady_clock::now();
@@ -347,4 +350,32 @@ void SceneWorld::Update()
 #endif
 }
 
+void SceneWorld::FixedUpdate(float fixedDeltaTime)
+{
+	for (Entity entity : GetAnimationEntities())
+	{
+		// Paused animations still step so that interpolation settles on the current time.
+		AnimationComponent* pAnimationComponent = GetAnimationComponent(entity);
+		const float stepTime = pAnimationComponent->IsPlaying() ? fixedDeltaTime * pAnimationComponent->GetPlayBackSpeed() : 0.0f;
+		pAnimationComponent->AdvanceRunningTime(stepTime);
+	}
+
+	// Particles only react to the last force field.
+	bool rotationForceField = false;
+	cd::Vec3f forceFieldRange = cd::Vec3f::Zero();
+	for (Entity entity : GetParticleForceFieldEntities())
+	{
+		ParticleForceFieldComponent* pForceFieldComponent = GetParticleForceFieldComponent(entity);
+		rotationForceField = pForceFieldComponent->GetRotationForce();
+		forceFieldRange = pForceFieldComponent->GetForceFieldRange() * GetTransformComponent(entity)->GetTransform().GetScale();
+	}
+
+	for (Entity entity : GetParticleEmitterEntities())
+	{
+		ParticleEmitterComponent* pEmitterComponent = GetParticleEmitterComponent(entity);
+		pEmitterComponent->GetParticlePool().SetRotationForceField(rotationForceField, forceFieldRange);
+		pEmitterComponent->Simulate(fixedDeltaTime, GetTransformComponent(entity)->GetTransform().GetTranslation());
+	}
+}
+
 }
\ No newline at end of file
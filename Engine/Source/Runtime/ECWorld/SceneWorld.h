@@ -140,9 +140,17 @@ public:
 
 	void Update();
 
+	// Advances simulation state such as animation time and particles by a fixed step.
+	void FixedUpdate(float fixedDeltaTime);
+
+	// Blend factor between the last two fixed steps for rendering.
+	void SetInterpolationAlpha(float alpha) { m_interpolationAlpha = alpha; }
+	float GetInterpolationAlpha() const { return m_interpolationAlpha; }
+
 private:
 	std::unique_ptr<cd::SceneDatabase> m_pSceneDatabase;
 	std::unique_ptr<engine::World> m_pWorld;
+	float m_interpolationAlpha = 0.0f;
 
 	std::unique_ptr<engine::MaterialType> m_pPBRMaterialType;
 	std::unique_ptr<engine::MaterialType> m_pAnimationMaterialType;
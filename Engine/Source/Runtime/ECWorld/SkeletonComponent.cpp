@@ -27,6 +27,9 @@ void SkeletonComponent::SetSkeletonAsset(const SkeletonResource* pSkeletonResour
 	m_boneVBH = m_pSkeletonResource->GetVertexBufferHandle();
 	m_boneGlobalMatrices.resize(boneCount, cd::Matrix4x4::Identity());
 	m_boneMatrices.resize(boneCount, cd::Matrix4x4::Identity());
+	m_localPose.Resize(boneCount);
+	m_blendPose.Resize(boneCount);
+	m_skinningMatrices.resize(boneCount, cd::Matrix4x4::Identity());
 }
 
 void SkeletonComponent::SetBoneGlobalMatrix(uint32_t index, const cd::Matrix4x4& boneGlobalMatrix)
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "Animation/AnimationLod.h"
+#include "Animation/CompressedAnimationClip.h"
+#include "Animation/SkinningPalette.h"
+#include "Animation/SoaPose.h"
 #include "Core/StringCrc.h"
 #include "ECWorld/Entity.h"
 #include "Scene/Bone.h"
@@ -46,8 +50,34 @@ public:
 
 	void SetBoneGlobalMatrix(uint32_t index, const cd::Matrix4x4& boneChangeMatrix);
 	const cd::Matrix4x4& GetBoneGlobalMatrix(uint32_t index) { return m_boneGlobalMatrices[index]; }
+	std::vector<cd::Matrix4x4>& GetBoneGlobalMatrices() { return m_boneGlobalMatrices; }
 	const std::vector<cd::Matrix4x4>& GetBoneGlobalMatrices() const { return m_boneGlobalMatrices; }
 
+	// Pose buffers of this entity. Sized to the bone count of the skeleton so evaluation never allocates.
+	SoaPose& GetLocalPose() { return m_localPose; }
+	SoaPose& GetBlendPose() { return m_blendPose; }
+	std::vector<cd::Matrix4x4>& GetSkinningMatrices() { return m_skinningMatrices; }
+	const std::vector<cd::Matrix4x4>& GetSkinningMatrices() const { return m_skinningMatrices; }
+
+	// Last keys of compressed clips sampled into the local and the blend pose.
+	AnimationSampleCursor& GetLocalSampleCursor() { return m_localSampleCursor; }
+	AnimationSampleCursor& GetBlendSampleCursor() { return m_blendSampleCursor; }
+
+	// LOD of the last frame and poses which are interpolated between two updates.
+	AnimationLodState& GetAnimationLodState() { return m_animationLodState; }
+	const AnimationLodState& GetAnimationLodState() const { return m_animationLodState; }
+
+	void SetSkinningMode(SkinningMode mode) { m_skinningMode = mode; }
+	SkinningMode GetSkinningMode() const { return m_skinningMode; }
+
+	// First texel of this entity in the bone palette texture. UINT32_MAX before the palette is built.
+	void SetBonePaletteTexel(uint32_t texel) { m_bonePaletteTexel = texel; }
+	uint32_t GetBonePaletteTexel() const { return m_bonePaletteTexel; }
+
+	// Dynamic vertex buffer with skinned positions and normals of this frame. UINT16_MAX when the mesh is skinned in vertex shaders.
+	void SetSkinnedVertexBuffer(uint16_t handle) { m_skinnedVertexBuffer = handle; }
+	uint16_t GetSkinnedVertexBuffer() const { return m_skinnedVertexBuffer; }
+
 	void SetBoneMatrix(uint32_t index, const cd::Matrix4x4& changeMatrix) { m_boneMatrices[index] = changeMatrix * m_boneMatrices[index]; }
 	const cd::Matrix4x4& GetBoneMatrix(uint32_t index) { return m_boneMatrices[index]; }
 
@@ -74,6 +104,16 @@ private:
 	std::vector<cd::Matrix4x4> m_boneMatrices;
 	std::vector<cd::AnimationID> m_animationID;
 
+	SoaPose m_localPose;
+	SoaPose m_blendPose;
+	std::vector<cd::Matrix4x4> m_skinningMatrices;
+	AnimationSampleCursor m_localSampleCursor;
+	AnimationSampleCursor m_blendSampleCursor;
+	AnimationLodState m_animationLodState;
+	SkinningMode m_skinningMode = SkinningMode::LinearBlend;
+	uint32_t m_bonePaletteTexel = UINT32_MAX;
+	uint16_t m_skinnedVertexBuffer = UINT16_MAX;
+
 };
 
 }
\ No newline at end of file
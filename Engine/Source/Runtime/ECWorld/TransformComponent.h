@@ -26,6 +26,8 @@ public:
 	const cd::Transform& GetTransform() const { return m_transform; }
 	cd::Transform& GetTransform() { return m_transform; }
 	void SetTransform(cd::Transform transform) { m_transform = cd::MoveTemp(transform); m_isMatrixDirty = true;  }
+	// Restores a transform with the world matrix which was built from it so that Build is not needed.
+	void SetTransform(cd::Transform transform, const cd::Matrix4x4& worldMatrix) { m_transform = cd::MoveTemp(transform); m_localToWorldMatrix = worldMatrix; m_isMatrixDirty = false; }
 
 	const cd::Matrix4x4& GetWorldMatrix() const { return m_localToWorldMatrix; }
 
@@ -2,6 +2,7 @@
 
 #include "ComponentsStorage.hpp"
 #include "Entity.h"
+#include "Core/Memory/MemoryTracker.h"
 #include "Core/StringCrc.h"
 
 #include <atomic>
@@ -26,12 +27,18 @@ public:
 
 	Entity CreateEntity()
 	{
-		// Overflow is expected as I want to use the max value of EntityID as invalid value.
-		// So I allocate entity id from 0.
-		static std::atomic<Entity> nextEntity = INVALID_ENTITY + 1;
-		return nextEntity.fetch_add(1);
+		return CreateEntities(1);
 	}
 
+	// Allocates count consecutive entities. Returns the first one.
+	Entity CreateEntities(uint32_t count)
+	{
+		return s_nextEntity.fetch_add(count);
+	}
+
+	// Entities which are created later have greater ids than it.
+	static Entity GetNextEntity() { return s_nextEntity.load(); }
+
 	template<typename Component>
 	ComponentsStorage<Component>* Register()
 	{
@@ -52,6 +59,7 @@ public:
 	template<typename Component>
 	Component& CreateComponent(Entity entity)
 	{
+		CD_MEMORY_TAG_SCOPE(ECS);
 		StringCrc componentName = Component::GetClassName();
 		assert(m_componentsLib.find(componentName.Value()) != m_componentsLib.end());
 		ComponentsStorage<Component>* pStorage = static_cast<ComponentsStorage<Component>*>(m_componentsLib[componentName.Value()].get());
@@ -59,6 +67,10 @@ public:
 	}
 
 private:
+	// Overflow is expected as I want to use the max value of EntityID as invalid value.
+	// So I allocate entity id from 0.
+	static inline std::atomic<Entity> s_nextEntity = INVALID_ENTITY + 1;
+
 	std::unordered_map<size_t, std::unique_ptr<IComponentsStorage>> m_componentsLib;
 };
 
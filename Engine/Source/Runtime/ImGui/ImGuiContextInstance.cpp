@@ -1,5 +1,6 @@
 ﻿#include "ImGuiContextInstance.h"
 
+#include "Core/Memory/MemoryTracker.h"
 #include "IconFont/IconsMaterialDesignIcons.h"
 #include "IconFont/MaterialDesign.inl"
 #include "ImGui/ImGuiBaseLayer.h"
@@ -177,6 +178,18 @@ namespace engine
 
 ImGuiContextInstance::ImGuiContextInstance(uint16_t width, uint16_t height, bool enableDock)
 {
+#ifdef ENABLE_MEMORY_TRACKING
+	// ImGui uses malloc by default which is invisible to operator new.
+	ImGui::SetAllocatorFunctions(
+		[](size_t size, void*) -> void*
+		{
+			MemoryTagScope scope(MemoryTag::ImGui);
+			return MemoryTracker::Allocate(size);
+		},
+		[](void* pMemory, void*) { MemoryTracker::Free(pMemory); });
+#endif
+
+	CD_MEMORY_TAG_SCOPE(ImGui);
 	m_pImGuiContext = ImGui::CreateContext();
 	SwitchCurrentContext();
 
@@ -317,6 +330,7 @@ void ImGuiContextInstance::EndDockSpace()
 
 void ImGuiContextInstance::Update(float deltaTime)
 {
+	CD_MEMORY_TAG_SCOPE(ImGui);
 	SwitchCurrentContext();
 
 	// It is necessary to pass correct deltaTime to ImGui underlaying framework because it will use the value to check
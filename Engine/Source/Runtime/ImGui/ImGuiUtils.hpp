@@ -321,8 +321,10 @@ static bool ImGuiTransformProperty(const char* pName, cd::Transform& value, cd::
 }
 
 template<typename T>
-static void ColorPickerProperty(const char* pName, T& color)
+static bool ColorPickerProperty(const char* pName, T& color)
 {
+	bool dirty = false;
+
 	static std::map<const char*, bool> showMap;
 	if (!showMap.count(pName))
 	{
@@ -342,11 +344,11 @@ static void ColorPickerProperty(const char* pName, T& color)
 	ImGui::NextColumn();
 	if constexpr (std::is_same<T, cd::Vec3f>())
 	{
-		ImGui::DragFloat3("", color.begin(), 0, 0.0f, 1.0f);
+		dirty |= ImGui::DragFloat3("", color.begin(), 0, 0.0f, 1.0f);
 	}
 	else if constexpr (std::is_same<T, cd::Vec4f>())
 	{
-		ImGui::DragFloat4("", color.begin(), 0, 0.0f, 1.0f);
+		dirty |= ImGui::DragFloat4("", color.begin(), 0, 0.0f, 1.0f);
 	}
 	else
 	{
@@ -366,16 +368,18 @@ static void ColorPickerProperty(const char* pName, T& color)
 		ImGui::Begin(pName, &showMap[pName], ImGuiWindowFlags_NoMove | ImGuiWindowFlags_AlwaysAutoResize);
 		if constexpr (std::is_same<T, cd::Vec3f>())
 		{
-			ImGui::ColorPicker3("Color Picker", color.begin());
+			dirty |= ImGui::ColorPicker3("Color Picker", color.begin());
 		}
 		else if constexpr (std::is_same<T, cd::Vec4f>())
 		{
-			ImGui::ColorPicker4("Color Picker", color.begin());
+			dirty |= ImGui::ColorPicker4("Color Picker", color.begin());
 		}
 		ImGui::End();
 	}
 	ImGui::Separator();
 	ImGui::PopID();
+
+	return dirty;
 }
 
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "DebugPanel.h"
+#include "Core/Memory/MemoryTracker.h"
 #include "ImGui/IconFont/IconsMaterialDesignIcons.h"
+#include "Log/Log.h"
 
 #include <bgfx/bgfx.h>
 #include <bx/string.h>
@@ -76,7 +78,7 @@ void DebugPanel::Init()
 
 void DebugPanel::Update()
 {
-	ImGui::SetNextWindowSize(ImVec2(350, 200.0f));
+	ImGui::SetNextWindowSize(ImVec2(350, 400.0f));
 
 	ImGui::Begin(GetName(), &m_isEnable);
 
@@ -84,6 +86,8 @@ void DebugPanel::Update()
 
 	ImGui::Separator();
 
+	ShowMemory();
+
 	ImGui::End();
 }
 
@@ -138,4 +142,71 @@ void DebugPanel::ShowProfiler()
 	}
 }
 
+void DebugPanel::ShowMemory()
+{
+#ifdef ENABLE_MEMORY_TRACKING
+	constexpr size_t TagCount = static_cast<size_t>(MemoryTag::Count);
+	static uint64_t s_lastAllocationCounts[TagCount + 1] = {};
+
+	if (!ImGui::BeginTable("Memory", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp))
+	{
+		return;
+	}
+
+	ImGui::TableSetupColumn("Tag");
+	ImGui::TableSetupColumn("Live");
+	ImGui::TableSetupColumn("Peak");
+	ImGui::TableSetupColumn("Allocs/Frame");
+	ImGui::TableHeadersRow();
+
+	auto showRow = [](const char* pName, const MemoryTagStats& stats, uint64_t& lastAllocationCount)
+	{
+		char liveText[64];
+		bx::prettify(liveText, BX_COUNTOF(liveText), static_cast<uint64_t>(bx::max<int64_t>(stats.liveBytes, 0)));
+		char peakText[64];
+		bx::prettify(peakText, BX_COUNTOF(peakText), static_cast<uint64_t>(bx::max<int64_t>(stats.peakBytes, 0)));
+
+		ImGui::TableNextRow();
+		ImGui::TableNextColumn();
+		ImGui::TextUnformatted(pName);
+		ImGui::TableNextColumn();
+		ImGui::TextUnformatted(liveText);
+		ImGui::TableNextColumn();
+		ImGui::TextUnformatted(peakText);
+		ImGui::TableNextColumn();
+		ImGui::Text("%llu", static_cast<unsigned long long>(stats.allocationCount - lastAllocationCount));
+		lastAllocationCount = stats.allocationCount;
+	};
+
+	for (size_t tagIndex = 0U; tagIndex < TagCount; ++tagIndex)
+	{
+		MemoryTag tag = static_cast<MemoryTag>(tagIndex);
+		showRow(MemoryTracker::GetTagName(tag), MemoryTracker::GetStats(tag), s_lastAllocationCounts[tagIndex]);
+	}
+	showRow("Total", MemoryTracker::GetTotalStats(), s_lastAllocationCounts[TagCount]);
+
+	ImGui::EndTable();
+
+	if (ImGui::Button("Dump"))
+	{
+		constexpr const char* pFilePath = "CatDogMemory.txt";
+		if (MemoryTracker::DumpToFile(pFilePath))
+		{
+			CD_ENGINE_INFO("Memory stats saved to {0}", pFilePath);
+		}
+		else
+		{
+			CD_ENGINE_ERROR("Failed to save memory stats to {0}", pFilePath);
+		}
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Reset Peaks"))
+	{
+		MemoryTracker::ResetPeaks();
+	}
+#else
+	ImGui::TextUnformatted("Memory tracking is disabled");
+#endif
+}
+
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Profiler.h"
 #include "ImGui/IconFont/IconsMaterialDesignIcons.h"
+#include "Log/Log.h"
+#include "Profiling/FrameProfiler.h"
 
 #include <bgfx/bgfx.h>
 #include <bx/string.h>
@@ -70,6 +72,7 @@ void Profiler::Update()
     static bool showFPS = true;
     static bool showFrameTime = true;
     static bool showViewStats = true;
+    static bool showRendererStats = true;
     static bool showGPUMemory = true;
 
     // title
@@ -186,6 +189,75 @@ void Profiler::Update()
         }
     }
 
+    if (showRendererStats)
+    {
+        ImGui::Separator();
+        ImGui::Text("Renderer stats");
+
+        FrameProfiler& frameProfiler = FrameProfiler::Get();
+        bool isProfilerEnabled = FrameProfiler::IsEnabled();
+        if (ImGui::Checkbox("Enable", &isProfilerEnabled))
+        {
+            FrameProfiler::SetEnable(isProfilerEnabled);
+        }
+
+        // Save the trace when the capture which this button started is finished.
+        static bool isCapturePending = false;
+        ImGui::SameLine();
+        if (frameProfiler.IsCapturing())
+        {
+            ImGui::TextDisabled("Capturing...");
+        }
+        else if (ImGui::Button("Capture"))
+        {
+            // Nothing is recorded while the profiler is off.
+            FrameProfiler::SetEnable(true);
+            frameProfiler.BeginCapture();
+            isCapturePending = true;
+        }
+
+        if (isCapturePending && !frameProfiler.IsCapturing())
+        {
+            constexpr const char* pTraceFilePath = "CatDogProfile.json";
+            if (frameProfiler.WriteChromeTrace(pTraceFilePath))
+            {
+                CD_ENGINE_INFO("Saved {0} frames of profile to {1}", frameProfiler.GetCapturedFrameCount(), pTraceFilePath);
+            }
+            else
+            {
+                CD_ENGINE_ERROR("Failed to save profile to {0}", pTraceFilePath);
+            }
+            isCapturePending = false;
+        }
+
+#ifdef ENABLE_PROFILING
+        for (const ProfileRendererStats& rendererStats : frameProfiler.GetRendererStats())
+        {
+            if (rendererStats.name.empty())
+            {
+                ImGui::Text("View %u", rendererStats.viewID);
+            }
+            else
+            {
+                ImGui::Text("%s", rendererStats.name.c_str());
+            }
+            ImGui::SameLine(overlayWidth * 1.2f);
+            ImGui::Text("CPU: %.2f ms", rendererStats.cpuMs);
+            ImGui::SameLine(overlayWidth * 1.8f);
+            ImGui::Text("GPU: %.2f ms", rendererStats.gpuMs);
+        }
+
+        for (const ProfileCounter& counter : frameProfiler.GetCounters())
+        {
+            ImGui::Text("%s", counter.pName);
+            ImGui::SameLine(overlayWidth * 1.2f);
+            ImGui::Text("%lld", static_cast<long long>(counter.value));
+        }
+#else
+        ImGui::TextWrapped("Compiled without ENABLE_PROFILING");
+#endif
+    }
+
     if (showGPUMemory)
     {
         int64_t used = stats->gpuMemoryUsed;
@@ -233,6 +305,7 @@ void Profiler::Update()
         ImGui::Checkbox("FPS", &showFPS);
         ImGui::Checkbox("Frame time", &showFrameTime);
         ImGui::Checkbox("View stats", &showViewStats);
+        ImGui::Checkbox("Renderer stats", &showRendererStats);
         ImGui::Checkbox("GPU memory", &showGPUMemory);
         ImGui::EndPopup();
     }
@@ -46,47 +46,8 @@ public:
     }
 
 public:
-	Particle() { Reset(); }
-	Particle(const Particle&) = default;
-	Particle& operator=(const Particle&) = default;
-	Particle(Particle&&) = default;
-	Particle& operator=(Particle&&) = default;
-	~Particle() = default;
-
-    cd::Vec3f& GetPos() { return m_particlePos; }
-    void SetPos(cd::Vec3f pos) { m_particlePos = pos; }
-
-    cd::Vec3f GetSpeed() { return m_particleSpeed; }
-    void SetSpeed(cd::Vec3f speed) { m_particleSpeed = speed; }
-
-    void SetAcceleration(cd::Vec3f acceleration) { m_particleAcceleration = acceleration; }
-    void SetColor(cd::Vec4f color) { m_particleColor = color; }
-    
-    void SetLifeTime(float lifeTime) { m_lifeTime = lifeTime; }
-
-    void SetRotationForceField(bool value) { m_rotationForceField = value; }
-    void SetRotationForceFieldRange(cd::Vec3f range) { m_rotationForceFieldRange = range; }
-
-    void Active() { m_isActive = true; }
-    bool isActive() const { return m_isActive; }
-
-    void Reset();
-
-    void Update(float deltaTime);
-
-private:
-    cd::Vec3f m_particlePos;
-    cd::Vec3f m_particleSpeed;
-    cd::Vec3f m_particleAcceleration;
-
-    bool m_rotationForceField = false;
-    cd::Vec3f m_rotationForceFieldRange;
-
-    bool m_isActive;
-    float m_currentTime;
-    float m_lifeTime;
-
-    cd::Color m_particleColor;
+	// Particle state lives in the streams of ParticlePool.
+	Particle() = delete;
 };
 
 }
\ No newline at end of file
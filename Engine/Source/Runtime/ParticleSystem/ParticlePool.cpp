@@ -1,71 +1,457 @@
 #include "ParticlePool.h"
 
+#include "Core/Memory/FrameArena.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#if defined(__AVX__)
+#define CD_PARTICLE_KERNELS_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CD_PARTICLE_KERNELS_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define CD_PARTICLE_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
 namespace engine
 {
 
-int ParticlePool::AllocateParticleIndex()
+namespace
 {
-	int particleIndex = -1;
-	if (!m_freeParticleIndexes.empty())
+
+constexpr size_t StreamCount = static_cast<size_t>(ParticleStream::Count);
+
+struct ScalarOps
+{
+	using Type = float;
+	using Mask = bool;
+	static constexpr uint32_t Width = 1U;
+
+	static Type Load(const float* pValue) { return *pValue; }
+	static void Store(float* pValue, Type value) { *pValue = value; }
+	static Type Set(float value) { return value; }
+	static Type Add(Type a, Type b) { return a + b; }
+	static Type Sub(Type a, Type b) { return a - b; }
+	static Type Mul(Type a, Type b) { return a * b; }
+	static Mask Less(Type a, Type b) { return a < b; }
+	static Mask Greater(Type a, Type b) { return a > b; }
+	static Mask GreaterEqual(Type a, Type b) { return a >= b; }
+	static Mask And(Mask a, Mask b) { return a && b; }
+	// value where mask is set, 0 elsewhere.
+	static Type Select(Mask mask, Type value) { return mask ? value : 0.0f; }
+	// One bit per lane.
+	static uint32_t GetBits(Mask mask) { return mask ? 1U : 0U; }
+};
+
+#if defined(CD_PARTICLE_KERNELS_AVX)
+struct SimdOps
+{
+	using Type = __m256;
+	using Mask = __m256;
+	static constexpr uint32_t Width = 8U;
+
+	static Type Load(const float* pValue) { return _mm256_load_ps(pValue); }
+	static void Store(float* pValue, Type value) { _mm256_store_ps(pValue, value); }
+	static Type Set(float value) { return _mm256_set1_ps(value); }
+	static Type Add(Type a, Type b) { return _mm256_add_ps(a, b); }
+	static Type Sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+	static Type Mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+	static Mask Less(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	static Mask Greater(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	static Mask GreaterEqual(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+	static Mask And(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+	static Type Select(Mask mask, Type value) { return _mm256_and_ps(mask, value); }
+	static uint32_t GetBits(Mask mask) { return static_cast<uint32_t>(_mm256_movemask_ps(mask)); }
+};
+#elif defined(CD_PARTICLE_KERNELS_SSE)
+struct SimdOps
+{
+	using Type = __m128;
+	using Mask = __m128;
+	static constexpr uint32_t Width = 4U;
+
+	static Type Load(const float* pValue) { return _mm_load_ps(pValue); }
+	static void Store(float* pValue, Type value) { _mm_store_ps(pValue, value); }
+	static Type Set(float value) { return _mm_set1_ps(value); }
+	static Type Add(Type a, Type b) { return _mm_add_ps(a, b); }
+	static Type Sub(Type a, Type b) { return _mm_sub_ps(a, b); }
+	static Type Mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+	static Mask Less(Type a, Type b) { return _mm_cmplt_ps(a, b); }
+	static Mask Greater(Type a, Type b) { return _mm_cmpgt_ps(a, b); }
+	static Mask GreaterEqual(Type a, Type b) { return _mm_cmpge_ps(a, b); }
+	static Mask And(Mask a, Mask b) { return _mm_and_ps(a, b); }
+	static Type Select(Mask mask, Type value) { return _mm_and_ps(mask, value); }
+	static uint32_t GetBits(Mask mask) { return static_cast<uint32_t>(_mm_movemask_ps(mask)); }
+};
+#elif defined(CD_PARTICLE_KERNELS_NEON)
+struct SimdOps
+{
+	using Type = float32x4_t;
+	using Mask = uint32x4_t;
+	static constexpr uint32_t Width = 4U;
+
+	static Type Load(const float* pValue) { return vld1q_f32(pValue); }
+	static void Store(float* pValue, Type value) { vst1q_f32(pValue, value); }
+	static Type Set(float value) { return vdupq_n_f32(value); }
+	static Type Add(Type a, Type b) { return vaddq_f32(a, b); }
+	static Type Sub(Type a, Type b) { return vsubq_f32(a, b); }
+	static Type Mul(Type a, Type b) { return vmulq_f32(a, b); }
+	static Mask Less(Type a, Type b) { return vcltq_f32(a, b); }
+	static Mask Greater(Type a, Type b) { return vcgtq_f32(a, b); }
+	static Mask GreaterEqual(Type a, Type b) { return vcgeq_f32(a, b); }
+	static Mask And(Mask a, Mask b) { return vandq_u32(a, b); }
+	static Type Select(Mask mask, Type value) { return vreinterpretq_f32_u32(vandq_u32(mask, vreinterpretq_u32_f32(value))); }
+	static uint32_t GetBits(Mask mask)
 	{
-		int index = m_freeParticleIndexes.back();
-		m_freeParticleIndexes.pop_back();
-		particleIndex = index;
+		const uint32_t laneBits[4] = { 1U, 2U, 4U, 8U };
+		return vaddvq_u32(vandq_u32(mask, vld1q_u32(laneBits)));
 	}
-	else
+};
+#else
+using SimdOps = ScalarOps;
+#endif
+
+static_assert(ParticlePool::LaneCount % SimdOps::Width == 0U, "Particle padding should cover a whole SIMD register.");
+
+template<typename Ops, bool RotationForceField>
+void UpdateImpl(ParticlePool& pool, uint32_t count, float deltaTime, const cd::Vec3f& forceFieldRange, std::vector<uint32_t>& deadIndexes)
+{
+	float* pPositionX = pool.GetStream(ParticleStream::PositionX);
+	float* pPositionY = pool.GetStream(ParticleStream::PositionY);
+	float* pPositionZ = pool.GetStream(ParticleStream::PositionZ);
+	float* pVelocityX = pool.GetStream(ParticleStream::VelocityX);
+	float* pVelocityY = pool.GetStream(ParticleStream::VelocityY);
+	float* pVelocityZ = pool.GetStream(ParticleStream::VelocityZ);
+	float* pAccelerationX = pool.GetStream(ParticleStream::AccelerationX);
+	float* pAccelerationY = pool.GetStream(ParticleStream::AccelerationY);
+	float* pAccelerationZ = pool.GetStream(ParticleStream::AccelerationZ);
+	float* pAge = pool.GetStream(ParticleStream::Age);
+	const float* pLifeTime = pool.GetStream(ParticleStream::LifeTime);
+
+	const typename Ops::Type dt = Ops::Set(deltaTime);
+	const typename Ops::Type halfDtSquared = Ops::Set(0.5f * deltaTime * deltaTime);
+	const typename Ops::Type half = Ops::Set(0.5f);
+	const typename Ops::Type rangeX = Ops::Set(forceFieldRange.x());
+	const typename Ops::Type rangeY = Ops::Set(forceFieldRange.y());
+	const typename Ops::Type rangeZ = Ops::Set(forceFieldRange.z());
+	const typename Ops::Type negativeRangeX = Ops::Set(-forceFieldRange.x());
+	const typename Ops::Type negativeRangeY = Ops::Set(-forceFieldRange.y());
+	const typename Ops::Type negativeRangeZ = Ops::Set(-forceFieldRange.z());
+
+	// Lanes past count are padding. Their results are never read.
+	for (uint32_t index = 0U; index < count; index += Ops::Width)
 	{
-		++m_currentParticleCount;
-		if (m_currentParticleCount >= m_maxParticleCount)
+		const typename Ops::Type accelerationX = Ops::Load(pAccelerationX + index);
+		const typename Ops::Type accelerationY = Ops::Load(pAccelerationY + index);
+		const typename Ops::Type accelerationZ = Ops::Load(pAccelerationZ + index);
+		typename Ops::Type velocityX = Ops::Load(pVelocityX + index);
+		typename Ops::Type velocityY = Ops::Load(pVelocityY + index);
+		typename Ops::Type velocityZ = Ops::Load(pVelocityZ + index);
+
+		// p += v * dt + a * dt^2 / 2 and v += a * dt.
+		const typename Ops::Type positionX = Ops::Add(Ops::Load(pPositionX + index), Ops::Add(Ops::Mul(velocityX, dt), Ops::Mul(accelerationX, halfDtSquared)));
+		const typename Ops::Type positionY = Ops::Add(Ops::Load(pPositionY + index), Ops::Add(Ops::Mul(velocityY, dt), Ops::Mul(accelerationY, halfDtSquared)));
+		const typename Ops::Type positionZ = Ops::Add(Ops::Load(pPositionZ + index), Ops::Add(Ops::Mul(velocityZ, dt), Ops::Mul(accelerationZ, halfDtSquared)));
+		velocityX = Ops::Add(velocityX, Ops::Mul(accelerationX, dt));
+		velocityY = Ops::Add(velocityY, Ops::Mul(accelerationY, dt));
+		velocityZ = Ops::Add(velocityZ, Ops::Mul(accelerationZ, dt));
+		Ops::Store(pPositionX + index, positionX);
+		Ops::Store(pPositionY + index, positionY);
+		Ops::Store(pPositionZ + index, positionZ);
+		Ops::Store(pVelocityX + index, velocityX);
+		Ops::Store(pVelocityY + index, velocityY);
+		Ops::Store(pVelocityZ + index, velocityZ);
+
+		if constexpr (RotationForceField)
 		{
-			m_currentParticleCount = 0;
+			// a -= cross(z, v) / 2 inside of the range.
+			const typename Ops::Mask isInside = Ops::And(
+				Ops::And(Ops::And(Ops::Less(positionX, rangeX), Ops::Greater(positionX, negativeRangeX)),
+					Ops::And(Ops::Less(positionY, rangeY), Ops::Greater(positionY, negativeRangeY))),
+				Ops::And(Ops::Less(positionZ, rangeZ), Ops::Greater(positionZ, negativeRangeZ)));
+			Ops::Store(pAccelerationX + index, Ops::Add(accelerationX, Ops::Select(isInside, Ops::Mul(velocityY, half))));
+			Ops::Store(pAccelerationY + index, Ops::Sub(accelerationY, Ops::Select(isInside, Ops::Mul(velocityX, half))));
 		}
 
-		if (m_particles[m_currentParticleCount].isActive())
+		const typename Ops::Type age = Ops::Add(Ops::Load(pAge + index), dt);
+		Ops::Store(pAge + index, age);
+
+		uint32_t deadBits = Ops::GetBits(Ops::GreaterEqual(age, Ops::Load(pLifeTime + index)));
+		while (deadBits != 0U)
 		{
-			particleIndex = -1;
+			uint32_t lane = 0U;
+			while (0U == (deadBits & (1U << lane)))
+			{
+				++lane;
+			}
+			deadBits &= deadBits - 1U;
+
+			if (index + lane < count)
+			{
+				deadIndexes.push_back(index + lane);
+			}
 		}
-		else
+	}
+}
+
+template<typename Ops>
+void UpdateImpl(ParticlePool& pool, uint32_t count, float deltaTime, bool rotationForceField, const cd::Vec3f& forceFieldRange, std::vector<uint32_t>& deadIndexes)
+{
+	if (rotationForceField)
+	{
+		UpdateImpl<Ops, true>(pool, count, deltaTime, forceFieldRange, deadIndexes);
+	}
+	else
+	{
+		UpdateImpl<Ops, false>(pool, count, deltaTime, forceFieldRange, deadIndexes);
+	}
+}
+
+}
+
+const char* ParticlePool::GetInstructionSetName()
+{
+#if defined(CD_PARTICLE_KERNELS_AVX)
+	return "AVX";
+#elif defined(CD_PARTICLE_KERNELS_SSE)
+	return "SSE2";
+#elif defined(CD_PARTICLE_KERNELS_NEON)
+	return "NEON";
+#else
+	return "Scalar";
+#endif
+}
+
+ParticlePool::ParticlePool(const ParticlePool& other)
+{
+	*this = other;
+}
+
+ParticlePool& ParticlePool::operator=(const ParticlePool& other)
+{
+	if (this != &other)
+	{
+		Free();
+		if (other.m_pData)
 		{
-			particleIndex = m_currentParticleCount;
+			m_pData = static_cast<float*>(::operator new(StreamCount * other.m_paddedMaxCount * sizeof(float), std::align_val_t{ Alignment }));
+			std::memcpy(m_pData, other.m_pData, StreamCount * other.m_paddedMaxCount * sizeof(float));
 		}
+		m_maxCount = other.m_maxCount;
+		m_paddedMaxCount = other.m_paddedMaxCount;
+		m_activeCount = other.m_activeCount;
+		m_lastDeltaTime = other.m_lastDeltaTime;
+		m_rotationForceField = other.m_rotationForceField;
+		m_rotationForceFieldRange = other.m_rotationForceFieldRange;
 	}
 
-	if (particleIndex != -1)
+	return *this;
+}
+
+ParticlePool::ParticlePool(ParticlePool&& other) noexcept
+	: m_pData(std::exchange(other.m_pData, nullptr))
+	, m_maxCount(std::exchange(other.m_maxCount, 0U))
+	, m_paddedMaxCount(std::exchange(other.m_paddedMaxCount, 0U))
+	, m_activeCount(std::exchange(other.m_activeCount, 0U))
+	, m_lastDeltaTime(other.m_lastDeltaTime)
+	, m_rotationForceField(other.m_rotationForceField)
+	, m_rotationForceFieldRange(other.m_rotationForceFieldRange)
+	, m_deadIndexes(std::move(other.m_deadIndexes))
+{
+}
+
+ParticlePool& ParticlePool::operator=(ParticlePool&& other) noexcept
+{
+	if (this != &other)
 	{
-		m_particles[particleIndex].Reset();
-		m_particles[particleIndex].Active();
+		Free();
+		m_pData = std::exchange(other.m_pData, nullptr);
+		m_maxCount = std::exchange(other.m_maxCount, 0U);
+		m_paddedMaxCount = std::exchange(other.m_paddedMaxCount, 0U);
+		m_activeCount = std::exchange(other.m_activeCount, 0U);
+		m_lastDeltaTime = other.m_lastDeltaTime;
+		m_rotationForceField = other.m_rotationForceField;
+		m_rotationForceFieldRange = other.m_rotationForceFieldRange;
+		m_deadIndexes = std::move(other.m_deadIndexes);
 	}
 
-	return particleIndex;
+	return *this;
 }
 
-void ParticlePool::Update(float deltaTime)
+ParticlePool::~ParticlePool()
+{
+	Free();
+}
+
+int ParticlePool::AllocateParticleIndex()
+{
+	if (m_activeCount >= m_maxCount)
+	{
+		return -1;
+	}
+
+	const uint32_t index = m_activeCount++;
+	for (ParticleStream stream : { ParticleStream::PositionX, ParticleStream::PositionY, ParticleStream::PositionZ,
+		ParticleStream::VelocityX, ParticleStream::VelocityY, ParticleStream::VelocityZ,
+		ParticleStream::AccelerationX, ParticleStream::AccelerationY, ParticleStream::AccelerationZ, ParticleStream::Age })
+	{
+		GetStream(stream)[index] = 0.0f;
+	}
+	GetStream(ParticleStream::LifeTime)[index] = 6.0f;
+	SetColor(static_cast<int>(index), cd::Vec4f::One());
+
+	return static_cast<int>(index);
+}
+
+void ParticlePool::SetParticleMaxCount(int count)
 {
-	m_currentActiveCount = 0;
-	for (int i = 0; i < m_maxParticleCount; ++i)
+	const uint32_t maxCount = static_cast<uint32_t>(std::max(count, 0));
+	if (maxCount == m_maxCount)
 	{
-		if (!m_particles[i].isActive())
+		return;
+	}
+
+	const uint32_t paddedMaxCount = (maxCount + LaneCount - 1U) / LaneCount * LaneCount;
+	const uint32_t activeCount = std::min(m_activeCount, maxCount);
+	float* pData = nullptr;
+	if (paddedMaxCount > 0U)
+	{
+		pData = static_cast<float*>(::operator new(StreamCount * paddedMaxCount * sizeof(float), std::align_val_t{ Alignment }));
+		std::memset(pData, 0, StreamCount * paddedMaxCount * sizeof(float));
+		for (size_t streamIndex = 0U; streamIndex < StreamCount && activeCount > 0U; ++streamIndex)
 		{
-			continue;
+			std::memcpy(pData + streamIndex * paddedMaxCount, m_pData + streamIndex * m_paddedMaxCount, activeCount * sizeof(float));
 		}
+	}
+
+	Free();
+	m_pData = pData;
+	m_maxCount = maxCount;
+	m_paddedMaxCount = paddedMaxCount;
+	m_activeCount = activeCount;
+}
+
+cd::Vec4f ParticlePool::GetColor(int index) const
+{
+	return cd::Vec4f(GetStream(ParticleStream::ColorR)[index], GetStream(ParticleStream::ColorG)[index],
+		GetStream(ParticleStream::ColorB)[index], GetStream(ParticleStream::ColorA)[index]);
+}
+
+void ParticlePool::SetColor(int index, const cd::Vec4f& color)
+{
+	GetStream(ParticleStream::ColorR)[index] = color.x();
+	GetStream(ParticleStream::ColorG)[index] = color.y();
+	GetStream(ParticleStream::ColorB)[index] = color.z();
+	GetStream(ParticleStream::ColorA)[index] = color.w();
+}
+
+cd::Vec3f ParticlePool::GetInterpolatedPosition(int index, float alpha) const
+{
+	// p(t - s) = p - v * s + a * s^2 / 2 inverts the integration in Update for a constant acceleration.
+	const float rewindTime = std::min((1.0f - std::clamp(alpha, 0.0f, 1.0f)) * m_lastDeltaTime, GetAge(index));
+	const cd::Vec3f velocity = GetVelocity(index);
+	const cd::Vec3f acceleration = GetAcceleration(index);
+	const float halfRewindTimeSquared = 0.5f * rewindTime * rewindTime;
+	cd::Vec3f position = GetPosition(index);
+	position.x() += acceleration.x() * halfRewindTimeSquared - velocity.x() * rewindTime;
+	position.y() += acceleration.y() * halfRewindTimeSquared - velocity.y() * rewindTime;
+	position.z() += acceleration.z() * halfRewindTimeSquared - velocity.z() * rewindTime;
+	return position;
+}
+
+int ParticlePool::GetSpawnOrderPositions(cd::Vec4f* pPositions, int maxCount, float alpha) const
+{
+	// Dead particles are swap removed so the pool is not in spawn order.
+	FrameVector<int> particleIndexes;
+	particleIndexes.reserve(m_activeCount);
+	for (int particleIndex = 0; particleIndex < GetParticleActiveCount(); ++particleIndex)
+	{
+		particleIndexes.push_back(particleIndex);
+	}
+	std::sort(particleIndexes.begin(), particleIndexes.end(), [this](int a, int b) { return GetAge(a) > GetAge(b); });
+
+	const int positionCount = std::min(GetParticleActiveCount(), maxCount);
+	for (int i = 0; i < positionCount; ++i)
+	{
+		const cd::Vec3f position = GetInterpolatedPosition(particleIndexes[i], alpha);
+		pPositions[i] = cd::Vec4f(position.x(), position.y(), position.z(), 0.0f);
+	}
 
-		m_particles[i].Update(deltaTime);
-		if (!m_particles[i].isActive())
+	return positionCount;
+}
+
+void ParticlePool::SetRotationForceField(bool enabled, const cd::Vec3f& range)
+{
+	m_rotationForceField = enabled;
+	m_rotationForceFieldRange = range;
+}
+
+void ParticlePool::Update(float deltaTime)
+{
+	UpdateImpl<SimdOps>(*this, m_activeCount, deltaTime, m_rotationForceField, m_rotationForceFieldRange, m_deadIndexes);
+	RemoveDeadParticles();
+	m_lastDeltaTime = deltaTime;
+}
+
+void ParticlePool::UpdateScalar(float deltaTime)
+{
+	UpdateImpl<ScalarOps>(*this, m_activeCount, deltaTime, m_rotationForceField, m_rotationForceFieldRange, m_deadIndexes);
+	RemoveDeadParticles();
+	m_lastDeltaTime = deltaTime;
+}
+
+void ParticlePool::AllParticlesReset()
+{
+	m_activeCount = 0U;
+	m_deadIndexes.clear();
+}
+
+cd::Vec3f ParticlePool::GetVec3(ParticleStream firstStream, int index) const
+{
+	const float* pX = GetStream(firstStream);
+	return cd::Vec3f(pX[index], pX[m_paddedMaxCount + index], pX[2U * m_paddedMaxCount + index]);
+}
+
+void ParticlePool::SetVec3(ParticleStream firstStream, int index, const cd::Vec3f& value)
+{
+	float* pX = GetStream(firstStream);
+	pX[index] = value.x();
+	pX[m_paddedMaxCount + index] = value.y();
+	pX[2U * m_paddedMaxCount + index] = value.z();
+}
+
+void ParticlePool::RemoveDeadParticles()
+{
+	// From the back so that the last particle is always alive when it fills a hole.
+	for (auto itDead = m_deadIndexes.rbegin(); itDead != m_deadIndexes.rend(); ++itDead)
+	{
+		const uint32_t lastIndex = --m_activeCount;
+		if (*itDead == lastIndex)
 		{
-			m_freeParticleIndexes.push_back(i);
+			continue;
 		}
-		else
+
+		for (size_t streamIndex = 0U; streamIndex < StreamCount; ++streamIndex)
 		{
-			++m_currentActiveCount;
+			float* pStream = m_pData + streamIndex * m_paddedMaxCount;
+			pStream[*itDead] = pStream[lastIndex];
 		}
 	}
+	m_deadIndexes.clear();
 }
 
-void ParticlePool::AllParticlesReset()
+void ParticlePool::Free()
 {
-	m_particles.resize(m_maxParticleCount);
-	m_freeParticleIndexes.clear();
-	m_freeParticleIndexes.reserve(m_maxParticleCount);
+	if (m_pData)
+	{
+		::operator delete(m_pData, std::align_val_t{ Alignment });
+		m_pData = nullptr;
+	}
 }
 
 }
@@ -1,9 +1,9 @@
 #pragma once
 
-#include "Base/Template.h"
-#include "Core/StringCrc.h"
 #include "Math/Vector.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 #include "Particle.h"
@@ -11,31 +11,106 @@
 namespace engine
 {
 
+// Components of a particle stream. Every stream stores one float per particle.
+enum class ParticleStream : uint8_t
+{
+	PositionX,
+	PositionY,
+	PositionZ,
+	VelocityX,
+	VelocityY,
+	VelocityZ,
+	AccelerationX,
+	AccelerationY,
+	AccelerationZ,
+	Age,
+	LifeTime,
+	ColorR,
+	ColorG,
+	ColorB,
+	ColorA,
+	Count
+};
+
+// ParticlePool stores particles as separate float streams so that the update kernel integrates several
+// particles per instruction. Alive particles are always the first GetParticleActiveCount() ones:
+// dead particles are swap removed with the last one, so the order of particles changes when they die.
+// Streams are aligned and padded to LaneCount particles so kernels never need a scalar tail.
 class ParticlePool final
 {
+public:
+	// Enough for AVX. SSE and NEON process half of it per instruction.
+	static constexpr uint32_t LaneCount = 8U;
+	static constexpr size_t Alignment = LaneCount * sizeof(float);
+
+	static const char* GetInstructionSetName();
+
 public:
 	ParticlePool() = default;
-	ParticlePool(const ParticlePool&) = default;
-	ParticlePool& operator=(const ParticlePool&) = default;
-	ParticlePool(ParticlePool&&) = default;
-	ParticlePool& operator=(ParticlePool&&) = default;
-	~ParticlePool() = default;
+	ParticlePool(const ParticlePool& other);
+	ParticlePool& operator=(const ParticlePool& other);
+	ParticlePool(ParticlePool&& other) noexcept;
+	ParticlePool& operator=(ParticlePool&& other) noexcept;
+	~ParticlePool();
 
+	// Returns the index of a new particle with default values or -1 if the pool is full.
 	int AllocateParticleIndex();
-	Particle& GetParticle(int index) { return m_particles[index]; }
-	int GetParticleActiveCount() { return m_currentActiveCount; }
-	int& GetParticleMaxCount() { return m_maxParticleCount; }
-	void SetParticleMaxCount(int count) { m_maxParticleCount = count; }
+	int GetParticleActiveCount() const { return static_cast<int>(m_activeCount); }
+	int GetParticleMaxCount() const { return static_cast<int>(m_maxCount); }
+	// Only reallocates when the count changes. Particles past the new count are dropped.
+	void SetParticleMaxCount(int count);
+
+	cd::Vec3f GetPosition(int index) const { return GetVec3(ParticleStream::PositionX, index); }
+	// Position between the last two updates, alpha 0 is the previous update and 1 the last one.
+	// Particles move back along their velocity and acceleration, but not past their spawn.
+	cd::Vec3f GetInterpolatedPosition(int index, float alpha) const;
+	// Interpolated positions of at most maxCount alive particles in spawn order, oldest first. Returns the written count.
+	// The sort uses frame memory so it doesn't touch the heap once the frame arena of the thread has grown.
+	int GetSpawnOrderPositions(cd::Vec4f* pPositions, int maxCount, float alpha) const;
+	void SetPosition(int index, const cd::Vec3f& position) { SetVec3(ParticleStream::PositionX, index, position); }
+	cd::Vec3f GetVelocity(int index) const { return GetVec3(ParticleStream::VelocityX, index); }
+	void SetVelocity(int index, const cd::Vec3f& velocity) { SetVec3(ParticleStream::VelocityX, index, velocity); }
+	cd::Vec3f GetAcceleration(int index) const { return GetVec3(ParticleStream::AccelerationX, index); }
+	void SetAcceleration(int index, const cd::Vec3f& acceleration) { SetVec3(ParticleStream::AccelerationX, index, acceleration); }
+	cd::Vec4f GetColor(int index) const;
+	void SetColor(int index, const cd::Vec4f& color);
+	float GetAge(int index) const { return GetStream(ParticleStream::Age)[index]; }
+	float GetLifeTime(int index) const { return GetStream(ParticleStream::LifeTime)[index]; }
+	void SetLifeTime(int index, float lifeTime) { GetStream(ParticleStream::LifeTime)[index] = lifeTime; }
+
+	float* GetStream(ParticleStream stream) { return m_pData + static_cast<size_t>(stream) * m_paddedMaxCount; }
+	const float* GetStream(ParticleStream stream) const { return m_pData + static_cast<size_t>(stream) * m_paddedMaxCount; }
 
+	// Particles inside of the range box around the origin are pulled around the z axis.
+	void SetRotationForceField(bool enabled, const cd::Vec3f& range);
+
+	// Integrates and ages all particles, then removes the ones which reached their life time.
 	void Update(float deltaTime);
+	// Same math one particle at a time. Kept as the reference to validate the SIMD path.
+	void UpdateScalar(float deltaTime);
+
+	// Kills all particles and keeps the memory.
 	void AllParticlesReset();
 
 private:
-	int m_maxParticleCount = 75;
-	int m_currentActiveCount = 0;
-	int m_currentParticleCount = 0;
-	std::vector<Particle> m_particles;
-	std::vector<int> m_freeParticleIndexes;
+	cd::Vec3f GetVec3(ParticleStream firstStream, int index) const;
+	void SetVec3(ParticleStream firstStream, int index, const cd::Vec3f& value);
+
+	void RemoveDeadParticles();
+	void Free();
+
+private:
+	float* m_pData = nullptr;
+	uint32_t m_maxCount = 0U;
+	uint32_t m_paddedMaxCount = 0U;
+	uint32_t m_activeCount = 0U;
+	float m_lastDeltaTime = 0.0f;
+
+	bool m_rotationForceField = false;
+	cd::Vec3f m_rotationForceFieldRange = cd::Vec3f::Zero();
+
+	// Indices of particles which died in the last update, ascending.
+	std::vector<uint32_t> m_deadIndexes;
 };
 
-}
\ No newline at end of file
+}
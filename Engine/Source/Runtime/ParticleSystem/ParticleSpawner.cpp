@@ -0,0 +1,133 @@
+#include "ParticleSpawner.h"
+
+#include "ParticlePool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace engine
+{
+
+void ParticleSpawner::SetSeed(uint32_t seed)
+{
+	m_seed = seed;
+	Reset();
+}
+
+void ParticleSpawner::Reset()
+{
+	m_time = 0.0f;
+	m_spawnAccumulator = 0.0f;
+
+	// xorshift32 gets stuck at 0.
+	m_randomState = m_seed * 2654435761U + 1U;
+	if (0U == m_randomState)
+	{
+		m_randomState = 1U;
+	}
+}
+
+uint32_t ParticleSpawner::Tick(float deltaTime)
+{
+	const float startTime = m_time;
+	const float endTime = m_time + deltaTime;
+	m_time = endTime;
+
+	m_spawnAccumulator += std::max(m_spawnRate, 0.0f) * deltaTime;
+	const float rateCount = std::floor(m_spawnAccumulator);
+	m_spawnAccumulator -= rateCount;
+	uint32_t spawnCount = static_cast<uint32_t>(rateCount);
+
+	// Cycle times are always computed as time + cycle * interval so that a cycle on a tick boundary
+	// belongs to exactly one tick.
+	for (const ParticleBurst& burst : m_bursts)
+	{
+		const bool isRepeated = burst.interval > 0.0f && 1U != burst.cycleCount;
+		uint32_t cycle = 0U;
+		if (isRepeated && startTime > burst.time)
+		{
+			// One cycle early in case the division rounds up.
+			const float skippedCycles = std::floor((startTime - burst.time) / burst.interval);
+			cycle = skippedCycles > 1.0f ? static_cast<uint32_t>(skippedCycles) - 1U : 0U;
+		}
+
+		for (; 0U == burst.cycleCount || cycle < burst.cycleCount; ++cycle)
+		{
+			const float cycleTime = burst.time + static_cast<float>(cycle) * burst.interval;
+			if (cycleTime >= endTime)
+			{
+				break;
+			}
+
+			if (cycleTime >= startTime)
+			{
+				spawnCount += burst.count;
+			}
+
+			if (!isRepeated)
+			{
+				break;
+			}
+		}
+	}
+
+	return spawnCount;
+}
+
+uint32_t ParticleSpawner::Spawn(ParticlePool& pool, uint32_t count, const ParticleSpawnParams& params)
+{
+	uint32_t spawnedCount = 0U;
+	for (; spawnedCount < count; ++spawnedCount)
+	{
+		const int particleIndex = pool.AllocateParticleIndex();
+		if (-1 == particleIndex)
+		{
+			break;
+		}
+
+		cd::Vec3f position = params.position;
+		if (params.randomPosition)
+		{
+			position.x() += GetRandomValue(params.positionRange.x());
+			position.y() += GetRandomValue(params.positionRange.y());
+			position.z() += GetRandomValue(params.positionRange.z());
+		}
+
+		cd::Vec3f velocity = params.velocity;
+		if (params.randomVelocity)
+		{
+			velocity.x() += GetRandomValue(params.velocityRange.x());
+			velocity.y() += GetRandomValue(params.velocityRange.y());
+			velocity.z() += GetRandomValue(params.velocityRange.z());
+		}
+
+		pool.SetPosition(particleIndex, position);
+		pool.SetVelocity(particleIndex, velocity);
+		pool.SetAcceleration(particleIndex, params.acceleration);
+		pool.SetColor(particleIndex, params.color);
+		pool.SetLifeTime(particleIndex, params.lifeTime);
+	}
+
+	return spawnedCount;
+}
+
+uint32_t ParticleSpawner::Simulate(ParticlePool& pool, float deltaTime, const ParticleSpawnParams& params)
+{
+	// Update first so that new particles start at the emitter and slots of dead particles can be reused.
+	pool.Update(deltaTime);
+	return Spawn(pool, Tick(deltaTime), params);
+}
+
+float ParticleSpawner::GetRandomValue(float range)
+{
+	// xorshift32
+	m_randomState ^= m_randomState << 13;
+	m_randomState ^= m_randomState >> 17;
+	m_randomState ^= m_randomState << 5;
+
+	// 24 bits are exact in a float.
+	const float unit = static_cast<float>(m_randomState >> 8) / 16777216.0f;
+	return (unit * 2.0f - 1.0f) * range;
+}
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Math/Vector.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+
+class ParticlePool;
+
+// count particles at time, then cycleCount - 1 more times every interval seconds of emitter time.
+struct ParticleBurst
+{
+	float time = 0.0f;
+	uint32_t count = 0U;
+	// 0 repeats forever.
+	uint32_t cycleCount = 1U;
+	float interval = 1.0f;
+};
+
+// Start values of spawned particles. Random offsets are in [-range, range] on every axis.
+struct ParticleSpawnParams
+{
+	cd::Vec3f position = cd::Vec3f::Zero();
+	cd::Vec3f positionRange = cd::Vec3f::Zero();
+	bool randomPosition = false;
+	cd::Vec3f velocity = cd::Vec3f::Zero();
+	cd::Vec3f velocityRange = cd::Vec3f::Zero();
+	bool randomVelocity = false;
+	cd::Vec3f acceleration = cd::Vec3f::Zero();
+	cd::Vec4f color = cd::Vec4f::One();
+	float lifeTime = 6.0f;
+};
+
+// ParticleSpawner is the emission state of one emitter: a continuous spawn rate, burst schedules and the random
+// generator of spawn values. Fractions of particles carry over between ticks so the emitted count follows the rate
+// whatever the tick length is. Two spawners with the same seed and ticks spawn the same particles.
+class ParticleSpawner final
+{
+public:
+	ParticleSpawner() { Reset(); }
+	explicit ParticleSpawner(uint32_t seed) { SetSeed(seed); }
+	ParticleSpawner(const ParticleSpawner&) = default;
+	ParticleSpawner& operator=(const ParticleSpawner&) = default;
+	ParticleSpawner(ParticleSpawner&&) = default;
+	ParticleSpawner& operator=(ParticleSpawner&&) = default;
+	~ParticleSpawner() = default;
+
+	// Particles per second.
+	float& GetSpawnRate() { return m_spawnRate; }
+	float GetSpawnRate() const { return m_spawnRate; }
+	void SetSpawnRate(float rate) { m_spawnRate = rate; }
+
+	void AddBurst(const ParticleBurst& burst) { m_bursts.push_back(burst); }
+	void ClearBursts() { m_bursts.clear(); }
+	const std::vector<ParticleBurst>& GetBursts() const { return m_bursts; }
+
+	// Also restarts the random sequence.
+	void SetSeed(uint32_t seed);
+	uint32_t GetSeed() const { return m_seed; }
+
+	// Back to emitter time 0 and the start of the random sequence.
+	void Reset();
+	float GetTime() const { return m_time; }
+
+	// Advances emitter time and returns the number of particles which start in [time, time + deltaTime).
+	uint32_t Tick(float deltaTime);
+
+	// Spawns count particles into pool. Particles which don't fit are dropped. Returns the spawned count.
+	uint32_t Spawn(ParticlePool& pool, uint32_t count, const ParticleSpawnParams& params);
+
+	// One simulation step: updates alive particles, then spawns the particles of this tick.
+	uint32_t Simulate(ParticlePool& pool, float deltaTime, const ParticleSpawnParams& params);
+
+private:
+	// Uniform in [-range, range].
+	float GetRandomValue(float range);
+
+private:
+	float m_spawnRate = 10.0f;
+	std::vector<ParticleBurst> m_bursts;
+
+	float m_time = 0.0f;
+	float m_spawnAccumulator = 0.0f;
+
+	uint32_t m_seed = 1U;
+	uint32_t m_randomState = 1U;
+};
+
+}
@@ -130,6 +130,17 @@ std::string Path::GetTerrainTextureOutputFilePath(const char* pInputFilePath, co
     return ((GetEngineResourcesPath() / "Textures" / "Terrain" / std::filesystem::path(pInputFilePath).stem()).replace_extension(extension)).generic_string();
 }
 
+std::string Path::GetSceneSnapshotOutputFilePath(const char* pInputFilePath, const std::string& options)
+{
+    std::string outputSceneFileName = std::filesystem::path(pInputFilePath).stem().generic_string();
+    if (!options.empty())
+    {
+        outputSceneFileName += "_" + options;
+    }
+
+    return (GetEngineResourcesPath() / "Scenes" / cd::MoveTemp(outputSceneFileName)).replace_extension(".cdscene").generic_string();
+}
+
 bool Path::FileExists(const char* pFilePath)
 {
     return std::filesystem::exists(pFilePath);
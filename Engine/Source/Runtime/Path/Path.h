@@ -29,6 +29,7 @@ public:
 	static std::string GetShaderOutputPath(const char* pInputFilePath, const std::string& options = "");
 	static std::string GetTextureOutputFilePath(const char* pInputFilePath, const char* extension);
 	static std::string GetTerrainTextureOutputFilePath(const char* pInputFilePath, const char* extension);
+	static std::string GetSceneSnapshotOutputFilePath(const char* pInputFilePath, const std::string& options = "");
 
 	template<typename... Args>
 	static std::string Join(Args&&... args)
@@ -24,6 +24,7 @@ Process::~Process()
 void Process::Run()
 {
 	m_pProcess = std::make_unique<subprocess_s>();
+	m_isFinished = false;
 
 	std::vector<const char*> commandLine;
 	commandLine.push_back(m_processName.c_str());
@@ -67,12 +68,23 @@ void Process::Run()
 
 	if (m_waitUntilFinished)
 	{
-		int processResult;
-		subprocess_join(m_pProcess.get(), &processResult);
-		CD_ENGINE_INFO("End process {0}", m_processName.c_str());
+		Wait();
 	}
 }
 
+void Process::Wait()
+{
+	if (!m_pProcess || m_isFinished)
+	{
+		return;
+	}
+
+	int processResult;
+	subprocess_join(m_pProcess.get(), &processResult);
+	m_isFinished = true;
+	CD_ENGINE_INFO("End process {0}", m_processName.c_str());
+}
+
 void Process::PrintSubProcessLog(OutputType outputType, subprocess_s* const pSubProcess, SubProcessReadLogFunction readMethod)
 {
 	static char processOutputData[65536] = { 0 };
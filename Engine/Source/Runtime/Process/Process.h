@@ -38,6 +38,8 @@ public:
 	void SetCommandArguments(std::vector<std::string> arguments) { m_commandArguments = cd::MoveTemp(arguments); }
 	void SetEnvironments(std::vector<std::string> environments) { m_environments = cd::MoveTemp(environments); }
 	void Run();
+	// Blocks until the started process exits. It does nothing when the process was joined already.
+	void Wait();
 
 	engine::Delegate<void(uint32_t handle, std::span<const char> str)> m_onOutput;
 	engine::Delegate<void(uint32_t handle, std::span<const char> str)> m_onErrorOutput;
@@ -53,6 +55,7 @@ private:
 	std::vector<std::string> m_commandArguments;
 	std::vector<std::string> m_environments;
 	bool m_waitUntilFinished = false;
+	bool m_isFinished = false;
 
 	bool m_printChildProcessLog = false;
 	bool m_printChildProcessErrorLog = true;
@@ -91,6 +94,7 @@ public:
 	void SetCommandArguments(std::vector<std::string> arguments) {}
 	void SetEnvironments(std::vector<std::string> environments) {}
 	void Run() {}
+	void Wait() {}
 
 	engine::Delegate<void(uint32_t handle, std::span<const char> str)> m_onOutput;
 	engine::Delegate<void(uint32_t handle, std::span<const char> str)> m_onErrorOutput;
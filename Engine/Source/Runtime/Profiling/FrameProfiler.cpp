@@ -0,0 +1,475 @@
+#include "FrameProfiler.h"
+
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+
+namespace engine
+{
+
+namespace
+{
+
+constexpr uint32_t CpuProcessID = 0U;
+constexpr uint32_t GpuProcessID = 1U;
+constexpr double NanosecondsToMilliseconds = 1.0 / 1000000.0;
+
+bool IsSameZoneName(const char* pLhs, const char* pRhs)
+{
+	// Literals are usually merged so pointers are compared first.
+	return pLhs == pRhs || 0 == std::strcmp(pLhs, pRhs);
+}
+
+void WriteJsonString(std::ostream& stream, const char* pText)
+{
+	stream << '"';
+	for (const char* pChar = pText; *pChar != '\0'; ++pChar)
+	{
+		const char c = *pChar;
+		if ('"' == c || '\\' == c)
+		{
+			stream << '\\' << c;
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			constexpr const char* HexDigits = "0123456789abcdef";
+			stream << "\\u00" << HexDigits[(c >> 4) & 0xF] << HexDigits[c & 0xF];
+		}
+		else
+		{
+			stream << c;
+		}
+	}
+	stream << '"';
+}
+
+void WriteTimestamp(std::ostream& stream, const char* pKey, uint64_t time)
+{
+	// Microseconds with nanosecond precision.
+	stream << ",\"" << pKey << "\":" << time / 1000U << '.';
+	const uint64_t fraction = time % 1000U;
+	stream << static_cast<char>('0' + fraction / 100U) << static_cast<char>('0' + fraction / 10U % 10U) << static_cast<char>('0' + fraction % 10U);
+}
+
+}
+
+std::atomic<bool> FrameProfiler::s_isEnabled = false;
+thread_local FrameProfiler::ThreadContext* FrameProfiler::s_pThreadContext = nullptr;
+
+uint64_t FrameProfiler::GetTime()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+FrameProfiler::ThreadContext& FrameProfiler::GetThreadContext()
+{
+	if (!s_pThreadContext)
+	{
+		// Only constructed on the first call of every thread. Its destructor runs when the thread exits.
+		struct ThreadExitGuard
+		{
+			~ThreadExitGuard()
+			{
+				if (s_pThreadContext)
+				{
+					Get().UnregisterThread(*s_pThreadContext);
+					s_pThreadContext = nullptr;
+				}
+			}
+		};
+		static thread_local ThreadExitGuard s_threadExitGuard;
+
+		s_pThreadContext = &Get().RegisterThread();
+	}
+	return *s_pThreadContext;
+}
+
+FrameProfiler::ThreadContext& FrameProfiler::RegisterThread()
+{
+	std::lock_guard<std::mutex> lock(m_threadMutex);
+	for (std::unique_ptr<ThreadContext>& pContext : m_threadContexts)
+	{
+		// Zones of exited threads are kept until EndFrame drains them. The new thread keeps the track of the old one.
+		if (pContext->isExited && (!pContext->pZoneRing || pContext->pZoneRing->IsEmpty()))
+		{
+			pContext->name.clear();
+			pContext->depth = 0U;
+			pContext->isExited = false;
+			return *pContext;
+		}
+	}
+
+	auto& pContext = m_threadContexts.emplace_back(std::make_unique<ThreadContext>());
+	pContext->threadIndex = static_cast<uint32_t>(m_threadContexts.size() - 1U);
+	return *pContext;
+}
+
+void FrameProfiler::UnregisterThread(ThreadContext& context)
+{
+	std::lock_guard<std::mutex> lock(m_threadMutex);
+	context.isExited = true;
+}
+
+void FrameProfiler::CreateZoneRing(ThreadContext& context)
+{
+	// EndFrame reads ring pointers of all threads under the same lock.
+	auto pZoneRing = std::make_unique<ProfileZoneRing>();
+	std::lock_guard<std::mutex> lock(m_threadMutex);
+	context.pZoneRing = std::move(pZoneRing);
+}
+
+uint64_t FrameProfiler::BeginZone()
+{
+	++GetThreadContext().depth;
+	return GetTime();
+}
+
+void FrameProfiler::EndZone(const char* pName, uint16_t viewID, uint64_t beginTime)
+{
+	const uint64_t endTime = GetTime();
+	ThreadContext& context = GetThreadContext();
+	assert(context.depth > 0U);
+	--context.depth;
+	if (!context.pZoneRing)
+	{
+		Get().CreateZoneRing(context);
+	}
+	context.pZoneRing->Push({ pName, beginTime, endTime, context.threadIndex, context.depth, viewID });
+}
+
+void FrameProfiler::SetThreadName(const char* pName)
+{
+	ThreadContext& context = GetThreadContext();
+	std::lock_guard<std::mutex> lock(m_threadMutex);
+	context.name = pName;
+}
+
+void FrameProfiler::AddGpuView(const char* pName, uint16_t viewID, double cpuMs, double gpuBeginMs, double gpuMs)
+{
+	ProfileGpuView& gpuView = m_pendingGpuViews.emplace_back();
+	gpuView.name = pName;
+	gpuView.viewID = viewID;
+	gpuView.beginTime = m_frameBeginTime + static_cast<uint64_t>(gpuBeginMs > 0.0 ? gpuBeginMs / NanosecondsToMilliseconds : 0.0);
+	gpuView.endTime = gpuView.beginTime + static_cast<uint64_t>(gpuMs > 0.0 ? gpuMs / NanosecondsToMilliseconds : 0.0);
+	gpuView.cpuMs = cpuMs;
+	gpuView.gpuMs = gpuMs;
+}
+
+void FrameProfiler::SetCounter(const char* pName, int64_t value)
+{
+	if (!IsEnabled())
+	{
+		return;
+	}
+
+	for (ProfileCounter& counter : m_pendingCounters)
+	{
+		if (IsSameZoneName(counter.pName, pName))
+		{
+			counter.value = value;
+			counter.time = GetTime();
+			return;
+		}
+	}
+
+	m_pendingCounters.push_back(ProfileCounter{ pName, value, GetTime() });
+}
+
+int64_t FrameProfiler::GetCounter(const char* pName) const
+{
+	for (const ProfileCounter& counter : m_counters)
+	{
+		if (IsSameZoneName(counter.pName, pName))
+		{
+			return counter.value;
+		}
+	}
+
+	return 0;
+}
+
+void FrameProfiler::EndFrame()
+{
+	const uint64_t frameEndTime = GetTime();
+
+	m_frameZones.clear();
+	{
+		std::lock_guard<std::mutex> lock(m_threadMutex);
+		for (std::unique_ptr<ThreadContext>& pContext : m_threadContexts)
+		{
+			if (pContext->pZoneRing)
+			{
+				pContext->pZoneRing->PopAll([this](const ProfileZone& zone) { m_frameZones.push_back(zone); });
+			}
+		}
+	}
+
+	std::swap(m_gpuViews, m_pendingGpuViews);
+	m_pendingGpuViews.clear();
+	std::swap(m_counters, m_pendingCounters);
+	m_pendingCounters.clear();
+	for (const ProfileGpuView& gpuView : m_gpuViews)
+	{
+		if (gpuView.viewID >= m_viewNames.size())
+		{
+			m_viewNames.resize(gpuView.viewID + 1U);
+		}
+		m_viewNames[gpuView.viewID] = gpuView.name;
+	}
+
+	BuildStatistics();
+
+	if (0U != m_frameBeginTime)
+	{
+		m_lastFrameMs = static_cast<double>(frameEndTime - m_frameBeginTime) * NanosecondsToMilliseconds;
+
+		if (IsCapturing())
+		{
+			m_capturedFrames.push_back({ m_frameBeginTime, frameEndTime });
+			m_capturedZones.insert(m_capturedZones.end(), m_frameZones.begin(), m_frameZones.end());
+			m_capturedGpuViews.insert(m_capturedGpuViews.end(), m_gpuViews.begin(), m_gpuViews.end());
+			m_capturedCounters.insert(m_capturedCounters.end(), m_counters.begin(), m_counters.end());
+			--m_captureFrameCount;
+		}
+	}
+
+	m_frameBeginTime = frameEndTime;
+	++m_frameIndex;
+}
+
+void FrameProfiler::BuildStatistics()
+{
+	m_zoneStats.clear();
+	for (const ProfileZone& zone : m_frameZones)
+	{
+		const double cpuMs = static_cast<double>(zone.endTime - zone.beginTime) * NanosecondsToMilliseconds;
+
+		ProfileZoneStats* pStats = nullptr;
+		for (ProfileZoneStats& stats : m_zoneStats)
+		{
+			if (stats.viewID == zone.viewID && IsSameZoneName(stats.pName, zone.pName))
+			{
+				pStats = &stats;
+				break;
+			}
+		}
+
+		if (!pStats)
+		{
+			pStats = &m_zoneStats.emplace_back(ProfileZoneStats{ zone.pName, zone.viewID, 0U, 0.0 });
+		}
+		++pStats->callCount;
+		pStats->cpuMs += cpuMs;
+	}
+
+	// Only the outermost zone of a renderer on each thread should be tagged with its view, otherwise time is counted twice.
+	m_rendererStats.clear();
+	for (const ProfileZoneStats& zoneStats : m_zoneStats)
+	{
+		if (InvalidProfileViewID == zoneStats.viewID)
+		{
+			continue;
+		}
+
+		ProfileRendererStats* pRendererStats = nullptr;
+		for (ProfileRendererStats& rendererStats : m_rendererStats)
+		{
+			if (rendererStats.viewID == zoneStats.viewID)
+			{
+				pRendererStats = &rendererStats;
+				break;
+			}
+		}
+
+		if (!pRendererStats)
+		{
+			pRendererStats = &m_rendererStats.emplace_back();
+			pRendererStats->name = GetViewName(zoneStats.viewID);
+			pRendererStats->viewID = zoneStats.viewID;
+			pRendererStats->cpuMs = 0.0;
+			pRendererStats->gpuMs = 0.0;
+		}
+		pRendererStats->cpuMs += zoneStats.cpuMs;
+	}
+
+	// A renderer which owns several views names all of them after itself, e.g. shadow map passes.
+	for (ProfileRendererStats& rendererStats : m_rendererStats)
+	{
+		for (const ProfileGpuView& gpuView : m_gpuViews)
+		{
+			const bool isSameView = rendererStats.name.empty() ? gpuView.viewID == rendererStats.viewID : gpuView.name == rendererStats.name;
+			if (isSameView)
+			{
+				rendererStats.gpuMs += gpuView.gpuMs;
+			}
+		}
+	}
+}
+
+const std::string& FrameProfiler::GetViewName(uint16_t viewID) const
+{
+	static const std::string s_emptyName;
+	return viewID < m_viewNames.size() ? m_viewNames[viewID] : s_emptyName;
+}
+
+void FrameProfiler::Reset()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_threadMutex);
+		for (std::unique_ptr<ThreadContext>& pContext : m_threadContexts)
+		{
+			if (pContext->pZoneRing)
+			{
+				pContext->pZoneRing->PopAll([](const ProfileZone&) {});
+			}
+		}
+	}
+
+	m_frameZones.clear();
+	m_zoneStats.clear();
+	m_pendingGpuViews.clear();
+	m_gpuViews.clear();
+	m_rendererStats.clear();
+	m_pendingCounters.clear();
+	m_counters.clear();
+	m_viewNames.clear();
+	m_frameBeginTime = 0U;
+	m_lastFrameMs = 0.0;
+
+	m_captureFrameCount = 0U;
+	m_capturedFrames.clear();
+	m_capturedZones.clear();
+	m_capturedGpuViews.clear();
+	m_capturedCounters.clear();
+}
+
+uint32_t FrameProfiler::GetDroppedZoneCount() const
+{
+	uint32_t droppedCount = 0U;
+	std::lock_guard<std::mutex> lock(m_threadMutex);
+	for (const std::unique_ptr<ThreadContext>& pContext : m_threadContexts)
+	{
+		droppedCount += pContext->pZoneRing ? pContext->pZoneRing->GetDroppedCount() : 0U;
+	}
+	return droppedCount;
+}
+
+uint32_t FrameProfiler::GetThreadContextCount() const
+{
+	std::lock_guard<std::mutex> lock(m_threadMutex);
+	return static_cast<uint32_t>(m_threadContexts.size());
+}
+
+uint32_t FrameProfiler::GetZoneRingCount() const
+{
+	uint32_t zoneRingCount = 0U;
+	std::lock_guard<std::mutex> lock(m_threadMutex);
+	for (const std::unique_ptr<ThreadContext>& pContext : m_threadContexts)
+	{
+		zoneRingCount += pContext->pZoneRing ? 1U : 0U;
+	}
+	return zoneRingCount;
+}
+
+void FrameProfiler::BeginCapture(uint32_t frameCount)
+{
+	m_captureFrameCount = frameCount;
+	m_capturedFrames.clear();
+	m_capturedZones.clear();
+	m_capturedGpuViews.clear();
+	m_capturedCounters.clear();
+}
+
+void FrameProfiler::WriteChromeTrace(std::ostream& stream) const
+{
+	const uint64_t baseTime = m_capturedFrames.empty() ? 0U : m_capturedFrames.front().beginTime;
+
+	stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << CpuProcessID << ",\"tid\":0,\"args\":{\"name\":\"CPU\"}},\n";
+	stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << GpuProcessID << ",\"tid\":0,\"args\":{\"name\":\"GPU\"}}";
+
+	{
+		std::lock_guard<std::mutex> lock(m_threadMutex);
+		for (const std::unique_ptr<ThreadContext>& pContext : m_threadContexts)
+		{
+			stream << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << CpuProcessID << ",\"tid\":" << pContext->threadIndex << ",\"args\":{\"name\":";
+			if (pContext->name.empty())
+			{
+				stream << "\"Thread " << pContext->threadIndex << '"';
+			}
+			else
+			{
+				WriteJsonString(stream, pContext->name.c_str());
+			}
+			stream << "}}";
+		}
+	}
+
+	for (const CapturedFrame& frame : m_capturedFrames)
+	{
+		stream << ",\n{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":" << CpuProcessID << ",\"tid\":0";
+		WriteTimestamp(stream, "ts", frame.endTime - baseTime);
+		stream << '}';
+	}
+
+	for (const ProfileZone& zone : m_capturedZones)
+	{
+		// Zones which finished before the capture started still belong to the first frame.
+		const uint64_t beginTime = zone.beginTime > baseTime ? zone.beginTime - baseTime : 0U;
+		const uint64_t endTime = zone.endTime > baseTime ? zone.endTime - baseTime : 0U;
+
+		const std::string& viewName = GetViewName(zone.viewID);
+		stream << ",\n{\"name\":";
+		WriteJsonString(stream, viewName.empty() ? zone.pName : viewName.c_str());
+		stream << ",\"cat\":\"CPU\",\"ph\":\"X\",\"pid\":" << CpuProcessID << ",\"tid\":" << zone.threadIndex;
+		WriteTimestamp(stream, "ts", beginTime);
+		WriteTimestamp(stream, "dur", endTime - beginTime);
+		stream << ",\"args\":{\"zone\":";
+		WriteJsonString(stream, zone.pName);
+		stream << ",\"depth\":" << zone.depth;
+		if (InvalidProfileViewID != zone.viewID)
+		{
+			stream << ",\"view\":" << zone.viewID;
+		}
+		stream << "}}";
+	}
+
+	for (const ProfileGpuView& gpuView : m_capturedGpuViews)
+	{
+		const uint64_t beginTime = gpuView.beginTime > baseTime ? gpuView.beginTime - baseTime : 0U;
+		stream << ",\n{\"name\":";
+		WriteJsonString(stream, gpuView.name.c_str());
+		stream << ",\"cat\":\"GPU\",\"ph\":\"X\",\"pid\":" << GpuProcessID << ",\"tid\":" << gpuView.viewID;
+		WriteTimestamp(stream, "ts", beginTime);
+		WriteTimestamp(stream, "dur", gpuView.endTime - gpuView.beginTime);
+		stream << ",\"args\":{\"view\":" << gpuView.viewID << ",\"cpuMs\":" << gpuView.cpuMs << ",\"gpuMs\":" << gpuView.gpuMs << "}}";
+	}
+
+	for (const ProfileCounter& counter : m_capturedCounters)
+	{
+		stream << ",\n{\"name\":";
+		WriteJsonString(stream, counter.pName);
+		stream << ",\"ph\":\"C\",\"pid\":" << CpuProcessID;
+		WriteTimestamp(stream, "ts", counter.time > baseTime ? counter.time - baseTime : 0U);
+		stream << ",\"args\":{\"value\":" << counter.value << "}}";
+	}
+
+	stream << "\n]}\n";
+}
+
+bool FrameProfiler::WriteChromeTrace(const char* pFilePath) const
+{
+	std::ofstream file(pFilePath, std::ios::out | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	WriteChromeTrace(file);
+	return file.good();
+}
+
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace engine
+{
+
+static constexpr uint16_t InvalidProfileViewID = UINT16_MAX;
+
+// One finished CPU zone. Names must be string literals so that recording never copies strings.
+struct ProfileZone
+{
+	const char* pName;
+	uint64_t beginTime;
+	uint64_t endTime;
+	uint32_t threadIndex;
+	uint16_t depth;
+	// Zones of renderers are tagged with their bgfx view so that they can be matched with GPU timings.
+	uint16_t viewID;
+};
+
+// Timings of one bgfx view which bgfx reported in the last frame.
+struct ProfileGpuView
+{
+	std::string name;
+	uint16_t viewID;
+	// Placed on the CPU timeline at the start of the frame which collected it.
+	uint64_t beginTime;
+	uint64_t endTime;
+	double cpuMs;
+	double gpuMs;
+};
+
+// Value of a named counter such as evaluated bones. Names must be string literals like zone names.
+struct ProfileCounter
+{
+	const char* pName;
+	int64_t value;
+	uint64_t time;
+};
+
+// CPU time of zones which share the same name and view in the last frame.
+struct ProfileZoneStats
+{
+	const char* pName;
+	uint16_t viewID;
+	uint32_t callCount;
+	double cpuMs;
+};
+
+// CPU time of all zones tagged with the view of one renderer, summed over threads,
+// and GPU time of all views which share the name of the renderer's view.
+struct ProfileRendererStats
+{
+	std::string name;
+	uint16_t viewID;
+	double cpuMs;
+	double gpuMs;
+};
+
+// Single producer single consumer ring of finished zones. The owner thread pushes without locks,
+// FrameProfiler::EndFrame pops on the main thread. Zones are dropped instead of blocking when the ring is full.
+class ProfileZoneRing final
+{
+public:
+	static constexpr uint32_t Capacity = 16384U;
+	static_assert(0U == (Capacity & (Capacity - 1U)), "Capacity should be power of two.");
+
+public:
+	ProfileZoneRing() = default;
+	ProfileZoneRing(const ProfileZoneRing&) = delete;
+	ProfileZoneRing& operator=(const ProfileZoneRing&) = delete;
+	ProfileZoneRing(ProfileZoneRing&&) = delete;
+	ProfileZoneRing& operator=(ProfileZoneRing&&) = delete;
+	~ProfileZoneRing() = default;
+
+	bool Push(const ProfileZone& zone)
+	{
+		const uint32_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+		if (writeIndex - m_readIndex.load(std::memory_order_acquire) >= Capacity)
+		{
+			m_droppedCount.fetch_add(1U, std::memory_order_relaxed);
+			return false;
+		}
+
+		m_zones[writeIndex & (Capacity - 1U)] = zone;
+		m_writeIndex.store(writeIndex + 1U, std::memory_order_release);
+		return true;
+	}
+
+	template<typename Func>
+	uint32_t PopAll(Func&& func)
+	{
+		const uint32_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+		const uint32_t writeIndex = m_writeIndex.load(std::memory_order_acquire);
+		for (uint32_t index = readIndex; index != writeIndex; ++index)
+		{
+			func(m_zones[index & (Capacity - 1U)]);
+		}
+		m_readIndex.store(writeIndex, std::memory_order_release);
+		return writeIndex - readIndex;
+	}
+
+	uint32_t GetDroppedCount() const { return m_droppedCount.load(std::memory_order_relaxed); }
+	bool IsEmpty() const { return m_readIndex.load(std::memory_order_acquire) == m_writeIndex.load(std::memory_order_acquire); }
+
+private:
+	ProfileZone m_zones[Capacity];
+	alignas(64) std::atomic<uint32_t> m_writeIndex = 0U;
+	alignas(64) std::atomic<uint32_t> m_readIndex = 0U;
+	std::atomic<uint32_t> m_droppedCount = 0U;
+};
+
+// FrameProfiler collects hierarchical CPU zones from every thread and per view timings from bgfx.
+// It doesn't depend on Tracy so it works on every platform. Use the macros in Profiling/Profile.h to record zones.
+// EndFrame should be called once per frame on the main thread. It drains all threads, builds statistics for UI
+// and appends the frame to a running capture which can be saved as a Chrome trace (chrome://tracing, Perfetto).
+class FrameProfiler final
+{
+public:
+	static constexpr uint32_t DefaultCaptureFrameCount = 120U;
+
+public:
+	FrameProfiler(const FrameProfiler&) = delete;
+	FrameProfiler& operator=(const FrameProfiler&) = delete;
+	FrameProfiler(FrameProfiler&&) = delete;
+	FrameProfiler& operator=(FrameProfiler&&) = delete;
+	~FrameProfiler() = default;
+
+	static FrameProfiler& Get()
+	{
+		static FrameProfiler s_instance;
+		return s_instance;
+	}
+
+	// Off by default, the profiler panel of the editor turns it on. Disabled zones only cost one relaxed load.
+	static bool IsEnabled() { return s_isEnabled.load(std::memory_order_relaxed); }
+	static void SetEnable(bool enable) { s_isEnabled.store(enable, std::memory_order_relaxed); }
+
+	// Nanoseconds of a monotonic clock.
+	static uint64_t GetTime();
+
+	// Called by ProfileScope. Every BeginZone needs an EndZone on the same thread.
+	static uint64_t BeginZone();
+	static void EndZone(const char* pName, uint16_t viewID, uint64_t beginTime);
+
+	// Name of the calling thread in captures.
+	void SetThreadName(const char* pName);
+
+	// Main thread.
+	void AddGpuView(const char* pName, uint16_t viewID, double cpuMs, double gpuBeginMs, double gpuMs);
+	// Main thread. Setting a counter twice in one frame keeps the last value.
+	void SetCounter(const char* pName, int64_t value);
+	void EndFrame();
+	// Drop collected zones, statistics and captures.
+	void Reset();
+
+	uint64_t GetFrameIndex() const { return m_frameIndex; }
+	// Threads which recorded zones or set their name, including exited ones whose contexts are not reused yet.
+	uint32_t GetThreadContextCount() const;
+	uint32_t GetZoneRingCount() const;
+	double GetLastFrameMs() const { return m_lastFrameMs; }
+	uint32_t GetDroppedZoneCount() const;
+	const std::vector<ProfileZone>& GetFrameZones() const { return m_frameZones; }
+	const std::vector<ProfileZoneStats>& GetZoneStats() const { return m_zoneStats; }
+	const std::vector<ProfileGpuView>& GetGpuViews() const { return m_gpuViews; }
+	const std::vector<ProfileRendererStats>& GetRendererStats() const { return m_rendererStats; }
+	const std::vector<ProfileCounter>& GetCounters() const { return m_counters; }
+	// Value in the last frame or 0 if it was not set.
+	int64_t GetCounter(const char* pName) const;
+
+	// Record next frameCount frames. The capture is kept until the next BeginCapture or Reset.
+	void BeginCapture(uint32_t frameCount = DefaultCaptureFrameCount);
+	void EndCapture() { m_captureFrameCount = 0U; }
+	bool IsCapturing() const { return m_captureFrameCount > 0U; }
+	uint32_t GetCapturedFrameCount() const { return static_cast<uint32_t>(m_capturedFrames.size()); }
+
+	// Chrome trace event format. CPU zones are in process 0 with one track per thread,
+	// GPU views are in process 1 with one track per view. Counters are counter tracks of process 0.
+	void WriteChromeTrace(std::ostream& stream) const;
+	bool WriteChromeTrace(const char* pFilePath) const;
+
+private:
+	// Contexts of exited threads are reused by new threads after their zones are drained.
+	// Rings are large so they are allocated on the first zone, threads which only set their name don't need one.
+	struct ThreadContext
+	{
+		std::unique_ptr<ProfileZoneRing> pZoneRing;
+		std::string name;
+		uint32_t threadIndex = 0U;
+		uint16_t depth = 0U;
+		bool isExited = false;
+	};
+
+	struct CapturedFrame
+	{
+		uint64_t beginTime;
+		uint64_t endTime;
+	};
+
+	FrameProfiler() = default;
+
+	static ThreadContext& GetThreadContext();
+	ThreadContext& RegisterThread();
+	void UnregisterThread(ThreadContext& context);
+	void CreateZoneRing(ThreadContext& context);
+	void BuildStatistics();
+	const std::string& GetViewName(uint16_t viewID) const;
+
+private:
+	static std::atomic<bool> s_isEnabled;
+	static thread_local ThreadContext* s_pThreadContext;
+
+	mutable std::mutex m_threadMutex;
+	std::vector<std::unique_ptr<ThreadContext>> m_threadContexts;
+
+	uint64_t m_frameIndex = 0U;
+	uint64_t m_frameBeginTime = 0U;
+	double m_lastFrameMs = 0.0;
+
+	// Last frame. Containers are reused to avoid allocations in steady state.
+	std::vector<ProfileZone> m_frameZones;
+	std::vector<ProfileZoneStats> m_zoneStats;
+	std::vector<ProfileGpuView> m_pendingGpuViews;
+	std::vector<ProfileGpuView> m_gpuViews;
+	std::vector<ProfileRendererStats> m_rendererStats;
+	std::vector<ProfileCounter> m_pendingCounters;
+	std::vector<ProfileCounter> m_counters;
+	std::vector<std::string> m_viewNames;
+
+	uint32_t m_captureFrameCount = 0U;
+	std::vector<CapturedFrame> m_capturedFrames;
+	std::vector<ProfileZone> m_capturedZones;
+	std::vector<ProfileGpuView> m_capturedGpuViews;
+	std::vector<ProfileCounter> m_capturedCounters;
+};
+
+}
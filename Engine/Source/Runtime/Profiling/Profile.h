@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Profiling/FrameProfiler.h"
+
+namespace engine
+{
+
+// Records the time between construction and destruction as a zone of the calling thread.
+// Nested scopes build the hierarchy.
+class ProfileScope final
+{
+public:
+	explicit ProfileScope(const char* pName, uint16_t viewID = InvalidProfileViewID)
+	{
+		if (FrameProfiler::IsEnabled())
+		{
+			m_pName = pName;
+			m_viewID = viewID;
+			m_beginTime = FrameProfiler::BeginZone();
+		}
+	}
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+	ProfileScope(ProfileScope&&) = delete;
+	ProfileScope& operator=(ProfileScope&&) = delete;
+
+	~ProfileScope()
+	{
+		if (m_pName)
+		{
+			FrameProfiler::EndZone(m_pName, m_viewID, m_beginTime);
+		}
+	}
+
+private:
+	const char* m_pName = nullptr;
+	uint64_t m_beginTime = 0U;
+	uint16_t m_viewID = InvalidProfileViewID;
+};
+
+}
+
+// Built-in profiling which works without Tracy. Compiled out when ENABLE_PROFILING is not defined.
+#ifdef ENABLE_PROFILING
+#define CD_PROFILE_CONCAT_IMPL(a, b) a##b
+#define CD_PROFILE_CONCAT(a, b) CD_PROFILE_CONCAT_IMPL(a, b)
+#define CD_PROFILE_ZONE(name) engine::ProfileScope CD_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define CD_PROFILE_ZONE_VIEW(name, viewID) engine::ProfileScope CD_PROFILE_CONCAT(profileScope, __LINE__)(name, viewID)
+#define CD_PROFILE_FRAME() engine::FrameProfiler::Get().EndFrame()
+#define CD_PROFILE_THREAD(name) engine::FrameProfiler::Get().SetThreadName(name)
+#define CD_PROFILE_COUNTER(name, value) engine::FrameProfiler::Get().SetCounter(name, value)
+#else
+#define CD_PROFILE_ZONE(name)
+#define CD_PROFILE_ZONE_VIEW(name, viewID)
+#define CD_PROFILE_FRAME()
+#define CD_PROFILE_THREAD(name)
+#define CD_PROFILE_COUNTER(name, value)
+#endif
@@ -1,14 +1,19 @@
 #include "AnimationRenderer.h"
 
+#include "Core/Memory/FrameArena.h"
 #include "Core/StringCrc.h"
 #include "ECWorld/SceneWorld.h"
 #include "ECWorld/StaticMeshComponent.h"
 #include "ECWorld/TransformComponent.h"
+#include "Log/Log.h"
 #include "Rendering/RenderContext.h"
 #include "Rendering/Resources/MeshResource.h"
 #include "Rendering/Resources/ShaderResource.h"
+#include "Rendering/SkinningRenderer.h"
 #include "Scene/Texture.h"
+#include "U_Skinning.sh"
 
+#include <algorithm>
 #include <cmath>
 
 //#define VISUALIZE_BONE_WEIGHTS
@@ -20,131 +25,53 @@ namespace
 
 constexpr const char* debugBoneIndex = "u_debugBoneIndex";
 
-}
+constexpr uint64_t skinnedMeshState = BGFX_STATE_WRITE_MASK | BGFX_STATE_CULL_CCW | BGFX_STATE_MSAA | BGFX_STATE_DEPTH_TEST_LESS;
 
-namespace details
-{
+// Model matrix and skinning params.
+constexpr uint16_t instanceStride = 80U;
 
-float CustomFModf(float dividend, float divisor)
+struct SkinnedDraw
 {
-	if (divisor == 0.0f)
-		return 0.0f;
-
-	int quotient = static_cast<int>(dividend / divisor);
-	float result = dividend - static_cast<float>(quotient) * divisor;
-
-	// Handle potential precision issues near zero
-	if (result == 0.0f && dividend != 0.0f)
-		result = 0.0f;
+	const StaticMeshComponent* pMeshComponent;
+	const cd::Matrix4x4* pWorldMatrix;
+	uint16_t programHandle;
+	uint16_t skinnedVertexBuffer;
+	float skinningParams[4];
+};
 
-	// Ensure the result has the same sign as the divisor
-	if ((dividend < 0 && divisor > 0) || (dividend > 0 && divisor < 0))
-		result = -result;
+// Draws with the same mesh range, program and skinning mode can share one instanced draw call.
+// Pre-skinned draws have their own vertex buffers so they are never instanced.
+bool IsSameBatch(const SkinnedDraw& a, const SkinnedDraw& b)
+{
+	return UINT16_MAX == a.skinnedVertexBuffer && UINT16_MAX == b.skinnedVertexBuffer &&
+		a.pMeshComponent->GetMeshResource() == b.pMeshComponent->GetMeshResource() &&
+		a.pMeshComponent->GetStartIndex() == b.pMeshComponent->GetStartIndex() &&
+		a.pMeshComponent->GetIndexCount() == b.pMeshComponent->GetIndexCount() &&
+		a.programHandle == b.programHandle &&
+		a.skinningParams[1] == b.skinningParams[1];
+}
 
-	return result;
 }
 
-void CalculateBoneTransform(std::vector<cd::Matrix4x4>& boneMatrices, const cd::SceneDatabase* pSceneDatabase,
-	float animationTime, const cd::Bone& bone, const cd::Matrix4x4& parentBoneTransform, const cd::Matrix4x4& globalInverse)
+void AnimationRenderer::Init()
 {
-	auto CalculateInterpolatedTranslation = [&animationTime](const cd::Track* pTrack) -> cd::Vec3f
-	{
-		if (1U == pTrack->GetTranslationKeyCount())
-		{
-			const auto& firstKey = pTrack->GetTranslationKeys()[0];
-			return firstKey.GetValue();
-		}
-
-		for (uint32_t keyIndex = 0U; keyIndex < pTrack->GetTranslationKeyCount() - 1; ++keyIndex)
-		{
-			const auto& nextKey = pTrack->GetTranslationKeys()[keyIndex + 1];
-			if (animationTime < nextKey.GetTime())
-			{
-				const auto& currentKey = pTrack->GetTranslationKeys()[keyIndex];
-				float keyFrameDeltaTime = nextKey.GetTime() - currentKey.GetTime();
-				float keyFrameRate = (animationTime - currentKey.GetTime()) / keyFrameDeltaTime;
-				assert(keyFrameRate >= 0.0f && keyFrameRate <= 1.0f);
-
-				return cd::Vec3f::Lerp(currentKey.GetValue(), nextKey.GetValue(), keyFrameRate);
-			}
-		}
-
-		return cd::Vec3f::Zero();
-	};
-
-	auto CalculateInterpolatedRotation = [&animationTime](const cd::Track* pTrack) -> cd::Quaternion
-	{
-		if (1U == pTrack->GetRotationKeyCount())
-		{
-			const auto& firstKey = pTrack->GetRotationKeys()[0];
-			return firstKey.GetValue();
-		}
-
-		for (uint32_t keyIndex = 0U; keyIndex < pTrack->GetRotationKeyCount() - 1; ++keyIndex)
-		{
-			const auto& nextKey = pTrack->GetRotationKeys()[keyIndex + 1];
-			if (animationTime < nextKey.GetTime())
-			{
-				const auto& currentKey = pTrack->GetRotationKeys()[keyIndex];
-				float keyFrameDeltaTime = nextKey.GetTime() - currentKey.GetTime();
-				float keyFrameRate = (animationTime - currentKey.GetTime()) / keyFrameDeltaTime;
-				assert(keyFrameRate >= 0.0f && keyFrameRate <= 1.0f);
-
-				return cd::Quaternion::Lerp(currentKey.GetValue(), nextKey.GetValue(), keyFrameRate).Normalize();
-			}
-		}
-
-		return cd::Quaternion::Identity();
-	};
-
-	auto CalculateInterpolatedScale = [&animationTime](const cd::Track* pTrack) -> cd::Vec3f
-	{
-		if (1U == pTrack->GetScaleKeyCount())
-		{
-			const auto& firstKey = pTrack->GetScaleKeys()[0];
-			return firstKey.GetValue();
-		}
-
-		for (uint32_t keyIndex = 0U; keyIndex < pTrack->GetScaleKeyCount() - 1; ++keyIndex)
-		{
-			const auto& nextKey = pTrack->GetScaleKeys()[keyIndex + 1];
-			if (animationTime < nextKey.GetTime())
-			{
-				const auto& currentKey = pTrack->GetScaleKeys()[keyIndex];
-				float keyFrameDeltaTime = nextKey.GetTime() - currentKey.GetTime();
-				float keyFrameRate = (animationTime - currentKey.GetTime()) / keyFrameDeltaTime;
-				assert(keyFrameRate >= 0.0f && keyFrameRate <= 1.0f);
-
-				return cd::Vec3f::Lerp(currentKey.GetValue(), nextKey.GetValue(), keyFrameRate);
-			}
-		}
+	bgfx::setViewName(GetViewID(), "AnimationRenderer");
 
-		return cd::Vec3f::One();
-	};
+	m_bonePaletteSampler.Init(GetRenderContext());
+	m_skinningParams.Init(GetRenderContext());
 
-	cd::Matrix4x4 boneLocalTransform = bone.GetTransform().GetMatrix();
-	if (const cd::Track* pTrack = pSceneDatabase->GetTrackByName(bone.GetName()))
+	// Vertex shaders read bone palettes from a float texture. Pre-skinned meshes don't need it.
+	const bgfx::Caps* pCaps = bgfx::getCaps();
+	m_isBonePaletteSupported = 0U != (pCaps->formats[bgfx::TextureFormat::RGBA32F] & BGFX_CAPS_FORMAT_TEXTURE_VERTEX);
+	if (!m_isBonePaletteSupported)
 	{
-		boneLocalTransform = cd::Transform(CalculateInterpolatedTranslation(pTrack),
-									  CalculateInterpolatedRotation(pTrack),
-									  CalculateInterpolatedScale(pTrack)).GetMatrix();
+		CD_ENGINE_WARN("RGBA32F textures can't be sampled in vertex shaders, only pre-skinned meshes are rendered.");
 	}
 
-	cd::Matrix4x4 globalTransform = parentBoneTransform * boneLocalTransform;
-	boneMatrices[bone.GetID().Data()] = globalInverse * globalTransform * bone.GetOffset();
-
-	for (cd::BoneID boneID : bone.GetChildIDs())
+	if (0U != (pCaps->supported & BGFX_CAPS_INSTANCING))
 	{
-		const cd::Bone& childBone = pSceneDatabase->GetBone(boneID.Data());
-		CalculateBoneTransform(boneMatrices, pSceneDatabase, animationTime, childBone, globalTransform, globalInverse);
+		m_pInstanceShaderResource = GetRenderContext()->RegisterShaderProgram("AnimationInstanceProgram", "vs_animation_instance", "fs_animation");
 	}
-};
-
-}
-
-void AnimationRenderer::Init()
-{
-	bgfx::setViewName(GetViewID(), "AnimationRenderer");
 
 #ifdef VISUALIZE_BONE_WEIGHTS
 	GetRenderContext()->CreateUniform(debugBoneIndex, bgfx::UniformType::Vec4, 1);
@@ -178,10 +105,7 @@ void AnimationRenderer::Render(float deltaTime)
 	GetRenderContext()->FillUniform(boneIndexCrc, selectedBoneIndex, 1);
 #endif
 
-	static float animationRunningTime = 0.0f;
-	animationRunningTime += deltaTime;
-
-	const cd::SceneDatabase* pSceneDatabase = m_pCurrentSceneWorld->GetSceneDatabase();
+	FrameVector<SkinnedDraw> skinnedDraws;
 	for (Entity entity : m_pCurrentSceneWorld->GetStaticMeshEntities())
 	{
 		StaticMeshComponent* pMeshComponent = m_pCurrentSceneWorld->GetStaticMeshComponent(entity);
@@ -204,13 +128,128 @@ void AnimationRenderer::Render(float deltaTime)
 			continue;
 		}
 
+		// Bone palette or pre-skinned vertices of this entity which SkinningRenderer prepared for this frame.
+		const SkeletonComponent* pSkeletonComponent = m_pCurrentSceneWorld->GetSkeletonComponent(entity);
+		if (!pSkeletonComponent || UINT32_MAX == pSkeletonComponent->GetBonePaletteTexel())
+		{
+			continue;
+		}
+
+		const uint16_t skinnedVertexBuffer = pSkeletonComponent->GetSkinnedVertexBuffer();
+		if (UINT16_MAX == skinnedVertexBuffer && !m_isBonePaletteSupported)
+		{
+			continue;
+		}
+
 		TransformComponent* pTransformComponent = m_pCurrentSceneWorld->GetTransformComponent(entity);
-		bgfx::setTransform(pTransformComponent->GetWorldMatrix().begin());
+		const float skinningMode = SkinningMode::DualQuaternion == pSkeletonComponent->GetSkinningMode() ? 1.0f : 0.0f;
+		const float preSkinned = UINT16_MAX == skinnedVertexBuffer ? 0.0f : 1.0f;
+		skinnedDraws.push_back({ pMeshComponent, &pTransformComponent->GetWorldMatrix(), pShaderResource->GetHandle(), skinnedVertexBuffer,
+			{ static_cast<float>(pSkeletonComponent->GetBonePaletteTexel()), skinningMode, preSkinned, 0.0f } });
+	}
+
+	// Draws of the same batch are neighbours after sorting.
+	std::sort(skinnedDraws.begin(), skinnedDraws.end(), [](const SkinnedDraw& a, const SkinnedDraw& b)
+	{
+		const MeshResource* pMeshA = a.pMeshComponent->GetMeshResource();
+		const MeshResource* pMeshB = b.pMeshComponent->GetMeshResource();
+		if (pMeshA != pMeshB)
+		{
+			return pMeshA < pMeshB;
+		}
+		if (a.pMeshComponent->GetStartIndex() != b.pMeshComponent->GetStartIndex())
+		{
+			return a.pMeshComponent->GetStartIndex() < b.pMeshComponent->GetStartIndex();
+		}
+		if (a.programHandle != b.programHandle)
+		{
+			return a.programHandle < b.programHandle;
+		}
+		return a.skinningParams[1] < b.skinningParams[1];
+	});
+
+	const bool isInstancingReady = m_pInstanceShaderResource &&
+		(ResourceStatus::Ready == m_pInstanceShaderResource->GetStatus() || ResourceStatus::Optimized == m_pInstanceShaderResource->GetStatus());
+	for (size_t batchBegin = 0U; batchBegin < skinnedDraws.size();)
+	{
+		const SkinnedDraw& firstDraw = skinnedDraws[batchBegin];
+		size_t batchEnd = batchBegin + 1U;
+		while (batchEnd < skinnedDraws.size() && IsSameBatch(firstDraw, skinnedDraws[batchEnd]))
+		{
+			++batchEnd;
+		}
+
+		if (!isInstancingReady || batchEnd - batchBegin < 2U)
+		{
+			for (size_t drawIndex = batchBegin; drawIndex < batchEnd; ++drawIndex)
+			{
+				const SkinnedDraw& draw = skinnedDraws[drawIndex];
+				SubmitSkinnedMesh(draw.pMeshComponent, draw.programHandle, draw.pWorldMatrix, nullptr, draw.skinningParams, draw.skinnedVertexBuffer);
+			}
+			batchBegin = batchEnd;
+			continue;
+		}
+
+		// Instances are split when the transient instance buffer runs out.
+		while (batchBegin < batchEnd)
+		{
+			const uint32_t instanceCount = bgfx::getAvailInstanceDataBuffer(static_cast<uint32_t>(batchEnd - batchBegin), instanceStride);
+			if (0U == instanceCount)
+			{
+				CD_ENGINE_WARN("Transient instance buffer is full, skip {0} skinned instances.", batchEnd - batchBegin);
+				break;
+			}
+
+			bgfx::InstanceDataBuffer instanceDataBuffer;
+			bgfx::allocInstanceDataBuffer(&instanceDataBuffer, instanceCount, instanceStride);
+			float* pInstanceData = reinterpret_cast<float*>(instanceDataBuffer.data);
+			for (uint32_t instanceIndex = 0U; instanceIndex < instanceCount; ++instanceIndex)
+			{
+				const SkinnedDraw& draw = skinnedDraws[batchBegin + instanceIndex];
+				std::copy_n(draw.pWorldMatrix->begin(), 16U, pInstanceData);
+				std::copy_n(draw.skinningParams, 4U, pInstanceData + 16U);
+				pInstanceData += instanceStride / sizeof(float);
+			}
+
+			SubmitSkinnedMesh(firstDraw.pMeshComponent, m_pInstanceShaderResource->GetHandle(), nullptr, &instanceDataBuffer, firstDraw.skinningParams, UINT16_MAX);
+			batchBegin += instanceCount;
+		}
+		batchBegin = batchEnd;
+	}
+}
 
-		constexpr uint64_t state = BGFX_STATE_WRITE_MASK | BGFX_STATE_CULL_CCW | BGFX_STATE_MSAA | BGFX_STATE_DEPTH_TEST_LESS;
-		bgfx::setState(state);
+void AnimationRenderer::SubmitSkinnedMesh(const StaticMeshComponent* pMeshComponent, uint16_t programHandle, const cd::Matrix4x4* pWorldMatrix,
+	const bgfx::InstanceDataBuffer* pInstanceDataBuffer, const float* pSkinningParams, uint16_t skinnedVertexBuffer)
+{
+	// State is discarded after every submit so it is set again for every index buffer.
+	const MeshResource* pMeshResource = pMeshComponent->GetMeshResource();
+	const bgfx::TextureHandle bonePaletteTexture = GetRenderContext()->GetTexture(StringCrc(SkinningRenderer::BonePaletteTextureName));
+	for (uint32_t indexBufferIndex = 0U, indexBufferCount = pMeshResource->GetIndexBufferCount(); indexBufferIndex < indexBufferCount; ++indexBufferIndex)
+	{
+		if (pWorldMatrix)
+		{
+			bgfx::setTransform(pWorldMatrix->begin());
+		}
+		if (pInstanceDataBuffer)
+		{
+			bgfx::setInstanceDataBuffer(pInstanceDataBuffer);
+		}
+		m_bonePaletteSampler.Bind(BONE_PALETTE_SLOT, bonePaletteTexture);
+		m_skinningParams.Set(pSkinningParams);
+		bgfx::setState(skinnedMeshState);
+		if (UINT16_MAX != skinnedVertexBuffer)
+		{
+			// Skinned positions in front of the mesh stream, bone influences are still read from the mesh.
+			bgfx::setVertexBuffer(0, bgfx::DynamicVertexBufferHandle{ skinnedVertexBuffer }, pMeshComponent->GetStartVertex(), pMeshComponent->GetVertexCount());
+			bgfx::setVertexBuffer(1, bgfx::VertexBufferHandle{ pMeshResource->GetVertexBufferHandle() }, pMeshComponent->GetStartVertex(), pMeshComponent->GetVertexCount());
+		}
+		else
+		{
+			bgfx::setVertexBuffer(0, bgfx::VertexBufferHandle{ pMeshResource->GetVertexBufferHandle() }, pMeshComponent->GetStartVertex(), pMeshComponent->GetVertexCount());
+		}
+		bgfx::setIndexBuffer(bgfx::IndexBufferHandle{ pMeshResource->GetIndexBufferHandle(indexBufferIndex) }, pMeshComponent->GetStartIndex(), pMeshComponent->GetIndexCount());
 
-		GetRenderContext()->Submit(GetViewID(), pShaderResource->GetHandle());
+		GetRenderContext()->Submit(GetViewID(), programHandle);
 	}
 }
 
@@ -1,14 +1,17 @@
 #pragma once
 
+#include "Math/Matrix.hpp"
 #include "Renderer.h"
-
-#include <vector>
+#include "Rendering/UniformSlot.h"
 
 namespace engine
 {
 
 class SceneWorld;
+class ShaderResource;
+class StaticMeshComponent;
 
+// Draws skinned meshes. Poses, bone palettes and pre-skinned vertices are prepared by SkinningRenderer.
 class AnimationRenderer final : public Renderer
 {
 public:
@@ -20,8 +23,18 @@ public:
 
 	void SetSceneWorld(SceneWorld* pSceneWorld) { m_pCurrentSceneWorld = pSceneWorld; }
 
+private:
+	void SubmitSkinnedMesh(const StaticMeshComponent* pMeshComponent, uint16_t programHandle, const cd::Matrix4x4* pWorldMatrix,
+		const bgfx::InstanceDataBuffer* pInstanceDataBuffer, const float* pSkinningParams, uint16_t skinnedVertexBuffer);
+
 private:
 	SceneWorld* m_pCurrentSceneWorld = nullptr;
+	ShaderResource* m_pInstanceShaderResource = nullptr;
+
+	bool m_isBonePaletteSupported = false;
+
+	SamplerUniform<"s_bonePalette"> m_bonePaletteSampler;
+	Vec4Uniform<"u_skinningParams"> m_skinningParams;
 };
 
-}
\ No newline at end of file
+}
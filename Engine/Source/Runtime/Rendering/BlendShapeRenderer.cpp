@@ -1,21 +1,17 @@
 #include "BlendShapeRenderer.h"
 
 #include "ECWorld/BlendShapeComponent.h"
-#include "ECWorld/CameraComponent.h"
-#include "ECWorld/MaterialComponent.h"
 #include "ECWorld/SceneWorld.h"
-#include "ECWorld/SkyComponent.h"
-#include "ECWorld/StaticMeshComponent.h"
-#include "ECWorld/TransformComponent.h"
-#include "LightUniforms.h"
-#include "Material/ShaderSchema.h"
-#include "Math/Transform.hpp"
+#include "Profiling/Profile.h"
 #include "RenderContext.h"
 #include "Rendering/Resources/ShaderResource.h"
-#include "Scene/Texture.h"
-#include "U_AtmophericScattering.sh"
+#include "Rendering/Utility/VertexLayoutUtility.h"
+#include "Scene/Mesh.h"
+#include "Scene/VertexFormat.h"
 #include "U_BlendShape.sh"
-#include "U_IBL.sh"
+
+#include <algorithm>
+#include <cassert>
 
 namespace engine
 {
@@ -23,103 +19,248 @@ namespace engine
 namespace
 {
 
-constexpr const char* morphCountVertexCount = "u_morphCount_vertexCount";
-constexpr const char* changedWeight = "u_changedWeight";
+// Work groups per dispatch along x which every backend supports.
+constexpr uint32_t maxDispatchGroupCount = 65535U;
 
-constexpr const char *BlendShapeWeightsProgram = "BlendShapeWeightsProgram";
-constexpr const char *BlendShapeWeightPosProgram = "BlendShapeWeightPosProgram";
-constexpr const char *BlendShapeFinalPosProgram = "BlendShapeFinalPosProgram";
-constexpr const char *BlendShapeUpdatePosProgram = "BlendShapeUpdatePosProgram";
+constexpr uint64_t computeReadFlags = BGFX_BUFFER_COMPUTE_READ | BGFX_BUFFER_INDEX32;
 
-constexpr StringCrc BlendShapeWeightsProgramCrc{ BlendShapeWeightsProgram };
-constexpr StringCrc BlendShapeWeightPosProgramCrc{ BlendShapeWeightPosProgram };
-constexpr StringCrc BlendShapeFinalPosProgramCrc{ BlendShapeFinalPosProgram };
-constexpr StringCrc BlendShapeUpdatePosProgramCrc{ BlendShapeUpdatePosProgram };
+static_assert(BlendShapeBatch::GroupVertexCount == BS_BATCH_THREAD_COUNT, "Blend shape work group size mismatch between shaders and engine.");
 
+bool IsResourceReady(const IResource* pResource)
+{
+	return ResourceStatus::Ready == pResource->GetStatus() || ResourceStatus::Optimized == pResource->GetStatus();
 }
 
-void BlendShapeRenderer::Init()
+void DestroyBuffer(uint16_t& handle, bool isDynamic)
 {
-	AddDependentShaderResource(GetRenderContext()->RegisterShaderProgram("BlendShapeWeightsProgram", "cs_blendshape_weights", ShaderProgramType::Compute));
-	AddDependentShaderResource(GetRenderContext()->RegisterShaderProgram("BlendShapeWeightPosProgram", "cs_blendshape_weight_pos", ShaderProgramType::Compute));
-	AddDependentShaderResource(GetRenderContext()->RegisterShaderProgram("BlendShapeFinalPosProgram", "cs_blendshape_final_pos", ShaderProgramType::Compute));
-	AddDependentShaderResource(GetRenderContext()->RegisterShaderProgram("BlendShapeUpdatePosProgram", "cs_blendshape_update_pos", ShaderProgramType::Compute));
+	if (UINT16_MAX == handle)
+	{
+		return;
+	}
+
+	if (isDynamic)
+	{
+		bgfx::destroy(bgfx::DynamicIndexBufferHandle{ handle });
+	}
+	else
+	{
+		bgfx::destroy(bgfx::IndexBufferHandle{ handle });
+	}
+	handle = UINT16_MAX;
+}
 
-	GetRenderContext()->CreateUniform(morphCountVertexCount, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(changedWeight, bgfx::UniformType::Vec4, 1);
+}
 
+BlendShapeRenderer::~BlendShapeRenderer()
+{
+	DestroyBuffers();
+}
+
+void BlendShapeRenderer::Init()
+{
 	bgfx::setViewName(GetViewID(), "BlendShapeRenderer");
+
+	m_batchParams.Init(GetRenderContext());
+
+	m_isComputeSupported = 0U != (bgfx::getCaps()->supported & BGFX_CAPS_COMPUTE);
+	if (m_isComputeSupported)
+	{
+		m_pBatchShaderResource = GetRenderContext()->RegisterShaderProgram("BlendShapeBatchProgram", "cs_blendshape_batch", ShaderProgramType::Compute);
+	}
 }
 
 void BlendShapeRenderer::UpdateView(const float* pViewMatrix, const float* pProjectionMatrix)
 {
-	UpdateViewRenderTarget();
-	bgfx::setViewTransform(GetViewID(), pViewMatrix, pProjectionMatrix);
+	// Only compute dispatches in this view.
 }
 
 void BlendShapeRenderer::Render(float deltaTime)
 {
-	for (const auto pResource : m_dependentShaderResources)
+	CD_PROFILE_ZONE("BlendShapes");
+
+	UpdateBatch();
+	if (0U == m_batch.GetMeshCount())
+	{
+		return;
+	}
+
+	// Changes are kept in the batch until the program is ready.
+	if (m_isComputeSupported && (!m_pBatchShaderResource || !IsResourceReady(m_pBatchShaderResource)))
+	{
+		return;
+	}
+
+	for (uint32_t meshIndex = 0U; meshIndex < m_batch.GetMeshCount(); ++meshIndex)
 	{
-		if (ResourceStatus::Ready != pResource->GetStatus() &&
-			ResourceStatus::Optimized != pResource->GetStatus())
+		BlendShapeComponent* pBlendShapeComponent = m_pCurrentSceneWorld->GetBlendShapeComponent(m_batchEntities[meshIndex]);
+		if (pBlendShapeComponent->IsDirty())
 		{
-			return;
+			m_batch.SetWeights(meshIndex, pBlendShapeComponent->GetWeights().data());
+			pBlendShapeComponent->SetDirty(false);
 		}
 	}
 
-	for (Entity entity : m_pCurrentSceneWorld->GetBlendShapeEntities())
+	// Meshes with unchanged weights are not in the work list.
+	const uint32_t workGroupCount = m_batch.BuildWorkGroups();
+	CD_PROFILE_COUNTER("BlendShape/ChangedMeshes", static_cast<int64_t>(m_batch.GetChangedMeshes().size()));
+	CD_PROFILE_COUNTER("BlendShape/WorkGroups", workGroupCount);
+	if (0U == workGroupCount)
 	{
-		// No blend shape?
-		BlendShapeComponent* pBlendShapeComponent = m_pCurrentSceneWorld->GetBlendShapeComponent(entity);
-		if (!pBlendShapeComponent)
+		return;
+	}
+
+	if (!m_isComputeSupported)
+	{
+		m_batch.Evaluate(m_finalPositions.data());
+		for (uint32_t meshIndex : m_batch.GetChangedMeshes())
 		{
-			continue;
+			const uint32_t firstVertex = m_batch.GetFirstVertex(meshIndex);
+			bgfx::update(bgfx::DynamicVertexBufferHandle{ m_finalPositionBufferHandle }, firstVertex,
+				bgfx::copy(&m_finalPositions[firstVertex * 4U], m_batch.GetVertexCount(meshIndex) * 4U * sizeof(float)));
 		}
+		return;
+	}
 
-		uint16_t viewId = GetViewID();
+	const std::vector<float>& weights = m_batch.GetWeights();
+	const std::vector<BlendShapeBatch::WorkGroup>& workGroups = m_batch.GetWorkGroups();
+	bgfx::update(bgfx::DynamicIndexBufferHandle{ m_morphWeightBufferHandle }, 0U,
+		bgfx::copy(weights.data(), static_cast<uint32_t>(weights.size() * sizeof(float))));
+	bgfx::update(bgfx::DynamicIndexBufferHandle{ m_workGroupBufferHandle }, 0U,
+		bgfx::copy(workGroups.data(), workGroupCount * static_cast<uint32_t>(sizeof(BlendShapeBatch::WorkGroup))));
 
-		// Compute Blend Shape
-		if (pBlendShapeComponent->IsDirty())
+	// One dispatch unless the work list exceeds the group count limit.
+	for (uint32_t firstGroup = 0U; firstGroup < workGroupCount; firstGroup += maxDispatchGroupCount)
+	{
+		const float batchParams[4] = { static_cast<float>(firstGroup), 0.0f, 0.0f, 0.0f };
+		m_batchParams.Set(batchParams);
+		bgfx::setBuffer(BS_AFFECTED_VERTEX_STAGE, bgfx::IndexBufferHandle{ m_affectedVertexBufferHandle }, bgfx::Access::Read);
+		bgfx::setBuffer(BS_MORPH_DELTA_STAGE, bgfx::IndexBufferHandle{ m_morphDeltaBufferHandle }, bgfx::Access::Read);
+		bgfx::setBuffer(BS_MORPH_WEIGHT_STAGE, bgfx::DynamicIndexBufferHandle{ m_morphWeightBufferHandle }, bgfx::Access::Read);
+		bgfx::setBuffer(BS_WORK_GROUP_STAGE, bgfx::DynamicIndexBufferHandle{ m_workGroupBufferHandle }, bgfx::Access::Read);
+		bgfx::setBuffer(BS_FINAL_POSITION_STAGE, bgfx::DynamicVertexBufferHandle{ m_finalPositionBufferHandle }, bgfx::Access::ReadWrite);
+		GetRenderContext()->Dispatch(GetViewID(), m_pBatchShaderResource->GetHandle(), std::min(workGroupCount - firstGroup, maxDispatchGroupCount), 1U, 1U);
+	}
+}
+
+void BlendShapeRenderer::UpdateBatch()
+{
+	const std::vector<Entity>& blendShapeEntities = m_pCurrentSceneWorld->GetBlendShapeEntities();
+	if (blendShapeEntities == m_blendShapeEntities)
+	{
+		return;
+	}
+
+	// Entities are rarely added or removed so the whole batch is rebuilt.
+	DestroyBuffers();
+	m_batch.Clear();
+	m_blendShapeEntities = blendShapeEntities;
+	m_batchEntities.clear();
+
+	std::vector<cd::Vec3f> basePositions;
+	std::vector<std::vector<uint32_t>> morphVertexIDs;
+	std::vector<std::vector<cd::Vec3f>> morphPositions;
+	std::vector<BlendShapeMorphTarget> morphTargets;
+	for (Entity entity : blendShapeEntities)
+	{
+		const BlendShapeComponent* pBlendShapeComponent = m_pCurrentSceneWorld->GetBlendShapeComponent(entity);
+		const cd::Mesh* pMesh = pBlendShapeComponent ? pBlendShapeComponent->GetMesh() : nullptr;
+		if (!pMesh)
 		{
-			bgfx::setBuffer(BS_ALL_MORPH_VERTEX_ID_STAGE, bgfx::IndexBufferHandle{pBlendShapeComponent->GetAllMorphVertexIDIB()}, bgfx::Access::Read);
-			bgfx::setBuffer(BS_ACTIVE_MORPH_DATA_STAGE, bgfx::DynamicIndexBufferHandle{pBlendShapeComponent->GetActiveMorphOffestLengthWeightIB()}, bgfx::Access::Read);
-			bgfx::setBuffer(BS_FINAL_MORPH_AFFECTED_STAGE, bgfx::DynamicVertexBufferHandle{pBlendShapeComponent->GetFinalMorphAffectedVB()}, bgfx::Access::ReadWrite);
-			constexpr StringCrc morphCountVertexCountCrc(morphCountVertexCount);
-			cd::Vec4f morphCount{ static_cast<float>(pBlendShapeComponent->GetActiveMorphCount()), static_cast<float>(pBlendShapeComponent->GetMeshVertexCount()), 0, 0};
-			GetRenderContext()->FillUniform(morphCountVertexCountCrc, &morphCount, 1);
-			GetRenderContext()->Dispatch(viewId, BlendShapeWeightsProgramCrc, 1U, 1U, 1U);
-
-			bgfx::setBuffer(BS_MORPH_AFFECTED_STAGE, bgfx::VertexBufferHandle{pBlendShapeComponent->GetMorphAffectedVB()}, bgfx::Access::Read);
-			bgfx::setBuffer(BS_FINAL_MORPH_AFFECTED_STAGE, bgfx::DynamicVertexBufferHandle{pBlendShapeComponent->GetFinalMorphAffectedVB()}, bgfx::Access::ReadWrite);
-			GetRenderContext()->FillUniform(morphCountVertexCountCrc, &morphCount, 1);
-			GetRenderContext()->Dispatch(viewId, BlendShapeWeightPosProgramCrc, 1U, 1U, 1U);
-
-			bgfx::setBuffer(BS_FINAL_MORPH_AFFECTED_STAGE, bgfx::DynamicVertexBufferHandle{pBlendShapeComponent->GetFinalMorphAffectedVB()}, bgfx::Access::ReadWrite);
-			bgfx::setBuffer(BS_ALL_MORPH_VERTEX_ID_STAGE, bgfx::IndexBufferHandle{pBlendShapeComponent->GetAllMorphVertexIDIB()}, bgfx::Access::Read);
-			bgfx::setBuffer(BS_ACTIVE_MORPH_DATA_STAGE, bgfx::DynamicIndexBufferHandle{pBlendShapeComponent->GetActiveMorphOffestLengthWeightIB()}, bgfx::Access::Read);
-			GetRenderContext()->FillUniform(morphCountVertexCountCrc, &morphCount, 1);
-			GetRenderContext()->Dispatch(viewId, BlendShapeFinalPosProgramCrc, 1U, 1U, 1U);
+			continue;
+		}
 
-			pBlendShapeComponent->SetDirty(false);
+		const uint32_t vertexCount = pBlendShapeComponent->GetMeshVertexCount();
+		basePositions.resize(vertexCount);
+		for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+		{
+			basePositions[vertexIndex] = pMesh->GetVertexPosition(vertexIndex);
 		}
 
-		if (pBlendShapeComponent->NeedUpdate()) 
+		const uint32_t morphCount = pBlendShapeComponent->GetMorphCount();
+		morphVertexIDs.resize(morphCount);
+		morphPositions.resize(morphCount);
+		morphTargets.resize(morphCount);
+		for (uint32_t morphIndex = 0U; morphIndex < morphCount; ++morphIndex)
 		{
-			pBlendShapeComponent->UpdateChanged();
-			bgfx::setBuffer(BS_MORPH_AFFECTED_STAGE, bgfx::VertexBufferHandle{pBlendShapeComponent->GetMorphAffectedVB()}, bgfx::Access::Read);
-			bgfx::setBuffer(BS_ALL_MORPH_VERTEX_ID_STAGE, bgfx::IndexBufferHandle{pBlendShapeComponent->GetAllMorphVertexIDIB()}, bgfx::Access::Read);
-			bgfx::setBuffer(BS_ACTIVE_MORPH_DATA_STAGE, bgfx::DynamicIndexBufferHandle{pBlendShapeComponent->GetActiveMorphOffestLengthWeightIB()}, bgfx::Access::Read);
-			bgfx::setBuffer(BS_FINAL_MORPH_AFFECTED_STAGE, bgfx::DynamicVertexBufferHandle{pBlendShapeComponent->GetFinalMorphAffectedVB()}, bgfx::Access::ReadWrite);
-			bgfx::setBuffer(BS_CHANGED_MORPH_INDEX_STAGE, bgfx::DynamicIndexBufferHandle{pBlendShapeComponent->GetChangedMorphIndexIB()}, bgfx::Access::Read);
-			//constexpr StringCrc changedWeightCrc(changedWeight);
-			//cd::Vec4f changedWeightData = cd::Vec4f{ static_cast<float>(pBlendShapeComponent->GetUpdatedWeight()),0,0,0 };
-			//GetRenderContext()->FillUniform(changedWeightCrc, &changedWeightData, 1);
-			GetRenderContext()->Dispatch(viewId, BlendShapeUpdatePosProgramCrc, 1U, 1U, 1U);
-
-			pBlendShapeComponent->ClearNeedUpdate();
+			const cd::Morph* pMorph = pBlendShapeComponent->GetMorphData(morphIndex);
+			const uint32_t morphVertexCount = pMorph->GetVertexCount();
+			morphVertexIDs[morphIndex].resize(morphVertexCount);
+			morphPositions[morphIndex].resize(morphVertexCount);
+			for (uint32_t vertexIndex = 0U; vertexIndex < morphVertexCount; ++vertexIndex)
+			{
+				morphVertexIDs[morphIndex][vertexIndex] = pMorph->GetVertexSourceID(vertexIndex).Data();
+				morphPositions[morphIndex][vertexIndex] = pMorph->GetVertexPosition(vertexIndex);
+			}
+			morphTargets[morphIndex] = { morphVertexIDs[morphIndex].data(), morphPositions[morphIndex].data(), morphVertexCount };
 		}
+
+		const uint32_t meshIndex = m_batch.AddMesh(basePositions.data(), vertexCount, morphTargets.data(), morphCount);
+		m_batch.SetWeights(meshIndex, pBlendShapeComponent->GetWeights().data());
+		m_batchEntities.push_back(entity);
+	}
+
+	CreateBuffers();
+	m_finalPositions = m_batch.GetBasePositions();
+	for (uint32_t meshIndex = 0U; meshIndex < m_batch.GetMeshCount(); ++meshIndex)
+	{
+		BlendShapeComponent* pBlendShapeComponent = m_pCurrentSceneWorld->GetBlendShapeComponent(m_batchEntities[meshIndex]);
+		pBlendShapeComponent->SetFinalMorphAffectedVB(m_finalPositionBufferHandle, m_batch.GetFirstVertex(meshIndex));
 	}
 }
 
-}
\ No newline at end of file
+void BlendShapeRenderer::CreateBuffers()
+{
+	if (0U == m_batch.GetTotalVertexCount())
+	{
+		return;
+	}
+
+	// Same layout as the position stream which blend shape materials expect, position and the base weight.
+	cd::VertexFormat finalPositionVF;
+	finalPositionVF.AddVertexAttributeLayout(cd::VertexAttributeType::Position, cd::GetAttributeValueType<cd::Point::ValueType>(), cd::Point::Size);
+	finalPositionVF.AddVertexAttributeLayout(cd::VertexAttributeType::BoneWeight, cd::AttributeValueType::Float, 1U);
+	bgfx::VertexLayout finalPositionVL;
+	VertexLayoutUtility::CreateVertexLayout(finalPositionVL, finalPositionVF.GetVertexAttributeLayouts());
+
+	const std::vector<float>& basePositions = m_batch.GetBasePositions();
+	bgfx::DynamicVertexBufferHandle finalPositionHandle = bgfx::createDynamicVertexBuffer(
+		bgfx::copy(basePositions.data(), static_cast<uint32_t>(basePositions.size() * sizeof(float))), finalPositionVL,
+		m_isComputeSupported ? BGFX_BUFFER_COMPUTE_READ_WRITE : BGFX_BUFFER_NONE);
+	assert(bgfx::isValid(finalPositionHandle));
+	m_finalPositionBufferHandle = finalPositionHandle.idx;
+
+	// Meshes without moved vertices don't need the compute buffers.
+	if (!m_isComputeSupported || m_batch.GetAffectedVertices().empty())
+	{
+		return;
+	}
+
+	const std::vector<BlendShapeBatch::AffectedVertex>& affectedVertices = m_batch.GetAffectedVertices();
+	const std::vector<BlendShapeBatch::MorphDelta>& morphDeltas = m_batch.GetMorphDeltas();
+	bgfx::IndexBufferHandle affectedVertexHandle = bgfx::createIndexBuffer(
+		bgfx::copy(affectedVertices.data(), static_cast<uint32_t>(affectedVertices.size() * sizeof(BlendShapeBatch::AffectedVertex))), computeReadFlags);
+	bgfx::IndexBufferHandle morphDeltaHandle = bgfx::createIndexBuffer(
+		bgfx::copy(morphDeltas.data(), static_cast<uint32_t>(morphDeltas.size() * sizeof(BlendShapeBatch::MorphDelta))), computeReadFlags);
+	bgfx::DynamicIndexBufferHandle morphWeightHandle = bgfx::createDynamicIndexBuffer(static_cast<uint32_t>(m_batch.GetWeights().size()), computeReadFlags);
+	bgfx::DynamicIndexBufferHandle workGroupHandle = bgfx::createDynamicIndexBuffer(m_batch.GetMaxWorkGroupCount() * 2U, computeReadFlags);
+	assert(bgfx::isValid(affectedVertexHandle) && bgfx::isValid(morphDeltaHandle) && bgfx::isValid(morphWeightHandle) && bgfx::isValid(workGroupHandle));
+	m_affectedVertexBufferHandle = affectedVertexHandle.idx;
+	m_morphDeltaBufferHandle = morphDeltaHandle.idx;
+	m_morphWeightBufferHandle = morphWeightHandle.idx;
+	m_workGroupBufferHandle = workGroupHandle.idx;
+}
+
+void BlendShapeRenderer::DestroyBuffers()
+{
+	DestroyBuffer(m_affectedVertexBufferHandle, false);
+	DestroyBuffer(m_morphDeltaBufferHandle, false);
+	DestroyBuffer(m_morphWeightBufferHandle, true);
+	DestroyBuffer(m_workGroupBufferHandle, true);
+	if (UINT16_MAX != m_finalPositionBufferHandle)
+	{
+		bgfx::destroy(bgfx::DynamicVertexBufferHandle{ m_finalPositionBufferHandle });
+		m_finalPositionBufferHandle = UINT16_MAX;
+	}
+}
+
+}
@@ -1,16 +1,27 @@
 #pragma once
 
+#include "Animation/BlendShapeBatch.h"
+#include "ECWorld/Entity.h"
 #include "Renderer.h"
+#include "Rendering/UniformSlot.h"
+
+#include <vector>
 
 namespace engine
 {
 
 class SceneWorld;
+class ShaderResource;
 
+// BlendShapeRenderer evaluates morphed positions of all blend shape meshes with one compute dispatch per frame.
+// Deltas of all meshes are in one BlendShapeBatch and only meshes whose weights changed are in the dispatch.
+// Morphed positions of all meshes share one vertex buffer. Backends without compute shaders evaluate on CPU.
+// Register it before passes which draw blend shapes so that its view runs first.
 class BlendShapeRenderer final : public Renderer
 {
 public:
 	using Renderer::Renderer;
+	virtual ~BlendShapeRenderer();
 
 	virtual void Init() override;
 	virtual void UpdateView(const float* pViewMatrix, const float* pProjectionMatrix) override;
@@ -18,8 +29,34 @@ public:
 
 	void SetSceneWorld(SceneWorld* pSceneWorld) { m_pCurrentSceneWorld = pSceneWorld; }
 
+	bool IsComputeSupported() const { return m_isComputeSupported; }
+	const BlendShapeBatch& GetBatch() const { return m_batch; }
+
+private:
+	// Rebuilds the batch when blend shape entities were added or removed.
+	void UpdateBatch();
+	void CreateBuffers();
+	void DestroyBuffers();
+
 private:
 	SceneWorld* m_pCurrentSceneWorld = nullptr;
+	ShaderResource* m_pBatchShaderResource = nullptr;
+	bool m_isComputeSupported = false;
+
+	BlendShapeBatch m_batch;
+	std::vector<Entity> m_blendShapeEntities;
+	// Entity of every mesh of the batch.
+	std::vector<Entity> m_batchEntities;
+	// Output of CPU evaluation.
+	std::vector<float> m_finalPositions;
+
+	uint16_t m_affectedVertexBufferHandle = UINT16_MAX;
+	uint16_t m_morphDeltaBufferHandle = UINT16_MAX;
+	uint16_t m_morphWeightBufferHandle = UINT16_MAX;
+	uint16_t m_workGroupBufferHandle = UINT16_MAX;
+	uint16_t m_finalPositionBufferHandle = UINT16_MAX;
+
+	Vec4Uniform<"u_blendShapeBatchParams"> m_batchParams;
 };
 
-}
\ No newline at end of file
+}
@@ -3,8 +3,6 @@
 #include "Rendering/RenderContext.h"
 #include "Rendering/Resources/ShaderResource.h"
 
-#include <format>
-
 namespace engine
 {
 
@@ -39,12 +37,12 @@ void BloomRenderer::Init()
 	AddDependentShaderResource(GetRenderContext()->RegisterShaderProgram(KawaseBlurProgram, "vs_fullscreen", "fs_kawaseblur"));
 	AddDependentShaderResource(GetRenderContext()->RegisterShaderProgram(CombineProgram, "vs_fullscreen", "fs_bloom"));
 
-	GetRenderContext()->CreateUniform("s_texture", bgfx::UniformType::Sampler);
-	GetRenderContext()->CreateUniform("s_bloom", bgfx::UniformType::Sampler);
-	GetRenderContext()->CreateUniform("s_lightingColor", bgfx::UniformType::Sampler);
-	GetRenderContext()->CreateUniform("u_textureSize", bgfx::UniformType::Vec4);
-	GetRenderContext()->CreateUniform("u_bloomIntensity", bgfx::UniformType::Vec4);
-	GetRenderContext()->CreateUniform("u_luminanceThreshold", bgfx::UniformType::Vec4);
+	m_textureSampler.Init(GetRenderContext());
+	m_bloomSampler.Init(GetRenderContext());
+	m_lightingColorSampler.Init(GetRenderContext());
+	m_textureSize.Init(GetRenderContext());
+	m_bloomIntensity.Init(GetRenderContext());
+	m_luminanceThreshold.Init(GetRenderContext());
 
 	bgfx::setViewName(GetViewID(), "BloomRenderer");
 
@@ -53,40 +51,25 @@ void BloomRenderer::Init()
 
 void BloomRenderer::AllocateViewIDs()
 {
-	Entity entity = m_pCurrentSceneWorld->GetMainCameraEntity();
-	CameraComponent* pCameraComponent = m_pCurrentSceneWorld->GetCameraComponent(entity);
-	assert(pCameraComponent);
-
-	for (int i = 0; i < TEX_CHAIN_LEN; i++)
-	{
-		m_sampleChainFB[i] = BGFX_INVALID_HANDLE;
-	}
-	for (int i = 0; i < 2; i++)
-	{
-		m_blurChainFB[i] = BGFX_INVALID_HANDLE;
-	}
-	m_combineFB = BGFX_INVALID_HANDLE;
-	m_startDowmSamplePassID = GetRenderContext()->CreateView();
-	for (int i = 0; i < TEX_CHAIN_LEN - 2; i++)
-	{
-		GetRenderContext()->CreateView();
-	}
-	m_startVerticalBlurPassID = GetRenderContext()->CreateView();
-	m_startHorizontalBlurPassID = GetRenderContext()->CreateView();
+	// The renderer's own view is taken by the first pass. Others are reserved when the graph needs them.
+	m_lastViewID = GetViewID();
+	m_renderGraph.SetViewRange(GetViewID(), 1);
+	m_renderGraph.OnReserveViews.Bind<BloomRenderer, &BloomRenderer::ReserveViews>(this);
+}
 
-	int totalBlurTimes = pCameraComponent->GetBlurMaxTimes() * 2;
-	for (int i = 0; i < totalBlurTimes - 2; i++)
-	{
-		GetRenderContext()->CreateView();
-	}
+uint16_t BloomRenderer::ReserveViews(uint16_t viewCount)
+{
+	// Later renderers created their views already so new views are ordered right after bloom's last view.
+	uint16_t firstViewID = GetRenderContext()->CreateViewsAfter(m_lastViewID, viewCount);
+	m_lastViewID = firstViewID + viewCount - 1;
+	return firstViewID;
+}
 
-	m_startUpSamplePassID = GetRenderContext()->CreateView();
-	for (int i = 0; i < TEX_CHAIN_LEN - 2; i++)
-	{
-		GetRenderContext()->CreateView();
-	}
-	m_combinePassID = GetRenderContext()->CreateView();
-	m_blitColorPassID = GetRenderContext()->CreateView();
+uint32_t BloomRenderer::AddPassData(RenderGraphResource input0, RenderGraphResource input1,
+	float textureSizeX, float textureSizeY, float textureSizeZ, float textureSizeW)
+{
+	m_passData.push_back(PassData{ { input0, input1 }, { textureSizeX, textureSizeY, textureSizeZ, textureSizeW } });
+	return static_cast<uint32_t>(m_passData.size() - 1);
 }
 
 void BloomRenderer::SetEnable(bool value)
@@ -94,6 +77,11 @@ void BloomRenderer::SetEnable(bool value)
 	Entity entity = m_pCurrentSceneWorld->GetMainCameraEntity();
 	CameraComponent* pCameraComponent = m_pCurrentSceneWorld->GetCameraComponent(entity);
 	pCameraComponent->SetBloomEnable(value);
+	if (!value)
+	{
+		// Nothing is rendered without bloom so pooled textures are released now.
+		m_renderGraph.Reset();
+	}
 }
 
 bool BloomRenderer::IsEnable() const
@@ -126,14 +114,9 @@ void BloomRenderer::UpdateView(const float* pViewMatrix, const float* pProjectio
 		Entity entity = m_pCurrentSceneWorld->GetMainCameraEntity();
 		CameraComponent* pCameraComponent = m_pCurrentSceneWorld->GetCameraComponent(entity);
 
-		constexpr uint64_t tsFlags = 0 | BGFX_TEXTURE_RT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP;
+		// Textures of the old size are released by the render graph after they stay unused for a few frames.
 		for (int ii = 0; ii < TEX_CHAIN_LEN; ++ii)
 		{
-			if (bgfx::isValid(m_sampleChainFB[ii]))
-			{
-				bgfx::destroy(m_sampleChainFB[ii]);
-			}
-
 			int viewWidth = m_width >> ii;
 			int viewHeight = m_height >> ii;
 			if (viewWidth < 2 || viewHeight < 2)
@@ -141,16 +124,20 @@ void BloomRenderer::UpdateView(const float* pViewMatrix, const float* pProjectio
 				pCameraComponent->SetBloomDownSampleMaxTimes(std::max(ii - 1, 0));
 				break;
 			}
-
-			m_sampleChainFB[ii] = bgfx::createFrameBuffer(viewWidth, viewHeight, bgfx::TextureFormat::RGBA32F, tsFlags);
 		}
-
-		m_combineFB = bgfx::createFrameBuffer(m_width, m_height, bgfx::TextureFormat::RGBA32F, tsFlags);
 	}
 }
 
 void BloomRenderer::Render(float deltaTime)
 {
+	Entity entity = m_pCurrentSceneWorld->GetMainCameraEntity();
+	m_pCameraComponent = m_pCurrentSceneWorld->GetCameraComponent(entity);
+	if (!m_pCameraComponent->GetIsBloomEnable())
+	{
+		// No passes write the scene color so nothing is imported and no view is used.
+		return;
+	}
+
 	for (const auto pResource : m_dependentShaderResources)
 	{
 		if (ResourceStatus::Ready != pResource->GetStatus() &&
@@ -181,26 +168,43 @@ void BloomRenderer::Render(float deltaTime)
 		screenEmissColorTextureHandle = pInputRT->GetTextureHandle(1);
 	}
 
-	Entity entity = m_pCurrentSceneWorld->GetMainCameraEntity();
-	CameraComponent* pCameraComponent = m_pCurrentSceneWorld->GetCameraComponent(entity);
+	CameraComponent* pCameraComponent = m_pCameraComponent;
 
-	cd::Matrix4x4 orthoMatrix = cd::Matrix4x4::Orthographic(0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1000.0f, 0.0f, bgfx::getCaps()->homogeneousDepth);
+	m_orthoMatrix = cd::Matrix4x4::Orthographic(0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1000.0f, 0.0f, bgfx::getCaps()->homogeneousDepth);
 
-	// capture
-	bgfx::setViewFrameBuffer(GetViewID(), m_sampleChainFB[0]);
-	bgfx::setViewRect(GetViewID(), 0, 0, m_width, m_height);
-	bgfx::setViewTransform(GetViewID(), nullptr, orthoMatrix.begin());
+	constexpr uint64_t tsFlags = 0 | BGFX_TEXTURE_RT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP;
+	auto ChainTextureDesc = [this](int shift)
+	{
+		return RenderGraphTextureDesc{ static_cast<uint16_t>(m_width >> shift), static_cast<uint16_t>(m_height >> shift), bgfx::TextureFormat::RGBA32F, tsFlags };
+	};
 
-	constexpr StringCrc luminanceThresholdUniformName("u_luminanceThreshold");
-	bgfx::setUniform(GetRenderContext()->GetUniform(luminanceThresholdUniformName), &pCameraComponent->GetLuminanceThreshold());
+	// Capacity is kept across frames.
+	m_passData.clear();
 
-	constexpr StringCrc textureSampler("s_texture");
-	bgfx::setTexture(0, GetRenderContext()->GetUniform(textureSampler), screenEmissColorTextureHandle);
+	RenderGraph& renderGraph = m_renderGraph;
+	const RenderGraphResource sceneColor = renderGraph.ImportTexture("SceneColor", screenTextureHandle, ChainTextureDesc(0));
+	const RenderGraphResource sceneEmissColor = renderGraph.ImportTexture("SceneEmissColor", screenEmissColorTextureHandle, ChainTextureDesc(0));
 
-	bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
-	Renderer::ScreenSpaceQuad(GetRenderTarget(), false);
+	// capture
+	RenderGraphResource sampleChain[TEX_CHAIN_LEN];
+	renderGraph.AddPass("BloomRenderer", [&](RenderGraphBuilder& builder)
+	{
+		builder.Read(sceneEmissColor);
+		sampleChain[0] = builder.WriteAttachment(builder.CreateTexture("SampleChain_0", ChainTextureDesc(0)));
+	},
+	[this, passDataIndex = AddPassData(sceneEmissColor)](const RenderGraph& graph, uint16_t viewID)
+	{
+		const PassData& passData = m_passData[passDataIndex];
+		bgfx::setViewTransform(viewID, nullptr, m_orthoMatrix.begin());
 
-	GetRenderContext()->Submit(GetViewID(), CapTureBrightnessProgramCrc);
+		m_luminanceThreshold.Set(&m_pCameraComponent->GetLuminanceThreshold());
+		m_textureSampler.Bind(0, graph.GetTexture(passData.inputs[0]));
+
+		bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
+		Renderer::ScreenSpaceQuad(GetRenderTarget(), false);
+
+		GetRenderContext()->Submit(viewID, CapTureBrightnessProgramCrc);
+	});
 
 	// downsample
 	int sampleTimes = std::min(pCameraComponent->GetBloomDownSampleTimes(), pCameraComponent->GetBloomDownSampleMaxTimes());
@@ -209,157 +213,179 @@ void BloomRenderer::Render(float deltaTime)
 	{
 		int shift = sampleIndex + 1;
 		tempshift = shift;
-		const float pixelSize[4] =
+		const RenderGraphTextureDesc& inputDesc = renderGraph.GetTextureDesc(sampleChain[sampleIndex]);
+		const uint32_t passDataIndex = AddPassData(sampleChain[sampleIndex], InvalidRenderGraphResource,
+			1.0f / static_cast<float>(inputDesc.width >> 1), 1.0f / static_cast<float>(inputDesc.height >> 1));
+		renderGraph.AddPass("Downsample", [&](RenderGraphBuilder& builder)
 		{
-			1.0f / static_cast<float>(m_width >> shift),
-			1.0f / static_cast<float>(m_height >> shift),
-			0.0f,
-			0.0f,
-		};
-
-		bgfx::setViewFrameBuffer(m_startDowmSamplePassID + sampleIndex, m_sampleChainFB[shift]);
-		bgfx::setViewName(m_startDowmSamplePassID + sampleIndex, std::format("Downsample_{}", sampleIndex).c_str());
-		bgfx::setViewRect(m_startDowmSamplePassID + sampleIndex, 0, 0, m_width >> shift, m_height >> shift);
-		bgfx::setViewTransform(m_startDowmSamplePassID + sampleIndex, nullptr, orthoMatrix.begin());
+			builder.Read(sampleChain[sampleIndex]);
+			sampleChain[shift] = builder.WriteAttachment(builder.CreateTexture("SampleChain", ChainTextureDesc(shift)));
+		},
+		[this, passDataIndex](const RenderGraph& graph, uint16_t viewID)
+		{
+			const PassData& passData = m_passData[passDataIndex];
+			bgfx::setViewTransform(viewID, nullptr, m_orthoMatrix.begin());
 
-		constexpr StringCrc textureSizeUniformName("u_textureSize");
-		bgfx::setUniform(GetRenderContext()->GetUniform(textureSizeUniformName), pixelSize);
+			m_textureSize.Set(passData.textureSize);
 
-		bgfx::setTexture(0, GetRenderContext()->GetUniform(textureSampler), bgfx::getTexture(m_sampleChainFB[sampleIndex]));
+			m_textureSampler.Bind(0, graph.GetTexture(passData.inputs[0]));
 
-		bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
-		Renderer::ScreenSpaceQuad(GetRenderTarget(), false);
+			bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
+			Renderer::ScreenSpaceQuad(GetRenderTarget(), false);
 
-		GetRenderContext()->Submit(m_startDowmSamplePassID + sampleIndex, DownSampleProgramCrc);
+			GetRenderContext()->Submit(viewID, DownSampleProgramCrc);
+		});
 	}
 
+	RenderGraphResource blurOutput = InvalidRenderGraphResource;
 	if (pCameraComponent->GetIsBlurEnable() && pCameraComponent->GetBlurTimes() != 0)
 	{
-		Blur(m_width >> tempshift, m_height >> tempshift, pCameraComponent->GetBlurTimes(), pCameraComponent->GetBlurSize(), pCameraComponent->GetBlurScaling(), orthoMatrix, bgfx::getTexture(m_sampleChainFB[tempshift]));
+		blurOutput = AddBlurPasses(sampleChain[tempshift], pCameraComponent->GetBlurTimes(), pCameraComponent->GetBlurSize(), pCameraComponent->GetBlurScaling());
 	}
 
 	// upsample
 	for (int sampleIndex = 0; sampleIndex < sampleTimes; ++sampleIndex)
 	{
 		int shift = sampleTimes - sampleIndex - 1;
-		const float pixelSize[4] =
+		const RenderGraphResource input = (InvalidRenderGraphResource != blurOutput && 0 == sampleIndex) ? blurOutput : sampleChain[shift + 1];
+		const RenderGraphTextureDesc& outputDesc = renderGraph.GetTextureDesc(sampleChain[shift]);
+		const uint32_t passDataIndex = AddPassData(input, InvalidRenderGraphResource,
+			1.0f / static_cast<float>(outputDesc.width), 1.0f / static_cast<float>(outputDesc.height));
+		renderGraph.AddPass("Upsample", [&](RenderGraphBuilder& builder)
+		{
+			builder.Read(input);
+			// Blends into the downsampled content.
+			builder.Read(sampleChain[shift]);
+			builder.WriteAttachment(sampleChain[shift]);
+		},
+		[this, passDataIndex](const RenderGraph& graph, uint16_t viewID)
 		{
-			1.0f / static_cast<float>(m_width >> shift),
-			1.0f / static_cast<float>(m_height >> shift),
-			0.0f,
-			0.0f,
-		};
+			const PassData& passData = m_passData[passDataIndex];
+			bgfx::setViewTransform(viewID, nullptr, m_orthoMatrix.begin());
 
-		bgfx::setViewFrameBuffer(m_startUpSamplePassID + sampleIndex, m_sampleChainFB[shift]);
-		bgfx::setViewName(m_startUpSamplePassID + sampleIndex, std::format("Upsample_{}", sampleIndex).c_str());
-		bgfx::setViewRect(m_startUpSamplePassID + sampleIndex, 0, 0, m_width >> shift, m_height >> shift);
-		bgfx::setViewTransform(m_startUpSamplePassID + sampleIndex, nullptr, orthoMatrix.begin());
+			m_textureSize.Set(passData.textureSize);
 
-		constexpr StringCrc textureSizeUniformName("u_textureSize");
-		bgfx::setUniform(GetRenderContext()->GetUniform(textureSizeUniformName), pixelSize);
+			m_bloomIntensity.Set(&m_pCameraComponent->GetBloomIntensity());
 
-		constexpr StringCrc bloomIntensityUniformName("u_bloomIntensity");
-		bgfx::setUniform(GetRenderContext()->GetUniform(bloomIntensityUniformName), &pCameraComponent->GetBloomIntensity());
+			m_textureSampler.Bind(0, graph.GetTexture(passData.inputs[0]));
 
-		if (pCameraComponent->GetIsBlurEnable() && pCameraComponent->GetBlurTimes() != 0 && 0 == sampleIndex)
-		{
-			bgfx::setTexture(0, GetRenderContext()->GetUniform(textureSampler), bgfx::getTexture(m_blurChainFB[1]));
-		}
-		else
-		{
-			bgfx::setTexture(0, GetRenderContext()->GetUniform(textureSampler), bgfx::getTexture(m_sampleChainFB[shift + 1]));
-		}
-
-		bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_BLEND_ADD);
-		Renderer::ScreenSpaceQuad(GetRenderTarget(), false);
+			bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_BLEND_ADD);
+			Renderer::ScreenSpaceQuad(GetRenderTarget(), false);
 
-		GetRenderContext()->Submit(m_startUpSamplePassID + sampleIndex, UpSampleProgramCrc);
+			GetRenderContext()->Submit(viewID, UpSampleProgramCrc);
+		});
 	}
 
 	// combine 
-	bgfx::setViewFrameBuffer(m_combinePassID, m_combineFB);
-	bgfx::setViewName(m_combinePassID, "CombineBloom");
-	bgfx::setViewRect(m_combinePassID, 0, 0, m_width, m_height);
-	bgfx::setViewTransform(m_combinePassID, nullptr, orthoMatrix.begin());
+	RenderGraphResource combineColor = InvalidRenderGraphResource;
+	renderGraph.AddPass("CombineBloom", [&](RenderGraphBuilder& builder)
+	{
+		builder.Read(sceneColor);
+		builder.Read(sampleChain[0]);
+		combineColor = builder.WriteAttachment(builder.CreateTexture("CombineColor", ChainTextureDesc(0)));
+	},
+	[this, passDataIndex = AddPassData(sceneColor, sampleChain[0])](const RenderGraph& graph, uint16_t viewID)
+	{
+		const PassData& passData = m_passData[passDataIndex];
+		bgfx::setViewTransform(viewID, nullptr, m_orthoMatrix.begin());
 
-	constexpr StringCrc lightColorSampler("s_lightingColor");
-	bgfx::setTexture(0, GetRenderContext()->GetUniform(lightColorSampler), screenTextureHandle);
+		m_lightingColorSampler.Bind(0, graph.GetTexture(passData.inputs[0]));
+		m_bloomSampler.Bind(1, graph.GetTexture(passData.inputs[1]));
 
-	constexpr StringCrc bloomcolorSampler("s_bloom");
-	bgfx::setTexture(1, GetRenderContext()->GetUniform(bloomcolorSampler), bgfx::getTexture(m_sampleChainFB[0]));
+		bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
+		Renderer::ScreenSpaceQuad(GetRenderTarget(), false);
 
-	bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
-	Renderer::ScreenSpaceQuad(GetRenderTarget(), false);
+		GetRenderContext()->Submit(viewID, CombineProgramCrc);
+	});
 
-	GetRenderContext()->Submit(m_combinePassID, CombineProgramCrc);
+	// Writes back to the scene color which is imported so the graph keeps everything it depends on.
+	renderGraph.AddPass("BlitBloom", [&](RenderGraphBuilder& builder)
+	{
+		builder.Read(combineColor);
+		builder.Write(sceneColor);
+	},
+	[this, passDataIndex = AddPassData(combineColor, sceneColor)](const RenderGraph& graph, uint16_t viewID)
+	{
+		const PassData& passData = m_passData[passDataIndex];
+		bgfx::blit(viewID, graph.GetTexture(passData.inputs[1]), 0, 0, graph.GetTexture(passData.inputs[0]));
+	});
 
-	bgfx::blit(m_blitColorPassID, screenTextureHandle, 0, 0, bgfx::getTexture(m_combineFB));
+	renderGraph.Compile();
+	renderGraph.Execute();
 }
 
-void BloomRenderer::Blur(uint16_t width, uint16_t height, int iteration, float blursize, int blurscaling, cd::Matrix4x4 ortho, bgfx::TextureHandle texture)
+RenderGraphResource BloomRenderer::AddBlurPasses(RenderGraphResource input, int iteration, float blursize, int blurscaling)
 {
-	width = static_cast<int>(width / blurscaling);
-	height = static_cast<int>(height / blurscaling);
+	RenderGraph& renderGraph = m_renderGraph;
+	RenderGraphTextureDesc blurDesc = renderGraph.GetTextureDesc(input);
+	blurDesc.width = static_cast<uint16_t>(blurDesc.width / blurscaling);
+	blurDesc.height = static_cast<uint16_t>(blurDesc.height / blurscaling);
 
-	const uint64_t tsFlags = 0 | BGFX_TEXTURE_RT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP;
-	for (int ii = 0; ii < 2; ++ii)
-	{
-		if (bgfx::isValid(m_blurChainFB[ii])) bgfx::destroy(m_blurChainFB[ii]);
-		m_blurChainFB[ii] = bgfx::createFrameBuffer(width, height, bgfx::TextureFormat::RGBA32F, tsFlags);
-	}
-
-	uint16_t verticalViewID = m_startVerticalBlurPassID;
-	uint16_t horizontalViewID = m_startHorizontalBlurPassID;
+	RenderGraphResource blurChain[2] = { InvalidRenderGraphResource, InvalidRenderGraphResource };
 	for (int i = 0; i < iteration; i++)
 	{
-		float pixelSize[4] =
-		{
-			1.0f / static_cast<float>(width),
-			1.0f / static_cast<float>(height),
-			static_cast<float>(i / blurscaling) + blursize, /*i + blursize*/
-			1.0f,
-		};
+		const float textureSizeX = 1.0f / static_cast<float>(blurDesc.width);
+		const float textureSizeY = 1.0f / static_cast<float>(blurDesc.height);
+		const float blurOffset = static_cast<float>(i / blurscaling) + blursize; /*i + blursize*/
 
-		bgfx::setViewFrameBuffer(verticalViewID, m_blurChainFB[0]);
-		bgfx::setViewName(verticalViewID, "BlurVertical");
-		bgfx::setViewRect(verticalViewID, 0, 0, width, height);
-		bgfx::setViewTransform(verticalViewID, nullptr, ortho.begin());
+		const RenderGraphResource verticalInput = 0 == i ? input : blurChain[1];
+		renderGraph.AddPass("BlurVertical", [&](RenderGraphBuilder& builder)
+		{
+			builder.Read(verticalInput);
+			if (InvalidRenderGraphResource == blurChain[0])
+			{
+				blurChain[0] = builder.CreateTexture("BlurChain_0", blurDesc);
+			}
+			builder.WriteAttachment(blurChain[0]);
+		},
+		[this, passDataIndex = AddPassData(verticalInput, InvalidRenderGraphResource, textureSizeX, textureSizeY, blurOffset, 1.0f)](const RenderGraph& graph, uint16_t viewID)
+		{
+			const PassData& passData = m_passData[passDataIndex];
+			bgfx::setViewTransform(viewID, nullptr, m_orthoMatrix.begin());
 
-		constexpr StringCrc textureSizeUniformName("u_textureSize");
-		bgfx::setUniform(GetRenderContext()->GetUniform(textureSizeUniformName), pixelSize);
+			m_textureSize.Set(passData.textureSize);
 
-		constexpr StringCrc textureSampler("s_texture");
-		bgfx::setTexture(0, GetRenderContext()->GetUniform(textureSampler), i == 0 ? texture : bgfx::getTexture(m_blurChainFB[1]));
+			m_textureSampler.Bind(0, graph.GetTexture(passData.inputs[0]));
 
-		bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
-		Renderer::ScreenSpaceQuad(GetRenderTarget(), false);
+			bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
+			Renderer::ScreenSpaceQuad(GetRenderTarget(), false);
 
-		GetRenderContext()->Submit(verticalViewID, KawaseBlurProgramCrc);
+			GetRenderContext()->Submit(viewID, KawaseBlurProgramCrc);
+		});
 
 		//constexpr StringCrc BlurHorizontalprogramName("BlurVerticalProgram"); // use Gaussian Blur
 		//bgfx::submit(horizontal, GetRenderContext()->GetProgram(BlurHorizontalprogramName));
 
 		// vertical
-		bgfx::setViewFrameBuffer(horizontalViewID, m_blurChainFB[1]);
-		bgfx::setViewName(horizontalViewID, "BlurHorizontal");
-		bgfx::setViewRect(horizontalViewID, 0, 0, width, height);
-		bgfx::setViewTransform(horizontalViewID, nullptr, ortho.begin());
+		renderGraph.AddPass("BlurHorizontal", [&](RenderGraphBuilder& builder)
+		{
+			builder.Read(blurChain[0]);
+			if (InvalidRenderGraphResource == blurChain[1])
+			{
+				blurChain[1] = builder.CreateTexture("BlurChain_1", blurDesc);
+			}
+			builder.WriteAttachment(blurChain[1]);
+		},
+		[this, passDataIndex = AddPassData(blurChain[0], InvalidRenderGraphResource, textureSizeX, textureSizeY, blurOffset, 1.0f)](const RenderGraph& graph, uint16_t viewID)
+		{
+			const PassData& passData = m_passData[passDataIndex];
+			bgfx::setViewTransform(viewID, nullptr, m_orthoMatrix.begin());
 
-		bgfx::setUniform(GetRenderContext()->GetUniform(textureSizeUniformName), pixelSize);
+			m_textureSize.Set(passData.textureSize);
 
-		bgfx::setTexture(0, GetRenderContext()->GetUniform(textureSampler), bgfx::getTexture(m_blurChainFB[0]));
+			m_textureSampler.Bind(0, graph.GetTexture(passData.inputs[0]));
 
-		bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
-		Renderer::ScreenSpaceQuad(GetRenderTarget(), false);
+			bgfx::setState(BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A);
+			Renderer::ScreenSpaceQuad(GetRenderTarget(), false);
 
-		GetRenderContext()->Submit(horizontalViewID, KawaseBlurProgramCrc);
+			GetRenderContext()->Submit(viewID, KawaseBlurProgramCrc);
+		});
 
 		//constexpr StringCrc BlurVerticalprogramName("BlurVerticalProgram");  // use Gaussian Blur
 		//bgfx::submit(horizontal, GetRenderContext()->GetProgram(BlurVerticalprogramName));
-
-		verticalViewID += 2;
-		horizontalViewID += 2;
 	}
+
+	return blurChain[1];
 }
 
 }
@@ -2,6 +2,8 @@
 
 #include "ECWorld/SceneWorld.h"
 #include "Renderer.h"
+#include "Rendering/RenderGraph.h"
+#include "Rendering/UniformSlot.h"
 #include<bgfx/bgfx.h>
 #include<vector>
 
@@ -25,24 +27,39 @@ namespace engine
 		void SetSceneWorld(SceneWorld* pSceneWorld) { m_pCurrentSceneWorld = pSceneWorld; }
 
 	private:
+		// Resources and uniforms of one pass in the current frame.
+		// Execute functions only capture this and an index so that std::function doesn't allocate.
+		struct PassData
+		{
+			RenderGraphResource inputs[2];
+			float textureSize[4];
+		};
+
 		void AllocateViewIDs();
-		void Blur(uint16_t width , uint16_t height,int iteration, float blursize, int blurscaling,cd::Matrix4x4 ortho, bgfx::TextureHandle texture);
+		uint16_t ReserveViews(uint16_t viewCount);
+		uint32_t AddPassData(RenderGraphResource input0, RenderGraphResource input1 = InvalidRenderGraphResource,
+			float textureSizeX = 0.0f, float textureSizeY = 0.0f, float textureSizeZ = 0.0f, float textureSizeW = 0.0f);
+		RenderGraphResource AddBlurPasses(RenderGraphResource input, int iteration, float blursize, int blurscaling);
 
 		SceneWorld* m_pCurrentSceneWorld = nullptr;
+		CameraComponent* m_pCameraComponent = nullptr;
 
-		bgfx::FrameBufferHandle m_blurChainFB[2];
-		bgfx::FrameBufferHandle m_sampleChainFB[TEX_CHAIN_LEN];
-		bgfx::FrameBufferHandle m_combineFB;
+		// Sample chain, blur and combine textures are transient in the graph.
+		// Views are reserved when the compiled graph has more alive passes than before.
+		RenderGraph m_renderGraph;
+		std::vector<PassData> m_passData;
+		uint16_t m_lastViewID = 0;
+		cd::Matrix4x4 m_orthoMatrix;
 
-		uint16_t m_width;
-		uint16_t m_height;
+		uint16_t m_width = 0;
+		uint16_t m_height = 0;
 
-		uint16_t m_startDowmSamplePassID;
-		uint16_t m_startVerticalBlurPassID;
-		uint16_t m_startHorizontalBlurPassID;
-		uint16_t m_startUpSamplePassID;
-		uint16_t m_blitColorPassID;
-		uint16_t m_combinePassID;
+		SamplerUniform<"s_texture"> m_textureSampler;
+		SamplerUniform<"s_bloom"> m_bloomSampler;
+		SamplerUniform<"s_lightingColor"> m_lightingColorSampler;
+		Vec4Uniform<"u_textureSize"> m_textureSize;
+		Vec4Uniform<"u_bloomIntensity"> m_bloomIntensity;
+		Vec4Uniform<"u_luminanceThreshold"> m_luminanceThreshold;
 	};
 
 }
\ No newline at end of file
@@ -103,7 +103,7 @@ void CelluloidRenderer::Render(float deltaTime)
 			}
 
 			textureSlotBindTable[textureInfo.slot] = true;
-			bgfx::setTexture(textureInfo.slot, bgfx::UniformHandle{ pTextureResource->GetSamplerHandle() }, bgfx::TextureHandle{ pTextureResource->GetTextureHandle() });
+			GetRenderContext()->BindTexture(textureInfo.slot, pTextureResource->GetTextureHandle(), pTextureResource->GetSamplerFlags());
 		}
 		constexpr StringCrc dividLineCrc(dividLine);
 		GetRenderContext()->FillUniform(dividLineCrc, pMaterialComponent->GetToonParameters().dividLine.begin(), 1);
@@ -312,7 +312,7 @@ void DDGIRenderer::Render(float deltaTime)
 		}
 		bgfx::setState(state);
 
-		bgfx::submit(GetViewID(), bgfx::ProgramHandle{pMaterialComponent->GetShadreProgram()});
+		GetRenderContext()->Submit(GetViewID(), pMaterialComponent->GetShadreProgram());
 	}
 }
 
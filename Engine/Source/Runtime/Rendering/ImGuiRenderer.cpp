@@ -180,6 +180,7 @@ void ImGuiRenderer::Render(float deltaTime)
 
 					constexpr StringCrc programHandleIndex{ "ImGuiProgram" };
 					pEncoder->submit(GetViewID(), bgfx::ProgramHandle{ GetRenderContext()->GetResourceContext()->GetShaderResource(programHandleIndex)->GetHandle()});
+					RenderCommandCounter::AddDrawCall();
 				}
 			}
 		}
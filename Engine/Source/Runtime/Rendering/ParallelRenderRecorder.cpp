@@ -0,0 +1,93 @@
+#include "ParallelRenderRecorder.h"
+
+#include "Core/Jobs/JobSystem.h"
+#include "Core/Memory/MemoryTracker.h"
+#include "Profiling/Profile.h"
+#include "Rendering/Renderer.h"
+
+#include <bgfx/bgfx.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace engine
+{
+
+void ParallelRenderRecorder::Add(Renderer* pRenderer, float deltaTime)
+{
+	assert(JobSystem::IsMainThread());
+	assert(pRenderer->IsParallelRecordSupported());
+
+	if (!pRenderer->PrepareRecord(deltaTime))
+	{
+		return;
+	}
+
+	for (uint32_t taskIndex = 0U, taskCount = pRenderer->GetRecordTaskCount(); taskIndex < taskCount; ++taskIndex)
+	{
+		m_tasks.push_back({ pRenderer, taskIndex });
+	}
+}
+
+void ParallelRenderRecorder::Record()
+{
+	assert(JobSystem::IsMainThread());
+
+	const uint32_t taskCount = GetTaskCount();
+	JobSystem& jobSystem = JobSystem::Get();
+	if (taskCount <= 1U || !jobSystem.IsInitialized() || 1U == jobSystem.GetThreadCount())
+	{
+		m_lastJobCount = taskCount > 0U ? 1U : 0U;
+		RecordTasks(0U, taskCount);
+		m_tasks.clear();
+		return;
+	}
+
+	// One job per thread at most. More jobs only ask bgfx for more encoders.
+	const uint32_t maxJobCount = std::min(jobSystem.GetThreadCount(), static_cast<uint32_t>(bgfx::getCaps()->limits.maxEncoders));
+	const uint32_t batchSize = (taskCount + maxJobCount - 1U) / maxJobCount;
+	m_lastJobCount = (taskCount + batchSize - 1U) / batchSize;
+	jobSystem.ParallelFor(taskCount, batchSize, [this](uint32_t begin, uint32_t end)
+	{
+		RecordTasks(begin, end);
+	});
+
+	// Encoder 0 of the main thread is always available.
+	for (const RecordTask& task : m_fallbackTasks)
+	{
+		CD_PROFILE_ZONE_VIEW("Record", task.pRenderer->GetViewID());
+		task.pRenderer->Record(bgfx::begin(), task.taskIndex);
+	}
+	m_fallbackTasks.clear();
+	m_tasks.clear();
+}
+
+void ParallelRenderRecorder::RecordTasks(uint32_t begin, uint32_t end)
+{
+	// Tags don't follow jobs to worker threads.
+	CD_MEMORY_TAG_SCOPE(Rendering);
+
+	// Main thread uses bgfx's default encoder. Worker threads need their own one.
+	const bool isMainThread = JobSystem::IsMainThread();
+	bgfx::Encoder* pEncoder = bgfx::begin(!isMainThread);
+	if (!pEncoder)
+	{
+		std::lock_guard<std::mutex> lock(m_fallbackMutex);
+		m_fallbackTasks.insert(m_fallbackTasks.end(), m_tasks.begin() + begin, m_tasks.begin() + end);
+		return;
+	}
+
+	for (uint32_t taskIndex = begin; taskIndex < end; ++taskIndex)
+	{
+		const RecordTask& task = m_tasks[taskIndex];
+		CD_PROFILE_ZONE_VIEW("Record", task.pRenderer->GetViewID());
+		task.pRenderer->Record(pEncoder, task.taskIndex);
+	}
+
+	if (!isMainThread)
+	{
+		bgfx::end(pEncoder);
+	}
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace engine
+{
+
+class Renderer;
+
+// ParallelRenderRecorder collects record tasks from renderers which support parallel recording
+// and records them on JobSystem threads. Every job records its tasks into its own bgfx encoder.
+// bgfx sorts draw calls by view so the final frame is the same as recording the tasks in sequence.
+class ParallelRenderRecorder final
+{
+public:
+	ParallelRenderRecorder() = default;
+	ParallelRenderRecorder(const ParallelRenderRecorder&) = delete;
+	ParallelRenderRecorder& operator=(const ParallelRenderRecorder&) = delete;
+	ParallelRenderRecorder(ParallelRenderRecorder&&) = delete;
+	ParallelRenderRecorder& operator=(ParallelRenderRecorder&&) = delete;
+	~ParallelRenderRecorder() = default;
+
+	// Main thread. Calls PrepareRecord in renderer list order so that data produced for later renderers is ready.
+	void Add(Renderer* pRenderer, float deltaTime);
+
+	// Main thread. Records all queued tasks and blocks until every encoder is ended. Call it before bgfx::frame.
+	void Record();
+
+	uint32_t GetTaskCount() const { return static_cast<uint32_t>(m_tasks.size()); }
+	uint32_t GetLastJobCount() const { return m_lastJobCount; }
+
+private:
+	struct RecordTask
+	{
+		Renderer* pRenderer;
+		uint32_t taskIndex;
+	};
+
+	void RecordTasks(uint32_t begin, uint32_t end);
+
+private:
+	std::vector<RecordTask> m_tasks;
+	uint32_t m_lastJobCount = 0U;
+
+	// bgfx has a limited number of encoders. Jobs which fail to get one leave their tasks to the main thread.
+	std::mutex m_fallbackMutex;
+	std::vector<RecordTask> m_fallbackTasks;
+};
+
+}
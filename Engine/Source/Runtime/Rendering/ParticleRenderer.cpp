@@ -9,19 +9,14 @@
 #include "Rendering/Resources/ShaderResource.h"
 #include "../UniformDefines/U_Particle.sh"
 
+#include <algorithm>
+
 namespace engine
 {
 
 namespace
 {
 
-constexpr const char* particlePos = "u_particlePos";
-constexpr const char* particleScale = "u_particleScale";
-constexpr const char* shapeRange = "u_shapeRange";
-constexpr const char* particleColor = "u_particleColor";
-constexpr const char* ribbonCount = "u_ribbonCount";
-constexpr const char* ribbonMaxPos = "u_ribbonMaxPos";
-
 uint64_t state_tristrip = BGFX_STATE_WRITE_MASK | BGFX_STATE_MSAA | BGFX_STATE_DEPTH_TEST_LESS |
 BGFX_STATE_BLEND_FUNC(BGFX_STATE_BLEND_SRC_ALPHA, BGFX_STATE_BLEND_INV_SRC_ALPHA) | BGFX_STATE_PT_TRISTRIP;
 
@@ -39,6 +34,9 @@ constexpr StringCrc RibbonParticleProgramCrc = StringCrc{ RibbonParticleProgram
 
 constexpr StringCrc ParticleEmitterShapeProgramCrc = StringCrc{ ParticleEmitterShapeProgram };
 constexpr StringCrc WO_BillboardParticleProgramCrc = StringCrc{ WO_BillboardParticleProgram };
+
+// Size of the ribbon position uniform array.
+constexpr int MaxRibbonParticleCount = 300;
 }
 
 void ParticleRenderer::Init()
@@ -53,14 +51,14 @@ void ParticleRenderer::Init()
 	m_particleSpriteTextureHandle = GetRenderContext()->CreateTexture(particleTexture);
 	m_particleRibbonTextureHandle = GetRenderContext()->CreateTexture(ribbonTexture);
 
-	GetRenderContext()->CreateUniform("s_texColor", bgfx::UniformType::Sampler);
-	GetRenderContext()->CreateUniform("r_texColor", bgfx::UniformType::Sampler);
-	GetRenderContext()->CreateUniform(particlePos, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(particleScale, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(shapeRange, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(particleColor, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(ribbonCount, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(ribbonMaxPos, bgfx::UniformType::Vec4, 300);
+	m_spriteSampler.Init(GetRenderContext());
+	m_ribbonSampler.Init(GetRenderContext());
+	m_particlePos.Init(GetRenderContext());
+	m_particleScale.Init(GetRenderContext());
+	m_shapeRange.Init(GetRenderContext());
+	m_particleColor.Init(GetRenderContext());
+	m_ribbonCount.Init(GetRenderContext());
+	m_ribbonMaxPos.Init(GetRenderContext());
 
 	bgfx::setViewName(GetViewID(), "ParticleRenderer");
 }
@@ -82,14 +80,6 @@ void ParticleRenderer::Render(float deltaTime)
 		}
 	}
 
-	for (Entity entity : m_pCurrentSceneWorld->GetParticleForceFieldEntities())
-	{
-		ParticleForceFieldComponent* pForceFieldComponent = m_pCurrentSceneWorld->GetParticleForceFieldComponent(entity);
-		const cd::Transform& forcefieldTransform = m_pCurrentSceneWorld->GetTransformComponent(entity)->GetTransform();
-		SetForceFieldRotationForce(pForceFieldComponent);
-		SetForceFieldRange(pForceFieldComponent,  forcefieldTransform.GetScale());
-	}
-
 	Entity pMainCameraEntity = m_pCurrentSceneWorld->GetMainCameraEntity();
 	for (Entity entity : m_pCurrentSceneWorld->GetParticleEmitterEntities())
 	{
@@ -109,33 +99,9 @@ void ParticleRenderer::Render(float deltaTime)
 		const cd::Transform& pMainCameraTransform = m_pCurrentSceneWorld->GetTransformComponent(pMainCameraEntity)->GetTransform();
 		//const cd::Quaternion& cameraRotation = pMainCameraTransform.GetRotation();
 		//Not include particle attribute
-		pEmitterComponent->GetParticlePool().SetParticleMaxCount(pEmitterComponent->GetSpawnCount());
-		pEmitterComponent->GetParticlePool().AllParticlesReset();
-		int particleIndex = pEmitterComponent->GetParticlePool().AllocateParticleIndex();
-
-		//Random value
-		cd::Vec3f randomPos(getRandomValue(-pEmitterComponent->GetEmitterShapeRange().x(), pEmitterComponent->GetEmitterShapeRange().x()),
-									getRandomValue(-pEmitterComponent->GetEmitterShapeRange().y(), pEmitterComponent->GetEmitterShapeRange().y()),
-									getRandomValue(-pEmitterComponent->GetEmitterShapeRange().z(), pEmitterComponent->GetEmitterShapeRange().z()));	
-		cd::Vec3f randomVelocity(getRandomValue(-pEmitterComponent->GetRandomVelocity().x(), pEmitterComponent->GetRandomVelocity().x()),
-									getRandomValue(-pEmitterComponent->GetRandomVelocity().y(), pEmitterComponent->GetRandomVelocity().y()),
-									getRandomValue(-pEmitterComponent->GetRandomVelocity().z(), pEmitterComponent->GetRandomVelocity().z()));
-		pEmitterComponent->SetRandomPos(randomPos);
-
-		//particle
-		if (particleIndex != -1)
-		{
-			Particle& particle = pEmitterComponent->GetParticlePool().GetParticle(particleIndex);
-			SetRandomPosState(particle, particleTransform.GetTranslation(), randomPos, pEmitterComponent->GetRandomPosState());
-			SetRandomVelocityState(particle, pEmitterComponent->GetEmitterVelocity(), randomVelocity, pEmitterComponent->GetRandomVelocityState());
-			particle.SetRotationForceField(m_forcefieldRotationFoce);
-			particle.SetRotationForceFieldRange(m_forcefieldRange);
-			particle.SetAcceleration(pEmitterComponent->GetEmitterAcceleration());
-			particle.SetColor(pEmitterComponent->GetEmitterColor());
-			particle.SetLifeTime(pEmitterComponent->GetLifeTime());
-		}
-
-		pEmitterComponent->GetParticlePool().Update(1.0f/60.0f);
+		// Particles are simulated in SceneWorld::FixedUpdate. Positions are interpolated between the last two steps.
+		const ParticlePool& particlePool = pEmitterComponent->GetParticlePool();
+		const float interpolationAlpha = m_pCurrentSceneWorld->GetInterpolationAlpha();
 
 		if (pEmitterComponent->GetInstanceState())
 		{
@@ -143,7 +109,7 @@ void ParticleRenderer::Render(float deltaTime)
 			const uint16_t instanceStride = 80;
 			// to total number of instances to draw
 			uint32_t totalSprites;
-			totalSprites = pEmitterComponent->GetParticlePool().GetParticleMaxCount();
+			totalSprites = particlePool.GetParticleActiveCount();
 			uint32_t drawnSprites = bgfx::getAvailInstanceDataBuffer(totalSprites, instanceStride);
 
 			bgfx::InstanceDataBuffer idb;
@@ -153,9 +119,10 @@ void ParticleRenderer::Render(float deltaTime)
 			for (uint32_t ii = 0; ii < drawnSprites; ++ii)
 			{
 				float* mtx = (float*)data;
+				const cd::Vec3f particlePosition = particlePool.GetInterpolatedPosition(ii, interpolationAlpha);
 				bx::mtxSRT(mtx, particleTransform.GetScale().x(), particleTransform.GetScale().y(), particleTransform.GetScale().z(),
 					particleRotation.Pitch(), particleRotation.Yaw(), particleRotation.Roll(),
-					pEmitterComponent->GetParticlePool().GetParticle(ii).GetPos().x(), pEmitterComponent->GetParticlePool().GetParticle(ii).GetPos().y(), pEmitterComponent->GetParticlePool().GetParticle(ii).GetPos().z());
+					particlePosition.x(), particlePosition.y(), particlePosition.z());
 				
 				float* color = (float*)&data[64];
 				color[0] = pEmitterComponent->GetEmitterColor().x();
@@ -167,22 +134,18 @@ void ParticleRenderer::Render(float deltaTime)
 			}
 
 			//Billboard particlePos particleScale
-			constexpr StringCrc particlePosCrc(particlePos);
-			bgfx::setUniform(GetRenderContext()->GetUniform(particlePosCrc), &particleTransform.GetTranslation(), 1);
-			constexpr StringCrc ParticleScaleCrc(particleScale);
-			bgfx::setUniform(GetRenderContext()->GetUniform(ParticleScaleCrc), &particleTransform.GetScale(), 1);
+			m_particlePos.Set(&particleTransform.GetTranslation());
+			m_particleScale.Set(&particleTransform.GetScale());
 
 			if (pEmitterComponent->GetEmitterParticleType() == engine::ParticleType::Sprite)
 			{
-				constexpr StringCrc ParticleSampler("s_texColor");
-				bgfx::setTexture(0, GetRenderContext()->GetUniform(ParticleSampler), m_particleSpriteTextureHandle);
+				m_spriteSampler.Bind(0, m_particleSpriteTextureHandle);
 				bgfx::setVertexBuffer(0, bgfx::VertexBufferHandle{ pEmitterComponent->GetSpriteParticleVertexBufferHandle() });
 				bgfx::setIndexBuffer(bgfx::IndexBufferHandle{  pEmitterComponent->GetSpriteParticleIndexBufferHandle() });
 			}
 			else if (pEmitterComponent->GetEmitterParticleType() == engine::ParticleType::Ribbon)
 			{
-				constexpr StringCrc ribbonParticleSampler("r_texColor");
-				bgfx::setTexture(1, GetRenderContext()->GetUniform(ribbonParticleSampler), m_particleRibbonTextureHandle);
+				m_ribbonSampler.Bind(1, m_particleRibbonTextureHandle);
 				bgfx::setVertexBuffer(0, bgfx::DynamicVertexBufferHandle{ pRibbonEmitterComponet->GetRibbonParticlePrePosVertexBufferHandle() });
 				bgfx::setVertexBuffer(1, bgfx::VertexBufferHandle{ pRibbonEmitterComponet->GetRibbonParticleRemainVertexBufferHandle() });
 				bgfx::setIndexBuffer(bgfx::IndexBufferHandle{  pRibbonEmitterComponet->GetRibbonParticleIndexBufferHandle() });
@@ -195,37 +158,43 @@ void ParticleRenderer::Render(float deltaTime)
 		}
 		else
 		{
-			constexpr StringCrc particleColorCrc(particleColor);
-			bgfx::setUniform(GetRenderContext()->GetUniform(particleColorCrc), &pEmitterComponent->GetEmitterColor(), 1);
+			m_particleColor.Set(&pEmitterComponent->GetEmitterColor());
+
+			// Ribbons connect particles in spawn order, oldest first.
+			cd::Vec4f ribbonPosList[MaxRibbonParticleCount]{};
+			if (pEmitterComponent->GetEmitterParticleType() == engine::ParticleType::Ribbon)
+			{
+				particlePool.GetSpawnOrderPositions(ribbonPosList, MaxRibbonParticleCount, interpolationAlpha);
+			}
 
-			uint32_t drawnSprites = pEmitterComponent->GetParticlePool().GetParticleMaxCount();
+			uint32_t drawnSprites = particlePool.GetParticleActiveCount();
 			for (uint32_t ii = 0; ii < drawnSprites; ++ii)
 			{
 				float mtx[16];
+				const cd::Vec3f particlePosition = particlePool.GetInterpolatedPosition(ii, interpolationAlpha);
 				if (pEmitterComponent->GetRenderMode() == engine::ParticleRenderMode::Mesh)
 				{
 					bx::mtxSRT(mtx, particleTransform.GetScale().x(), particleTransform.GetScale().y(), particleTransform.GetScale().z(),
 						particleRotation.Pitch(), particleRotation.Yaw(), particleRotation.Roll(),
-						pEmitterComponent->GetParticlePool().GetParticle(ii).GetPos().x(), pEmitterComponent->GetParticlePool().GetParticle(ii).GetPos().y(), pEmitterComponent->GetParticlePool().GetParticle(ii).GetPos().z());
+						particlePosition.x(), particlePosition.y(), particlePosition.z());
 				}
 				else if (pEmitterComponent->GetRenderMode() == engine::ParticleRenderMode::Billboard)
 				{
 					auto up = particleTransform.GetRotation().ToMatrix3x3() * cd::Vec3f(0, 1, 0);
-					auto vec =  pMainCameraTransform.GetTranslation() - pEmitterComponent->GetParticlePool().GetParticle(ii).GetPos();
+					auto vec =  pMainCameraTransform.GetTranslation() - particlePosition;
 					auto right = up.Cross(vec);
 					float yaw = atan2f(right.z(), right.x());
 					float pitch = atan2f(vec.y(), sqrtf(vec.x() * vec.x() + vec.z() * vec.z())); 
 					float roll = atan2f(right.x(), -right.y()); 
 					bx::mtxSRT(mtx, particleTransform.GetScale().x(), particleTransform.GetScale().y(), particleTransform.GetScale().z(),
 						pitch, yaw, roll,
-						pEmitterComponent->GetParticlePool().GetParticle(ii).GetPos().x(), pEmitterComponent->GetParticlePool().GetParticle(ii).GetPos().y(), pEmitterComponent->GetParticlePool().GetParticle(ii).GetPos().z());
+						particlePosition.x(), particlePosition.y(), particlePosition.z());
 				}
 				bgfx::setTransform(mtx);
 				bgfx::setState(state_tristrip);
 				if (pEmitterComponent->GetEmitterParticleType() == engine::ParticleType::Sprite)
 				{
-					constexpr StringCrc spriteParticleSampler("s_texColor");
-					bgfx::setTexture(0, GetRenderContext()->GetUniform(spriteParticleSampler), m_particleSpriteTextureHandle);
+					m_spriteSampler.Bind(0, m_particleSpriteTextureHandle);
 					bgfx::setVertexBuffer(0, bgfx::VertexBufferHandle{ pEmitterComponent->GetSpriteParticleVertexBufferHandle() });
 					bgfx::setIndexBuffer(bgfx::IndexBufferHandle{  pEmitterComponent->GetSpriteParticleIndexBufferHandle() });
 				}
@@ -234,35 +203,17 @@ void ParticleRenderer::Render(float deltaTime)
 					bgfx::setBuffer(PT_RIBBON_VERTEX_STAGE, bgfx::DynamicVertexBufferHandle{ pRibbonEmitterComponet->GetRibbonParticlePrePosVertexBufferHandle() }, bgfx::Access::ReadWrite);
 
 					//ribbonCount Uinform
-					constexpr StringCrc ribbontCounts(ribbonCount);
-					cd::Vec4f allRibbonCount{ static_cast<float>(pEmitterComponent->GetParticlePool().GetParticleMaxCount()* Particle::GetMeshVertexCount<ParticleType::Ribbon>()),
-						pEmitterComponent->GetParticlePool().GetParticleMaxCount(),
+					cd::Vec4f allRibbonCount{ static_cast<float>(particlePool.GetParticleMaxCount()* Particle::GetMeshVertexCount<ParticleType::Ribbon>()),
+						particlePool.GetParticleMaxCount(),
 						0,
 						0};
-					GetRenderContext()->FillUniform(ribbontCounts, &allRibbonCount, 1);
+					m_ribbonCount.Set(&allRibbonCount);
 
 					//ribbonListUniform
-					cd::Vec4f ribbonPosList[300]{};
-					for (int i = 0; i < 300; i++)
-					{
-						if (i >= pEmitterComponent->GetParticlePool().GetParticleMaxCount())
-						{
-							ribbonPosList[i] = cd::Vec4f(0.0f,0.0f,0.0f,0.0f);
-						}
-						else
-						{
-						ribbonPosList[i] =cd::Vec4f(pEmitterComponent->GetParticlePool().GetParticle(i).GetPos().x(),
-							pEmitterComponent->GetParticlePool().GetParticle(i).GetPos().y(),
-							pEmitterComponent->GetParticlePool().GetParticle(i).GetPos().z()
-							, 0.0f);
-						}
-					}
-					constexpr StringCrc maxPosList(ribbonMaxPos);
-					GetRenderContext()->FillUniform(maxPosList, &ribbonPosList, 300);
+					m_ribbonMaxPos.Set(&ribbonPosList);
 					GetRenderContext()->Dispatch(GetViewID(), RibbonParticleProgramCsCrc, 1U, 1U, 1U);
 					//pEmitterComponent->UpdateRibbonPosBuffer();
-					constexpr StringCrc ribbonParticleSampler("r_texColor");
-					bgfx::setTexture(1, GetRenderContext()->GetUniform(ribbonParticleSampler), m_particleRibbonTextureHandle);
+					m_ribbonSampler.Bind(1, m_particleRibbonTextureHandle);
 					bgfx::setVertexBuffer(0, bgfx::DynamicVertexBufferHandle{ pRibbonEmitterComponet->GetRibbonParticlePrePosVertexBufferHandle() });
 					bgfx::setVertexBuffer(1, bgfx::VertexBufferHandle{ pRibbonEmitterComponet->GetRibbonParticleRemainVertexBufferHandle() });
 					bgfx::setIndexBuffer(bgfx::IndexBufferHandle{  pRibbonEmitterComponet->GetRibbonParticleIndexBufferHandle() });
@@ -271,8 +222,7 @@ void ParticleRenderer::Render(float deltaTime)
 			}
 		}
 
-		constexpr StringCrc emitShapeRangeCrc(shapeRange);
-		bgfx::setUniform(GetRenderContext()->GetUniform(emitShapeRangeCrc), &pEmitterComponent->GetEmitterShapeRange(), 1);
+		m_shapeRange.Set(&pEmitterComponent->GetEmitterShapeRange());
 		bgfx::setTransform(m_pCurrentSceneWorld->GetTransformComponent(entity)->GetWorldMatrix().begin());
 		bgfx::setVertexBuffer(0, bgfx::VertexBufferHandle{ pEmitterComponent->GetEmitterShapeVertexBufferHandle() });
 		bgfx::setIndexBuffer(bgfx::IndexBufferHandle{ pEmitterComponent->GetEmitterShapeIndexBufferHandle() });
@@ -309,27 +259,4 @@ void ParticleRenderer::SetRenderMode(engine::ParticleRenderMode& rendermode, eng
 	}
 }
 
-void ParticleRenderer::SetRandomPosState(engine::Particle& particle, cd::Vec3f value, cd::Vec3f randomvalue, bool state)
-{
-	if (state)
-	{
-		particle.SetPos(value + randomvalue);
-	}
-	else
-	{
-		particle.SetPos(value);
-	}
-}
-void ParticleRenderer::SetRandomVelocityState(engine::Particle& particle, cd::Vec3f value, cd::Vec3f randomvalue, bool state)
-{
-	if (state)
-	{
-		particle.SetSpeed(value + randomvalue);
-	}
-	else
-	{
-		particle.SetSpeed(value);
-	}
-}
-
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "ECWorld/ParticleForceFieldComponent.h"
 #include "ECWorld/TransformComponent.h"
 #include "RenderContext.h"
+#include "Rendering/UniformSlot.h"
 #include "Rendering/Utility/VertexLayoutUtility.h"
 
 namespace engine
@@ -23,21 +24,22 @@ public:
 	virtual void Render(float deltaTime) override;
 
 	void SetSceneWorld(SceneWorld* pSceneWorld) { m_pCurrentSceneWorld = pSceneWorld; }
-	float getRandomValue(float min, float max) { return min + static_cast<float>(rand()) / (RAND_MAX / (max - min)); }
-	void SetForceFieldRotationForce(ParticleForceFieldComponent* forcefield) { m_forcefieldRotationFoce = forcefield->GetRotationForce(); }
-	void SetForceFieldRange(ParticleForceFieldComponent* forcefield ,cd::Vec3f scale) { m_forcefieldRange = forcefield->GetForceFieldRange()*scale; }
 
 	void SetRenderMode(engine::ParticleRenderMode& rendermode, engine::ParticleType type, engine::MaterialComponent* materialcomponent);
-	void SetRandomPosState(engine::Particle& particle, cd::Vec3f value, cd::Vec3f randomvalue, bool state);
-	void SetRandomVelocityState(engine::Particle& particle, cd::Vec3f value, cd::Vec3f randomvalue, bool state);
 private:
 	SceneWorld* m_pCurrentSceneWorld = nullptr;
 	bgfx::TextureHandle m_particleSpriteTextureHandle;
 	bgfx::TextureHandle m_particleRibbonTextureHandle;
 	ParticleType m_currentType = ParticleType::Sprite;
 
-	bool m_forcefieldRotationFoce = false;
-	cd::Vec3f m_forcefieldRange;
+	SamplerUniform<"s_texColor"> m_spriteSampler;
+	SamplerUniform<"r_texColor"> m_ribbonSampler;
+	Vec4Uniform<"u_particlePos"> m_particlePos;
+	Vec4Uniform<"u_particleScale"> m_particleScale;
+	Vec4Uniform<"u_shapeRange"> m_shapeRange;
+	Vec4Uniform<"u_particleColor"> m_particleColor;
+	Vec4Uniform<"u_ribbonCount"> m_ribbonCount;
+	Vec4Uniform<"u_ribbonMaxPos", 300> m_ribbonMaxPos;
 };
 
 }
\ No newline at end of file
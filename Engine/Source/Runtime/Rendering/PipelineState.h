@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+namespace engine
+{
+
+class TextureResource;
+
+struct PipelineTexture
+{
+	uint8_t slot;
+	uint16_t samplerUniformHandle;
+	uint16_t textureHandle;
+	uint32_t samplerFlags;
+	// Handle and sampler flags are stale when the generation of the resource changed.
+	const TextureResource* pTextureResource;
+	uint32_t textureHandleGeneration;
+};
+
+struct PipelineUniform
+{
+	uint16_t uniformHandle;
+	float value[4];
+};
+
+// PipelineState is a flat record about how to submit a draw call with one material :
+// program, render states, textures and material uniform values.
+// It is resolved when material or shader changes so that draw loop doesn't need to look up any maps.
+struct PipelineState
+{
+	static constexpr uint8_t MaxTextureCount = 8;
+	static constexpr uint8_t MaxUniformCount = 8;
+
+	uint16_t programHandle = UINT16_MAX;
+	uint64_t state = 0;
+	uint8_t textureCount = 0;
+	uint8_t uniformCount = 0;
+	// Resolve again later if some textures are still loading.
+	bool isComplete = false;
+	PipelineTexture textures[MaxTextureCount];
+	PipelineUniform uniforms[MaxUniformCount];
+
+	void Reset()
+	{
+		programHandle = UINT16_MAX;
+		state = 0;
+		textureCount = 0;
+		uniformCount = 0;
+		isComplete = false;
+	}
+
+	void AddTexture(uint8_t slot, uint16_t samplerUniformHandle, uint16_t textureHandle, uint32_t samplerFlags,
+		const TextureResource* pTextureResource, uint32_t textureHandleGeneration)
+	{
+		assert(textureCount < MaxTextureCount);
+		textures[textureCount++] = PipelineTexture{ slot, samplerUniformHandle, textureHandle, samplerFlags, pTextureResource, textureHandleGeneration };
+	}
+
+	void AddUniform(uint16_t uniformHandle, const float* pValue, uint8_t valueCount = 4)
+	{
+		assert(uniformCount < MaxUniformCount && valueCount <= 4);
+		PipelineUniform& uniform = uniforms[uniformCount++];
+		uniform.uniformHandle = uniformHandle;
+		std::memset(uniform.value, 0, sizeof(uniform.value));
+		std::memcpy(uniform.value, pValue, valueCount * sizeof(float));
+	}
+};
+
+}
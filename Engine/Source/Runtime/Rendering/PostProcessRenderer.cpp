@@ -59,6 +59,7 @@ void PostProcessRenderer::Render(float deltaTime)
 	postProcessingParams[1] = static_cast<float>(pCameraComponent->GetToneMappingMode());
 	postProcessingParams[2] = pCameraComponent->GetGammaCorrection();
 	bgfx::setUniform(GetRenderContext()->GetUniform(paramUniformName), &postProcessingParams);
+	RenderCommandCounter::AddUniformUpdate();
 
 	constexpr StringCrc lightingResultSampler("s_lightingColor");
 	bgfx::setTexture(0, GetRenderContext()->GetUniform(lightingResultSampler), screenTextureHandle);
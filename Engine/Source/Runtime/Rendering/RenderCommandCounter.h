@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace engine
+{
+
+// Commands which the engine submitted to bgfx in one frame.
+struct RenderCommandCounts
+{
+	uint32_t drawCallCount = 0U;
+	uint32_t dispatchCount = 0U;
+	uint32_t uniformUpdateCount = 0U;
+};
+
+// Counts bgfx commands on the engine side. bgfx::Stats only contains draw counts which the backend fills
+// and the Noop backend used by headless runs leaves them empty. Counters are atomic so that renderers
+// recording into encoders on job threads can use them too.
+class RenderCommandCounter final
+{
+public:
+	RenderCommandCounter() = delete;
+
+	static void AddDrawCall() { s_drawCallCount.fetch_add(1U, std::memory_order_relaxed); }
+	static void AddDispatch() { s_dispatchCount.fetch_add(1U, std::memory_order_relaxed); }
+	static void AddUniformUpdate() { s_uniformUpdateCount.fetch_add(1U, std::memory_order_relaxed); }
+
+	// Returns counts since the last call. RenderContext::EndFrame calls it once per frame.
+	static RenderCommandCounts Reset()
+	{
+		RenderCommandCounts counts;
+		counts.drawCallCount = s_drawCallCount.exchange(0U, std::memory_order_relaxed);
+		counts.dispatchCount = s_dispatchCount.exchange(0U, std::memory_order_relaxed);
+		counts.uniformUpdateCount = s_uniformUpdateCount.exchange(0U, std::memory_order_relaxed);
+		return counts;
+	}
+
+private:
+	static inline std::atomic<uint32_t> s_drawCallCount = 0U;
+	static inline std::atomic<uint32_t> s_dispatchCount = 0U;
+	static inline std::atomic<uint32_t> s_uniformUpdateCount = 0U;
+};
+
+}
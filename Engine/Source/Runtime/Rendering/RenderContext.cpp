@@ -1,8 +1,10 @@
 #include "RenderContext.h"
 
 #include "Base/Template.h"
+#include "Core/Memory/FrameArena.h"
 #include "Log/Log.h"
 #include "Path/Path.h"
+#include "Profiling/FrameProfiler.h"
 #include "Renderer.h"
 #include "Rendering/Resources/ResourceContext.h"
 #include "Rendering/Resources/ShaderResource.h"
@@ -15,7 +17,9 @@
 #include <bimg/decode.h>
 #include <bx/allocator.h>
 
+#include <algorithm>
 #include <cassert>
+#include <format>
 #include <fstream>
 #include <memory>
 
@@ -28,6 +32,9 @@ static bx::AllocatorI* GetResourceAllocator()
 	return &s_allocator;
 }
 
+// Sampler names of material textures should align to shader codes. See Material.sh and U_BaseSlot.sh.
+constexpr const char* MaterialSamplerNames[] = { "s_texBaseColor", "s_texNormal", "s_texORM", "s_texEmissive" };
+
 static void imageReleaseCb(void* _ptr, void* _userData)
 {
 	BX_UNUSED(_ptr);
@@ -89,6 +96,7 @@ void RenderContext::Init(GraphicsBackend backend, void* hwnd)
 	}
 
 	initDesc.platformData.nwh = hwnd;
+	initDesc.resolution.reset = m_resetFlags;
 	bgfx::init(initDesc);
 }
 
@@ -103,16 +111,35 @@ void RenderContext::Shutdown()
 	{
 		bgfx::destroy(bgfx::UniformHandle{ it.second });
 	}
+	m_samplerStateCaches.clear();
 }
 
 void RenderContext::BeginFrame()
 {
+	// Transient data of the last frame is consumed by bgfx::frame in EndFrame.
+	FrameArena::BeginFrame();
+
+#ifdef ENABLE_PROFILING
+	// bgfx only measures views with timer queries when its profiler is on.
+	SetDebugFlag(BGFX_DEBUG_PROFILER, FrameProfiler::IsEnabled());
+#endif
+}
+
+void RenderContext::SetDebugFlag(uint32_t flag, bool enable)
+{
+	const uint32_t debugFlags = enable ? m_debugFlags | flag : m_debugFlags & ~flag;
+	if (debugFlags != m_debugFlags)
+	{
+		m_debugFlags = debugFlags;
+		bgfx::setDebug(m_debugFlags);
+	}
 }
 
 void RenderContext::Submit(uint16_t viewID, uint16_t programHandle)
 {
 	assert(bgfx::isValid(bgfx::ProgramHandle{ programHandle }));
 	bgfx::submit(viewID, bgfx::ProgramHandle{ programHandle });
+	RenderCommandCounter::AddDrawCall();
 }
 
 void RenderContext::Submit(uint16_t viewID, StringCrc programHandleIndex)
@@ -124,6 +151,7 @@ void RenderContext::Dispatch(uint16_t viewID, uint16_t programHandle, uint32_t n
 {
 	assert(bgfx::isValid(bgfx::ProgramHandle{ programHandle }));
 	bgfx::dispatch(viewID, bgfx::ProgramHandle{ programHandle }, numX, numY, numZ);
+	RenderCommandCounter::AddDispatch();
 }
 void RenderContext::Dispatch(uint16_t viewID, StringCrc programHandleIndex, uint32_t numX, uint32_t numY, uint32_t numZ)
 {
@@ -135,19 +163,62 @@ void RenderContext::EndFrame()
 	// Advance to next frame. Rendering thread will be kicked to
 	// process submitted rendering primitives.
 	bgfx::frame();
+	m_lastFrameCommandCounts = RenderCommandCounter::Reset();
+
+#ifdef ENABLE_PROFILING
+	if (m_isGpuProfilerEnabled)
+	{
+		const bgfx::Stats* pStats = bgfx::getStats();
+		const double toCpuMs = 1000.0 / static_cast<double>(pStats->cpuTimerFreq);
+		const double toGpuMs = 1000.0 / static_cast<double>(pStats->gpuTimerFreq);
+		FrameProfiler& profiler = FrameProfiler::Get();
+		for (uint16_t viewIndex = 0U; viewIndex < pStats->numViews; ++viewIndex)
+		{
+			const bgfx::ViewStats& viewStats = pStats->viewStats[viewIndex];
+			profiler.AddGpuView(viewStats.name, viewStats.view,
+				static_cast<double>(viewStats.cpuTimeEnd - viewStats.cpuTimeBegin) * toCpuMs,
+				static_cast<double>(viewStats.gpuTimeBegin - pStats->gpuTimeBegin) * toGpuMs,
+				static_cast<double>(viewStats.gpuTimeEnd - viewStats.gpuTimeBegin) * toGpuMs);
+		}
+	}
+#endif
 }
 
 void RenderContext::OnResize(uint16_t width, uint16_t height)
 {
-	bgfx::reset(width, height, BGFX_RESET_VSYNC);
+	bgfx::reset(width, height, m_resetFlags);
 	m_backBufferWidth = width;
 	m_backBufferHeight = height;
 }
 
 uint16_t RenderContext::CreateView()
 {
-	assert(m_currentViewCount < MaxViewCount && "Overflow the max count of views.");
-	return m_currentViewCount++;
+	return CreateViews(1);
+}
+
+uint16_t RenderContext::CreateViews(uint16_t count)
+{
+	assert(count > 0 && m_currentViewCount + count <= MaxViewCount && "Overflow the max count of views.");
+	uint16_t firstViewID = m_currentViewCount;
+	m_currentViewCount += static_cast<uint8_t>(count);
+	for (uint16_t viewID = firstViewID; viewID < m_currentViewCount; ++viewID)
+	{
+		m_viewOrder.push_back(viewID);
+	}
+	return firstViewID;
+}
+
+uint16_t RenderContext::CreateViewsAfter(uint16_t previousViewID, uint16_t count)
+{
+	uint16_t firstViewID = CreateViews(count);
+
+	auto itPreviousView = std::find(m_viewOrder.begin(), m_viewOrder.end(), previousViewID);
+	assert(itPreviousView != m_viewOrder.end());
+	std::rotate(itPreviousView + 1, m_viewOrder.end() - count, m_viewOrder.end());
+
+	// bgfx sorts views by their positions in the order table.
+	bgfx::setViewOrder(0, static_cast<uint16_t>(m_viewOrder.size()), m_viewOrder.data());
+	return firstViewID;
 }
 
 ShaderResource* RenderContext::RegisterShaderProgram(const std::string& programName, const std::string& vsName, const std::string& fsName, const std::string& combine)
@@ -439,6 +510,33 @@ bgfx::UniformHandle RenderContext::CreateUniform(const char* pName, bgfx::Unifor
 	return uniformHandle;
 }
 
+const SamplerState& RenderContext::GetSamplerState(uint8_t slot, uint32_t samplerFlags)
+{
+	assert(slot < MaxTextureSlotCount);
+	uint64_t samplerKey = (static_cast<uint64_t>(slot) << 32) | samplerFlags;
+	auto itSamplerState = m_samplerStateCaches.find(samplerKey);
+	if (itSamplerState != m_samplerStateCaches.end())
+	{
+		return itSamplerState->second;
+	}
+
+	// Different sampler states in the same slot still share one uniform.
+	std::string samplerName = slot < sizeof(MaterialSamplerNames) / sizeof(char*) ? MaterialSamplerNames[slot] : std::format("s_textureSampler{}", slot);
+
+	SamplerState& samplerState = m_samplerStateCaches[samplerKey];
+	samplerState.uniformHandle = CreateUniform(samplerName.c_str(), bgfx::UniformType::Sampler);
+	samplerState.flags = samplerFlags;
+	assert(bgfx::isValid(samplerState.uniformHandle));
+
+	return samplerState;
+}
+
+void RenderContext::BindTexture(uint8_t slot, uint16_t textureHandle, uint32_t samplerFlags)
+{
+	const SamplerState& samplerState = GetSamplerState(slot, samplerFlags);
+	bgfx::setTexture(slot, samplerState.uniformHandle, bgfx::TextureHandle{ textureHandle }, samplerState.flags);
+}
+
 bgfx::VertexLayout RenderContext::CreateVertexLayout(StringCrc resourceCrc, const std::vector<cd::VertexAttributeLayout>& vertexAttributes)
 {
 	auto itVertexLayoutCache = m_vertexLayoutCaches.find(resourceCrc);
@@ -485,6 +583,7 @@ void RenderContext::SetUniform(StringCrc resourceCrc, bgfx::UniformHandle unifor
 void RenderContext::FillUniform(StringCrc resourceCrc, const void *pData, uint16_t vec4Count) const
 {
 	bgfx::setUniform(GetUniform(resourceCrc), pData, vec4Count);
+	RenderCommandCounter::AddUniformUpdate();
 }
 
 RenderTarget* RenderContext::GetRenderTarget(StringCrc resourceCrc) const
@@ -3,6 +3,7 @@
 #include "Core/StringCrc.h"
 #include "Graphics/GraphicsBackend.h"
 #include "Math/Matrix.hpp"
+#include "Rendering/RenderCommandCounter.h"
 #include "Rendering/ShaderType.h"
 #include "RenderTarget.h"
 #include "Scene/VertexAttribute.h"
@@ -16,6 +17,7 @@
 #include <set>
 #include <tuple>
 #include <unordered_map>
+#include <vector>
 
 namespace engine
 {
@@ -27,6 +29,15 @@ class ShaderResource;
 
 static constexpr uint8_t MaxViewCount = 255;
 static constexpr uint8_t MaxRenderTargetCount = 255;
+static constexpr uint8_t MaxTextureSlotCount = 16;
+
+// Sampler uniforms are shared by all textures bound to the same slot.
+// Filtering and address modes are passed to bgfx::setTexture as flags so they don't need new uniforms either.
+struct SamplerState
+{
+	bgfx::UniformHandle uniformHandle = BGFX_INVALID_HANDLE;
+	uint32_t flags = UINT32_MAX;
+};
 
 // In current design, RenderContext needs to be a singleton.
 // The reason is that it binds to bgfx graphics initialization which should only happen once.
@@ -45,6 +56,12 @@ public:
 
 	void Init(GraphicsBackend backend, void* hwnd = nullptr);
 	void OnResize(uint16_t width, uint16_t height);
+	// Call before Init. Without vsync the main loop paces frames itself.
+	void SetVSync(bool enable) { m_resetFlags = enable ? BGFX_RESET_VSYNC : BGFX_RESET_NONE; }
+	bool IsVSyncEnabled() const { return 0U != (m_resetFlags & BGFX_RESET_VSYNC); }
+	// bgfx can't query debug flags. Toggle them here so that other flags are kept.
+	void SetDebugFlag(uint32_t flag, bool enable);
+	uint32_t GetDebugFlags() const { return m_debugFlags; }
 	void BeginFrame();
 	void Submit(uint16_t viewID, uint16_t programHandle);
 	void Submit(uint16_t viewID, StringCrc programHandleIndex);
@@ -53,6 +70,9 @@ public:
 	void EndFrame();
 	void Shutdown();
 
+	// Draw calls, dispatches and uniform updates of the last finished frame.
+	const RenderCommandCounts& GetLastFrameCommandCounts() const { return m_lastFrameCommandCounts; }
+
 	void SetResourceContext(ResourceContext* pContext) { m_pResourceContext = pContext; }
 	ResourceContext* GetResourceContext() const { return m_pResourceContext; }
 
@@ -61,7 +81,11 @@ public:
 	void SetBackBufferSize(uint16_t width, uint16_t height) { m_backBufferWidth = width; m_backBufferHeight = height; }
 
 	uint16_t CreateView();
-	void ResetViewCount() { m_currentViewCount = 0; }
+	// Consecutive views. Returns the first one.
+	uint16_t CreateViews(uint16_t count);
+	// Consecutive views which are submitted right after previousViewID though their ids are larger than views created before.
+	uint16_t CreateViewsAfter(uint16_t previousViewID, uint16_t count);
+	void ResetViewCount() { m_currentViewCount = 0; m_viewOrder.clear(); bgfx::setViewOrder(); }
 	uint16_t GetCurrentViewCount() const { return m_currentViewCount; }
 
 	// For Standard ShaderProgramType
@@ -104,6 +128,11 @@ public:
 	
 	bgfx::UniformHandle CreateUniform(const char* pName, bgfx::UniformType::Enum uniformType, uint16_t number = 1);
 
+	// UINT32_MAX means to use sampler flags which the texture is created with.
+	const SamplerState& GetSamplerState(uint8_t slot, uint32_t samplerFlags = UINT32_MAX);
+	void BindTexture(uint8_t slot, uint16_t textureHandle, uint32_t samplerFlags = UINT32_MAX);
+	size_t GetSamplerStateCount() const { return m_samplerStateCaches.size(); }
+
 	bgfx::VertexLayout CreateVertexLayout(StringCrc resourceCrc, const std::vector<cd::VertexAttributeLayout>& vertexAttributes);
 	bgfx::VertexLayout CreateVertexLayout(StringCrc resourceCrc, const cd::VertexAttributeLayout& vertexAttribute);
 	void SetVertexLayout(StringCrc resourceCrc, bgfx::VertexLayout textureHandle);
@@ -124,6 +153,11 @@ private:
 	ResourceContext* m_pResourceContext = nullptr;
 
 	uint8_t m_currentViewCount = 0;
+	// View ids in submission order. It only differs from id order after CreateViewsAfter.
+	std::vector<bgfx::ViewId> m_viewOrder;
+	uint32_t m_debugFlags = BGFX_DEBUG_NONE;
+	uint32_t m_resetFlags = BGFX_RESET_VSYNC;
+	RenderCommandCounts m_lastFrameCommandCounts;
 	uint16_t m_backBufferWidth;
 	uint16_t m_backBufferHeight;
 
@@ -131,6 +165,8 @@ private:
 	std::unordered_map<StringCrc, bgfx::VertexLayout> m_vertexLayoutCaches;
 	std::unordered_map<StringCrc, uint16_t> m_textureHandleCaches;
 	std::unordered_map<StringCrc, uint16_t> m_uniformHandleCaches;
+	// Key : slot << 32 | sampler flags
+	std::unordered_map<uint64_t, SamplerState> m_samplerStateCaches;
 
 	// Key : StringCrc(shader name), Value : ShaderResource*
 	std::multimap<StringCrc, ShaderResource*> m_shaderResources;
@@ -0,0 +1,431 @@
+#include "RenderGraph.h"
+
+#include "Base/Template.h"
+
+#include <bimg/bimg.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace engine
+{
+
+RenderGraphResource RenderGraphBuilder::CreateTexture(const char* pName, const RenderGraphTextureDesc& desc)
+{
+	return m_graph.AddResource(pName, desc);
+}
+
+RenderGraphResource RenderGraphBuilder::Read(RenderGraphResource resource)
+{
+	assert(resource < m_graph.m_resourceCount);
+	m_graph.m_passes[m_passIndex].reads.push_back(resource);
+	return resource;
+}
+
+RenderGraphResource RenderGraphBuilder::WriteAttachment(RenderGraphResource resource)
+{
+	assert(resource < m_graph.m_resourceCount);
+	RenderGraph::PassNode& pass = m_graph.m_passes[m_passIndex];
+	assert(pass.attachments.size() < RenderGraph::MaxAttachmentCount);
+	assert(!m_graph.m_resources[resource].isImported && "Imported textures are written by Write. Their frame buffers are owned outside.");
+	pass.attachments.push_back(resource);
+	pass.writes.push_back(resource);
+	return resource;
+}
+
+RenderGraphResource RenderGraphBuilder::Write(RenderGraphResource resource)
+{
+	assert(resource < m_graph.m_resourceCount);
+	m_graph.m_passes[m_passIndex].writes.push_back(resource);
+	return resource;
+}
+
+void RenderGraphBuilder::SetSideEffect()
+{
+	m_graph.m_passes[m_passIndex].hasSideEffect = true;
+}
+
+RenderGraph::~RenderGraph()
+{
+	Reset();
+}
+
+void RenderGraph::SetViewRange(uint16_t firstViewID, uint16_t viewCount)
+{
+	m_viewIDs.clear();
+	for (uint16_t viewIndex = 0U; viewIndex < viewCount; ++viewIndex)
+	{
+		m_viewIDs.push_back(firstViewID + viewIndex);
+	}
+	m_viewNames.assign(viewCount, std::string());
+}
+
+uint16_t RenderGraph::AddResource(const char* pName, const RenderGraphTextureDesc& desc)
+{
+	if (m_resourceCount == m_resources.size())
+	{
+		m_resources.emplace_back();
+	}
+
+	ResourceNode& resource = m_resources[m_resourceCount];
+	resource.name = pName;
+	resource.desc = desc;
+	resource.importedHandle = BGFX_INVALID_HANDLE;
+	resource.isImported = false;
+	resource.firstPassIndex = UINT16_MAX;
+	resource.lastPassIndex = 0U;
+	resource.physicalIndex = UINT16_MAX;
+
+	assert(m_resourceCount < InvalidRenderGraphResource);
+	return static_cast<uint16_t>(m_resourceCount++);
+}
+
+RenderGraphResource RenderGraph::ImportTexture(const char* pName, bgfx::TextureHandle textureHandle, const RenderGraphTextureDesc& desc)
+{
+	uint16_t resourceIndex = AddResource(pName, desc);
+	ResourceNode& resource = m_resources[resourceIndex];
+	resource.importedHandle = textureHandle;
+	resource.isImported = true;
+	return resourceIndex;
+}
+
+uint16_t RenderGraph::BeginPass(const char* pName, ExecuteFunction execute)
+{
+	assert(!m_isCompiled && "Passes can't be added between Compile and Execute.");
+	if (m_passCount == m_passes.size())
+	{
+		m_passes.emplace_back();
+	}
+
+	uint16_t passIndex = static_cast<uint16_t>(m_passCount++);
+	PassNode& pass = m_passes[passIndex];
+	pass.name = pName;
+	pass.execute = cd::MoveTemp(execute);
+	pass.reads.clear();
+	pass.writes.clear();
+	pass.attachments.clear();
+	pass.hasSideEffect = false;
+	pass.isCulled = false;
+	pass.viewID = UINT16_MAX;
+	pass.viewIndex = UINT16_MAX;
+	return passIndex;
+}
+
+void RenderGraph::Compile()
+{
+	assert(!m_isCompiled);
+	++m_frameIndex;
+
+	CullPasses();
+
+	const uint32_t alivePassCount = m_passCount - m_culledPassCount;
+	if (alivePassCount > m_viewIDs.size() && !OnReserveViews.Empty())
+	{
+		const uint16_t newViewCount = static_cast<uint16_t>(alivePassCount - m_viewIDs.size());
+		const uint16_t firstNewViewID = OnReserveViews.Invoke(newViewCount);
+		for (uint16_t viewIndex = 0U; viewIndex < newViewCount; ++viewIndex)
+		{
+			m_viewIDs.push_back(firstNewViewID + viewIndex);
+		}
+		m_viewNames.resize(m_viewIDs.size());
+	}
+
+	// Alive passes get views in declaration order.
+	uint16_t viewIndex = 0U;
+	for (uint32_t passIndex = 0U; passIndex < m_passCount; ++passIndex)
+	{
+		PassNode& pass = m_passes[passIndex];
+		if (!pass.isCulled)
+		{
+			assert(viewIndex < m_viewIDs.size() && "Too many render graph passes for the reserved views.");
+			pass.viewID = m_viewIDs[viewIndex];
+			pass.viewIndex = viewIndex;
+			++viewIndex;
+		}
+	}
+
+	ReleaseUnusedResources();
+	AllocatePhysicalTextures();
+
+	m_isCompiled = true;
+}
+
+void RenderGraph::Execute()
+{
+	assert(m_isCompiled);
+
+	for (uint32_t passIndex = 0U; passIndex < m_passCount; ++passIndex)
+	{
+		PassNode& pass = m_passes[passIndex];
+		if (pass.isCulled)
+		{
+			continue;
+		}
+
+		// bgfx copies view names. Only update them when another pass takes the view.
+		std::string& viewName = m_viewNames[pass.viewIndex];
+		if (viewName != pass.name)
+		{
+			viewName = pass.name;
+			bgfx::setViewName(pass.viewID, viewName.c_str());
+		}
+
+		if (pass.attachments.empty())
+		{
+			bgfx::setViewFrameBuffer(pass.viewID, BGFX_INVALID_HANDLE);
+		}
+		else
+		{
+			const RenderGraphTextureDesc& desc = GetTextureDesc(pass.attachments[0]);
+			bgfx::setViewFrameBuffer(pass.viewID, GetFrameBuffer(pass));
+			bgfx::setViewRect(pass.viewID, 0, 0, desc.width, desc.height);
+		}
+
+		if (pass.execute)
+		{
+			pass.execute(*this, pass.viewID);
+		}
+	}
+
+	// Statistics stay readable until the next Compile.
+	m_isCompiled = false;
+	m_resourceCount = 0U;
+	m_passCount = 0U;
+}
+
+void RenderGraph::Reset()
+{
+	for (const FrameBufferEntry& frameBuffer : m_frameBuffers)
+	{
+		bgfx::destroy(frameBuffer.handle);
+	}
+	m_frameBuffers.clear();
+
+	for (const PhysicalTexture& physicalTexture : m_physicalTextures)
+	{
+		bgfx::destroy(physicalTexture.handle);
+	}
+	m_physicalTextures.clear();
+}
+
+bgfx::TextureHandle RenderGraph::GetTexture(RenderGraphResource resource) const
+{
+	const ResourceNode& node = m_resources[resource];
+	if (node.isImported)
+	{
+		return node.importedHandle;
+	}
+
+	assert(node.physicalIndex < m_physicalTextures.size() && "Resource is not used by any alive pass.");
+	return m_physicalTextures[node.physicalIndex].handle;
+}
+
+const RenderGraphTextureDesc& RenderGraph::GetTextureDesc(RenderGraphResource resource) const
+{
+	return m_resources[resource].desc;
+}
+
+uint64_t RenderGraph::GetPhysicalTextureBytes() const
+{
+	uint64_t totalBytes = 0U;
+	for (const PhysicalTexture& physicalTexture : m_physicalTextures)
+	{
+		const RenderGraphTextureDesc& desc = physicalTexture.desc;
+		uint64_t bitsPerPixel = bimg::getBitsPerPixel(static_cast<bimg::TextureFormat::Enum>(desc.format));
+		totalBytes += static_cast<uint64_t>(desc.width) * desc.height * bitsPerPixel / 8U;
+	}
+
+	return totalBytes;
+}
+
+void RenderGraph::CullPasses()
+{
+	// Walk backwards from passes which have visible effects. A pass stays alive if any alive pass reads what it writes.
+	std::vector<bool> isResourceNeeded(m_resourceCount, false);
+	m_culledPassCount = 0U;
+	for (uint32_t passIndex = m_passCount; passIndex-- > 0U;)
+	{
+		PassNode& pass = m_passes[passIndex];
+		bool isAlive = pass.hasSideEffect;
+		for (RenderGraphResource resource : pass.writes)
+		{
+			isAlive = isAlive || m_resources[resource].isImported || isResourceNeeded[resource];
+		}
+
+		pass.isCulled = !isAlive;
+		if (pass.isCulled)
+		{
+			++m_culledPassCount;
+			continue;
+		}
+
+		for (RenderGraphResource resource : pass.reads)
+		{
+			isResourceNeeded[resource] = true;
+		}
+	}
+}
+
+void RenderGraph::ReleaseUnusedResources()
+{
+	auto IsExpired = [this](uint64_t lastUsedFrame)
+	{
+		return lastUsedFrame + UnusedFrameCountBeforeRelease < m_frameIndex;
+	};
+
+	// Frame buffers which use an expired texture go away before the texture.
+	for (const PhysicalTexture& physicalTexture : m_physicalTextures)
+	{
+		if (!IsExpired(physicalTexture.lastUsedFrame))
+		{
+			continue;
+		}
+
+		for (FrameBufferEntry& frameBuffer : m_frameBuffers)
+		{
+			const uint16_t* pTextureHandlesBegin = frameBuffer.textureHandles;
+			const uint16_t* pTextureHandlesEnd = pTextureHandlesBegin + frameBuffer.attachmentCount;
+			if (std::find(pTextureHandlesBegin, pTextureHandlesEnd, physicalTexture.handle.idx) != pTextureHandlesEnd)
+			{
+				frameBuffer.lastUsedFrame = 0U;
+			}
+		}
+	}
+
+	std::erase_if(m_frameBuffers, [&IsExpired](const FrameBufferEntry& frameBuffer)
+	{
+		if (IsExpired(frameBuffer.lastUsedFrame))
+		{
+			bgfx::destroy(frameBuffer.handle);
+			return true;
+		}
+		return false;
+	});
+
+	std::erase_if(m_physicalTextures, [&IsExpired](const PhysicalTexture& physicalTexture)
+	{
+		if (IsExpired(physicalTexture.lastUsedFrame))
+		{
+			bgfx::destroy(physicalTexture.handle);
+			return true;
+		}
+		return false;
+	});
+}
+
+void RenderGraph::AllocatePhysicalTextures()
+{
+	for (uint32_t passIndex = 0U; passIndex < m_passCount; ++passIndex)
+	{
+		const PassNode& pass = m_passes[passIndex];
+		if (pass.isCulled)
+		{
+			continue;
+		}
+
+		auto UpdateLifetime = [this, passIndex](RenderGraphResource resource)
+		{
+			ResourceNode& node = m_resources[resource];
+			node.firstPassIndex = std::min(node.firstPassIndex, static_cast<uint16_t>(passIndex));
+			node.lastPassIndex = std::max(node.lastPassIndex, static_cast<uint16_t>(passIndex));
+		};
+		std::for_each(pass.reads.begin(), pass.reads.end(), UpdateLifetime);
+		std::for_each(pass.writes.begin(), pass.writes.end(), UpdateLifetime);
+	}
+
+	for (PhysicalTexture& physicalTexture : m_physicalTextures)
+	{
+		physicalTexture.isInUse = false;
+	}
+
+	// Acquire textures when their lifetimes begin and give them back when they end so that later textures can alias them.
+	m_transientTextureCount = 0U;
+	for (uint32_t passIndex = 0U; passIndex < m_passCount; ++passIndex)
+	{
+		const PassNode& pass = m_passes[passIndex];
+		if (pass.isCulled)
+		{
+			continue;
+		}
+
+		auto Acquire = [this, passIndex](RenderGraphResource resource)
+		{
+			ResourceNode& node = m_resources[resource];
+			if (!node.isImported && passIndex == node.firstPassIndex && UINT16_MAX == node.physicalIndex)
+			{
+				node.physicalIndex = AcquirePhysicalTexture(node.desc);
+				++m_transientTextureCount;
+			}
+		};
+		std::for_each(pass.reads.begin(), pass.reads.end(), Acquire);
+		std::for_each(pass.writes.begin(), pass.writes.end(), Acquire);
+
+		auto Release = [this, passIndex](RenderGraphResource resource)
+		{
+			const ResourceNode& node = m_resources[resource];
+			if (!node.isImported && passIndex == node.lastPassIndex)
+			{
+				m_physicalTextures[node.physicalIndex].isInUse = false;
+			}
+		};
+		std::for_each(pass.reads.begin(), pass.reads.end(), Release);
+		std::for_each(pass.writes.begin(), pass.writes.end(), Release);
+	}
+}
+
+uint16_t RenderGraph::AcquirePhysicalTexture(const RenderGraphTextureDesc& desc)
+{
+	// First fit keeps the assignment stable across frames when the graph doesn't change.
+	for (uint32_t physicalIndex = 0U; physicalIndex < m_physicalTextures.size(); ++physicalIndex)
+	{
+		PhysicalTexture& physicalTexture = m_physicalTextures[physicalIndex];
+		if (!physicalTexture.isInUse && physicalTexture.desc == desc)
+		{
+			physicalTexture.isInUse = true;
+			physicalTexture.lastUsedFrame = m_frameIndex;
+			return static_cast<uint16_t>(physicalIndex);
+		}
+	}
+
+	PhysicalTexture& physicalTexture = m_physicalTextures.emplace_back();
+	physicalTexture.desc = desc;
+	physicalTexture.handle = bgfx::createTexture2D(desc.width, desc.height, false, 1, desc.format, desc.flags);
+	physicalTexture.lastUsedFrame = m_frameIndex;
+	physicalTexture.isInUse = true;
+	return static_cast<uint16_t>(m_physicalTextures.size() - 1U);
+}
+
+bgfx::FrameBufferHandle RenderGraph::GetFrameBuffer(const PassNode& pass)
+{
+	uint16_t textureHandles[MaxAttachmentCount];
+	uint8_t attachmentCount = static_cast<uint8_t>(pass.attachments.size());
+	for (uint8_t attachmentIndex = 0U; attachmentIndex < attachmentCount; ++attachmentIndex)
+	{
+		textureHandles[attachmentIndex] = GetTexture(pass.attachments[attachmentIndex]).idx;
+	}
+
+	for (FrameBufferEntry& frameBuffer : m_frameBuffers)
+	{
+		if (frameBuffer.attachmentCount == attachmentCount &&
+			std::equal(textureHandles, textureHandles + attachmentCount, frameBuffer.textureHandles))
+		{
+			frameBuffer.lastUsedFrame = m_frameIndex;
+			return frameBuffer.handle;
+		}
+	}
+
+	bgfx::TextureHandle attachmentTextures[MaxAttachmentCount];
+	for (uint8_t attachmentIndex = 0U; attachmentIndex < attachmentCount; ++attachmentIndex)
+	{
+		attachmentTextures[attachmentIndex] = bgfx::TextureHandle{ textureHandles[attachmentIndex] };
+	}
+
+	FrameBufferEntry& frameBuffer = m_frameBuffers.emplace_back();
+	std::copy_n(textureHandles, attachmentCount, frameBuffer.textureHandles);
+	frameBuffer.attachmentCount = attachmentCount;
+	frameBuffer.handle = bgfx::createFrameBuffer(attachmentCount, attachmentTextures, false);
+	frameBuffer.lastUsedFrame = m_frameIndex;
+	return frameBuffer.handle;
+}
+
+}
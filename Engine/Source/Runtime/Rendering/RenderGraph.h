@@ -0,0 +1,189 @@
+#pragma once
+
+#include "Base/Template.h"
+#include "Core/Delegates/Delegate.hpp"
+
+#include <bgfx/bgfx.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace engine
+{
+
+class RenderGraph;
+
+using RenderGraphResource = uint16_t;
+static constexpr RenderGraphResource InvalidRenderGraphResource = UINT16_MAX;
+
+struct RenderGraphTextureDesc
+{
+	uint16_t width = 0;
+	uint16_t height = 0;
+	bgfx::TextureFormat::Enum format = bgfx::TextureFormat::RGBA8;
+	uint64_t flags = BGFX_TEXTURE_RT;
+
+	bool operator==(const RenderGraphTextureDesc&) const = default;
+};
+
+// Passed to the setup function of a pass to declare what the pass reads and writes.
+class RenderGraphBuilder final
+{
+public:
+	RenderGraphBuilder(const RenderGraphBuilder&) = delete;
+	RenderGraphBuilder& operator=(const RenderGraphBuilder&) = delete;
+	RenderGraphBuilder(RenderGraphBuilder&&) = delete;
+	RenderGraphBuilder& operator=(RenderGraphBuilder&&) = delete;
+	~RenderGraphBuilder() = default;
+
+	// Transient texture which only lives inside the graph. Its memory can be shared with other transient textures.
+	RenderGraphResource CreateTexture(const char* pName, const RenderGraphTextureDesc& desc);
+
+	RenderGraphResource Read(RenderGraphResource resource);
+	// Bound as the next color attachment of the pass's frame buffer.
+	RenderGraphResource WriteAttachment(RenderGraphResource resource);
+	// Written without a frame buffer, e.g. bgfx::blit or compute.
+	RenderGraphResource Write(RenderGraphResource resource);
+
+	// The pass has effects outside the graph so it is never culled.
+	void SetSideEffect();
+
+private:
+	friend class RenderGraph;
+	RenderGraphBuilder(RenderGraph& graph, uint16_t passIndex) : m_graph(graph), m_passIndex(passIndex) {}
+
+	RenderGraph& m_graph;
+	uint16_t m_passIndex;
+};
+
+// RenderGraph is rebuilt every frame from passes which declare reads and writes of named resources.
+// Compile culls passes whose outputs nobody uses, gives surviving passes the graph's views in declaration order
+// and assigns transient textures to pooled GPU textures so that textures with non-overlapping lifetimes share memory.
+// Pooled textures and frame buffers are kept across frames and released after they stay unused for a few frames.
+class RenderGraph final
+{
+public:
+	using ExecuteFunction = std::function<void(const RenderGraph&, uint16_t viewID)>;
+
+	static constexpr uint8_t MaxAttachmentCount = 4U;
+	static constexpr uint32_t UnusedFrameCountBeforeRelease = 4U;
+
+public:
+	RenderGraph() = default;
+	RenderGraph(const RenderGraph&) = delete;
+	RenderGraph& operator=(const RenderGraph&) = delete;
+	RenderGraph(RenderGraph&&) = delete;
+	RenderGraph& operator=(RenderGraph&&) = delete;
+	~RenderGraph();
+
+	// Views [firstViewID, firstViewID + viewCount) are owned by the graph.
+	void SetViewRange(uint16_t firstViewID, uint16_t viewCount);
+	uint16_t GetFirstViewID() const { return m_viewIDs.empty() ? 0U : m_viewIDs.front(); }
+	uint16_t GetViewCount() const { return static_cast<uint16_t>(m_viewIDs.size()); }
+
+	// Called by Compile when alive passes need more views than the graph owns. Returns the first of viewCount consecutive new views.
+	// Views are only reserved for passes which were alive so the graph never owns more views than its largest frame used.
+	Delegate<uint16_t(uint16_t viewCount)> OnReserveViews;
+
+	// Build the graph for one frame. Declaration order is execution order so a pass can only read what earlier passes wrote.
+	RenderGraphResource ImportTexture(const char* pName, bgfx::TextureHandle textureHandle, const RenderGraphTextureDesc& desc);
+	// Setup is called immediately so it is not stored in a std::function.
+	template<typename SetupFunction>
+	void AddPass(const char* pName, SetupFunction&& setup, ExecuteFunction execute)
+	{
+		RenderGraphBuilder builder(*this, BeginPass(pName, cd::MoveTemp(execute)));
+		setup(builder);
+	}
+
+	void Compile();
+	// Sets up views and calls execute functions of alive passes. Clears passes and resources for the next frame.
+	void Execute();
+
+	// Destroy all pooled GPU resources.
+	void Reset();
+
+	// Valid inside execute functions.
+	bgfx::TextureHandle GetTexture(RenderGraphResource resource) const;
+	const RenderGraphTextureDesc& GetTextureDesc(RenderGraphResource resource) const;
+
+	// Statistics of the last compiled frame.
+	uint32_t GetPassCount() const { return m_passCount; }
+	uint32_t GetCulledPassCount() const { return m_culledPassCount; }
+	bool IsPassCulled(uint32_t passIndex) const { return m_passes[passIndex].isCulled; }
+	uint16_t GetPassViewID(uint32_t passIndex) const { return m_passes[passIndex].viewID; }
+	uint32_t GetTransientTextureCount() const { return m_transientTextureCount; }
+	uint32_t GetPhysicalTextureCount() const { return static_cast<uint32_t>(m_physicalTextures.size()); }
+	uint64_t GetPhysicalTextureBytes() const;
+
+private:
+	friend class RenderGraphBuilder;
+
+	struct ResourceNode
+	{
+		std::string name;
+		RenderGraphTextureDesc desc;
+		bgfx::TextureHandle importedHandle;
+		bool isImported;
+		uint16_t firstPassIndex;
+		uint16_t lastPassIndex;
+		uint16_t physicalIndex;
+	};
+
+	struct PassNode
+	{
+		std::string name;
+		ExecuteFunction execute;
+		std::vector<RenderGraphResource> reads;
+		std::vector<RenderGraphResource> writes;
+		std::vector<RenderGraphResource> attachments;
+		bool hasSideEffect;
+		bool isCulled;
+		uint16_t viewID;
+		uint16_t viewIndex;
+	};
+
+	struct PhysicalTexture
+	{
+		RenderGraphTextureDesc desc;
+		bgfx::TextureHandle handle;
+		uint64_t lastUsedFrame;
+		bool isInUse;
+	};
+
+	struct FrameBufferEntry
+	{
+		uint16_t textureHandles[MaxAttachmentCount];
+		uint8_t attachmentCount;
+		bgfx::FrameBufferHandle handle;
+		uint64_t lastUsedFrame;
+	};
+
+	uint16_t BeginPass(const char* pName, ExecuteFunction execute);
+	uint16_t AddResource(const char* pName, const RenderGraphTextureDesc& desc);
+	void CullPasses();
+	void AllocatePhysicalTextures();
+	void ReleaseUnusedResources();
+	uint16_t AcquirePhysicalTexture(const RenderGraphTextureDesc& desc);
+	bgfx::FrameBufferHandle GetFrameBuffer(const PassNode& pass);
+
+private:
+	std::vector<uint16_t> m_viewIDs;
+	uint64_t m_frameIndex = 0U;
+	bool m_isCompiled = false;
+
+	// Nodes are reused across frames to keep the capacity of their containers.
+	std::vector<PassNode> m_passes;
+	uint32_t m_passCount = 0U;
+	std::vector<ResourceNode> m_resources;
+	uint32_t m_resourceCount = 0U;
+	uint32_t m_culledPassCount = 0U;
+	uint32_t m_transientTextureCount = 0U;
+
+	std::vector<PhysicalTexture> m_physicalTextures;
+	std::vector<FrameBufferEntry> m_frameBuffers;
+	std::vector<std::string> m_viewNames;
+};
+
+}
@@ -1,6 +1,7 @@
 #include "Renderer.h"
 
 #include "ECWorld/StaticMeshComponent.h"
+#include "Rendering/PipelineState.h"
 #include "Rendering/RenderContext.h"
 #include "Rendering/RenderTarget.h"
 #include "Rendering/Resources/MeshResource.h"
@@ -161,4 +162,57 @@ void Renderer::SubmitStaticMeshDrawCall(StaticMeshComponent* pMeshComponent, uin
 	SubmitStaticMeshDrawCall(pMeshComponent, viewID, m_pRenderContext->GetResourceContext()->GetShaderResource(programHandleIndex)->GetHandle());
 }
 
+void Renderer::SubmitStaticMeshDrawCall(bgfx::Encoder* pEncoder, const StaticMeshComponent* pMeshComponent, uint16_t viewID, uint16_t programHandle, uint64_t state)
+{
+	// Encoder state is reset after every submit so the transform is kept and state is set again for every index buffer.
+	const MeshResource* pMeshResource = pMeshComponent->GetMeshResource();
+	assert(ResourceStatus::Ready == pMeshResource->GetStatus() || ResourceStatus::Optimized == pMeshResource->GetStatus());
+	assert(bgfx::isValid(bgfx::ProgramHandle{ programHandle }));
+	for (uint32_t indexBufferIndex = 0U, indexBufferCount = pMeshResource->GetIndexBufferCount(); indexBufferIndex < indexBufferCount; ++indexBufferIndex)
+	{
+		pEncoder->setState(state);
+		pEncoder->setVertexBuffer(0, bgfx::VertexBufferHandle{ pMeshResource->GetVertexBufferHandle() }, pMeshComponent->GetStartVertex(), pMeshComponent->GetVertexCount());
+		pEncoder->setIndexBuffer(bgfx::IndexBufferHandle{ pMeshResource->GetIndexBufferHandle(indexBufferIndex) }, pMeshComponent->GetStartIndex(), pMeshComponent->GetIndexCount());
+		pEncoder->submit(viewID, bgfx::ProgramHandle{ programHandle }, 0, BGFX_DISCARD_ALL & ~BGFX_DISCARD_TRANSFORM);
+		RenderCommandCounter::AddDrawCall();
+	}
+	pEncoder->discard(BGFX_DISCARD_ALL);
+}
+
+void Renderer::SubmitSkinnedMeshDrawCall(bgfx::Encoder* pEncoder, const StaticMeshComponent* pMeshComponent, uint16_t skinnedVertexBuffer, uint16_t viewID, uint16_t programHandle, uint64_t state)
+{
+	// Streams are merged by bgfx in order so position and normal of stream 0 hide the ones in the mesh vertex buffer.
+	const MeshResource* pMeshResource = pMeshComponent->GetMeshResource();
+	assert(ResourceStatus::Ready == pMeshResource->GetStatus() || ResourceStatus::Optimized == pMeshResource->GetStatus());
+	assert(bgfx::isValid(bgfx::ProgramHandle{ programHandle }));
+	for (uint32_t indexBufferIndex = 0U, indexBufferCount = pMeshResource->GetIndexBufferCount(); indexBufferIndex < indexBufferCount; ++indexBufferIndex)
+	{
+		pEncoder->setState(state);
+		pEncoder->setVertexBuffer(0, bgfx::DynamicVertexBufferHandle{ skinnedVertexBuffer }, pMeshComponent->GetStartVertex(), pMeshComponent->GetVertexCount());
+		pEncoder->setVertexBuffer(1, bgfx::VertexBufferHandle{ pMeshResource->GetVertexBufferHandle() }, pMeshComponent->GetStartVertex(), pMeshComponent->GetVertexCount());
+		pEncoder->setIndexBuffer(bgfx::IndexBufferHandle{ pMeshResource->GetIndexBufferHandle(indexBufferIndex) }, pMeshComponent->GetStartIndex(), pMeshComponent->GetIndexCount());
+		pEncoder->submit(viewID, bgfx::ProgramHandle{ programHandle }, 0, BGFX_DISCARD_ALL & ~BGFX_DISCARD_TRANSFORM);
+		RenderCommandCounter::AddDrawCall();
+	}
+	pEncoder->discard(BGFX_DISCARD_ALL);
+}
+
+void Renderer::ApplyPipelineState(const PipelineState& pipelineState)
+{
+	for (uint8_t textureIndex = 0; textureIndex < pipelineState.textureCount; ++textureIndex)
+	{
+		const PipelineTexture& texture = pipelineState.textures[textureIndex];
+		bgfx::setTexture(texture.slot, bgfx::UniformHandle{ texture.samplerUniformHandle }, bgfx::TextureHandle{ texture.textureHandle }, texture.samplerFlags);
+	}
+
+	for (uint8_t uniformIndex = 0; uniformIndex < pipelineState.uniformCount; ++uniformIndex)
+	{
+		const PipelineUniform& uniform = pipelineState.uniforms[uniformIndex];
+		bgfx::setUniform(bgfx::UniformHandle{ uniform.uniformHandle }, uniform.value, 1);
+		RenderCommandCounter::AddUniformUpdate();
+	}
+
+	bgfx::setState(pipelineState.state);
+}
+
 }
\ No newline at end of file
@@ -6,6 +6,13 @@
 #include <set>
 #include <string>
 
+namespace bgfx
+{
+
+struct Encoder;
+
+}
+
 namespace engine
 {
 
@@ -14,6 +21,7 @@ class RenderContext;
 class RenderTarget;
 class ShaderResource;
 class StaticMeshComponent;
+struct PipelineState;
 
 class Renderer
 {
@@ -33,6 +41,15 @@ public:
 	virtual void UpdateView(const float* pViewMatrix, const float* pProjectionMatrix) = 0;
 	virtual void Render(float deltaTime) = 0;
 
+	// Parallel recording. A renderer which sets up all of its views and per frame data in PrepareRecord on the main thread
+	// can record draw calls on job threads through bgfx encoders. Every record task must only submit to views it owns
+	// so that the output doesn't depend on which thread or encoder recorded it.
+	virtual bool IsParallelRecordSupported() const { return false; }
+	// Returns false when there is nothing to record in this frame.
+	virtual bool PrepareRecord(float deltaTime) { return false; }
+	virtual uint32_t GetRecordTaskCount() const { return 0U; }
+	virtual void Record(bgfx::Encoder* pEncoder, uint32_t taskIndex) {}
+
 	uint16_t GetViewID() const { return m_viewID; }
 	
 	void UpdateViewRenderTarget();
@@ -44,6 +61,12 @@ public:
 
 	void SubmitStaticMeshDrawCall(StaticMeshComponent* pMeshComponent, uint16_t viewID, uint16_t programHandle);
 	void SubmitStaticMeshDrawCall(StaticMeshComponent* pMeshComponent, uint16_t viewID, StringCrc programHandleIndex);
+	static void SubmitStaticMeshDrawCall(bgfx::Encoder* pEncoder, const StaticMeshComponent* pMeshComponent, uint16_t viewID, uint16_t programHandle, uint64_t state);
+	// Pre-skinned positions and normals from skinnedVertexBuffer, other attributes from the mesh.
+	static void SubmitSkinnedMeshDrawCall(bgfx::Encoder* pEncoder, const StaticMeshComponent* pMeshComponent, uint16_t skinnedVertexBuffer, uint16_t viewID, uint16_t programHandle, uint64_t state);
+
+	// Sets textures, uniforms and render states in a resolved PipelineState.
+	static void ApplyPipelineState(const PipelineState& pipelineState);
 
 public:
 	static void ScreenSpaceQuad(const RenderTarget* pRenderTarget, bool _originBottomLeft = false, float _width = 1.0f, float _height = 1.0f);
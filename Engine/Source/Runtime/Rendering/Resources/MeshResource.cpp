@@ -4,6 +4,9 @@
 #include "Rendering/Utility/VertexLayoutUtility.h"
 #include "Utilities/MeshUtils.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 namespace details
 {
 
@@ -17,6 +20,40 @@ uint16_t SubmitVertexBuffer(const engine::MeshResource::VertexBuffer& vertexBuff
 	return vertexBufferHandle.idx;
 }
 
+uint32_t GetAttributeValueSize(cd::AttributeValueType valueType)
+{
+	switch (valueType)
+	{
+	case cd::AttributeValueType::Uint8:
+		return 1U;
+	case cd::AttributeValueType::Int16:
+		return 2U;
+	default:
+		return 4U;
+	}
+}
+
+float ReadAttributeValue(const std::byte* pData, cd::AttributeValueType valueType)
+{
+	switch (valueType)
+	{
+	case cd::AttributeValueType::Uint8:
+		return static_cast<float>(*reinterpret_cast<const uint8_t*>(pData));
+	case cd::AttributeValueType::Int16:
+	{
+		int16_t value;
+		std::memcpy(&value, pData, sizeof(value));
+		return static_cast<float>(value);
+	}
+	default:
+	{
+		float value;
+		std::memcpy(&value, pData, sizeof(value));
+		return value;
+	}
+	}
+}
+
 enum class IndexBufferType
 {
 	Static,
@@ -77,6 +114,7 @@ void MeshResource::SetMeshAsset(const cd::Mesh* pMeshAsset)
 void MeshResource::SetSkinAsset(const cd::Skin* pSkinAsset)
 {
 	m_pSkinAsset.push_back(pSkinAsset);
+	m_isSkinned = true;
 }
 
 void MeshResource::AddBonesAsset(const cd::Bone& bone)
@@ -112,6 +150,63 @@ void MeshResource::UpdateVertexFormat(const cd::VertexFormat& vertexFormat)
 	}
 }
 
+bool MeshResource::GetBuiltData(BuiltData& builtData) const
+{
+	builtData.vertexFormat = m_currentVertexFormat;
+	builtData.isSkinned = m_isSkinned;
+	if (!m_vertexBuffer.empty() && !m_indexBuffers.empty())
+	{
+		builtData.vertexCount = m_vertexCount;
+		builtData.polygonCount = m_polygonCount;
+		builtData.vertexBuffer = m_vertexBuffer;
+		builtData.indexBuffers = m_indexBuffers;
+		return true;
+	}
+
+	if (!m_pMeshAsset || m_pMeshAsset->GetVertexCount() < 3U || 0U == m_pMeshAsset->GetPolygonCount())
+	{
+		return false;
+	}
+
+	std::optional<cd::VertexBuffer> optVertexBuffer = m_isSkinned ?
+		cd::BuildVertexBufferForSkeletalMesh(*m_pMeshAsset, m_currentVertexFormat, *m_pSkinAsset[0], m_pBonesAsset) :
+		cd::BuildVertexBufferForStaticMesh(*m_pMeshAsset, m_currentVertexFormat);
+	if (!optVertexBuffer.has_value())
+	{
+		return false;
+	}
+
+	builtData.vertexCount = m_pMeshAsset->GetVertexCount();
+	builtData.polygonCount = m_pMeshAsset->GetPolygonCount();
+	builtData.vertexBuffer = cd::MoveTemp(optVertexBuffer.value());
+	builtData.indexBuffers.resize(m_pMeshAsset->GetPolygonGroupCount());
+	for (uint32_t polygonGroupIndex = 0U; polygonGroupIndex < m_pMeshAsset->GetPolygonGroupCount(); ++polygonGroupIndex)
+	{
+		std::optional<cd::IndexBuffer> optIndexBuffer = cd::BuildIndexBufferesForPolygonGroup(*m_pMeshAsset, polygonGroupIndex);
+		if (!optIndexBuffer.has_value())
+		{
+			return false;
+		}
+		builtData.indexBuffers[polygonGroupIndex] = cd::MoveTemp(optIndexBuffer.value());
+	}
+
+	return true;
+}
+
+void MeshResource::SetBuiltData(BuiltData builtData)
+{
+	m_pMeshAsset = nullptr;
+	m_pSkinAsset.clear();
+	m_pBonesAsset.clear();
+	m_currentVertexFormat = cd::MoveTemp(builtData.vertexFormat);
+	m_vertexCount = builtData.vertexCount;
+	m_polygonCount = builtData.polygonCount;
+	m_polygonGroupCount = static_cast<uint32_t>(builtData.indexBuffers.size());
+	m_isSkinned = builtData.isSkinned;
+	m_vertexBuffer = cd::MoveTemp(builtData.vertexBuffer);
+	m_indexBuffers = cd::MoveTemp(builtData.indexBuffers);
+}
+
 void MeshResource::Update()
 {
 	switch (GetStatus())
@@ -125,6 +220,10 @@ void MeshResource::Update()
 			m_polygonGroupCount = m_pMeshAsset->GetPolygonGroupCount();
 			SetStatus(ResourceStatus::Loaded);
 		}
+		else if (!m_vertexBuffer.empty())
+		{
+			SetStatus(ResourceStatus::Loaded);
+		}
 		break;
 	}
 	case ResourceStatus::Loaded:
@@ -137,8 +236,16 @@ void MeshResource::Update()
 	}
 	case ResourceStatus::Building:
 	{
-		BuildVertexBuffer();
-		BuildIndexBuffer();
+		// Buffers which were set as built data are used as they are.
+		if (m_pMeshAsset)
+		{
+			BuildVertexBuffer();
+			BuildIndexBuffer();
+		}
+		if (m_isSkinned)
+		{
+			BuildSkinningVertices();
+		}
 		SetStatus(ResourceStatus::Built);
 		break;
 	}
@@ -146,6 +253,7 @@ void MeshResource::Update()
 	{
 		SubmitVertexBuffer();
 		SubmitIndexBuffer();
+		SubmitSkinningVertexBuffer();
 		m_recycleCount = 0U;
 		SetStatus(ResourceStatus::Ready);
 		break;
@@ -165,6 +273,7 @@ void MeshResource::Update()
 	{
 		DestroyVertexBufferHandle();
 		DestroyIndexBufferHandle();
+		DestroySkinningVertexBufferHandle();
 		// CPU data will destroy after deconstructor.
 		SetStatus(ResourceStatus::Destroyed);
 		break;
@@ -178,6 +287,7 @@ void MeshResource::Reset()
 {
 	DestroyVertexBufferHandle();
 	DestroyIndexBufferHandle();
+	DestroySkinningVertexBufferHandle();
 	ClearMeshData();
 	SetStatus(ResourceStatus::Loading);
 }
@@ -209,6 +319,61 @@ bool MeshResource::BuildVertexBuffer()
 	return true;
 }
 
+bool MeshResource::BuildSkinningVertices()
+{
+	// Reads bind pose attributes back from the interleaved vertex buffer so that bone influences match what is drawn.
+	const cd::VertexAttributeLayout* pLayouts[4] = {};
+	uint32_t offsets[4] = {};
+	constexpr cd::VertexAttributeType attributeTypes[4] = { cd::VertexAttributeType::Position, cd::VertexAttributeType::Normal,
+		cd::VertexAttributeType::BoneIndex, cd::VertexAttributeType::BoneWeight };
+	uint32_t offset = 0U;
+	for (const cd::VertexAttributeLayout& layout : m_currentVertexFormat.GetVertexAttributeLayouts())
+	{
+		for (uint32_t attributeIndex = 0U; attributeIndex < 4U; ++attributeIndex)
+		{
+			if (attributeTypes[attributeIndex] == layout.vertexAttributeType)
+			{
+				pLayouts[attributeIndex] = &layout;
+				offsets[attributeIndex] = offset;
+			}
+		}
+		offset += details::GetAttributeValueSize(layout.attributeValueType) * layout.attributeCount;
+	}
+
+	const uint32_t stride = offset;
+	if (!pLayouts[0] || !pLayouts[2] || !pLayouts[3] || m_vertexBuffer.size() < static_cast<size_t>(stride) * m_vertexCount)
+	{
+		CD_ERROR("Failed to build skinning vertices, position and bone influences are required.");
+		return false;
+	}
+
+	m_skinningVertices.assign(m_vertexCount, SkinningVertex{});
+	for (uint32_t vertexIndex = 0U; vertexIndex < m_vertexCount; ++vertexIndex)
+	{
+		const std::byte* pVertex = m_vertexBuffer.data() + static_cast<size_t>(vertexIndex) * stride;
+		float* pOutputs[4] = { m_skinningVertices[vertexIndex].position, m_skinningVertices[vertexIndex].normal,
+			m_skinningVertices[vertexIndex].boneIndices, m_skinningVertices[vertexIndex].boneWeights };
+		for (uint32_t attributeIndex = 0U; attributeIndex < 4U; ++attributeIndex)
+		{
+			const cd::VertexAttributeLayout* pLayout = pLayouts[attributeIndex];
+			if (!pLayout)
+			{
+				continue;
+			}
+
+			const uint32_t valueSize = details::GetAttributeValueSize(pLayout->attributeValueType);
+			const uint32_t valueCount = std::min(static_cast<uint32_t>(pLayout->attributeCount), 4U);
+			for (uint32_t valueIndex = 0U; valueIndex < valueCount; ++valueIndex)
+			{
+				pOutputs[attributeIndex][valueIndex] = details::ReadAttributeValue(pVertex + offsets[attributeIndex] + valueIndex * valueSize, pLayout->attributeValueType);
+			}
+		}
+		m_skinningVertices[vertexIndex].position[3] = 1.0f;
+	}
+
+	return true;
+}
+
 bool MeshResource::BuildIndexBuffer()
 {
 	assert(m_pMeshAsset && m_polygonCount > 0U && m_polygonGroupCount > 0U);
@@ -293,17 +458,47 @@ void MeshResource::SubmitIndexBuffer()
 	}
 }
 
+void MeshResource::SubmitSkinningVertexBuffer()
+{
+	// Only compute shaders read the GPU copy.
+	if (m_skinningVertices.empty() || m_skinningVertexBufferHandle != UINT16_MAX ||
+		0U == (bgfx::getCaps()->supported & BGFX_CAPS_COMPUTE))
+	{
+		return;
+	}
+
+	bgfx::VertexLayout vertexLayout;
+	vertexLayout.begin()
+		.add(bgfx::Attrib::Position, 4, bgfx::AttribType::Float)
+		.add(bgfx::Attrib::Normal, 4, bgfx::AttribType::Float)
+		.add(bgfx::Attrib::Indices, 4, bgfx::AttribType::Float)
+		.add(bgfx::Attrib::Weight, 4, bgfx::AttribType::Float)
+		.end();
+	const bgfx::Memory* pMemory = bgfx::makeRef(m_skinningVertices.data(), static_cast<uint32_t>(m_skinningVertices.size() * sizeof(SkinningVertex)));
+	bgfx::VertexBufferHandle vertexBufferHandle = bgfx::createVertexBuffer(pMemory, vertexLayout, BGFX_BUFFER_COMPUTE_READ);
+	assert(bgfx::isValid(vertexBufferHandle));
+	m_skinningVertexBufferHandle = vertexBufferHandle.idx;
+}
+
 void MeshResource::ClearMeshData()
 {
 	m_vertexBuffer.clear();
 	m_indexBuffers.clear();
+	m_skinningVertices.clear();
 }
 
 void MeshResource::FreeMeshData()
 {
-	ClearMeshData();
+	// CPU pre-skinning reads skinning vertices every frame when there is no GPU copy.
+	const bool keepSkinningVertices = m_skinningVertexBufferHandle == UINT16_MAX;
+	m_vertexBuffer.clear();
+	m_indexBuffers.clear();
 	VertexBuffer().swap(m_vertexBuffer);
 	std::vector<IndexBuffer>().swap(m_indexBuffers);
+	if (!keepSkinningVertices)
+	{
+		std::vector<SkinningVertex>().swap(m_skinningVertices);
+	}
 }
 
 void MeshResource::DestroyVertexBufferHandle()
@@ -315,6 +510,15 @@ void MeshResource::DestroyVertexBufferHandle()
 	}
 }
 
+void MeshResource::DestroySkinningVertexBufferHandle()
+{
+	if (m_skinningVertexBufferHandle != UINT16_MAX)
+	{
+		bgfx::destroy(bgfx::VertexBufferHandle{ m_skinningVertexBufferHandle });
+		m_skinningVertexBufferHandle = UINT16_MAX;
+	}
+}
+
 void MeshResource::DestroyIndexBufferHandle()
 {
 	for (uint16_t indexBufferHandle : m_indexBufferHandles)
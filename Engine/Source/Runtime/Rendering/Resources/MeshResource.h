@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Animation/VertexSkinning.h"
 #include "IResource.h"
 #include "Scene/VertexFormat.h"
 
@@ -23,6 +24,17 @@ public:
 	using VertexBuffer = std::vector<std::byte>;
 	using IndexBuffer = std::vector<std::byte>;
 
+	// CPU buffers in the current vertex format. Scene snapshots store them so that loading doesn't need a cd::Mesh.
+	struct BuiltData
+	{
+		cd::VertexFormat vertexFormat;
+		uint32_t vertexCount = 0U;
+		uint32_t polygonCount = 0U;
+		bool isSkinned = false;
+		VertexBuffer vertexBuffer;
+		std::vector<IndexBuffer> indexBuffers;
+	};
+
 public:
 	MeshResource();
 	MeshResource(const MeshResource&) = default;
@@ -44,6 +56,12 @@ public:
 	void AddBonesAsset(const cd::Bone&);
 	
 	void UpdateVertexFormat(const cd::VertexFormat& vertexFormat);
+	const cd::VertexFormat& GetVertexFormat() const { return m_currentVertexFormat; }
+
+	// Copies CPU buffers, or builds them from the mesh asset when they are not built yet or were freed.
+	bool GetBuiltData(BuiltData& builtData) const;
+	// Replaces the mesh asset by buffers which were built before. The resource is built from them in the next updates.
+	void SetBuiltData(BuiltData builtData);
 	
 	uint32_t GetVertexCount() const { return m_vertexCount; }
 	uint32_t GetPolygonCount() const { return m_polygonCount; }
@@ -52,15 +70,22 @@ public:
 	uint32_t GetIndexBufferCount() const { return static_cast<uint32_t>(m_indexBufferHandles.size()); }
 	uint16_t GetIndexBufferHandle(uint32_t index) const;
 
+	// Bind pose vertices of skinned meshes for pre-skinning. The CPU copy is only kept when compute shaders are not supported.
+	const std::vector<SkinningVertex>& GetSkinningVertices() const { return m_skinningVertices; }
+	uint16_t GetSkinningVertexBufferHandle() const { return m_skinningVertexBufferHandle; }
+
 private:
 	bool BuildVertexBuffer();
+	bool BuildSkinningVertices();
 	bool BuildIndexBuffer();
 	void SubmitVertexBuffer();
 	void SubmitIndexBuffer();
+	void SubmitSkinningVertexBuffer();
 	void ClearMeshData();
 	void FreeMeshData();
 	void DestroyVertexBufferHandle();
 	void DestroyIndexBufferHandle();
+	void DestroySkinningVertexBufferHandle();
 
 private:
 	// Asset
@@ -70,6 +95,7 @@ private:
 	uint32_t m_vertexCount = 0U;
 	uint32_t m_polygonCount = 0U;
 	uint32_t m_polygonGroupCount = 0U;
+	bool m_isSkinned = false;
 
 	// Runtime
 	cd::VertexFormat m_currentVertexFormat;
@@ -77,11 +103,13 @@ private:
 	// CPU
 	VertexBuffer m_vertexBuffer;
 	std::vector<IndexBuffer> m_indexBuffers;
+	std::vector<SkinningVertex> m_skinningVertices;
 	uint32_t m_recycleCount = 0;
 
 	// GPU
 	uint16_t m_vertexBufferHandle = UINT16_MAX;
 	std::vector<uint16_t> m_indexBufferHandles;
+	uint16_t m_skinningVertexBufferHandle = UINT16_MAX;
 };
 
 }
\ No newline at end of file
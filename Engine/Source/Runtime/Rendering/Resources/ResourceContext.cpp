@@ -1,6 +1,7 @@
 #include "ResourceContext.h"
 
 #include "Base/NameOf.h"
+#include "Core/Memory/MemoryTracker.h"
 #include "MeshResource.h"
 #include "ShaderResource.h"
 #include "SkeletonResource.h"
@@ -15,6 +16,7 @@ ResourceContext::~ResourceContext()
 
 void ResourceContext::Update()
 {
+	CD_MEMORY_TAG_SCOPE(Resources);
 	for (auto& [_, resource] : m_resources)
 	{
 		resource->Update();
@@ -58,14 +60,25 @@ ShaderResource* ResourceContext::GetShaderResource(StringCrc nameCrc)
 	return static_cast<ShaderResource*>(GetResourceImpl<ResourceType::Shader>(nameCrc));
 }
 
+SkeletonResource* ResourceContext::GetSkeletonResource(StringCrc nameCrc)
+{
+	return static_cast<SkeletonResource*>(GetResourceImpl<ResourceType::Skeleton>(nameCrc));
+}
+
 TextureResource* ResourceContext::GetTextureResource(StringCrc nameCrc)
 {
 	return static_cast<TextureResource*>(GetResourceImpl<ResourceType::Texture>(nameCrc));
 }
 
+void ResourceContext::RemoveTextureResource(StringCrc nameCrc)
+{
+	RemoveResourceImpl<ResourceType::Texture>(nameCrc);
+}
+
 template<ResourceType RT>
 IResource* ResourceContext::AddResourceImpl(StringCrc nameCrc)
 {
+	CD_MEMORY_TAG_SCOPE(Resources);
 	StringCrc resourceCrc = GetResourceCrc(RT, nameCrc);
 	auto itResource = m_resources.find(resourceCrc);
 	if (itResource != m_resources.end())
@@ -103,4 +116,10 @@ IResource* ResourceContext::GetResourceImpl(StringCrc nameCrc)
 	return itResource != m_resources.end() ? itResource->second.get() : nullptr;
 }
 
-}
\ No newline at end of file
+template<ResourceType RT>
+void ResourceContext::RemoveResourceImpl(StringCrc nameCrc)
+{
+	m_resources.erase(GetResourceCrc(RT, nameCrc));
+}
+
+}
@@ -35,7 +35,10 @@ public:
 	TextureResource* AddTextureResource(StringCrc nameCrc);
 	MeshResource* GetMeshResource(StringCrc nameCrc);
 	ShaderResource* GetShaderResource(StringCrc nameCrc);
+	SkeletonResource* GetSkeletonResource(StringCrc nameCrc);
 	TextureResource* GetTextureResource(StringCrc nameCrc);
+	// Destroys the resource. Pointers to it must not be used after removing.
+	void RemoveTextureResource(StringCrc nameCrc);
 
 private:
 	template<ResourceType RT>
@@ -44,6 +47,9 @@ private:
 	template<ResourceType RT>
 	IResource* GetResourceImpl(StringCrc nameCrc);
 
+	template<ResourceType RT>
+	void RemoveResourceImpl(StringCrc nameCrc);
+
 private:
 	std::map<StringCrc, std::unique_ptr<IResource>> m_resources;
 };
@@ -62,6 +62,10 @@ void SkeletonResource::Update()
 			m_boneCount = m_pSceneDatabase->GetBoneCount();
 			SetStatus(ResourceStatus::Loaded);
 		}
+		else if (!m_boneParentIndices.empty())
+		{
+			SetStatus(ResourceStatus::Loaded);
+		}
 		break;
 	}
 	case ResourceStatus::Loaded:
@@ -75,7 +79,15 @@ void SkeletonResource::Update()
 	}
 	case ResourceStatus::Building:
 	{
-		BuildSkeletonBuffer();
+		if (m_pSceneDatabase)
+		{
+			BuildSkeletonBuffer();
+			BuildAnimationData();
+		}
+		else
+		{
+			BuildSkeletonBufferFromBones();
+		}
 		SetStatus(ResourceStatus::Built);
 		break;
 	}
@@ -116,9 +128,27 @@ void SkeletonResource::Reset()
 	DestroyVertexBufferHandle();
 	DestroyIndexBufferHandle();
 	ClearSkeletonData();
+	m_animationClips.clear();
+	m_boneOffsets.clear();
+	m_boneParentIndices.clear();
 	SetStatus(ResourceStatus::Loading);
 }
 
+void SkeletonResource::SetAnimationClips(std::vector<AnimationClipData> clips, std::vector<cd::Matrix4x4> boneOffsets)
+{
+	assert(clips.empty() || clips[0].GetBoneCount() == boneOffsets.size());
+	m_boneCount = static_cast<uint32_t>(boneOffsets.size());
+	m_animationClips = std::move(clips);
+	m_boneOffsets = std::move(boneOffsets);
+}
+
+void SkeletonResource::SetSkeletonData(std::vector<cd::Matrix4x4> boneOffsets, std::vector<uint32_t> boneParentIndices, std::vector<AnimationClipData> clips)
+{
+	assert(boneOffsets.size() == boneParentIndices.size());
+	SetAnimationClips(std::move(clips), std::move(boneOffsets));
+	m_boneParentIndices = std::move(boneParentIndices);
+}
+
 void SkeletonResource::BuildSkeletonBuffer()
 {
 	constexpr uint32_t indexTypeSize = static_cast<uint32_t>(sizeof(uint16_t));
@@ -146,6 +176,73 @@ void SkeletonResource::BuildSkeletonBuffer()
 	details::TraverseBone(m_pSceneDatabase->GetBone(0), m_pSceneDatabase, m_vertexBuffer.data(), m_indexBuffer.data(), vbDataSize, ibDataSize);
 }
 
+void SkeletonResource::BuildSkeletonBufferFromBones()
+{
+	// One line from every bone to its parent. Vertex i is bone i in the bind pose.
+	m_currentVertexFormat.AddVertexAttributeLayout(cd::VertexAttributeType::Position, cd::AttributeValueType::Float, 3);
+	m_currentVertexFormat.AddVertexAttributeLayout(cd::VertexAttributeType::BoneIndex, cd::AttributeValueType::Int16, 4U);
+	m_vertexBuffer.resize(m_boneCount * m_currentVertexFormat.GetStride());
+	m_indexBuffer.clear();
+
+	constexpr uint32_t posDataSize = cd::Point::Size * sizeof(cd::Point::ValueType);
+	std::byte* pVertex = m_vertexBuffer.data();
+	for (uint32_t boneIndex = 0U; boneIndex < m_boneCount; ++boneIndex)
+	{
+		const cd::Vec3f position = m_boneOffsets[boneIndex].Inverse().GetTranslation();
+		const uint16_t selectedBoneIndex[4] = { static_cast<uint16_t>(boneIndex), static_cast<uint16_t>(boneIndex),
+			static_cast<uint16_t>(boneIndex), static_cast<uint16_t>(boneIndex) };
+		std::memcpy(pVertex, position.begin(), posDataSize);
+		std::memcpy(pVertex + posDataSize, selectedBoneIndex, sizeof(selectedBoneIndex));
+		pVertex += m_currentVertexFormat.GetStride();
+
+		const uint32_t parentIndex = m_boneParentIndices[boneIndex];
+		if (parentIndex < m_boneCount)
+		{
+			const uint16_t lineIndices[2] = { static_cast<uint16_t>(parentIndex), static_cast<uint16_t>(boneIndex) };
+			const auto* pLineIndices = reinterpret_cast<const std::byte*>(lineIndices);
+			m_indexBuffer.insert(m_indexBuffer.end(), pLineIndices, pLineIndices + sizeof(lineIndices));
+		}
+	}
+}
+
+void SkeletonResource::BuildAnimationData()
+{
+	CompileAnimationData(m_boneOffsets, m_boneParentIndices, m_animationClips);
+}
+
+bool SkeletonResource::CompileAnimationData(std::vector<cd::Matrix4x4>& boneOffsets, std::vector<uint32_t>& boneParentIndices,
+	std::vector<AnimationClipData>& clips) const
+{
+	if (!m_pSceneDatabase)
+	{
+		return false;
+	}
+
+	const uint32_t boneCount = m_pSceneDatabase->GetBoneCount();
+	boneOffsets.resize(boneCount);
+	boneParentIndices.resize(boneCount);
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		const cd::Bone& bone = m_pSceneDatabase->GetBone(boneIndex);
+		boneOffsets[boneIndex] = bone.GetOffset();
+		boneParentIndices[boneIndex] = bone.GetParentID().IsValid() ? bone.GetParentID().Data() : AnimationClipData::InvalidBoneIndex;
+	}
+
+	clips.clear();
+	clips.reserve(m_pSceneDatabase->GetAnimationCount());
+	for (uint32_t animationIndex = 0U; animationIndex < m_pSceneDatabase->GetAnimationCount(); ++animationIndex)
+	{
+		AnimationClipData& clip = clips.emplace_back();
+		if (clip.Compile(m_pSceneDatabase, m_pSceneDatabase->GetAnimation(animationIndex)) && m_isAnimationCompressionEnabled)
+		{
+			// Sampling keeps working on uncompressed frames if the clip is too long.
+			clip.Compress(m_animationCompressionSettings);
+		}
+	}
+
+	return true;
+}
+
 void SkeletonResource::SubmitVertexBuffer()
 {
 	if (m_vertexBufferHandle != UINT16_MAX)
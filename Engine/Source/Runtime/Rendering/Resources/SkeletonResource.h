@@ -1,6 +1,7 @@
 #pragma once
 
 #include "IResource.h"
+#include "Animation/AnimationClipData.h"
 #include "Scene/SceneDatabase.h"
 
 #include <vector>
@@ -38,8 +39,34 @@ public:
 	uint16_t GetVertexBufferHandle() const { return m_vertexBufferHandle; }
 	uint16_t GetIndexBufferHandle() const { return m_indexBufferHandle; }
 
+	// Inverse bind matrices indexed by bone index.
+	const std::vector<cd::Matrix4x4>& GetBoneOffsets() const { return m_boneOffsets; }
+	// Parent bone indices, UINT32_MAX for root bones.
+	const std::vector<uint32_t>& GetBoneParentIndices() const { return m_boneParentIndices; }
+
+	// Clips are compiled from animations of the SceneDatabase in the same order.
+	uint32_t GetAnimationClipCount() const { return static_cast<uint32_t>(m_animationClips.size()); }
+	const AnimationClipData* GetAnimationClip(uint32_t index) const { return index < m_animationClips.size() ? &m_animationClips[index] : nullptr; }
+
+	// Clips which are not compiled from a SceneDatabase such as procedural ones. Doesn't change the status.
+	void SetAnimationClips(std::vector<AnimationClipData> clips, std::vector<cd::Matrix4x4> boneOffsets);
+
+	// Skeleton which was compiled before, e.g. stored in a scene snapshot. Builds without a SceneDatabase.
+	void SetSkeletonData(std::vector<cd::Matrix4x4> boneOffsets, std::vector<uint32_t> boneParentIndices, std::vector<AnimationClipData> clips);
+
+	// Compiles bones and clips from the SceneDatabase without changing the resource. Returns false without a SceneDatabase.
+	bool CompileAnimationData(std::vector<cd::Matrix4x4>& boneOffsets, std::vector<uint32_t>& boneParentIndices, std::vector<AnimationClipData>& clips) const;
+
+	// Off by default. Applies to clips which are compiled after it is set.
+	void SetAnimationCompressionEnabled(bool enabled) { m_isAnimationCompressionEnabled = enabled; }
+	bool IsAnimationCompressionEnabled() const { return m_isAnimationCompressionEnabled; }
+	void SetAnimationCompressionSettings(const AnimationCompressionSettings& settings) { m_animationCompressionSettings = settings; }
+	const AnimationCompressionSettings& GetAnimationCompressionSettings() const { return m_animationCompressionSettings; }
+
 private:
 	void BuildSkeletonBuffer();
+	void BuildSkeletonBufferFromBones();
+	void BuildAnimationData();
 	void SubmitVertexBuffer();
 	void SubmitIndexBuffer();
 	void ClearSkeletonData();
@@ -49,7 +76,7 @@ private:
 
 private:
 	// Asset
-	const cd::SceneDatabase* m_pSceneDatabase;
+	const cd::SceneDatabase* m_pSceneDatabase = nullptr;
 	uint32_t m_boneCount = 0U;
 
 	// Runtime
@@ -60,6 +87,13 @@ private:
 	IndexBuffer m_indexBuffer;
 	uint32_t m_recycleCount = 0;
 
+	// Kept after optimizing CPU data as renderers sample them every frame.
+	std::vector<AnimationClipData> m_animationClips;
+	std::vector<cd::Matrix4x4> m_boneOffsets;
+	std::vector<uint32_t> m_boneParentIndices;
+	bool m_isAnimationCompressionEnabled = false;
+	AnimationCompressionSettings m_animationCompressionSettings;
+
 	// GPU
 	uint16_t m_vertexBufferHandle = UINT16_MAX;
 	uint16_t m_indexBufferHandle = UINT16_MAX;
@@ -8,8 +8,6 @@
 #include <bimg/decode.h>
 #include <bx/allocator.h>
 
-#include <format>
-
 namespace details
 {
 
@@ -79,6 +77,7 @@ void TextureResource::UpdateUVMapMode(cd::TextureMapMode u, cd::TextureMapMode v
 {
 	m_uvMapMode[0] = u;
 	m_uvMapMode[1] = v;
+	++m_textureHandleGeneration;
 }
 
 void TextureResource::Update()
@@ -115,7 +114,6 @@ void TextureResource::Update()
 	{
 		if (m_textureImageData != nullptr)
 		{
-			BuildSamplerHandle();
 			BuildTextureHandle();
 			m_recycleCount = 0U;
 			SetStatus(ResourceStatus::Ready);
@@ -137,7 +135,6 @@ void TextureResource::Update()
 	}
 	case ResourceStatus::Garbage:
 	{
-		DestroySamplerHandle();
 		DestroyTextureHandle();
 		// CPU data will destroy after deconstructor.
 		SetStatus(ResourceStatus::Destroyed);
@@ -150,25 +147,24 @@ void TextureResource::Update()
 
 void TextureResource::Reset()
 {
-	DestroySamplerHandle();
 	DestroyTextureHandle();
 	FreeTextureData();
 	SetStatus(ResourceStatus::Loading);
 }
 
-uint64_t TextureResource::GetTextureFlags() const
+uint32_t TextureResource::GetSamplerFlags() const
 {
-	uint64_t textureFlags = m_enableSRGB ? BGFX_TEXTURE_SRGB : 0;
+	uint32_t samplerFlags = 0U;
 	switch (m_uvMapMode[0])
 	{
 	case cd::TextureMapMode::Clamp:
-		textureFlags |= BGFX_SAMPLER_U_CLAMP;
+		samplerFlags |= BGFX_SAMPLER_U_CLAMP;
 		break;
 	case cd::TextureMapMode::Mirror:
-		textureFlags |= BGFX_SAMPLER_U_MIRROR;
+		samplerFlags |= BGFX_SAMPLER_U_MIRROR;
 		break;
 	case cd::TextureMapMode::Border:
-		textureFlags |= BGFX_SAMPLER_U_BORDER;
+		samplerFlags |= BGFX_SAMPLER_U_BORDER;
 		break;
 	case cd::TextureMapMode::Wrap:
 	default:
@@ -178,29 +174,26 @@ uint64_t TextureResource::GetTextureFlags() const
 	switch (m_uvMapMode[1])
 	{
 	case cd::TextureMapMode::Clamp:
-		textureFlags |= BGFX_SAMPLER_V_CLAMP;
+		samplerFlags |= BGFX_SAMPLER_V_CLAMP;
 		break;
 	case cd::TextureMapMode::Mirror:
-		textureFlags |= BGFX_SAMPLER_V_MIRROR;
+		samplerFlags |= BGFX_SAMPLER_V_MIRROR;
 		break;
 	case cd::TextureMapMode::Border:
-		textureFlags |= BGFX_SAMPLER_V_BORDER;
+		samplerFlags |= BGFX_SAMPLER_V_BORDER;
 		break;
 	case cd::TextureMapMode::Wrap:
 	default:
 		break;
 	}
 
-	return textureFlags;
+	return samplerFlags;
 }
 
-void TextureResource::BuildSamplerHandle()
+uint64_t TextureResource::GetTextureFlags() const
 {
-	assert(m_samplerHandle == UINT16_MAX);
-	static int textureIndex = 0;
-	std::string samplerUniformName = std::format("s_textureSampler{}", textureIndex++);
-	m_samplerHandle = bgfx::createUniform(samplerUniformName.c_str(), bgfx::UniformType::Sampler).idx;
-	assert(m_samplerHandle != UINT16_MAX);
+	uint64_t textureFlags = m_enableSRGB ? BGFX_TEXTURE_SRGB : 0;
+	return textureFlags | GetSamplerFlags();
 }
 
 void TextureResource::BuildTextureHandle()
@@ -208,9 +201,11 @@ void TextureResource::BuildTextureHandle()
 	assert(m_textureHandle == UINT16_MAX);
 	auto* pImageContainer = reinterpret_cast<bimg::ImageContainer*>(m_textureImageData);
 	const bgfx::Memory* pImageContent = bgfx::makeRef(pImageContainer->m_data, pImageContainer->m_size);
+	// Packed material textures are stored as 2D texture arrays.
 	m_textureHandle = details::BGFXCreateTexture(pImageContainer->m_width, pImageContainer->m_height, pImageContainer->m_depth, false, pImageContainer->m_numMips > 1,
-		1, static_cast<bgfx::TextureFormat::Enum>(pImageContainer->m_format), GetTextureFlags(), pImageContent).idx;
+		pImageContainer->m_numLayers, static_cast<bgfx::TextureFormat::Enum>(pImageContainer->m_format), GetTextureFlags(), pImageContent).idx;
 	assert(m_textureHandle != UINT16_MAX);
+	++m_textureHandleGeneration;
 }
 
 void TextureResource::ClearTextureData()
@@ -230,21 +225,13 @@ void TextureResource::FreeTextureData()
 	TextureRawData().swap(m_textureRawData);
 }
 
-void TextureResource::DestroySamplerHandle()
-{
-	if (m_samplerHandle != UINT16_MAX)
-	{
-		bgfx::destroy(bgfx::UniformHandle{ m_samplerHandle });
-		m_samplerHandle = UINT16_MAX;
-	}
-}
-
 void TextureResource::DestroyTextureHandle()
 {
 	if (m_textureHandle != UINT16_MAX)
 	{
 		bgfx::destroy(bgfx::TextureHandle{ m_textureHandle });
 		m_textureHandle = UINT16_MAX;
+		++m_textureHandleGeneration;
 	}
 }
 
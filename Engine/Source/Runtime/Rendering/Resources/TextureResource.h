@@ -35,26 +35,32 @@ public:
 
 	// TODO : Move resource builder to engine and aync build not to block main thread.
 	void SetDDSBuiltTexturePath(std::string ddsFilePath);
+	const std::string& GetDDSBuiltTexturePath() const { return m_ddsFilePath; }
 
 	void UpdateTextureType(cd::MaterialPropertyGroup textureType);
 	void UpdateUVMapMode(cd::TextureMapMode u, cd::TextureMapMode v);
+	bool IsSRGBEnabled() const { return m_enableSRGB; }
+	void SetSRGBEnabled(bool enable) { m_enableSRGB = enable; }
+	cd::TextureMapMode GetUMapMode() const { return m_uvMapMode[0]; }
+	cd::TextureMapMode GetVMapMode() const { return m_uvMapMode[1]; }
 
 	const cd::Texture* GetTextureAsset() const { return m_pTextureAsset; }
 	void SetTextureAsset(const cd::Texture* pTextureAsset);
 
-	uint16_t GetSamplerHandle() const { return m_samplerHandle; }
+	// Sampler uniforms are shared by slot in RenderContext. Texture only provides its filtering and address modes.
+	uint32_t GetSamplerFlags() const;
 	uint16_t GetTextureHandle() const { return m_textureHandle; }
+	// Changes whenever the handle is created or destroyed, or sampler flags change. Cached handles compare it to detect rebuilds.
+	uint32_t GetTextureHandleGeneration() const { return m_textureHandleGeneration; }
 
 private:
 	uint64_t GetTextureFlags() const;
 
-	void BuildSamplerHandle();
 	void BuildTextureHandle();
 
 	void ClearTextureData();
 	void FreeTextureData();
 
-	void DestroySamplerHandle();
 	void DestroyTextureHandle();
 
 private:
@@ -72,8 +78,8 @@ private:
 	uint32_t m_recycleCount = 0;
 
 	// GPU
-	uint16_t m_samplerHandle = UINT16_MAX;
 	uint16_t m_textureHandle = UINT16_MAX;
+	uint32_t m_textureHandleGeneration = 0U;
 };
 
 }
\ No newline at end of file
@@ -19,6 +19,7 @@ enum class ShaderFeature : uint32_t
 	NORMAL_MAP,
 	ORM_MAP,
 	EMISSIVE_MAP,
+	TEXTURE_ARRAY,
 
 	// Techniques
 	IBL,
@@ -37,6 +38,7 @@ constexpr const char* ShaderFeatureNames[] =
 	"NORMALMAP;",
 	"ORMMAP;",
 	"EMISSIVEMAP;",
+	"TEXTUREARRAY;",
 	"IBL;",
 	"PARTICLEINSTANCE;",
 	"ATM;",
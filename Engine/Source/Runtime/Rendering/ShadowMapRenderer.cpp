@@ -10,6 +10,7 @@
 #include "Math/Transform.hpp"
 #include "Rendering/RenderContext.h"
 #include "Rendering/Resources/MeshResource.h"
+#include "Rendering/Resources/ResourceContext.h"
 #include "Rendering/Resources/ShaderResource.h"
 
 #include <string>
@@ -23,7 +24,6 @@ namespace
 constexpr const char* cameraPos                   = "u_cameraPos";
 constexpr const char* lightCountAndStride         = "u_lightCountAndStride";
 constexpr const char* lightParams                 = "u_lightParams";
-constexpr const char* lightPosAndFarPlane         = "u_lightWorldPos_farPlane";
 constexpr const char* lightDir                    = "u_LightDir";
 constexpr const char* heightOffsetAndshadowLength = "u_HeightOffsetAndshadowLength";
 
@@ -48,7 +48,7 @@ void ShadowMapRenderer::Init()
 		}
 	}
 
-	GetRenderContext()->CreateUniform(lightPosAndFarPlane, bgfx::UniformType::Vec4, 1);
+	m_lightPosAndFarPlane.Init(GetRenderContext());
 }
 
 void ShadowMapRenderer::UpdateView(const float* pViewMatrix, const float* pProjectionMatrix)
@@ -58,12 +58,29 @@ void ShadowMapRenderer::UpdateView(const float* pViewMatrix, const float* pProje
 
 void ShadowMapRenderer::Render(float deltaTime)
 {
+	if (!PrepareRecord(deltaTime))
+	{
+		return;
+	}
+
+	bgfx::Encoder* pEncoder = bgfx::begin();
+	for (uint32_t passIndex = 0U; passIndex < m_shadowPassCount; ++passIndex)
+	{
+		Record(pEncoder, passIndex);
+	}
+}
+
+bool ShadowMapRenderer::PrepareRecord(float deltaTime)
+{
+	m_shadowPassCount = 0U;
+	m_shadowCasters.clear();
+
 	for (const auto pResource : m_dependentShaderResources)
 	{
 		if (ResourceStatus::Ready != pResource->GetStatus() &&
 			ResourceStatus::Optimized != pResource->GetStatus())
 		{
-			return;
+			return false;
 		}
 	}
 
@@ -75,6 +92,40 @@ void ShadowMapRenderer::Render(float deltaTime)
 
 	if (!lightEntities.empty())
 	{
+		// Shadow casters are shared by all shadow passes.
+		for (Entity entity : m_pCurrentSceneWorld->GetMaterialEntities())
+		{
+			// No mesh attached?
+			const StaticMeshComponent* pMeshComponent = m_pCurrentSceneWorld->GetStaticMeshComponent(entity);
+			if (!pMeshComponent)
+			{
+				continue;
+			}
+			const MeshResource* pMeshResource = pMeshComponent->GetMeshResource();
+			if (ResourceStatus::Ready != pMeshResource->GetStatus() &&
+				ResourceStatus::Optimized != pMeshResource->GetStatus())
+			{
+				continue;
+			}
+
+			ShadowCaster& caster = m_shadowCasters.emplace_back();
+			caster.pMeshComponent = pMeshComponent;
+			caster.hasWorldMatrix = false;
+			if (const TransformComponent* pTransformComponent = m_pCurrentSceneWorld->GetTransformComponent(entity))
+			{
+				caster.worldMatrix = pTransformComponent->GetWorldMatrix();
+				caster.hasWorldMatrix = true;
+			}
+			caster.isBlendShape = nullptr != m_pCurrentSceneWorld->GetBlendShapeComponent(entity);
+			const SkeletonComponent* pSkeletonComponent = m_pCurrentSceneWorld->GetSkeletonComponent(entity);
+			caster.skinnedVertexBuffer = pSkeletonComponent ? pSkeletonComponent->GetSkinnedVertexBuffer() : UINT16_MAX;
+		}
+
+		constexpr StringCrc shadowMapProgram{ "ShadowMapProgram" };
+		constexpr StringCrc linearShadowMapProgram{ "LinearShadowMapProgram" };
+		const uint16_t shadowMapProgramHandle = GetRenderContext()->GetResourceContext()->GetShaderResource(shadowMapProgram)->GetHandle();
+		const uint16_t linearShadowMapProgramHandle = GetRenderContext()->GetResourceContext()->GetShaderResource(linearShadowMapProgram)->GetHandle();
+
 		// camera 
 		CameraComponent* pMainCameraComponent = m_pCurrentSceneWorld->GetCameraComponent(m_pCurrentSceneWorld->GetMainCameraEntity());
 		const cd::Matrix4x4 camView = pMainCameraComponent->GetViewMatrix();
@@ -157,19 +208,14 @@ void ShadowMapRenderer::Render(float deltaTime)
 
 				// Compute the frustum according to ndc depth of different graphic backends
 				cd::Direction lightDirection = lightComponent->GetDirection();
-				std::vector<cd::Point> frustumCorners = ndcDepthMinusOneToOne ? 
-					std::vector<cd::Point>{		 // Depth [-1, 1]
-						UnProject(cd::Vec4f(-1, -1,  -1, 1)),	UnProject(cd::Vec4f(-1, -1, 1, 1)),	// lower-left near and far 
-						UnProject(cd::Vec4f(-1,  1,  -1, 1)),	UnProject(cd::Vec4f(-1,  1, 1, 1)),	// upper-left near and far 
-						UnProject(cd::Vec4f( 1, -1,  -1, 1)),	UnProject(cd::Vec4f( 1, -1, 1, 1)),	//	lower-right near and far 
-						UnProject(cd::Vec4f( 1,  1,  -1, 1)),	UnProject(cd::Vec4f( 1,  1, 1, 1))		// upper-right near and far
-					} :
-					std::vector<cd::Point>{		// Depth [0, 1]
-						UnProject(cd::Vec4f(-1, -1,  0, 1)),	UnProject(cd::Vec4f(-1, -1, 1, 1)),	// lower-left near and far 
-						UnProject(cd::Vec4f(-1,  1,  0, 1)),	UnProject(cd::Vec4f(-1,  1, 1, 1)),	// upper-left near and far 
-						UnProject(cd::Vec4f( 1, -1,  0, 1)),	UnProject(cd::Vec4f( 1, -1, 1, 1)),	//	lower-right near and far 
-						UnProject(cd::Vec4f( 1,  1,  0, 1)),	UnProject(cd::Vec4f( 1,  1, 1, 1))		// upper-right near and far
-					};
+				// Corners are a fixed size array so that no heap memory is needed per light.
+				const float ndcNear = ndcDepthMinusOneToOne ? -1.0f : 0.0f;
+				const cd::Point frustumCorners[8] = {
+					UnProject(cd::Vec4f(-1, -1, ndcNear, 1)),	UnProject(cd::Vec4f(-1, -1, 1, 1)),	// lower-left near and far 
+					UnProject(cd::Vec4f(-1,  1, ndcNear, 1)),	UnProject(cd::Vec4f(-1,  1, 1, 1)),	// upper-left near and far 
+					UnProject(cd::Vec4f( 1, -1, ndcNear, 1)),	UnProject(cd::Vec4f( 1, -1, 1, 1)),	//	lower-right near and far 
+					UnProject(cd::Vec4f( 1,  1, ndcNear, 1)),	UnProject(cd::Vec4f( 1,  1, 1, 1))		// upper-right near and far
+				};
 
 				// Set cascade split dividing values for choosing cascade level in world renderer
 				lightComponent->SetComputedCascadeSplit(&CascadeSplits[0]);
@@ -218,8 +264,6 @@ void ShadowMapRenderer::Render(float deltaTime)
 						0, ndcDepthMinusOneToOne);
 
 					// Settings
-					bgfx::setState(defaultRenderingState);
-
 					uint16_t viewId = m_renderPassID[shadowNum * shadowTexturePassMaxNum + cascadeIndex];
 					bgfx::setViewRect(viewId, 0, 0, lightComponent->GetShadowMapSize(), lightComponent->GetShadowMapSize());
 					bgfx::setViewFrameBuffer(viewId, static_cast<bgfx::FrameBufferHandle>(lightComponent->GetShadowMapFBs().at(cascadeIndex)));
@@ -231,37 +275,7 @@ void ShadowMapRenderer::Render(float deltaTime)
 					lightComponent->AddLightViewProjMatrix(lightCSMViewProj);
 
 					// Submit draw call (TODO : one pass MRT
-					for (Entity entity : m_pCurrentSceneWorld->GetMaterialEntities())
-					{
-						// No mesh attached?
-						StaticMeshComponent* pMeshComponent = m_pCurrentSceneWorld->GetStaticMeshComponent(entity);
-						if (!pMeshComponent)
-						{
-							continue;
-						}
-						const MeshResource* pMeshResource = pMeshComponent->GetMeshResource();
-						if (ResourceStatus::Ready != pMeshResource->GetStatus() &&
-							ResourceStatus::Optimized != pMeshResource->GetStatus())
-						{
-							continue;
-						}
-
-						BlendShapeComponent* pBlendShapeComponent = m_pCurrentSceneWorld->GetBlendShapeComponent(entity);
-						if (pBlendShapeComponent)
-						{
-							continue;
-						}
-
-						// Transform
-						if (TransformComponent* pTransformComponent = m_pCurrentSceneWorld->GetTransformComponent(entity))
-						{
-							bgfx::setTransform(pTransformComponent->GetWorldMatrix().begin());
-						}
-
-						// Mesh
-						constexpr StringCrc programHandleIndex{ "ShadowMapProgram" };
-						SubmitStaticMeshDrawCall(pMeshComponent, viewId, programHandleIndex);
-					}
+					AddShadowPass(viewId, shadowMapProgramHandle, true);
 				}
 			}
 			break;
@@ -299,8 +313,6 @@ void ShadowMapRenderer::Render(float deltaTime)
 				};
 				cd::Matrix4x4 lightProjection = cd::Matrix4x4::Perspective(90.0f, 1.0f, 0.01f, range, ndcDepthMinusOneToOne);
 
-				// Settings
-				bgfx::setState(defaultRenderingState);
 				// 6 faces
 				for (uint16_t i = 0U; i < 6U; ++i)
 				{
@@ -311,36 +323,11 @@ void ShadowMapRenderer::Render(float deltaTime)
 					bgfx::setViewClear(viewId, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, 0xffffffff, 1.0f, 0);
 					bgfx::setViewTransform(viewId, lightView[i].begin(), lightProjection.begin());
 
-					constexpr StringCrc lightPosAndFarPlaneCrc(lightPosAndFarPlane);
-					cd::Vec4f lightPosAndFarPlaneData = cd::Vec4f(lightComponent->GetPosition().x(), lightComponent->GetPosition().y(),
-						lightComponent->GetPosition().z(), lightComponent->GetRange());
-					GetRenderContext()->FillUniform(lightPosAndFarPlaneCrc, &lightPosAndFarPlaneData, 1);
-
 					// Submit draw call
-					for (Entity entity : m_pCurrentSceneWorld->GetMaterialEntities())
-					{
-						// No mesh attached?
-						StaticMeshComponent* pMeshComponent = m_pCurrentSceneWorld->GetStaticMeshComponent(entity);
-						if (!pMeshComponent)
-						{
-							continue;
-						}
-						const MeshResource* pMeshResource = pMeshComponent->GetMeshResource();
-						if (ResourceStatus::Ready != pMeshResource->GetStatus() &&
-							ResourceStatus::Optimized != pMeshResource->GetStatus())
-						{
-							continue;
-						}
-
-						// Transform
-						if (TransformComponent* pTransformComponent = m_pCurrentSceneWorld->GetTransformComponent(entity))
-						{
-							bgfx::setTransform(pTransformComponent->GetWorldMatrix().begin());
-						}
-
-						constexpr StringCrc programHandleIndex{ "LinearShadowMapProgram" };
-						SubmitStaticMeshDrawCall(pMeshComponent, viewId, programHandleIndex);
-					}
+					ShadowPass& shadowPass = AddShadowPass(viewId, linearShadowMapProgramHandle, false);
+					shadowPass.hasLightPosAndFarPlane = true;
+					shadowPass.lightPosAndFarPlane = cd::Vec4f(lightComponent->GetPosition().x(), lightComponent->GetPosition().y(),
+						lightComponent->GetPosition().z(), lightComponent->GetRange());
 				}
 			}
 			break;
@@ -364,8 +351,6 @@ void ShadowMapRenderer::Render(float deltaTime)
 				cd::Matrix4x4 lightProjection = cd::Matrix4x4::Perspective(2.0f*lightComponent->GetInnerAndOuter().y(), 1.0f, 0.1f, range, ndcDepthMinusOneToOne);
 
 				// Settings
-				uint64_t state = defaultRenderingState;
-				bgfx::setState(state);
 				uint16_t viewId = m_renderPassID[shadowNum * shadowTexturePassMaxNum + 0];
 				bgfx::setViewRect(viewId, 0, 0, lightComponent->GetShadowMapSize(), lightComponent->GetShadowMapSize());
 				bgfx::setViewFrameBuffer(viewId, static_cast<bgfx::FrameBufferHandle>(lightComponent->GetShadowMapFBs().at(0)));
@@ -378,37 +363,7 @@ void ShadowMapRenderer::Render(float deltaTime)
 				lightComponent->AddLightViewProjMatrix(lightCSMViewProj);
 
 				// Submit draw call
-				for (Entity entity : m_pCurrentSceneWorld->GetMaterialEntities())
-				{
-					// No mesh attached?
-					StaticMeshComponent* pMeshComponent = m_pCurrentSceneWorld->GetStaticMeshComponent(entity);
-					if (!pMeshComponent)
-					{
-						continue;
-					}
-					const MeshResource* pMeshResource = pMeshComponent->GetMeshResource();
-					if (ResourceStatus::Ready != pMeshResource->GetStatus() &&
-						ResourceStatus::Optimized != pMeshResource->GetStatus())
-					{
-						continue;
-					}
-
-					BlendShapeComponent* pBlendShapeComponent = m_pCurrentSceneWorld->GetBlendShapeComponent(entity);
-					if (pBlendShapeComponent)
-					{
-						continue;
-					}
-
-					// Transform
-					if (TransformComponent* pTransformComponent = m_pCurrentSceneWorld->GetTransformComponent(entity))
-					{
-						bgfx::setTransform(pTransformComponent->GetWorldMatrix().begin());
-					}
-
-					// Mesh
-					constexpr StringCrc programHandleIndex{ "ShadowMapProgram" };
-					SubmitStaticMeshDrawCall(pMeshComponent, viewId, programHandleIndex);
-				}
+				AddShadowPass(viewId, shadowMapProgramHandle, true);
 			}
 			break;
 			}
@@ -420,6 +375,53 @@ void ShadowMapRenderer::Render(float deltaTime)
 			}
 		}
 	}
+
+	return m_shadowPassCount > 0U;
+}
+
+ShadowMapRenderer::ShadowPass& ShadowMapRenderer::AddShadowPass(uint16_t viewID, uint16_t programHandle, bool skipBlendShape)
+{
+	assert(m_shadowPassCount < shadowLightMaxNum * shadowTexturePassMaxNum);
+	ShadowPass& shadowPass = m_shadowPasses[m_shadowPassCount++];
+	shadowPass.viewID = viewID;
+	shadowPass.programHandle = programHandle;
+	shadowPass.skipBlendShape = skipBlendShape;
+	shadowPass.hasLightPosAndFarPlane = false;
+	return shadowPass;
+}
+
+void ShadowMapRenderer::Record(bgfx::Encoder* pEncoder, uint32_t taskIndex)
+{
+	// Only reads data which PrepareRecord filled so it is safe to run on any job thread.
+	const ShadowPass& shadowPass = m_shadowPasses[taskIndex];
+	if (shadowPass.hasLightPosAndFarPlane)
+	{
+		m_lightPosAndFarPlane.Set(pEncoder, &shadowPass.lightPosAndFarPlane);
+	}
+
+	for (const ShadowCaster& caster : m_shadowCasters)
+	{
+		if (shadowPass.skipBlendShape && caster.isBlendShape)
+		{
+			continue;
+		}
+
+		// Transform
+		if (caster.hasWorldMatrix)
+		{
+			pEncoder->setTransform(caster.worldMatrix.begin());
+		}
+
+		// Mesh
+		if (UINT16_MAX != caster.skinnedVertexBuffer)
+		{
+			SubmitSkinnedMeshDrawCall(pEncoder, caster.pMeshComponent, caster.skinnedVertexBuffer, shadowPass.viewID, shadowPass.programHandle, defaultRenderingState);
+		}
+		else
+		{
+			SubmitStaticMeshDrawCall(pEncoder, caster.pMeshComponent, shadowPass.viewID, shadowPass.programHandle, defaultRenderingState);
+		}
+	}
 }
 
 }
\ No newline at end of file
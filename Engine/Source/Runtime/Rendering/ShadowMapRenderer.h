@@ -1,6 +1,11 @@
 #pragma once
 
+#include "Math/Matrix.hpp"
+#include "Math/Vector.hpp"
 #include "Renderer.h"
+#include "UniformSlot.h"
+
+#include <vector>
 
 namespace engine
 {
@@ -11,6 +16,7 @@ constexpr uint16_t shadowTexturePassMaxNum = 6U;
 }
 
 class SceneWorld;
+class StaticMeshComponent;
 
 class ShadowMapRenderer final : public Renderer
 {
@@ -21,11 +27,46 @@ public:
 	virtual void UpdateView(const float* pViewMatrix, const float* pProjectionMatrix) override;
 	virtual void Render(float deltaTime) override;
 
+	// Every cascade, cube face and spot light view is one record task.
+	virtual bool IsParallelRecordSupported() const override { return true; }
+	virtual bool PrepareRecord(float deltaTime) override;
+	virtual uint32_t GetRecordTaskCount() const override { return m_shadowPassCount; }
+	virtual void Record(bgfx::Encoder* pEncoder, uint32_t taskIndex) override;
+
 	void SetSceneWorld(SceneWorld* pSceneWorld) { m_pCurrentSceneWorld = pSceneWorld; }
 
+private:
+	struct ShadowPass
+	{
+		uint16_t viewID;
+		uint16_t programHandle;
+		bool skipBlendShape;
+		bool hasLightPosAndFarPlane;
+		cd::Vec4f lightPosAndFarPlane;
+	};
+
+	struct ShadowCaster
+	{
+		const StaticMeshComponent* pMeshComponent;
+		cd::Matrix4x4 worldMatrix;
+		bool hasWorldMatrix;
+		bool isBlendShape;
+		// Pre-skinned vertices so that skinned meshes cast shadows in their current pose.
+		uint16_t skinnedVertexBuffer;
+	};
+
+	ShadowPass& AddShadowPass(uint16_t viewID, uint16_t programHandle, bool skipBlendShape);
+
 private:
 	SceneWorld* m_pCurrentSceneWorld = nullptr;
 	uint16_t m_renderPassID[18];
+
+	Vec4Uniform<"u_lightWorldPos_farPlane"> m_lightPosAndFarPlane;
+
+	// Filled in PrepareRecord on the main thread and read only while recording.
+	ShadowPass m_shadowPasses[shadowLightMaxNum * shadowTexturePassMaxNum];
+	uint32_t m_shadowPassCount = 0U;
+	std::vector<ShadowCaster> m_shadowCasters;
 };
 
 }
\ No newline at end of file
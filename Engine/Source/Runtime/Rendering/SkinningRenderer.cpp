@@ -0,0 +1,282 @@
+#include "SkinningRenderer.h"
+
+#include "Animation/PoseEvaluator.h"
+#include "Animation/VertexSkinning.h"
+#include "Core/Jobs/JobSystem.h"
+#include "Core/Memory/FrameArena.h"
+#include "Core/StringCrc.h"
+#include "ECWorld/SceneWorld.h"
+#include "ECWorld/StaticMeshComponent.h"
+#include "Log/Log.h"
+#include "Profiling/Profile.h"
+#include "Rendering/RenderContext.h"
+#include "Rendering/Resources/MeshResource.h"
+#include "Rendering/Resources/ShaderResource.h"
+#include "U_Skinning.sh"
+
+#include <algorithm>
+#include <cstring>
+
+namespace engine
+{
+
+namespace
+{
+
+constexpr uint64_t bonePaletteFlags = BGFX_SAMPLER_POINT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP;
+
+// Buffers of entities which were not skinned for this many frames are destroyed.
+constexpr uint32_t unusedFramesBeforeDestroy = 60U;
+
+static_assert(SkinningPalette::TextureWidth == BONE_PALETTE_WIDTH, "Bone palette width mismatch between shaders and engine.");
+
+bool IsResourceReady(const IResource* pResource)
+{
+	return ResourceStatus::Ready == pResource->GetStatus() || ResourceStatus::Optimized == pResource->GetStatus();
+}
+
+struct CpuSkinningTask
+{
+	const SkinningVertex* pVertices;
+	uint32_t vertexCount;
+	uint32_t firstTexel;
+	SkinningMode mode;
+	uint16_t vertexBufferHandle;
+	const bgfx::Memory* pMemory;
+};
+
+}
+
+SkinningRenderer::~SkinningRenderer()
+{
+	for (const auto& [entity, skinnedVertexBuffer] : m_skinnedVertexBuffers)
+	{
+		bgfx::destroy(bgfx::DynamicVertexBufferHandle{ skinnedVertexBuffer.handle });
+	}
+}
+
+void SkinningRenderer::Init()
+{
+	bgfx::setViewName(GetViewID(), "SkinningRenderer");
+
+	m_bonePaletteSampler.Init(GetRenderContext());
+	m_skinningParams.Init(GetRenderContext());
+
+	const bgfx::Caps* pCaps = bgfx::getCaps();
+	m_isComputeSupported = 0U != (pCaps->supported & BGFX_CAPS_COMPUTE);
+	if (m_isComputeSupported)
+	{
+		m_pSkinningShaderResource = GetRenderContext()->RegisterShaderProgram("SkinningProgram", "cs_skinning", ShaderProgramType::Compute);
+	}
+
+	// Vertex shaders and cs_skinning read bone palettes from a float texture. CPU pre-skinning reads them from memory.
+	const bool isVertexTextureSupported = 0U != (pCaps->formats[bgfx::TextureFormat::RGBA32F] & BGFX_CAPS_FORMAT_TEXTURE_VERTEX);
+	m_isBonePaletteTextureUsed = m_isComputeSupported || isVertexTextureSupported;
+}
+
+void SkinningRenderer::UpdateView(const float* pViewMatrix, const float* pProjectionMatrix)
+{
+	// Only compute dispatches in this view. The camera selects animation LODs.
+	std::memcpy(&m_viewMatrix, pViewMatrix, sizeof(cd::Matrix4x4));
+	std::memcpy(&m_projectionMatrix, pProjectionMatrix, sizeof(cd::Matrix4x4));
+}
+
+void SkinningRenderer::Render(float deltaTime)
+{
+	// Poses of all characters are evaluated in parallel into their own SkeletonComponent.
+	if (m_isAnimationLodEnabled)
+	{
+		// ShadowMapRenderer draws every mesh into the shadow maps of every light.
+		const bool hasShadowCasters = !m_pCurrentSceneWorld->GetLightEntities().empty();
+		const AnimationLodView lodView{ m_viewMatrix, m_projectionMatrix, m_frameIndex, deltaTime, hasShadowCasters };
+		PoseEvaluator::EvaluateAll(m_pCurrentSceneWorld, &lodView, m_animationLodSettings);
+	}
+	else
+	{
+		PoseEvaluator::EvaluateAll(m_pCurrentSceneWorld);
+	}
+
+	if (!UpdateBonePalette())
+	{
+		return;
+	}
+
+	UpdateSkinnedVertexBuffers();
+}
+
+bool SkinningRenderer::UpdateBonePalette()
+{
+	m_bonePalette.Reset();
+	for (Entity entity : m_pCurrentSceneWorld->GetAnimationEntities())
+	{
+		SkeletonComponent* pSkeletonComponent = m_pCurrentSceneWorld->GetSkeletonComponent(entity);
+		if (!pSkeletonComponent)
+		{
+			continue;
+		}
+
+		const std::vector<cd::Matrix4x4>& skinningMatrices = pSkeletonComponent->GetSkinningMatrices();
+		pSkeletonComponent->SetBonePaletteTexel(skinningMatrices.empty() ? UINT32_MAX :
+			m_bonePalette.Append(skinningMatrices.data(), static_cast<uint32_t>(skinningMatrices.size()), pSkeletonComponent->GetSkinningMode()));
+		pSkeletonComponent->SetSkinnedVertexBuffer(UINT16_MAX);
+	}
+
+	if (!m_isBonePaletteTextureUsed)
+	{
+		return true;
+	}
+
+	const uint32_t rowCount = std::max(m_bonePalette.GetRowCount(), 1U);
+	if (rowCount > m_bonePaletteRowCount)
+	{
+		// Grows by power of two so that the texture is rarely created again when characters are added.
+		uint32_t textureRowCount = std::max(m_bonePaletteRowCount, 1U);
+		while (textureRowCount < rowCount)
+		{
+			textureRowCount *= 2U;
+		}
+
+		if (textureRowCount > bgfx::getCaps()->limits.maxTextureSize)
+		{
+			CD_ENGINE_ERROR("Bone palette needs {0} rows which is more than the max texture size.", textureRowCount);
+			return false;
+		}
+
+		GetRenderContext()->DestoryTexture(StringCrc(BonePaletteTextureName));
+		GetRenderContext()->CreateTexture(BonePaletteTextureName, static_cast<uint16_t>(SkinningPalette::TextureWidth), static_cast<uint16_t>(textureRowCount),
+			1U, bgfx::TextureFormat::RGBA32F, bonePaletteFlags);
+		m_bonePaletteRowCount = textureRowCount;
+	}
+
+	// Palette memory is reused next frame so it is copied instead of referenced.
+	if (m_bonePalette.GetTexelCount() > 0U)
+	{
+		bgfx::updateTexture2D(GetRenderContext()->GetTexture(StringCrc(BonePaletteTextureName)), 0U, 0U, 0U, 0U,
+			static_cast<uint16_t>(SkinningPalette::TextureWidth), static_cast<uint16_t>(m_bonePalette.GetRowCount()),
+			bgfx::copy(m_bonePalette.GetData(), m_bonePalette.GetDataSize()));
+	}
+
+	return true;
+}
+
+void SkinningRenderer::UpdateSkinnedVertexBuffers()
+{
+	CD_PROFILE_ZONE("PreSkinning");
+
+	++m_frameIndex;
+	if (m_isPreSkinningEnabled)
+	{
+		const bool isComputeReady = m_pSkinningShaderResource && IsResourceReady(m_pSkinningShaderResource);
+		const bgfx::TextureHandle bonePaletteTexture = GetRenderContext()->GetTexture(StringCrc(BonePaletteTextureName));
+
+		FrameVector<CpuSkinningTask> cpuTasks;
+		for (Entity entity : m_pCurrentSceneWorld->GetAnimationEntities())
+		{
+			SkeletonComponent* pSkeletonComponent = m_pCurrentSceneWorld->GetSkeletonComponent(entity);
+			const StaticMeshComponent* pMeshComponent = m_pCurrentSceneWorld->GetStaticMeshComponent(entity);
+			if (!pSkeletonComponent || !pMeshComponent || UINT32_MAX == pSkeletonComponent->GetBonePaletteTexel())
+			{
+				continue;
+			}
+
+			const MeshResource* pMeshResource = pMeshComponent->GetMeshResource();
+			if (!pMeshResource || !IsResourceReady(pMeshResource))
+			{
+				continue;
+			}
+
+			const uint32_t vertexCount = pMeshResource->GetVertexCount();
+			if (m_isComputeSupported)
+			{
+				// Before the program is ready meshes are skinned in vertex shaders.
+				if (!isComputeReady || UINT16_MAX == pMeshResource->GetSkinningVertexBufferHandle())
+				{
+					continue;
+				}
+
+				const uint16_t skinnedVertexBuffer = GetSkinnedVertexBuffer(entity, vertexCount);
+				const float skinningParams[4] = { static_cast<float>(pSkeletonComponent->GetBonePaletteTexel()),
+					SkinningMode::DualQuaternion == pSkeletonComponent->GetSkinningMode() ? 1.0f : 0.0f, 0.0f, static_cast<float>(vertexCount) };
+				bgfx::setBuffer(SKINNING_VERTEX_STAGE, bgfx::VertexBufferHandle{ pMeshResource->GetSkinningVertexBufferHandle() }, bgfx::Access::Read);
+				bgfx::setBuffer(SKINNED_VERTEX_STAGE, bgfx::DynamicVertexBufferHandle{ skinnedVertexBuffer }, bgfx::Access::Write);
+				m_bonePaletteSampler.Bind(BONE_PALETTE_SLOT, bonePaletteTexture);
+				m_skinningParams.Set(skinningParams);
+				GetRenderContext()->Dispatch(GetViewID(), m_pSkinningShaderResource->GetHandle(), (vertexCount + SKINNING_THREAD_COUNT - 1U) / SKINNING_THREAD_COUNT, 1U, 1U);
+				pSkeletonComponent->SetSkinnedVertexBuffer(skinnedVertexBuffer);
+			}
+			else
+			{
+				const std::vector<SkinningVertex>& skinningVertices = pMeshResource->GetSkinningVertices();
+				if (skinningVertices.size() != vertexCount)
+				{
+					continue;
+				}
+
+				// bgfx memory is allocated on the main thread and filled on job threads.
+				const uint16_t skinnedVertexBuffer = GetSkinnedVertexBuffer(entity, vertexCount);
+				cpuTasks.push_back({ skinningVertices.data(), vertexCount, pSkeletonComponent->GetBonePaletteTexel(), pSkeletonComponent->GetSkinningMode(),
+					skinnedVertexBuffer, bgfx::alloc(vertexCount * static_cast<uint32_t>(sizeof(SkinnedVertex))) });
+				pSkeletonComponent->SetSkinnedVertexBuffer(skinnedVertexBuffer);
+			}
+		}
+
+		const float* pPaletteData = m_bonePalette.GetData();
+		JobSystem::Get().ParallelFor(static_cast<uint32_t>(cpuTasks.size()), 1U, [&cpuTasks, pPaletteData](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t taskIndex = begin; taskIndex < end; ++taskIndex)
+			{
+				const CpuSkinningTask& task = cpuTasks[taskIndex];
+				VertexSkinning::SkinVertices(pPaletteData + static_cast<size_t>(task.firstTexel) * 4U, task.mode, task.pVertices, task.vertexCount,
+					reinterpret_cast<SkinnedVertex*>(task.pMemory->data));
+			}
+		});
+
+		for (const CpuSkinningTask& task : cpuTasks)
+		{
+			bgfx::update(bgfx::DynamicVertexBufferHandle{ task.vertexBufferHandle }, 0U, task.pMemory);
+		}
+	}
+
+	// Entities which were removed or are skinned in vertex shaders don't need their buffers anymore.
+	for (auto itBuffer = m_skinnedVertexBuffers.begin(); itBuffer != m_skinnedVertexBuffers.end();)
+	{
+		if (m_frameIndex - itBuffer->second.lastUsedFrame > unusedFramesBeforeDestroy)
+		{
+			bgfx::destroy(bgfx::DynamicVertexBufferHandle{ itBuffer->second.handle });
+			itBuffer = m_skinnedVertexBuffers.erase(itBuffer);
+		}
+		else
+		{
+			++itBuffer;
+		}
+	}
+}
+
+uint16_t SkinningRenderer::GetSkinnedVertexBuffer(Entity entity, uint32_t vertexCount)
+{
+	SkinnedVertexBuffer& skinnedVertexBuffer = m_skinnedVertexBuffers[entity];
+	skinnedVertexBuffer.lastUsedFrame = m_frameIndex;
+	if (UINT16_MAX != skinnedVertexBuffer.handle && vertexCount == skinnedVertexBuffer.vertexCount)
+	{
+		return skinnedVertexBuffer.handle;
+	}
+
+	if (UINT16_MAX != skinnedVertexBuffer.handle)
+	{
+		bgfx::destroy(bgfx::DynamicVertexBufferHandle{ skinnedVertexBuffer.handle });
+	}
+
+	// Same attributes as the mesh vertex buffer so that bgfx takes position and normal from this stream.
+	bgfx::VertexLayout vertexLayout;
+	vertexLayout.begin()
+		.add(bgfx::Attrib::Position, 4, bgfx::AttribType::Float)
+		.add(bgfx::Attrib::Normal, 4, bgfx::AttribType::Float)
+		.end();
+	bgfx::DynamicVertexBufferHandle vertexBufferHandle = bgfx::createDynamicVertexBuffer(vertexCount, vertexLayout, m_isComputeSupported ? BGFX_BUFFER_COMPUTE_WRITE : BGFX_BUFFER_NONE);
+	assert(bgfx::isValid(vertexBufferHandle));
+	skinnedVertexBuffer.handle = vertexBufferHandle.idx;
+	skinnedVertexBuffer.vertexCount = vertexCount;
+	return skinnedVertexBuffer.handle;
+}
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Animation/AnimationLod.h"
+#include "Animation/SkinningPalette.h"
+#include "ECWorld/Entity.h"
+#include "Renderer.h"
+#include "Rendering/UniformSlot.h"
+
+#include <unordered_map>
+
+namespace engine
+{
+
+class SceneWorld;
+class ShaderResource;
+
+// SkinningRenderer evaluates poses of all characters and skins their meshes once per frame before other passes.
+// Skinned positions and normals are written into a dynamic vertex buffer per entity by cs_skinning, or on CPU
+// threads for backends without compute shaders. Shadow, animation and world passes bind it in front of the mesh
+// vertex buffer so they draw skinned meshes like static meshes. Register it before ShadowMapRenderer so its view runs first.
+class SkinningRenderer final : public Renderer
+{
+public:
+	// Bone palettes of all characters in RenderContext so that other passes can skin with them.
+	static constexpr const char* BonePaletteTextureName = "BonePaletteTexture";
+
+public:
+	using Renderer::Renderer;
+	virtual ~SkinningRenderer();
+
+	virtual void Init() override;
+	virtual void UpdateView(const float* pViewMatrix, const float* pProjectionMatrix) override;
+	virtual void Render(float deltaTime) override;
+
+	void SetSceneWorld(SceneWorld* pSceneWorld) { m_pCurrentSceneWorld = pSceneWorld; }
+
+	// When disabled, meshes are skinned in vertex shaders of every pass which allows instancing of characters sharing a mesh.
+	void SetPreSkinningEnabled(bool enabled) { m_isPreSkinningEnabled = enabled; }
+	bool IsPreSkinningEnabled() const { return m_isPreSkinningEnabled; }
+	bool IsComputeSkinningSupported() const { return m_isComputeSupported; }
+
+	// Characters which are small on screen update less often and without leaf bones. Culled ones are not updated.
+	void SetAnimationLodEnabled(bool enabled) { m_isAnimationLodEnabled = enabled; }
+	bool IsAnimationLodEnabled() const { return m_isAnimationLodEnabled; }
+	void SetAnimationLodSettings(const AnimationLodSettings& settings) { m_animationLodSettings = settings; }
+	const AnimationLodSettings& GetAnimationLodSettings() const { return m_animationLodSettings; }
+
+private:
+	struct SkinnedVertexBuffer
+	{
+		uint16_t handle = UINT16_MAX;
+		uint32_t vertexCount = 0U;
+		uint32_t lastUsedFrame = 0U;
+	};
+
+	// Returns false if the palette doesn't fit into a texture.
+	bool UpdateBonePalette();
+	void UpdateSkinnedVertexBuffers();
+	uint16_t GetSkinnedVertexBuffer(Entity entity, uint32_t vertexCount);
+
+private:
+	SceneWorld* m_pCurrentSceneWorld = nullptr;
+	ShaderResource* m_pSkinningShaderResource = nullptr;
+
+	bool m_isPreSkinningEnabled = true;
+	bool m_isAnimationLodEnabled = true;
+	AnimationLodSettings m_animationLodSettings;
+	cd::Matrix4x4 m_viewMatrix = cd::Matrix4x4::Identity();
+	cd::Matrix4x4 m_projectionMatrix = cd::Matrix4x4::Identity();
+	bool m_isComputeSupported = false;
+	bool m_isBonePaletteTextureUsed = false;
+	uint32_t m_bonePaletteRowCount = 0U;
+	SkinningPalette m_bonePalette;
+
+	uint32_t m_frameIndex = 0U;
+	std::unordered_map<Entity, SkinnedVertexBuffer> m_skinnedVertexBuffers;
+
+	SamplerUniform<"s_bonePalette"> m_bonePaletteSampler;
+	Vec4Uniform<"u_skinningParams"> m_skinningParams;
+};
+
+}
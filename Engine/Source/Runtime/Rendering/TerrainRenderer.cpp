@@ -22,35 +22,13 @@ namespace engine
 namespace
 {
 
-constexpr const char* snowSampler = "s_texSnow";
-constexpr const char* rockSampler = "s_texRock";
-constexpr const char* grassSampler = "s_texGrass";
-constexpr const char* elevationSampler = "s_texElevation";
-
 constexpr const char* snowTexture = "Textures/terrain/snow_baseColor.dds";
 constexpr const char* rockTexture = "Textures/terrain/rock_baseColor.dds";
 constexpr const char* grassTexture = "Textures/terrain/grass_baseColor.dds";
 constexpr const char* elevationTexture = "Terrain";
 
-constexpr const char* lutSampler = "s_texLUT";
-constexpr const char* cubeIrradianceSampler = "s_texCubeIrr";
-constexpr const char* cubeRadianceSampler = "s_texCubeRad";
-constexpr const char* iblStrength = "u_iblStrength";
-
 constexpr const char* lutTexture = "Textures/lut/ibl_brdf_lut.dds";
 
-constexpr const char* cameraPos = "u_cameraPos";
-constexpr const char* cameraNearFarPlane = "u_cameraNearFarPlane";
-
-constexpr const char* albedoColor = "u_albedoColor";
-constexpr const char* metallicRoughnessRefectanceFactor = "u_metallicRoughnessRefectanceFactor";
-constexpr const char* albedoUVOffsetAndScale = "u_albedoUVOffsetAndScale";
-constexpr const char* alphaCutOff = "u_alphaCutOff";
-constexpr const char* emissiveColor = "u_emissiveColor";
-
-constexpr const char* lightCountAndStride = "u_lightCountAndStride";
-constexpr const char* lightParams = "u_lightParams";
-
 constexpr uint64_t samplerFlags = BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP | BGFX_SAMPLER_W_CLAMP;
 constexpr uint64_t defaultRenderingState = BGFX_STATE_WRITE_MASK | BGFX_STATE_MSAA | BGFX_STATE_DEPTH_TEST_LESS;
 
@@ -60,10 +38,10 @@ void TerrainRenderer::Init()
 {
 	SkyComponent* pSkyComponent = m_pCurrentSceneWorld->GetSkyComponent(m_pCurrentSceneWorld->GetSkyEntity());
 
-	GetRenderContext()->CreateUniform(snowSampler, bgfx::UniformType::Sampler);
-	GetRenderContext()->CreateUniform(rockSampler, bgfx::UniformType::Sampler);
-	GetRenderContext()->CreateUniform(grassSampler, bgfx::UniformType::Sampler);
-	GetRenderContext()->CreateUniform(elevationSampler, bgfx::UniformType::Sampler);
+	m_snowSampler.Init(GetRenderContext());
+	m_rockSampler.Init(GetRenderContext());
+	m_grassSampler.Init(GetRenderContext());
+	m_elevationSampler.Init(GetRenderContext());
 
 	GetRenderContext()->CreateTexture(snowTexture);
 	GetRenderContext()->CreateTexture(rockTexture);
@@ -73,19 +51,22 @@ void TerrainRenderer::Init()
 	GetRenderContext()->CreateTexture(lutTexture);
 	GetRenderContext()->CreateTexture(pSkyComponent->GetIrradianceTexturePath().c_str(), samplerFlags);
 	GetRenderContext()->CreateTexture(pSkyComponent->GetRadianceTexturePath().c_str(), samplerFlags);
-	GetRenderContext()->CreateUniform(iblStrength, bgfx::UniformType::Vec4, 1);
+	m_lutSampler.Init(GetRenderContext());
+	m_cubeIrradianceSampler.Init(GetRenderContext());
+	m_cubeRadianceSampler.Init(GetRenderContext());
+	m_iblStrength.Init(GetRenderContext());
 
-	GetRenderContext()->CreateUniform(cameraPos, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(cameraNearFarPlane, bgfx::UniformType::Vec4, 1);
+	m_cameraPos.Init(GetRenderContext());
+	m_cameraNearFarPlane.Init(GetRenderContext());
 
-	GetRenderContext()->CreateUniform(albedoColor, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(emissiveColor, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(metallicRoughnessRefectanceFactor, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(albedoUVOffsetAndScale, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(alphaCutOff, bgfx::UniformType::Vec4, 1);
+	m_albedoColor.Init(GetRenderContext());
+	m_emissiveColor.Init(GetRenderContext());
+	m_metallicRoughnessRefectanceFactor.Init(GetRenderContext());
+	m_albedoUVOffsetAndScale.Init(GetRenderContext());
+	m_alphaCutOff.Init(GetRenderContext());
 
-	GetRenderContext()->CreateUniform(lightCountAndStride, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(lightParams, bgfx::UniformType::Vec4, LightUniform::VEC4_COUNT);
+	m_lightCountAndStride.Init(GetRenderContext());
+	m_lightParams.Init(GetRenderContext());
 
 	GetRenderContext()->CreateTexture(elevationTexture, 129U, 129U, 1, bgfx::TextureFormat::Enum::R32F, samplerFlags, nullptr, 0);
 
@@ -144,86 +125,61 @@ void TerrainRenderer::Render(float deltaTime)
 		}
 
 		// Material
-		bgfx::setTexture(TERRAIN_TOP_ALBEDO_MAP_SLOT,
-			GetRenderContext()->GetUniform(StringCrc(snowSampler)),
-			GetRenderContext()->GetTexture(StringCrc(snowTexture)));
-
-		bgfx::setTexture(TERRAIN_MEDIUM_ALBEDO_MAP_SLOT,
-			GetRenderContext()->GetUniform(StringCrc(rockSampler)),
-			GetRenderContext()->GetTexture(StringCrc(rockTexture)));
-
-		bgfx::setTexture(TERRAIN_BOTTOM_ALBEDO_MAP_SLOT,
-			GetRenderContext()->GetUniform(StringCrc(grassSampler)),
-			GetRenderContext()->GetTexture(StringCrc(grassTexture)));
+		m_snowSampler.Bind(TERRAIN_TOP_ALBEDO_MAP_SLOT, GetRenderContext()->GetTexture(StringCrc(snowTexture)));
+		m_rockSampler.Bind(TERRAIN_MEDIUM_ALBEDO_MAP_SLOT, GetRenderContext()->GetTexture(StringCrc(rockTexture)));
+		m_grassSampler.Bind(TERRAIN_BOTTOM_ALBEDO_MAP_SLOT, GetRenderContext()->GetTexture(StringCrc(grassTexture)));
 
 		TerrainComponent* pTerrainComponent = m_pCurrentSceneWorld->GetTerrainComponent(entity);
 		GetRenderContext()->UpdateTexture(elevationTexture, 0, 0, 0, 0, 0, pTerrainComponent->GetTexWidth(), pTerrainComponent->GetTexDepth(),
 			1, pTerrainComponent->GetElevationRawData(), pTerrainComponent->GetElevationRawDataSize());
 
-		bgfx::setTexture(TERRAIN_ELEVATION_MAP_SLOT,
-			GetRenderContext()->GetUniform(StringCrc(elevationSampler)),
-			GetRenderContext()->GetTexture(StringCrc(elevationTexture)));
+		m_elevationSampler.Bind(TERRAIN_ELEVATION_MAP_SLOT, GetRenderContext()->GetTexture(StringCrc(elevationTexture)));
 
 		// Sky
 		SkyType crtSkyType = pSkyComponent->GetSkyType();
 		if (crtSkyType == SkyType::SkyBox)
 		{
-			constexpr StringCrc irrSamplerCrc(cubeIrradianceSampler);
 			GetRenderContext()->CreateTexture(pSkyComponent->GetIrradianceTexturePath().c_str(), samplerFlags);
-			bgfx::setTexture(IBL_IRRADIANCE_SLOT,
-				GetRenderContext()->GetUniform(irrSamplerCrc),
-				GetRenderContext()->GetTexture(StringCrc(pSkyComponent->GetIrradianceTexturePath())));
+			m_cubeIrradianceSampler.Bind(IBL_IRRADIANCE_SLOT, GetRenderContext()->GetTexture(StringCrc(pSkyComponent->GetIrradianceTexturePath())));
 
-			constexpr StringCrc radSamplerCrc(cubeRadianceSampler);
 			GetRenderContext()->CreateTexture(pSkyComponent->GetRadianceTexturePath().c_str(), samplerFlags);
-			bgfx::setTexture(IBL_RADIANCE_SLOT,
-				GetRenderContext()->GetUniform(radSamplerCrc),
-				GetRenderContext()->GetTexture(StringCrc(pSkyComponent->GetRadianceTexturePath())));
+			m_cubeRadianceSampler.Bind(IBL_RADIANCE_SLOT, GetRenderContext()->GetTexture(StringCrc(pSkyComponent->GetRadianceTexturePath())));
 
-			constexpr StringCrc iblStrengthCrc{ iblStrength };
-			GetRenderContext()->FillUniform(iblStrengthCrc, &(pMaterialComponent->GetIblStrengeth()));
+			m_iblStrength.Set(&(pMaterialComponent->GetIblStrengeth()));
 
-			constexpr StringCrc lutsamplerCrc(lutSampler);
 			constexpr StringCrc luttextureCrc(lutTexture);
-			bgfx::setTexture(BRDF_LUT_SLOT, GetRenderContext()->GetUniform(lutsamplerCrc), GetRenderContext()->GetTexture(luttextureCrc));
+			m_lutSampler.Bind(BRDF_LUT_SLOT, GetRenderContext()->GetTexture(luttextureCrc));
 		}
 
 		// Submit uniform values : camera settings
-		constexpr StringCrc cameraPosCrc(cameraPos);
-		GetRenderContext()->FillUniform(cameraPosCrc, &cameraTransform.GetTranslation().x(), 1);
+		m_cameraPos.Set(&cameraTransform.GetTranslation().x());
 
-		constexpr StringCrc cameraNearFarPlaneCrc(cameraNearFarPlane);
-		float cameraNearFarPlanedata[2] { pMainCameraComponent->GetNearPlane(), pMainCameraComponent->GetFarPlane() };
-		GetRenderContext()->FillUniform(cameraNearFarPlaneCrc, cameraNearFarPlanedata, 1);
+		float cameraNearFarPlanedata[4] { pMainCameraComponent->GetNearPlane(), pMainCameraComponent->GetFarPlane(), 0.0f, 0.0f };
+		m_cameraNearFarPlane.Set(cameraNearFarPlanedata);
 
 		// Submit  uniform values : material settings
-		constexpr StringCrc albedoColorCrc(albedoColor);
-		GetRenderContext()->FillUniform(albedoColorCrc, pMaterialComponent->GetFactor<cd::Vec3f>(cd::MaterialPropertyGroup::BaseColor), 1);
+		m_albedoColor.Set(pMaterialComponent->GetFactor<cd::Vec3f>(cd::MaterialPropertyGroup::BaseColor));
 
 		cd::Vec4f u_metallicRoughnessRefectanceFactorData(
 			*(pMaterialComponent->GetFactor<float>(cd::MaterialPropertyGroup::Metallic)),
 			*(pMaterialComponent->GetFactor<float>(cd::MaterialPropertyGroup::Roughness)),
 			pMaterialComponent->GetReflectance(),
 			1.0f);
-		constexpr StringCrc mrrFactorCrc(metallicRoughnessRefectanceFactor);
-		GetRenderContext()->FillUniform(mrrFactorCrc, u_metallicRoughnessRefectanceFactorData.begin(), 1);
+		m_metallicRoughnessRefectanceFactor.Set(u_metallicRoughnessRefectanceFactorData.begin());
 
-		constexpr StringCrc emissiveColorCrc(emissiveColor);
-		GetRenderContext()->FillUniform(emissiveColorCrc, pMaterialComponent->GetFactor<cd::Vec4f>(cd::MaterialPropertyGroup::Emissive), 1);
+		m_emissiveColor.Set(pMaterialComponent->GetFactor<cd::Vec4f>(cd::MaterialPropertyGroup::Emissive));
 
 		// Submit  uniform values : light settings
 		auto lightEntities = m_pCurrentSceneWorld->GetLightEntities();
 		size_t lightEntityCount = lightEntities.size();
-		constexpr engine::StringCrc lightCountAndStrideCrc(lightCountAndStride);
 		static cd::Vec4f lightInfoData(0, LightUniform::LIGHT_STRIDE, 0.0f, 0.0f);
 		lightInfoData.x() = static_cast<float>(lightEntityCount);
-		GetRenderContext()->FillUniform(lightCountAndStrideCrc, lightInfoData.begin(), 1);
+		m_lightCountAndStride.Set(lightInfoData.begin());
 		if (lightEntityCount > 0)
 		{
 			// Light component storage has continus memory address and layout.
 			float* pLightDataBegin = reinterpret_cast<float*>(m_pCurrentSceneWorld->GetLightComponent(lightEntities[0]));
-			constexpr engine::StringCrc lightParamsCrc(lightParams);
-			GetRenderContext()->FillUniform(lightParamsCrc, pLightDataBegin, static_cast<uint16_t>(lightEntityCount * LightUniform::LIGHT_STRIDE));
+			m_lightParams.Set(pLightDataBegin, static_cast<uint16_t>(lightEntityCount * LightUniform::LIGHT_STRIDE));
 		}
 
 		uint64_t state = defaultRenderingState;
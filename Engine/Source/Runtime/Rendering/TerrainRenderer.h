@@ -1,6 +1,8 @@
 #pragma once
 
+#include "LightUniforms.h"
 #include "Renderer.h"
+#include "Rendering/UniformSlot.h"
 
 namespace engine
 {
@@ -20,6 +22,28 @@ public:
 
 private:
 	SceneWorld* m_pCurrentSceneWorld = nullptr;
+
+	SamplerUniform<"s_texSnow"> m_snowSampler;
+	SamplerUniform<"s_texRock"> m_rockSampler;
+	SamplerUniform<"s_texGrass"> m_grassSampler;
+	SamplerUniform<"s_texElevation"> m_elevationSampler;
+
+	SamplerUniform<"s_texLUT"> m_lutSampler;
+	SamplerUniform<"s_texCubeIrr"> m_cubeIrradianceSampler;
+	SamplerUniform<"s_texCubeRad"> m_cubeRadianceSampler;
+	Vec4Uniform<"u_iblStrength"> m_iblStrength;
+
+	Vec4Uniform<"u_cameraPos"> m_cameraPos;
+	Vec4Uniform<"u_cameraNearFarPlane"> m_cameraNearFarPlane;
+
+	Vec4Uniform<"u_albedoColor"> m_albedoColor;
+	Vec4Uniform<"u_emissiveColor"> m_emissiveColor;
+	Vec4Uniform<"u_metallicRoughnessRefectanceFactor"> m_metallicRoughnessRefectanceFactor;
+	Vec4Uniform<"u_albedoUVOffsetAndScale"> m_albedoUVOffsetAndScale;
+	Vec4Uniform<"u_alphaCutOff"> m_alphaCutOff;
+
+	Vec4Uniform<"u_lightCountAndStride"> m_lightCountAndStride;
+	Vec4Uniform<"u_lightParams", LightUniform::VEC4_COUNT> m_lightParams;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Rendering/RenderContext.h"
+
+#include <bgfx/bgfx.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace engine
+{
+
+// String literal which can be passed as a template argument. e.g. UniformSlot<"u_cameraPos", ...>.
+template<std::size_t N>
+struct UniformName
+{
+	constexpr UniformName(const char (&name)[N]) { std::copy_n(name, N, value); }
+
+	char value[N];
+};
+
+// UniformSlot binds a shader uniform name to its type and element count at compile time.
+// The bgfx handle is resolved once in Init so that Set/Bind in the draw loop doesn't need to hash a name
+// and look up RenderContext's uniform map per call.
+template<UniformName Name, bgfx::UniformType::Enum Type, uint16_t Count = 1>
+class UniformSlot
+{
+public:
+	static constexpr const char* GetName() { return Name.value; }
+	static constexpr bgfx::UniformType::Enum GetType() { return Type; }
+	static constexpr uint16_t GetCount() { return Count; }
+
+	// RenderContext keeps a name cache so renderers sharing the same uniform get the same handle.
+	void Init(RenderContext* pRenderContext) { m_handle = pRenderContext->CreateUniform(Name.value, Type, Count); }
+	bool IsValid() const { return bgfx::isValid(m_handle); }
+	bgfx::UniformHandle GetHandle() const { return m_handle; }
+
+	void Set(const void* pData, uint16_t count = Count) const requires (bgfx::UniformType::Sampler != Type)
+	{
+		assert(IsValid() && count <= Count);
+		bgfx::setUniform(m_handle, pData, count);
+		RenderCommandCounter::AddUniformUpdate();
+	}
+
+	void Bind(uint8_t stage, bgfx::TextureHandle textureHandle, uint32_t flags = UINT32_MAX) const requires (bgfx::UniformType::Sampler == Type)
+	{
+		assert(IsValid());
+		bgfx::setTexture(stage, m_handle, textureHandle, flags);
+	}
+
+	// Encoder versions for renderers which record on job threads.
+	void Set(bgfx::Encoder* pEncoder, const void* pData, uint16_t count = Count) const requires (bgfx::UniformType::Sampler != Type)
+	{
+		assert(IsValid() && count <= Count);
+		pEncoder->setUniform(m_handle, pData, count);
+		RenderCommandCounter::AddUniformUpdate();
+	}
+
+	void Bind(bgfx::Encoder* pEncoder, uint8_t stage, bgfx::TextureHandle textureHandle, uint32_t flags = UINT32_MAX) const requires (bgfx::UniformType::Sampler == Type)
+	{
+		assert(IsValid());
+		pEncoder->setTexture(stage, m_handle, textureHandle, flags);
+	}
+
+private:
+	bgfx::UniformHandle m_handle = BGFX_INVALID_HANDLE;
+};
+
+template<UniformName Name, uint16_t Count = 1>
+using Vec4Uniform = UniformSlot<Name, bgfx::UniformType::Vec4, Count>;
+
+template<UniformName Name, uint16_t Count = 1>
+using Mat4Uniform = UniformSlot<Name, bgfx::UniformType::Mat4, Count>;
+
+template<UniformName Name>
+using SamplerUniform = UniformSlot<Name, bgfx::UniformType::Sampler>;
+
+}
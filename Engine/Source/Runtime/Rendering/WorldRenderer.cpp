@@ -1,5 +1,6 @@
 #include "WorldRenderer.h"
 
+#include "Core/Memory/FrameArena.h"
 #include "ECWorld/CameraComponent.h"
 #include "ECWorld/MaterialComponent.h"
 #include "ECWorld/SceneWorld.h"
@@ -9,14 +10,17 @@
 #include "LightUniforms.h"
 #include "Material/ShaderSchema.h"
 #include "Math/Transform.hpp"
+#include "Rendering/PipelineState.h"
 #include "Rendering/RenderContext.h"
 #include "Rendering/Resources/MeshResource.h"
 #include "Rendering/Resources/ShaderResource.h"
 #include "Rendering/Resources/TextureResource.h"
+#include "Rendering/SkinningRenderer.h"
 #include "Scene/Texture.h"
 #include "U_AtmophericScattering.sh"
 #include "U_IBL.sh"
 #include "U_Shadow.sh"
+#include "U_Skinning.sh"
 
 namespace engine
 {
@@ -24,35 +28,8 @@ namespace engine
 namespace
 {
 
-constexpr const char* lutSampler                        = "s_texLUT";
-constexpr const char* cubeIrradianceSampler             = "s_texCubeIrr";
-constexpr const char* cubeRadianceSampler               = "s_texCubeRad";
-											            
 constexpr const char* lutTexture                        = "Textures/lut/ibl_brdf_lut.dds";
-											            
-constexpr const char* cameraPos                         = "u_cameraPos";
-constexpr const char* iblStrength                       = "u_iblStrength";
-constexpr const char* albedoColor                       = "u_albedoColor";
-constexpr const char* emissiveColorAndFactor            = "u_emissiveColorAndFactor";
-constexpr const char* metallicRoughnessRefectanceFactor = "u_metallicRoughnessRefectanceFactor";
-											      
-constexpr const char* albedoUVOffsetAndScale            = "u_albedoUVOffsetAndScale";
-constexpr const char* alphaCutOff                       = "u_alphaCutOff";
-											            
-constexpr const char* lightCountAndStride               = "u_lightCountAndStride";
-constexpr const char* lightParams                       = "u_lightParams";
-											            
-constexpr const char* LightDir                          = "u_LightDir";
-constexpr const char* HeightOffsetAndshadowLength       = "u_HeightOffsetAndshadowLength";
-												        
-constexpr const char* lightViewProjs                    = "u_lightViewProjs";
-constexpr const char* cubeShadowMapSamplers[3]          = { "s_texCubeShadowMap_1", "s_texCubeShadowMap_2" ,  "s_texCubeShadowMap_3" };
-												        
-constexpr const char* cameraNearFarPlane                = "u_cameraNearFarPlane";
-constexpr const char* cameraLookAt                      = "u_cameraLookAt";
-constexpr const char* clipFrustumDepth                  = "u_clipFrustumDepth";
-												        
-constexpr const char* IsCastShadow                      = "u_isCastShadow";
+
 constexpr const char* directionShadowMapTexture         = "DirectionShadowMapTexture";
 constexpr const char* pointShadowMapTexture             = "PointShadowMapTexture";
 constexpr const char* spotShadowMapTexture              = "SpotShadowMapTexture";
@@ -61,42 +38,59 @@ constexpr uint64_t samplerFlags          = BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V
 constexpr uint64_t defaultRenderingState = BGFX_STATE_WRITE_MASK | BGFX_STATE_MSAA | BGFX_STATE_DEPTH_TEST_LESS;
 constexpr uint64_t blitDstTextureFlags   = BGFX_TEXTURE_BLIT_DST | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP;
 
+// Texture resources which were reset, rebuilt or destroyed since the pipeline state was resolved changed their generation.
+bool AreTextureHandlesValid(const PipelineState& pipelineState)
+{
+	for (uint8_t textureIndex = 0; textureIndex < pipelineState.textureCount; ++textureIndex)
+	{
+		const PipelineTexture& texture = pipelineState.textures[textureIndex];
+		if (texture.pTextureResource->GetTextureHandleGeneration() != texture.textureHandleGeneration)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 }
 
 void WorldRenderer::Init()
 {
 	SkyComponent* pSkyComponent = m_pCurrentSceneWorld->GetSkyComponent(m_pCurrentSceneWorld->GetSkyEntity());
 
-	GetRenderContext()->CreateUniform(lutSampler, bgfx::UniformType::Sampler);
-	GetRenderContext()->CreateUniform(cubeIrradianceSampler, bgfx::UniformType::Sampler);
-	GetRenderContext()->CreateUniform(cubeRadianceSampler, bgfx::UniformType::Sampler);
+	m_lutSampler.Init(GetRenderContext());
+	m_cubeIrradianceSampler.Init(GetRenderContext());
+	m_cubeRadianceSampler.Init(GetRenderContext());
 
 	GetRenderContext()->CreateTexture(lutTexture, samplerFlags);
 	GetRenderContext()->CreateTexture(pSkyComponent->GetIrradianceTexturePath().c_str(), samplerFlags);
 	GetRenderContext()->CreateTexture(pSkyComponent->GetRadianceTexturePath().c_str(), samplerFlags);
 
-	GetRenderContext()->CreateUniform(cameraPos, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(iblStrength, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(albedoColor, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(emissiveColorAndFactor, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(metallicRoughnessRefectanceFactor, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(albedoUVOffsetAndScale, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(alphaCutOff, bgfx::UniformType::Vec4, 1);
-
-	GetRenderContext()->CreateUniform(lightCountAndStride, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(lightParams, bgfx::UniformType::Vec4, LightUniform::VEC4_COUNT);
-
-	GetRenderContext()->CreateUniform(LightDir, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(HeightOffsetAndshadowLength, bgfx::UniformType::Vec4, 1);
-
-	GetRenderContext()->CreateUniform(lightViewProjs, bgfx::UniformType::Mat4, 12);
-	GetRenderContext()->CreateUniform(cubeShadowMapSamplers[0], bgfx::UniformType::Sampler);
-	GetRenderContext()->CreateUniform(cubeShadowMapSamplers[1], bgfx::UniformType::Sampler);
-	GetRenderContext()->CreateUniform(cubeShadowMapSamplers[2], bgfx::UniformType::Sampler);
-
-	GetRenderContext()->CreateUniform(cameraNearFarPlane, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(clipFrustumDepth, bgfx::UniformType::Vec4, 1);
-	GetRenderContext()->CreateUniform(IsCastShadow, bgfx::UniformType::Vec4, 1);
+	m_bonePaletteSampler.Init(GetRenderContext());
+	m_skinningParams.Init(GetRenderContext());
+
+	m_cameraPos.Init(GetRenderContext());
+	m_cameraNearFarPlane.Init(GetRenderContext());
+	m_iblStrength.Init(GetRenderContext());
+	m_albedoColor.Init(GetRenderContext());
+	m_emissiveColorAndFactor.Init(GetRenderContext());
+	m_metallicRoughnessRefectanceFactor.Init(GetRenderContext());
+	m_albedoUVOffsetAndScale.Init(GetRenderContext());
+	m_alphaCutOff.Init(GetRenderContext());
+	m_textureLayers.Init(GetRenderContext());
+
+	m_lightCountAndStride.Init(GetRenderContext());
+	m_lightParams.Init(GetRenderContext());
+	m_lightViewProjs.Init(GetRenderContext());
+	m_cubeShadowMapSampler1.Init(GetRenderContext());
+	m_cubeShadowMapSampler2.Init(GetRenderContext());
+	m_cubeShadowMapSampler3.Init(GetRenderContext());
+	m_clipFrustumDepth.Init(GetRenderContext());
+	m_isCastShadow.Init(GetRenderContext());
+
+	m_lightDir.Init(GetRenderContext());
+	m_heightOffsetAndShadowLength.Init(GetRenderContext());
 
 	bgfx::setViewName(GetViewID(), "WorldRenderer");
 }
@@ -187,9 +181,10 @@ void WorldRenderer::Render(float deltaTime)
 		}
 
 		// TODO : Temporary solution for CelluloidRenderer, remove it.
-		if (pMaterialComponent->GetMaterialType() != m_pCurrentSceneWorld->GetPBRMaterialType() &&
-			pMaterialComponent->GetMaterialType() != m_pCurrentSceneWorld->GetCelluloidMaterialType()&&
-			pMaterialComponent->GetMaterialType() != m_pCurrentSceneWorld->GetAnimationMaterialType())
+		const MaterialType* pMaterialType = pMaterialComponent->GetMaterialType();
+		if (pMaterialType != m_pCurrentSceneWorld->GetPBRMaterialType() &&
+			pMaterialType != m_pCurrentSceneWorld->GetCelluloidMaterialType() &&
+			pMaterialType != m_pCurrentSceneWorld->GetAnimationMaterialType())
 		{
 			continue;
 		}
@@ -215,10 +210,29 @@ void WorldRenderer::Render(float deltaTime)
 			continue;
 		}
 
-		// SkinMesh
-		if(m_pCurrentSceneWorld->GetAnimationComponent(entity))
+		// Blend shapes read positions which BlendShapeRenderer evaluated into its shared buffer.
+		const BlendShapeComponent* pBlendShapeComponent = m_pCurrentSceneWorld->GetBlendShapeComponent(entity);
+		if (pBlendShapeComponent && UINT16_MAX == pBlendShapeComponent->GetFinalMorphAffectedVB())
+		{
+			continue;
+		}
+
+		// Skinned meshes read pre-skinned vertices or bones from the palette which SkinningRenderer prepared for this frame.
+		uint16_t skinnedVertexBuffer = UINT16_MAX;
+		if (pMaterialType == m_pCurrentSceneWorld->GetAnimationMaterialType())
 		{
-			//continue;
+			const SkeletonComponent* pSkeletonComponent = m_pCurrentSceneWorld->GetSkeletonComponent(entity);
+			if (!pSkeletonComponent || UINT32_MAX == pSkeletonComponent->GetBonePaletteTexel())
+			{
+				continue;
+			}
+
+			skinnedVertexBuffer = pSkeletonComponent->GetSkinnedVertexBuffer();
+			const float skinningParams[4] = { static_cast<float>(pSkeletonComponent->GetBonePaletteTexel()),
+				SkinningMode::DualQuaternion == pSkeletonComponent->GetSkinningMode() ? 1.0f : 0.0f,
+				UINT16_MAX == skinnedVertexBuffer ? 0.0f : 1.0f, 0.0f };
+			m_skinningParams.Set(skinningParams);
+			m_bonePaletteSampler.Bind(BONE_PALETTE_SLOT, GetRenderContext()->GetTexture(StringCrc(SkinningRenderer::BonePaletteTextureName)));
 		}
 
 		// Transform
@@ -228,38 +242,14 @@ void WorldRenderer::Render(float deltaTime)
 		}
 
 		// Material
-		// TODO : need to check if one texture binds twice to different slot. Or will get bgfx assert about duplicated uniform set.
-		// So please have a research about same texture handle binds to different slots multiple times.
-		// The factor is to build slot -> texture handle maps before update.
-		bool textureSlotBindTable[32] = { false };
-		for (const auto& [textureType, propertyGroup] : pMaterialComponent->GetPropertyGroups())
+		// Textures, material uniforms and render states are resolved into a flat record when the material changes.
+		PipelineState& pipelineState = pMaterialComponent->GetPipelineState();
+		if (pMaterialComponent->IsPipelineStateDirty() || !pipelineState.isComplete || pipelineState.programHandle != pShaderResource->GetHandle() ||
+			!AreTextureHandlesValid(pipelineState))
 		{
-			const MaterialComponent::TextureInfo& textureInfo = propertyGroup.textureInfo;
-			if (textureSlotBindTable[textureInfo.slot])
-			{
-				// already bind.
-				continue;
-			}
-
-			TextureResource* pTextureResource = textureInfo.pTextureResource;
-			if (!propertyGroup.useTexture ||
-				pTextureResource == nullptr ||
-				(pTextureResource->GetStatus() != ResourceStatus::Ready && pTextureResource->GetStatus() != ResourceStatus::Optimized))
-			{
-				continue;
-			}
-
-			if (cd::MaterialTextureType::BaseColor == textureType)
-			{
-				constexpr StringCrc albedoUVOffsetAndScaleCrc(albedoUVOffsetAndScale);
-				cd::Vec4f uvOffsetAndScaleData(textureInfo.GetUVOffset().x(), textureInfo.GetUVOffset().y(),
-					textureInfo.GetUVScale().x(), textureInfo.GetUVScale().y());
-				GetRenderContext()->FillUniform(albedoUVOffsetAndScaleCrc, &uvOffsetAndScaleData, 1);
-			}
-
-			textureSlotBindTable[textureInfo.slot] = true;
-			bgfx::setTexture(textureInfo.slot, bgfx::UniformHandle{ pTextureResource->GetSamplerHandle() }, bgfx::TextureHandle{ pTextureResource->GetTextureHandle() });
+			ResolvePipelineState(pMaterialComponent);
 		}
+		ApplyPipelineState(pipelineState);
 
 		// Sky
 		SkyType crtSkyType = pSkyComponent->GetSkyType();
@@ -268,24 +258,14 @@ void WorldRenderer::Render(float deltaTime)
 			// Create a new TextureHandle each frame if the skybox texture path has been updated,
 			// otherwise RenderContext::CreateTexture will skip it automatically.
 
-			constexpr StringCrc irrSamplerCrc(cubeIrradianceSampler);
 			GetRenderContext()->CreateTexture(pSkyComponent->GetIrradianceTexturePath().c_str(), samplerFlags);
-			bgfx::setTexture(IBL_IRRADIANCE_SLOT,
-				GetRenderContext()->GetUniform(irrSamplerCrc),
-				GetRenderContext()->GetTexture(StringCrc(pSkyComponent->GetIrradianceTexturePath())));
+			m_cubeIrradianceSampler.Bind(IBL_IRRADIANCE_SLOT, GetRenderContext()->GetTexture(StringCrc(pSkyComponent->GetIrradianceTexturePath())));
 
-			constexpr StringCrc radSamplerCrc(cubeRadianceSampler);
 			GetRenderContext()->CreateTexture(pSkyComponent->GetRadianceTexturePath().c_str(), samplerFlags);
-			bgfx::setTexture(IBL_RADIANCE_SLOT,
-				GetRenderContext()->GetUniform(radSamplerCrc),
-				GetRenderContext()->GetTexture(StringCrc(pSkyComponent->GetRadianceTexturePath())));
-
-			constexpr StringCrc iblStrengthCrc{ iblStrength };
-			GetRenderContext()->FillUniform(iblStrengthCrc, &(pMaterialComponent->GetIblStrengeth()));
+			m_cubeRadianceSampler.Bind(IBL_RADIANCE_SLOT, GetRenderContext()->GetTexture(StringCrc(pSkyComponent->GetRadianceTexturePath())));
 
-			constexpr StringCrc lutsamplerCrc{ lutSampler };
 			constexpr StringCrc luttextureCrc{ lutTexture };
-			bgfx::setTexture(BRDF_LUT_SLOT, GetRenderContext()->GetUniform(lutsamplerCrc), GetRenderContext()->GetTexture(luttextureCrc));
+			m_lutSampler.Bind(BRDF_LUT_SLOT, GetRenderContext()->GetTexture(luttextureCrc));
 		}
 		else if (SkyType::AtmosphericScattering == crtSkyType)
 		{
@@ -293,42 +273,22 @@ void WorldRenderer::Render(float deltaTime)
 			bgfx::setImage(ATM_IRRADIANCE_SLOT, GetRenderContext()->GetTexture(pSkyComponent->GetATMIrradianceCrc()), 0, bgfx::Access::Read, bgfx::TextureFormat::RGBA32F);
 			bgfx::setImage(ATM_SCATTERING_SLOT, GetRenderContext()->GetTexture(pSkyComponent->GetATMScatteringCrc()), 0, bgfx::Access::Read, bgfx::TextureFormat::RGBA32F);
 
-			constexpr StringCrc LightDirCrc(LightDir);
-			GetRenderContext()->FillUniform(LightDirCrc, &(pSkyComponent->GetSunDirection().x()), 1);
+			m_lightDir.Set(&(pSkyComponent->GetSunDirection().x()));
 
-			constexpr StringCrc HeightOffsetAndshadowLengthCrc(HeightOffsetAndshadowLength);
 			cd::Vec4f tmpHeightOffsetAndshadowLength = cd::Vec4f(pSkyComponent->GetHeightOffset(), pSkyComponent->GetShadowLength(), 0.0f, 0.0f);
-			GetRenderContext()->FillUniform(HeightOffsetAndshadowLengthCrc, &(tmpHeightOffsetAndshadowLength.x()), 1);
+			m_heightOffsetAndShadowLength.Set(&(tmpHeightOffsetAndshadowLength.x()));
 		}
 
 		// Submit uniform values : camera settings
-		constexpr StringCrc cameraPosCrc(cameraPos);
-		GetRenderContext()->FillUniform(cameraPosCrc, &cameraTransform.GetTranslation().x(), 1);
-
-		constexpr StringCrc cameraNearFarPlaneCrc(cameraNearFarPlane);
-		float cameraNearFarPlanedata[2]{ pMainCameraComponent->GetNearPlane(), pMainCameraComponent->GetFarPlane() };
-		GetRenderContext()->FillUniform(cameraNearFarPlaneCrc, cameraNearFarPlanedata, 1);
-
-		// Submit uniform values : material settings
-		constexpr StringCrc albedoColorCrc(albedoColor);
-		GetRenderContext()->FillUniform(albedoColorCrc, pMaterialComponent->GetFactor<cd::Vec3f>(cd::MaterialPropertyGroup::BaseColor), 1);
+		m_cameraPos.Set(&cameraTransform.GetTranslation().x());
 
-		cd::Vec4f metallicRoughnessRefectanceFactorData(
-			*(pMaterialComponent->GetFactor<float>(cd::MaterialPropertyGroup::Metallic)),
-			*(pMaterialComponent->GetFactor<float>(cd::MaterialPropertyGroup::Roughness)),
-			pMaterialComponent->GetReflectance(),
-			1.0f);
-		constexpr StringCrc mrrFactorCrc(metallicRoughnessRefectanceFactor);
-		GetRenderContext()->FillUniform(mrrFactorCrc, metallicRoughnessRefectanceFactorData.begin(), 1);
-
-		constexpr StringCrc emissiveColorCrc(emissiveColorAndFactor);
-		GetRenderContext()->FillUniform(emissiveColorCrc, pMaterialComponent->GetFactor<cd::Vec4f>(cd::MaterialPropertyGroup::Emissive), 1);
+		float cameraNearFarPlanedata[4]{ pMainCameraComponent->GetNearPlane(), pMainCameraComponent->GetFarPlane(), 0.0f, 0.0f };
+		m_cameraNearFarPlane.Set(cameraNearFarPlanedata);
 
 		// Submit light data
-		constexpr engine::StringCrc lightCountAndStrideCrc(lightCountAndStride);
 		static cd::Vec4f lightInfoData(0, LightUniform::LIGHT_STRIDE, 0.0f, 0.0f);
 		lightInfoData.x() = static_cast<float>(lightEntityCount);
-		GetRenderContext()->FillUniform(lightCountAndStrideCrc, lightInfoData.begin(), 1);
+		m_lightCountAndStride.Set(lightInfoData.begin());
 		int totalLightViewProjOffset = 0;
 		float lightData[4 *7 * 3] = { 0 };
 		for (uint16_t i = 0U; i < lightEntityCount; ++i)
@@ -346,11 +306,11 @@ void WorldRenderer::Render(float deltaTime)
 			}
 			memcpy(&lightData[4 * 7 * i], lightComponent->GetLightUniformData(), sizeof(U_Light));
 		}
-		constexpr engine::StringCrc lightParamsCrc(lightParams);
-		GetRenderContext()->FillUniform(lightParamsCrc, lightData, static_cast<uint16_t>(lightEntityCount * LightUniform::LIGHT_STRIDE));
+		m_lightParams.Set(lightData, static_cast<uint16_t>(lightEntityCount * LightUniform::LIGHT_STRIDE));
 
 		// Submit light view&projection transform
-		std::vector<cd::Matrix4x4> lightViewProjsData;
+		FrameVector<cd::Matrix4x4> lightViewProjsData;
+		lightViewProjsData.reserve(static_cast<size_t>(totalLightViewProjOffset));
 		for (uint16_t i = 0U; i < lightEntityCount; ++i)
 		{
 			LightComponent* lightComponent = m_pCurrentSceneWorld->GetLightComponent(lightEntities[i]);
@@ -360,77 +320,156 @@ void WorldRenderer::Render(float deltaTime)
 				lightViewProjsData.push_back(lightViewProj);
 			}
 		}
-		constexpr engine::StringCrc lightViewProjsCrc(lightViewProjs);
-		GetRenderContext()->FillUniform(lightViewProjsCrc, lightViewProjsData.data(), totalLightViewProjOffset);
+		m_lightViewProjs.Set(lightViewProjsData.data(), static_cast<uint16_t>(totalLightViewProjOffset));
 
 		// Submit shadow map and settings of each light
-		constexpr StringCrc shadowMapSamplerCrcs[3] = { StringCrc(cubeShadowMapSamplers[0]), StringCrc(cubeShadowMapSamplers[1]), StringCrc(cubeShadowMapSamplers[2]) };
+		const bgfx::UniformHandle shadowMapSamplers[3] = { m_cubeShadowMapSampler1.GetHandle(), m_cubeShadowMapSampler2.GetHandle(), m_cubeShadowMapSampler3.GetHandle() };
 		for (int lightIndex = 0; lightIndex < lightEntityCount; lightIndex++)
 		{
 			auto lightComponent = m_pCurrentSceneWorld->GetLightComponent(lightEntities[lightIndex]);
 			cd::LightType lightType = lightComponent->GetType();
 
-			constexpr StringCrc CastShadowIntensityCrc(IsCastShadow);
 			if (lightComponent->IsCastShadow())
 			{
 				cd::Vec4f vec4 = cd::Vec4f::One();
-				GetRenderContext()->FillUniform(CastShadowIntensityCrc, &vec4);
+				m_isCastShadow.Set(&vec4);
 			}
 			else
 			{
 				cd::Vec4f vec4 = cd::Vec4f::Zero();
-				GetRenderContext()->FillUniform(CastShadowIntensityCrc, &vec4);
+				m_isCastShadow.Set(&vec4);
 			}
 			//GetRenderContext()->FillUniform(CastShadowIntensityCrc, &lightComponent->IsCastShadow());
 			if (cd::LightType::Directional == lightType)
 			{
 				bgfx::TextureHandle blitDstShadowMapTexture = static_cast<bgfx::TextureHandle>(lightComponent->GetShadowMapTexture());
-				bgfx::setTexture(SHADOW_MAP_CUBE_FIRST_SLOT + lightIndex, GetRenderContext()->GetUniform(shadowMapSamplerCrcs[lightIndex]), blitDstShadowMapTexture);
+				bgfx::setTexture(SHADOW_MAP_CUBE_FIRST_SLOT + lightIndex, shadowMapSamplers[lightIndex], blitDstShadowMapTexture);
 				// TODO : manual 
-				constexpr StringCrc clipFrustumDepthCrc(clipFrustumDepth);
-				GetRenderContext()->FillUniform(clipFrustumDepthCrc, lightComponent->GetComputedCascadeSplit(), 1);
+				m_clipFrustumDepth.Set(lightComponent->GetComputedCascadeSplit());
 			}
 			else if (cd::LightType::Point == lightType)
 			{
 				bgfx::TextureHandle blitDstShadowMapTexture = static_cast<bgfx::TextureHandle>(lightComponent->GetShadowMapTexture());
-				bgfx::setTexture(SHADOW_MAP_CUBE_FIRST_SLOT + lightIndex, GetRenderContext()->GetUniform(shadowMapSamplerCrcs[lightIndex]), blitDstShadowMapTexture);
+				bgfx::setTexture(SHADOW_MAP_CUBE_FIRST_SLOT + lightIndex, shadowMapSamplers[lightIndex], blitDstShadowMapTexture);
 			}
 			else if (cd::LightType::Spot == lightType)
 			{
 				// Blit RTV(FrameBuffer Texture) to SRV(Texture)
 				bgfx::TextureHandle blitDstShadowMapTexture = static_cast<bgfx::TextureHandle>(lightComponent->GetShadowMapTexture());
-				bgfx::setTexture(SHADOW_MAP_CUBE_FIRST_SLOT + lightIndex, GetRenderContext()->GetUniform(shadowMapSamplerCrcs[lightIndex]), blitDstShadowMapTexture);
+				bgfx::setTexture(SHADOW_MAP_CUBE_FIRST_SLOT + lightIndex, shadowMapSamplers[lightIndex], blitDstShadowMapTexture);
 			}
 		}
 
-		uint64_t state = defaultRenderingState;
-		if (!pMaterialComponent->GetTwoSided())
+		// Mesh
+		if (pBlendShapeComponent)
 		{
-			state |= BGFX_STATE_CULL_CCW;
+			bgfx::setVertexBuffer(0, bgfx::DynamicVertexBufferHandle{ pBlendShapeComponent->GetFinalMorphAffectedVB() },
+				pBlendShapeComponent->GetFinalMorphAffectedFirstVertex(), pBlendShapeComponent->GetMeshVertexCount());
+			bgfx::setVertexBuffer(1, bgfx::VertexBufferHandle{ pBlendShapeComponent->GetNonMorphAffectedVB() });
+			// TODO : BlendShape + multiple index buffers.
+			bgfx::setIndexBuffer(bgfx::IndexBufferHandle{ pMeshResource->GetIndexBufferHandle(0U) });
+			GetRenderContext()->Submit(GetViewID(), pipelineState.programHandle);
 		}
+		else if (UINT16_MAX != skinnedVertexBuffer)
+		{
+			// Skinned positions in front of the mesh stream, bone influences are still read from the mesh.
+			bgfx::setVertexBuffer(0, bgfx::DynamicVertexBufferHandle{ skinnedVertexBuffer }, pMeshComponent->GetStartVertex(), pMeshComponent->GetVertexCount());
+			bgfx::setVertexBuffer(1, bgfx::VertexBufferHandle{ pMeshResource->GetVertexBufferHandle() }, pMeshComponent->GetStartVertex(), pMeshComponent->GetVertexCount());
+			bgfx::setIndexBuffer(bgfx::IndexBufferHandle{ pMeshResource->GetIndexBufferHandle(0U) }, pMeshComponent->GetStartIndex(), pMeshComponent->GetIndexCount());
+			GetRenderContext()->Submit(GetViewID(), pipelineState.programHandle);
+		}
+		else
+		{
+			SubmitStaticMeshDrawCall(pMeshComponent, GetViewID(), pipelineState.programHandle);
+		}
+	}
+}
+
+void WorldRenderer::ResolvePipelineState(MaterialComponent* pMaterialComponent)
+{
+	PipelineState& pipelineState = pMaterialComponent->GetPipelineState();
+	pipelineState.Reset();
+	pipelineState.isComplete = true;
+	pipelineState.programHandle = pMaterialComponent->GetShaderResource()->GetHandle();
+
+	pipelineState.state = defaultRenderingState;
+	if (!pMaterialComponent->GetTwoSided())
+	{
+		pipelineState.state |= BGFX_STATE_CULL_CCW;
+	}
 
-		if (cd::BlendMode::Mask == pMaterialComponent->GetBlendMode())
+	// TODO : need to check if one texture binds twice to different slot. Or will get bgfx assert about duplicated uniform set.
+	// So please have a research about same texture handle binds to different slots multiple times.
+	// The factor is to build slot -> texture handle maps before update.
+	bool textureSlotBindTable[32] = { false };
+	float textureLayersData[4] = { 0.0f };
+	float uvOffsetAndScaleData[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+	for (const auto& [textureType, propertyGroup] : pMaterialComponent->GetPropertyGroups())
+	{
+		const MaterialComponent::TextureInfo& textureInfo = propertyGroup.textureInfo;
+		if (textureSlotBindTable[textureInfo.slot])
 		{
-			constexpr StringCrc alphaCutOffCrc(alphaCutOff);
-			GetRenderContext()->FillUniform(alphaCutOffCrc, &pMaterialComponent->GetAlphaCutOff(), 1);
+			// already bind.
+			continue;
 		}
 
-		bgfx::setState(state);
+		TextureResource* pTextureResource = textureInfo.pTextureResource;
+		if (!propertyGroup.useTexture || pTextureResource == nullptr)
+		{
+			continue;
+		}
 
-		// Mesh
-		if (BlendShapeComponent* pBlendShapeComponent = m_pCurrentSceneWorld->GetBlendShapeComponent(entity))
+		if (pTextureResource->GetStatus() != ResourceStatus::Ready && pTextureResource->GetStatus() != ResourceStatus::Optimized)
 		{
-			bgfx::setVertexBuffer(0, bgfx::DynamicVertexBufferHandle{ pBlendShapeComponent->GetFinalMorphAffectedVB() });
-			bgfx::setVertexBuffer(1, bgfx::VertexBufferHandle{ pBlendShapeComponent->GetNonMorphAffectedVB() });
-			// TODO : BlendShape + multiple index buffers.
-			bgfx::setIndexBuffer(bgfx::IndexBufferHandle{ pMeshComponent->GetMeshResource()->GetIndexBufferHandle(0U) });
-			GetRenderContext()->Submit(GetViewID(), pShaderResource->GetHandle());
+			pipelineState.isComplete = false;
+			continue;
 		}
-		else
+
+		if (cd::MaterialTextureType::BaseColor == textureType)
+		{
+			uvOffsetAndScaleData[0] = textureInfo.GetUVOffset().x();
+			uvOffsetAndScaleData[1] = textureInfo.GetUVOffset().y();
+			uvOffsetAndScaleData[2] = textureInfo.GetUVScale().x();
+			uvOffsetAndScaleData[3] = textureInfo.GetUVScale().y();
+		}
+
+		textureSlotBindTable[textureInfo.slot] = true;
+		if (textureInfo.slot < 4)
 		{
-			SubmitStaticMeshDrawCall(pMeshComponent, GetViewID(), pShaderResource->GetHandle());
+			textureLayersData[textureInfo.slot] = static_cast<float>(textureInfo.GetLayer());
 		}
+
+		const SamplerState& samplerState = GetRenderContext()->GetSamplerState(textureInfo.slot, pTextureResource->GetSamplerFlags());
+		pipelineState.AddTexture(textureInfo.slot, samplerState.uniformHandle.idx, pTextureResource->GetTextureHandle(), samplerState.flags,
+			pTextureResource, pTextureResource->GetTextureHandleGeneration());
+	}
+
+	pipelineState.AddUniform(m_albedoUVOffsetAndScale.GetHandle().idx, uvOffsetAndScaleData);
+
+	if (pMaterialComponent->GetShaderFeatures().contains(ShaderFeature::TEXTURE_ARRAY))
+	{
+		pipelineState.AddUniform(m_textureLayers.GetHandle().idx, textureLayersData);
 	}
+
+	pipelineState.AddUniform(m_albedoColor.GetHandle().idx, pMaterialComponent->GetFactor<cd::Vec3f>(cd::MaterialPropertyGroup::BaseColor)->begin(), 3);
+
+	float metallicRoughnessRefectanceFactorData[4] = {
+		*(pMaterialComponent->GetFactor<float>(cd::MaterialPropertyGroup::Metallic)),
+		*(pMaterialComponent->GetFactor<float>(cd::MaterialPropertyGroup::Roughness)),
+		pMaterialComponent->GetReflectance(),
+		1.0f };
+	pipelineState.AddUniform(m_metallicRoughnessRefectanceFactor.GetHandle().idx, metallicRoughnessRefectanceFactorData);
+
+	pipelineState.AddUniform(m_emissiveColorAndFactor.GetHandle().idx, pMaterialComponent->GetFactor<cd::Vec4f>(cd::MaterialPropertyGroup::Emissive)->begin());
+
+	pipelineState.AddUniform(m_iblStrength.GetHandle().idx, &pMaterialComponent->GetIblStrengeth(), 1);
+
+	if (cd::BlendMode::Mask == pMaterialComponent->GetBlendMode())
+	{
+		pipelineState.AddUniform(m_alphaCutOff.GetHandle().idx, &pMaterialComponent->GetAlphaCutOff(), 1);
+	}
+
+	pMaterialComponent->SetPipelineStateDirty(false);
 }
 
-}
\ No newline at end of file
+}
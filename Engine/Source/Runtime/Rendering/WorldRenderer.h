@@ -1,10 +1,13 @@
 #pragma once
 
+#include "LightUniforms.h"
 #include "Renderer.h"
+#include "Rendering/UniformSlot.h"
 
 namespace engine
 {
 
+class MaterialComponent;
 class SceneWorld;
 
 class WorldRenderer final : public Renderer
@@ -18,8 +21,39 @@ public:
 
 	void SetSceneWorld(SceneWorld* pSceneWorld) { m_pCurrentSceneWorld = pSceneWorld; }
 
+private:
+	void ResolvePipelineState(MaterialComponent* pMaterialComponent);
+
 private:
 	SceneWorld* m_pCurrentSceneWorld = nullptr;
+
+	SamplerUniform<"s_texLUT"> m_lutSampler;
+	SamplerUniform<"s_texCubeIrr"> m_cubeIrradianceSampler;
+	SamplerUniform<"s_texCubeRad"> m_cubeRadianceSampler;
+	SamplerUniform<"s_texCubeShadowMap_1"> m_cubeShadowMapSampler1;
+	SamplerUniform<"s_texCubeShadowMap_2"> m_cubeShadowMapSampler2;
+	SamplerUniform<"s_texCubeShadowMap_3"> m_cubeShadowMapSampler3;
+	SamplerUniform<"s_bonePalette"> m_bonePaletteSampler;
+
+	Vec4Uniform<"u_cameraPos"> m_cameraPos;
+	Vec4Uniform<"u_cameraNearFarPlane"> m_cameraNearFarPlane;
+	Vec4Uniform<"u_iblStrength"> m_iblStrength;
+	Vec4Uniform<"u_albedoColor"> m_albedoColor;
+	Vec4Uniform<"u_emissiveColorAndFactor"> m_emissiveColorAndFactor;
+	Vec4Uniform<"u_metallicRoughnessRefectanceFactor"> m_metallicRoughnessRefectanceFactor;
+	Vec4Uniform<"u_albedoUVOffsetAndScale"> m_albedoUVOffsetAndScale;
+	Vec4Uniform<"u_alphaCutOff"> m_alphaCutOff;
+	Vec4Uniform<"u_textureLayers"> m_textureLayers;
+	Vec4Uniform<"u_skinningParams"> m_skinningParams;
+
+	Vec4Uniform<"u_lightCountAndStride"> m_lightCountAndStride;
+	Vec4Uniform<"u_lightParams", LightUniform::VEC4_COUNT> m_lightParams;
+	Mat4Uniform<"u_lightViewProjs", 12> m_lightViewProjs;
+	Vec4Uniform<"u_clipFrustumDepth"> m_clipFrustumDepth;
+	Vec4Uniform<"u_isCastShadow"> m_isCastShadow;
+
+	Vec4Uniform<"u_LightDir"> m_lightDir;
+	Vec4Uniform<"u_HeightOffsetAndshadowLength"> m_heightOffsetAndShadowLength;
 };
 
 }
\ No newline at end of file
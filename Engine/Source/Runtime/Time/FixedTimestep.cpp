@@ -0,0 +1,38 @@
+#include "FixedTimestep.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace engine
+{
+
+FixedTimestep::FixedTimestep(float stepTime, uint32_t maxStepCount)
+	: m_stepTime(stepTime)
+	, m_maxStepCount(maxStepCount)
+{
+	assert(stepTime > 0.0f && maxStepCount > 0U);
+}
+
+uint32_t FixedTimestep::Advance(float deltaTime)
+{
+	m_accumulator += std::max(deltaTime, 0.0f);
+
+	uint32_t stepCount = 0U;
+	while (m_accumulator >= m_stepTime && stepCount < m_maxStepCount)
+	{
+		m_accumulator -= m_stepTime;
+		++stepCount;
+	}
+
+	if (m_accumulator >= m_stepTime)
+	{
+		// Keep the fraction so that interpolation doesn't jump.
+		m_accumulator = std::fmod(m_accumulator, m_stepTime);
+	}
+
+	m_stepIndex += stepCount;
+	return stepCount;
+}
+
+}
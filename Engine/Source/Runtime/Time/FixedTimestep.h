@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+namespace engine
+{
+
+// Accumulates variable frame time and splits it into fixed simulation steps.
+// The remaining time in the accumulator is exposed as an interpolation factor between the last two steps.
+class FixedTimestep
+{
+public:
+	static constexpr float DefaultStepTime = 1.0f / 60.0f;
+	static constexpr uint32_t DefaultMaxStepCount = 5U;
+
+public:
+	FixedTimestep() = default;
+	explicit FixedTimestep(float stepTime, uint32_t maxStepCount = DefaultMaxStepCount);
+	FixedTimestep(const FixedTimestep&) = default;
+	FixedTimestep& operator=(const FixedTimestep&) = default;
+	FixedTimestep(FixedTimestep&&) = default;
+	FixedTimestep& operator=(FixedTimestep&&) = default;
+	~FixedTimestep() = default;
+
+	// Returns how many steps to simulate for this frame. At most maxStepCount steps are returned,
+	// time beyond that is dropped so that a long hitch doesn't make next frames even slower.
+	uint32_t Advance(float deltaTime);
+
+	float GetStepTime() const { return m_stepTime; }
+	uint32_t GetMaxStepCount() const { return m_maxStepCount; }
+
+	// [0, 1) blend factor from the previous step to the current step.
+	float GetAlpha() const { return m_accumulator / m_stepTime; }
+
+	// Steps simulated in total.
+	uint64_t GetStepIndex() const { return m_stepIndex; }
+
+private:
+	float m_stepTime = DefaultStepTime;
+	uint32_t m_maxStepCount = DefaultMaxStepCount;
+	float m_accumulator = 0.0f;
+	uint64_t m_stepIndex = 0U;
+};
+
+}
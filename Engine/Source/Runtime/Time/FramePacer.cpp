@@ -0,0 +1,49 @@
+#include "FramePacer.h"
+
+#include <cassert>
+#include <thread>
+
+namespace engine
+{
+
+FramePacer::FramePacer(FramePacingMode mode, float targetFrameRate)
+	: m_mode(mode)
+	, m_targetFrameRate(targetFrameRate)
+{
+	assert(FramePacingMode::TargetFrameRate != mode || targetFrameRate > 0.0f);
+	if (FramePacingMode::TargetFrameRate == mode)
+	{
+		m_framePeriod = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / targetFrameRate));
+	}
+}
+
+void FramePacer::WaitForNextFrame()
+{
+	if (FramePacingMode::TargetFrameRate != m_mode)
+	{
+		return;
+	}
+
+	TimePoint now = std::chrono::steady_clock::now();
+	if (TimePoint{} == m_nextFrameTime || now - m_nextFrameTime > m_framePeriod)
+	{
+		// First frame or more than a frame late. Restart the schedule instead of rushing to catch up.
+		m_nextFrameTime = now + m_framePeriod;
+		return;
+	}
+
+	if (m_nextFrameTime - now > SpinDuration)
+	{
+		std::this_thread::sleep_until(m_nextFrameTime - SpinDuration);
+	}
+
+	while (std::chrono::steady_clock::now() < m_nextFrameTime)
+	{
+		std::this_thread::yield();
+	}
+
+	// Deadlines advance by whole periods so that small oversleeps don't accumulate into drift.
+	m_nextFrameTime += m_framePeriod;
+}
+
+}
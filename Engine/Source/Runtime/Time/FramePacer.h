@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace engine
+{
+
+enum class FramePacingMode : uint8_t
+{
+	// Swap chain waits for vertical blank.
+	VSync,
+	// No wait at all. Useful to measure the real cost of a frame.
+	Uncapped,
+	// No vsync. The main loop waits until the frame period of the target frame rate is over.
+	TargetFrameRate,
+};
+
+// Waits at the end of frames to keep a fixed frame period in TargetFrameRate mode.
+// Sleeping is coarse on most platforms so it sleeps until shortly before the deadline and spins for the rest.
+class FramePacer
+{
+public:
+	using TimePoint = std::chrono::steady_clock::time_point;
+
+	// Sleeps shorter than this may overshoot so the last part of the wait always spins.
+	static constexpr std::chrono::microseconds SpinDuration = std::chrono::microseconds(2000);
+
+public:
+	FramePacer() = default;
+	FramePacer(FramePacingMode mode, float targetFrameRate);
+	FramePacer(const FramePacer&) = default;
+	FramePacer& operator=(const FramePacer&) = default;
+	FramePacer(FramePacer&&) = default;
+	FramePacer& operator=(FramePacer&&) = default;
+	~FramePacer() = default;
+
+	FramePacingMode GetMode() const { return m_mode; }
+	float GetTargetFrameRate() const { return m_targetFrameRate; }
+	bool IsVSyncEnabled() const { return FramePacingMode::VSync == m_mode; }
+
+	// Call once at the end of every frame.
+	void WaitForNextFrame();
+
+private:
+	FramePacingMode m_mode = FramePacingMode::VSync;
+	float m_targetFrameRate = 60.0f;
+	std::chrono::steady_clock::duration m_framePeriod{};
+	TimePoint m_nextFrameTime{};
+};
+
+}
@@ -0,0 +1,110 @@
+#include "FrameTimeStats.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+namespace engine
+{
+
+namespace
+{
+
+double GetPercentile(const std::vector<float>& sortedSamples, double percentile)
+{
+	// Nearest rank.
+	size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sortedSamples.size())));
+	rank = std::clamp<size_t>(rank, 1U, sortedSamples.size());
+	return sortedSamples[rank - 1U];
+}
+
+}
+
+FrameTimeStats::FrameTimeStats(uint32_t capacity)
+	: m_capacity(capacity)
+{
+	assert(capacity > 0U);
+	m_samples.reserve(capacity);
+}
+
+void FrameTimeStats::AddSample(float frameTimeMs)
+{
+	if (m_samples.size() < m_capacity)
+	{
+		m_samples.push_back(frameTimeMs);
+	}
+	else
+	{
+		m_samples[m_nextSampleIndex] = frameTimeMs;
+	}
+
+	m_nextSampleIndex = (m_nextSampleIndex + 1U) % m_capacity;
+	++m_totalFrameCount;
+}
+
+void FrameTimeStats::Reset()
+{
+	m_samples.clear();
+	m_nextSampleIndex = 0U;
+	m_totalFrameCount = 0U;
+}
+
+FrameTimeSummary FrameTimeStats::GetSummary() const
+{
+	FrameTimeSummary summary;
+	summary.frameCount = m_totalFrameCount;
+	if (m_samples.empty())
+	{
+		return summary;
+	}
+
+	std::vector<float> sortedSamples = m_samples;
+	std::sort(sortedSamples.begin(), sortedSamples.end());
+
+	double sum = 0.0;
+	for (float sample : sortedSamples)
+	{
+		sum += sample;
+	}
+
+	summary.averageMs = sum / static_cast<double>(sortedSamples.size());
+	summary.p50Ms = GetPercentile(sortedSamples, 50.0);
+	summary.p95Ms = GetPercentile(sortedSamples, 95.0);
+	summary.p99Ms = GetPercentile(sortedSamples, 99.0);
+	summary.maxMs = sortedSamples.back();
+	return summary;
+}
+
+bool FrameTimeStats::WriteToFile(const char* pFilePath) const
+{
+	FILE* pFile = std::fopen(pFilePath, "w");
+	if (!pFile)
+	{
+		return false;
+	}
+
+	const FrameTimeSummary summary = GetSummary();
+	std::fprintf(pFile, "{\n");
+	std::fprintf(pFile, "  \"frameCount\": %llu,\n", static_cast<unsigned long long>(summary.frameCount));
+	std::fprintf(pFile, "  \"averageMs\": %.4f,\n", summary.averageMs);
+	std::fprintf(pFile, "  \"p50Ms\": %.4f,\n", summary.p50Ms);
+	std::fprintf(pFile, "  \"p95Ms\": %.4f,\n", summary.p95Ms);
+	std::fprintf(pFile, "  \"p99Ms\": %.4f,\n", summary.p99Ms);
+	std::fprintf(pFile, "  \"maxMs\": %.4f,\n", summary.maxMs);
+
+	// Oldest sample first.
+	std::fprintf(pFile, "  \"samplesMs\": [");
+	const size_t sampleCount = m_samples.size();
+	const size_t firstIndex = sampleCount < m_capacity ? 0U : m_nextSampleIndex;
+	for (size_t sampleIndex = 0U; sampleIndex < sampleCount; ++sampleIndex)
+	{
+		std::fprintf(pFile, "%s%.4f", 0U == sampleIndex ? "" : ", ", m_samples[(firstIndex + sampleIndex) % sampleCount]);
+	}
+	std::fprintf(pFile, "]\n}\n");
+
+	std::fclose(pFile);
+	return true;
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace engine
+{
+
+struct FrameTimeSummary
+{
+	uint64_t frameCount = 0U;
+	double averageMs = 0.0;
+	double p50Ms = 0.0;
+	double p95Ms = 0.0;
+	double p99Ms = 0.0;
+	double maxMs = 0.0;
+};
+
+// Keeps the most recent frame times to report percentiles. Recording doesn't allocate after construction.
+class FrameTimeStats
+{
+public:
+	static constexpr uint32_t DefaultCapacity = 60U * 60U;
+
+public:
+	explicit FrameTimeStats(uint32_t capacity = DefaultCapacity);
+	FrameTimeStats(const FrameTimeStats&) = default;
+	FrameTimeStats& operator=(const FrameTimeStats&) = default;
+	FrameTimeStats(FrameTimeStats&&) = default;
+	FrameTimeStats& operator=(FrameTimeStats&&) = default;
+	~FrameTimeStats() = default;
+
+	void AddSample(float frameTimeMs);
+	void Reset();
+
+	uint32_t GetSampleCount() const { return static_cast<uint32_t>(m_samples.size()); }
+	uint64_t GetTotalFrameCount() const { return m_totalFrameCount; }
+
+	// Percentiles use the nearest rank of recent samples. frameCount counts all frames since Reset.
+	FrameTimeSummary GetSummary() const;
+
+	// Summary and recent samples as json.
+	bool WriteToFile(const char* pFilePath) const;
+
+private:
+	uint32_t m_capacity;
+	uint32_t m_nextSampleIndex = 0U;
+	uint64_t m_totalFrameCount = 0U;
+	std::vector<float> m_samples;
+};
+
+}
@@ -0,0 +1,1403 @@
+#include "Animation/AnimationClipData.h"
+#include "Animation/AnimationLod.h"
+#include "Animation/BlendShapeBatch.h"
+#include "Animation/CompressedAnimationClip.h"
+#include "Animation/PoseEvaluator.h"
+#include "Animation/PoseKernels.h"
+#include "Animation/SkinningPalette.h"
+#include "Animation/SoaPose.h"
+#include "Animation/VertexSkinning.h"
+#include "Core/Jobs/JobSystem.h"
+#include "ECWorld/SceneWorld.h"
+#include "Rendering/Resources/SkeletonResource.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+
+using namespace engine;
+
+template<typename T>
+struct TestKey
+{
+	float time;
+	T value;
+
+	float GetTime() const { return time; }
+	const T& GetValue() const { return value; }
+};
+
+using TranslationKey = TestKey<cd::Vec3f>;
+using RotationKey = TestKey<cd::Quaternion>;
+
+struct TestTrack
+{
+	std::vector<TranslationKey> translationKeys;
+	std::vector<RotationKey> rotationKeys;
+};
+
+bool IsNearlyEqual(float a, float b, float tolerance = 1e-4f)
+{
+	return std::abs(a - b) <= tolerance;
+}
+
+bool IsNearlyEqual(const cd::Vec3f& a, const cd::Vec3f& b, float tolerance = 1e-4f)
+{
+	return IsNearlyEqual(a[0], b[0], tolerance) && IsNearlyEqual(a[1], b[1], tolerance) && IsNearlyEqual(a[2], b[2], tolerance);
+}
+
+bool IsNearlyEqual(const cd::Matrix4x4& a, const cd::Matrix4x4& b, float tolerance = 1e-4f)
+{
+	for (uint32_t index = 0U; index < 16U; ++index)
+	{
+		if (!IsNearlyEqual(a.begin()[index], b.begin()[index], tolerance))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool IsNearlyEqual(const cd::Quaternion& a, const cd::Quaternion& b, float tolerance = 1e-4f)
+{
+	// q and -q are the same rotation.
+	float dot = a.x() * b.x() + a.y() * b.y() + a.z() * b.z() + a.w() * b.w();
+	return IsNearlyEqual(std::abs(dot), 1.0f, tolerance);
+}
+
+// Same key search as the renderers used before clips were compiled.
+template<typename Key, typename Interpolate>
+auto ScanKeys(const std::vector<Key>& keys, float time, Interpolate interpolate)
+{
+	for (uint32_t keyIndex = 0U; keyIndex + 1U < keys.size(); ++keyIndex)
+	{
+		const Key& nextKey = keys[keyIndex + 1U];
+		if (time <= nextKey.GetTime())
+		{
+			const Key& currentKey = keys[keyIndex];
+			float keyFrameRate = (time - currentKey.GetTime()) / (nextKey.GetTime() - currentKey.GetTime());
+			return interpolate(currentKey.GetValue(), nextKey.GetValue(), keyFrameRate);
+		}
+	}
+
+	return keys.back().GetValue();
+}
+
+TestTrack MakeTrack(uint32_t boneIndex, uint32_t keyCount, float duration)
+{
+	TestTrack track;
+	for (uint32_t keyIndex = 0U; keyIndex < keyCount; ++keyIndex)
+	{
+		float time = duration * static_cast<float>(keyIndex) / static_cast<float>(keyCount - 1U);
+		float phase = time * 3.0f + static_cast<float>(boneIndex);
+		track.translationKeys.push_back({ time, cd::Vec3f(std::sin(phase), std::cos(phase), static_cast<float>(boneIndex)) });
+		track.rotationKeys.push_back({ time, cd::Quaternion::RotateY(0.5f * std::sin(phase)) });
+	}
+
+	return track;
+}
+
+void Test_Resample()
+{
+	constexpr float duration = 2.0f;
+	std::vector<TranslationKey> translationKeys = {
+		{ 0.0f, cd::Vec3f(0.0f, 0.0f, 0.0f) },
+		{ 0.5f, cd::Vec3f(1.0f, 0.0f, 0.0f) },
+		{ 2.0f, cd::Vec3f(1.0f, 3.0f, 0.0f) },
+	};
+	std::vector<RotationKey> rotationKeys = {
+		{ 0.0f, cd::Quaternion::Identity() },
+		{ 2.0f, cd::Quaternion::RotateY(1.0f) },
+	};
+
+	AnimationClipData clip;
+	clip.Init(2U, duration);
+	clip.SetParentIndex(1U, 0U);
+	clip.ResampleTranslationKeys(1U, translationKeys.data(), static_cast<uint32_t>(translationKeys.size()));
+	clip.ResampleRotationKeys(1U, rotationKeys.data(), static_cast<uint32_t>(rotationKeys.size()));
+	assert(61U == clip.GetFrameCount());
+	assert(!clip.HasTrack(0U) && clip.HasTrack(1U));
+	assert(0U == clip.GetParentIndex(1U));
+	assert(AnimationClipData::InvalidBoneIndex == clip.GetParentIndex(0U));
+
+	// Keys on frames are exact, keys between frames are within the resampling error of linear segments.
+	auto lerp = [](const cd::Vec3f& a, const cd::Vec3f& b, float t) { return cd::Vec3f::Lerp(a, b, t); };
+	for (float time : { 0.0f, 0.25f, 0.5f, 0.51f, 1.234f, 2.0f })
+	{
+		cd::Transform transform = clip.SampleBone(1U, time);
+		assert(IsNearlyEqual(transform.GetTranslation(), ScanKeys(translationKeys, time, lerp), 0.02f));
+		assert(IsNearlyEqual(transform.GetRotation(), cd::Quaternion::RotateY(time * 0.5f), 1e-3f));
+		assert(IsNearlyEqual(transform.GetScale(), cd::Vec3f::One()));
+	}
+
+	// Bones without tracks stay identity and times out of the clip are clamped.
+	std::vector<cd::Transform> pose(clip.GetBoneCount());
+	clip.SamplePose(5.0f, pose.data());
+	assert(IsNearlyEqual(pose[0].GetTranslation(), cd::Vec3f::Zero()));
+	assert(IsNearlyEqual(pose[1].GetTranslation(), cd::Vec3f(1.0f, 3.0f, 0.0f)));
+	clip.SamplePose(-1.0f, pose.data());
+	assert(IsNearlyEqual(pose[1].GetTranslation(), cd::Vec3f::Zero()));
+
+	printf("[Success] Test_Resample\n");
+}
+
+void Test_SingleKey()
+{
+	std::vector<TranslationKey> translationKeys = { { 0.0f, cd::Vec3f(1.0f, 2.0f, 3.0f) } };
+
+	AnimationClipData clip;
+	clip.Init(1U, 0.0f);
+	clip.ResampleTranslationKeys(0U, translationKeys.data(), 1U);
+	assert(IsNearlyEqual(clip.SampleBone(0U, 0.0f).GetTranslation(), cd::Vec3f(1.0f, 2.0f, 3.0f)));
+	assert(IsNearlyEqual(clip.SampleBone(0U, 1.0f).GetTranslation(), cd::Vec3f(1.0f, 2.0f, 3.0f)));
+
+	printf("[Success] Test_SingleKey\n");
+}
+
+void Test_ResampleTicks()
+{
+	// Imported key times are in ticks. 25 ticks per second and 50 ticks make a 2 second clip.
+	constexpr float ticksPerSecond = 25.0f;
+	std::vector<TranslationKey> translationKeys = {
+		{ 0.0f, cd::Vec3f(0.0f, 0.0f, 0.0f) },
+		{ 50.0f, cd::Vec3f(2.0f, 0.0f, 0.0f) },
+	};
+
+	AnimationClipData clip;
+	clip.Init(1U, 50.0f / ticksPerSecond);
+	clip.ResampleTranslationKeys(0U, translationKeys.data(), 2U, 1.0f / ticksPerSecond);
+	assert(IsNearlyEqual(clip.GetDuration(), 2.0f));
+	for (float time : { 0.0f, 0.5f, 1.0f, 2.0f })
+	{
+		assert(IsNearlyEqual(clip.SampleBone(0U, time).GetTranslation(), cd::Vec3f(time, 0.0f, 0.0f)));
+	}
+
+	printf("[Success] Test_ResampleTicks\n");
+}
+
+void Test_SamplingBenchmark()
+{
+	constexpr uint32_t characterCount = 1000U;
+	constexpr uint32_t boneCount = 100U;
+	constexpr uint32_t keyCount = 60U;
+	constexpr float duration = 2.0f;
+	const std::string clipName = "Walk";
+
+	std::vector<std::string> boneNames;
+	std::unordered_map<std::string, TestTrack> tracks;
+	AnimationClipData clip;
+	clip.Init(boneCount, duration);
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		boneNames.push_back("Bone" + std::to_string(boneIndex));
+		TestTrack& track = tracks[clipName + boneNames.back()] = MakeTrack(boneIndex, keyCount, duration);
+		clip.ResampleTranslationKeys(boneIndex, track.translationKeys.data(), keyCount);
+		clip.ResampleRotationKeys(boneIndex, track.rotationKeys.data(), keyCount);
+	}
+
+	auto lerp = [](const cd::Vec3f& a, const cd::Vec3f& b, float t) { return cd::Vec3f::Lerp(a, b, t); };
+	auto slerp = [](const cd::Quaternion& a, const cd::Quaternion& b, float t) { return cd::Quaternion::SLerp(a, b, t).Normalize(); };
+	auto getCharacterTime = [duration](uint32_t characterIndex) { return duration * static_cast<float>(characterIndex) / characterCount; };
+
+	using Clock = std::chrono::steady_clock;
+	auto toMs = [](Clock::duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+
+	// Track lookup by name and key scans for every bone of every character.
+	std::vector<cd::Transform> scannedPoses(static_cast<size_t>(characterCount) * boneCount);
+	auto scanBegin = Clock::now();
+	for (uint32_t characterIndex = 0U; characterIndex < characterCount; ++characterIndex)
+	{
+		const float time = getCharacterTime(characterIndex);
+		for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+		{
+			const TestTrack& track = tracks.find(clipName + boneNames[boneIndex])->second;
+			scannedPoses[characterIndex * boneCount + boneIndex] = cd::Transform(ScanKeys(track.translationKeys, time, lerp),
+				ScanKeys(track.rotationKeys, time, slerp), cd::Vec3f::One());
+		}
+	}
+	const double scanMs = toMs(Clock::now() - scanBegin);
+
+	std::vector<cd::Transform> sampledPoses(static_cast<size_t>(characterCount) * boneCount);
+	auto sampleBegin = Clock::now();
+	for (uint32_t characterIndex = 0U; characterIndex < characterCount; ++characterIndex)
+	{
+		clip.SamplePose(getCharacterTime(characterIndex), &sampledPoses[characterIndex * boneCount]);
+	}
+	const double sampleMs = toMs(Clock::now() - sampleBegin);
+
+	for (size_t poseIndex = 0U; poseIndex < sampledPoses.size(); ++poseIndex)
+	{
+		assert(IsNearlyEqual(sampledPoses[poseIndex].GetTranslation(), scannedPoses[poseIndex].GetTranslation(), 0.02f));
+		assert(IsNearlyEqual(sampledPoses[poseIndex].GetRotation(), scannedPoses[poseIndex].GetRotation(), 1e-3f));
+	}
+
+	printf("[Benchmark] %u characters x %u bones : key scan %.3f ms, compiled clip %.3f ms (%.1fx)\n",
+		characterCount, boneCount, scanMs, sampleMs, scanMs / sampleMs);
+	printf("[Success] Test_SamplingBenchmark\n");
+}
+
+// Same recursion as the renderers used before the flat walk.
+void BuildGlobalMatricesRecursive(const std::vector<std::vector<uint32_t>>& children, uint32_t boneIndex, const cd::Matrix4x4& parentMatrix,
+	const cd::Transform* pLocalPose, cd::Matrix4x4* pGlobalMatrices)
+{
+	pGlobalMatrices[boneIndex] = parentMatrix * pLocalPose[boneIndex].GetMatrix();
+	for (uint32_t childIndex : children[boneIndex])
+	{
+		BuildGlobalMatricesRecursive(children, childIndex, pGlobalMatrices[boneIndex], pLocalPose, pGlobalMatrices);
+	}
+}
+
+// Spine with branches every few bones like arms and fingers.
+AnimationClipData MakeSkeletonClip(uint32_t boneCount, float duration, std::vector<std::vector<uint32_t>>* pChildren = nullptr)
+{
+	AnimationClipData clip;
+	clip.Init(boneCount, duration);
+	for (uint32_t boneIndex = 1U; boneIndex < boneCount; ++boneIndex)
+	{
+		uint32_t parentIndex = 0U == boneIndex % 5U ? boneIndex / 2U : boneIndex - 1U;
+		clip.SetParentIndex(boneIndex, parentIndex);
+		if (pChildren)
+		{
+			pChildren->resize(boneCount);
+			(*pChildren)[parentIndex].push_back(boneIndex);
+		}
+
+		TestTrack track = MakeTrack(boneIndex, 30U, duration);
+		clip.ResampleTranslationKeys(boneIndex, track.translationKeys.data(), 30U);
+		clip.ResampleRotationKeys(boneIndex, track.rotationKeys.data(), 30U);
+	}
+
+	return clip;
+}
+
+void Test_FlatHierarchyWalk()
+{
+	constexpr uint32_t boneCount = 24U;
+	std::vector<std::vector<uint32_t>> children;
+	AnimationClipData clip = MakeSkeletonClip(boneCount, 1.0f, &children);
+
+	std::vector<cd::Transform> localPose(boneCount);
+	SoaPose soaPose(boneCount);
+	clip.SamplePose(0.37f, localPose.data());
+	clip.SamplePose(0.37f, soaPose);
+
+	std::vector<cd::Matrix4x4> flatMatrices(boneCount);
+	std::vector<cd::Matrix4x4> recursiveMatrices(boneCount);
+	PoseKernels::LocalToModelScalar(soaPose, clip, flatMatrices.data());
+	BuildGlobalMatricesRecursive(children, 0U, cd::Matrix4x4::Identity(), localPose.data(), recursiveMatrices.data());
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		assert(IsNearlyEqual(soaPose.GetTransform(boneIndex).GetTranslation(), localPose[boneIndex].GetTranslation()));
+		assert(IsNearlyEqual(flatMatrices[boneIndex], recursiveMatrices[boneIndex]));
+	}
+
+	// Blending a pose with itself keeps it. Weight 1 gives the second pose.
+	SoaPose otherPose(boneCount);
+	SoaPose blendedPose(boneCount);
+	clip.SamplePose(0.81f, otherPose);
+	const SoaPose* selfPoses[] = { &soaPose, &soaPose };
+	const float halfWeights[] = { 0.5f, 0.5f };
+	PoseKernels::BlendPoses(selfPoses, halfWeights, 2U, blendedPose);
+	assert(IsNearlyEqual(blendedPose.GetTransform(7U).GetTranslation(), localPose[7].GetTranslation()));
+	assert(IsNearlyEqual(blendedPose.GetTransform(7U).GetRotation(), localPose[7].GetRotation()));
+	const SoaPose* poses[] = { &soaPose, &otherPose };
+	const float weights[] = { 0.0f, 1.0f };
+	PoseKernels::BlendPoses(poses, weights, 2U, blendedPose);
+	assert(IsNearlyEqual(blendedPose.GetTransform(7U).GetRotation(), otherPose.GetTransform(7U).GetRotation()));
+
+	printf("[Success] Test_FlatHierarchyWalk\n");
+}
+
+void Test_PoseKernels()
+{
+	// Not a multiple of the lane count so padding bones are covered too.
+	constexpr uint32_t boneCount = 37U;
+	AnimationClipData clip = MakeSkeletonClip(boneCount, 2.0f);
+
+	SoaPose poseA(boneCount);
+	SoaPose poseB(boneCount);
+	SoaPose poseC(boneCount);
+	clip.SamplePose(0.1f, poseA);
+	clip.SamplePose(0.9f, poseB);
+	clip.SamplePose(1.7f, poseC);
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; boneIndex += 3U)
+	{
+		// Opposite hemisphere and non uniform scale.
+		cd::Transform transform = poseC.GetTransform(boneIndex);
+		cd::Quaternion rotation = transform.GetRotation();
+		rotation.x() = -rotation.x();
+		rotation.y() = -rotation.y();
+		rotation.z() = -rotation.z();
+		rotation.w() = -rotation.w();
+		transform.SetRotation(rotation);
+		transform.SetScale(cd::Vec3f(1.0f, 2.0f, 0.5f));
+		poseC.SetTransform(boneIndex, transform);
+	}
+
+	auto isNearlyEqualPose = [](const SoaPose& a, const SoaPose& b)
+	{
+		for (uint32_t boneIndex = 0U; boneIndex < a.GetBoneCount(); ++boneIndex)
+		{
+			const cd::Transform transformA = a.GetTransform(boneIndex);
+			const cd::Transform transformB = b.GetTransform(boneIndex);
+			if (!IsNearlyEqual(transformA.GetTranslation(), transformB.GetTranslation()) ||
+				!IsNearlyEqual(transformA.GetRotation(), transformB.GetRotation()) ||
+				!IsNearlyEqual(transformA.GetScale(), transformB.GetScale()))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	};
+
+	// N-way blend.
+	const SoaPose* poses[] = { &poseA, &poseB, &poseC };
+	const float weights[] = { 0.2f, 0.5f, 0.3f };
+	SoaPose simdPose(boneCount);
+	SoaPose scalarPose(boneCount);
+	PoseKernels::BlendPoses(poses, weights, 3U, simdPose);
+	PoseKernels::BlendPosesScalar(poses, weights, 3U, scalarPose);
+	assert(isNearlyEqualPose(simdPose, scalarPose));
+
+	// Additive layer on top of the blend.
+	PoseKernels::AddLayer(simdPose, poseC, 0.4f);
+	PoseKernels::AddLayerScalar(scalarPose, poseC, 0.4f);
+	assert(isNearlyEqualPose(simdPose, scalarPose));
+
+	// Full weight of a delta rotates by the delta, zero weight keeps the pose.
+	SoaPose deltaPose(boneCount);
+	cd::Transform delta = cd::Transform::Identity();
+	delta.SetRotation(cd::Quaternion::RotateY(0.5f));
+	deltaPose.SetTransform(4U, delta);
+	SoaPose layeredPose(boneCount);
+	PoseKernels::AddLayer(layeredPose, deltaPose, 1.0f);
+	assert(IsNearlyEqual(layeredPose.GetTransform(4U).GetRotation(), cd::Quaternion::RotateY(0.5f)));
+	layeredPose = poseA;
+	PoseKernels::AddLayer(layeredPose, poseB, 0.0f);
+	assert(isNearlyEqualPose(layeredPose, poseA));
+
+	// Local to model against cd::Transform::GetMatrix and cd::Matrix4x4 products.
+	std::vector<cd::Matrix4x4> simdMatrices(boneCount);
+	std::vector<cd::Matrix4x4> scalarMatrices(boneCount);
+	PoseKernels::LocalToModel(simdPose, clip, simdMatrices.data());
+	PoseKernels::LocalToModelScalar(simdPose, clip, scalarMatrices.data());
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		assert(IsNearlyEqual(simdMatrices[boneIndex], scalarMatrices[boneIndex], 1e-3f));
+	}
+
+	printf("[Success] Test_PoseKernels (%s)\n", PoseKernels::GetInstructionSetName());
+}
+
+void Test_PoseKernelsBenchmark()
+{
+	constexpr uint32_t characterCount = 1000U;
+	constexpr uint32_t boneCount = 100U;
+	constexpr float duration = 2.0f;
+	AnimationClipData clip = MakeSkeletonClip(boneCount, duration);
+
+	std::vector<SoaPose> posesA(characterCount, SoaPose(boneCount));
+	std::vector<SoaPose> posesB(characterCount, SoaPose(boneCount));
+	for (uint32_t characterIndex = 0U; characterIndex < characterCount; ++characterIndex)
+	{
+		const float time = duration * static_cast<float>(characterIndex) / characterCount;
+		clip.SamplePose(time, posesA[characterIndex]);
+		clip.SamplePose(duration - time, posesB[characterIndex]);
+	}
+
+	std::vector<SoaPose> scalarPoses(characterCount, SoaPose(boneCount));
+	std::vector<SoaPose> simdPoses(characterCount, SoaPose(boneCount));
+	std::vector<cd::Matrix4x4> scalarMatrices(static_cast<size_t>(characterCount) * boneCount);
+	std::vector<cd::Matrix4x4> simdMatrices(static_cast<size_t>(characterCount) * boneCount);
+	const float weights[] = { 0.3f, 0.7f };
+
+	using Clock = std::chrono::steady_clock;
+	auto toMs = [](Clock::duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+
+	auto scalarBegin = Clock::now();
+	for (uint32_t characterIndex = 0U; characterIndex < characterCount; ++characterIndex)
+	{
+		const SoaPose* poses[] = { &posesA[characterIndex], &posesB[characterIndex] };
+		PoseKernels::BlendPosesScalar(poses, weights, 2U, scalarPoses[characterIndex]);
+		PoseKernels::LocalToModelScalar(scalarPoses[characterIndex], clip, &scalarMatrices[characterIndex * boneCount]);
+	}
+	const double scalarMs = toMs(Clock::now() - scalarBegin);
+
+	auto simdBegin = Clock::now();
+	for (uint32_t characterIndex = 0U; characterIndex < characterCount; ++characterIndex)
+	{
+		const SoaPose* poses[] = { &posesA[characterIndex], &posesB[characterIndex] };
+		PoseKernels::BlendPoses(poses, weights, 2U, simdPoses[characterIndex]);
+		PoseKernels::LocalToModel(simdPoses[characterIndex], clip, &simdMatrices[characterIndex * boneCount]);
+	}
+	const double simdMs = toMs(Clock::now() - simdBegin);
+
+	for (size_t matrixIndex = 0U; matrixIndex < simdMatrices.size(); ++matrixIndex)
+	{
+		assert(IsNearlyEqual(simdMatrices[matrixIndex], scalarMatrices[matrixIndex], 1e-3f));
+	}
+
+	printf("[Benchmark] %u characters x %u bones blend and local to model : scalar %.3f ms, %s %.3f ms (%.1fx)\n",
+		characterCount, boneCount, scalarMs, PoseKernels::GetInstructionSetName(), simdMs, scalarMs / simdMs);
+	printf("[Success] Test_PoseKernelsBenchmark\n");
+}
+
+// Same math as SkinPositionLinearBlend and SkinPositionDualQuaternion in Skinning.sh for one influence.
+cd::Vec3f SkinWithMatrixTexels(const float* pTexels, const cd::Vec3f& position)
+{
+	cd::Vec3f result;
+	for (uint32_t row = 0U; row < 3U; ++row)
+	{
+		const float* pRow = pTexels + row * 4U;
+		result[row] = pRow[0] * position[0] + pRow[1] * position[1] + pRow[2] * position[2] + pRow[3];
+	}
+
+	return result;
+}
+
+cd::Vec3f SkinWithDualQuaternionTexels(const float* pTexels, const cd::Vec3f& position)
+{
+	auto cross = [](const float* a, const cd::Vec3f& b) { return cd::Vec3f(a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]); };
+	const float* pReal = pTexels;
+	const float* pDual = pTexels + 4U;
+
+	const cd::Vec3f realCross = cross(pReal, position);
+	const cd::Vec3f inner(realCross[0] + pReal[3] * position[0], realCross[1] + pReal[3] * position[1], realCross[2] + pReal[3] * position[2]);
+	const cd::Vec3f rotatedCross = cross(pReal, inner);
+	const cd::Vec3f dualCross = cross(pReal, cd::Vec3f(pDual[0], pDual[1], pDual[2]));
+	cd::Vec3f result;
+	for (uint32_t axis = 0U; axis < 3U; ++axis)
+	{
+		const float translation = 2.0f * (pReal[3] * pDual[axis] - pDual[3] * pReal[axis] + dualCross[axis]);
+		result[axis] = position[axis] + 2.0f * rotatedCross[axis] + translation;
+	}
+
+	return result;
+}
+
+cd::Vec3f TransformPoint(const cd::Matrix4x4& matrix, const cd::Vec3f& position)
+{
+	const float* pMatrix = matrix.begin();
+	return cd::Vec3f(pMatrix[0] * position[0] + pMatrix[4] * position[1] + pMatrix[8] * position[2] + pMatrix[12],
+		pMatrix[1] * position[0] + pMatrix[5] * position[1] + pMatrix[9] * position[2] + pMatrix[13],
+		pMatrix[2] * position[0] + pMatrix[6] * position[1] + pMatrix[10] * position[2] + pMatrix[14]);
+}
+
+void Test_SkinningPalette()
+{
+	// Rigid skinning matrices from a posed skeleton.
+	constexpr uint32_t boneCount = 300U;
+	AnimationClipData clip = MakeSkeletonClip(boneCount, 1.0f);
+	SoaPose pose(boneCount);
+	clip.SamplePose(0.6f, pose);
+	std::vector<cd::Matrix4x4> skinningMatrices(boneCount);
+	PoseKernels::LocalToModel(pose, clip, skinningMatrices.data());
+
+	// Palettes of characters are appended after each other, more bones than a uniform array can hold.
+	SkinningPalette palette;
+	palette.Reset();
+	const uint32_t matrixTexel = palette.Append(skinningMatrices.data(), boneCount, SkinningMode::LinearBlend);
+	const uint32_t dualQuaternionTexel = palette.Append(skinningMatrices.data(), boneCount, SkinningMode::DualQuaternion);
+	assert(0U == matrixTexel);
+	assert(boneCount * SkinningPalette::GetTexelsPerBone(SkinningMode::LinearBlend) == dualQuaternionTexel);
+	assert(boneCount * 5U == palette.GetTexelCount());
+	assert(2U == palette.GetRowCount());
+	assert(palette.GetDataSize() == 2U * SkinningPalette::TextureWidth * 4U * sizeof(float));
+
+	const cd::Vec3f position(0.3f, -1.2f, 2.5f);
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		const cd::Vec3f expected = TransformPoint(skinningMatrices[boneIndex], position);
+		const float* pMatrixTexels = palette.GetData() + (matrixTexel + boneIndex * 3U) * 4U;
+		const float* pDualQuaternionTexels = palette.GetData() + (dualQuaternionTexel + boneIndex * 2U) * 4U;
+		assert(IsNearlyEqual(SkinWithMatrixTexels(pMatrixTexels, position), expected, 1e-3f));
+		assert(IsNearlyEqual(SkinWithDualQuaternionTexels(pDualQuaternionTexels, position), expected, 1e-3f));
+	}
+
+	// Reset keeps the memory for the next frame.
+	const float* pData = palette.GetData();
+	palette.Reset();
+	assert(0U == palette.Append(skinningMatrices.data(), 10U, SkinningMode::DualQuaternion));
+	assert(pData == palette.GetData() && 1U == palette.GetRowCount());
+
+	printf("[Success] Test_SkinningPalette\n");
+}
+
+void Test_VertexSkinning()
+{
+	constexpr uint32_t boneCount = 64U;
+	AnimationClipData clip = MakeSkeletonClip(boneCount, 1.0f);
+	SoaPose pose(boneCount);
+	clip.SamplePose(0.3f, pose);
+	std::vector<cd::Matrix4x4> skinningMatrices(boneCount);
+	PoseKernels::LocalToModel(pose, clip, skinningMatrices.data());
+
+	// Another character in front so that palettes are read from their first texel.
+	SkinningPalette palette;
+	palette.Append(skinningMatrices.data(), 5U, SkinningMode::DualQuaternion);
+	const uint32_t matrixTexel = palette.Append(skinningMatrices.data(), boneCount, SkinningMode::LinearBlend);
+	const uint32_t dualQuaternionTexel = palette.Append(skinningMatrices.data(), boneCount, SkinningMode::DualQuaternion);
+
+	constexpr uint32_t vertexCount = 256U;
+	std::vector<SkinningVertex> vertices(vertexCount);
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		SkinningVertex& vertex = vertices[vertexIndex];
+		const float offset = static_cast<float>(vertexIndex) * 0.01f;
+		vertex = { { 0.5f + offset, -1.0f, 2.0f - offset, 1.0f }, { 0.0f, 0.6f, 0.8f, 0.0f },
+			{ static_cast<float>(vertexIndex % boneCount), static_cast<float>((vertexIndex * 7U) % boneCount), static_cast<float>((vertexIndex * 13U) % boneCount), 0.0f },
+			{ 0.5f, 0.25f, 0.25f, 0.0f } };
+	}
+
+	// Linear blend skinning is the weighted sum of bone transforms.
+	std::vector<SkinnedVertex> skinnedVertices(vertexCount);
+	VertexSkinning::SkinVertices(palette.GetData() + matrixTexel * 4U, SkinningMode::LinearBlend, vertices.data(), vertexCount, skinnedVertices.data());
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const SkinningVertex& vertex = vertices[vertexIndex];
+		const cd::Vec3f position(vertex.position[0], vertex.position[1], vertex.position[2]);
+		cd::Vec3f expected(0.0f, 0.0f, 0.0f);
+		for (uint32_t influence = 0U; influence < 4U; ++influence)
+		{
+			const cd::Vec3f bonePosition = TransformPoint(skinningMatrices[static_cast<uint32_t>(vertex.boneIndices[influence])], position);
+			for (uint32_t axis = 0U; axis < 3U; ++axis)
+			{
+				expected[axis] += bonePosition[axis] * vertex.boneWeights[influence];
+			}
+		}
+
+		const SkinnedVertex& skinnedVertex = skinnedVertices[vertexIndex];
+		assert(IsNearlyEqual(cd::Vec3f(skinnedVertex.position[0], skinnedVertex.position[1], skinnedVertex.position[2]), expected, 1e-3f));
+		const float normalLength = std::sqrt(skinnedVertex.normal[0] * skinnedVertex.normal[0] + skinnedVertex.normal[1] * skinnedVertex.normal[1] + skinnedVertex.normal[2] * skinnedVertex.normal[2]);
+		assert(IsNearlyEqual(normalLength, 1.0f, 1e-4f) && 1.0f == skinnedVertex.position[3] && 0.0f == skinnedVertex.normal[3]);
+	}
+
+	// With one influence dual quaternions and matrices move vertices and normals the same way for rigid bones.
+	for (SkinningVertex& vertex : vertices)
+	{
+		vertex.boneWeights[0] = 1.0f;
+		vertex.boneWeights[1] = 0.0f;
+		vertex.boneWeights[2] = 0.0f;
+	}
+	std::vector<SkinnedVertex> dualQuaternionVertices(vertexCount);
+	VertexSkinning::SkinVertices(palette.GetData() + matrixTexel * 4U, SkinningMode::LinearBlend, vertices.data(), vertexCount, skinnedVertices.data());
+	VertexSkinning::SkinVertices(palette.GetData() + dualQuaternionTexel * 4U, SkinningMode::DualQuaternion, vertices.data(), vertexCount, dualQuaternionVertices.data());
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const SkinnedVertex& a = skinnedVertices[vertexIndex];
+		const SkinnedVertex& b = dualQuaternionVertices[vertexIndex];
+		assert(IsNearlyEqual(cd::Vec3f(a.position[0], a.position[1], a.position[2]), cd::Vec3f(b.position[0], b.position[1], b.position[2]), 1e-3f));
+		assert(IsNearlyEqual(cd::Vec3f(a.normal[0], a.normal[1], a.normal[2]), cd::Vec3f(b.normal[0], b.normal[1], b.normal[2]), 1e-3f));
+	}
+
+	// Meshes without normals keep a zero normal.
+	vertices[0].normal[0] = vertices[0].normal[1] = vertices[0].normal[2] = 0.0f;
+	VertexSkinning::SkinVertices(palette.GetData() + dualQuaternionTexel * 4U, SkinningMode::DualQuaternion, vertices.data(), 1U, dualQuaternionVertices.data());
+	assert(0.0f == dualQuaternionVertices[0].normal[0] && 0.0f == dualQuaternionVertices[0].normal[1] && 0.0f == dualQuaternionVertices[0].normal[2]);
+
+	printf("[Success] Test_VertexSkinning\n");
+}
+
+// Like mocap : one key per frame, constant bone lengths and a moving root.
+AnimationClipData MakeMocapClip(uint32_t boneCount, float duration)
+{
+	constexpr float keyRate = 30.0f;
+	const uint32_t keyCount = static_cast<uint32_t>(duration * keyRate) + 1U;
+	std::vector<TranslationKey> translationKeys(keyCount);
+	std::vector<RotationKey> rotationKeys(keyCount);
+
+	AnimationClipData clip;
+	clip.Init(boneCount, duration);
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		if (boneIndex > 0U)
+		{
+			clip.SetParentIndex(boneIndex, 0U == boneIndex % 5U ? boneIndex / 2U : boneIndex - 1U);
+		}
+
+		const float frequency = 1.0f + static_cast<float>(boneIndex % 7U) * 0.5f;
+		for (uint32_t keyIndex = 0U; keyIndex < keyCount; ++keyIndex)
+		{
+			const float time = static_cast<float>(keyIndex) / keyRate;
+			const float phase = time * frequency + static_cast<float>(boneIndex);
+			translationKeys[keyIndex] = { time, 0U == boneIndex ? cd::Vec3f(time * 1.5f, 0.9f + 0.05f * std::sin(phase * 4.0f), 0.0f) : cd::Vec3f(0.0f, 0.2f, 0.0f) };
+			rotationKeys[keyIndex] = { time, cd::Quaternion::RotateY(0.6f * std::sin(phase)) };
+		}
+
+		clip.ResampleTranslationKeys(boneIndex, translationKeys.data(), keyCount);
+		clip.ResampleRotationKeys(boneIndex, rotationKeys.data(), keyCount);
+	}
+
+	return clip;
+}
+
+// From the chord between both rotations which is precise for small angles.
+float RotationAngle(const cd::Quaternion& a, const cd::Quaternion& b)
+{
+	const float sign = a.x() * b.x() + a.y() * b.y() + a.z() * b.z() + a.w() * b.w() < 0.0f ? -1.0f : 1.0f;
+	const float x = a.x() - b.x() * sign;
+	const float y = a.y() - b.y() * sign;
+	const float z = a.z() - b.z() * sign;
+	const float w = a.w() - b.w() * sign;
+	return 4.0f * std::asin(std::min(0.5f * std::sqrt(x * x + y * y + z * z + w * w), 1.0f));
+}
+
+// Largest distance between virtual vertices of both clips. Vertices are placed around every bone in model space
+// so that rotation errors are scaled by a typical skin distance like translation errors.
+float MeasureModelError(const AnimationClipData& clip, const AnimationClipData& compressedClip, float vertexDistance, float timeStep)
+{
+	const uint32_t boneCount = clip.GetBoneCount();
+	SoaPose pose(boneCount);
+	SoaPose compressedPose(boneCount);
+	std::vector<cd::Matrix4x4> modelMatrices(boneCount);
+	std::vector<cd::Matrix4x4> compressedModelMatrices(boneCount);
+	const cd::Vec3f vertices[] = { cd::Vec3f(vertexDistance, 0.0f, 0.0f), cd::Vec3f(0.0f, vertexDistance, 0.0f), cd::Vec3f(0.0f, 0.0f, vertexDistance) };
+
+	float maxError = 0.0f;
+	for (float time = 0.0f; time <= clip.GetDuration(); time += timeStep)
+	{
+		clip.SamplePose(time, pose);
+		compressedClip.SamplePose(time, compressedPose);
+		PoseKernels::LocalToModel(pose, clip, modelMatrices.data());
+		PoseKernels::LocalToModel(compressedPose, compressedClip, compressedModelMatrices.data());
+		for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+		{
+			for (const cd::Vec3f& vertex : vertices)
+			{
+				const cd::Vec3f position = TransformPoint(modelMatrices[boneIndex], vertex);
+				const cd::Vec3f compressedPosition = TransformPoint(compressedModelMatrices[boneIndex], vertex);
+				const float dx = position[0] - compressedPosition[0];
+				const float dy = position[1] - compressedPosition[1];
+				const float dz = position[2] - compressedPosition[2];
+				maxError = std::max(maxError, std::sqrt(dx * dx + dy * dy + dz * dz));
+			}
+		}
+	}
+
+	return maxError;
+}
+
+void Test_ClipCompression()
+{
+	constexpr uint32_t boneCount = 20U;
+	constexpr float duration = 4.0f;
+	AnimationClipData clip = MakeMocapClip(boneCount, duration);
+	AnimationClipData compressedClip = MakeMocapClip(boneCount, duration);
+	AnimationCompressionSettings settings;
+	assert(compressedClip.Compress(settings) && compressedClip.IsCompressed());
+	assert(compressedClip.GetMemorySize() < clip.GetMemorySize());
+	// Frames are freed.
+	assert(compressedClip.GetMemorySize() == compressedClip.GetCompressedClip().GetMemorySize());
+
+	// Every frame is within the tolerances, quantization included.
+	const float frameInterval = duration / static_cast<float>(clip.GetFrameCount() - 1U);
+	for (uint32_t frameIndex = 0U; frameIndex < clip.GetFrameCount(); ++frameIndex)
+	{
+		const float time = static_cast<float>(frameIndex) * frameInterval;
+		for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+		{
+			const cd::Transform expected = clip.SampleBone(boneIndex, time);
+			const cd::Transform actual = compressedClip.SampleBone(boneIndex, time);
+			assert(IsNearlyEqual(actual.GetTranslation(), expected.GetTranslation(), settings.translationTolerance + 1e-5f));
+			assert(RotationAngle(actual.GetRotation(), expected.GetRotation()) <= settings.rotationTolerance + 1e-5f);
+			assert(IsNearlyEqual(actual.GetScale(), expected.GetScale(), settings.scaleTolerance + 1e-5f));
+		}
+	}
+
+	// Constant translations and scales keep one key.
+	const CompressedAnimationClip& compressedData = compressedClip.GetCompressedClip();
+	assert(compressedData.GetKeyCount() < boneCount * 3U * clip.GetFrameCount() / 2U);
+
+	// Zero tolerances keep all animated frames, the error is only quantization.
+	AnimationClipData exactClip = MakeMocapClip(boneCount, duration);
+	AnimationCompressionSettings exactSettings;
+	exactSettings.translationTolerance = 0.0f;
+	exactSettings.rotationTolerance = 0.0f;
+	exactSettings.scaleTolerance = 0.0f;
+	assert(exactClip.Compress(exactSettings));
+	for (float time : { 0.0f, 0.5f, 1.37f, 4.0f })
+	{
+		for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+		{
+			const cd::Transform expected = clip.SampleBone(boneIndex, time);
+			const cd::Transform actual = exactClip.SampleBone(boneIndex, time);
+			assert(IsNearlyEqual(actual.GetTranslation(), expected.GetTranslation(), 1e-4f));
+			assert(IsNearlyEqual(actual.GetRotation(), expected.GetRotation(), 1e-6f));
+		}
+	}
+
+	// Cursors only skip searches, forward and backward sampling returns the same poses.
+	AnimationSampleCursor cursor;
+	SoaPose pose(boneCount);
+	SoaPose cursorPose(boneCount);
+	for (float time : { 0.0f, 0.01f, 0.3f, 0.31f, 2.9f, 1.2f, 1.25f, 4.0f, 0.0f })
+	{
+		compressedClip.SamplePose(time, pose);
+		compressedClip.SamplePose(time, cursorPose, UINT32_MAX, &cursor);
+		for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+		{
+			assert(IsNearlyEqual(pose.GetTransform(boneIndex).GetTranslation(), cursorPose.GetTransform(boneIndex).GetTranslation(), 0.0f));
+			assert(IsNearlyEqual(pose.GetTransform(boneIndex).GetRotation(), cursorPose.GetTransform(boneIndex).GetRotation(), 1e-6f));
+		}
+	}
+
+	// Linear tracks are split into bounded segments. Bones without tracks keep one identity key per track.
+	AnimationClipData linearClip;
+	linearClip.Init(2U, 60.0f);
+	const TranslationKey translationKeys[] = { { 0.0f, cd::Vec3f::Zero() }, { 60.0f, cd::Vec3f(6.0f, 0.0f, 0.0f) } };
+	linearClip.ResampleTranslationKeys(0U, translationKeys, 2U);
+	const uint32_t linearFrameCount = linearClip.GetFrameCount();
+	assert(linearClip.Compress());
+	const uint32_t minSegmentCount = (linearFrameCount - 2U) / CompressedAnimationClip::MaxSegmentFrameCount + 1U;
+	const uint32_t linearKeyCount = linearClip.GetCompressedClip().GetKeyCount();
+	assert(linearKeyCount >= minSegmentCount + 1U + 5U && linearKeyCount < linearFrameCount / 8U);
+	assert(IsNearlyEqual(linearClip.SampleBone(0U, 31.0f).GetTranslation(), cd::Vec3f(3.1f, 0.0f, 0.0f), 1e-3f));
+	assert(IsNearlyEqual(linearClip.SampleBone(1U, 31.0f).GetScale(), cd::Vec3f::One()));
+
+	// Frame indices are 16 bits. Longer clips keep their uncompressed frames.
+	AnimationClipData longClip;
+	longClip.Init(1U, 2200.0f);
+	assert(!longClip.Compress() && !longClip.IsCompressed());
+	assert(IsNearlyEqual(longClip.SampleBone(0U, 1.0f).GetScale(), cd::Vec3f::One()));
+
+	printf("[Success] Test_ClipCompression\n");
+}
+
+void Test_ClipCompressionBenchmark()
+{
+	constexpr uint32_t boneCount = 60U;
+	constexpr float duration = 20.0f;
+	constexpr float vertexDistance = 0.1f;
+	AnimationClipData clip = MakeMocapClip(boneCount, duration);
+	AnimationClipData compressedClip = MakeMocapClip(boneCount, duration);
+
+	using Clock = std::chrono::steady_clock;
+	auto toMs = [](Clock::duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+	auto compressBegin = Clock::now();
+	assert(compressedClip.Compress());
+	const double compressMs = toMs(Clock::now() - compressBegin);
+
+	// Half frame steps so that errors between keys are measured too.
+	const float maxError = MeasureModelError(clip, compressedClip, vertexDistance, 0.5f / AnimationClipData::DefaultSampleRate);
+	assert(maxError < 0.01f);
+
+	constexpr uint32_t sampleCount = 2000U;
+	SoaPose pose(boneCount);
+	auto sampleBegin = Clock::now();
+	for (uint32_t sampleIndex = 0U; sampleIndex < sampleCount; ++sampleIndex)
+	{
+		clip.SamplePose(duration * static_cast<float>(sampleIndex) / sampleCount, pose);
+	}
+	const double sampleMs = toMs(Clock::now() - sampleBegin);
+	auto compressedSampleBegin = Clock::now();
+	for (uint32_t sampleIndex = 0U; sampleIndex < sampleCount; ++sampleIndex)
+	{
+		compressedClip.SamplePose(duration * static_cast<float>(sampleIndex) / sampleCount, pose);
+	}
+	const double compressedSampleMs = toMs(Clock::now() - compressedSampleBegin);
+	AnimationSampleCursor cursor;
+	auto cursorSampleBegin = Clock::now();
+	for (uint32_t sampleIndex = 0U; sampleIndex < sampleCount; ++sampleIndex)
+	{
+		compressedClip.SamplePose(duration * static_cast<float>(sampleIndex) / sampleCount, pose, UINT32_MAX, &cursor);
+	}
+	const double cursorSampleMs = toMs(Clock::now() - cursorSampleBegin);
+
+	const size_t memorySize = clip.GetMemorySize();
+	const size_t compressedMemorySize = compressedClip.GetMemorySize();
+	printf("[Benchmark] %u bones x %u frames : %zu KB -> %zu KB (%.1fx), %u keys, max error %.5f at %.2f from bones, compress %.3f ms\n",
+		boneCount, clip.GetFrameCount(), memorySize / 1024U, compressedMemorySize / 1024U, static_cast<double>(memorySize) / compressedMemorySize,
+		compressedClip.GetCompressedClip().GetKeyCount(), maxError, vertexDistance, compressMs);
+	printf("[Benchmark] %u poses : frames %.3f ms, compressed %.3f ms, compressed with cursor %.3f ms\n", sampleCount, sampleMs, compressedSampleMs, cursorSampleMs);
+	printf("[Success] Test_ClipCompressionBenchmark\n");
+}
+
+// Left handed perspective projection like bgfx uses, column major.
+cd::Matrix4x4 MakePerspective(float fovY, float nearZ, float farZ)
+{
+	cd::Matrix4x4 projection = cd::Matrix4x4::Identity();
+	float* pElements = reinterpret_cast<float*>(&projection);
+	const float yScale = 1.0f / std::tan(fovY * 0.5f);
+	pElements[0] = yScale;
+	pElements[5] = yScale;
+	pElements[10] = farZ / (farZ - nearZ);
+	pElements[11] = 1.0f;
+	pElements[14] = -nearZ * farZ / (farZ - nearZ);
+	pElements[15] = 0.0f;
+	return projection;
+}
+
+void Test_AnimationLod()
+{
+	// Camera at the origin looking down +z.
+	const cd::Matrix4x4 view = cd::Matrix4x4::Identity();
+	const cd::Matrix4x4 projection = MakePerspective(1.0471976f, 0.1f, 100.0f);
+	const float screenSize = AnimationLod::GetScreenSize(view, projection, cd::Vec3f(0.0f, 0.0f, 10.0f), 1.0f);
+	assert(IsNearlyEqual(screenSize, 1.7320508f / 10.0f));
+	assert(AnimationLod::GetScreenSize(view, projection, cd::Vec3f(0.0f, 0.0f, 40.0f), 1.0f) < screenSize);
+	assert(0.0f == AnimationLod::GetScreenSize(view, projection, cd::Vec3f(0.0f, 0.0f, -10.0f), 1.0f));
+	assert(0.0f == AnimationLod::GetScreenSize(view, projection, cd::Vec3f(30.0f, 0.0f, 10.0f), 1.0f));
+	assert(0.0f == AnimationLod::GetScreenSize(view, projection, cd::Vec3f(0.0f, 0.0f, 200.0f), 1.0f));
+	// Partially inside the frustum and around the camera.
+	assert(AnimationLod::GetScreenSize(view, projection, cd::Vec3f(6.5f, 0.0f, 10.0f), 1.0f) > 0.0f);
+	assert(AnimationLod::GetScreenSize(view, projection, cd::Vec3f(0.0f, 0.0f, 0.0f), 1.0f) > 1.0f);
+
+	AnimationLodSettings settings;
+	assert(AnimationLodLevel::Full == AnimationLod::SelectLevel(0.5f, settings));
+	assert(AnimationLodLevel::Half == AnimationLod::SelectLevel(screenSize, settings));
+	assert(AnimationLodLevel::Quarter == AnimationLod::SelectLevel(0.01f, settings));
+	assert(AnimationLodLevel::Culled == AnimationLod::SelectLevel(0.001f, settings));
+	assert(AnimationLodLevel::Culled == AnimationLod::SelectLevel(0.0f, settings));
+	// Shadow casters keep the lowest update rate outside of the view.
+	assert(AnimationLodLevel::Quarter == AnimationLod::SelectLevel(0.0f, settings, true));
+	assert(AnimationLodLevel::Half == AnimationLod::SelectLevel(screenSize, settings, true));
+	assert(0U == AnimationLod::GetUpdateInterval(AnimationLodLevel::Culled, settings));
+	assert(!AnimationLod::IsLeafBoneSkipped(AnimationLodLevel::Half, settings));
+	assert(AnimationLod::IsLeafBoneSkipped(AnimationLodLevel::Quarter, settings));
+
+	// Every entity updates once per interval, and entities with consecutive staggers on different frames.
+	constexpr uint32_t interval = 4U;
+	uint32_t updatesPerFrame[interval] = {};
+	for (uint32_t stagger = 0U; stagger < interval * 8U; ++stagger)
+	{
+		uint32_t updateCount = 0U;
+		for (uint64_t frameIndex = 0U; frameIndex < interval; ++frameIndex)
+		{
+			if (AnimationLod::IsUpdateFrame(frameIndex, stagger, interval))
+			{
+				++updateCount;
+				++updatesPerFrame[frameIndex];
+			}
+		}
+		assert(1U == updateCount);
+	}
+	for (uint32_t updateCount : updatesPerFrame)
+	{
+		assert(8U == updateCount);
+	}
+
+	cd::Matrix4x4 matrices[3] = { cd::Matrix4x4::Identity(), cd::Matrix4x4::Identity(), cd::Matrix4x4::Identity() };
+	reinterpret_cast<float*>(&matrices[1])[12] = 4.0f;
+	AnimationLod::InterpolateMatrices(&matrices[0], &matrices[1], 0.25f, 1U, &matrices[2]);
+	assert(IsNearlyEqual(matrices[2].begin()[12], 1.0f));
+	assert(IsNearlyEqual(matrices[2].begin()[0], 1.0f));
+
+	// Leaf bones are at the end of the order so that the LOD prefix still has parents before children.
+	constexpr uint32_t boneCount = 24U;
+	std::vector<std::vector<uint32_t>> children;
+	AnimationClipData clip = MakeSkeletonClip(boneCount, 1.0f, &children);
+	const std::vector<uint32_t>& boneOrder = clip.GetBoneOrder();
+	const uint32_t lodBoneCount = clip.GetLodBoneCount();
+	assert(lodBoneCount > 0U && lodBoneCount < boneCount);
+	std::vector<uint32_t> orderIndices(boneCount);
+	for (uint32_t orderIndex = 0U; orderIndex < boneCount; ++orderIndex)
+	{
+		const uint32_t boneIndex = boneOrder[orderIndex];
+		orderIndices[boneIndex] = orderIndex;
+		assert(children[boneIndex].empty() == (orderIndex >= lodBoneCount));
+	}
+	for (uint32_t boneIndex = 1U; boneIndex < boneCount; ++boneIndex)
+	{
+		assert(orderIndices[clip.GetParentIndex(boneIndex)] < orderIndices[boneIndex]);
+	}
+
+	// Sampling and the hierarchy walk of the prefix match the full pose. Sampling leaves leaf bones untouched.
+	SoaPose fullPose(boneCount);
+	SoaPose lodPose(boneCount);
+	clip.SamplePose(0.37f, fullPose);
+	clip.SamplePose(0.81f, lodPose);
+	const cd::Transform staleLeaf = lodPose.GetTransform(boneOrder[boneCount - 1U]);
+	clip.SamplePose(0.37f, lodPose, lodBoneCount);
+	std::vector<cd::Matrix4x4> fullMatrices(boneCount);
+	std::vector<cd::Matrix4x4> lodMatrices(boneCount, cd::Matrix4x4::Identity());
+	PoseKernels::LocalToModel(fullPose, clip, fullMatrices.data());
+	PoseKernels::LocalToModel(lodPose, clip, lodMatrices.data(), lodBoneCount);
+	for (uint32_t orderIndex = 0U; orderIndex < lodBoneCount; ++orderIndex)
+	{
+		const uint32_t boneIndex = boneOrder[orderIndex];
+		assert(IsNearlyEqual(lodPose.GetTransform(boneIndex).GetRotation(), fullPose.GetTransform(boneIndex).GetRotation()));
+		assert(IsNearlyEqual(lodMatrices[boneIndex], fullMatrices[boneIndex]));
+	}
+	assert(IsNearlyEqual(lodPose.GetTransform(boneOrder[boneCount - 1U]).GetRotation(), staleLeaf.GetRotation()));
+
+	// SIMD and scalar hierarchy walks of the prefix match and both leave the matrices of skipped bones unchanged.
+	std::vector<cd::Matrix4x4> scalarLodMatrices(boneCount, cd::Matrix4x4::Identity());
+	PoseKernels::LocalToModelScalar(lodPose, clip, scalarLodMatrices.data(), lodBoneCount);
+	for (uint32_t orderIndex = 0U; orderIndex < boneCount; ++orderIndex)
+	{
+		const uint32_t boneIndex = boneOrder[orderIndex];
+		assert(IsNearlyEqual(lodMatrices[boneIndex], scalarLodMatrices[boneIndex]));
+		assert(orderIndex < lodBoneCount || IsNearlyEqual(lodMatrices[boneIndex], cd::Matrix4x4::Identity()));
+	}
+
+	printf("[Success] Test_AnimationLod\n");
+}
+
+// Bones turn and move at a constant speed so that interpolated LOD poses stay close to evaluated ones.
+AnimationClipData MakeLinearClip(uint32_t boneCount, float duration)
+{
+	AnimationClipData clip;
+	clip.Init(boneCount, duration);
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		if (boneIndex > 0U)
+		{
+			clip.SetParentIndex(boneIndex, boneIndex - 1U);
+		}
+
+		const TranslationKey translationKeys[] = { { 0.0f, cd::Vec3f(0.0f, 1.0f, 0.0f) }, { duration, cd::Vec3f(0.1f * duration, 1.0f, 0.0f) } };
+		const RotationKey rotationKeys[] = { { 0.0f, cd::Quaternion::RotateY(0.0f) }, { duration, cd::Quaternion::RotateY(0.05f * duration) } };
+		clip.ResampleTranslationKeys(boneIndex, translationKeys, 2U);
+		clip.ResampleRotationKeys(boneIndex, rotationKeys, 2U);
+	}
+
+	return clip;
+}
+
+void InitAnimationComponent(AnimationComponent& animationComponent, float playBackSpeed)
+{
+	animationComponent.SetAnimationClip(AnimationClip::Idle);
+	animationComponent.SetPlayBackSpeed(playBackSpeed);
+	animationComponent.SetBlendFactor(0.0f);
+	animationComponent.IsPlaying() = true;
+}
+
+// EvaluateAll with throttled updates against a full evaluation at the same running time.
+void Test_AnimationLodPlayBackSpeed()
+{
+	constexpr uint32_t boneCount = 6U;
+	constexpr float duration = 60.0f;
+	constexpr float deltaTime = 1.0f / 60.0f;
+	constexpr uint32_t frameCount = 48U;
+
+	std::vector<AnimationClipData> clips;
+	clips.push_back(MakeLinearClip(boneCount, duration));
+	SkeletonResource skeletonResource;
+	skeletonResource.SetAnimationClips(std::move(clips), std::vector<cd::Matrix4x4>(boneCount, cd::Matrix4x4::Identity()));
+	skeletonResource.SetStatus(ResourceStatus::Ready);
+
+	// Camera at the origin looking down +z. Every visible character is at the Half level.
+	AnimationLodView lodView;
+	lodView.viewMatrix = cd::Matrix4x4::Identity();
+	lodView.projectionMatrix = MakePerspective(1.0471976f, 0.1f, 100.0f);
+	lodView.deltaTime = deltaTime;
+	AnimationLodSettings lodSettings;
+	lodSettings.screenSizes[0] = FLT_MAX;
+	lodSettings.screenSizes[1] = 1e-6f;
+	lodSettings.screenSizes[2] = 1e-7f;
+	lodSettings.leafBoneLevel = AnimationLodLevel::Count;
+
+	for (uint32_t updateInterval : { 2U, 4U })
+	{
+		lodSettings.updateIntervals[1] = updateInterval;
+		for (float playBackSpeed : { 0.5f, 1.0f, 2.5f })
+		{
+			SceneWorld sceneWorld;
+			World* pWorld = sceneWorld.GetWorld();
+			Entity entity = pWorld->CreateEntity();
+			cd::Transform transform = cd::Transform::Identity();
+			transform.SetTranslation(cd::Vec3f(0.0f, 0.0f, 10.0f));
+			TransformComponent& transformComponent = pWorld->CreateComponent<TransformComponent>(entity);
+			transformComponent.SetTransform(transform);
+			transformComponent.Build();
+			pWorld->CreateComponent<CollisionMeshComponent>(entity).SetAABB(cd::AABB(cd::Point(-1.0f), cd::Point(1.0f)));
+			InitAnimationComponent(pWorld->CreateComponent<AnimationComponent>(entity), playBackSpeed);
+			pWorld->CreateComponent<SkeletonComponent>(entity).SetSkeletonAsset(&skeletonResource);
+			const AnimationComponent* pAnimationComponent = sceneWorld.GetAnimationComponent(entity);
+			const SkeletonComponent* pSkeletonComponent = sceneWorld.GetSkeletonComponent(entity);
+
+			AnimationComponent referenceAnimationComponent;
+			InitAnimationComponent(referenceAnimationComponent, playBackSpeed);
+			SkeletonComponent referenceSkeletonComponent;
+			referenceSkeletonComponent.SetSkeletonAsset(&skeletonResource);
+
+			uint32_t interpolatedFrameCount = 0U;
+			for (uint32_t frameIndex = 0U; frameIndex < frameCount; ++frameIndex)
+			{
+				sceneWorld.FixedUpdate(deltaTime);
+				sceneWorld.SetInterpolationAlpha(1.0f);
+				lodView.frameIndex = frameIndex;
+				const AnimationLodStats stats = PoseEvaluator::EvaluateAll(&sceneWorld, &lodView, lodSettings);
+				assert(AnimationLodLevel::Half == pSkeletonComponent->GetAnimationLodState().level);
+				assert(1U == stats.evaluatedEntityCount + stats.interpolatedEntityCount);
+				interpolatedFrameCount += stats.interpolatedEntityCount;
+
+				assert(boneCount == PoseEvaluator::Evaluate(&referenceAnimationComponent, &referenceSkeletonComponent, pAnimationComponent->GetRunningTime()));
+				for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+				{
+					assert(IsNearlyEqual(pSkeletonComponent->GetSkinningMatrices()[boneIndex], referenceSkeletonComponent.GetSkinningMatrices()[boneIndex], 1e-2f));
+				}
+			}
+
+			// One evaluation per interval plus the first frame. A look ahead which ignores the playback speed
+			// falls behind the running time and evaluates every frame.
+			assert(interpolatedFrameCount + frameCount / updateInterval + 1U >= frameCount);
+		}
+	}
+
+	printf("[Success] Test_AnimationLodPlayBackSpeed\n");
+}
+
+// Face like mesh. Every morph moves a region of vertices like an expression does and a few targets keep the base position.
+struct TestFace
+{
+	std::vector<cd::Vec3f> basePositions;
+	std::vector<std::vector<uint32_t>> morphVertexIDs;
+	std::vector<std::vector<cd::Vec3f>> morphPositions;
+	std::vector<BlendShapeMorphTarget> morphTargets;
+};
+
+TestFace MakeFace(uint32_t vertexCount, uint32_t morphCount, uint32_t regionVertexCount, uint32_t seed)
+{
+	TestFace face;
+	face.basePositions.resize(vertexCount);
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const float angle = static_cast<float>(vertexIndex) * 0.37f + static_cast<float>(seed);
+		face.basePositions[vertexIndex] = cd::Vec3f(std::sin(angle), std::cos(angle * 0.3f), static_cast<float>(vertexIndex) * 0.001f);
+	}
+
+	face.morphVertexIDs.resize(morphCount);
+	face.morphPositions.resize(morphCount);
+	for (uint32_t morphIndex = 0U; morphIndex < morphCount; ++morphIndex)
+	{
+		const uint32_t firstVertex = (morphIndex * 97U + seed * 31U) % vertexCount;
+		for (uint32_t regionIndex = 0U; regionIndex < regionVertexCount; ++regionIndex)
+		{
+			const uint32_t vertexID = (firstVertex + regionIndex) % vertexCount;
+			const float offset = 0 == regionIndex % 10U ? 0.0f : 0.01f * static_cast<float>(morphIndex + 1U);
+			const cd::Vec3f& basePosition = face.basePositions[vertexID];
+			face.morphVertexIDs[morphIndex].push_back(vertexID);
+			face.morphPositions[morphIndex].push_back(cd::Vec3f(basePosition[0] + offset, basePosition[1] - offset, basePosition[2] + offset * 0.5f));
+		}
+	}
+
+	for (uint32_t morphIndex = 0U; morphIndex < morphCount; ++morphIndex)
+	{
+		face.morphTargets.push_back({ face.morphVertexIDs[morphIndex].data(), face.morphPositions[morphIndex].data(), regionVertexCount });
+	}
+
+	return face;
+}
+
+// Scatters every morph target of a face like the per entity compute shaders did.
+void EvaluateFaceDense(const TestFace& face, const float* pWeights, float* pOutputPositions)
+{
+	for (uint32_t vertexIndex = 0U; vertexIndex < face.basePositions.size(); ++vertexIndex)
+	{
+		for (uint32_t axis = 0U; axis < 3U; ++axis)
+		{
+			pOutputPositions[vertexIndex * 4U + axis] = face.basePositions[vertexIndex][axis];
+		}
+	}
+
+	for (uint32_t morphIndex = 0U; morphIndex < face.morphTargets.size(); ++morphIndex)
+	{
+		const BlendShapeMorphTarget& morphTarget = face.morphTargets[morphIndex];
+		for (uint32_t targetIndex = 0U; targetIndex < morphTarget.vertexCount; ++targetIndex)
+		{
+			const uint32_t vertexID = morphTarget.pVertexIDs[targetIndex];
+			for (uint32_t axis = 0U; axis < 3U; ++axis)
+			{
+				pOutputPositions[vertexID * 4U + axis] += pWeights[morphIndex] * (morphTarget.pPositions[targetIndex][axis] - face.basePositions[vertexID][axis]);
+			}
+		}
+	}
+}
+
+bool IsFaceEqual(const BlendShapeBatch& batch, uint32_t meshIndex, const TestFace& face, const float* pWeights, const std::vector<float>& outputPositions)
+{
+	std::vector<float> expected(face.basePositions.size() * 4U);
+	EvaluateFaceDense(face, pWeights, expected.data());
+	const float* pOutput = outputPositions.data() + batch.GetFirstVertex(meshIndex) * 4U;
+	for (uint32_t vertexIndex = 0U; vertexIndex < face.basePositions.size(); ++vertexIndex)
+	{
+		for (uint32_t axis = 0U; axis < 3U; ++axis)
+		{
+			if (!IsNearlyEqual(pOutput[vertexIndex * 4U + axis], expected[vertexIndex * 4U + axis]))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void Test_BlendShapeBatch()
+{
+	constexpr uint32_t faceCount = 3U;
+	constexpr uint32_t vertexCount = 300U;
+	constexpr uint32_t morphCount = 8U;
+	constexpr uint32_t regionVertexCount = 40U;
+	BlendShapeBatch batch;
+	std::vector<TestFace> faces;
+	for (uint32_t faceIndex = 0U; faceIndex < faceCount; ++faceIndex)
+	{
+		faces.push_back(MakeFace(vertexCount, morphCount, regionVertexCount, faceIndex));
+		const TestFace& face = faces.back();
+		assert(faceIndex == batch.AddMesh(face.basePositions.data(), vertexCount, face.morphTargets.data(), morphCount));
+		assert(faceIndex * vertexCount == batch.GetFirstVertex(faceIndex));
+	}
+	assert(faceCount * vertexCount == batch.GetTotalVertexCount());
+
+	// Only moved vertices and targets which differ from the base position are stored.
+	assert(batch.GetAffectedVertexCount(0U) > 0U && batch.GetAffectedVertexCount(0U) < vertexCount);
+	assert(batch.GetMorphDeltas().size() == faceCount * morphCount * (regionVertexCount - regionVertexCount / 10U));
+
+	// New meshes are evaluated once, with zero weights they keep the base positions.
+	std::vector<float> outputPositions = batch.GetBasePositions();
+	assert(batch.BuildWorkGroups() > 0U && faceCount == batch.GetChangedMeshes().size());
+	batch.Evaluate(outputPositions.data());
+	assert(outputPositions == batch.GetBasePositions());
+	assert(0U == batch.BuildWorkGroups());
+
+	// Only the mesh whose weights changed is in the work list.
+	std::vector<float> weights[faceCount];
+	for (uint32_t faceIndex = 0U; faceIndex < faceCount; ++faceIndex)
+	{
+		weights[faceIndex].resize(morphCount, 0.0f);
+	}
+	for (uint32_t morphIndex = 0U; morphIndex < morphCount; ++morphIndex)
+	{
+		weights[1][morphIndex] = 0.1f * static_cast<float>(morphIndex);
+	}
+	assert(batch.SetWeights(1U, weights[1].data()));
+	assert(!batch.SetWeights(1U, weights[1].data()));
+	assert(!batch.SetWeights(0U, weights[0].data()));
+	assert(batch.BuildWorkGroups() > 0U);
+	assert(1U == batch.GetChangedMeshes().size() && 1U == batch.GetChangedMeshes()[0]);
+	for (const BlendShapeBatch::WorkGroup& workGroup : batch.GetWorkGroups())
+	{
+		for (uint32_t affectedIndex = workGroup.firstAffectedVertex; affectedIndex < workGroup.firstAffectedVertex + workGroup.affectedVertexCount; ++affectedIndex)
+		{
+			const uint32_t outputVertex = batch.GetAffectedVertices()[affectedIndex].outputVertex;
+			assert(outputVertex >= vertexCount && outputVertex < 2U * vertexCount);
+		}
+	}
+	batch.Evaluate(outputPositions.data());
+	for (uint32_t faceIndex = 0U; faceIndex < faceCount; ++faceIndex)
+	{
+		assert(IsFaceEqual(batch, faceIndex, faces[faceIndex], weights[faceIndex].data(), outputPositions));
+	}
+
+	// Unchanged meshes are not written again and changed ones are rebuilt from their base positions.
+	std::fill(outputPositions.begin() + vertexCount * 4U, outputPositions.begin() + 2U * vertexCount * 4U, -7.0f);
+	weights[0][3] = 0.5f;
+	weights[2][5] = 1.0f;
+	assert(batch.SetWeight(0U, 3U, weights[0][3]));
+	assert(batch.SetWeight(2U, 5U, weights[2][5]));
+	batch.BuildWorkGroups();
+	batch.Evaluate(outputPositions.data());
+	assert(IsFaceEqual(batch, 0U, faces[0], weights[0].data(), outputPositions));
+	assert(IsFaceEqual(batch, 2U, faces[2], weights[2].data(), outputPositions));
+	assert(-7.0f == outputPositions[vertexCount * 4U] && -7.0f == outputPositions[2U * vertexCount * 4U - 1U]);
+	weights[0][3] = 0.0f;
+	batch.SetWeight(0U, 3U, 0.0f);
+	batch.BuildWorkGroups();
+	batch.Evaluate(outputPositions.data());
+	assert(IsFaceEqual(batch, 0U, faces[0], weights[0].data(), outputPositions));
+
+	// w is the weight which is left for the base position like the previous shaders wrote.
+	const uint32_t vertexID = faces[2].morphVertexIDs[5][1];
+	float overlapWeight = 0.0f;
+	for (uint32_t morphIndex = 0U; morphIndex < morphCount; ++morphIndex)
+	{
+		for (uint32_t targetIndex = 1U; targetIndex < regionVertexCount; ++targetIndex)
+		{
+			if (0U != targetIndex % 10U && vertexID == faces[2].morphVertexIDs[morphIndex][targetIndex])
+			{
+				overlapWeight += weights[2][morphIndex];
+			}
+		}
+	}
+	assert(IsNearlyEqual(outputPositions[(2U * vertexCount + vertexID) * 4U + 3U], 1.0f - overlapWeight));
+
+	batch.MarkAllChanged();
+	batch.BuildWorkGroups();
+	assert(faceCount == batch.GetChangedMeshes().size());
+
+	printf("[Success] Test_BlendShapeBatch\n");
+}
+
+void Test_BlendShapeBatchBenchmark()
+{
+	constexpr uint32_t faceCount = 500U;
+	constexpr uint32_t morphCount = 50U;
+	constexpr uint32_t vertexCount = 2000U;
+	constexpr uint32_t regionVertexCount = 120U;
+	constexpr uint32_t frameCount = 60U;
+	// Characters in the background keep their expression, a few talk.
+	constexpr uint32_t changedFaceCount = faceCount / 10U;
+
+	std::vector<TestFace> faces;
+	faces.reserve(faceCount);
+	BlendShapeBatch batch;
+	for (uint32_t faceIndex = 0U; faceIndex < faceCount; ++faceIndex)
+	{
+		faces.push_back(MakeFace(vertexCount, morphCount, regionVertexCount, faceIndex));
+		batch.AddMesh(faces.back().basePositions.data(), vertexCount, faces.back().morphTargets.data(), morphCount);
+	}
+
+	std::vector<float> weights(faceCount * morphCount, 0.0f);
+	std::vector<float> denseOutput(faceCount * vertexCount * 4U);
+	std::vector<float> batchOutput = batch.GetBasePositions();
+	batch.BuildWorkGroups();
+	batch.Evaluate(batchOutput.data());
+
+	// Every face every frame without sparse storage or change tracking.
+	auto startTime = std::chrono::steady_clock::now();
+	for (uint32_t frameIndex = 0U; frameIndex < frameCount; ++frameIndex)
+	{
+		for (uint32_t faceIndex = 0U; faceIndex < faceCount; ++faceIndex)
+		{
+			EvaluateFaceDense(faces[faceIndex], weights.data() + faceIndex * morphCount, denseOutput.data() + faceIndex * vertexCount * 4U);
+		}
+	}
+	const double denseMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() / frameCount;
+
+	uint32_t workGroupCount = 0U;
+	startTime = std::chrono::steady_clock::now();
+	for (uint32_t frameIndex = 0U; frameIndex < frameCount; ++frameIndex)
+	{
+		for (uint32_t changeIndex = 0U; changeIndex < changedFaceCount; ++changeIndex)
+		{
+			const uint32_t faceIndex = (frameIndex * 37U + changeIndex * 10U) % faceCount;
+			for (uint32_t morphIndex = 0U; morphIndex < 3U; ++morphIndex)
+			{
+				const uint32_t changedMorph = (frameIndex + morphIndex * 17U) % morphCount;
+				float& weight = weights[faceIndex * morphCount + changedMorph];
+				weight = 0.5f + 0.5f * std::sin(static_cast<float>(frameIndex + morphIndex));
+				batch.SetWeight(faceIndex, changedMorph, weight);
+			}
+		}
+		workGroupCount += batch.BuildWorkGroups();
+		batch.Evaluate(batchOutput.data());
+	}
+	const double batchMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() / frameCount;
+
+	for (uint32_t faceIndex = 0U; faceIndex < faceCount; faceIndex += 7U)
+	{
+		assert(IsFaceEqual(batch, faceIndex, faces[faceIndex], weights.data() + faceIndex * morphCount, batchOutput));
+	}
+
+	const uint32_t maxWorkGroupCount = batch.GetMaxWorkGroupCount();
+	printf("[Benchmark] %u faces x %u morphs : %u changed faces per frame in 1 dispatch, %u of %u work groups, all faces %.3f ms, changed faces %.3f ms (%.1fx)\n",
+		faceCount, morphCount, changedFaceCount, workGroupCount / frameCount, maxWorkGroupCount, denseMs, batchMs, denseMs / batchMs);
+	printf("[Benchmark] Morph data : %zu KB, %zu deltas of %zu vertices\n", batch.GetMemorySize() / 1024U, batch.GetMorphDeltas().size(), batch.GetAffectedVertices().size());
+	printf("[Success] Test_BlendShapeBatchBenchmark\n");
+}
+
+void Test_ParallelPoseBenchmark()
+{
+	constexpr uint32_t characterCount = 1000U;
+	constexpr uint32_t boneCount = 100U;
+	constexpr float idleDuration = 2.0f;
+	constexpr float walkingDuration = 1.3f;
+
+	std::vector<AnimationClipData> clips;
+	clips.push_back(MakeSkeletonClip(boneCount, idleDuration));
+	clips.push_back(MakeSkeletonClip(boneCount, walkingDuration));
+	SkeletonResource skeletonResource;
+	skeletonResource.SetAnimationClips(std::move(clips), std::vector<cd::Matrix4x4>(boneCount, cd::Matrix4x4::Identity()));
+	skeletonResource.SetStatus(ResourceStatus::Ready);
+
+	// Characters cycle through both clips and the blend of them at different times.
+	SceneWorld sceneWorld;
+	World* pWorld = sceneWorld.GetWorld();
+	std::vector<Entity> entities;
+	for (uint32_t characterIndex = 0U; characterIndex < characterCount; ++characterIndex)
+	{
+		Entity entity = pWorld->CreateEntity();
+		const AnimationClip animationClips[] = { AnimationClip::Idle, AnimationClip::Walking, AnimationClip::Blend };
+		AnimationComponent& animationComponent = pWorld->CreateComponent<AnimationComponent>(entity);
+		InitAnimationComponent(animationComponent, 1.0f);
+		animationComponent.SetAnimationClip(animationClips[characterIndex % 3U]);
+		animationComponent.SetBlendFactor(0.3f);
+		animationComponent.AdvanceRunningTime(idleDuration * static_cast<float>(characterIndex) / characterCount);
+		pWorld->CreateComponent<SkeletonComponent>(entity).SetSkeletonAsset(&skeletonResource);
+		entities.push_back(entity);
+	}
+	sceneWorld.SetInterpolationAlpha(1.0f);
+
+	using Clock = std::chrono::steady_clock;
+	auto toMs = [](Clock::duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+
+	std::vector<cd::Matrix4x4> serialMatrices(characterCount * boneCount);
+	auto serialBegin = Clock::now();
+	for (Entity entity : entities)
+	{
+		AnimationComponent* pAnimationComponent = sceneWorld.GetAnimationComponent(entity);
+		assert(boneCount == PoseEvaluator::Evaluate(pAnimationComponent, sceneWorld.GetSkeletonComponent(entity), pAnimationComponent->GetRunningTime()));
+	}
+	const double serialMs = toMs(Clock::now() - serialBegin);
+	for (uint32_t characterIndex = 0U; characterIndex < characterCount; ++characterIndex)
+	{
+		const std::vector<cd::Matrix4x4>& skinningMatrices = sceneWorld.GetSkeletonComponent(entities[characterIndex])->GetSkinningMatrices();
+		std::copy(skinningMatrices.begin(), skinningMatrices.end(), serialMatrices.begin() + characterIndex * boneCount);
+		sceneWorld.GetSkeletonComponent(entities[characterIndex])->GetSkinningMatrices().assign(boneCount, cd::Matrix4x4::Identity());
+	}
+
+	JobSystem& jobSystem = JobSystem::Get();
+	jobSystem.Init();
+	auto parallelBegin = Clock::now();
+	const AnimationLodStats stats = PoseEvaluator::EvaluateAll(&sceneWorld);
+	const double parallelMs = toMs(Clock::now() - parallelBegin);
+	const uint32_t threadCount = jobSystem.GetThreadCount();
+	jobSystem.Shutdown();
+	assert(characterCount == stats.evaluatedEntityCount);
+
+	// Characters don't share buffers so results are the same as the serial evaluation.
+	for (uint32_t characterIndex = 0U; characterIndex < characterCount; ++characterIndex)
+	{
+		const std::vector<cd::Matrix4x4>& skinningMatrices = sceneWorld.GetSkeletonComponent(entities[characterIndex])->GetSkinningMatrices();
+		for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+		{
+			assert(IsNearlyEqual(serialMatrices[characterIndex * boneCount + boneIndex], skinningMatrices[boneIndex], 0.0f));
+		}
+	}
+
+	// Different clips and times give different poses.
+	const cd::Matrix4x4* pIdleMatrices = serialMatrices.data() + 300U * boneCount;
+	const cd::Matrix4x4* pWalkingMatrices = serialMatrices.data() + 301U * boneCount;
+	assert(!IsNearlyEqual(pIdleMatrices[boneCount - 1U], pWalkingMatrices[boneCount - 1U], 1e-4f));
+
+	printf("[Benchmark] %u characters x %u bones : serial %.3f ms, %u threads %.3f ms (%.1fx)\n",
+		characterCount, boneCount, serialMs, threadCount, parallelMs, serialMs / parallelMs);
+	printf("[Success] Test_ParallelPoseBenchmark\n");
+}
+
+}
+
+int main()
+{
+	Test_Resample();
+	Test_SingleKey();
+	Test_ResampleTicks();
+	Test_SamplingBenchmark();
+	Test_FlatHierarchyWalk();
+	Test_PoseKernels();
+	Test_PoseKernelsBenchmark();
+	Test_SkinningPalette();
+	Test_VertexSkinning();
+	Test_ClipCompression();
+	Test_ClipCompressionBenchmark();
+	Test_AnimationLod();
+	Test_AnimationLodPlayBackSpeed();
+	Test_BlendShapeBatch();
+	Test_BlendShapeBatchBenchmark();
+	Test_ParallelPoseBenchmark();
+
+	return 0;
+}
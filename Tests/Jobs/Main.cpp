@@ -0,0 +1,290 @@
+#include "Core/Jobs/JobSystem.h"
+#include "Utilities/PerformanceProfiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using namespace engine;
+
+void Test_RunJobs(JobSystem& jobSystem)
+{
+	cdtools::PerformanceProfiler perf("Test_RunJobs");
+
+	constexpr uint32_t jobCount = 100000U;
+	std::atomic<uint32_t> executedCount = 0U;
+
+	// More jobs than one ring pool. Wait in batches so that job slots can be reused.
+	constexpr uint32_t batchJobCount = JobSystem::MaxJobCountPerThread / 2U;
+	for (uint32_t batchStart = 0U; batchStart < jobCount; batchStart += batchJobCount)
+	{
+		JobCounter counter;
+		for (uint32_t jobIndex = 0U; jobIndex < batchJobCount; ++jobIndex)
+		{
+			jobSystem.Run([&executedCount]() { executedCount.fetch_add(1U, std::memory_order_relaxed); }, &counter);
+		}
+		jobSystem.Wait(counter);
+		assert(counter.IsDone());
+	}
+
+	assert(executedCount.load() == (jobCount + batchJobCount - 1U) / batchJobCount * batchJobCount);
+
+	printf("[Success] Test_RunJobs\n");
+}
+
+void Test_Dependencies(JobSystem& jobSystem)
+{
+	cdtools::PerformanceProfiler perf("Test_Dependencies");
+
+	// Stage B reads what stage A writes. Waiting on A's counter expresses the dependency.
+	constexpr uint32_t valueCount = 1024U;
+	std::vector<uint32_t> values(valueCount, 0U);
+	std::vector<uint32_t> results(valueCount, 0U);
+
+	JobCounter stageA;
+	for (uint32_t valueIndex = 0U; valueIndex < valueCount; ++valueIndex)
+	{
+		jobSystem.Run([&values, valueIndex]() { values[valueIndex] = valueIndex + 1U; }, &stageA);
+	}
+	jobSystem.Wait(stageA);
+
+	JobCounter stageB;
+	for (uint32_t valueIndex = 0U; valueIndex < valueCount; ++valueIndex)
+	{
+		jobSystem.Run([&values, &results, valueIndex]() { results[valueIndex] = values[valueIndex] * 2U; }, &stageB);
+	}
+	jobSystem.Wait(stageB);
+
+	for (uint32_t valueIndex = 0U; valueIndex < valueCount; ++valueIndex)
+	{
+		assert(results[valueIndex] == (valueIndex + 1U) * 2U);
+	}
+
+	printf("[Success] Test_Dependencies\n");
+}
+
+void Test_NestedJobs(JobSystem& jobSystem)
+{
+	cdtools::PerformanceProfiler perf("Test_NestedJobs");
+
+	// Jobs spawn and wait for child jobs on worker threads. Waiting threads help instead of blocking.
+	constexpr uint32_t parentCount = 64U;
+	constexpr uint32_t childCount = 32U;
+	std::atomic<uint32_t> childExecutedCount = 0U;
+
+	JobCounter parentCounter;
+	for (uint32_t parentIndex = 0U; parentIndex < parentCount; ++parentIndex)
+	{
+		jobSystem.Run([&jobSystem, &childExecutedCount]()
+		{
+			JobCounter childCounter;
+			for (uint32_t childIndex = 0U; childIndex < childCount; ++childIndex)
+			{
+				jobSystem.Run([&childExecutedCount]() { childExecutedCount.fetch_add(1U, std::memory_order_relaxed); }, &childCounter);
+			}
+			jobSystem.Wait(childCounter);
+		}, &parentCounter);
+	}
+	jobSystem.Wait(parentCounter);
+
+	assert(childExecutedCount.load() == parentCount * childCount);
+
+	printf("[Success] Test_NestedJobs\n");
+}
+
+void Test_ParallelFor(JobSystem& jobSystem)
+{
+	cdtools::PerformanceProfiler perf("Test_ParallelFor");
+
+	constexpr uint32_t valueCount = 1000003U;
+	std::vector<uint32_t> values(valueCount, 0U);
+	jobSystem.ParallelFor(valueCount, 0U, [&values](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t valueIndex = begin; valueIndex < end; ++valueIndex)
+		{
+			values[valueIndex] += valueIndex;
+		}
+	});
+
+	for (uint32_t valueIndex = 0U; valueIndex < valueCount; ++valueIndex)
+	{
+		assert(values[valueIndex] == valueIndex);
+	}
+
+	// Odd batch size leaves a partial batch at the end.
+	std::atomic<uint64_t> sum = 0U;
+	jobSystem.ParallelFor(valueCount, 777U, [&values, &sum](uint32_t begin, uint32_t end)
+	{
+		uint64_t localSum = 0U;
+		for (uint32_t valueIndex = begin; valueIndex < end; ++valueIndex)
+		{
+			localSum += values[valueIndex];
+		}
+		sum.fetch_add(localSum, std::memory_order_relaxed);
+	});
+	assert(sum.load() == static_cast<uint64_t>(valueCount) * (valueCount - 1U) / 2U);
+
+	printf("[Success] Test_ParallelFor\n");
+}
+
+void Test_ManyBatches(JobSystem& jobSystem)
+{
+	cdtools::PerformanceProfiler perf("Test_ManyBatches");
+
+	// More batches than job slots of one thread.
+	constexpr uint32_t valueCount = JobSystem::MaxJobCountPerThread * 3U;
+	std::vector<std::atomic<uint32_t>> values(valueCount);
+	for (uint32_t repeatIndex = 0U; repeatIndex < 4U; ++repeatIndex)
+	{
+		jobSystem.ParallelFor(valueCount, 1U, [&values](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t valueIndex = begin; valueIndex < end; ++valueIndex)
+			{
+				values[valueIndex].fetch_add(1U, std::memory_order_relaxed);
+			}
+		});
+	}
+
+	// Jobs which are still queued or running while the job pool wraps around.
+	JobCounter counter;
+	for (uint32_t valueIndex = 0U; valueIndex < valueCount; ++valueIndex)
+	{
+		jobSystem.Run([&values, valueIndex]()
+		{
+			values[valueIndex].fetch_add(1U, std::memory_order_relaxed);
+		}, &counter);
+	}
+	jobSystem.Wait(counter);
+
+	// Same from inside of a job on a worker thread.
+	JobCounter outerCounter;
+	jobSystem.Run([&jobSystem, &values]()
+	{
+		JobCounter innerCounter;
+		for (uint32_t valueIndex = 0U; valueIndex < valueCount; ++valueIndex)
+		{
+			jobSystem.Run([&values, valueIndex]()
+			{
+				values[valueIndex].fetch_add(1U, std::memory_order_relaxed);
+			}, &innerCounter);
+		}
+		jobSystem.Wait(innerCounter);
+	}, &outerCounter);
+	jobSystem.Wait(outerCounter);
+
+	for (uint32_t valueIndex = 0U; valueIndex < valueCount; ++valueIndex)
+	{
+		assert(6U == values[valueIndex].load());
+	}
+
+	printf("[Success] Test_ManyBatches\n");
+}
+
+void Test_MainThreadAffinity(JobSystem& jobSystem)
+{
+	cdtools::PerformanceProfiler perf("Test_MainThreadAffinity");
+
+	const std::thread::id mainThreadID = std::this_thread::get_id();
+	std::atomic<uint32_t> mainThreadExecutedCount = 0U;
+
+	// Workers post jobs back to the main thread. The main thread executes them while waiting.
+	JobCounter counter;
+	for (uint32_t jobIndex = 0U; jobIndex < 256U; ++jobIndex)
+	{
+		jobSystem.Run([&jobSystem, &counter, &mainThreadExecutedCount, mainThreadID]()
+		{
+			jobSystem.RunOnMainThread([&mainThreadExecutedCount, mainThreadID]()
+			{
+				assert(std::this_thread::get_id() == mainThreadID);
+				assert(JobSystem::IsMainThread());
+				mainThreadExecutedCount.fetch_add(1U, std::memory_order_relaxed);
+			}, &counter);
+		}, &counter);
+	}
+	jobSystem.Wait(counter);
+
+	assert(mainThreadExecutedCount.load() == 256U);
+
+	printf("[Success] Test_MainThreadAffinity\n");
+}
+
+float Benchmark_Workload(JobSystem& jobSystem, std::vector<float>& values)
+{
+	auto startTime = std::chrono::steady_clock::now();
+	jobSystem.ParallelFor(static_cast<uint32_t>(values.size()), 1024U, [&values](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t valueIndex = begin; valueIndex < end; ++valueIndex)
+		{
+			float value = values[valueIndex];
+			for (uint32_t iteration = 0U; iteration < 64U; ++iteration)
+			{
+				value = std::sqrt(value * value + 1.0f);
+			}
+			values[valueIndex] = value;
+		}
+	});
+	auto endTime = std::chrono::steady_clock::now();
+	return std::chrono::duration<float, std::milli>(endTime - startTime).count();
+}
+
+void Test_Scaling()
+{
+	cdtools::PerformanceProfiler perf("Test_Scaling");
+
+	// Thread counts above hardware concurrency are still measured to show oversubscription cost.
+	std::vector<float> values(1U << 20U, 1.0f);
+	float baselineTime = 0.0f;
+	for (uint32_t threadCount = 1U; threadCount <= JobSystem::MaxThreadCount; threadCount *= 2U)
+	{
+		JobSystem& jobSystem = JobSystem::Get();
+		jobSystem.Init(threadCount);
+
+		// Warm up threads and caches.
+		Benchmark_Workload(jobSystem, values);
+		float bestTime = Benchmark_Workload(jobSystem, values);
+		for (uint32_t runIndex = 0U; runIndex < 4U; ++runIndex)
+		{
+			bestTime = std::min(bestTime, Benchmark_Workload(jobSystem, values));
+		}
+
+		if (1U == threadCount)
+		{
+			baselineTime = bestTime;
+		}
+		printf("[Benchmark] %2u threads : %8.3f ms, speedup %5.2fx\n", threadCount, bestTime, baselineTime / bestTime);
+
+		jobSystem.Shutdown();
+	}
+
+	printf("[Success] Test_Scaling\n");
+}
+
+}
+
+int main()
+{
+	JobSystem& jobSystem = JobSystem::Get();
+	jobSystem.Init();
+
+	Test_RunJobs(jobSystem);
+	Test_Dependencies(jobSystem);
+	Test_NestedJobs(jobSystem);
+	Test_ParallelFor(jobSystem);
+	Test_ManyBatches(jobSystem);
+	Test_MainThreadAffinity(jobSystem);
+
+	jobSystem.Shutdown();
+
+	Test_Scaling();
+
+	return 0;
+}
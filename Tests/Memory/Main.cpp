@@ -0,0 +1,475 @@
+#include "Core/Jobs/JobSystem.h"
+#include "Core/Memory/FrameArena.h"
+#include "Core/Memory/MemoryTracker.h"
+#include "ParticleSystem/ParticlePool.h"
+#include "Utilities/PerformanceProfiler.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#ifdef CD_PLATFORM_WINDOWS
+#include <malloc.h>
+#endif
+#include <new>
+#include <thread>
+#include <vector>
+
+// Allocation counting hook. Every global new in this process goes through here so tests can prove
+// that a code path doesn't touch the heap.
+namespace
+{
+
+std::atomic<uint64_t> g_heapAllocationCount = 0U;
+
+uint64_t GetHeapAllocationCount()
+{
+	return g_heapAllocationCount.load(std::memory_order_relaxed);
+}
+
+void* CountedAlloc(size_t size, size_t alignment)
+{
+	g_heapAllocationCount.fetch_add(1U, std::memory_order_relaxed);
+	size = (size + alignment - 1U) / alignment * alignment;
+#ifdef CD_PLATFORM_WINDOWS
+	void* pMemory = _aligned_malloc(size > 0U ? size : alignment, alignment);
+#else
+	void* pMemory = std::aligned_alloc(alignment, size > 0U ? size : alignment);
+#endif
+	if (!pMemory)
+	{
+		throw std::bad_alloc();
+	}
+	return pMemory;
+}
+
+void CountedFree(void* pMemory)
+{
+#ifdef CD_PLATFORM_WINDOWS
+	_aligned_free(pMemory);
+#else
+	std::free(pMemory);
+#endif
+}
+
+}
+
+void* operator new(size_t size) { return CountedAlloc(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size) { return CountedAlloc(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t alignment) { return CountedAlloc(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return CountedAlloc(size, static_cast<size_t>(alignment)); }
+void operator delete(void* pMemory) noexcept { CountedFree(pMemory); }
+void operator delete[](void* pMemory) noexcept { CountedFree(pMemory); }
+void operator delete(void* pMemory, size_t) noexcept { CountedFree(pMemory); }
+void operator delete[](void* pMemory, size_t) noexcept { CountedFree(pMemory); }
+void operator delete(void* pMemory, std::align_val_t) noexcept { CountedFree(pMemory); }
+void operator delete[](void* pMemory, std::align_val_t) noexcept { CountedFree(pMemory); }
+void operator delete(void* pMemory, size_t, std::align_val_t) noexcept { CountedFree(pMemory); }
+void operator delete[](void* pMemory, size_t, std::align_val_t) noexcept { CountedFree(pMemory); }
+
+namespace
+{
+
+using namespace engine;
+
+struct alignas(16) Matrix
+{
+	float data[16];
+};
+
+void Test_Alignment()
+{
+	LinearArena arena(1024U);
+	for (size_t alignment = 1U; alignment <= 256U; alignment <<= 1U)
+	{
+		// Odd sizes shift the offset so that every alignment needs padding.
+		arena.Allocate(3U, 1U);
+		void* pMemory = arena.Allocate(alignment * 3U, alignment);
+		assert(0U == reinterpret_cast<uintptr_t>(pMemory) % alignment);
+	}
+
+	// Larger than a block.
+	void* pLarge = arena.Allocate(4096U, 64U);
+	assert(0U == reinterpret_cast<uintptr_t>(pLarge) % 64U);
+
+	printf("[Success] Test_Alignment\n");
+}
+
+void Test_ResetMergesBlocks()
+{
+	LinearArena arena(256U);
+
+	auto fill = [&arena]()
+	{
+		for (uint32_t allocationIndex = 0U; allocationIndex < 64U; ++allocationIndex)
+		{
+			arena.Allocate(100U, 8U);
+		}
+	};
+
+	fill();
+	const size_t usedSize = arena.GetUsedSize();
+	assert(arena.GetCapacity() >= usedSize);
+
+	arena.Reset();
+	assert(0U == arena.GetUsedSize());
+	assert(arena.GetCapacity() >= usedSize);
+
+	// Same allocations fit into the merged block.
+	const uint64_t arenaBlockCount = LinearArena::GetHeapAllocationCount();
+	const uint64_t heapAllocationCount = GetHeapAllocationCount();
+	fill();
+	arena.Reset();
+	fill();
+	assert(arenaBlockCount == LinearArena::GetHeapAllocationCount());
+	assert(heapAllocationCount == GetHeapAllocationCount());
+
+	printf("[Success] Test_ResetMergesBlocks\n");
+}
+
+// Builds the same transient data as renderers do: matrices for uniforms and track names per bone.
+size_t SimulateFrame()
+{
+	FrameArena::BeginFrame();
+
+	FrameVector<Matrix> lightViewProjs;
+	lightViewProjs.reserve(12U);
+	for (uint32_t matrixIndex = 0U; matrixIndex < 12U; ++matrixIndex)
+	{
+		lightViewProjs.push_back(Matrix{});
+	}
+
+	size_t nameLength = 0U;
+	for (uint32_t boneIndex = 0U; boneIndex < 128U; ++boneIndex)
+	{
+		// Longer than small string buffers.
+		FrameString trackName("AnimationClip_Character_Run_Forward");
+		trackName += "mixamorig:LeftHandIndex";
+		trackName += std::to_string(boneIndex).c_str();
+		nameLength += trackName.size();
+	}
+
+	// Containers which grow without reserve.
+	FrameVector<uint32_t> indices;
+	for (uint32_t index = 0U; index < 1000U; ++index)
+	{
+		indices.push_back(index);
+	}
+
+	return nameLength + lightViewProjs.size() + indices.size();
+}
+
+void Test_SteadyStateFrames()
+{
+	cdtools::PerformanceProfiler perf("Test_SteadyStateFrames");
+
+	// First frames grow the arena of this thread to its working size.
+	const size_t expected = SimulateFrame();
+	SimulateFrame();
+
+	const uint64_t arenaBlockCount = LinearArena::GetHeapAllocationCount();
+	const uint64_t heapAllocationCount = GetHeapAllocationCount();
+	constexpr uint32_t frameCount = 1000U;
+	for (uint32_t frameIndex = 0U; frameIndex < frameCount; ++frameIndex)
+	{
+		size_t result = SimulateFrame();
+		assert(expected == result);
+	}
+
+	const uint64_t newHeapAllocationCount = GetHeapAllocationCount() - heapAllocationCount;
+	printf("[Info] Heap allocations in %u frames : %llu\n", frameCount, static_cast<unsigned long long>(newHeapAllocationCount));
+	assert(0U == newHeapAllocationCount);
+	assert(arenaBlockCount == LinearArena::GetHeapAllocationCount());
+
+	printf("[Success] Test_SteadyStateFrames\n");
+}
+
+void Test_ThreadArenas(JobSystem& jobSystem)
+{
+	// One frame needs 128 KB, so the first block of every arena holds all of it whatever thread runs which batch.
+	constexpr uint32_t itemCount = 1024U;
+	constexpr uint64_t valueCount = 16U;
+	std::vector<uint64_t> sums(itemCount, 0U);
+	std::vector<uint8_t> participatedThreads(jobSystem.GetThreadCount(), 0U);
+	std::atomic<size_t> maxArenaCapacity = 0U;
+
+	auto simulateFrame = [&]()
+	{
+		FrameArena::BeginFrame();
+		jobSystem.ParallelFor(itemCount, 16U, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t itemIndex = begin; itemIndex < end; ++itemIndex)
+			{
+				FrameVector<uint64_t> values;
+				values.reserve(valueCount);
+				for (uint64_t value = 0U; value < valueCount; ++value)
+				{
+					values.push_back(value + itemIndex);
+				}
+
+				uint64_t sum = 0U;
+				for (uint64_t value : values)
+				{
+					sum += value;
+				}
+				sums[itemIndex] = sum;
+			}
+
+			participatedThreads[JobSystem::GetThreadIndex()] = 1U;
+			size_t capacity = maxArenaCapacity.load(std::memory_order_relaxed);
+			const size_t threadCapacity = FrameArena::GetThreadArena().GetCapacity();
+			while (threadCapacity > capacity && !maxArenaCapacity.compare_exchange_weak(capacity, threadCapacity, std::memory_order_relaxed))
+			{
+			}
+		});
+	};
+
+	// Every thread which took part allocates its first block. Job scheduling itself may allocate so only arena blocks are checked.
+	for (uint32_t frameIndex = 0U; frameIndex < 4U; ++frameIndex)
+	{
+		simulateFrame();
+	}
+
+	const uint64_t arenaBlockCount = LinearArena::GetHeapAllocationCount();
+	const std::vector<uint8_t> warmThreads = participatedThreads;
+	for (uint32_t frameIndex = 0U; frameIndex < 100U; ++frameIndex)
+	{
+		simulateFrame();
+	}
+
+	for (uint32_t itemIndex = 0U; itemIndex < itemCount; ++itemIndex)
+	{
+		assert(sums[itemIndex] == (valueCount - 1U) * valueCount / 2U + valueCount * static_cast<uint64_t>(itemIndex));
+	}
+
+	// Arenas never grow past one block. After warmup only threads which didn't run a batch before may add their first one.
+	uint64_t newThreadCount = 0U;
+	for (size_t threadIndex = 0U; threadIndex < participatedThreads.size(); ++threadIndex)
+	{
+		newThreadCount += participatedThreads[threadIndex] && !warmThreads[threadIndex] ? 1U : 0U;
+	}
+	const uint64_t newArenaBlockCount = LinearArena::GetHeapAllocationCount() - arenaBlockCount;
+	printf("[Info] Arena blocks allocated after warmup : %llu, high water mark : %zu bytes\n",
+		static_cast<unsigned long long>(newArenaBlockCount), maxArenaCapacity.load());
+	assert(newArenaBlockCount <= newThreadCount);
+	assert(LinearArena::DefaultBlockSize == maxArenaCapacity.load());
+
+	printf("[Success] Test_ThreadArenas\n");
+}
+
+// ParticleRenderer builds the ribbon uniform array every frame with ParticlePool::GetSpawnOrderPositions.
+void Test_RibbonPositions()
+{
+	ParticlePool pool;
+	pool.SetParticleMaxCount(400);
+
+	// Particles live for 2 seconds and die in spawn order, swap removal moves the pool out of spawn order.
+	cd::Vec4f ribbonPositions[300];
+	auto simulateFrame = [&pool, &ribbonPositions]()
+	{
+		FrameArena::BeginFrame();
+		pool.Update(1.0f / 60.0f);
+		for (int spawnIndex = 0; spawnIndex < 3; ++spawnIndex)
+		{
+			const int index = pool.AllocateParticleIndex();
+			pool.SetVelocity(index, cd::Vec3f(1.0f, 0.0f, 0.0f));
+			pool.SetLifeTime(index, 2.0f);
+		}
+		return pool.GetSpawnOrderPositions(ribbonPositions, 300, 0.5f);
+	};
+
+	// Until particles start to die the active count grows.
+	for (uint32_t frameIndex = 0U; frameIndex < 150U; ++frameIndex)
+	{
+		simulateFrame();
+	}
+
+	const uint64_t heapAllocationCount = GetHeapAllocationCount();
+	constexpr uint32_t frameCount = 300U;
+	for (uint32_t frameIndex = 0U; frameIndex < frameCount; ++frameIndex)
+	{
+		const int positionCount = simulateFrame();
+		assert(300 == positionCount);
+		for (int i = 1; i < positionCount; ++i)
+		{
+			// Older particles traveled further.
+			assert(ribbonPositions[i - 1].x() >= ribbonPositions[i].x());
+		}
+	}
+
+	const uint64_t newHeapAllocationCount = GetHeapAllocationCount() - heapAllocationCount;
+	printf("[Info] Heap allocations of ribbon positions in %u frames : %llu\n", frameCount, static_cast<unsigned long long>(newHeapAllocationCount));
+	assert(0U == newHeapAllocationCount);
+
+	printf("[Success] Test_RibbonPositions\n");
+}
+
+void Test_TagScopes()
+{
+	assert(MemoryTag::Untagged == MemoryTracker::GetThreadTag());
+	{
+		MemoryTagScope sceneScope(MemoryTag::Scene);
+		assert(MemoryTag::Scene == MemoryTracker::GetThreadTag());
+		{
+			MemoryTagScope resourceScope(MemoryTag::Resources);
+			assert(MemoryTag::Resources == MemoryTracker::GetThreadTag());
+		}
+		assert(MemoryTag::Scene == MemoryTracker::GetThreadTag());
+
+		// Tags are per thread.
+		std::thread([]()
+		{
+			assert(MemoryTag::Untagged == MemoryTracker::GetThreadTag());
+		}).join();
+	}
+	assert(MemoryTag::Untagged == MemoryTracker::GetThreadTag());
+
+	printf("[Success] Test_TagScopes\n");
+}
+
+void Test_Accounting()
+{
+	const MemoryTagStats before = MemoryTracker::GetStats(MemoryTag::Scene);
+	const MemoryTagStats totalBefore = MemoryTracker::GetTotalStats();
+
+	void* pMemory = nullptr;
+	{
+		MemoryTagScope scope(MemoryTag::Scene);
+		pMemory = MemoryTracker::Allocate(1000U);
+	}
+
+	MemoryTagStats stats = MemoryTracker::GetStats(MemoryTag::Scene);
+	assert(before.liveBytes + 1000 == stats.liveBytes);
+	assert(stats.peakBytes >= stats.liveBytes);
+	assert(before.allocationCount + 1U == stats.allocationCount);
+	assert(totalBefore.liveBytes + 1000 == MemoryTracker::GetTotalStats().liveBytes);
+
+	// Freed outside of the scope but still accounted to Scene.
+	MemoryTracker::Free(pMemory);
+	stats = MemoryTracker::GetStats(MemoryTag::Scene);
+	assert(before.liveBytes == stats.liveBytes);
+	assert(before.freeCount + 1U == stats.freeCount);
+	assert(stats.peakBytes >= before.liveBytes + 1000);
+
+	MemoryTracker::ResetPeaks();
+	assert(MemoryTracker::GetStats(MemoryTag::Scene).peakBytes == stats.liveBytes);
+
+	MemoryTracker::Free(nullptr);
+
+	printf("[Success] Test_Accounting\n");
+}
+
+void Test_CrossThreadFree()
+{
+	constexpr uint32_t allocationCount = 1000U;
+	const MemoryTagStats before = MemoryTracker::GetStats(MemoryTag::ECS);
+
+	std::vector<void*> allocations;
+	allocations.reserve(allocationCount);
+	{
+		MemoryTagScope scope(MemoryTag::ECS);
+		for (uint32_t allocationIndex = 0U; allocationIndex < allocationCount; ++allocationIndex)
+		{
+			allocations.push_back(MemoryTracker::Allocate(64U));
+		}
+	}
+
+	std::thread([&allocations]()
+	{
+		MemoryTagScope scope(MemoryTag::Rendering);
+		for (void* pMemory : allocations)
+		{
+			MemoryTracker::Free(pMemory);
+		}
+	}).join();
+
+	const MemoryTagStats stats = MemoryTracker::GetStats(MemoryTag::ECS);
+	assert(before.liveBytes == stats.liveBytes);
+	assert(before.allocationCount + allocationCount == stats.allocationCount);
+	assert(before.freeCount + allocationCount == stats.freeCount);
+
+	printf("[Success] Test_CrossThreadFree\n");
+}
+
+void Test_TrackerAlignment()
+{
+	MemoryTagScope scope(MemoryTag::Rendering);
+	const int64_t liveBytes = MemoryTracker::GetStats(MemoryTag::Rendering).liveBytes;
+
+	std::vector<void*> allocations;
+	for (size_t alignment = 1U; alignment <= 256U; alignment <<= 1U)
+	{
+		for (size_t size : { size_t(0U), size_t(1U), size_t(3U), alignment * 3U })
+		{
+			void* pMemory = MemoryTracker::Allocate(size, alignment);
+			assert(pMemory);
+			assert(0U == reinterpret_cast<uintptr_t>(pMemory) % alignment);
+			allocations.push_back(pMemory);
+		}
+	}
+
+	for (void* pMemory : allocations)
+	{
+		MemoryTracker::Free(pMemory);
+	}
+	assert(liveBytes == MemoryTracker::GetStats(MemoryTag::Rendering).liveBytes);
+
+	printf("[Success] Test_TrackerAlignment\n");
+}
+
+void Test_TrackerOverhead()
+{
+	constexpr uint32_t batchSize = 1024U;
+	constexpr uint32_t batchCount = 1000U;
+	std::vector<void*> allocations(batchSize);
+
+	auto measure = [&allocations](auto allocate, auto release)
+	{
+		auto begin = std::chrono::steady_clock::now();
+		for (uint32_t batchIndex = 0U; batchIndex < batchCount; ++batchIndex)
+		{
+			for (uint32_t allocationIndex = 0U; allocationIndex < batchSize; ++allocationIndex)
+			{
+				allocations[allocationIndex] = allocate(16U + allocationIndex % 256U);
+			}
+			for (void* pMemory : allocations)
+			{
+				release(pMemory);
+			}
+		}
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::nano>(end - begin).count() / (batchSize * batchCount);
+	};
+
+	const double mallocNs = measure([](size_t size) { return std::malloc(size); }, [](void* pMemory) { std::free(pMemory); });
+	MemoryTagScope scope(MemoryTag::Scene);
+	const double trackerNs = measure([](size_t size) { return MemoryTracker::Allocate(size); }, [](void* pMemory) { MemoryTracker::Free(pMemory); });
+
+	printf("[Benchmark] malloc/free : %.1f ns, MemoryTracker : %.1f ns per pair\n", mallocNs, trackerNs);
+	printf("[Success] Test_TrackerOverhead\n");
+}
+
+}
+
+int main()
+{
+	Test_Alignment();
+	Test_ResetMergesBlocks();
+	Test_SteadyStateFrames();
+	Test_RibbonPositions();
+
+	JobSystem& jobSystem = JobSystem::Get();
+	jobSystem.Init();
+	Test_ThreadArenas(jobSystem);
+	jobSystem.Shutdown();
+
+	Test_TagScopes();
+	Test_Accounting();
+	Test_CrossThreadFree();
+	Test_TrackerAlignment();
+	Test_TrackerOverhead();
+
+	return 0;
+}
@@ -0,0 +1,367 @@
+#include "ParticleSystem/ParticlePool.h"
+#include "ParticleSystem/ParticleSpawner.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+using namespace engine;
+
+bool IsNearlyEqual(float a, float b, float tolerance = 1e-4f)
+{
+	return std::abs(a - b) <= tolerance * std::max(1.0f, std::abs(a));
+}
+
+// Spawns particleCount particles with random state. The red color channel keeps the spawn order to identify particles.
+void SpawnParticles(ParticlePool& pool, uint32_t particleCount, uint32_t seed, float maxLifeTime)
+{
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+	std::uniform_real_distribution<float> velocity(-5.0f, 5.0f);
+	std::uniform_real_distribution<float> acceleration(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> lifeTime(0.1f, maxLifeTime);
+	for (uint32_t particleIndex = 0U; particleIndex < particleCount; ++particleIndex)
+	{
+		const int index = pool.AllocateParticleIndex();
+		assert(index == static_cast<int>(particleIndex));
+		pool.SetPosition(index, cd::Vec3f(position(generator), position(generator), position(generator)));
+		pool.SetVelocity(index, cd::Vec3f(velocity(generator), velocity(generator), velocity(generator)));
+		pool.SetAcceleration(index, cd::Vec3f(acceleration(generator), acceleration(generator), acceleration(generator)));
+		pool.SetLifeTime(index, lifeTime(generator));
+		pool.SetColor(index, cd::Vec4f(static_cast<float>(particleIndex), 1.0f, 1.0f, 1.0f));
+	}
+}
+
+void Test_ParticlePool()
+{
+	ParticlePool pool;
+	pool.SetParticleMaxCount(10);
+	assert(10 == pool.GetParticleMaxCount() && 0 == pool.GetParticleActiveCount());
+
+	// Particle i lives for i + 0.5 seconds.
+	for (int particleIndex = 0; particleIndex < 10; ++particleIndex)
+	{
+		const int index = pool.AllocateParticleIndex();
+		assert(particleIndex == index);
+		assert(0.0f == pool.GetAge(index) && 6.0f == pool.GetLifeTime(index));
+		assert(1.0f == pool.GetColor(index).w());
+		pool.SetLifeTime(index, static_cast<float>(particleIndex) + 0.5f);
+		pool.SetColor(index, cd::Vec4f(static_cast<float>(particleIndex), 0.0f, 0.0f, 1.0f));
+		pool.SetVelocity(index, cd::Vec3f(1.0f, 0.0f, 0.0f));
+		pool.SetAcceleration(index, cd::Vec3f(0.0f, 2.0f, 0.0f));
+	}
+	assert(-1 == pool.AllocateParticleIndex());
+
+	// p = v * t + a * t^2 / 2, v = v0 + a * t.
+	pool.Update(1.0f);
+	assert(9 == pool.GetParticleActiveCount());
+	for (int index = 0; index < pool.GetParticleActiveCount(); ++index)
+	{
+		assert(IsNearlyEqual(pool.GetPosition(index).x(), 1.0f) && IsNearlyEqual(pool.GetPosition(index).y(), 1.0f));
+		assert(IsNearlyEqual(pool.GetVelocity(index).y(), 2.0f));
+		assert(1.0f == pool.GetAge(index));
+	}
+
+	// Rendering between updates follows the same curve back to the previous update.
+	for (float alpha : { 0.0f, 0.5f, 1.0f })
+	{
+		const cd::Vec3f position = pool.GetInterpolatedPosition(0, alpha);
+		assert(IsNearlyEqual(position.x(), alpha) && IsNearlyEqual(position.y(), alpha * alpha));
+	}
+	{
+		// Particles which were spawned after the update don't move back behind the emitter.
+		ParticlePool spawnPool = pool;
+		const int index = spawnPool.AllocateParticleIndex();
+		spawnPool.SetPosition(index, cd::Vec3f(5.0f, 5.0f, 5.0f));
+		spawnPool.SetVelocity(index, cd::Vec3f(1.0f, 1.0f, 1.0f));
+		assert(IsNearlyEqual(spawnPool.GetInterpolatedPosition(index, 0.0f).x(), 5.0f));
+	}
+
+	// Dead particles are swap removed so alive ones stay packed in front.
+	pool.Update(1.0f);
+	pool.Update(1.0f);
+	assert(7 == pool.GetParticleActiveCount());
+	std::vector<bool> isAlive(10, false);
+	for (int index = 0; index < pool.GetParticleActiveCount(); ++index)
+	{
+		const int particleID = static_cast<int>(pool.GetColor(index).x());
+		assert(pool.GetAge(index) < pool.GetLifeTime(index));
+		assert(!isAlive[particleID]);
+		isAlive[particleID] = true;
+	}
+	for (int particleID = 0; particleID < 10; ++particleID)
+	{
+		assert(isAlive[particleID] == (particleID >= 3));
+	}
+
+	// Freed slots are reused.
+	assert(7 == pool.AllocateParticleIndex());
+
+	// Same capacity keeps particles, a smaller one drops the ones past it.
+	pool.SetParticleMaxCount(10);
+	assert(8 == pool.GetParticleActiveCount());
+	const cd::Vec3f firstPosition = pool.GetPosition(0);
+	pool.SetParticleMaxCount(5);
+	assert(5 == pool.GetParticleActiveCount() && 5 == pool.GetParticleMaxCount());
+	assert(firstPosition == pool.GetPosition(0));
+
+	ParticlePool copiedPool = pool;
+	assert(5 == copiedPool.GetParticleActiveCount() && firstPosition == copiedPool.GetPosition(0));
+
+	pool.AllParticlesReset();
+	assert(0 == pool.GetParticleActiveCount() && 5 == pool.GetParticleMaxCount());
+	assert(5 == copiedPool.GetParticleActiveCount());
+
+	// Particles inside of the force field range turn around the z axis.
+	ParticlePool forceFieldPool;
+	forceFieldPool.SetParticleMaxCount(2);
+	forceFieldPool.SetRotationForceField(true, cd::Vec3f(5.0f, 5.0f, 5.0f));
+	const int insideIndex = forceFieldPool.AllocateParticleIndex();
+	forceFieldPool.SetVelocity(insideIndex, cd::Vec3f(2.0f, 4.0f, 0.0f));
+	const int outsideIndex = forceFieldPool.AllocateParticleIndex();
+	forceFieldPool.SetPosition(outsideIndex, cd::Vec3f(100.0f, 0.0f, 0.0f));
+	forceFieldPool.SetVelocity(outsideIndex, cd::Vec3f(2.0f, 4.0f, 0.0f));
+	forceFieldPool.Update(0.5f);
+	assert(IsNearlyEqual(forceFieldPool.GetAcceleration(insideIndex).x(), 2.0f) && IsNearlyEqual(forceFieldPool.GetAcceleration(insideIndex).y(), -1.0f));
+	assert(0.0f == forceFieldPool.GetAcceleration(outsideIndex).x() && 0.0f == forceFieldPool.GetAcceleration(outsideIndex).y());
+
+	printf("[Success] Test_ParticlePool\n");
+}
+
+void Test_ParticleKernels()
+{
+	// Not a multiple of the lane count so the last register has padding lanes.
+	constexpr uint32_t particleCount = 1003U;
+	for (bool rotationForceField : { false, true })
+	{
+		ParticlePool simdPool;
+		simdPool.SetParticleMaxCount(particleCount);
+		simdPool.SetRotationForceField(rotationForceField, cd::Vec3f(8.0f, 8.0f, 8.0f));
+		SpawnParticles(simdPool, particleCount, 7U, 3.0f);
+		ParticlePool scalarPool = simdPool;
+
+		for (uint32_t frameIndex = 0U; frameIndex < 120U; ++frameIndex)
+		{
+			simdPool.Update(1.0f / 60.0f);
+			scalarPool.UpdateScalar(1.0f / 60.0f);
+			assert(simdPool.GetParticleActiveCount() == scalarPool.GetParticleActiveCount());
+		}
+		assert(simdPool.GetParticleActiveCount() > 0 && simdPool.GetParticleActiveCount() < static_cast<int>(particleCount));
+
+		for (int index = 0; index < simdPool.GetParticleActiveCount(); ++index)
+		{
+			for (uint32_t streamIndex = 0U; streamIndex < static_cast<uint32_t>(ParticleStream::Count); ++streamIndex)
+			{
+				const ParticleStream stream = static_cast<ParticleStream>(streamIndex);
+				assert(IsNearlyEqual(simdPool.GetStream(stream)[index], scalarPool.GetStream(stream)[index]));
+			}
+		}
+	}
+
+	printf("[Success] Test_ParticleKernels\n");
+}
+
+bool IsPoolEqual(const ParticlePool& a, const ParticlePool& b)
+{
+	if (a.GetParticleActiveCount() != b.GetParticleActiveCount())
+	{
+		return false;
+	}
+
+	for (uint32_t streamIndex = 0U; streamIndex < static_cast<uint32_t>(ParticleStream::Count); ++streamIndex)
+	{
+		const ParticleStream stream = static_cast<ParticleStream>(streamIndex);
+		if (!std::equal(a.GetStream(stream), a.GetStream(stream) + a.GetParticleActiveCount(), b.GetStream(stream)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Test_ParticleSpawner()
+{
+	// Fractions carry over so the count follows the rate at any tick length.
+	{
+		ParticleSpawner spawner;
+		spawner.SetSpawnRate(30.0f);
+		uint32_t spawnCount = 0U;
+		for (uint32_t tickIndex = 0U; tickIndex < 60U; ++tickIndex)
+		{
+			const uint32_t tickSpawnCount = spawner.Tick(1.0f / 60.0f);
+			assert(tickSpawnCount == tickIndex % 2U);
+			spawnCount += tickSpawnCount;
+		}
+		assert(30U == spawnCount);
+
+		spawner.Reset();
+		spawnCount = 0U;
+		for (uint32_t tickIndex = 0U; tickIndex < 144U * 10U; ++tickIndex)
+		{
+			spawnCount += spawner.Tick(1.0f / 144.0f);
+		}
+		assert(spawnCount >= 299U && spawnCount <= 300U);
+
+		spawner.Reset();
+		assert(300U == spawner.Tick(10.0f));
+	}
+
+	// Every burst cycle is counted once, also when one tick covers several cycles.
+	{
+		ParticleSpawner spawner;
+		spawner.SetSpawnRate(0.0f);
+		spawner.AddBurst({ 0.5f, 10U, 3U, 0.25f });
+		uint32_t spawnCount = 0U;
+		for (uint32_t tickIndex = 0U; tickIndex < 20U; ++tickIndex)
+		{
+			const uint32_t tickSpawnCount = spawner.Tick(0.1f);
+			assert(0U == tickSpawnCount || 10U == tickSpawnCount);
+			assert(0U == tickSpawnCount || spawner.GetTime() > 0.5f);
+			spawnCount += tickSpawnCount;
+		}
+		assert(30U == spawnCount);
+
+		spawner.Reset();
+		assert(30U == spawner.Tick(2.0f) && 0U == spawner.Tick(2.0f));
+
+		// Repeats forever and adds up with the rate.
+		spawner.ClearBursts();
+		spawner.AddBurst({ 0.0f, 5U, 0U, 1.0f });
+		spawner.SetSpawnRate(2.0f);
+		spawner.Reset();
+		spawnCount = 0U;
+		for (uint32_t tickIndex = 0U; tickIndex < 590U; ++tickIndex)
+		{
+			spawnCount += spawner.Tick(1.0f / 60.0f);
+		}
+		assert(10U * 5U + 19U == spawnCount);
+	}
+
+	// Same seed and ticks give the same particles.
+	{
+		ParticleSpawnParams params;
+		params.position = cd::Vec3f(1.0f, 2.0f, 3.0f);
+		params.positionRange = cd::Vec3f(4.0f, 1.0f, 4.0f);
+		params.randomPosition = true;
+		params.velocity = cd::Vec3f(0.0f, 5.0f, 0.0f);
+		params.velocityRange = cd::Vec3f(1.0f, 1.0f, 1.0f);
+		params.randomVelocity = true;
+		params.acceleration = cd::Vec3f(0.0f, -9.8f, 0.0f);
+		params.lifeTime = 1.5f;
+
+		auto simulate = [&params](uint32_t seed, ParticlePool& pool)
+		{
+			ParticleSpawner spawner(seed);
+			spawner.SetSpawnRate(120.0f);
+			spawner.AddBurst({ 0.25f, 40U, 4U, 0.5f });
+			pool.SetParticleMaxCount(200);
+			for (uint32_t tickIndex = 0U; tickIndex < 300U; ++tickIndex)
+			{
+				spawner.Simulate(pool, 1.0f / 60.0f, params);
+				assert(pool.GetParticleActiveCount() <= pool.GetParticleMaxCount());
+			}
+		};
+
+		ParticlePool poolA;
+		ParticlePool poolB;
+		ParticlePool poolC;
+		simulate(42U, poolA);
+		simulate(42U, poolB);
+		simulate(43U, poolC);
+		assert(poolA.GetParticleActiveCount() > 100);
+		assert(IsPoolEqual(poolA, poolB));
+		assert(!IsPoolEqual(poolA, poolC));
+
+		for (int index = 0; index < poolA.GetParticleActiveCount(); ++index)
+		{
+			const cd::Vec3f velocity = poolA.GetVelocity(index);
+			assert(poolA.GetAge(index) < params.lifeTime);
+			assert(std::abs(velocity.x()) <= 1.0f && std::abs(velocity.z()) <= 1.0f);
+		}
+	}
+
+	// Spawns past the capacity are dropped and don't pile up for later ticks.
+	{
+		ParticleSpawnParams params;
+		params.lifeTime = 0.5f;
+		ParticleSpawner spawner;
+		spawner.SetSpawnRate(0.0f);
+		spawner.AddBurst({ 0.0f, 100U, 1U, 1.0f });
+		ParticlePool pool;
+		pool.SetParticleMaxCount(10);
+		assert(10U == spawner.Simulate(pool, 0.1f, params));
+		assert(0U == spawner.Simulate(pool, 0.1f, params));
+		assert(10 == pool.GetParticleActiveCount());
+		for (uint32_t tickIndex = 0U; tickIndex < 5U; ++tickIndex)
+		{
+			spawner.Simulate(pool, 0.1f, params);
+		}
+		assert(0 == pool.GetParticleActiveCount());
+	}
+
+	printf("[Success] Test_ParticleSpawner\n");
+}
+
+void Test_ParticleKernelsBenchmark()
+{
+	constexpr uint32_t particleCount = 1000000U;
+	constexpr uint32_t frameCount = 100U;
+	constexpr float deltaTime = 1.0f / 60.0f;
+
+	// Life times are long enough that every particle is alive for the whole benchmark.
+	ParticlePool simdPool;
+	simdPool.SetParticleMaxCount(particleCount);
+	SpawnParticles(simdPool, particleCount, 11U, 1.0f);
+	for (int index = 0; index < simdPool.GetParticleActiveCount(); ++index)
+	{
+		simdPool.SetLifeTime(index, 1000.0f);
+	}
+	ParticlePool scalarPool = simdPool;
+
+	using Clock = std::chrono::steady_clock;
+	auto toMs = [](Clock::duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+
+	auto scalarBegin = Clock::now();
+	for (uint32_t frameIndex = 0U; frameIndex < frameCount; ++frameIndex)
+	{
+		scalarPool.UpdateScalar(deltaTime);
+	}
+	const double scalarMs = toMs(Clock::now() - scalarBegin) / frameCount;
+
+	auto simdBegin = Clock::now();
+	for (uint32_t frameIndex = 0U; frameIndex < frameCount; ++frameIndex)
+	{
+		simdPool.Update(deltaTime);
+	}
+	const double simdMs = toMs(Clock::now() - simdBegin) / frameCount;
+
+	assert(static_cast<int>(particleCount) == simdPool.GetParticleActiveCount());
+	for (int index = 0; index < simdPool.GetParticleActiveCount(); index += 997)
+	{
+		assert(IsNearlyEqual(simdPool.GetPosition(index).x(), scalarPool.GetPosition(index).x(), 1e-3f));
+	}
+
+	printf("[Benchmark] %u particles update : scalar %.3f ms, %s %.3f ms (%.1fx)\n",
+		particleCount, scalarMs, ParticlePool::GetInstructionSetName(), simdMs, scalarMs / simdMs);
+	printf("[Success] Test_ParticleKernelsBenchmark\n");
+}
+
+}
+
+int main()
+{
+	Test_ParticlePool();
+	Test_ParticleKernels();
+	Test_ParticleSpawner();
+	Test_ParticleKernelsBenchmark();
+
+	return 0;
+}
@@ -0,0 +1,309 @@
+#include "Core/Jobs/JobSystem.h"
+#include "Profiling/Profile.h"
+#include "Utilities/PerformanceProfiler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using namespace engine;
+
+const ProfileZone* FindZone(const std::vector<ProfileZone>& zones, const char* pName)
+{
+	auto itZone = std::find_if(zones.begin(), zones.end(), [pName](const ProfileZone& zone) { return 0 == std::strcmp(zone.pName, pName); });
+	return itZone != zones.end() ? &*itZone : nullptr;
+}
+
+uint32_t CountOccurrences(const std::string& text, const char* pPattern)
+{
+	uint32_t count = 0U;
+	for (size_t pos = text.find(pPattern); pos != std::string::npos; pos = text.find(pPattern, pos + 1U))
+	{
+		++count;
+	}
+	return count;
+}
+
+void Test_NestedZones()
+{
+	cdtools::PerformanceProfiler perf("Test_NestedZones");
+
+	FrameProfiler& profiler = FrameProfiler::Get();
+	profiler.Reset();
+
+	{
+		ProfileScope outer("Outer");
+		{
+			ProfileScope inner("Inner");
+			ProfileScope innermost("Innermost");
+		}
+		ProfileScope sibling("Sibling");
+	}
+	profiler.EndFrame();
+
+	const std::vector<ProfileZone>& zones = profiler.GetFrameZones();
+	assert(4U == zones.size());
+
+	const ProfileZone* pOuter = FindZone(zones, "Outer");
+	const ProfileZone* pInner = FindZone(zones, "Inner");
+	const ProfileZone* pInnermost = FindZone(zones, "Innermost");
+	const ProfileZone* pSibling = FindZone(zones, "Sibling");
+	assert(pOuter && pInner && pInnermost && pSibling);
+	assert(0U == pOuter->depth && 1U == pInner->depth && 2U == pInnermost->depth && 1U == pSibling->depth);
+
+	// Children are inside their parents.
+	assert(pOuter->beginTime <= pInner->beginTime && pInner->endTime <= pOuter->endTime);
+	assert(pInner->beginTime <= pInnermost->beginTime && pInnermost->endTime <= pInner->endTime);
+	assert(pInner->endTime <= pSibling->beginTime && pSibling->endTime <= pOuter->endTime);
+
+	// Rings are drained by EndFrame.
+	profiler.EndFrame();
+	assert(profiler.GetFrameZones().empty());
+
+	printf("[Success] Test_NestedZones\n");
+}
+
+void Test_MultiThreadZones(JobSystem& jobSystem)
+{
+	cdtools::PerformanceProfiler perf("Test_MultiThreadZones");
+
+	FrameProfiler& profiler = FrameProfiler::Get();
+	profiler.Reset();
+
+	constexpr uint32_t taskCount = 4096U;
+	constexpr uint16_t viewCount = 8U;
+	jobSystem.ParallelFor(taskCount, 16U, [](uint32_t begin, uint32_t end)
+	{
+		ProfileScope batch("Batch");
+		for (uint32_t taskIndex = begin; taskIndex < end; ++taskIndex)
+		{
+			ProfileScope task("Task", static_cast<uint16_t>(taskIndex % viewCount));
+		}
+	});
+
+	profiler.AddGpuView("ViewA", 0U, 0.1, 0.0, 1.0);
+	profiler.AddGpuView("ViewB", 1U, 0.1, 1.0, 2.0);
+	profiler.AddGpuView("ViewB", 9U, 0.1, 3.0, 0.5);
+	profiler.EndFrame();
+
+	assert(taskCount + taskCount / 16U == profiler.GetFrameZones().size());
+	assert(0U == profiler.GetDroppedZoneCount());
+
+	uint32_t taskZoneCount = 0U;
+	for (const ProfileZoneStats& stats : profiler.GetZoneStats())
+	{
+		if (0 == std::strcmp(stats.pName, "Task"))
+		{
+			assert(taskCount / viewCount == stats.callCount);
+			taskZoneCount += stats.callCount;
+		}
+		else
+		{
+			assert(0 == std::strcmp(stats.pName, "Batch"));
+			assert(InvalidProfileViewID == stats.viewID);
+			assert(taskCount / 16U == stats.callCount);
+		}
+	}
+	assert(taskCount == taskZoneCount);
+
+	// Renderers are keyed by view. GPU time of views which share a name is summed.
+	const std::vector<ProfileRendererStats>& rendererStats = profiler.GetRendererStats();
+	assert(viewCount == rendererStats.size());
+	for (const ProfileRendererStats& stats : rendererStats)
+	{
+		if (0U == stats.viewID)
+		{
+			assert("ViewA" == stats.name && 1.0 == stats.gpuMs);
+		}
+		else if (1U == stats.viewID)
+		{
+			assert("ViewB" == stats.name && 2.5 == stats.gpuMs);
+		}
+		else
+		{
+			assert(stats.name.empty() && 0.0 == stats.gpuMs);
+		}
+		assert(stats.cpuMs >= 0.0);
+	}
+
+	printf("[Success] Test_MultiThreadZones\n");
+}
+
+void Test_ChromeTrace()
+{
+	cdtools::PerformanceProfiler perf("Test_ChromeTrace");
+
+	FrameProfiler& profiler = FrameProfiler::Get();
+	profiler.Reset();
+	profiler.SetThreadName("Main \"Thread\"");
+
+	// Starts the frame timer. Captures only contain complete frames.
+	profiler.EndFrame();
+
+	constexpr uint32_t frameCount = 3U;
+	profiler.BeginCapture(frameCount);
+	for (uint32_t frameIndex = 0U; frameIndex < frameCount + 2U; ++frameIndex)
+	{
+		{
+			ProfileScope frame("Frame");
+			ProfileScope render("Render", 5U);
+		}
+		profiler.AddGpuView("Scene", 5U, 0.2, 0.0, 0.75);
+		profiler.EndFrame();
+	}
+	assert(!profiler.IsCapturing());
+	assert(frameCount == profiler.GetCapturedFrameCount());
+
+	std::stringstream stream;
+	profiler.WriteChromeTrace(stream);
+	const std::string trace = stream.str();
+
+	assert(0U == trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+	assert(2U * frameCount + frameCount == CountOccurrences(trace, "\"ph\":\"X\""));
+	assert(frameCount == CountOccurrences(trace, "\"cat\":\"GPU\""));
+	assert(frameCount == CountOccurrences(trace, "\"ph\":\"i\""));
+	// Zones tagged with a view are named after it.
+	assert(2U * frameCount == CountOccurrences(trace, "\"name\":\"Scene\""));
+	assert(std::string::npos != trace.find("\"name\":\"Main \\\"Thread\\\"\""));
+	assert(CountOccurrences(trace, "{") == CountOccurrences(trace, "}"));
+	assert(CountOccurrences(trace, "[") == CountOccurrences(trace, "]"));
+
+	printf("[Success] Test_ChromeTrace\n");
+}
+
+void Test_Counters()
+{
+	cdtools::PerformanceProfiler perf("Test_Counters");
+
+	FrameProfiler& profiler = FrameProfiler::Get();
+	profiler.Reset();
+	profiler.EndFrame();
+
+	// Counters of a frame are visible after its EndFrame. The last value of a frame wins.
+	constexpr uint32_t frameCount = 2U;
+	profiler.BeginCapture(frameCount);
+	for (uint32_t frameIndex = 0U; frameIndex < frameCount; ++frameIndex)
+	{
+		CD_PROFILE_COUNTER("Bones", 10);
+		CD_PROFILE_COUNTER("Bones", 100 + frameIndex);
+		CD_PROFILE_COUNTER("Characters", 3);
+		assert(frameIndex > 0U || profiler.GetCounters().empty());
+		profiler.EndFrame();
+	}
+	assert(2U == profiler.GetCounters().size());
+	assert(101 == profiler.GetCounter("Bones"));
+	assert(3 == profiler.GetCounter("Characters"));
+	assert(0 == profiler.GetCounter("Unknown"));
+
+	std::stringstream stream;
+	profiler.WriteChromeTrace(stream);
+	const std::string trace = stream.str();
+	assert(2U * frameCount == CountOccurrences(trace, "\"ph\":\"C\""));
+	assert(std::string::npos != trace.find("\"args\":{\"value\":101}"));
+
+	// Counters are dropped while disabled.
+	FrameProfiler::SetEnable(false);
+	CD_PROFILE_COUNTER("Bones", 7);
+	profiler.EndFrame();
+	FrameProfiler::SetEnable(true);
+	profiler.EndFrame();
+	assert(profiler.GetCounters().empty());
+
+	printf("[Success] Test_Counters\n");
+}
+
+void Test_ThreadContexts()
+{
+	cdtools::PerformanceProfiler perf("Test_ThreadContexts");
+
+	FrameProfiler& profiler = FrameProfiler::Get();
+	profiler.Reset();
+
+	// Naming a thread doesn't allocate a zone ring.
+	const uint32_t zoneRingCount = profiler.GetZoneRingCount();
+	std::thread([]() { CD_PROFILE_THREAD("Named"); }).join();
+	assert(zoneRingCount == profiler.GetZoneRingCount());
+
+	// Zones of exited threads are still drained, then their contexts are reused.
+	std::thread([]() { ProfileScope zone("Exited"); }).join();
+	const uint32_t threadContextCount = profiler.GetThreadContextCount();
+	profiler.EndFrame();
+	assert(nullptr != FindZone(profiler.GetFrameZones(), "Exited"));
+	for (uint32_t threadIndex = 0U; threadIndex < 8U; ++threadIndex)
+	{
+		std::thread([]() { ProfileScope zone("Reused"); }).join();
+		profiler.EndFrame();
+		assert(1U == profiler.GetFrameZones().size());
+	}
+	assert(threadContextCount == profiler.GetThreadContextCount());
+
+	printf("[Success] Test_ThreadContexts\n");
+}
+
+double Benchmark_Zones(uint32_t zoneCount)
+{
+	FrameProfiler& profiler = FrameProfiler::Get();
+	auto startTime = std::chrono::steady_clock::now();
+	for (uint32_t zoneIndex = 0U; zoneIndex < zoneCount; ++zoneIndex)
+	{
+		ProfileScope zone("Zone");
+		if (0U == (zoneIndex + 1U) % (ProfileZoneRing::Capacity / 2U))
+		{
+			profiler.EndFrame();
+		}
+	}
+	auto endTime = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(endTime - startTime).count() / zoneCount;
+}
+
+void Test_ZoneCost()
+{
+	cdtools::PerformanceProfiler perf("Test_ZoneCost");
+
+	FrameProfiler& profiler = FrameProfiler::Get();
+	profiler.Reset();
+
+	constexpr uint32_t zoneCount = 1U << 20U;
+	const double enabledCost = Benchmark_Zones(zoneCount);
+
+	FrameProfiler::SetEnable(false);
+	const double disabledCost = Benchmark_Zones(zoneCount);
+	profiler.EndFrame();
+	assert(profiler.GetFrameZones().empty());
+	FrameProfiler::SetEnable(true);
+
+	printf("[Benchmark] Zone cost enabled : %6.2f ns, disabled : %6.2f ns\n", enabledCost, disabledCost);
+	printf("[Success] Test_ZoneCost\n");
+}
+
+}
+
+int main()
+{
+	// Off until a profiler panel or a tool turns it on.
+	assert(!FrameProfiler::IsEnabled());
+	FrameProfiler::SetEnable(true);
+
+	Test_NestedZones();
+
+	JobSystem& jobSystem = JobSystem::Get();
+	jobSystem.Init();
+	Test_MultiThreadZones(jobSystem);
+	jobSystem.Shutdown();
+
+	Test_ChromeTrace();
+	Test_Counters();
+	Test_ThreadContexts();
+	Test_ZoneCost();
+
+	return 0;
+}
@@ -0,0 +1,495 @@
+#include "Base/Template.h"
+#include "Core/Jobs/JobSystem.h"
+#include "Graphics/GraphicsBackend.h"
+#include "Rendering/ParallelRenderRecorder.h"
+#include "Rendering/RenderContext.h"
+#include "Rendering/RenderGraph.h"
+#include "Rendering/Renderer.h"
+#include "Rendering/Resources/TextureResource.h"
+#include "Scene/Texture.h"
+#include "Utilities/PerformanceProfiler.h"
+
+#include <bgfx/bgfx.h>
+#include <bimg/bimg.h>
+#include <bx/file.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using namespace engine;
+
+std::string Test_WriteSourceTexture()
+{
+	constexpr uint32_t textureSize = 4U;
+	uint8_t pixels[textureSize * textureSize * 4U];
+	for (uint32_t pixelIndex = 0U; pixelIndex < textureSize * textureSize * 4U; ++pixelIndex)
+	{
+		pixels[pixelIndex] = static_cast<uint8_t>(pixelIndex);
+	}
+
+	std::string textureFilePath = (std::filesystem::temp_directory_path() / "cd_stress_texture.tga").generic_string();
+	bx::FileWriter writer;
+	bool isOpened = bx::open(&writer, textureFilePath.c_str());
+	assert(isOpened);
+	bimg::imageWriteTga(&writer, textureSize, textureSize, textureSize * 4U, pixels, false, false);
+	bx::close(&writer);
+
+	return textureFilePath;
+}
+
+// Every texture used to create its own sampler uniform which runs out of bgfx uniform handles in large scenes.
+void Test_LoadManyTextures(RenderContext& renderContext, const std::string& textureFilePath)
+{
+	cdtools::PerformanceProfiler perf("Test_LoadManyTextures");
+
+	// bgfx limits alive texture handles too. So load textures batch by batch.
+	constexpr uint32_t textureCount = 10000U;
+	constexpr uint32_t batchTextureCount = 1000U;
+	constexpr uint8_t usedSlotCount = 4U;
+	constexpr cd::TextureMapMode mapModes[2] = { cd::TextureMapMode::Wrap, cd::TextureMapMode::Clamp };
+
+	const uint16_t oldUniformCount = bgfx::getStats()->numUniforms;
+	for (uint32_t batchStart = 0U; batchStart < textureCount; batchStart += batchTextureCount)
+	{
+		std::vector<std::unique_ptr<TextureResource>> textureResources;
+		textureResources.reserve(batchTextureCount);
+		for (uint32_t textureIndex = 0U; textureIndex < batchTextureCount; ++textureIndex)
+		{
+			auto pTextureResource = std::make_unique<TextureResource>();
+			cd::TextureMapMode mapMode = mapModes[textureIndex % 2U];
+			pTextureResource->UpdateUVMapMode(mapMode, mapMode);
+			pTextureResource->SetDDSBuiltTexturePath(textureFilePath);
+			textureResources.push_back(cd::MoveTemp(pTextureResource));
+		}
+
+		// Loading -> Loaded -> Building -> Built -> Ready
+		for (uint32_t updateIndex = 0U; updateIndex < 4U; ++updateIndex)
+		{
+			for (auto& pTextureResource : textureResources)
+			{
+				pTextureResource->Update();
+			}
+		}
+
+		for (uint32_t textureIndex = 0U; textureIndex < batchTextureCount; ++textureIndex)
+		{
+			const TextureResource* pTextureResource = textureResources[textureIndex].get();
+			assert(ResourceStatus::Ready == pTextureResource->GetStatus());
+			assert(bgfx::isValid(bgfx::TextureHandle{ pTextureResource->GetTextureHandle() }));
+
+			renderContext.BindTexture(static_cast<uint8_t>(textureIndex % usedSlotCount), pTextureResource->GetTextureHandle(), pTextureResource->GetSamplerFlags());
+		}
+		renderContext.EndFrame();
+	}
+
+	// One sampler state per slot and address mode. All of them share one uniform per slot.
+	assert(renderContext.GetSamplerStateCount() <= usedSlotCount * 2U);
+	assert(bgfx::getStats()->numUniforms - oldUniformCount <= usedSlotCount);
+
+	printf("[Success] Test_LoadManyTextures\n");
+}
+
+// A -> B -> C -> D(output) with an unused pass on the side.
+// The unused pass is culled and the texture written by C can reuse A's texture because their lifetimes don't overlap.
+void Test_RenderGraph(RenderContext& renderContext)
+{
+	cdtools::PerformanceProfiler perf("Test_RenderGraph");
+
+	constexpr uint16_t viewCount = 8U;
+	RenderGraph renderGraph;
+	renderGraph.SetViewRange(renderContext.CreateViews(viewCount), viewCount);
+
+	const RenderGraphTextureDesc outputDesc{ 64, 64, bgfx::TextureFormat::RGBA8, BGFX_TEXTURE_BLIT_DST };
+	bgfx::TextureHandle outputTexture = bgfx::createTexture2D(outputDesc.width, outputDesc.height, false, 1, outputDesc.format, outputDesc.flags);
+
+	auto BuildFrame = [&](uint16_t size, bgfx::TextureHandle* pTextureHandles, uint16_t* pViewIDs)
+	{
+		const RenderGraphTextureDesc desc{ size, size, bgfx::TextureFormat::RGBA8, BGFX_TEXTURE_RT };
+		const RenderGraphResource output = renderGraph.ImportTexture("Output", outputTexture, outputDesc);
+
+		RenderGraphResource textureA = InvalidRenderGraphResource;
+		renderGraph.AddPass("A", [&](RenderGraphBuilder& builder)
+		{
+			textureA = builder.WriteAttachment(builder.CreateTexture("TextureA", desc));
+		},
+		[&textureA, pTextureHandles, pViewIDs](const RenderGraph& graph, uint16_t viewID)
+		{
+			pTextureHandles[0] = graph.GetTexture(textureA);
+			pViewIDs[0] = viewID;
+		});
+
+		RenderGraphResource textureB = InvalidRenderGraphResource;
+		renderGraph.AddPass("B", [&](RenderGraphBuilder& builder)
+		{
+			builder.Read(textureA);
+			textureB = builder.WriteAttachment(builder.CreateTexture("TextureB", desc));
+		},
+		[&textureB, pTextureHandles, pViewIDs](const RenderGraph& graph, uint16_t viewID)
+		{
+			pTextureHandles[1] = graph.GetTexture(textureB);
+			pViewIDs[1] = viewID;
+		});
+
+		renderGraph.AddPass("Unused", [&](RenderGraphBuilder& builder)
+		{
+			builder.Read(textureB);
+			builder.WriteAttachment(builder.CreateTexture("TextureUnused", desc));
+		},
+		[](const RenderGraph&, uint16_t)
+		{
+			assert(false && "Culled pass should not execute.");
+		});
+
+		RenderGraphResource textureC = InvalidRenderGraphResource;
+		renderGraph.AddPass("C", [&](RenderGraphBuilder& builder)
+		{
+			builder.Read(textureB);
+			textureC = builder.WriteAttachment(builder.CreateTexture("TextureC", desc));
+		},
+		[&textureC, pTextureHandles, pViewIDs](const RenderGraph& graph, uint16_t viewID)
+		{
+			pTextureHandles[2] = graph.GetTexture(textureC);
+			pViewIDs[2] = viewID;
+		});
+
+		renderGraph.AddPass("D", [&](RenderGraphBuilder& builder)
+		{
+			builder.Read(textureC);
+			builder.Write(output);
+		},
+		[&textureC, output, pViewIDs](const RenderGraph& graph, uint16_t viewID)
+		{
+			bgfx::blit(viewID, graph.GetTexture(output), 0, 0, graph.GetTexture(textureC));
+			pViewIDs[3] = viewID;
+		});
+
+		renderGraph.Compile();
+		assert(5U == renderGraph.GetPassCount());
+		assert(1U == renderGraph.GetCulledPassCount());
+		assert(renderGraph.IsPassCulled(2U));
+		assert(3U == renderGraph.GetTransientTextureCount());
+		renderGraph.Execute();
+		renderContext.EndFrame();
+	};
+
+	bgfx::TextureHandle firstTextureHandles[3];
+	uint16_t viewIDs[4];
+	BuildFrame(64U, firstTextureHandles, viewIDs);
+	for (uint16_t passIndex = 0U; passIndex < 4U; ++passIndex)
+	{
+		assert(renderGraph.GetFirstViewID() + passIndex == viewIDs[passIndex]);
+	}
+	assert(firstTextureHandles[0].idx == firstTextureHandles[2].idx);
+	assert(firstTextureHandles[0].idx != firstTextureHandles[1].idx);
+	assert(2U == renderGraph.GetPhysicalTextureCount());
+	assert(2U * 64U * 64U * 4U == renderGraph.GetPhysicalTextureBytes());
+
+	// Same graph in the next frame reuses the same textures.
+	bgfx::TextureHandle textureHandles[3];
+	BuildFrame(64U, textureHandles, viewIDs);
+	assert(2U == renderGraph.GetPhysicalTextureCount());
+	for (uint16_t textureIndex = 0U; textureIndex < 3U; ++textureIndex)
+	{
+		assert(firstTextureHandles[textureIndex].idx == textureHandles[textureIndex].idx);
+	}
+
+	// After a resize, textures of the old size are released once they stay unused long enough.
+	for (uint32_t frameIndex = 0U; frameIndex <= RenderGraph::UnusedFrameCountBeforeRelease + 1U; ++frameIndex)
+	{
+		BuildFrame(32U, textureHandles, viewIDs);
+	}
+	assert(2U == renderGraph.GetPhysicalTextureCount());
+	assert(2U * 32U * 32U * 4U == renderGraph.GetPhysicalTextureBytes());
+
+	renderGraph.Reset();
+	assert(0U == renderGraph.GetPhysicalTextureCount());
+	bgfx::destroy(outputTexture);
+
+	printf("[Success] Test_RenderGraph\n");
+}
+
+// What one submit call handed to the encoder.
+struct RecordedDraw
+{
+	uint16_t viewID;
+	uint32_t depth;
+	uint64_t state;
+	uint64_t transformDigest;
+
+	bool operator==(const RecordedDraw&) const = default;
+};
+
+// Forwards to a bgfx encoder and logs every submit with the state which was set for it.
+class RecordingEncoder final
+{
+public:
+	RecordingEncoder(bgfx::Encoder* pEncoder, std::vector<RecordedDraw>& recordedDraws)
+		: m_pEncoder(pEncoder)
+		, m_recordedDraws(recordedDraws)
+	{
+	}
+
+	void setTransform(const float* pTransform)
+	{
+		uint32_t transformBits[16];
+		std::memcpy(transformBits, pTransform, sizeof(transformBits));
+		m_transformDigest = 14695981039346656037ULL;
+		for (uint32_t bits : transformBits)
+		{
+			m_transformDigest = (m_transformDigest ^ bits) * 1099511628211ULL;
+		}
+		m_pEncoder->setTransform(pTransform);
+	}
+
+	void setState(uint64_t state)
+	{
+		m_state = state;
+		m_pEncoder->setState(state);
+	}
+
+	void submit(uint16_t viewID, uint32_t depth)
+	{
+		m_recordedDraws.push_back({ viewID, depth, m_state, m_transformDigest });
+		m_pEncoder->submit(viewID, BGFX_INVALID_HANDLE, depth);
+		m_state = 0U;
+		m_transformDigest = 0U;
+	}
+
+private:
+	bgfx::Encoder* m_pEncoder;
+	std::vector<RecordedDraw>& m_recordedDraws;
+	uint64_t m_state = 0U;
+	uint64_t m_transformDigest = 0U;
+};
+
+// Two record tasks share every view and interleave their draw calls by sort depth.
+// What the encoders received, in bgfx's sort order, must not depend on how tasks are spread over threads and encoders.
+class RecordTestRenderer final : public Renderer
+{
+public:
+	static constexpr uint32_t TaskCount = 16U;
+	static constexpr uint32_t ViewCount = TaskCount / 2U;
+	static constexpr uint32_t DrawCountPerTask = 1024U;
+
+public:
+	RecordTestRenderer(RenderContext& renderContext, uint32_t workCountPerDraw)
+		: Renderer(renderContext.CreateView())
+		, m_workCountPerDraw(workCountPerDraw)
+	{
+		m_viewIDs[0] = GetViewID();
+		for (uint32_t viewIndex = 1U; viewIndex < ViewCount; ++viewIndex)
+		{
+			m_viewIDs[viewIndex] = renderContext.CreateView();
+		}
+
+		for (uint32_t taskIndex = 0U; taskIndex < TaskCount; ++taskIndex)
+		{
+			m_recordedDraws[taskIndex].reserve(DrawCountPerTask);
+		}
+	}
+
+	virtual void Init() override {}
+	virtual void UpdateView(const float* pViewMatrix, const float* pProjectionMatrix) override {}
+	virtual void Render(float deltaTime) override {}
+
+	virtual bool IsParallelRecordSupported() const override { return true; }
+	virtual bool PrepareRecord(float deltaTime) override
+	{
+		// Views are global bgfx state so they are set up on the main thread.
+		for (uint32_t viewIndex = 0U; viewIndex < ViewCount; ++viewIndex)
+		{
+			bgfx::setViewRect(m_viewIDs[viewIndex], 0, 0, 64, 64);
+		}
+
+		for (uint32_t taskIndex = 0U; taskIndex < TaskCount; ++taskIndex)
+		{
+			m_recordCounts[taskIndex].store(0U);
+			m_recordedDraws[taskIndex].clear();
+		}
+		return true;
+	}
+	virtual uint32_t GetRecordTaskCount() const override { return TaskCount; }
+	virtual void Record(bgfx::Encoder* pEncoder, uint32_t taskIndex) override
+	{
+		assert(pEncoder);
+		m_recordCounts[taskIndex].fetch_add(1U);
+
+		RecordingEncoder encoder(pEncoder, m_recordedDraws[taskIndex]);
+		const uint16_t viewID = m_viewIDs[taskIndex % ViewCount];
+		const uint32_t taskSlot = taskIndex / ViewCount;
+		for (uint32_t drawIndex = 0U; drawIndex < DrawCountPerTask; ++drawIndex)
+		{
+			float transform[16];
+			BuildTransform(taskIndex, drawIndex, transform);
+
+			encoder.setTransform(transform);
+			encoder.setState(0U == drawIndex % 3U ? BGFX_STATE_DEFAULT | BGFX_STATE_BLEND_ALPHA : BGFX_STATE_DEFAULT);
+			encoder.submit(viewID, drawIndex * 2U + taskSlot);
+		}
+	}
+
+	uint32_t GetRecordCount(uint32_t taskIndex) const { return m_recordCounts[taskIndex].load(); }
+
+	// Draws of the last frame ordered by view and depth like bgfx sorts them.
+	std::vector<RecordedDraw> GetSortedDraws() const
+	{
+		std::vector<RecordedDraw> draws;
+		for (const std::vector<RecordedDraw>& taskDraws : m_recordedDraws)
+		{
+			draws.insert(draws.end(), taskDraws.begin(), taskDraws.end());
+		}
+		std::stable_sort(draws.begin(), draws.end(), [](const RecordedDraw& lhs, const RecordedDraw& rhs)
+		{
+			return lhs.viewID != rhs.viewID ? lhs.viewID < rhs.viewID : lhs.depth < rhs.depth;
+		});
+		return draws;
+	}
+
+private:
+	// Stands for culling and matrix work which a real renderer does per draw call.
+	void BuildTransform(uint32_t taskIndex, uint32_t drawIndex, float* pTransform) const
+	{
+		for (uint32_t elementIndex = 0U; elementIndex < 16U; ++elementIndex)
+		{
+			pTransform[elementIndex] = 0 == elementIndex % 5U ? 1.0f : 0.0f;
+		}
+		pTransform[12] = static_cast<float>(taskIndex);
+		pTransform[13] = static_cast<float>(drawIndex);
+
+		float angle = static_cast<float>(taskIndex * DrawCountPerTask + drawIndex) * 0.001f;
+		for (uint32_t workIndex = 0U; workIndex < m_workCountPerDraw; ++workIndex)
+		{
+			float c = std::cos(angle);
+			float s = std::sin(angle);
+			float x = pTransform[0] * c - pTransform[1] * s;
+			float y = pTransform[0] * s + pTransform[1] * c;
+			pTransform[0] = x;
+			pTransform[1] = y;
+			angle += pTransform[14] + 0.0001f;
+		}
+	}
+
+private:
+	uint32_t m_workCountPerDraw;
+	uint16_t m_viewIDs[ViewCount];
+	std::atomic<uint32_t> m_recordCounts[TaskCount];
+	// Every task only writes its own log so no lock is needed.
+	std::vector<RecordedDraw> m_recordedDraws[TaskCount];
+};
+
+float RecordOneFrame(RenderContext& renderContext, ParallelRenderRecorder& recorder, RecordTestRenderer& renderer)
+{
+	auto startTime = std::chrono::steady_clock::now();
+	recorder.Add(&renderer, 0.0f);
+	recorder.Record();
+	auto endTime = std::chrono::steady_clock::now();
+	renderContext.EndFrame();
+
+	return std::chrono::duration<float, std::milli>(endTime - startTime).count();
+}
+
+void Test_ParallelRecordDeterminism(RenderContext& renderContext)
+{
+	cdtools::PerformanceProfiler perf("Test_ParallelRecordDeterminism");
+
+	ParallelRenderRecorder recorder;
+	RecordTestRenderer renderer(renderContext, 4U);
+
+	// Serial recording is the reference.
+	RecordOneFrame(renderContext, recorder, renderer);
+	assert(1U == recorder.GetLastJobCount());
+	for (uint32_t taskIndex = 0U; taskIndex < RecordTestRenderer::TaskCount; ++taskIndex)
+	{
+		assert(1U == renderer.GetRecordCount(taskIndex));
+	}
+	const std::vector<RecordedDraw> referenceDraws = renderer.GetSortedDraws();
+	assert(RecordTestRenderer::TaskCount * RecordTestRenderer::DrawCountPerTask == referenceDraws.size());
+
+	// Thread counts above bgfx's encoder limit exercise the main thread fallback.
+	for (uint32_t threadCount = 2U; threadCount <= 16U; threadCount *= 2U)
+	{
+		JobSystem& jobSystem = JobSystem::Get();
+		jobSystem.Init(threadCount);
+
+		for (uint32_t frameIndex = 0U; frameIndex < 8U; ++frameIndex)
+		{
+			RecordOneFrame(renderContext, recorder, renderer);
+			assert(0U == recorder.GetTaskCount());
+			assert(recorder.GetLastJobCount() <= threadCount);
+			for (uint32_t taskIndex = 0U; taskIndex < RecordTestRenderer::TaskCount; ++taskIndex)
+			{
+				assert(1U == renderer.GetRecordCount(taskIndex));
+			}
+			assert(referenceDraws == renderer.GetSortedDraws());
+		}
+
+		jobSystem.Shutdown();
+	}
+
+	printf("[Success] Test_ParallelRecordDeterminism\n");
+}
+
+void Test_ParallelRecordScaling(RenderContext& renderContext)
+{
+	cdtools::PerformanceProfiler perf("Test_ParallelRecordScaling");
+
+	ParallelRenderRecorder recorder;
+	RecordTestRenderer renderer(renderContext, 64U);
+
+	float baselineTime = 0.0f;
+	const uint32_t maxThreadCount = std::max(1U, static_cast<uint32_t>(bgfx::getCaps()->limits.maxEncoders));
+	for (uint32_t threadCount = 1U; threadCount <= maxThreadCount; threadCount *= 2U)
+	{
+		JobSystem& jobSystem = JobSystem::Get();
+		jobSystem.Init(threadCount);
+
+		// Warm up threads and encoders.
+		RecordOneFrame(renderContext, recorder, renderer);
+		float bestTime = RecordOneFrame(renderContext, recorder, renderer);
+		for (uint32_t frameIndex = 0U; frameIndex < 8U; ++frameIndex)
+		{
+			bestTime = std::min(bestTime, RecordOneFrame(renderContext, recorder, renderer));
+		}
+
+		if (1U == threadCount)
+		{
+			baselineTime = bestTime;
+		}
+		printf("[Benchmark] %2u threads, %u draws : %8.3f ms, speedup %5.2fx\n", threadCount,
+			RecordTestRenderer::TaskCount * RecordTestRenderer::DrawCountPerTask, bestTime, baselineTime / bestTime);
+
+		jobSystem.Shutdown();
+	}
+
+	printf("[Success] Test_ParallelRecordScaling\n");
+}
+
+}
+
+int main()
+{
+	RenderContext renderContext;
+	renderContext.Init(GraphicsBackend::Noop);
+
+	std::string textureFilePath = Test_WriteSourceTexture();
+	Test_LoadManyTextures(renderContext, textureFilePath);
+	Test_RenderGraph(renderContext);
+	Test_ParallelRecordDeterminism(renderContext);
+	Test_ParallelRecordScaling(renderContext);
+
+	renderContext.Shutdown();
+	std::filesystem::remove(textureFilePath);
+
+	return 0;
+}
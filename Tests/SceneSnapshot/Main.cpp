@@ -0,0 +1,366 @@
+#include "Core/StringCrc.h"
+#include "ECWorld/AnimationComponent.h"
+#include "ECWorld/CameraComponent.h"
+#include "ECWorld/CollisionMeshComponent.h"
+#include "ECWorld/HierarchyComponent.h"
+#include "ECWorld/LightComponent.h"
+#include "ECWorld/MaterialComponent.h"
+#include "ECWorld/NameComponent.h"
+#include "ECWorld/SceneSnapshot.h"
+#include "ECWorld/SkeletonComponent.h"
+#include "ECWorld/StaticMeshComponent.h"
+#include "ECWorld/TransformComponent.h"
+#include "ECWorld/World.h"
+#include "Rendering/Resources/MeshResource.h"
+#include "Rendering/Resources/ResourceContext.h"
+#include "Rendering/Resources/SkeletonResource.h"
+
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using namespace engine;
+
+constexpr const char* SnapshotFilePath = "Test_SceneSnapshot.cdscene";
+
+// All component storages which SceneSnapshot supports.
+void RegisterComponents(World& world)
+{
+	world.Register<AnimationComponent>();
+	world.Register<CameraComponent>();
+	world.Register<CollisionMeshComponent>();
+	world.Register<HierarchyComponent>();
+	world.Register<LightComponent>();
+	world.Register<MaterialComponent>();
+	world.Register<NameComponent>();
+	world.Register<SkeletonComponent>();
+	world.Register<StaticMeshComponent>();
+	world.Register<TransformComponent>();
+}
+
+// Same per entity work as ECWorldConsumer does for a node with a mesh.
+void BuildScene(World& world, ResourceContext& resourceContext, uint32_t entityCount)
+{
+	const MeshResource* meshResources[] =
+	{
+		resourceContext.AddMeshResource(StringCrc("BoxMesh")),
+		resourceContext.AddMeshResource(StringCrc("SphereMesh")),
+	};
+
+	Entity rootEntity = INVALID_ENTITY;
+	for (uint32_t entityIndex = 0U; entityIndex < entityCount; ++entityIndex)
+	{
+		Entity entity = world.CreateEntity();
+
+		auto& nameComponent = world.CreateComponent<NameComponent>(entity);
+		nameComponent.SetName("Node_" + std::to_string(entityIndex));
+
+		auto& transformComponent = world.CreateComponent<TransformComponent>(entity);
+		cd::Transform transform = cd::Transform::Identity();
+		transform.SetTranslation(cd::Vec3f(static_cast<float>(entityIndex % 100U), 0.0f, static_cast<float>(entityIndex / 100U)));
+		transformComponent.SetTransform(transform);
+		transformComponent.Build();
+
+		if (INVALID_ENTITY == rootEntity)
+		{
+			rootEntity = entity;
+		}
+		else
+		{
+			world.CreateComponent<HierarchyComponent>(entity).SetParentEntity(rootEntity);
+		}
+
+		// Every 4th node is a transform only group.
+		if (entityIndex % 4U != 0U)
+		{
+			world.CreateComponent<StaticMeshComponent>(entity).SetMeshResource(meshResources[entityIndex % 2U]);
+		}
+	}
+}
+
+void Test_RoundTrip()
+{
+	constexpr uint32_t entityCount = 100U;
+
+	World sourceWorld;
+	RegisterComponents(sourceWorld);
+	ResourceContext resourceContext;
+	BuildScene(sourceWorld, resourceContext, entityCount);
+	bool isSaved = SceneSnapshot::Save(sourceWorld, SnapshotFilePath);
+	assert(isSaved);
+
+	World loadedWorld;
+	RegisterComponents(loadedWorld);
+	SceneSnapshotInfo info;
+	bool isLoaded = SceneSnapshot::Load(loadedWorld, &resourceContext, SnapshotFilePath, &info);
+	assert(isLoaded);
+	assert(entityCount == info.entityCount);
+	assert(0U == info.unresolvedResourceCount);
+
+	ComponentsStorage<NameComponent>* pSourceNames = sourceWorld.GetComponents<NameComponent>();
+	ComponentsStorage<NameComponent>* pLoadedNames = loadedWorld.GetComponents<NameComponent>();
+	ComponentsStorage<TransformComponent>* pSourceTransforms = sourceWorld.GetComponents<TransformComponent>();
+	ComponentsStorage<TransformComponent>* pLoadedTransforms = loadedWorld.GetComponents<TransformComponent>();
+	ComponentsStorage<HierarchyComponent>* pLoadedHierarchies = loadedWorld.GetComponents<HierarchyComponent>();
+	ComponentsStorage<StaticMeshComponent>* pSourceMeshes = sourceWorld.GetComponents<StaticMeshComponent>();
+	ComponentsStorage<StaticMeshComponent>* pLoadedMeshes = loadedWorld.GetComponents<StaticMeshComponent>();
+	assert(pSourceNames->GetCount() == pLoadedNames->GetCount());
+	assert(pSourceMeshes->GetCount() == pLoadedMeshes->GetCount());
+	assert(sourceWorld.GetComponents<HierarchyComponent>()->GetCount() == pLoadedHierarchies->GetCount());
+
+	// Scene entities were created in order so new entities keep the same order.
+	const std::vector<Entity>& sourceEntities = pSourceNames->GetEntities();
+	for (uint32_t entityIndex = 0U; entityIndex < entityCount; ++entityIndex)
+	{
+		Entity sourceEntity = sourceEntities[entityIndex];
+		Entity loadedEntity = info.firstEntity + entityIndex;
+
+		assert(0 == std::strcmp(pSourceNames->GetComponent(sourceEntity)->GetName(), pLoadedNames->GetComponent(loadedEntity)->GetName()));
+		assert(pSourceNames->GetComponent(sourceEntity)->GetNameCrc() == pLoadedNames->GetComponent(loadedEntity)->GetNameCrc());
+
+		const cd::Transform& sourceTransform = pSourceTransforms->GetComponent(sourceEntity)->GetTransform();
+		const cd::Transform& loadedTransform = pLoadedTransforms->GetComponent(loadedEntity)->GetTransform();
+		assert(0 == std::memcmp(&sourceTransform, &loadedTransform, sizeof(cd::Transform)));
+
+		if (entityIndex > 0U)
+		{
+			assert(info.firstEntity == pLoadedHierarchies->GetComponent(loadedEntity)->GetParentEntity());
+		}
+
+		const StaticMeshComponent* pSourceMesh = pSourceMeshes->GetComponent(sourceEntity);
+		const StaticMeshComponent* pLoadedMesh = pLoadedMeshes->GetComponent(loadedEntity);
+		assert((nullptr == pSourceMesh) == (nullptr == pLoadedMesh));
+		assert(!pSourceMesh || pSourceMesh->GetMeshResource() == pLoadedMesh->GetMeshResource());
+	}
+
+	std::remove(SnapshotFilePath);
+
+	printf("[Success] Test_RoundTrip\n");
+}
+
+void Test_UnresolvedResources()
+{
+	World sourceWorld;
+	RegisterComponents(sourceWorld);
+	ResourceContext resourceContext;
+	BuildScene(sourceWorld, resourceContext, 8U);
+	bool isSaved = SceneSnapshot::Save(sourceWorld, SnapshotFilePath);
+	assert(isSaved);
+
+	// Meshes are skipped without a ResourceContext, other components still load.
+	World loadedWorld;
+	RegisterComponents(loadedWorld);
+	SceneSnapshotInfo info;
+	bool isLoaded = SceneSnapshot::Load(loadedWorld, nullptr, SnapshotFilePath, &info);
+	assert(isLoaded);
+	assert(2U == info.unresolvedResourceCount);
+	assert(6U == info.skippedComponentCount);
+	assert(0U == loadedWorld.GetComponents<StaticMeshComponent>()->GetCount());
+	assert(8U == loadedWorld.GetComponents<TransformComponent>()->GetCount());
+
+	std::remove(SnapshotFilePath);
+
+	printf("[Success] Test_UnresolvedResources\n");
+}
+
+void Test_StoredResources()
+{
+	World sourceWorld;
+	RegisterComponents(sourceWorld);
+	ResourceContext sourceResourceContext;
+
+	// One triangle which was built before.
+	MeshResource::BuiltData meshData;
+	meshData.vertexFormat.AddVertexAttributeLayout(cd::VertexAttributeType::Position, cd::AttributeValueType::Float, 3U);
+	meshData.vertexCount = 3U;
+	meshData.polygonCount = 1U;
+	meshData.vertexBuffer.resize(3U * meshData.vertexFormat.GetStride(), std::byte{ 1 });
+	meshData.indexBuffers.emplace_back(3U * sizeof(uint32_t), std::byte{ 2 });
+	MeshResource* pSourceMesh = sourceResourceContext.AddMeshResource(StringCrc("TriangleMesh"));
+	pSourceMesh->SetBuiltData(meshData);
+
+	// Two bones with one clip.
+	AnimationClipData clip;
+	clip.Init(2U, 1.0f);
+	clip.SetParentIndex(1U, 0U);
+	std::vector<AnimationClipData> clips;
+	clips.push_back(cd::MoveTemp(clip));
+	SkeletonResource* pSourceSkeleton = sourceResourceContext.AddSkeletonResource(StringCrc("TwoBones"));
+	pSourceSkeleton->SetSkeletonData({ cd::Matrix4x4::Identity(), cd::Matrix4x4::Identity() }, { AnimationClipData::InvalidBoneIndex, 0U }, cd::MoveTemp(clips));
+
+	Entity meshEntity = sourceWorld.CreateEntity();
+	sourceWorld.CreateComponent<NameComponent>(meshEntity).SetName("Triangle");
+	sourceWorld.CreateComponent<TransformComponent>(meshEntity).SetTransform(cd::Transform::Identity());
+	sourceWorld.CreateComponent<StaticMeshComponent>(meshEntity).SetMeshResource(pSourceMesh);
+	sourceWorld.CreateComponent<SkeletonComponent>(meshEntity).SetSkeletonAsset(pSourceSkeleton);
+
+	Entity lightEntity = sourceWorld.CreateEntity();
+	auto& sourceLight = sourceWorld.CreateComponent<LightComponent>(lightEntity);
+	sourceLight.SetType(cd::LightType::Directional);
+	sourceLight.SetIntensity(2.0f);
+	sourceLight.SetIsCastShadow(true);
+	sourceLight.SetShadowMapSize(1024U);
+
+	Entity cameraEntity = sourceWorld.CreateEntity();
+	cd::Transform cameraTransform = cd::Transform::Identity();
+	cameraTransform.SetTranslation(cd::Vec3f(0.0f, 1.0f, -5.0f));
+	sourceWorld.CreateComponent<TransformComponent>(cameraEntity).SetTransform(cameraTransform);
+	auto& sourceCamera = sourceWorld.CreateComponent<CameraComponent>(cameraEntity);
+	sourceCamera.SetAspect(16.0f / 9.0f);
+	sourceCamera.SetFov(45.0f);
+	sourceCamera.SetNearPlane(0.1f);
+	sourceCamera.SetFarPlane(100.0f);
+	sourceCamera.SetNDCDepth(cd::NDCDepth::ZeroToOne);
+	sourceCamera.BuildProjectMatrix();
+
+	bool isSaved = SceneSnapshot::Save(sourceWorld, SnapshotFilePath, meshEntity);
+	assert(isSaved);
+
+	// A new ResourceContext doesn't have any resource, they are created from the snapshot.
+	World loadedWorld;
+	RegisterComponents(loadedWorld);
+	ResourceContext loadedResourceContext;
+	SceneSnapshotInfo info;
+	bool isLoaded = SceneSnapshot::Load(loadedWorld, &loadedResourceContext, SnapshotFilePath, &info);
+	assert(isLoaded);
+	assert(3U == info.entityCount);
+	assert(0U == info.unresolvedResourceCount);
+	assert(0U == info.skippedComponentCount);
+
+	const MeshResource* pLoadedMesh = loadedWorld.GetComponents<StaticMeshComponent>()->GetComponent(info.firstEntity)->GetMeshResource();
+	assert(pLoadedMesh && pLoadedMesh == loadedResourceContext.GetMeshResource(StringCrc("TriangleMesh")));
+	MeshResource::BuiltData loadedMeshData;
+	bool hasMeshData = pLoadedMesh->GetBuiltData(loadedMeshData);
+	assert(hasMeshData);
+	assert(3U == loadedMeshData.vertexCount && 1U == loadedMeshData.polygonCount);
+	assert(meshData.vertexFormat.GetStride() == loadedMeshData.vertexFormat.GetStride());
+	assert(meshData.vertexBuffer == loadedMeshData.vertexBuffer && meshData.indexBuffers == loadedMeshData.indexBuffers);
+
+	const SkeletonResource* pLoadedSkeleton = loadedWorld.GetComponents<SkeletonComponent>()->GetComponent(info.firstEntity)->GetSkeletonResource();
+	assert(pLoadedSkeleton && pLoadedSkeleton == loadedResourceContext.GetSkeletonResource(StringCrc("TwoBones")));
+	assert(2U == pLoadedSkeleton->GetBoneCount());
+	assert(pSourceSkeleton->GetBoneParentIndices() == pLoadedSkeleton->GetBoneParentIndices());
+	assert(1U == pLoadedSkeleton->GetAnimationClipCount());
+	const AnimationClipData* pSourceClip = pSourceSkeleton->GetAnimationClip(0U);
+	const AnimationClipData* pLoadedClip = pLoadedSkeleton->GetAnimationClip(0U);
+	assert(pSourceClip->GetFrameCount() == pLoadedClip->GetFrameCount());
+	assert(pSourceClip->GetBoneOrder() == pLoadedClip->GetBoneOrder());
+	assert(0U == pLoadedClip->GetParentIndex(1U));
+
+	const LightComponent* pLoadedLight = loadedWorld.GetComponents<LightComponent>()->GetComponent(info.firstEntity + 1U);
+	assert(pLoadedLight);
+	assert(cd::LightType::Directional == pLoadedLight->GetType() && 2.0f == pLoadedLight->GetIntensity());
+	assert(pLoadedLight->IsCastShadow() && 1024U == pLoadedLight->GetShadowMapSize());
+
+	const CameraComponent* pLoadedCamera = loadedWorld.GetComponents<CameraComponent>()->GetComponent(info.firstEntity + 2U);
+	assert(pLoadedCamera);
+	assert(45.0f == pLoadedCamera->GetFov() && 100.0f == pLoadedCamera->GetFarPlane());
+	assert(0 == std::memcmp(&sourceCamera.GetProjectionMatrix(), &pLoadedCamera->GetProjectionMatrix(), sizeof(cd::Matrix4x4)));
+
+	std::remove(SnapshotFilePath);
+
+	printf("[Success] Test_StoredResources\n");
+}
+
+void Test_InvalidData()
+{
+	World world;
+	RegisterComponents(world);
+	ResourceContext resourceContext;
+	BuildScene(world, resourceContext, 16U);
+	bool isSaved = SceneSnapshot::Save(world, SnapshotFilePath);
+	assert(isSaved);
+
+	std::vector<std::byte> data;
+	if (FILE* pFile = std::fopen(SnapshotFilePath, "rb"))
+	{
+		std::fseek(pFile, 0, SEEK_END);
+		data.resize(static_cast<size_t>(std::ftell(pFile)));
+		std::fseek(pFile, 0, SEEK_SET);
+		size_t readSize = std::fread(data.data(), 1U, data.size(), pFile);
+		assert(readSize == data.size());
+		std::fclose(pFile);
+	}
+	std::remove(SnapshotFilePath);
+
+	World loadedWorld;
+	RegisterComponents(loadedWorld);
+	assert(SceneSnapshot::Load(loadedWorld, &resourceContext, data.data(), data.size()));
+
+	// Truncated and corrupted data is rejected before creating anything.
+	World rejectedWorld;
+	RegisterComponents(rejectedWorld);
+	assert(!SceneSnapshot::Load(rejectedWorld, &resourceContext, data.data(), data.size() / 2U));
+	assert(!SceneSnapshot::Load(rejectedWorld, &resourceContext, data.data(), 8U));
+	std::vector<std::byte> corrupted = data;
+	corrupted[0] = std::byte{ 0 };
+	assert(!SceneSnapshot::Load(rejectedWorld, &resourceContext, corrupted.data(), corrupted.size()));
+	assert(!SceneSnapshot::Load(rejectedWorld, nullptr, "NotExist.cdscene"));
+
+	// Two components of one type for the same entity. Offsets follow SnapshotHeader and SnapshotSection, the first section is names.
+	std::vector<std::byte> duplicated = data;
+	uint64_t sectionTableOffset = 0U;
+	std::memcpy(&sectionTableOffset, duplicated.data() + 48U, sizeof(uint64_t));
+	uint64_t entityIndicesOffset = 0U;
+	std::memcpy(&entityIndicesOffset, duplicated.data() + sectionTableOffset + 8U, sizeof(uint64_t));
+	std::memcpy(duplicated.data() + entityIndicesOffset + sizeof(uint32_t), duplicated.data() + entityIndicesOffset, sizeof(uint32_t));
+	assert(!SceneSnapshot::Load(rejectedWorld, &resourceContext, duplicated.data(), duplicated.size()));
+	assert(0U == rejectedWorld.GetComponents<NameComponent>()->GetCount());
+
+	printf("[Success] Test_InvalidData\n");
+}
+
+void Test_LoadBenchmark()
+{
+	constexpr uint32_t entityCount = 100000U;
+	using Clock = std::chrono::steady_clock;
+	auto toMs = [](Clock::duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+
+	ResourceContext resourceContext;
+
+	World importedWorld;
+	RegisterComponents(importedWorld);
+	auto importBegin = Clock::now();
+	BuildScene(importedWorld, resourceContext, entityCount);
+	const double importMs = toMs(Clock::now() - importBegin);
+
+	auto saveBegin = Clock::now();
+	bool isSaved = SceneSnapshot::Save(importedWorld, SnapshotFilePath);
+	assert(isSaved);
+	const double saveMs = toMs(Clock::now() - saveBegin);
+
+	World loadedWorld;
+	RegisterComponents(loadedWorld);
+	SceneSnapshotInfo info;
+	auto loadBegin = Clock::now();
+	bool isLoaded = SceneSnapshot::Load(loadedWorld, &resourceContext, SnapshotFilePath, &info);
+	assert(isLoaded);
+	const double loadMs = toMs(Clock::now() - loadBegin);
+	assert(entityCount == info.entityCount);
+	assert(importedWorld.GetComponents<StaticMeshComponent>()->GetCount() == loadedWorld.GetComponents<StaticMeshComponent>()->GetCount());
+
+	std::remove(SnapshotFilePath);
+
+	printf("[Benchmark] %u entities : per entity creation %.2f ms, snapshot save %.2f ms, snapshot load %.2f ms (%.1fx)\n",
+		entityCount, importMs, saveMs, loadMs, importMs / loadMs);
+	printf("[Success] Test_LoadBenchmark\n");
+}
+
+}
+
+int main()
+{
+	Test_RoundTrip();
+	Test_UnresolvedResources();
+	Test_StoredResources();
+	Test_InvalidData();
+	Test_LoadBenchmark();
+
+	return 0;
+}
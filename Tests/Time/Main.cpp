@@ -0,0 +1,145 @@
+#include "Time/FixedTimestep.h"
+#include "Time/FramePacer.h"
+#include "Time/FrameTimeStats.h"
+
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+
+using namespace engine;
+
+bool IsNearlyEqual(double a, double b, double tolerance = 1e-4)
+{
+	return std::abs(a - b) <= tolerance;
+}
+
+void Test_FixedTimestep()
+{
+	FixedTimestep timestep(0.01f, 4U);
+
+	// Less than a step only accumulates.
+	assert(0U == timestep.Advance(0.004f));
+	assert(IsNearlyEqual(timestep.GetAlpha(), 0.4));
+
+	// Remainder carries over.
+	assert(1U == timestep.Advance(0.008f));
+	assert(IsNearlyEqual(timestep.GetAlpha(), 0.2));
+
+	assert(2U == timestep.Advance(0.02f));
+	assert(3U == timestep.GetStepIndex());
+
+	// Total simulated time follows real time for any frame rate.
+	FixedTimestep variableFrames(1.0f / 60.0f);
+	uint64_t stepCount = 0U;
+	for (uint32_t frameIndex = 0U; frameIndex < 1440U; ++frameIndex)
+	{
+		stepCount += variableFrames.Advance(0 == frameIndex % 2 ? 1.0f / 144.0f : 1.0f / 90.0f);
+	}
+	// 13 seconds. The last step may still sit in the accumulator.
+	constexpr uint64_t expectedStepCount = 780U;
+	assert(stepCount + 1U >= expectedStepCount && stepCount <= expectedStepCount);
+
+	printf("[Success] Test_FixedTimestep\n");
+}
+
+void Test_FixedTimestepHitch()
+{
+	FixedTimestep timestep(0.01f, 4U);
+
+	// A long hitch is clamped. The fraction of a step is kept.
+	assert(4U == timestep.Advance(1.005f));
+	assert(timestep.GetAlpha() >= 0.0f && timestep.GetAlpha() < 1.0f);
+	assert(0U == timestep.Advance(0.0f));
+
+	// Negative time from a clock going backwards is ignored.
+	assert(0U == timestep.Advance(-1.0f));
+
+	printf("[Success] Test_FixedTimestepHitch\n");
+}
+
+void Test_FrameTimeStats()
+{
+	FrameTimeStats stats(100U);
+	for (uint32_t sampleIndex = 1U; sampleIndex <= 100U; ++sampleIndex)
+	{
+		stats.AddSample(static_cast<float>(sampleIndex));
+	}
+
+	FrameTimeSummary summary = stats.GetSummary();
+	assert(100U == summary.frameCount);
+	assert(IsNearlyEqual(summary.averageMs, 50.5));
+	assert(IsNearlyEqual(summary.p50Ms, 50.0));
+	assert(IsNearlyEqual(summary.p95Ms, 95.0));
+	assert(IsNearlyEqual(summary.p99Ms, 99.0));
+	assert(IsNearlyEqual(summary.maxMs, 100.0));
+
+	// Old samples are replaced once the ring is full.
+	for (uint32_t sampleIndex = 0U; sampleIndex < 100U; ++sampleIndex)
+	{
+		stats.AddSample(1.0f);
+	}
+	summary = stats.GetSummary();
+	assert(200U == summary.frameCount);
+	assert(100U == stats.GetSampleCount());
+	assert(IsNearlyEqual(summary.p99Ms, 1.0));
+
+	stats.Reset();
+	assert(0U == stats.GetSummary().frameCount);
+
+	printf("[Success] Test_FrameTimeStats\n");
+}
+
+void Test_FramePacer()
+{
+	constexpr float targetFrameRate = 200.0f;
+	constexpr uint32_t frameCount = 100U;
+	FramePacer pacer(FramePacingMode::TargetFrameRate, targetFrameRate);
+	assert(!pacer.IsVSyncEnabled());
+
+	FrameTimeStats stats;
+	auto lastTime = std::chrono::steady_clock::now();
+	for (uint32_t frameIndex = 0U; frameIndex <= frameCount; ++frameIndex)
+	{
+		pacer.WaitForNextFrame();
+		auto now = std::chrono::steady_clock::now();
+		if (frameIndex > 0U)
+		{
+			stats.AddSample(std::chrono::duration<float, std::milli>(now - lastTime).count());
+		}
+		lastTime = now;
+	}
+
+	const FrameTimeSummary summary = stats.GetSummary();
+	printf("[Info] Target 5.000 ms : avg %.3f ms, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms\n",
+		summary.averageMs, summary.p50Ms, summary.p95Ms, summary.p99Ms);
+
+	// Deadlines don't drift so the average stays on target even if single frames are late.
+	assert(std::abs(summary.averageMs - 1000.0 / targetFrameRate) < 0.5);
+
+	// Uncapped never waits.
+	FramePacer uncapped(FramePacingMode::Uncapped, targetFrameRate);
+	auto begin = std::chrono::steady_clock::now();
+	for (uint32_t frameIndex = 0U; frameIndex < frameCount; ++frameIndex)
+	{
+		uncapped.WaitForNextFrame();
+	}
+	assert(std::chrono::steady_clock::now() - begin < std::chrono::milliseconds(100));
+
+	printf("[Success] Test_FramePacer\n");
+}
+
+}
+
+int main()
+{
+	Test_FixedTimestep();
+	Test_FixedTimestepHitch();
+	Test_FrameTimeStats();
+	Test_FramePacer();
+
+	return 0;
+}